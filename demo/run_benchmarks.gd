@@ -20,8 +20,12 @@ const ALLOC_FAST_ITER := 160
 const ALLOC_FAST_SIZE := 4096
 const FILE_IO_ITER := 32
 const FILE_IO_SIZE := 2048
+const GLOBAL_ITER := 200
+const GLOBAL_INNER := 1000
 
 var _vg_script: Script = null
+var _bench_global_a := 0
+var _bench_global_b := 0
 
 func _get_vg_script() -> Script:
     if _vg_script == null:
@@ -245,6 +249,17 @@ func bench_gd_file_io(iterations: int, size: int) -> Dictionary:
     var elapsed := Time.get_ticks_usec() - start
     return {"elapsed_us": elapsed, "checksum": read_line.length()}
 
+func bench_gd_global_access(iterations: int, inner: int) -> Dictionary:
+    var start := Time.get_ticks_usec()
+    _bench_global_a = 0
+    _bench_global_b = 0
+    for _i in iterations:
+        for j in inner:
+            _bench_global_a += j
+            _bench_global_b += 1
+    var elapsed := Time.get_ticks_usec() - start
+    return {"elapsed_us": elapsed, "checksum": _bench_global_a + _bench_global_b}
+
 func bench_vg_arithmetic(iterations: int, inner: int) -> Dictionary:
     return run_visual_gasic("BenchArithmetic", [iterations, inner])
 
@@ -278,6 +293,9 @@ func bench_vg_allocations_fast(iterations: int, size: int) -> Dictionary:
 func bench_vg_file_io(iterations: int, size: int) -> Dictionary:
     return run_visual_gasic("BenchFileIO", [iterations, size])
 
+func bench_vg_global_access(iterations: int, inner: int) -> Dictionary:
+    return run_visual_gasic("BenchGlobalAccess", [iterations, inner])
+
 func bench_cpp_arithmetic(iterations: int, inner: int) -> Dictionary:
     return run_cpp("run_cpp_arithmetic", [iterations, inner])
 
@@ -305,6 +323,9 @@ func bench_cpp_allocations_fast(iterations: int, size: int) -> Dictionary:
 func bench_cpp_file_io(iterations: int, size: int) -> Dictionary:
     return run_cpp("run_cpp_file_io", [iterations, size])
 
+func bench_cpp_global_access(iterations: int, inner: int) -> Dictionary:
+    return run_cpp("run_cpp_global_access", [iterations, inner])
+
 func run_workload(name: String, gd_call: Callable, vg_call: Callable, cpp_call: Callable = Callable()) -> Dictionary:
     var entry := {
         "name": name,
@@ -399,6 +420,13 @@ func _init():
         Callable(self, "bench_cpp_file_io").bind(FILE_IO_ITER, FILE_IO_SIZE)
     ))
 
+    results.append(run_workload(
+        "GlobalAccess",
+        Callable(self, "bench_gd_global_access").bind(GLOBAL_ITER, GLOBAL_INNER),
+        Callable(self, "bench_vg_global_access").bind(GLOBAL_ITER, GLOBAL_INNER),
+        Callable(self, "bench_cpp_global_access").bind(GLOBAL_ITER, GLOBAL_INNER)
+    ))
+
     for r in results:
         print("\n=== ", r["name"], " ===")
         var gd_result: Dictionary = r["gd"]
@@ -0,0 +1,39 @@
+extends SceneTree
+
+# Builtin dispatch benchmark (VisualGasicBenchmark.run_cpp_builtin_dispatch):
+# for every expression builtin, in table order, the one-off cost of resolving
+# its name at a call site and the cost of a call by cached ID. Both should be
+# flat across the table; the summary reports the spread.
+
+const ITERATIONS := 200000
+
+func _init():
+    var bench = ClassDB.instantiate("VisualGasicBenchmark")
+    if bench == null:
+        push_error("Failed to instantiate VisualGasicBenchmark")
+        quit(1)
+        return
+    var result: Dictionary = bench.run_cpp_builtin_dispatch(ITERATIONS)
+    bench.free()
+
+    var builtins: Array = result["builtins"]
+    print("Builtin dispatch benchmark (%d calls per builtin)" % ITERATIONS)
+    print("%4s  %-16s %10s %10s" % ["id", "builtin", "resolve ns", "call ns"])
+    var failures := 0
+    var min_ns := INF
+    var max_ns := 0.0
+    for entry in builtins:
+        var dispatch_ns := float(entry["dispatch_ns"])
+        min_ns = min(min_ns, dispatch_ns)
+        max_ns = max(max_ns, dispatch_ns)
+        print("%4d  %-16s %10.1f %10.1f" % [int(entry["id"]), entry["name"], float(entry["resolve_ns"]), dispatch_ns])
+        if not bool(entry["resolved"]):
+            push_error("%s did not resolve to its own ID" % entry["name"])
+            failures += 1
+    print("call ns min %.1f  max %.1f  (skipped: %s)" % [min_ns, max_ns, ", ".join(PackedStringArray(result["skipped"]))])
+
+    # Every call passes a rejected argument count, so none may be handled.
+    if int(result["checksum"]) != builtins.size() * ITERATIONS:
+        push_error("A builtin accepted an out-of-range argument count")
+        failures += 1
+    quit(0 if failures == 0 else 1)
@@ -0,0 +1,126 @@
+extends SceneTree
+
+# Bytecode stress suite: generated Functions that overflow single-byte
+# operands (constant pool, local slots) and 16-bit jump offsets. Each one
+# must compile to bytecode and return the same value GDScript computes.
+
+const CONSTANT_COUNT := 400
+const LOCAL_COUNT := 320
+const BODY_LINES := 8000
+
+var _failures := 0
+
+func build_many_constants() -> String:
+    var lines: PackedStringArray = []
+    lines.append("Function ManyConstants() As Long")
+    lines.append("    Dim s As Long")
+    for i in range(CONSTANT_COUNT):
+        lines.append("    s = s + %d" % (1000 + i * 7))
+    lines.append("    ManyConstants = s")
+    lines.append("End Function")
+    return "\n".join(lines)
+
+func expected_many_constants() -> int:
+    var s := 0
+    for i in range(CONSTANT_COUNT):
+        s += 1000 + i * 7
+    return s
+
+func build_many_locals() -> String:
+    var lines: PackedStringArray = []
+    lines.append("Function ManyLocals(ByVal base As Long) As Long")
+    for i in range(LOCAL_COUNT):
+        lines.append("    Dim v%d As Long" % i)
+    lines.append("    Dim t As Long")
+    for i in range(LOCAL_COUNT):
+        lines.append("    v%d = base + %d" % [i, i])
+    for i in range(LOCAL_COUNT):
+        lines.append("    t = t + v%d" % i)
+    lines.append("    ManyLocals = t")
+    lines.append("End Function")
+    return "\n".join(lines)
+
+func expected_many_locals(base: int) -> int:
+    var t := 0
+    for i in range(LOCAL_COUNT):
+        t += base + i
+    return t
+
+func build_big_body() -> String:
+    var lines: PackedStringArray = []
+    lines.append("Function BigBody(ByVal flag As Long) As Long")
+    lines.append("    Dim s As Long")
+    lines.append("    Dim r As Long")
+    lines.append("    If flag > 0 Then")
+    lines.append("        For r = 1 To 2")
+    for i in range(BODY_LINES):
+        lines.append("            s = s + r * %d" % (i % 17 + 1))
+    lines.append("        Next r")
+    lines.append("    Else")
+    lines.append("        s = -1")
+    lines.append("    End If")
+    lines.append("    BigBody = s")
+    lines.append("End Function")
+    return "\n".join(lines)
+
+func expected_big_body(flag: int) -> int:
+    if flag <= 0:
+        return -1
+    var s := 0
+    for r in range(1, 3):
+        for i in range(BODY_LINES):
+            s += r * (i % 17 + 1)
+    return s
+
+func check_bytecode(script, entry: String, min_code_size: int) -> void:
+    var dump: Dictionary = script.debug_dump_bytecode(entry)
+    if dump.has("error"):
+        _failures += 1
+        print("[FAIL] %s: %s" % [entry, dump["error"]])
+        return
+    var wide_count := 0
+    for inst in dump.get("instructions", []):
+        if String(inst["name"]) == "OP_WIDE" or String(inst["name"]) == "OP_CONSTANT_LONG":
+            wide_count += 1
+    var code_size: int = dump["code"].size()
+    print("%-14s code=%7d bytes  constants=%5d  locals=%4d  wide=%d" % [
+        entry, code_size, dump["constants"].size(), int(dump["local_count"]), wide_count
+    ])
+    if code_size < min_code_size or wide_count == 0:
+        _failures += 1
+        print("[FAIL] %s did not exercise wide operands" % entry)
+
+func check_value(label: String, got, expected) -> void:
+    if got != expected:
+        _failures += 1
+        print("[FAIL] %s: expected %s, got %s" % [label, str(expected), str(got)])
+    else:
+        print("[PASS] %s = %s" % [label, str(got)])
+
+func _init():
+    var vg_script = VisualGasicScript.new()
+    vg_script.source_code = "\n\n".join([build_many_constants(), build_many_locals(), build_big_body()]) + "\n"
+    vg_script.reload(true)
+
+    check_bytecode(vg_script, "ManyConstants", 0)
+    check_bytecode(vg_script, "ManyLocals", 0)
+    check_bytecode(vg_script, "BigBody", 65536)
+
+    var node := Node.new()
+    node.set_script(vg_script)
+    root.add_child(node)
+
+    check_value("ManyConstants()", node.call("ManyConstants"), expected_many_constants())
+    check_value("ManyLocals(5)", node.call("ManyLocals", 5), expected_many_locals(5))
+    check_value("BigBody(1)", node.call("BigBody", 1), expected_big_body(1))
+    check_value("BigBody(0)", node.call("BigBody", 0), expected_big_body(0))
+
+    root.remove_child(node)
+    node.free()
+
+    if _failures == 0:
+        print("✅ Bytecode stress suite passed")
+        quit(0)
+    else:
+        push_error("Bytecode stress suite failed (%d)" % _failures)
+        quit(1)
@@ -0,0 +1,90 @@
+extends SceneTree
+
+# Measures per-call overhead as module state grows: every combination of
+# global count and global array size runs the same tiny function CALLS times.
+# Poke also writes one element of the global array per call, so the "write"
+# column shows whether journaling that write grows with the array.
+
+const CALLS := 2000
+const GLOBAL_COUNTS := [0, 100, 1000, 10000]
+const ARRAY_SIZES := [0, 1000, 100000]
+
+func build_source(global_count: int, array_size: int) -> String:
+    var lines: PackedStringArray = []
+    for i in range(global_count):
+        lines.append("Dim G%d As Long" % i)
+    if array_size > 0:
+        lines.append("Dim Blob(%d) As Long" % (array_size - 1))
+    lines.append("")
+    lines.append("Function Touch(ByVal x As Long) As Long")
+    lines.append("    Touch = x + 1")
+    lines.append("End Function")
+    lines.append("")
+    lines.append("Function Poke(ByVal x As Long) As Long")
+    if array_size > 0:
+        lines.append("    Blob(x Mod %d) = x" % array_size)
+    lines.append("    Poke = x + 1")
+    lines.append("End Function")
+    lines.append("")
+    lines.append("Function CallLoop(ByVal n As Long) As Long")
+    lines.append("    Dim i As Long")
+    lines.append("    Dim s As Long")
+    lines.append("    For i = 0 To n - 1 Step 1")
+    lines.append("        s = Touch(s)")
+    lines.append("    Next i")
+    lines.append("    CallLoop = s")
+    lines.append("End Function")
+    return "\n".join(lines) + "\n"
+
+func run_case(global_count: int, array_size: int) -> Dictionary:
+    var vg_script = VisualGasicScript.new()
+    vg_script.source_code = build_source(global_count, array_size)
+    vg_script.reload(true)
+
+    var node := Node.new()
+    node.set_script(vg_script)
+    root.add_child(node)
+
+    # Warm the bytecode cache before timing.
+    node.call("Touch", 0)
+    node.call("Poke", 0)
+
+    var start := Time.get_ticks_usec()
+    var s = 0
+    for i in range(CALLS):
+        s = node.call("Touch", s)
+    var host_elapsed := Time.get_ticks_usec() - start
+
+    start = Time.get_ticks_usec()
+    var w = 0
+    for i in range(CALLS):
+        w = node.call("Poke", w)
+    var write_elapsed := Time.get_ticks_usec() - start
+
+    start = Time.get_ticks_usec()
+    var nested = node.call("CallLoop", CALLS)
+    var nested_elapsed := Time.get_ticks_usec() - start
+
+    root.remove_child(node)
+    node.free()
+
+    return {
+        "globals": global_count,
+        "array_size": array_size,
+        "host_us_per_call": float(host_elapsed) / CALLS,
+        "nested_us_per_call": float(nested_elapsed) / CALLS,
+        "write_us_per_call": float(write_elapsed) / CALLS,
+        "checksum": [s, nested, w]
+    }
+
+func _init():
+    print("Call overhead vs module state (", CALLS, " calls per case)")
+    for global_count in GLOBAL_COUNTS:
+        for array_size in ARRAY_SIZES:
+            var r := run_case(global_count, array_size)
+            if r["checksum"][0] != CALLS or r["checksum"][1] != CALLS or r["checksum"][2] != CALLS:
+                push_warning("Unexpected checksum: " + str(r["checksum"]))
+            print("globals=%6d array=%7d  host=%8.2f us/call  nested=%8.2f us/call  write=%8.2f us/call" % [
+                r["globals"], r["array_size"], r["host_us_per_call"], r["nested_us_per_call"], r["write_us_per_call"]
+            ])
+    quit(0)
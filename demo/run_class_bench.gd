@@ -0,0 +1,121 @@
+extends SceneTree
+
+# Class object benchmark: particles as VB classes. Times create/launch/release
+# throughput (Class_Initialize and Class_Terminate run for every object) and
+# method-call throughput over a live population, then checks that every
+# object was terminated once the script dropped its references.
+
+const CREATE_COUNT := 200000
+const POPULATION := 2000
+const FRAMES := 100
+
+const SOURCE := """
+Dim live As Long
+
+Class Particle
+    Public X As Double
+    Public Y As Double
+    Public VX As Double
+    Public VY As Double
+    Public Life As Long
+
+    Sub Class_Initialize()
+        Life = 100
+        live = live + 1
+    End Sub
+
+    Public Sub Launch(ByVal sx As Double, ByVal sy As Double)
+        VX = sx
+        VY = sy
+    End Sub
+
+    Public Sub Update(ByVal dt As Double)
+        X = X + VX * dt
+        Y = Y + VY * dt
+        Life = Life - 1
+    End Sub
+
+    Sub Class_Terminate()
+        live = live - 1
+    End Sub
+End Class
+
+Function CreateDestroy(ByVal n As Long) As Long
+    Dim i As Long
+    Dim p
+    For i = 1 To n
+        p = New Particle
+        p.Launch 1, 2
+    Next i
+    p = Nothing
+    CreateDestroy = live
+End Function
+
+Function UpdateAll(ByVal count As Long, ByVal frames As Long) As Double
+    Dim i As Long
+    Dim f As Long
+    Dim p
+    Dim ps(count)
+    For i = 0 To count - 1
+        p = New Particle
+        p.Launch 1, 2
+        ps(i) = p
+    Next i
+    For f = 1 To frames
+        For i = 0 To count - 1
+            p = ps(i)
+            p.Update 0.016
+        Next i
+    Next f
+    UpdateAll = p.X
+    p = Nothing
+    For i = 0 To count - 1
+        ps(i) = Nothing
+    Next i
+End Function
+
+Function LiveCount() As Long
+    LiveCount = live
+End Function
+"""
+
+func _init():
+    var vg_script = VisualGasicScript.new()
+    vg_script.source_code = SOURCE
+    vg_script.reload(true)
+    var node := Node.new()
+    node.set_script(vg_script)
+    root.add_child(node)
+
+    print("Class object benchmark (%d create/destroy, %d objects x %d frames)" % [
+        CREATE_COUNT, POPULATION, FRAMES
+    ])
+    var failures := 0
+
+    var start := Time.get_ticks_usec()
+    var remaining = node.call("CreateDestroy", CREATE_COUNT)
+    var create_us := Time.get_ticks_usec() - start
+    print("create/destroy %8d ms  %8.0f objects/s" % [
+        create_us / 1000, float(CREATE_COUNT) * 1000000.0 / max(create_us, 1)
+    ])
+    if int(remaining) != 0:
+        push_error("CreateDestroy left %d live objects" % int(remaining))
+        failures += 1
+
+    var calls := POPULATION * FRAMES
+    start = Time.get_ticks_usec()
+    var x = node.call("UpdateAll", POPULATION, FRAMES)
+    var update_us := Time.get_ticks_usec() - start
+    print("update         %8d ms  %6.1f ns/call" % [update_us / 1000, float(update_us) * 1000.0 / calls])
+    if absf(float(x) - 0.016 * FRAMES) > 0.001:
+        push_error("UpdateAll moved particles to %f" % float(x))
+        failures += 1
+
+    var live = node.call("LiveCount")
+    if int(live) != 0:
+        push_error("%d objects were never terminated" % int(live))
+        failures += 1
+
+    root.remove_child(node)
+    node.free()
+    quit(0 if failures == 0 else 1)
@@ -0,0 +1,116 @@
+extends SceneTree
+
+# Cold-start benchmark: loads a generated project of many .vg modules and
+# calls every Function once, three times over: with the bytecode cache off,
+# with an empty cache (compiles and writes user://visualgasic_cache/) and
+# with a warm cache (chunks read back instead of compiled). Results must
+# agree, and the warm pass must actually use the cached chunks.
+
+const MODULES := 200
+const FUNCTIONS := 8
+const MODULE_DIR := "user://vg_cold_start/"
+const CACHE_DIR := "user://visualgasic_cache/"
+const CACHE_SETTING := "visual_gasic/bytecode_cache/enabled"
+
+func module_source(m: int) -> String:
+    var src := ""
+    for k in range(FUNCTIONS):
+        src += """
+Function F%d(ByVal n As Long) As Long
+    Dim i As Long
+    Dim s As Long
+    Dim t As Double
+    For i = 1 To n
+        s = s + i * %d - %d
+        t = t + i * 0.5
+        If s > 100000 Then
+            s = s - 100000
+        End If
+    Next i
+    F%d = s + t
+End Function
+""" % [k, k + 1, m % 7, k]
+    return src
+
+func write_modules() -> PackedStringArray:
+    DirAccess.make_dir_recursive_absolute(MODULE_DIR)
+    var paths := PackedStringArray()
+    for m in range(MODULES):
+        var path := MODULE_DIR + "mod_%03d.vg" % m
+        var f := FileAccess.open(path, FileAccess.WRITE)
+        f.store_string(module_source(m))
+        f.close()
+        paths.push_back(path)
+    return paths
+
+# Cache files are named <file>-<path hash>.vgc.
+func clear_cache() -> void:
+    for file in DirAccess.get_files_at(CACHE_DIR):
+        if file.begins_with("mod_") and file.ends_with(".vgc"):
+            DirAccess.remove_absolute(CACHE_DIR + file)
+
+# Returns load time, first-call time, checksum, how many Functions run as
+# bytecode and how many of those chunks came from the cache.
+func run_pass(paths: PackedStringArray) -> Dictionary:
+    var start := Time.get_ticks_usec()
+    var scripts := []
+    for path in paths:
+        scripts.push_back(ResourceLoader.load(path, "", ResourceLoader.CACHE_MODE_IGNORE))
+    var loaded := Time.get_ticks_usec()
+
+    var checksum := 0
+    var nodes := []
+    for script in scripts:
+        var node := Node.new()
+        node.set_script(script)
+        root.add_child(node)
+        nodes.push_back(node)
+        for k in range(FUNCTIONS):
+            checksum += int(node.call("F%d" % k, 10))
+    var called := Time.get_ticks_usec()
+
+    var compiled := 0
+    var cached := 0
+    for script in scripts:
+        for k in range(FUNCTIONS):
+            var dump: Dictionary = script.debug_dump_bytecode("F%d" % k)
+            if not dump.has("error"):
+                compiled += 1
+            if dump.get("from_cache", false):
+                cached += 1
+    for node in nodes:
+        root.remove_child(node)
+        node.free()
+    return {"load_us": loaded - start, "call_us": called - loaded, "checksum": checksum,
+        "compiled": compiled, "cached": cached}
+
+func report(label: String, r: Dictionary) -> void:
+    print("%-10s load=%9d us  first calls=%9d us  total=%9d us  cached=%d  checksum=%d" % [
+        label, r["load_us"], r["call_us"], r["load_us"] + r["call_us"], r["cached"], r["checksum"]
+    ])
+
+func _init():
+    var paths := write_modules()
+    var previous = ProjectSettings.get_setting(CACHE_SETTING, true)
+
+    print("Cold-start benchmark (%d modules x %d Functions)" % [MODULES, FUNCTIONS])
+    ProjectSettings.set_setting(CACHE_SETTING, false)
+    var off := run_pass(paths)
+    report("no cache", off)
+
+    ProjectSettings.set_setting(CACHE_SETTING, true)
+    clear_cache()
+    var cold := run_pass(paths)
+    report("cold", cold)
+    var warm := run_pass(paths)
+    report("warm", warm)
+    ProjectSettings.set_setting(CACHE_SETTING, previous)
+
+    var failures := 0
+    if cold["checksum"] != off["checksum"] or warm["checksum"] != off["checksum"]:
+        push_error("Checksums differ between passes")
+        failures += 1
+    if warm["compiled"] == 0 or warm["cached"] != warm["compiled"]:
+        push_error("Warm pass compiled %d entries instead of reading them" % (warm["compiled"] - warm["cached"]))
+        failures += 1
+    quit(0 if failures == 0 else 1)
@@ -0,0 +1,70 @@
+extends SceneTree
+
+# Statement call benchmark: calls/second for a user Sub and for built-in
+# commands called as statements from a While loop (While runs on the AST
+# interpreter). Statement calls are bound to their Sub or command once, so
+# the Sub, a command of the first module (Randomize) and one of the last
+# (DrawLine, a no-op on a plain Node) should cost about the same.
+
+const CALLS := 1000000
+
+const SOURCE := """
+Dim hits As Long
+
+Sub Bump()
+    hits = hits + 1
+End Sub
+
+Function SubLoop(ByVal n As Long) As Long
+    Dim i As Long
+    hits = 0
+    While i < n
+        Bump
+        i = i + 1
+    Wend
+    SubLoop = hits
+End Function
+
+Function RandomizeLoop(ByVal n As Long) As Long
+    Dim i As Long
+    While i < n
+        Randomize
+        i = i + 1
+    Wend
+    RandomizeLoop = i
+End Function
+
+Function DrawLoop(ByVal n As Long) As Long
+    Dim i As Long
+    While i < n
+        DrawLine 0, 0, 1, 1
+        i = i + 1
+    Wend
+    DrawLoop = i
+End Function
+"""
+
+func _init():
+    var vg_script = VisualGasicScript.new()
+    vg_script.source_code = SOURCE
+    vg_script.reload(true)
+    var node := Node.new()
+    node.set_script(vg_script)
+    root.add_child(node)
+
+    print("Statement call benchmark (%d calls each)" % CALLS)
+    var failures := 0
+    for name in ["SubLoop", "RandomizeLoop", "DrawLoop"]:
+        var start := Time.get_ticks_usec()
+        var result = node.call(name, CALLS)
+        var elapsed := Time.get_ticks_usec() - start
+        print("%-14s %8d ms  %10.0f calls/s" % [
+            name, elapsed / 1000, float(CALLS) * 1000000.0 / max(elapsed, 1)
+        ])
+        if int(result) != CALLS:
+            push_error("%s returned %s, expected %d" % [name, str(result), CALLS])
+            failures += 1
+
+    root.remove_child(node)
+    node.free()
+    quit(0 if failures == 0 else 1)
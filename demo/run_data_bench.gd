@@ -0,0 +1,76 @@
+extends SceneTree
+
+# LoadData over a 1M-value data file. The C++ figures compare the old
+# LoadData (read the whole text, parse every value into an expression node
+# up front) with the DATA pool, which parses the file as READ advances:
+# time to the first value, time to read everything, and memory held. The
+# VB figure is a script doing LoadData and a READ loop over the same count.
+
+const VALUES := 1000000
+const DATA_PATH := "user://bench_data_vb.txt"
+
+const SOURCE := """
+Function ReadAll(ByVal path As String, ByVal n As Long) As Long
+    Dim i As Long
+    Dim v As Long
+    Dim sum As Long
+    LoadData path
+    For i = 1 To n
+        Read v
+        sum = sum + v
+    Next i
+    ReadAll = sum
+End Function
+"""
+
+func _init():
+    var failures := 0
+    print("LoadData benchmark, %d values" % VALUES)
+
+    var bench = VisualGasicBenchmark.new()
+    var cpp: Dictionary = bench.run_cpp_data_pool(VALUES)
+    print("%-16s %8s %10s %10s" % ["", "first ms", "total ms", "memory KB"])
+    print("%-16s %8d %10d %10d" % [
+        "C++ parse all", int(cpp["legacy_first_us"]) / 1000, int(cpp["legacy_us"]) / 1000, int(cpp["legacy_bytes"]) / 1024
+    ])
+    print("%-16s %8d %10d %10d" % [
+        "C++ DATA pool", int(cpp["pool_first_us"]) / 1000, int(cpp["pool_us"]) / 1000, int(cpp["pool_bytes"]) / 1024
+    ])
+    if int(cpp["checksum"]) <= 0:
+        push_error("run_cpp_data_pool checksum %s" % str(cpp["checksum"]))
+        failures += 1
+    bench.free()
+
+    var file := FileAccess.open(DATA_PATH, FileAccess.WRITE)
+    var line := PackedStringArray()
+    for i in VALUES:
+        line.append(str(i))
+        if line.size() == 16:
+            file.store_line(", ".join(line))
+            line.clear()
+    if not line.is_empty():
+        file.store_line(", ".join(line))
+    file.close()
+
+    var vg_script = VisualGasicScript.new()
+    vg_script.source_code = SOURCE
+    vg_script.reload(true)
+    var node := Node.new()
+    node.set_script(vg_script)
+    root.add_child(node)
+
+    var start := Time.get_ticks_usec()
+    var result = node.call("ReadAll", DATA_PATH, VALUES)
+    var elapsed := Time.get_ticks_usec() - start
+    print("%-16s %8s %10d %10s  %.0f values/s" % [
+        "VB LoadData+Read", "", elapsed / 1000, "", float(VALUES) * 1000000.0 / max(elapsed, 1)
+    ])
+    var expected := VALUES * (VALUES - 1) / 2
+    if int(result) != expected:
+        push_error("ReadAll returned %s, expected %d" % [str(result), expected])
+        failures += 1
+
+    root.remove_child(node)
+    node.free()
+    DirAccess.remove_absolute(DATA_PATH)
+    quit(0 if failures == 0 else 1)
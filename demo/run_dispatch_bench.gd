@@ -0,0 +1,106 @@
+extends SceneTree
+
+# Dispatch microbenchmark: times BenchArithmetic / BenchBranch from bench.vg
+# plus unfused copies of the same loops (two statements per body so the loop
+# fusions do not collapse them into one opcode). Run once per build flavour;
+# `make -f Makefile.tests bench-dispatch` builds the switch and threaded
+# loops back to back and passes --dispatch=<label>.
+
+const ITER := 200
+const INNER := 1000
+const REPEATS := 5
+
+const UNFUSED_SOURCE := """
+Function DispatchArithmetic(ByVal iterations As Long, ByVal inner As Long) As Long
+    Dim i As Long
+    Dim j As Long
+    Dim s As Long
+    Dim t As Long
+
+    For i = 0 To iterations - 1 Step 1
+        For j = 0 To inner - 1 Step 1
+            s = s + (j * 3) - 7
+            t = t + 1
+        Next j
+    Next i
+
+    DispatchArithmetic = s + t
+End Function
+
+Function DispatchBranch(ByVal iterations As Long, ByVal inner As Long) As Long
+    Dim i As Long
+    Dim j As Long
+    Dim s As Long
+    Dim flag As Long
+    Dim t As Long
+
+    For i = 0 To iterations - 1 Step 1
+        flag = 0
+        For j = 0 To inner - 1 Step 1
+            If flag = 0 Then
+                s = s + j
+                flag = 1
+            Else
+                s = s - j
+                flag = 0
+            End If
+            t = t + 1
+        Next j
+    Next i
+
+    DispatchBranch = s + t
+End Function
+"""
+
+func time_best(node: Node, entry: String) -> Dictionary:
+    var best := -1
+    var value = null
+    for _r in range(REPEATS):
+        var start := Time.get_ticks_usec()
+        value = node.call(entry, ITER, INNER)
+        var elapsed := Time.get_ticks_usec() - start
+        if best < 0 or elapsed < best:
+            best = elapsed
+    return {"elapsed_us": best, "value": value}
+
+func attach(script: Script) -> Node:
+    var node := Node.new()
+    node.set_script(script)
+    root.add_child(node)
+    return node
+
+func _init():
+    var label := "unknown"
+    for arg in OS.get_cmdline_user_args() + OS.get_cmdline_args():
+        if String(arg).begins_with("--dispatch="):
+            label = String(arg).substr(11)
+
+    var bench_script = load("res://bench.vg")
+    var unfused_script = VisualGasicScript.new()
+    unfused_script.source_code = UNFUSED_SOURCE
+    unfused_script.reload(true)
+    if bench_script == null:
+        push_error("Failed to load bench.vg")
+        quit(1)
+        return
+
+    var bench_node := attach(bench_script)
+    var unfused_node := attach(unfused_script)
+
+    print("Dispatch benchmark [%s] (best of %d, %dx%d)" % [label, REPEATS, ITER, INNER])
+    var cases := [
+        [bench_node, "BenchArithmetic"],
+        [bench_node, "BenchBranch"],
+        [unfused_node, "DispatchArithmetic"],
+        [unfused_node, "DispatchBranch"],
+    ]
+    for c in cases:
+        var node: Node = c[0]
+        node.call(c[1], 1, 1) # compile before timing
+        var r := time_best(node, c[1])
+        print("%-20s %10d us  checksum=%s" % [c[1], r["elapsed_us"], str(r["value"])])
+
+    for node in [bench_node, unfused_node]:
+        root.remove_child(node)
+        node.free()
+    quit(0)
@@ -0,0 +1,75 @@
+extends SceneTree
+
+# PSet throughput as pixels per 60 FPS frame (16.7 ms). The C++ figures
+# are the per-frame cost of the two drawing backends on their own:
+# batching every pixel into one triangle array, and writing every pixel
+# into the SetFramebuffer image and uploading it. The VB figure is a
+# script filling the framebuffer with PSet from a For loop, which is what
+# a game pays per frame before the upload.
+
+const WIDTH := 320
+const HEIGHT := 180
+const FRAMES := 60
+
+const SOURCE := """
+Sub Setup(ByVal w As Long, ByVal h As Long)
+    SetFramebuffer w, h, 2
+End Sub
+
+Function FillFrame(ByVal w As Long, ByVal h As Long, ByVal frame As Long) As Long
+    Dim x As Long
+    Dim y As Long
+    Dim n As Long
+    For y = 0 To h - 1
+        For x = 0 To w - 1
+            PSet x, y, Color(((x + frame) Mod 256) / 255, (y Mod 256) / 255, 0.5)
+            n = n + 1
+        Next x
+    Next y
+    FillFrame = n
+End Function
+"""
+
+const FRAME_US := 1000000.0 / 60.0
+
+func _init():
+    var failures := 0
+    var pixels := WIDTH * HEIGHT
+    print("PSet benchmark, %dx%d (%d pixels), %d frames" % [WIDTH, HEIGHT, pixels, FRAMES])
+
+    var bench = VisualGasicBenchmark.new()
+    var cpp: Dictionary = bench.run_cpp_draw_batch(WIDTH, HEIGHT, FRAMES)
+    print("%-22s %9.1f us/frame  %12d pixels/frame" % [
+        "C++ batch build", cpp["batch_frame_us"], cpp["batch_pixels_per_frame"]
+    ])
+    print("%-22s %9.1f us/frame  %12d pixels/frame" % [
+        "C++ framebuffer", cpp["framebuffer_frame_us"], cpp["framebuffer_pixels_per_frame"]
+    ])
+    if int(cpp["checksum"]) != FRAMES:
+        push_error("run_cpp_draw_batch checksum %s" % str(cpp["checksum"]))
+        failures += 1
+    bench.free()
+
+    var vg_script = VisualGasicScript.new()
+    vg_script.source_code = SOURCE
+    vg_script.reload(true)
+    var node := Node2D.new()
+    node.set_script(vg_script)
+    root.add_child(node)
+    node.call("Setup", WIDTH, HEIGHT)
+
+    var start := Time.get_ticks_usec()
+    for frame in FRAMES:
+        var count = node.call("FillFrame", WIDTH, HEIGHT, frame)
+        if int(count) != pixels:
+            push_error("FillFrame returned %s, expected %d" % [str(count), pixels])
+            failures += 1
+            break
+    var frame_us := float(Time.get_ticks_usec() - start) / FRAMES
+    print("%-22s %9.1f us/frame  %12d pixels/frame" % [
+        "VB PSet framebuffer", frame_us, int(pixels * FRAME_US / max(frame_us, 0.001))
+    ])
+
+    root.remove_child(node)
+    node.free()
+    quit(0 if failures == 0 else 1)
@@ -0,0 +1,92 @@
+extends SceneTree
+
+# Declare (FFI) call benchmark against tools/ffi_test_lib.c: calls/second for
+# an integer, a floating-point, a String and a twelve-argument native
+# function, each called from a VB loop. Build the library first with
+#   make -f Makefile.tests ffi-test-lib
+
+const CALLS := 1000000
+const LIBRARY := "res://bin/libvgffitest.so"
+
+func build_source(lib_path: String) -> String:
+    var lib := "Lib \"%s\"" % lib_path
+    return """
+Declare Function vg_add %s (ByVal a As Long, ByVal b As Long) As Long
+Declare Function vg_lerp %s (ByVal a As Double, ByVal b As Double, ByVal t As Double) As Double
+Declare Function vg_strlen %s (ByVal s As String) As Integer
+Declare Function vg_sum12 %s (ByVal a As Long, ByVal b As Double, ByVal c As Integer, ByVal d As Single, ByVal e As Long, ByVal f As Double, ByVal g As Integer, ByVal h As Double, ByVal i As Long, ByVal j As Double, ByVal k As Long, ByVal l As Double) As Double
+
+Function AddLoop(ByVal n As Long) As Long
+    Dim i As Long
+    Dim s As Long
+    For i = 1 To n
+        s = vg_add(s, 1)
+    Next i
+    AddLoop = s
+End Function
+
+Function LerpLoop(ByVal n As Long) As Double
+    Dim i As Long
+    Dim x As Double
+    For i = 1 To n
+        x = vg_lerp(x, 1, 0.5)
+    Next i
+    LerpLoop = x
+End Function
+
+Function StrlenLoop(ByVal n As Long) As Long
+    Dim i As Long
+    Dim s As Long
+    For i = 1 To n
+        s = s + vg_strlen("visual")
+    Next i
+    StrlenLoop = s
+End Function
+
+Function Sum12Loop(ByVal n As Long) As Double
+    Dim i As Long
+    Dim s As Double
+    For i = 1 To n
+        s = vg_sum12(1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1)
+    Next i
+    Sum12Loop = s
+End Function
+""" % [lib, lib, lib, lib]
+
+func _init():
+    var lib_path := ProjectSettings.globalize_path(LIBRARY)
+    if not FileAccess.file_exists(lib_path):
+        push_error("%s not found; run make -f Makefile.tests ffi-test-lib" % lib_path)
+        quit(1)
+        return
+
+    var vg_script = VisualGasicScript.new()
+    vg_script.source_code = build_source(lib_path)
+    vg_script.reload(true)
+    var node := Node.new()
+    node.set_script(vg_script)
+    root.add_child(node)
+
+    print("Declare call benchmark (%d calls each)" % CALLS)
+    var failures := 0
+    var cases := [
+        ["AddLoop", CALLS],
+        ["LerpLoop", 1.0],
+        ["StrlenLoop", CALLS * 6],
+        ["Sum12Loop", 12.0],
+    ]
+    for entry in cases:
+        var name: String = entry[0]
+        var start := Time.get_ticks_usec()
+        var result = node.call(name, CALLS)
+        var elapsed := Time.get_ticks_usec() - start
+        print("%-12s %8d ms  %10.0f calls/s" % [
+            name, elapsed / 1000, float(CALLS) * 1000000.0 / max(elapsed, 1)
+        ])
+        if absf(float(result) - float(entry[1])) > 0.001:
+            push_error("%s returned %s, expected %s" % [name, str(result), str(entry[1])])
+            failures += 1
+
+    root.remove_child(node)
+    node.free()
+    quit(0 if failures == 0 else 1)
@@ -0,0 +1,103 @@
+extends SceneTree
+
+# AST loop benchmark: 10M-iteration For, While and Do loops on the tree-walking
+# interpreter (While/Do and Exit For are not compiled to bytecode), then the
+# optional loop watchdog stopping a runaway loop.
+
+const ITERATIONS := 10000000
+const WATCHDOG_BUDGET := 1000
+const WATCHDOG_SETTING := "visual_gasic/runtime/loop_watchdog_iterations"
+
+const SOURCE := """
+Function ForLong(ByVal n As Long) As Long
+    Dim i As Long
+    Dim s As Long
+    For i = 1 To n
+        s = s + 1
+        If s < 0 Then Exit For
+    Next i
+    ForLong = s
+End Function
+
+Function ForStepDown(ByVal n As Long) As Long
+    Dim i As Long
+    Dim s As Long
+    For i = n To 1 Step -2
+        s = s + 1
+        If s < 0 Then Exit For
+    Next i
+    ForStepDown = s
+End Function
+
+Function WhileLoop(ByVal n As Long) As Long
+    Dim i As Long
+    While i < n
+        i = i + 1
+    Wend
+    WhileLoop = i
+End Function
+
+Function DoLoop(ByVal n As Long) As Long
+    Dim i As Long
+    Do
+        i = i + 1
+    Loop Until i >= n
+    DoLoop = i
+End Function
+"""
+
+const CASES := [
+    ["ForLong", ITERATIONS],
+    ["ForStepDown", ITERATIONS / 2],
+    ["WhileLoop", ITERATIONS],
+    ["DoLoop", ITERATIONS],
+]
+
+func make_node() -> Node:
+    var vg_script = VisualGasicScript.new()
+    vg_script.source_code = SOURCE
+    vg_script.reload(true)
+    var node := Node.new()
+    node.set_script(vg_script)
+    root.add_child(node)
+    return node
+
+func free_node(node: Node) -> void:
+    root.remove_child(node)
+    node.free()
+
+func _init():
+    var failures := 0
+    var previous = ProjectSettings.get_setting(WATCHDOG_SETTING, 0)
+    ProjectSettings.set_setting(WATCHDOG_SETTING, 0)
+
+    print("AST loop benchmark (%d iterations)" % ITERATIONS)
+    var node := make_node()
+    for case in CASES:
+        var entry: String = case[0]
+        var expected: int = case[1]
+        var start := Time.get_ticks_usec()
+        var result = node.call(entry, ITERATIONS)
+        var elapsed := Time.get_ticks_usec() - start
+        print("%-12s %8d ms  %6.1f ns/iter  result=%d" % [
+            entry, elapsed / 1000, float(elapsed) * 1000.0 / expected, int(result)
+        ])
+        if int(result) != expected:
+            push_error("%s returned %d, expected %d" % [entry, int(result), expected])
+            failures += 1
+    free_node(node)
+
+    # The watchdog is read when the instance is created.
+    ProjectSettings.set_setting(WATCHDOG_SETTING, WATCHDOG_BUDGET)
+    node = make_node()
+    var watch_start := Time.get_ticks_usec()
+    node.call("WhileLoop", ITERATIONS)
+    var watch_us := Time.get_ticks_usec() - watch_start
+    print("Watchdog (%d iterations): WhileLoop stopped after %d us" % [WATCHDOG_BUDGET, watch_us])
+    if watch_us > 1000000:
+        push_error("Watchdog did not stop WhileLoop")
+        failures += 1
+    free_node(node)
+    ProjectSettings.set_setting(WATCHDOG_SETTING, previous)
+
+    quit(0 if failures == 0 else 1)
@@ -0,0 +1,339 @@
+extends SceneTree
+
+# Loop corpus: everyday variations of the bench.vg loop shapes (an extra
+# term, a different step, an offset or scaled index, 2D indexing, Double
+# state). None of them match a fused template, so they exercise the general
+# register-loop pipeline: invariant hoisting, derived induction registers and
+# array range guards. Each variant must compile to register loops, agree
+# with GDScript and run at least MIN_GD_SPEEDUP times as fast as it; times
+# are printed next to the bench shape it varies. Most bench shapes are
+# closed-form fusions, so their times are shown for reference only.
+#
+# FindRun leaves its loop with Exit For before the counter would index past
+# the array, so its reads must not be range-guarded up front: a failed guard
+# would re-run the whole Function on the AST path.
+
+const ITER := 200
+const INNER := 1000
+const REPEATS := 5
+const MIN_GD_SPEEDUP := 1.0
+
+const SOURCE := """
+Function ArithPlusOuter(ByVal iterations As Long, ByVal inner As Long) As Long
+    Dim i As Long
+    Dim j As Long
+    Dim s As Long
+    For i = 0 To iterations - 1
+        For j = 0 To inner - 1
+            s = s + j * 3 - 7 + i
+        Next j
+    Next i
+    ArithPlusOuter = s
+End Function
+
+Function ArithStride(ByVal iterations As Long, ByVal inner As Long) As Long
+    Dim i As Long
+    Dim j As Long
+    Dim s As Long
+    For i = 0 To iterations - 1
+        For j = 0 To inner * 2 - 1 Step 2
+            s = s + (j * 3 + 1) * 2 - 7
+        Next j
+    Next i
+    ArithStride = s
+End Function
+
+Function ArrayPairSum(ByVal iterations As Long, ByVal size As Long) As Long
+    Dim i As Long
+    Dim k As Long
+    Dim s As Long
+    Dim arr(0) As Long
+    ReDim arr(size - 1)
+    For i = 0 To size - 1
+        arr(i) = i
+    Next i
+    For k = 0 To iterations - 1
+        For i = 0 To size - 2
+            s = s + arr(i) + arr(i + 1)
+        Next i
+    Next k
+    ArrayPairSum = s
+End Function
+
+Function ArrayScaledSum(ByVal iterations As Long, ByVal size As Long) As Long
+    Dim i As Long
+    Dim k As Long
+    Dim w As Long
+    Dim s As Long
+    Dim arr(0) As Long
+    ReDim arr(size - 1)
+    For i = 0 To size - 1
+        arr(i) = i
+    Next i
+    For k = 0 To iterations - 1
+        w = k + 1
+        For i = 0 To size - 1
+            s = s + arr(i) * (w * 2 + 1)
+        Next i
+    Next k
+    ArrayScaledSum = s
+End Function
+
+Function BranchPivot(ByVal iterations As Long, ByVal inner As Long) As Long
+    Dim i As Long
+    Dim j As Long
+    Dim s As Long
+    Dim pivot As Long
+    pivot = inner - 250
+    For i = 0 To iterations - 1
+        For j = 0 To inner - 1
+            If j < pivot Then
+                s = s + j
+            Else
+                s = s - j
+            End If
+        Next j
+    Next i
+    BranchPivot = s
+End Function
+
+Function GridSum(ByVal iterations As Long, ByVal w As Long) As Long
+    Dim x As Long
+    Dim y As Long
+    Dim k As Long
+    Dim h As Long
+    Dim s As Long
+    Dim grid(0) As Long
+    h = 20
+    ReDim grid(w * h - 1)
+    For x = 0 To w * h - 1
+        grid(x) = x
+    Next x
+    For k = 0 To iterations - 1
+        For y = 0 To h - 1
+            For x = 0 To w - 1
+                s = s + grid(y * w + x)
+            Next x
+        Next y
+    Next k
+    GridSum = s
+End Function
+
+Function FindRun(ByVal iterations As Long, ByVal size As Long) As Long
+    Dim i As Long
+    Dim k As Long
+    Dim s As Long
+    Dim arr(0) As Long
+    ReDim arr(size - 1)
+    For i = 0 To size - 1
+        arr(i) = i
+    Next i
+    For k = 0 To iterations - 1
+        For i = 0 To size * 2
+            If i = size - 1 Then Exit For
+            s = s + arr(i + 1)
+        Next i
+    Next k
+    FindRun = s
+End Function
+
+Function Integrate(ByVal iterations As Long, ByVal inner As Long) As Double
+    Dim i As Long
+    Dim j As Long
+    Dim x As Double
+    Dim v As Double
+    Dim dt As Double
+    Dim g As Double
+    dt = 0.016
+    g = 9.8
+    For i = 0 To iterations - 1
+        v = 3.5
+        For j = 0 To inner - 1
+            v = v - g * dt
+            x = x + v * dt
+        Next j
+    Next i
+    Integrate = x
+End Function
+"""
+
+var _failures := 0
+
+func gd_arith_plus_outer(iterations: int, inner: int) -> int:
+    var s := 0
+    for i in range(iterations):
+        for j in range(inner):
+            s = s + j * 3 - 7 + i
+    return s
+
+func gd_arith_stride(iterations: int, inner: int) -> int:
+    var s := 0
+    for _i in range(iterations):
+        for j in range(0, inner * 2, 2):
+            s = s + (j * 3 + 1) * 2 - 7
+    return s
+
+func gd_array_pair_sum(iterations: int, size: int) -> int:
+    var arr := PackedInt64Array()
+    arr.resize(size)
+    for i in range(size):
+        arr[i] = i
+    var s := 0
+    for _k in range(iterations):
+        for i in range(size - 1):
+            s = s + arr[i] + arr[i + 1]
+    return s
+
+func gd_array_scaled_sum(iterations: int, size: int) -> int:
+    var arr := PackedInt64Array()
+    arr.resize(size)
+    for i in range(size):
+        arr[i] = i
+    var s := 0
+    for k in range(iterations):
+        var w := k + 1
+        for i in range(size):
+            s = s + arr[i] * (w * 2 + 1)
+    return s
+
+func gd_branch_pivot(iterations: int, inner: int) -> int:
+    var s := 0
+    var pivot := inner - 250
+    for _i in range(iterations):
+        for j in range(inner):
+            if j < pivot:
+                s = s + j
+            else:
+                s = s - j
+    return s
+
+func gd_grid_sum(iterations: int, w: int) -> int:
+    var h := 20
+    var grid := PackedInt64Array()
+    grid.resize(w * h)
+    for x in range(w * h):
+        grid[x] = x
+    var s := 0
+    for _k in range(iterations):
+        for y in range(h):
+            for x in range(w):
+                s = s + grid[y * w + x]
+    return s
+
+func gd_find_run(iterations: int, size: int) -> int:
+    var arr := PackedInt64Array()
+    arr.resize(size)
+    for i in range(size):
+        arr[i] = i
+    var s := 0
+    for _k in range(iterations):
+        for i in range(size * 2 + 1):
+            if i == size - 1:
+                break
+            s = s + arr[i + 1]
+    return s
+
+func gd_integrate(iterations: int, inner: int) -> float:
+    var x := 0.0
+    var dt := 0.016
+    var g := 9.8
+    for _i in range(iterations):
+        var v := 3.5
+        for _j in range(inner):
+            v = v - g * dt
+            x = x + v * dt
+    return x
+
+func time_best(fn: Callable) -> Dictionary:
+    var best := -1
+    var value = null
+    for _r in range(REPEATS):
+        var start := Time.get_ticks_usec()
+        value = fn.call()
+        var elapsed := Time.get_ticks_usec() - start
+        if best < 0 or elapsed < best:
+            best = elapsed
+    return {"elapsed_us": best, "value": value}
+
+func opcode_count(script, entry: String, opcode: String) -> int:
+    var dump: Dictionary = script.debug_dump_bytecode(entry)
+    if dump.has("error"):
+        return -1
+    var count := 0
+    for inst in dump.get("instructions", []):
+        if String(inst["name"]) == opcode:
+            count += 1
+    return count
+
+func attach(script: Script) -> Node:
+    var node := Node.new()
+    node.set_script(script)
+    root.add_child(node)
+    return node
+
+func _init():
+    var bench_script = load("res://bench.vg")
+    if bench_script == null:
+        push_error("Failed to load bench.vg")
+        quit(1)
+        return
+    var corpus_script = VisualGasicScript.new()
+    corpus_script.source_code = SOURCE
+    corpus_script.reload(true)
+
+    var bench_node := attach(bench_script)
+    var corpus_node := attach(corpus_script)
+
+    # [variant, bench shape it varies, GDScript reference, range guards allowed]
+    var cases := [
+        ["ArithPlusOuter", "BenchArithmetic", gd_arith_plus_outer, true],
+        ["ArithStride", "BenchArithmetic", gd_arith_stride, true],
+        ["ArrayPairSum", "BenchArraySum", gd_array_pair_sum, true],
+        ["ArrayScaledSum", "BenchArraySum", gd_array_scaled_sum, true],
+        ["BranchPivot", "BenchBranch", gd_branch_pivot, true],
+        ["GridSum", "BenchArraySum", gd_grid_sum, true],
+        ["FindRun", "BenchArraySum", gd_find_run, false],
+        ["Integrate", "", gd_integrate, true],
+    ]
+
+    print("Loop corpus (best of %d, %dx%d)" % [REPEATS, ITER, INNER])
+    for c in cases:
+        var entry: String = c[0]
+        var shape: String = c[1]
+        var gd_fn: Callable = c[2]
+        var guards_allowed: bool = c[3]
+        corpus_node.call(entry, 1, INNER) # compile before timing
+        var loops := opcode_count(corpus_script, entry, "OP_R_JUMP_IF_NOT_I64")
+        var guards := opcode_count(corpus_script, entry, "OP_R_GUARD_ARRAY")
+        var vg := time_best(func(): return corpus_node.call(entry, ITER, INNER))
+        var gd := time_best(func(): return gd_fn.call(ITER, INNER))
+        var shape_us := 0
+        if shape != "":
+            bench_node.call(shape, 1, INNER)
+            shape_us = int(time_best(func(): return bench_node.call(shape, ITER, INNER))["elapsed_us"])
+        var same: bool = is_equal_approx(float(vg["value"]), float(gd["value"]))
+        var speedup := float(gd["elapsed_us"]) / max(int(vg["elapsed_us"]), 1)
+        var status := "ok"
+        if loops <= 0:
+            status = "NOT COMPILED TO REGISTER LOOPS"
+        elif not same:
+            status = "MISMATCH gd=%s vg=%s" % [str(gd["value"]), str(vg["value"])]
+        elif guards > 0 and not guards_allowed:
+            status = "RANGE GUARD AHEAD OF AN EXIT"
+        elif speedup < MIN_GD_SPEEDUP:
+            status = "SLOWER THAN EXPECTED (%.2fx GDScript, want %.2fx)" % [speedup, MIN_GD_SPEEDUP]
+        if status != "ok":
+            _failures += 1
+        print("%-15s vg=%9d us  %-16s %9d us  gd=%9d us  %5.2fx  %s" % [
+            entry, vg["elapsed_us"], shape if shape != "" else "-", shape_us, gd["elapsed_us"], speedup, status
+        ])
+
+    for node in [bench_node, corpus_node]:
+        root.remove_child(node)
+        node.free()
+
+    if _failures == 0:
+        quit(0)
+    else:
+        push_error("Loop corpus failed (%d)" % _failures)
+        quit(1)
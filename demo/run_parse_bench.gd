@@ -0,0 +1,102 @@
+extends SceneTree
+
+# Parser benchmark: parses a generated module of roughly 50k lines and
+# reports parse time, the memory held by its AST arena and the process peak
+# RSS (VmHWM). Full parses use a fresh script each time; a second set of
+# passes edits the body of one Function between reloads of the same script,
+# which only re-parses that Function.
+
+const TARGET_LINES := 50000
+const PASSES := 3
+
+func module_source() -> String:
+    var parts := PackedStringArray()
+    var lines := 0
+    var k := 0
+    while lines < TARGET_LINES:
+        parts.push_back("""
+Function F%d(ByVal n As Long) As Long
+    Dim i As Long
+    Dim s As Long
+    Dim t As Double
+    Dim msg As String
+    For i = 1 To n
+        s = s + i * %d - (i Mod 7)
+        t = t + i * 0.5
+        If s > 100000 Then
+            s = s - 100000
+        ElseIf s < 0 Then
+            s = -s
+        End If
+    Next i
+    msg = "F%d done: " & s
+    F%d = s + t
+End Function
+""" % [k, k + 1, k, k])
+        lines += 18
+        k += 1
+    return "".join(parts)
+
+# Linux only; returns -1 elsewhere.
+func peak_rss_kb() -> int:
+    var f := FileAccess.open("/proc/self/status", FileAccess.READ)
+    if f == null:
+        return -1
+    while not f.eof_reached():
+        var line := f.get_line()
+        if line.begins_with("VmHWM:"):
+            return int(line.substr(6).strip_edges().split(" ")[0])
+    return -1
+
+func _init():
+    var source := module_source()
+    var line_count := source.count("\n")
+    print("Parser benchmark (%d lines, %d bytes)" % [line_count, source.length()])
+    var rss_before := peak_rss_kb()
+
+    var script: VisualGasicScript
+    var failures := 0
+    var best := 0
+    for pass_index in range(PASSES):
+        script = VisualGasicScript.new()
+        script.source_code = source
+        var start := Time.get_ticks_usec()
+        var err := script.reload()
+        var elapsed := Time.get_ticks_usec() - start
+        if err != OK:
+            push_error("reload() failed with %d" % err)
+            failures += 1
+            break
+        best = elapsed if pass_index == 0 else mini(best, elapsed)
+        print("pass %d: %9d us  (%.0f lines/ms)" % [pass_index, elapsed, line_count / (elapsed / 1000.0)])
+
+    var edited_best := 0
+    for pass_index in range(PASSES):
+        script.source_code = source.replace("F%d = s + t" % (pass_index * 100), "F%d = s + t + %d" % [pass_index * 100, pass_index + 1])
+        var start := Time.get_ticks_usec()
+        var err := script.reload()
+        var elapsed := Time.get_ticks_usec() - start
+        if err != OK:
+            push_error("reload() after an edit failed with %d" % err)
+            failures += 1
+            break
+        edited_best = elapsed if pass_index == 0 else mini(edited_best, elapsed)
+        var edit_stats: Dictionary = script.debug_ast_stats()
+        print("edit %d: %9d us  reused %d/%d Subs" % [pass_index, elapsed, edit_stats["reused_subs"], edit_stats["subs"]])
+        if edit_stats["reused_subs"] != edit_stats["subs"] - 1:
+            push_error("Expected every Sub but the edited one to be reused")
+            failures += 1
+    print("one-Function edit: best=%d us (full parse best=%d us)" % [edited_best, best])
+
+    var stats: Dictionary = script.debug_ast_stats()
+    if stats.has("error"):
+        push_error(stats["error"])
+        failures += 1
+    else:
+        print("best=%d us  subs=%d  arena allocated=%d KB reserved=%d KB" % [
+            best, stats["subs"], stats["bytes_allocated"] / 1024, stats["bytes_reserved"] / 1024
+        ])
+    var rss_after := peak_rss_kb()
+    if rss_after >= 0:
+        print("peak RSS: %d KB before, %d KB after (+%d KB)" % [rss_before, rss_after, rss_after - rss_before])
+    quit(0 if failures == 0 else 1)
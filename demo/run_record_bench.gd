@@ -0,0 +1,88 @@
+extends SceneTree
+
+# Record I/O throughput. The C++ figures write and read back RECORDS
+# fixed-length records with a FileAccess call per record, then through the
+# buffered VisualGasicFile layer that Open uses. The VB figures are scripts
+# doing the same with Put/Get on a Random file, and writing lines with
+# Print # and reading them back with Line Input #.
+
+const RECORDS := 200000
+const RECORD_LENGTH := 32
+const LINES := 200000
+
+const SOURCE := """
+Function RecordLoop(ByVal n As Long) As Long
+    Dim i As Long
+    Dim v As Long
+    Dim sum As Long
+    Open "user://bench_records_vb.dat" For Random As #1 Len = 32
+    For i = 1 To n
+        v = i
+        Put #1, i, v
+    Next i
+    For i = 1 To n
+        Get #1, i, v
+        sum = sum + v
+    Next i
+    Close #1
+    RecordLoop = sum
+End Function
+
+Function LineLoop(ByVal n As Long) As Long
+    Dim i As Long
+    Dim s As String
+    Dim count As Long
+    Open "user://bench_lines_vb.txt" For Output As #1
+    For i = 1 To n
+        Print #1, "line"
+    Next i
+    Close #1
+    Open "user://bench_lines_vb.txt" For Input As #1
+    While Not EOF(1)
+        Line Input #1, s
+        count = count + 1
+    Wend
+    Close #1
+    LineLoop = count
+End Function
+"""
+
+func _init():
+    var failures := 0
+    print("Record I/O benchmark, %d records of %d bytes" % [RECORDS, RECORD_LENGTH])
+
+    var bench = VisualGasicBenchmark.new()
+    var cpp: Dictionary = bench.run_cpp_record_io(RECORDS, RECORD_LENGTH)
+    print("%-22s %8d ms" % ["C++ per-record calls", int(cpp["direct_us"]) / 1000])
+    print("%-22s %8d ms  (%.1fx)" % ["C++ buffered", int(cpp["buffered_us"]) / 1000, cpp["speedup"]])
+    var expected_sum := RECORDS * (RECORDS - 1) / 2
+    if int(cpp["checksum"]) != expected_sum:
+        push_error("run_cpp_record_io checksum %s, expected %d" % [str(cpp["checksum"]), expected_sum])
+        failures += 1
+    bench.free()
+
+    var vg_script = VisualGasicScript.new()
+    vg_script.source_code = SOURCE
+    vg_script.reload(true)
+    var node := Node.new()
+    node.set_script(vg_script)
+    root.add_child(node)
+
+    var runs := [
+        ["VB Put/Get", "RecordLoop", RECORDS, RECORDS * (RECORDS + 1) / 2],
+        ["VB Print #/Line Input", "LineLoop", LINES, LINES],
+    ]
+    for run in runs:
+        var start := Time.get_ticks_usec()
+        var result = node.call(run[1], run[2])
+        var elapsed := Time.get_ticks_usec() - start
+        print("%-22s %8d ms  %10.0f ops/s" % [
+            run[0], elapsed / 1000, float(run[2]) * 2.0 * 1000000.0 / max(elapsed, 1)
+        ])
+        if int(result) != run[3]:
+            push_error("%s returned %s, expected %d" % [run[1], str(result), run[3]])
+            failures += 1
+
+    root.remove_child(node)
+    node.free()
+    quit(0 if failures == 0 else 1)
@@ -0,0 +1,101 @@
+extends SceneTree
+
+# Recursion benchmark: calls per second for Fib and Ackermann in VisualGasic
+# (user-to-user calls through OP_CALL_USER frames) next to the same code in
+# GDScript. Call counts come from the GDScript run.
+
+const FIB_N := 22
+const ACK_M := 2
+const ACK_N := 200
+const REPEATS := 3
+
+const SOURCE := """
+Function Fib(ByVal n As Long) As Long
+    If n < 2 Then
+        Fib = n
+    Else
+        Fib = Fib(n - 1) + Fib(n - 2)
+    End If
+End Function
+
+Function Ackermann(ByVal m As Long, ByVal n As Long) As Long
+    If m = 0 Then
+        Ackermann = n + 1
+    ElseIf n = 0 Then
+        Ackermann = Ackermann(m - 1, 1)
+    Else
+        Ackermann = Ackermann(m - 1, Ackermann(m, n - 1))
+    End If
+End Function
+"""
+
+var _calls := 0
+
+func gd_fib(n: int) -> int:
+    _calls += 1
+    if n < 2:
+        return n
+    return gd_fib(n - 1) + gd_fib(n - 2)
+
+func gd_ackermann(m: int, n: int) -> int:
+    _calls += 1
+    if m == 0:
+        return n + 1
+    if n == 0:
+        return gd_ackermann(m - 1, 1)
+    return gd_ackermann(m - 1, gd_ackermann(m, n - 1))
+
+func time_best(fn: Callable) -> Dictionary:
+    var best := -1
+    var value = null
+    for _r in range(REPEATS):
+        var start := Time.get_ticks_usec()
+        value = fn.call()
+        var elapsed := Time.get_ticks_usec() - start
+        if best < 0 or elapsed < best:
+            best = elapsed
+    return {"elapsed_us": best, "value": value}
+
+func report(label: String, calls: int, gd: Dictionary, vg: Dictionary) -> void:
+    if gd["value"] != vg["value"]:
+        push_warning("%s checksum mismatch: gd=%s vg=%s" % [label, str(gd["value"]), str(vg["value"])])
+    var gd_us: int = max(int(gd["elapsed_us"]), 1)
+    var vg_us: int = max(int(vg["elapsed_us"]), 1)
+    var gd_rate: float = float(calls) / gd_us * 1000000.0
+    var vg_rate: float = float(calls) / vg_us * 1000000.0
+    print("%-16s calls=%9d  gd=%12.0f calls/s  vg=%12.0f calls/s  (vg %.2fx gd time)" % [
+        label, calls, gd_rate, vg_rate, float(vg_us) / gd_us
+    ])
+
+func _init():
+    var vg_script = VisualGasicScript.new()
+    vg_script.source_code = SOURCE
+    vg_script.reload(true)
+
+    var node := Node.new()
+    node.set_script(vg_script)
+    root.add_child(node)
+
+    # Compile both entry points before timing.
+    node.call("Fib", 2)
+    node.call("Ackermann", 1, 1)
+
+    print("Recursion benchmark (best of ", REPEATS, ")")
+
+    _calls = 0
+    gd_fib(FIB_N)
+    var fib_calls := _calls
+    var gd := time_best(func(): return gd_fib(FIB_N))
+    var vg := time_best(func(): return node.call("Fib", FIB_N))
+    report("Fib(%d)" % FIB_N, fib_calls, gd, vg)
+
+    _calls = 0
+    gd_ackermann(ACK_M, ACK_N)
+    var ack_calls := _calls
+    gd = time_best(func(): return gd_ackermann(ACK_M, ACK_N))
+    vg = time_best(func(): return node.call("Ackermann", ACK_M, ACK_N))
+    report("Ackermann(%d,%d)" % [ACK_M, ACK_N], ack_calls, gd, vg)
+
+    root.remove_child(node)
+    node.free()
+    quit(0)
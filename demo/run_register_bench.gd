@@ -0,0 +1,128 @@
+extends SceneTree
+
+# Register-tier benchmark: gameplay-style inner loops over typed Long and
+# Double locals, timed against the same code in GDScript. The bytecode dump
+# must show the loops compiled to register ops (OP_R_*) rather than the
+# value stack.
+
+const STEPS := 200000
+const REPEATS := 5
+
+const SOURCE := """
+Function Integrate(ByVal steps As Long) As Double
+    Dim i As Long
+    Dim x As Double
+    Dim v As Double
+    Dim dt As Double
+    dt = 0.016
+    v = 3.5
+    For i = 1 To steps
+        v = v - 9.8 * dt
+        x = x + v * dt
+        If i = 1000 Then
+            v = 3.5
+        End If
+    Next i
+    Integrate = x
+End Function
+
+Function Accumulate(ByVal steps As Long) As Long
+    Dim i As Long
+    Dim s As Long
+    Dim t As Long
+    For i = 1 To steps
+        s = s + i * 3 - 7
+        t = t + 1
+        If t > 100 Then
+            t = 0
+        End If
+    Next i
+    Accumulate = s + t
+End Function
+"""
+
+var _failures := 0
+
+func gd_integrate(steps: int) -> float:
+    var x := 0.0
+    var v := 3.5
+    var dt := 0.016
+    for i in range(1, steps + 1):
+        v = v - 9.8 * dt
+        x = x + v * dt
+        if i == 1000:
+            v = 3.5
+    return x
+
+func gd_accumulate(steps: int) -> int:
+    var s := 0
+    var t := 0
+    for i in range(1, steps + 1):
+        s = s + i * 3 - 7
+        t = t + 1
+        if t > 100:
+            t = 0
+    return s + t
+
+func time_best(fn: Callable) -> Dictionary:
+    var best := -1
+    var value = null
+    for _r in range(REPEATS):
+        var start := Time.get_ticks_usec()
+        value = fn.call()
+        var elapsed := Time.get_ticks_usec() - start
+        if best < 0 or elapsed < best:
+            best = elapsed
+    return {"elapsed_us": best, "value": value}
+
+func count_register_ops(script, entry: String) -> int:
+    var dump: Dictionary = script.debug_dump_bytecode(entry)
+    if dump.has("error"):
+        return 0
+    var count := 0
+    for inst in dump.get("instructions", []):
+        if String(inst["name"]).begins_with("OP_R_"):
+            count += 1
+    return count
+
+func report(label: String, gd: Dictionary, vg: Dictionary, reg_ops: int) -> void:
+    var same: bool = is_equal_approx(float(gd["value"]), float(vg["value"]))
+    if not same or reg_ops == 0:
+        _failures += 1
+    var gd_us: int = max(int(gd["elapsed_us"]), 1)
+    var vg_us: int = max(int(vg["elapsed_us"]), 1)
+    print("%-12s gd=%9d us  vg=%9d us  (vg %.2fx gd)  reg_ops=%d  %s" % [
+        label, gd_us, vg_us, float(vg_us) / gd_us, reg_ops,
+        "ok" if same else "MISMATCH gd=%s vg=%s" % [str(gd["value"]), str(vg["value"])]
+    ])
+
+func _init():
+    var vg_script = VisualGasicScript.new()
+    vg_script.source_code = SOURCE
+    vg_script.reload(true)
+
+    var node := Node.new()
+    node.set_script(vg_script)
+    root.add_child(node)
+
+    node.call("Integrate", 1) # compile before timing
+    node.call("Accumulate", 1)
+
+    print("Register benchmark (best of %d, %d steps)" % [REPEATS, STEPS])
+    report("Integrate",
+        time_best(func(): return gd_integrate(STEPS)),
+        time_best(func(): return node.call("Integrate", STEPS)),
+        count_register_ops(vg_script, "Integrate"))
+    report("Accumulate",
+        time_best(func(): return gd_accumulate(STEPS)),
+        time_best(func(): return node.call("Accumulate", STEPS)),
+        count_register_ops(vg_script, "Accumulate"))
+
+    root.remove_child(node)
+    node.free()
+
+    if _failures == 0:
+        quit(0)
+    else:
+        push_error("Register benchmark failed (%d)" % _failures)
+        quit(1)
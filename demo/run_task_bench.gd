@@ -0,0 +1,54 @@
+extends SceneTree
+
+# Async::TaskScheduler benchmark: spawn+await round-trip latency and batch
+# throughput for 100k tiny tasks (VisualGasicBenchmark.run_cpp_tasks), then
+# nested parallelism on the work-stealing workers: a fork-join fib with one
+# task per call and a chunked parallel_for (run_cpp_fork_join).
+
+const TASKS := 100000
+const FIB_DEPTH := 22
+const FIB_RESULT := 17711
+const PARALLEL_ITEMS := 1000000
+
+func _init():
+    var bench = ClassDB.instantiate("VisualGasicBenchmark")
+    if bench == null:
+        push_error("Failed to instantiate VisualGasicBenchmark")
+        quit(1)
+        return
+    var result: Dictionary = bench.run_cpp_tasks(TASKS)
+    var nested: Dictionary = bench.run_cpp_fork_join(FIB_DEPTH, PARALLEL_ITEMS)
+    bench.free()
+
+    print("Task scheduler benchmark (%d tasks, %d worker threads)" % [TASKS, int(result["threads"])])
+    var roundtrip_us := int(result["roundtrip_us"])
+    var batch_us := int(result["elapsed_us"])
+    print("round trip  %8d ms  %8.2f us/task" % [roundtrip_us / 1000, float(roundtrip_us) / TASKS])
+    print("batch       %8d ms  %8.0f tasks/s" % [batch_us / 1000, float(TASKS) * 1000000.0 / max(batch_us, 1)])
+    # fib(n) forks F(n+1) - 1 tasks.
+    var a := 0
+    var b := 1
+    for i in range(FIB_DEPTH + 1):
+        var next := a + b
+        a = b
+        b = next
+    var fib_tasks := a - 1
+    var fib_us := int(nested["elapsed_us"])
+    var pfor_us := int(nested["parallel_for_us"])
+    print("fork-join   %8d ms  %8.0f tasks/s  (fib(%d))" % [fib_us / 1000, float(fib_tasks) * 1000000.0 / max(fib_us, 1), FIB_DEPTH])
+    print("pfor        %8d ms  %8.0f items/s" % [pfor_us / 1000, float(PARALLEL_ITEMS) * 1000000.0 / max(pfor_us, 1)])
+
+    var failures := 0
+    # Sum of 0..TASKS-1, identical for both passes.
+    var expected := TASKS * (TASKS - 1) / 2
+    if int(result["checksum"]) != expected:
+        push_error("Checksum %d, expected %d" % [int(result["checksum"]), expected])
+        failures += 1
+    if int(nested["checksum"]) != FIB_RESULT:
+        push_error("fib(%d) = %d, expected %d" % [FIB_DEPTH, int(nested["checksum"]), FIB_RESULT])
+        failures += 1
+    var expected_items := PARALLEL_ITEMS * (PARALLEL_ITEMS - 1) / 2
+    if int(nested["parallel_checksum"]) != expected_items:
+        push_error("parallel_for sum %d, expected %d" % [int(nested["parallel_checksum"]), expected_items])
+        failures += 1
+    quit(0 if failures == 0 else 1)
@@ -0,0 +1,82 @@
+extends SceneTree
+
+# Whenever dispatch benchmark: registers many value and expression sections,
+# then times assignments to a variable nothing watches and to one that a
+# single value section and two expressions read.
+
+const VALUE_SECTIONS := 50
+const EXPRESSION_SECTIONS := 10
+const ASSIGNMENTS := 1000000
+
+func build_source() -> String:
+    var lines: PackedStringArray = []
+    lines.append("Dim hits As Long")
+    lines.append("Dim x As Long")
+    for k in range(VALUE_SECTIONS):
+        lines.append("Dim w%d As Long" % k)
+    lines.append("")
+    lines.append("Sub Setup()")
+    for k in range(VALUE_SECTIONS):
+        lines.append("    Whenever Section V%d w%d Becomes -1 Hit" % [k, k])
+    # Never true, so they cost an evaluation but no callback.
+    for k in range(EXPRESSION_SECTIONS):
+        lines.append("    Whenever Section E%d (w%d < -2000000000 And w%d > 0) Hit" % [k, k, k + 1])
+    lines.append("End Sub")
+    lines.append("")
+    lines.append("Sub Hit()")
+    lines.append("    hits = hits + 1")
+    lines.append("End Sub")
+    lines.append("")
+    lines.append("Function Unwatched(ByVal n As Long) As Long")
+    lines.append("    Dim i As Long")
+    lines.append("    While i < n")
+    lines.append("        x = x + 1")
+    lines.append("        i = i + 1")
+    lines.append("    Wend")
+    lines.append("    Unwatched = x")
+    lines.append("End Function")
+    lines.append("")
+    lines.append("Function Watched(ByVal n As Long) As Long")
+    lines.append("    Dim i As Long")
+    lines.append("    While i < n")
+    lines.append("        w1 = w1 - 1")
+    lines.append("        i = i + 1")
+    lines.append("    Wend")
+    lines.append("    Watched = hits")
+    lines.append("End Function")
+    return "\n".join(lines) + "\n"
+
+func _init():
+    var vg_script = VisualGasicScript.new()
+    vg_script.source_code = build_source()
+    vg_script.reload(true)
+    var node := Node.new()
+    node.set_script(vg_script)
+    root.add_child(node)
+    node.call("Setup")
+
+    print("Whenever dispatch benchmark (%d value + %d expression sections, %d assignments)" % [
+        VALUE_SECTIONS, EXPRESSION_SECTIONS, ASSIGNMENTS
+    ])
+    var failures := 0
+
+    var start := Time.get_ticks_usec()
+    var x = node.call("Unwatched", ASSIGNMENTS)
+    var unwatched_us := Time.get_ticks_usec() - start
+    print("unwatched  %8d ms  %6.1f ns/assignment" % [unwatched_us / 1000, float(unwatched_us) * 1000.0 / ASSIGNMENTS])
+    if int(x) != ASSIGNMENTS:
+        push_error("Unwatched returned %d" % int(x))
+        failures += 1
+
+    start = Time.get_ticks_usec()
+    var hits = node.call("Watched", ASSIGNMENTS)
+    var watched_us := Time.get_ticks_usec() - start
+    print("watched    %8d ms  %6.1f ns/assignment" % [watched_us / 1000, float(watched_us) * 1000.0 / ASSIGNMENTS])
+    # w1 Becomes -1 once; the expressions never hold.
+    if int(hits) != 1:
+        push_error("Watched fired %d callbacks, expected 1" % int(hits))
+        failures += 1
+
+    root.remove_child(node)
+    node.free()
+    quit(0 if failures == 0 else 1)
@@ -16,6 +16,7 @@
 #include "gasic_ai_controller.h"
 #include "gasic_form.h"
 #include "visual_gasic_comm.h"
+#include "visual_gasic_object.h"
 #include "visual_gasic_benchmark.h"
 #include "visual_gasic_test_runner.h"
 
@@ -34,6 +35,23 @@ void initialize_visual_gasic_module(ModuleInitializationLevel p_level) {
             ProjectSettings::get_singleton()->set_setting("visual_gasic/auto_format_iif", false);
             ProjectSettings::get_singleton()->set_initial_value("visual_gasic/auto_format_iif", false);
         }
+        if (!ProjectSettings::get_singleton()->has_setting("visual_gasic/bytecode_cache/enabled")) {
+            ProjectSettings::get_singleton()->set_setting("visual_gasic/bytecode_cache/enabled", true);
+            ProjectSettings::get_singleton()->set_initial_value("visual_gasic/bytecode_cache/enabled", true);
+        }
+        // Loop watchdog budgets (0 = off): iterations per loop and wall-clock ms.
+        if (!ProjectSettings::get_singleton()->has_setting("visual_gasic/runtime/loop_watchdog_iterations")) {
+            ProjectSettings::get_singleton()->set_setting("visual_gasic/runtime/loop_watchdog_iterations", 0);
+            ProjectSettings::get_singleton()->set_initial_value("visual_gasic/runtime/loop_watchdog_iterations", 0);
+        }
+        if (!ProjectSettings::get_singleton()->has_setting("visual_gasic/runtime/loop_watchdog_ms")) {
+            ProjectSettings::get_singleton()->set_setting("visual_gasic/runtime/loop_watchdog_ms", 0);
+            ProjectSettings::get_singleton()->set_initial_value("visual_gasic/runtime/loop_watchdog_ms", 0);
+        }
+        if (!ProjectSettings::get_singleton()->has_setting("visual_gasic/whenever/deferred_dispatch")) {
+            ProjectSettings::get_singleton()->set_setting("visual_gasic/whenever/deferred_dispatch", false);
+            ProjectSettings::get_singleton()->set_initial_value("visual_gasic/whenever/deferred_dispatch", false);
+        }
 
         ClassDB::register_class<VisualGasicLanguage>();
         ClassDB::register_class<VisualGasicScript>();
@@ -42,6 +60,7 @@ void initialize_visual_gasic_module(ModuleInitializationLevel p_level) {
         ClassDB::register_class<GasicAIController>();
         ClassDB::register_class<GasicForm>();
         ClassDB::register_class<MSComm>();
+        ClassDB::register_class<VisualGasicObject>();
         ClassDB::register_class<VisualGasicBenchmark>();
         ClassDB::register_class<VisualGasicTestRunner>();
     
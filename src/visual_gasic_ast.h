@@ -2,11 +2,15 @@
 #define VISUAL_GASIC_AST_H
 
 #include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/templates/hash_map.hpp>
 #include <godot_cpp/templates/vector.hpp>
 #include <godot_cpp/variant/variant.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 #include <stdio.h>
 
+#include "visual_gasic_ast_arena.h"
+#include "visual_gasic_global_slots.h"
+
 using namespace godot;
 namespace VisualGasic {
 // Forward declarations
@@ -59,6 +63,7 @@ enum StatementType {
     STMT_PARALLEL_SECTION,
     STMT_PATTERN_MATCH,
     STMT_DECLARE,  // FFI/DLL declarations
+    STMT_FILE_RECORD, // Get # / Put #
     STMT_UNKNOWN
 };
 
@@ -66,12 +71,47 @@ struct ASTNode {
     virtual ~ASTNode() {}
 };
 
+// How VisualGasicBinder resolved a name (see visual_gasic_binder.h).
+// Nodes it never saw, such as code parsed at run time, stay UNRESOLVED and
+// are looked up by name.
+enum BindKind : uint8_t {
+    BIND_UNRESOLVED,
+    BIND_LOCAL,     // Declared in the enclosing Sub/Function
+    BIND_GLOBAL,    // Module-level Dim, Const or Enum value
+    BIND_SUB,       // Sub/Function of the module
+    BIND_STRUCT,    // Type of the module
+    BIND_INTRINSIC, // Handled by the interpreter itself (builtins, FreeFile, MemoryBlock...)
+    BIND_EXTERNAL,  // Not declared in the module: owner property/method, autoload or Godot class
+    BIND_CLASS,     // Class of the module
+    BIND_MEMBER,    // Field of the Class whose method is running
+    BIND_METHOD,    // Sub/Function of the Class whose method is running
+    BIND_DECLARE,   // Declare'd function in a native library
+    BIND_COMMAND,   // Statement-level command (visual_gasic_commands.h); index is its ID
+};
+
+struct Binding {
+    BindKind kind = BIND_UNRESOLVED;
+    int slot = -1;  // Index into ModuleNode::slot_names, -1 if the name is never a variable
+    int index = -1; // Index into ModuleNode::subs/structs/classes/declares, or ClassDefinition::members/methods
+};
+
+struct ClassDefinition;
+struct DeclareStatement;
+
+// Inline cache for a member or method name looked up on a class object: the
+// class last seen at this node and the index the name had in it. Cleared by
+// the binder, since a reparse can reuse the node with new definitions.
+struct ClassSiteCache {
+    const ClassDefinition *definition = nullptr;
+    int index = -1;
+};
+
 // Expression Nodes
 struct ExpressionNode {
     enum Type { LITERAL, VARIABLE, BINARY_OP, UNARY_OP, EXPRESSION_CALL, MEMBER_ACCESS, ARRAY_ACCESS, ME, SUPER, NEW, WITH_CONTEXT, EXPRESSION_IIF, MATCH_EXPRESSION, OPTIONAL_ACCESS, TYPE_CHECK } type;
     virtual ~ExpressionNode() {}
     
-    virtual ExpressionNode* duplicate() {
+    virtual ExpressionNode* duplicate(ASTArena& p_arena) {
         return nullptr; // Base impl returns null or handle unknown types gracefully
     }
 };
@@ -79,34 +119,32 @@ struct ExpressionNode {
 struct NewNode : public ExpressionNode {
     String class_name;
     Vector<ExpressionNode*> args;
+    Binding binding;
     NewNode() { type = NEW; }
-    virtual ~NewNode() {
-        for(int i=0; i<args.size(); i++) if(args[i]) delete args[i];
-    }
-    virtual ExpressionNode* duplicate() override {
-        NewNode* n = new NewNode();
+    virtual ExpressionNode* duplicate(ASTArena& p_arena) override {
+        NewNode* n = p_arena.alloc<NewNode>();
         n->class_name = class_name;
-        for(int i=0; i<args.size(); i++) n->args.push_back(args[i]->duplicate());
+        for(int i=0; i<args.size(); i++) n->args.push_back(args[i]->duplicate(p_arena));
         return n;
     }
 };
 
 struct MeNode : public ExpressionNode {
     MeNode() { type = ME; }
-    virtual ExpressionNode* duplicate() override { return new MeNode(); }
+    virtual ExpressionNode* duplicate(ASTArena& p_arena) override { return p_arena.alloc<MeNode>(); }
 };
 
 struct SuperNode : public ExpressionNode {
     SuperNode() { type = SUPER; }
-    virtual ExpressionNode* duplicate() override { return new SuperNode(); }
+    virtual ExpressionNode* duplicate(ASTArena& p_arena) override { return p_arena.alloc<SuperNode>(); }
 };
 
 
 struct LiteralNode : public ExpressionNode {
     Variant value;
     LiteralNode() { type = LITERAL; }
-    virtual ExpressionNode* duplicate() override {
-        LiteralNode* l = new LiteralNode();
+    virtual ExpressionNode* duplicate(ASTArena& p_arena) override {
+        LiteralNode* l = p_arena.alloc<LiteralNode>();
         l->value = value;
         return l;
     }
@@ -114,9 +152,11 @@ struct LiteralNode : public ExpressionNode {
 
 struct VariableNode : public ExpressionNode {
     String name;
+    SlotHint slot_hint; // Cached GlobalSlotTable slot, validated on use
+    Binding binding;
     VariableNode() { type = VARIABLE; }
-    virtual ExpressionNode* duplicate() override {
-        VariableNode* v = new VariableNode();
+    virtual ExpressionNode* duplicate(ASTArena& p_arena) override {
+        VariableNode* v = p_arena.alloc<VariableNode>();
         v->name = name;
         return v;
     }
@@ -134,16 +174,12 @@ struct BinaryOpNode : public ExpressionNode {
     ExpressionNode* right;
     
     BinaryOpNode() { type = BINARY_OP; left=nullptr; right=nullptr; op="+"; }
-    virtual ~BinaryOpNode() { 
-        if(left) delete left;
-        if(right) delete right; 
-    }
     
-    virtual ExpressionNode* duplicate() override {
-        BinaryOpNode* b = new BinaryOpNode();
+    virtual ExpressionNode* duplicate(ASTArena& p_arena) override {
+        BinaryOpNode* b = p_arena.alloc<BinaryOpNode>();
         b->op = op;
-        if(left) b->left = left->duplicate();
-        if(right) b->right = right->duplicate();
+        if(left) b->left = left->duplicate(p_arena);
+        if(right) b->right = right->duplicate(p_arena);
         return b;
     }
 };
@@ -152,13 +188,10 @@ struct UnaryOpNode : public ExpressionNode {
     String op;
     ExpressionNode* operand;
     UnaryOpNode() { type = UNARY_OP; operand=nullptr; }
-    virtual ~UnaryOpNode() {
-        if(operand) delete operand;
-    }
-    virtual ExpressionNode* duplicate() override {
-        UnaryOpNode* u = new UnaryOpNode();
+    virtual ExpressionNode* duplicate(ASTArena& p_arena) override {
+        UnaryOpNode* u = p_arena.alloc<UnaryOpNode>();
         u->op = op;
-        if(operand) u->operand = operand->duplicate();
+        if(operand) u->operand = operand->duplicate(p_arena);
         return u;
     }
 };
@@ -167,18 +200,15 @@ struct CallExpression : public ExpressionNode {
     ExpressionNode* base_object; // Optional base
     String method_name;
     Vector<ExpressionNode*> arguments;
+    Binding binding; // Left UNRESOLVED for calls on a base object
+    ClassSiteCache class_cache; // Method of a class object base
+    int builtin_id = -2; // VisualGasicBuiltins expression builtin ID, filled on first call (-1 = none)
     CallExpression() { type = EXPRESSION_CALL; base_object=nullptr; }
-    virtual ~CallExpression() {
-        if (base_object) delete base_object;
-        for(int i=0; i<arguments.size(); i++) {
-            if (arguments[i]) delete arguments[i];
-        }
-    }
-    virtual ExpressionNode* duplicate() override {
-        CallExpression* c = new CallExpression();
+    virtual ExpressionNode* duplicate(ASTArena& p_arena) override {
+        CallExpression* c = p_arena.alloc<CallExpression>();
         c->method_name = method_name;
-        if(base_object) c->base_object = base_object->duplicate();
-        for(int i=0; i<arguments.size(); i++) c->arguments.push_back(arguments[i]->duplicate());
+        if(base_object) c->base_object = base_object->duplicate(p_arena);
+        for(int i=0; i<arguments.size(); i++) c->arguments.push_back(arguments[i]->duplicate(p_arena));
         return c;
     }
 };
@@ -189,16 +219,11 @@ struct IIfNode : public ExpressionNode {
     ExpressionNode* false_part;
     
     IIfNode() { type = EXPRESSION_IIF; condition=nullptr; true_part=nullptr; false_part=nullptr; }
-    virtual ~IIfNode() {
-        if(condition) delete condition;
-        if(true_part) delete true_part;
-        if(false_part) delete false_part;
-    }
-    virtual ExpressionNode* duplicate() override {
-         IIfNode* n = new IIfNode();
-         if(condition) n->condition = condition->duplicate();
-         if(true_part) n->true_part = true_part->duplicate();
-         if(false_part) n->false_part = false_part->duplicate();
+    virtual ExpressionNode* duplicate(ASTArena& p_arena) override {
+         IIfNode* n = p_arena.alloc<IIfNode>();
+         if(condition) n->condition = condition->duplicate(p_arena);
+         if(true_part) n->true_part = true_part->duplicate(p_arena);
+         if(false_part) n->false_part = false_part->duplicate(p_arena);
          return n;
     }
 };
@@ -207,14 +232,10 @@ struct ArrayAccessNode : public ExpressionNode {
     ExpressionNode* base;
     Vector<ExpressionNode*> indices;
     ArrayAccessNode() { type = ARRAY_ACCESS; base=nullptr; }
-    virtual ~ArrayAccessNode() {
-        if(base) delete base;
-        for(int i=0; i<indices.size(); i++) if(indices[i]) delete indices[i];
-    }
-    virtual ExpressionNode* duplicate() override {
-        ArrayAccessNode* a = new ArrayAccessNode();
-        if(base) a->base = base->duplicate();
-        for(int i=0; i<indices.size(); i++) a->indices.push_back(indices[i]->duplicate());
+    virtual ExpressionNode* duplicate(ASTArena& p_arena) override {
+        ArrayAccessNode* a = p_arena.alloc<ArrayAccessNode>();
+        if(base) a->base = base->duplicate(p_arena);
+        for(int i=0; i<indices.size(); i++) a->indices.push_back(indices[i]->duplicate(p_arena));
         return a;
     }
 };
@@ -222,15 +243,13 @@ struct ArrayAccessNode : public ExpressionNode {
 struct MemberAccessNode : public ExpressionNode {
     ExpressionNode* base_object; 
     String member_name;
+    ClassSiteCache class_cache; // Field of a class object base
     
     MemberAccessNode() { type = MEMBER_ACCESS; base_object=nullptr; }
-    virtual ~MemberAccessNode() {
-        if (base_object) delete base_object;
-    }
-    virtual ExpressionNode* duplicate() override {
-        MemberAccessNode* m = new MemberAccessNode();
+    virtual ExpressionNode* duplicate(ASTArena& p_arena) override {
+        MemberAccessNode* m = p_arena.alloc<MemberAccessNode>();
         m->member_name = member_name;
-        if(base_object) m->base_object = base_object->duplicate();
+        if(base_object) m->base_object = base_object->duplicate(p_arena);
         return m;
     }
 };
@@ -245,31 +264,24 @@ struct PrintStatement : public Statement {
     ExpressionNode* expression;
     ExpressionNode* file_number; // Optional, formatted as #N
     PrintStatement() : Statement(STMT_PRINT), expression(nullptr), file_number(nullptr) {}
-    virtual ~PrintStatement() { 
-        if(expression) delete expression; 
-        if(file_number) delete file_number;
-    }
 };
 
 struct OpenStatement : public Statement {
-    enum Mode { MODE_INPUT, MODE_OUTPUT, MODE_APPEND };
+    // Same order as VisualGasicFile::Mode and ::Access.
+    enum Mode { MODE_INPUT, MODE_OUTPUT, MODE_APPEND, MODE_BINARY, MODE_RANDOM };
+    enum Access { ACCESS_DEFAULT, ACCESS_READ, ACCESS_WRITE, ACCESS_READ_WRITE };
     Mode mode;
+    Access access;
     ExpressionNode* path;
     ExpressionNode* file_number;
+    ExpressionNode* record_length; // Len = n (Random), optional
     
-    OpenStatement() : Statement(STMT_OPEN), path(nullptr), file_number(nullptr) {}
-    ~OpenStatement() {
-        if(path) delete path;
-        if(file_number) delete file_number;
-    }
+    OpenStatement() : Statement(STMT_OPEN), mode(MODE_RANDOM), access(ACCESS_DEFAULT), path(nullptr), file_number(nullptr), record_length(nullptr) {}
 };
 
 struct CloseStatement : public Statement {
     ExpressionNode* file_number;
     CloseStatement() : Statement(STMT_CLOSE), file_number(nullptr) {}
-    ~CloseStatement() {
-        if(file_number) delete file_number;
-    }
 };
 
 struct InputStatement : public Statement {
@@ -278,10 +290,6 @@ struct InputStatement : public Statement {
     bool is_line_input;
     
     InputStatement() : Statement(STMT_INPUT), file_number(nullptr), is_line_input(false) {}
-    ~InputStatement() {
-        if(file_number) delete file_number;
-        for(int i=0; i<variables.size(); i++) if(variables[i]) delete variables[i];
-    }
 };
 
 struct ExitStatement : public Statement {
@@ -293,7 +301,6 @@ struct ExitStatement : public Statement {
 struct ReturnStatement : public Statement {
     ExpressionNode* return_value;
     ReturnStatement() : Statement(STMT_RETURN) { return_value = nullptr; }
-    virtual ~ReturnStatement() { if(return_value) delete return_value; }
 };
 
 struct ContinueStatement : public Statement {
@@ -309,9 +316,6 @@ struct ReDimStatement : public Statement {
     // We can ignore 'As Type' for ReDim for now as parsed.
     
     ReDimStatement() : Statement(STMT_REDIM), preserve(false) {}
-    ~ReDimStatement() {
-        for(int i=0; i<array_sizes.size(); i++) if(array_sizes[i]) delete array_sizes[i];
-    }
 };
 
 struct DimStatement : public Statement {
@@ -322,12 +326,6 @@ struct DimStatement : public Statement {
     bool is_static;
     
     DimStatement() : Statement(STMT_DIM) { initializer = nullptr; is_static = false; }
-    virtual ~DimStatement() { 
-        for(int i=0; i<array_sizes.size(); i++) {
-             if (array_sizes[i]) delete array_sizes[i];
-        }
-        if (initializer) delete initializer;
-    }
 };
 
 struct ConstStatement : public Statement {
@@ -335,7 +333,6 @@ struct ConstStatement : public Statement {
     ExpressionNode* value; 
     
     ConstStatement() : Statement(STMT_CONST), value(nullptr) {}
-    virtual ~ConstStatement() { if(value) delete value; }
 };
 
 struct DoEventsStatement : public Statement {
@@ -345,17 +342,11 @@ struct DoEventsStatement : public Statement {
 struct DataStatement : public Statement {
     Vector<ExpressionNode*> values;
     DataStatement() : Statement(STMT_DATA) {}
-    ~DataStatement() {
-        for(int i=0; i<values.size(); i++) if(values[i]) delete values[i];
-    }
 };
 
 struct ReadStatement : public Statement {
     Vector<ExpressionNode*> targets;
     ReadStatement() : Statement(STMT_READ) {}
-    ~ReadStatement() {
-        for(int i=0; i<targets.size(); i++) if(targets[i]) delete targets[i];
-    }
 };
 
 struct RestoreStatement : public Statement {
@@ -367,10 +358,6 @@ struct AssignmentStatement : public Statement {
     ExpressionNode* target;
     ExpressionNode* value;
     AssignmentStatement() : Statement(STMT_ASSIGNMENT), target(nullptr), value(nullptr) {}
-    virtual ~AssignmentStatement() { 
-        if(target) delete target;
-        if(value) delete value;
-    }
 };
 
 struct IfStatement : public Statement {
@@ -379,19 +366,21 @@ struct IfStatement : public Statement {
     Vector<Statement*> else_branch;
     
     IfStatement() : Statement(STMT_IF), condition(nullptr) {}
-    virtual ~IfStatement() { 
-        if(condition) delete condition;
-        for(int i=0; i<then_branch.size(); i++) delete then_branch[i]; 
-        for(int i=0; i<else_branch.size(); i++) delete else_branch[i];
-    }
 };
 
 struct LoadDataStatement : public Statement {
     ExpressionNode* path_expression;
     LoadDataStatement() : Statement(STMT_LOAD_DATA), path_expression(nullptr) {}
-    virtual ~LoadDataStatement() {
-        if(path_expression) delete path_expression;
-    }
+};
+
+// Get #n, [position], variable / Put #n, [position], value
+struct FileRecordStatement : public Statement {
+    bool is_put;
+    ExpressionNode* file_number;
+    ExpressionNode* position; // Optional: 1-based byte (Binary) or record (Random)
+    ExpressionNode* variable;
+    
+    FileRecordStatement() : Statement(STMT_FILE_RECORD), is_put(false), file_number(nullptr), position(nullptr), variable(nullptr) {}
 };
 
 struct SeekStatement : public Statement {
@@ -399,10 +388,6 @@ struct SeekStatement : public Statement {
     ExpressionNode* position;
     
     SeekStatement() : Statement(STMT_SEEK), file_number(nullptr), position(nullptr) {}
-    virtual ~SeekStatement() {
-        if(file_number) delete file_number;
-        if(position) delete position;
-    }
 };
 
 struct ForStatement : public Statement {
@@ -411,14 +396,9 @@ struct ForStatement : public Statement {
     ExpressionNode* to_val;
     ExpressionNode* step_val;
     Vector<Statement*> body;
+    Binding binding; // The loop variable
     
     ForStatement() : Statement(STMT_FOR), from_val(nullptr), to_val(nullptr), step_val(nullptr) {}
-    virtual ~ForStatement() {
-        if(from_val) delete from_val;
-        if(to_val) delete to_val;
-        if(step_val) delete step_val;
-        for(int i=0; i<body.size(); i++) delete body[i];
-    }
 };
 
 struct WhileStatement : public Statement {
@@ -426,10 +406,6 @@ struct WhileStatement : public Statement {
     Vector<Statement*> body;
     
     WhileStatement() : Statement(STMT_WHILE), condition(nullptr) {}
-    virtual ~WhileStatement() {
-        if(condition) delete condition;
-        for(int i=0; i<body.size(); i++) delete body[i];
-    }
 };
 
 struct DoStatement : public Statement {
@@ -440,10 +416,6 @@ struct DoStatement : public Statement {
     Vector<Statement*> body;
     
     DoStatement() : Statement(STMT_DO), condition_type(NONE), is_post_condition(false), condition(nullptr) {}
-    virtual ~DoStatement() {
-        if(condition) delete condition;
-        for(int i=0; i<body.size(); i++) delete body[i];
-    }
 };
 
 struct ForEachStatement : public Statement {
@@ -452,10 +424,6 @@ struct ForEachStatement : public Statement {
     Vector<Statement*> body;
     
     ForEachStatement() : Statement(STMT_FOR_EACH), collection(nullptr) {}
-    virtual ~ForEachStatement() {
-        if(collection) delete collection;
-        for(int i=0; i<body.size(); i++) delete body[i];
-    }
 };
 
 struct WithStatement : public Statement {
@@ -463,10 +431,6 @@ struct WithStatement : public Statement {
     Vector<Statement*> body;
     
     WithStatement() : Statement(STMT_WITH), expression(nullptr) {}
-    virtual ~WithStatement() {
-        if(expression) delete expression;
-        for(int i=0; i<body.size(); i++) delete body[i];
-    }
 };
 
 
@@ -475,14 +439,10 @@ struct CallStatement : public Statement {
     ExpressionNode* base_object;
     String method_name;
     Vector<ExpressionNode*> arguments;
+    Binding binding; // BIND_METHOD, BIND_DECLARE, BIND_SUB or BIND_COMMAND, otherwise unresolved
+    ClassSiteCache class_cache; // Method of a class object base
     
     CallStatement() : Statement(STMT_CALL), base_object(nullptr) {}
-    virtual ~CallStatement() {
-        if(base_object) delete base_object;
-        for(int i=0; i<arguments.size(); i++) {
-            if (arguments[i]) delete arguments[i];
-        }
-    }
 };
 
 struct LabelStatement : public Statement {
@@ -508,10 +468,6 @@ struct CaseBlock : public ASTNode {
     Vector<Statement*> body;
     
     CaseBlock() : is_else(false) {}
-    ~CaseBlock() {
-        for(int i=0; i<values.size(); i++) if(values[i]) delete values[i];
-        for(int i=0; i<body.size(); i++) if(body[i]) delete body[i];
-    }
 };
 
 struct SelectStatement : public Statement {
@@ -519,10 +475,6 @@ struct SelectStatement : public Statement {
     Vector<CaseBlock*> cases;
     
     SelectStatement() : Statement(STMT_SELECT), expression(nullptr) {}
-    ~SelectStatement() {
-        if(expression) delete expression;
-        for(int i=0; i<cases.size(); i++) delete cases[i];
-    }
 };
 
 struct Parameter {
@@ -547,14 +499,12 @@ struct SubDefinition : public ASTNode {
     
     SubDefinition() : type(TYPE_SUB) {}
     
-    ~SubDefinition() {
-        for(int i=0; i<statements.size(); i++) if(statements[i]) delete statements[i];
-    }
 };
 
 struct StructMember {
     String name;
     String type; // "Integer", "String", or UDT name. We might treat simple types as just Variant for now unless we do strict typing.
+    int fixed_length = 0; // n for "String * n": Put/Get store exactly n bytes
 };
 
 struct StructDefinition : public ASTNode {
@@ -583,7 +533,6 @@ struct VariableDefinition : public ASTNode {
     Vector<int> array_sizes; // if array
     
     VariableDefinition() : default_value(nullptr), visibility(VIS_PRIVATE) {}
-    ~VariableDefinition() { if(default_value) delete default_value; }
 };
 
 struct EventDefinition : public ASTNode {
@@ -596,27 +545,17 @@ struct RaiseEventStatement : public Statement {
     String expression_name;
     Vector<ExpressionNode*> arguments;
     RaiseEventStatement() : Statement(STMT_RAISE_EVENT) {}
-    ~RaiseEventStatement() {
-         for(int i=0; i<arguments.size(); i++) if(arguments[i]) delete arguments[i];
-    }
 };
 
 struct KillStatement : public Statement {
     ExpressionNode* path;
     KillStatement() : Statement(STMT_KILL) { path = nullptr; }
-    virtual ~KillStatement() {
-        if (path) delete path;
-    }
 };
 
 struct NameStatement : public Statement {
     ExpressionNode* old_path;
     ExpressionNode* new_path;
     NameStatement() : Statement(STMT_NAME) { old_path=nullptr; new_path=nullptr; }
-    virtual ~NameStatement() {
-        if(old_path) delete old_path;
-        if(new_path) delete new_path;
-    }
 };
 
 struct TryStatement : public Statement {
@@ -626,11 +565,6 @@ struct TryStatement : public Statement {
     String catch_var_name;
     
     TryStatement() : Statement(STMT_TRY) {}
-    ~TryStatement() {
-        for(int i=0; i<try_block.size(); i++) if(try_block[i]) delete try_block[i];
-        for(int i=0; i<catch_block.size(); i++) if(catch_block[i]) delete catch_block[i];
-        for(int i=0; i<finally_block.size(); i++) if(finally_block[i]) delete finally_block[i];
-    }
 };
 
 struct RaiseStatement : public Statement {
@@ -640,10 +574,6 @@ struct RaiseStatement : public Statement {
     ExpressionNode*& error_code;
     ExpressionNode*& message;
     RaiseStatement() : Statement(STMT_RAISE), error_code(code), message(msg) { code=nullptr; msg=nullptr; } 
-    virtual ~RaiseStatement() {
-        if(code) delete code;
-        if(msg) delete msg;
-    }
 };
 
 struct PassStatement : public Statement { 
@@ -666,11 +596,6 @@ struct WheneverSectionStatement : public Statement {
         condition_expression = nullptr;
     }
     
-    virtual ~WheneverSectionStatement() {
-        if(comparison_value) delete comparison_value;
-        if(comparison_value2) delete comparison_value2;
-        if(condition_expression) delete condition_expression;
-    }
 };
 
 struct SuspendWheneverStatement : public Statement {
@@ -685,7 +610,25 @@ struct ResumeWheneverStatement : public Statement {
     ResumeWheneverStatement() : Statement(STMT_RESUME_WHENEVER) {}
 };
 
+// Where a top-level Sub/Function came from, recorded when a module is parsed
+// together with its source text so the next parse of an edited version can
+// reuse it (see VisualGasicParser::parse).
+struct DeclarationInfo {
+    SubDefinition* sub = nullptr;
+    uint64_t text_hash = 0;      // Source from 'Sub'/'Function' through 'End Sub'/'End Function'
+    uint64_t context_hash = 0;   // Module-level tokens before it, which the parse of its body can see
+    uint64_t signature_hash = 0; // Its first line: kind, name and parameters
+    int first_token = 0;         // Token range it was parsed from
+    int end_token = 0;
+    Vector<EnumDefinition*> enums; // Enums declared in its body
+    size_t arena_bytes = 0;      // Arena bytes taken by its nodes
+    int previous_index = -1;     // Index in the previous module's subs when reused
+};
+
+// Every node of a module is allocated from its arena and destroyed with
+// it; the vectors below only index into the arena.
 struct ModuleNode {
+    ASTArena arena;
     bool option_explicit;
     bool option_compare_text;
     String inherits_path; // For inheritance
@@ -697,19 +640,22 @@ struct ModuleNode {
     Vector<ConstStatement*> constants; // Module level constants
     Vector<Statement*> global_statements; // For Data and Labels at module level
     Vector<PropertyDefinition*> properties; // Module level properties (owned by ClassDefinitions)
+    Vector<ClassDefinition*> classes; // Class ... End Class blocks
+    Vector<DeclareStatement*> declares; // Declare Sub/Function ... Lib
+
+    // Incremental reparse bookkeeping; empty when parsed without source text.
+    Vector<DeclarationInfo> declarations; // One per entry of subs
+    uint64_t interface_hash = 0; // Module-level tokens plus every Sub signature, in order
+    size_t stale_bytes = 0; // Arena bytes only referenced by replaced declarations
+
+    // Filled by VisualGasicBinder: every variable name the module uses, in
+    // the order Binding::slot refers to them.
+    Vector<String> slot_names;
+    uint64_t bind_generation = 0; // Unique per binder run, 0 if never bound
+    std::shared_ptr<const SlotLayout> slot_layout; // slot_names for GlobalSlotTable::set_layout
     
     ModuleNode() { option_explicit = false; option_compare_text = false; }
 
-    ~ModuleNode() {
-        for(int i=0; i<events.size(); i++) if(events[i]) delete events[i];
-        for(int i=0; i<subs.size(); i++) if(subs[i]) delete subs[i];
-        for(int i=0; i<structs.size(); i++) if(structs[i]) delete structs[i];
-        for(int i=0; i<enums.size(); i++) if(enums[i]) delete enums[i];
-        for(int i=0; i<variables.size(); i++) if(variables[i]) delete variables[i];
-        for(int i=0; i<constants.size(); i++) if(constants[i]) delete constants[i];
-        for(int i=0; i<global_statements.size(); i++) if(global_statements[i]) delete global_statements[i];
-        // Note: properties are managed separately to avoid incomplete type issues with forward declaration
-    }
 };
 
 // === MULTITASKING AST STRUCTURES ===
@@ -722,10 +668,6 @@ struct AsyncFunctionStatement : Statement {
     Vector<Statement*> body;
     
     AsyncFunctionStatement() : Statement(STMT_ASYNC_FUNCTION) {}
-    ~AsyncFunctionStatement() {
-        for(int i=0; i<parameters.size(); i++) if(parameters[i]) delete parameters[i];
-        for(int i=0; i<body.size(); i++) if(body[i]) delete body[i];
-    }
 };
 
 // Await Expression
@@ -736,7 +678,6 @@ struct AwaitExpression : ExpressionNode {
         type = LITERAL; // We'll extend this enum 
         expression = nullptr;
     }
-    ~AwaitExpression() { if(expression) delete expression; }
 };
 
 // Task.Run Statement  
@@ -746,9 +687,6 @@ struct TaskRunStatement : Statement {
     String task_name;
     
     TaskRunStatement() : Statement(STMT_TASK_RUN), is_background(true) {}
-    ~TaskRunStatement() {
-        for(int i=0; i<task_body.size(); i++) if(task_body[i]) delete task_body[i];
-    }
 };
 
 // Task.Wait Statement
@@ -772,12 +710,6 @@ struct ParallelForStatement : Statement {
         end_expr = nullptr; 
         step_expr = nullptr;
     }
-    ~ParallelForStatement() {
-        if(start_expr) delete start_expr;
-        if(end_expr) delete end_expr;
-        if(step_expr) delete step_expr;
-        for(int i=0; i<body.size(); i++) if(body[i]) delete body[i];
-    }
 };
 
 // Parallel Section Statement
@@ -787,9 +719,6 @@ struct ParallelSectionStatement : Statement {
     bool high_priority;
     
     ParallelSectionStatement() : Statement(STMT_PARALLEL_SECTION), max_threads(-1), high_priority(false) {}
-    ~ParallelSectionStatement() {
-        for(int i=0; i<section_body.size(); i++) if(section_body[i]) delete section_body[i];
-    }
 };
 
 // Task Definition (for runtime tracking)
@@ -824,10 +753,6 @@ struct AdvancedType {
     bool is_optional; // For Player?
     
     AdvancedType() : kind(BASIC), is_optional(false) {}
-    ~AdvancedType() {
-        for(int i=0; i<type_parameters.size(); i++) if(type_parameters[i]) delete type_parameters[i];
-        for(int i=0; i<union_types.size(); i++) if(union_types[i]) delete union_types[i];
-    }
 };
 
 // Pattern Matching Structures
@@ -842,10 +767,6 @@ struct Pattern {
     Variant literal_value; // For literal patterns
     
     Pattern() { type = LITERAL_PATTERN; guard_expression = nullptr; }
-    ~Pattern() {
-        if (guard_expression) delete guard_expression;
-        for(int i=0; i<sub_patterns.size(); i++) if(sub_patterns[i]) delete sub_patterns[i];
-    }
 };
 
 struct MatchCase {
@@ -853,10 +774,6 @@ struct MatchCase {
     Vector<Statement*> statements;
     
     MatchCase() { pattern = nullptr; }
-    ~MatchCase() {
-        if (pattern) delete pattern;
-        for(int i=0; i<statements.size(); i++) if(statements[i]) delete statements[i];
-    }
 };
 
 struct PatternMatchStatement : Statement {
@@ -864,10 +781,6 @@ struct PatternMatchStatement : Statement {
     Vector<MatchCase*> cases;
     
     PatternMatchStatement() : Statement(STMT_PATTERN_MATCH) { expression = nullptr; }
-    ~PatternMatchStatement() {
-        if (expression) delete expression;
-        for(int i=0; i<cases.size(); i++) if(cases[i]) delete cases[i];
-    }
 };
 
 // Optional Type Expression
@@ -879,7 +792,6 @@ struct OptionalAccessExpression : ExpressionNode {
         type = OPTIONAL_ACCESS; 
         object_expression = nullptr;
     }
-    ~OptionalAccessExpression() { if(object_expression) delete object_expression; }
 };
 
 // Type Check Expression
@@ -892,10 +804,6 @@ struct TypeCheckExpression : ExpressionNode {
         expression = nullptr;
         check_type = nullptr;
     }
-    ~TypeCheckExpression() {
-        if(expression) delete expression;
-        if(check_type) delete check_type;
-    }
 };
 
 // Class System Support
@@ -909,9 +817,6 @@ struct PropertyDefinition : public ASTNode {
     Vector<Statement*> body;
     
     PropertyDefinition() : property_type(PROP_GET) {}
-    ~PropertyDefinition() {
-        for (Statement* s : body) { if(s) delete s; }
-    }
 };
 
 struct ClassDefinition : public ASTNode {
@@ -924,15 +829,12 @@ struct ClassDefinition : public ASTNode {
     SubDefinition* class_initialize;  // Class_Initialize sub
     SubDefinition* class_terminate;   // Class_Terminate sub
     bool is_public;
+    // Filled by VisualGasicBinder: lower-case name -> index into members
+    // (the layout of VisualGasicObject::fields) and methods.
+    HashMap<String, int> member_index;
+    HashMap<String, int> method_index;
     
     ClassDefinition() : class_initialize(nullptr), class_terminate(nullptr), is_public(true) {}
-    ~ClassDefinition() {
-        for (VariableDefinition* v : members) { if(v) delete v; }
-        for (SubDefinition* s : methods) { if(s) delete s; }
-        for (PropertyDefinition* p : properties) { if(p) delete p; }
-        for (EventDefinition* e : events) { if(e) delete e; }
-        // class_initialize and class_terminate are also in methods, so don't double-delete
-    }
 };
 
 // FFI/DLL Support
@@ -1,42 +1,147 @@
 #ifndef VISUAL_GASIC_AST_ARENA_H
 #define VISUAL_GASIC_AST_ARENA_H
 
-// Lightweight arena allocator for AST nodes.
-// Provides bulk allocation semantics and an efficient clear()
-// to free all allocated blocks at once.
+// Bump allocator for AST nodes.
+// Nodes are carved out of large chunks and never freed one by one: the
+// arena owns every node allocated from it and destroys them all in clear()
+// (or its destructor). Node destructors therefore only release their own
+// members, never their children.
 
-#include <vector>
 #include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 class ASTArena {
 public:
+    static constexpr std::size_t CHUNK_SIZE = 64 * 1024;
+
     ASTArena() {}
     ~ASTArena() { clear(); }
 
+    ASTArena(const ASTArena &) = delete;
+    ASTArena &operator=(const ASTArena &) = delete;
+
     // Allocate raw bytes (caller placement-news into returned pointer).
-    void* allocate_bytes(std::size_t sz) {
-        void* p = ::operator new(sz);
-        blocks.push_back(p);
-        return p;
+    void *allocate_bytes(std::size_t sz, std::size_t align = alignof(std::max_align_t)) {
+        std::uintptr_t p = (std::uintptr_t(cursor) + (align - 1)) & ~std::uintptr_t(align - 1);
+        if (cursor == nullptr || p + sz > std::uintptr_t(limit)) {
+            new_chunk(sz + align);
+            p = (std::uintptr_t(cursor) + (align - 1)) & ~std::uintptr_t(align - 1);
+        }
+        cursor = reinterpret_cast<char *>(p + sz);
+        bytes_allocated += sz;
+        return reinterpret_cast<void *>(p);
+    }
+
+    // Allocate and construct a T. Types with a non-trivial destructor are
+    // remembered so clear() can run it.
+    template <typename T, typename... Args>
+    T *alloc(Args &&...args) {
+        void *mem = allocate_bytes(sizeof(T), alignof(T));
+        T *obj = new (mem) T(std::forward<Args>(args)...);
+        if (!std::is_trivially_destructible<T>::value) {
+            Finalizer *f = static_cast<Finalizer *>(allocate_bytes(sizeof(Finalizer), alignof(Finalizer)));
+            f->destroy = &destroy_object<T>;
+            f->object = obj;
+            f->next = finalizers;
+            finalizers = f;
+        }
+        return obj;
     }
 
-    // Convenience template to allocate and construct an object of type T
-    template<typename T, typename... Args>
-    T* alloc(Args&&... args) {
-        void* mem = allocate_bytes(sizeof(T));
-        return new (mem) T(std::forward<Args>(args)...);
+    // Take over every node and chunk of p_other, which is left empty. Used
+    // when nodes parsed into a temporary module outlive it.
+    void adopt(ASTArena &p_other) {
+        if (p_other.chunks == nullptr) {
+            return;
+        }
+        Chunk *tail = p_other.chunks;
+        while (tail->next) {
+            tail = tail->next;
+        }
+        // Keep bumping in our current chunk; the adopted ones are only kept alive.
+        if (chunks) {
+            tail->next = chunks->next;
+            chunks->next = p_other.chunks;
+        } else {
+            tail->next = nullptr;
+            chunks = p_other.chunks;
+            cursor = p_other.cursor;
+            limit = p_other.limit;
+        }
+        Finalizer *last = p_other.finalizers;
+        if (last) {
+            while (last->next) {
+                last = last->next;
+            }
+            last->next = finalizers;
+            finalizers = p_other.finalizers;
+        }
+        bytes_allocated += p_other.bytes_allocated;
+        bytes_reserved += p_other.bytes_reserved;
+        p_other.reset_state();
     }
 
-    // Free all allocations (calls destructors then frees memory)
+    // Destroy all nodes (newest first) and free every chunk.
     void clear() {
-        for (void* p : blocks) {
-            ::operator delete(p);
+        for (Finalizer *f = finalizers; f; f = f->next) {
+            f->destroy(f->object);
         }
-        blocks.clear();
+        Chunk *c = chunks;
+        while (c) {
+            Chunk *next = c->next;
+            ::operator delete(c);
+            c = next;
+        }
+        reset_state();
     }
 
+    std::size_t get_bytes_allocated() const { return bytes_allocated; }
+    std::size_t get_bytes_reserved() const { return bytes_reserved; }
+
 private:
-    std::vector<void*> blocks;
+    struct Chunk {
+        Chunk *next;
+    };
+    struct Finalizer {
+        void (*destroy)(void *);
+        void *object;
+        Finalizer *next;
+    };
+
+    template <typename T>
+    static void destroy_object(void *p) {
+        static_cast<T *>(p)->~T();
+    }
+
+    void new_chunk(std::size_t p_min) {
+        std::size_t header = (sizeof(Chunk) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+        std::size_t size = header + (p_min > CHUNK_SIZE ? p_min : CHUNK_SIZE);
+        Chunk *c = static_cast<Chunk *>(::operator new(size));
+        c->next = chunks;
+        chunks = c;
+        cursor = reinterpret_cast<char *>(c) + header;
+        limit = reinterpret_cast<char *>(c) + size;
+        bytes_reserved += size;
+    }
+
+    void reset_state() {
+        chunks = nullptr;
+        finalizers = nullptr;
+        cursor = nullptr;
+        limit = nullptr;
+        bytes_allocated = 0;
+        bytes_reserved = 0;
+    }
+
+    Chunk *chunks = nullptr;        // Newest first; the head is the one being bumped
+    Finalizer *finalizers = nullptr; // Newest first
+    char *cursor = nullptr;
+    char *limit = nullptr;
+    std::size_t bytes_allocated = 0;
+    std::size_t bytes_reserved = 0;
 };
 
 #endif // VISUAL_GASIC_AST_ARENA_H
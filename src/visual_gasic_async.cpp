@@ -19,45 +19,90 @@ Task::Task(TaskHandle handle, TaskFunction func)
 }
 
 void Task::execute() {
-    if (state_ == TaskState::CANCELLED) {
-        return;
+    TaskState expected = TaskState::PENDING;
+    if (!state_.compare_exchange_strong(expected, TaskState::RUNNING)) {
+        return; // Cancelled while queued
     }
     
-    state_ = TaskState::RUNNING;
-    
     // Execute the task function (no try/catch - exceptions disabled in Godot builds)
     result_ = function_();
-    state_ = result_.success ? TaskState::COMPLETED : TaskState::FAILED;
-    
-    // Run continuations
-    std::lock_guard<std::mutex> lock(mutex_);
-    for (auto& cont : continuations_) {
-        cont(result_);
-    }
+    function_ = nullptr; // Drop captures now, not when the slot is reused
+    finish(result_.success ? TaskState::COMPLETED : TaskState::FAILED);
 }
 
 void Task::cancel() {
     TaskState expected = TaskState::PENDING;
     if (state_.compare_exchange_strong(expected, TaskState::CANCELLED)) {
         result_ = TaskResult(String("Task cancelled"));
-        result_.success = false;
+        finish(TaskState::CANCELLED);
     }
 }
 
+// Publishes the result and runs the continuations outside the lock, so they
+// may schedule or await other tasks. Waiters wake only once every
+// continuation registered before that point has run.
+void Task::finish(TaskState state) {
+    state_ = state;
+    while (true) {
+        std::vector<ContinuationFunction> continuations;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (continuations_.empty()) {
+                finished_ = true;
+                break;
+            }
+            continuations.swap(continuations_);
+        }
+        for (auto& cont : continuations) {
+            cont(result_);
+        }
+    }
+    finished_cv_.notify_all();
+}
+
 void Task::add_continuation(ContinuationFunction cont) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (is_completed()) {
-        // Already completed, run immediately
-        cont(result_);
-    } else {
-        continuations_.push_back(std::move(cont));
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!finished_) {
+            continuations_.push_back(std::move(cont));
+            return;
+        }
     }
+    // Already finished, run immediately
+    cont(result_);
+}
+
+void Task::wait() {
+    if (finished_) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    finished_cv_.wait(lock, [this] { return finished_.load(); });
 }
 
 // ============================================================================
 // TaskScheduler Implementation
 // ============================================================================
 
+namespace {
+
+uint32_t slot_of(TaskHandle handle) {
+    return static_cast<uint32_t>(handle.get_id() & 0xffffffffu) - 1;
+}
+
+uint32_t generation_of(TaskHandle handle) {
+    return static_cast<uint32_t>(handle.get_id() >> 32);
+}
+
+TaskResult missing_task_result() {
+    return TaskResult(String("Task not found"));
+}
+
+// Index of the scheduler worker running on this thread, or -1.
+thread_local int current_worker_index = -1;
+
+} // namespace
+
 TaskScheduler& TaskScheduler::get_instance() {
     static TaskScheduler instance;
     return instance;
@@ -66,9 +111,15 @@ TaskScheduler& TaskScheduler::get_instance() {
 TaskScheduler::TaskScheduler() {
     running_ = true;
     
-    // Create worker threads
-    for (size_t i = 0; i < thread_count_; ++i) {
-        worker_threads_.emplace_back(&TaskScheduler::worker_thread_func, this);
+    // One worker per hardware thread, leaving one for the main thread.
+    unsigned int hardware = std::thread::hardware_concurrency();
+    size_t thread_count = hardware > 1 ? hardware - 1 : 1;
+    for (size_t i = 0; i < thread_count; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+        workers_.back()->steal_seed = static_cast<uint32_t>(i * 2654435761u + 1);
+    }
+    for (size_t i = 0; i < thread_count; ++i) {
+        worker_threads_.emplace_back(&TaskScheduler::worker_thread_func, this, i);
     }
 }
 
@@ -77,8 +128,11 @@ TaskScheduler::~TaskScheduler() {
 }
 
 void TaskScheduler::shutdown() {
-    running_ = false;
-    queue_cv_.notify_all();
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        running_ = false;
+    }
+    sleep_cv_.notify_all();
     
     for (auto& thread : worker_threads_) {
         if (thread.joinable()) {
@@ -88,54 +142,132 @@ void TaskScheduler::shutdown() {
     worker_threads_.clear();
 }
 
-void TaskScheduler::worker_thread_func() {
-    while (running_) {
-        TaskHandle handle;
-        
-        {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-            queue_cv_.wait(lock, [this] {
-                return !pending_queue_.empty() || !running_;
-            });
-            
-            if (!running_ && pending_queue_.empty()) {
-                return;
-            }
-            
-            if (!pending_queue_.empty()) {
-                handle = pending_queue_.front();
-                pending_queue_.pop();
-                pending_count_--;
-                running_count_++;
-            }
+void TaskScheduler::worker_thread_func(size_t index) {
+    current_worker_index = static_cast<int>(index);
+    while (true) {
+        Task* task = take_task(current_worker_index);
+        if (task) {
+            run_task(task);
+            continue;
         }
         
-        if (handle.is_valid()) {
-            Task* task = find_task(handle);
-            if (task) {
-                task->execute();
-                running_count_--;
-                completed_count_++;
-            }
+        // Pairs with enqueue(): either it sees this worker counted as
+        // sleeping and notifies under the lock, or the predicate sees its
+        // pending_count_ increment.
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        sleeping_count_++;
+        sleep_cv_.wait(lock, [this] {
+            return pending_count_ > 0 || !running_;
+        });
+        sleeping_count_--;
+        if (!running_ && pending_count_ == 0) {
+            return;
         }
     }
 }
 
-TaskHandle TaskScheduler::schedule(Task::TaskFunction func) {
-    TaskHandle handle(next_task_id_++);
+void TaskScheduler::enqueue(std::shared_ptr<Task> task) {
+    Task* raw = task.get();
+    raw->queued_self_ = std::move(task);
     
-    {
-        std::lock_guard<std::mutex> lock(tasks_mutex_);
-        tasks_.push_back(std::make_unique<Task>(handle, std::move(func)));
+    int worker = current_worker_index;
+    if (worker >= 0) {
+        workers_[worker]->deque.push(raw);
+    } else {
+        std::lock_guard<std::mutex> lock(injection_mutex_);
+        injection_queue_.push_back(raw);
     }
     
+    pending_count_++;
+    if (sleeping_count_ > 0) {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        sleep_cv_.notify_one();
+    }
+}
+
+// Own deque first, then the injection queue, then one pass over the other
+// workers starting at a random victim. A lost steal race counts as empty.
+Task* TaskScheduler::take_task(int worker_index) {
+    Task* task = nullptr;
+    if (worker_index >= 0) {
+        task = workers_[worker_index]->deque.pop();
+    }
+    if (!task) {
+        std::lock_guard<std::mutex> lock(injection_mutex_);
+        if (!injection_queue_.empty()) {
+            task = injection_queue_.front();
+            injection_queue_.pop_front();
+        }
+    }
+    if (!task && workers_.size() > 1) {
+        size_t count = workers_.size();
+        size_t start = 0;
+        if (worker_index >= 0) {
+            uint32_t& seed = workers_[worker_index]->steal_seed;
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            start = seed % count;
+        }
+        for (size_t i = 0; i < count && !task; ++i) {
+            size_t victim = (start + i) % count;
+            if (static_cast<int>(victim) != worker_index) {
+                task = workers_[victim]->deque.steal();
+            }
+        }
+    }
+    if (task) {
+        pending_count_--;
+    }
+    return task;
+}
+
+void TaskScheduler::run_task(Task* raw) {
+    std::shared_ptr<Task> task = std::move(raw->queued_self_);
+    running_count_++;
+    task->execute();
+    running_count_--;
+    completed_count_++;
+    if (task->detached_) {
+        release(task->get_handle());
+    }
+}
+
+// Once a scan finds nothing, whatever the caller waits on is already running
+// on another thread, so blocking from there on cannot deadlock.
+void TaskScheduler::help_until(const std::function<bool()>& done) {
+    int worker = current_worker_index;
+    if (worker < 0) {
+        return;
+    }
+    while (!done()) {
+        Task* task = take_task(worker);
+        if (!task) {
+            return;
+        }
+        run_task(task);
+    }
+}
+
+TaskHandle TaskScheduler::schedule(Task::TaskFunction func) {
+    std::shared_ptr<Task> task;
     {
-        std::lock_guard<std::mutex> lock(queue_mutex_);
-        pending_queue_.push(handle);
-        pending_count_++;
+        std::lock_guard<std::mutex> lock(tasks_mutex_);
+        uint32_t index;
+        if (!free_slots_.empty()) {
+            index = free_slots_.back();
+            free_slots_.pop_back();
+        } else {
+            index = static_cast<uint32_t>(slots_.size());
+            slots_.emplace_back();
+        }
+        TaskSlot& slot = slots_[index];
+        TaskHandle handle((static_cast<uint64_t>(slot.generation) << 32) | (index + 1));
+        task = std::make_shared<Task>(handle, std::move(func));
+        slot.task = task;
     }
-    
-    queue_cv_.notify_one();
+    TaskHandle handle = task->get_handle();
+    enqueue(std::move(task));
     return handle;
 }
 
@@ -150,59 +282,93 @@ TaskHandle TaskScheduler::schedule_delayed(Task::TaskFunction func, double delay
     return schedule(delayed_func);
 }
 
-Task* TaskScheduler::find_task(TaskHandle handle) {
+std::shared_ptr<Task> TaskScheduler::find_task(TaskHandle handle) const {
+    uint32_t index = slot_of(handle);
     std::lock_guard<std::mutex> lock(tasks_mutex_);
-    for (auto& task : tasks_) {
-        if (task->get_handle() == handle) {
-            return task.get();
-        }
+    if (!handle.is_valid() || index >= slots_.size() || slots_[index].generation != generation_of(handle)) {
+        return nullptr;
     }
-    return nullptr;
+    return slots_[index].task;
 }
 
-bool TaskScheduler::is_completed(TaskHandle handle) const {
-    std::lock_guard<std::mutex> lock(const_cast<std::mutex&>(tasks_mutex_));
-    for (const auto& task : tasks_) {
-        if (task->get_handle() == handle) {
-            return task->is_completed();
-        }
+void TaskScheduler::release(TaskHandle handle) {
+    uint32_t index = slot_of(handle);
+    std::shared_ptr<Task> task; // Destroyed outside the lock
+    std::lock_guard<std::mutex> lock(tasks_mutex_);
+    if (!handle.is_valid() || index >= slots_.size() || slots_[index].generation != generation_of(handle)) {
+        return;
+    }
+    TaskSlot& slot = slots_[index];
+    task.swap(slot.task);
+    slot.generation++;
+    if (slot.generation == 0) {
+        slot.generation = 1; // Keep ids of reused slots distinct from never-issued ones
     }
-    return true; // Not found means completed or invalid
+    free_slots_.push_back(index);
+}
+
+bool TaskScheduler::is_completed(TaskHandle handle) const {
+    std::shared_ptr<Task> task = find_task(handle);
+    return !task || task->is_finished(); // Not found means completed or invalid
 }
 
 TaskState TaskScheduler::get_state(TaskHandle handle) const {
-    std::lock_guard<std::mutex> lock(const_cast<std::mutex&>(tasks_mutex_));
-    for (const auto& task : tasks_) {
-        if (task->get_handle() == handle) {
-            return task->get_state();
-        }
-    }
-    return TaskState::COMPLETED;
+    std::shared_ptr<Task> task = find_task(handle);
+    return task ? task->get_state() : TaskState::COMPLETED;
 }
 
 TaskResult TaskScheduler::get_result(TaskHandle handle) const {
-    std::lock_guard<std::mutex> lock(const_cast<std::mutex&>(tasks_mutex_));
-    for (const auto& task : tasks_) {
-        if (task->get_handle() == handle) {
-            return task->get_result();
-        }
+    std::shared_ptr<Task> task = find_task(handle);
+    if (!task || !task->is_finished()) {
+        return task ? TaskResult(String("Task not finished")) : missing_task_result();
     }
-    return TaskResult(String("Task not found"));
+    return task->get_result();
 }
 
 void TaskScheduler::cancel(TaskHandle handle) {
-    Task* task = find_task(handle);
+    std::shared_ptr<Task> task = find_task(handle);
     if (task) {
         task->cancel();
     }
 }
 
+void TaskScheduler::detach(TaskHandle handle) {
+    std::shared_ptr<Task> task = find_task(handle);
+    if (!task) {
+        return;
+    }
+    task->detached_ = true;
+    if (task->is_finished()) {
+        release(handle); // The worker may have finished before seeing the flag
+    }
+}
+
+void TaskScheduler::then(TaskHandle handle, Task::ContinuationFunction cont) {
+    std::shared_ptr<Task> task = find_task(handle);
+    if (!task) {
+        cont(missing_task_result());
+        return;
+    }
+    task->add_continuation(std::move(cont));
+}
+
+void TaskScheduler::then_on_main(TaskHandle handle, Task::ContinuationFunction cont) {
+    then(handle, [this, cont](const TaskResult& result) {
+        std::lock_guard<std::mutex> lock(main_mutex_);
+        main_continuations_.push_back({ cont, result });
+    });
+}
+
 TaskResult TaskScheduler::await(TaskHandle handle) {
-    // Busy-wait for completion (in a real implementation, use proper async patterns)
-    while (!is_completed(handle)) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    std::shared_ptr<Task> task = find_task(handle);
+    if (!task) {
+        return missing_task_result();
     }
-    return get_result(handle);
+    help_until([&task] { return task->is_finished(); });
+    task->wait();
+    TaskResult result = task->get_result();
+    release(handle);
+    return result;
 }
 
 std::vector<TaskResult> TaskScheduler::await_all(const std::vector<TaskHandle>& handles) {
@@ -216,21 +382,60 @@ std::vector<TaskResult> TaskScheduler::await_all(const std::vector<TaskHandle>&
     return results;
 }
 
+// Only the task that finished first is released; the others can still be
+// awaited.
 TaskResult TaskScheduler::await_any(const std::vector<TaskHandle>& handles, TaskHandle& completed_handle) {
-    while (true) {
-        for (const auto& handle : handles) {
-            if (is_completed(handle)) {
-                completed_handle = handle;
-                return get_result(handle);
+    struct AnyWaiter {
+        std::mutex mutex;
+        std::condition_variable cv;
+        TaskHandle first;
+    };
+    auto waiter = std::make_shared<AnyWaiter>();
+    
+    for (const auto& handle : handles) {
+        then(handle, [waiter, handle](const TaskResult&) {
+            {
+                std::lock_guard<std::mutex> lock(waiter->mutex);
+                if (waiter->first.is_valid()) {
+                    return;
+                }
+                waiter->first = handle;
             }
+            waiter->cv.notify_all();
+        });
+        std::lock_guard<std::mutex> lock(waiter->mutex);
+        if (waiter->first.is_valid()) {
+            break;
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
+    if (handles.empty()) {
+        completed_handle = TaskHandle();
+        return missing_task_result();
+    }
+    
+    help_until([&waiter] {
+        std::lock_guard<std::mutex> lock(waiter->mutex);
+        return waiter->first.is_valid();
+    });
+    {
+        std::unique_lock<std::mutex> lock(waiter->mutex);
+        waiter->cv.wait(lock, [&waiter] { return waiter->first.is_valid(); });
+        completed_handle = waiter->first;
+    }
+    return await(completed_handle);
 }
 
 void TaskScheduler::process_pending() {
-    // This is called from the main thread to process completed tasks
-    // and run any main-thread-only continuations
+    // Runs the continuations registered with then_on_main for tasks that
+    // finished since the last call.
+    std::vector<MainThreadContinuation> ready;
+    {
+        std::lock_guard<std::mutex> lock(main_mutex_);
+        ready.swap(main_continuations_);
+    }
+    for (auto& entry : ready) {
+        entry.function(entry.result);
+    }
 }
 
 size_t TaskScheduler::get_pending_count() const {
@@ -277,79 +482,101 @@ bool AsyncContext::has_local(const String& name) const {
 // ParallelExecutor Implementation
 // ============================================================================
 
+namespace {
+
+// Chunks per thread: enough slack for stealing to even out uneven items
+// without paying a task per item.
+constexpr size_t CHUNKS_PER_THREAD = 4;
+
+} // namespace
+
+void ParallelExecutor::for_each_chunk(size_t count, const std::function<void(size_t, size_t)>& body) {
+    if (count == 0) {
+        return;
+    }
+    auto& scheduler = TaskScheduler::get_instance();
+    size_t threads = scheduler.get_thread_count() + 1; // The caller works too
+    size_t chunk = std::max<size_t>(1, count / (threads * CHUNKS_PER_THREAD));
+    if (chunk >= count) {
+        body(0, count);
+        return;
+    }
+    
+    std::vector<TaskHandle> handles;
+    handles.reserve((count - 1) / chunk);
+    for (size_t begin = chunk; begin < count; begin += chunk) {
+        size_t end = std::min(count, begin + chunk);
+        handles.push_back(scheduler.schedule([&body, begin, end]() -> TaskResult {
+            body(begin, end);
+            return TaskResult();
+        }));
+    }
+    body(0, chunk);
+    scheduler.await_all(handles); // Also keeps body alive for the chunks
+}
+
 std::vector<TaskResult> ParallelExecutor::parallel_invoke(
         const std::vector<Task::TaskFunction>& functions) {
+    if (functions.empty()) {
+        return {};
+    }
     std::vector<TaskHandle> handles;
-    handles.reserve(functions.size());
+    handles.reserve(functions.size() - 1);
     
     auto& scheduler = TaskScheduler::get_instance();
-    for (const auto& func : functions) {
-        handles.push_back(scheduler.schedule(func));
+    for (size_t i = 1; i < functions.size(); ++i) {
+        handles.push_back(scheduler.schedule(functions[i]));
     }
     
-    return scheduler.await_all(handles);
+    std::vector<TaskResult> results;
+    results.reserve(functions.size());
+    results.push_back(functions[0]());
+    for (TaskResult& result : scheduler.await_all(handles)) {
+        results.push_back(std::move(result));
+    }
+    return results;
 }
 
 Array ParallelExecutor::parallel_map(const Array& items, Callable func) {
-    Array results;
-    results.resize(items.size());
-    
-    std::vector<TaskHandle> handles;
-    handles.reserve(items.size());
-    
-    auto& scheduler = TaskScheduler::get_instance();
+    size_t count = static_cast<size_t>(items.size());
+    std::vector<Variant> values(count);
     
-    for (int i = 0; i < items.size(); ++i) {
-        Variant item = items[i];
-        int index = i;
-        
-        handles.push_back(scheduler.schedule([item, func]() -> TaskResult {
-            Array args;
-            args.push_back(item);
-            return TaskResult(func.callv(args));
-        }));
-    }
+    for_each_chunk(count, [&items, &func, &values](size_t begin, size_t end) {
+        Array args;
+        args.resize(1);
+        for (size_t i = begin; i < end; ++i) {
+            args[0] = items[static_cast<int64_t>(i)];
+            values[i] = func.callv(args);
+        }
+    });
     
-    auto task_results = scheduler.await_all(handles);
-    for (size_t i = 0; i < task_results.size(); ++i) {
-        results[i] = task_results[i].value;
+    Array results;
+    results.resize(static_cast<int64_t>(count));
+    for (size_t i = 0; i < count; ++i) {
+        results[static_cast<int64_t>(i)] = values[i];
     }
-    
     return results;
 }
 
 Array ParallelExecutor::parallel_filter(const Array& items, Callable predicate) {
-    Array results;
-    
-    std::vector<TaskHandle> handles;
-    handles.reserve(items.size());
+    size_t count = static_cast<size_t>(items.size());
+    std::vector<uint8_t> keep(count);
     
-    auto& scheduler = TaskScheduler::get_instance();
-    
-    for (int i = 0; i < items.size(); ++i) {
-        Variant item = items[i];
-        
-        handles.push_back(scheduler.schedule([item, predicate]() -> TaskResult {
-            Array args;
-            args.push_back(item);
-            bool keep = bool(predicate.callv(args));
-            Dictionary result;
-            result["item"] = item;
-            result["keep"] = keep;
-            return TaskResult(result);
-        }));
-    }
+    for_each_chunk(count, [&items, &predicate, &keep](size_t begin, size_t end) {
+        Array args;
+        args.resize(1);
+        for (size_t i = begin; i < end; ++i) {
+            args[0] = items[static_cast<int64_t>(i)];
+            keep[i] = bool(predicate.callv(args)) ? 1 : 0;
+        }
+    });
     
-    auto task_results = scheduler.await_all(handles);
-    for (const auto& result : task_results) {
-        if (result.success) {
-            Dictionary d = result.value;
-            if (bool(d["keep"])) {
-                results.push_back(d["item"]);
-            }
+    Array results;
+    for (size_t i = 0; i < count; ++i) {
+        if (keep[i]) {
+            results.push_back(items[static_cast<int64_t>(i)]);
         }
     }
-    
     return results;
 }
 
@@ -22,6 +22,8 @@
 #include <thread>
 #include <condition_variable>
 #include <future>
+#include <deque>
+#include "visual_gasic_work_stealing_deque.h"
 
 using namespace godot;
 
@@ -79,25 +81,53 @@ public:
     
     TaskHandle get_handle() const { return handle_; }
     TaskState get_state() const { return state_; }
+    // Only meaningful once is_finished(); the result is never written again.
     const TaskResult& get_result() const { return result_; }
     
     void execute();
     void cancel();
+    // Runs cont on the thread that finishes the task, or right away if it
+    // already has.
     void add_continuation(ContinuationFunction cont);
+    // Blocks until the task has run or was cancelled.
+    void wait();
     
     bool is_completed() const { return state_ == TaskState::COMPLETED || state_ == TaskState::FAILED; }
     bool is_cancelled() const { return state_ == TaskState::CANCELLED; }
+    bool is_finished() const { return finished_; }
     
 private:
+    friend class TaskScheduler;
+
+    void finish(TaskState state);
+
     TaskHandle handle_;
     TaskFunction function_;
     std::vector<ContinuationFunction> continuations_;
     TaskResult result_;
     std::atomic<TaskState> state_{TaskState::PENDING};
+    std::atomic<bool> finished_{false};
+    std::atomic<bool> detached_{false}; // Release the slot as soon as it finishes
+    std::shared_ptr<Task> queued_self_; // The run queue's reference while queued
     std::mutex mutex_;
+    std::condition_variable finished_cv_;
 };
 
 // Task scheduler - manages async task execution
+//
+// Handles are (generation << 32 | slot + 1) into a table of task slots, so
+// lookups are O(1). A slot is reused once its task has been awaited (the
+// result is handed over) or, for detach()ed tasks, once it finishes; a stale
+// handle then reads as completed with a "Task not found" result.
+//
+// Work stealing: each worker owns a Chase-Lev deque. Tasks scheduled from a
+// worker go to the bottom of its own deque (LIFO, so forked subtasks run hot
+// in cache); tasks scheduled from any other thread go to a shared injection
+// queue. An idle worker pops its own deque, then the injection queue, then
+// steals from the top of another worker's deque, and sleeps only when all
+// are empty. A worker that awaits keeps running queued tasks until the
+// awaited one finishes, so tasks may fork and join subtasks at any depth
+// without exhausting the pool.
 class TaskScheduler {
 public:
     static TaskScheduler& get_instance();
@@ -111,8 +141,16 @@ public:
     TaskState get_state(TaskHandle handle) const;
     TaskResult get_result(TaskHandle handle) const;
     void cancel(TaskHandle handle);
+    // Fire and forget: nobody will await the task.
+    void detach(TaskHandle handle);
+    
+    // Continuations: `then` runs on the worker that finishes the task,
+    // `then_on_main` from the next process_pending() call.
+    void then(TaskHandle handle, Task::ContinuationFunction cont);
+    void then_on_main(TaskHandle handle, Task::ContinuationFunction cont);
     
-    // Awaiting
+    // Awaiting (blocks without polling, then releases the awaited slots;
+    // on a worker thread, runs other queued tasks while it waits)
     TaskResult await(TaskHandle handle);
     std::vector<TaskResult> await_all(const std::vector<TaskHandle>& handles);
     TaskResult await_any(const std::vector<TaskHandle>& handles, TaskHandle& completed_handle);
@@ -125,6 +163,7 @@ public:
     size_t get_pending_count() const;
     size_t get_running_count() const;
     size_t get_completed_count() const;
+    size_t get_thread_count() const { return worker_threads_.size(); }
     
 private:
     TaskScheduler();
@@ -134,19 +173,44 @@ private:
     TaskScheduler(const TaskScheduler&) = delete;
     TaskScheduler& operator=(const TaskScheduler&) = delete;
     
-    void worker_thread_func();
-    Task* find_task(TaskHandle handle);
+    struct TaskSlot {
+        std::shared_ptr<Task> task;
+        uint32_t generation = 1;
+    };
+    struct MainThreadContinuation {
+        Task::ContinuationFunction function;
+        TaskResult result;
+    };
+    
+    struct Worker {
+        WorkStealingDeque<Task*> deque;
+        uint32_t steal_seed = 1;
+    };
+    
+    void worker_thread_func(size_t index);
+    void enqueue(std::shared_ptr<Task> task);
+    Task* take_task(int worker_index);
+    void run_task(Task* task);
+    // On a worker thread, runs queued tasks until done() holds or there is
+    // nothing left to run; the caller then blocks for what remains.
+    void help_until(const std::function<bool()>& done);
+    std::shared_ptr<Task> find_task(TaskHandle handle) const;
+    void release(TaskHandle handle);
     
-    std::atomic<uint64_t> next_task_id_{1};
-    std::vector<std::unique_ptr<Task>> tasks_;
-    std::queue<TaskHandle> pending_queue_;
-    std::mutex tasks_mutex_;
-    std::mutex queue_mutex_;
-    std::condition_variable queue_cv_;
+    std::vector<TaskSlot> slots_;
+    std::vector<uint32_t> free_slots_;
+    mutable std::mutex tasks_mutex_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::deque<Task*> injection_queue_;
+    std::mutex injection_mutex_;
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    std::atomic<size_t> sleeping_count_{0};
+    std::mutex main_mutex_;
+    std::vector<MainThreadContinuation> main_continuations_;
     
     std::vector<std::thread> worker_threads_;
     std::atomic<bool> running_{false};
-    size_t thread_count_ = 4;
     
     std::atomic<size_t> pending_count_{0};
     std::atomic<size_t> running_count_{0};
@@ -180,8 +244,16 @@ private:
 };
 
 // Parallel execution utilities
+//
+// The bulk operations split their input into contiguous chunks, about four
+// per thread, rather than scheduling one task per item; the calling thread
+// runs the first chunk itself. They may be called from inside a task.
 class ParallelExecutor {
 public:
+    // Calls body(begin, end) over disjoint ranges covering [0, count) and
+    // returns once every range has been processed.
+    static void for_each_chunk(size_t count, const std::function<void(size_t, size_t)>& body);
+    
     // Execute items in parallel with a function
     template<typename T>
     static std::vector<TaskResult> parallel_for(
@@ -199,6 +271,19 @@ public:
     static Array parallel_filter(const Array& items, Callable predicate);
 };
 
+template<typename T>
+std::vector<TaskResult> ParallelExecutor::parallel_for(
+        const std::vector<T>& items,
+        std::function<TaskResult(const T&, size_t)> func) {
+    std::vector<TaskResult> results(items.size());
+    for_each_chunk(items.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            results[i] = func(items[i], i);
+        }
+    });
+    return results;
+}
+
 // Helper macros for async patterns
 #define VG_ASYNC_BEGIN(context) \
     AsyncContext& __async_ctx = context; \
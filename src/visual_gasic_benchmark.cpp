@@ -1,12 +1,37 @@
 #include "visual_gasic_benchmark.h"
+#include "visual_gasic_async.h"
+#include "visual_gasic_builtins.h"
+#include "visual_gasic_data_pool.h"
+#include "visual_gasic_draw_batch.h"
+#include "visual_gasic_file.h"
+#include "visual_gasic_global_slots.h"
+#include "visual_gasic_parser.h"
 
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/classes/time.hpp>
 #include <godot_cpp/classes/file_access.hpp>
 #include <godot_cpp/variant/string.hpp>
 
+#include <climits>
+#include <cstring>
+#include <string>
 #include <vector>
 
+namespace {
+
+int64_t fork_join_fib(int64_t n) {
+    using namespace VisualGasic::Async;
+    if (n < 2) {
+        return n;
+    }
+    TaskScheduler &scheduler = TaskScheduler::get_instance();
+    TaskHandle left = scheduler.schedule([n]() { return TaskResult(Variant(fork_join_fib(n - 1))); });
+    int64_t right = fork_join_fib(n - 2);
+    return (int64_t)scheduler.await(left).value + right;
+}
+
+} // namespace
+
 void VisualGasicBenchmark::_bind_methods() {
     ClassDB::bind_method(D_METHOD("run_cpp_benchmark", "iterations", "inner"), &VisualGasicBenchmark::run_cpp_benchmark);
     ClassDB::bind_method(D_METHOD("run_cpp_arithmetic", "iterations", "inner"), &VisualGasicBenchmark::run_cpp_arithmetic);
@@ -18,6 +43,13 @@ void VisualGasicBenchmark::_bind_methods() {
     ClassDB::bind_method(D_METHOD("run_cpp_allocations", "iterations", "size"), &VisualGasicBenchmark::run_cpp_allocations);
     ClassDB::bind_method(D_METHOD("run_cpp_allocations_fast", "iterations", "size"), &VisualGasicBenchmark::run_cpp_allocations_fast);
     ClassDB::bind_method(D_METHOD("run_cpp_file_io", "iterations", "size"), &VisualGasicBenchmark::run_cpp_file_io);
+    ClassDB::bind_method(D_METHOD("run_cpp_global_access", "iterations", "inner"), &VisualGasicBenchmark::run_cpp_global_access);
+    ClassDB::bind_method(D_METHOD("run_cpp_tasks", "count"), &VisualGasicBenchmark::run_cpp_tasks);
+    ClassDB::bind_method(D_METHOD("run_cpp_fork_join", "depth", "items"), &VisualGasicBenchmark::run_cpp_fork_join);
+    ClassDB::bind_method(D_METHOD("run_cpp_builtin_dispatch", "iterations"), &VisualGasicBenchmark::run_cpp_builtin_dispatch);
+    ClassDB::bind_method(D_METHOD("run_cpp_draw_batch", "width", "height", "frames"), &VisualGasicBenchmark::run_cpp_draw_batch);
+    ClassDB::bind_method(D_METHOD("run_cpp_record_io", "records", "record_length"), &VisualGasicBenchmark::run_cpp_record_io);
+    ClassDB::bind_method(D_METHOD("run_cpp_data_pool", "values"), &VisualGasicBenchmark::run_cpp_data_pool);
 }
 
 Dictionary VisualGasicBenchmark::run_cpp_benchmark(int64_t iterations, int64_t inner) {
@@ -283,3 +315,405 @@ Dictionary VisualGasicBenchmark::run_cpp_file_io(int64_t iterations, int64_t siz
     result["checksum"] = (int64_t)read_line.length();
     return result;
 }
+
+// Same workload as BenchGlobalAccess, run twice: once against a String-keyed
+// Dictionary (the interpreter's old variable storage) and once against
+// GlobalSlotTable slots. elapsed_us reports the slot path.
+Dictionary VisualGasicBenchmark::run_cpp_global_access(int64_t iterations, int64_t inner) {
+    Dictionary result;
+    if (iterations <= 0 || inner <= 0) {
+        result["elapsed_us"] = 0;
+        result["dictionary_us"] = 0;
+        result["checksum"] = 0;
+        return result;
+    }
+
+    const String name_a = "BenchGlobalA";
+    const String name_b = "BenchGlobalB";
+
+    Dictionary dict;
+    dict[name_a] = (int64_t)0;
+    dict[name_b] = (int64_t)0;
+    uint64_t start = Time::get_singleton()->get_ticks_usec();
+    for (int64_t i = 0; i < iterations; i++) {
+        for (int64_t j = 0; j < inner; j++) {
+            dict[name_a] = (int64_t)dict[name_a] + j;
+            dict[name_b] = (int64_t)dict[name_b] + 1;
+        }
+    }
+    uint64_t dictionary_elapsed = Time::get_singleton()->get_ticks_usec() - start;
+    int64_t dictionary_sum = (int64_t)dict[name_a] + (int64_t)dict[name_b];
+
+    GlobalSlotTable table;
+    int slot_a = table.intern(name_a);
+    int slot_b = table.intern(name_b);
+    table.set_slot(slot_a, (int64_t)0);
+    table.set_slot(slot_b, (int64_t)0);
+    start = Time::get_singleton()->get_ticks_usec();
+    for (int64_t i = 0; i < iterations; i++) {
+        for (int64_t j = 0; j < inner; j++) {
+            table.set_slot(slot_a, (int64_t)table.get_slot(slot_a) + j);
+            table.set_slot(slot_b, (int64_t)table.get_slot(slot_b) + 1);
+        }
+    }
+    uint64_t slot_elapsed = Time::get_singleton()->get_ticks_usec() - start;
+    int64_t slot_sum = (int64_t)table.get_slot(slot_a) + (int64_t)table.get_slot(slot_b);
+
+    result["elapsed_us"] = (int64_t)slot_elapsed;
+    result["dictionary_us"] = (int64_t)dictionary_elapsed;
+    result["checksum"] = slot_sum == dictionary_sum ? slot_sum : (int64_t)-1;
+    return result;
+}
+
+// Async::TaskScheduler cost for tiny tasks: `roundtrip_us` schedules and
+// awaits one task at a time (wake-up latency), `elapsed_us` schedules all of
+// them and then awaits them in order (throughput).
+Dictionary VisualGasicBenchmark::run_cpp_tasks(int64_t count) {
+    using namespace VisualGasic::Async;
+    Dictionary result;
+    TaskScheduler &scheduler = TaskScheduler::get_instance();
+    result["threads"] = (int64_t)scheduler.get_thread_count();
+    if (count <= 0) {
+        result["elapsed_us"] = 0;
+        result["roundtrip_us"] = 0;
+        result["checksum"] = 0;
+        return result;
+    }
+
+    int64_t roundtrip_sum = 0;
+    uint64_t start = Time::get_singleton()->get_ticks_usec();
+    for (int64_t i = 0; i < count; i++) {
+        TaskHandle handle = scheduler.schedule([i]() { return TaskResult(Variant(i)); });
+        roundtrip_sum += (int64_t)scheduler.await(handle).value;
+    }
+    uint64_t roundtrip_elapsed = Time::get_singleton()->get_ticks_usec() - start;
+
+    std::vector<TaskHandle> handles;
+    handles.reserve(static_cast<size_t>(count));
+    start = Time::get_singleton()->get_ticks_usec();
+    for (int64_t i = 0; i < count; i++) {
+        handles.push_back(scheduler.schedule([i]() { return TaskResult(Variant(i)); }));
+    }
+    int64_t batch_sum = 0;
+    for (const TaskResult &task_result : scheduler.await_all(handles)) {
+        batch_sum += (int64_t)task_result.value;
+    }
+    uint64_t batch_elapsed = Time::get_singleton()->get_ticks_usec() - start;
+
+    result["elapsed_us"] = (int64_t)batch_elapsed;
+    result["roundtrip_us"] = (int64_t)roundtrip_elapsed;
+    result["checksum"] = roundtrip_sum == batch_sum ? batch_sum : (int64_t)-1;
+    return result;
+}
+
+// Work-stealing scheduler under nested parallelism: `elapsed_us` is a
+// fork-join fib(depth) with one task per call, `parallel_for_us` a chunked
+// ParallelExecutor::parallel_for over `items` integers.
+Dictionary VisualGasicBenchmark::run_cpp_fork_join(int64_t depth, int64_t items) {
+    using namespace VisualGasic::Async;
+    Dictionary result;
+    TaskScheduler &scheduler = TaskScheduler::get_instance();
+    result["threads"] = (int64_t)scheduler.get_thread_count();
+    if (depth < 0 || items < 0) {
+        result["elapsed_us"] = 0;
+        result["parallel_for_us"] = 0;
+        result["checksum"] = 0;
+        result["parallel_checksum"] = 0;
+        return result;
+    }
+
+    uint64_t start = Time::get_singleton()->get_ticks_usec();
+    TaskHandle root = scheduler.schedule([depth]() { return TaskResult(Variant(fork_join_fib(depth))); });
+    int64_t fib = (int64_t)scheduler.await(root).value;
+    uint64_t fib_elapsed = Time::get_singleton()->get_ticks_usec() - start;
+
+    std::vector<int64_t> values(static_cast<size_t>(items));
+    for (int64_t i = 0; i < items; i++) {
+        values[static_cast<size_t>(i)] = i;
+    }
+    start = Time::get_singleton()->get_ticks_usec();
+    std::vector<TaskResult> mapped = ParallelExecutor::parallel_for<int64_t>(values,
+            [](const int64_t &value, size_t) { return TaskResult(Variant(value)); });
+    int64_t parallel_sum = 0;
+    for (const TaskResult &task_result : mapped) {
+        parallel_sum += (int64_t)task_result.value;
+    }
+    uint64_t parallel_elapsed = Time::get_singleton()->get_ticks_usec() - start;
+
+    result["elapsed_us"] = (int64_t)fib_elapsed;
+    result["parallel_for_us"] = (int64_t)parallel_elapsed;
+    result["checksum"] = fib;
+    result["parallel_checksum"] = parallel_sum;
+    return result;
+}
+
+// Per-builtin dispatch cost, in table order: `resolve_ns` is the one-off
+// name lookup a call site pays (VB capitalisation), `dispatch_ns` a call by
+// cached ID. The calls pass an argument count outside the builtin's arity,
+// so they stop right after dispatch and no builtin body runs; builtins that
+// accept any number of arguments are listed under `skipped`.
+Dictionary VisualGasicBenchmark::run_cpp_builtin_dispatch(int64_t iterations) {
+    Dictionary result;
+    Array builtins;
+    Array skipped;
+    if (iterations <= 0) {
+        result["builtins"] = builtins;
+        result["skipped"] = skipped;
+        return result;
+    }
+
+    int64_t unhandled = 0;
+    int count = VisualGasicBuiltins::get_expr_builtin_count();
+    for (int id = 0; id < count; id++) {
+        String name = VisualGasicBuiltins::get_expr_builtin_name(id);
+        int min_args = 0;
+        int max_args = 0;
+        VisualGasicBuiltins::get_expr_builtin_arity(id, min_args, max_args);
+        int argc = min_args > 0 ? min_args - 1 : max_args + 1;
+        if (min_args == 0 && max_args == INT_MAX) {
+            skipped.push_back(name);
+            continue;
+        }
+        Array args;
+        args.resize(argc);
+        String vb_name = name.substr(0, 1).to_upper() + name.substr(1);
+
+        uint64_t start = Time::get_singleton()->get_ticks_usec();
+        int64_t id_sum = 0;
+        for (int64_t i = 0; i < iterations; i++) {
+            id_sum += VisualGasicBuiltins::find_expr_builtin_id(vb_name);
+        }
+        uint64_t resolve_elapsed = Time::get_singleton()->get_ticks_usec() - start;
+
+        start = Time::get_singleton()->get_ticks_usec();
+        for (int64_t i = 0; i < iterations; i++) {
+            bool handled = true;
+            VisualGasicBuiltins::call_builtin_expr_by_id(nullptr, id, args, handled);
+            unhandled += handled ? 0 : 1;
+        }
+        uint64_t dispatch_elapsed = Time::get_singleton()->get_ticks_usec() - start;
+
+        Dictionary entry;
+        entry["id"] = id;
+        entry["name"] = name;
+        entry["resolve_ns"] = (double)resolve_elapsed * 1000.0 / (double)iterations;
+        entry["dispatch_ns"] = (double)dispatch_elapsed * 1000.0 / (double)iterations;
+        entry["resolved"] = id_sum == (int64_t)id * iterations;
+        builtins.push_back(entry);
+    }
+
+    result["builtins"] = builtins;
+    result["skipped"] = skipped;
+    result["checksum"] = unhandled;
+    return result;
+}
+
+// PSet cost per frame for a width x height screen: batching the pixels
+// into triangles (without a canvas, so the draw calls themselves are not
+// counted), and writing them into the framebuffer and uploading it. The
+// pixels_per_frame figures are how many pixels fit in a 60 FPS frame.
+Dictionary VisualGasicBenchmark::run_cpp_draw_batch(int64_t width, int64_t height, int64_t frames) {
+    Dictionary result;
+    if (width <= 0 || height <= 0 || frames <= 0) {
+        result["elapsed_us"] = 0;
+        result["checksum"] = 0;
+        return result;
+    }
+
+    const double frame_budget_us = 1000000.0 / 60.0;
+    const int64_t pixels = width * height;
+
+    VisualGasicDrawBatch batch;
+    uint64_t start = Time::get_singleton()->get_ticks_usec();
+    for (int64_t frame = 0; frame < frames; frame++) {
+        for (int64_t y = 0; y < height; y++) {
+            for (int64_t x = 0; x < width; x++) {
+                batch.add_pixel(Vector2(x, y), Color((x + frame) % 256 / 255.0f, y % 256 / 255.0f, 0.5f));
+            }
+        }
+        batch.flush();
+    }
+    uint64_t batch_elapsed = Time::get_singleton()->get_ticks_usec() - start;
+
+    batch.set_framebuffer(nullptr, (int)width, (int)height, 1);
+    int64_t uploads = 0;
+    start = Time::get_singleton()->get_ticks_usec();
+    for (int64_t frame = 0; frame < frames; frame++) {
+        for (int64_t y = 0; y < height; y++) {
+            for (int64_t x = 0; x < width; x++) {
+                batch.framebuffer_pset((int)x, (int)y, Color((x + frame) % 256 / 255.0f, y % 256 / 255.0f, 0.5f));
+            }
+        }
+        uploads += batch.upload_framebuffer() ? 1 : 0;
+    }
+    uint64_t framebuffer_elapsed = Time::get_singleton()->get_ticks_usec() - start;
+
+    double batch_frame_us = (double)batch_elapsed / (double)frames;
+    double framebuffer_frame_us = (double)framebuffer_elapsed / (double)frames;
+    result["pixels"] = pixels;
+    result["batch_frame_us"] = batch_frame_us;
+    result["batch_pixels_per_frame"] = (int64_t)(pixels * frame_budget_us / MAX(batch_frame_us, 0.001));
+    result["framebuffer_frame_us"] = framebuffer_frame_us;
+    result["framebuffer_pixels_per_frame"] = (int64_t)(pixels * frame_budget_us / MAX(framebuffer_frame_us, 0.001));
+    result["elapsed_us"] = (int64_t)(batch_elapsed + framebuffer_elapsed);
+    result["checksum"] = uploads; // One per frame
+    return result;
+}
+
+// Writes and reads back `records` fixed-size records twice: once with a
+// FileAccess call per record (what Put/Get did before files were buffered)
+// and once through VisualGasicFile's Random mode.
+Dictionary VisualGasicBenchmark::run_cpp_record_io(int64_t records, int64_t record_length) {
+    Dictionary result;
+    if (records <= 0 || record_length < 16) {
+        result["elapsed_us"] = 0;
+        result["checksum"] = 0;
+        return result;
+    }
+
+    const String direct_path = "user://bench_records_direct.dat";
+    const String buffered_path = "user://bench_records_buffered.dat";
+    std::vector<uint8_t> bytes;
+    PackedByteArray record;
+    record.resize(record_length);
+    int64_t direct_sum = 0;
+
+    uint64_t start = Time::get_singleton()->get_ticks_usec();
+    Ref<FileAccess> direct = FileAccess::open(direct_path, FileAccess::WRITE_READ);
+    if (direct.is_valid()) {
+        for (int64_t i = 0; i < records; i++) {
+            bytes.clear();
+            VisualGasicFile::encode_value(i, false, bytes);
+            VisualGasicFile::encode_value((double)i * 0.5, false, bytes);
+            memset(record.ptrw(), 0, record_length);
+            memcpy(record.ptrw(), bytes.data(), bytes.size());
+            direct->seek(i * record_length);
+            direct->store_buffer(record);
+        }
+        for (int64_t i = 0; i < records; i++) {
+            direct->seek(i * record_length);
+            PackedByteArray read = direct->get_buffer(record_length);
+            int64_t value = 0;
+            memcpy(&value, read.ptr(), sizeof(value));
+            direct_sum += value;
+        }
+        direct->close();
+    }
+    uint64_t direct_elapsed = Time::get_singleton()->get_ticks_usec() - start;
+
+    int64_t buffered_sum = 0;
+    String record_error;
+    start = Time::get_singleton()->get_ticks_usec();
+    Error open_error = OK;
+    VisualGasicFile *file = VisualGasicFile::open(buffered_path, VisualGasicFile::MODE_RANDOM, VisualGasicFile::ACCESS_DEFAULT, record_length, open_error);
+    if (file) {
+        Array fields;
+        fields.resize(2);
+        for (int64_t i = 0; i < records; i++) {
+            fields[0] = i;
+            fields[1] = (double)i * 0.5;
+            file->put_value(fields, i + 1, record_error);
+        }
+        Variant target = fields;
+        for (int64_t i = 0; i < records; i++) {
+            file->get_value(target, i + 1, record_error);
+            buffered_sum += (int64_t)((Array)target)[0];
+        }
+        memdelete(file);
+    }
+    uint64_t buffered_elapsed = Time::get_singleton()->get_ticks_usec() - start;
+
+    result["direct_us"] = (int64_t)direct_elapsed;
+    result["buffered_us"] = (int64_t)buffered_elapsed;
+    result["speedup"] = (double)direct_elapsed / (double)MAX(buffered_elapsed, (uint64_t)1);
+    result["elapsed_us"] = (int64_t)buffered_elapsed;
+    result["checksum"] = direct_sum == buffered_sum ? buffered_sum : -1;
+    return result;
+}
+
+// LoadData over a file of `values` values, 16 per line (ints, some
+// doubles and a few repeated strings), read to the end twice: the old way
+// (read the whole text, parse it into expression nodes, take each node's
+// value) and through VisualGasicDataPool, which parses as READ advances.
+// first_us is the time until the first value can be read.
+Dictionary VisualGasicBenchmark::run_cpp_data_pool(int64_t values) {
+    Dictionary result;
+    if (values <= 0) {
+        result["elapsed_us"] = 0;
+        result["checksum"] = 0;
+        return result;
+    }
+
+    const String path = "user://bench_data_pool.txt";
+    std::string text;
+    for (int64_t i = 0; i < values; i++) {
+        // The first line has no Data: the old parser adds it.
+        if (i % 16 != 0) {
+            text += ", ";
+        } else if (i > 0) {
+            text += "Data ";
+        }
+        if (i % 8 == 3) {
+            text += std::to_string(i) + ".5";
+        } else if (i % 8 == 7) {
+            text += "\"tile" + std::to_string(i % 32) + "\"";
+        } else {
+            text += std::to_string(i);
+        }
+        if (i % 16 == 15) text += "\n";
+    }
+    Ref<FileAccess> writer = FileAccess::open(path, FileAccess::WRITE);
+    if (writer.is_null()) {
+        result["elapsed_us"] = 0;
+        result["checksum"] = -1;
+        return result;
+    }
+    writer->store_string(String::utf8(text.data(), (int64_t)text.size()));
+    writer->close();
+    text = std::string();
+
+    int64_t legacy_sum = 0;
+    uint64_t start = Time::get_singleton()->get_ticks_usec();
+    int64_t legacy_bytes = 0;
+    uint64_t legacy_first = 0;
+    {
+        Ref<FileAccess> reader = FileAccess::open(path, FileAccess::READ);
+        String content = reader->get_as_text();
+        reader->close();
+        ASTArena arena;
+        Vector<ExpressionNode *> nodes = VisualGasicParser::parse_data_values_from_text(content, arena);
+        legacy_first = Time::get_singleton()->get_ticks_usec() - start;
+        legacy_bytes = (int64_t)arena.get_bytes_allocated() + nodes.size() * (int64_t)sizeof(ExpressionNode *);
+        for (int i = 0; i < nodes.size(); i++) {
+            if (nodes[i]->type == ExpressionNode::LITERAL) {
+                const Variant &value = static_cast<LiteralNode *>(nodes[i])->value;
+                if (value.get_type() == Variant::INT) legacy_sum += (int64_t)value;
+            }
+        }
+    }
+    uint64_t legacy_elapsed = Time::get_singleton()->get_ticks_usec() - start;
+
+    int64_t pool_sum = 0;
+    start = Time::get_singleton()->get_ticks_usec();
+    VisualGasicDataPool pool;
+    pool.add_file(path);
+    pool.ensure(0);
+    uint64_t pool_first = Time::get_singleton()->get_ticks_usec() - start;
+    for (int64_t i = 0; pool.ensure(i); i++) {
+        if (pool.get_kind(i) == VisualGasicDataPool::KIND_INT) {
+            pool_sum += (int64_t)pool.get_value(i);
+        }
+    }
+    uint64_t pool_elapsed = Time::get_singleton()->get_ticks_usec() - start;
+    int64_t pool_bytes = pool.get_memory_usage();
+
+    result["legacy_first_us"] = (int64_t)legacy_first;
+    result["legacy_us"] = (int64_t)legacy_elapsed;
+    result["legacy_bytes"] = legacy_bytes;
+    result["pool_first_us"] = (int64_t)pool_first;
+    result["pool_us"] = (int64_t)pool_elapsed;
+    result["pool_bytes"] = pool_bytes;
+    result["elapsed_us"] = (int64_t)pool_elapsed;
+    result["checksum"] = legacy_sum == pool_sum ? pool_sum : -1;
+    return result;
+}
@@ -23,6 +23,13 @@ public:
     Dictionary run_cpp_allocations(int64_t iterations, int64_t size);
     Dictionary run_cpp_allocations_fast(int64_t iterations, int64_t size);
     Dictionary run_cpp_file_io(int64_t iterations, int64_t size);
+    Dictionary run_cpp_global_access(int64_t iterations, int64_t inner);
+    Dictionary run_cpp_tasks(int64_t count);
+    Dictionary run_cpp_fork_join(int64_t depth, int64_t items);
+    Dictionary run_cpp_builtin_dispatch(int64_t iterations);
+    Dictionary run_cpp_draw_batch(int64_t width, int64_t height, int64_t frames);
+    Dictionary run_cpp_record_io(int64_t records, int64_t record_length);
+    Dictionary run_cpp_data_pool(int64_t values);
 };
 
 #endif // VISUAL_GASIC_BENCHMARK_H
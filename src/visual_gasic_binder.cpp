@@ -0,0 +1,619 @@
+#include "visual_gasic_binder.h"
+#include "visual_gasic_builtins.h"
+#include "visual_gasic_commands.h"
+
+#include <atomic>
+
+namespace {
+
+std::atomic<uint64_t> next_bind_generation{ 1 };
+
+} // namespace
+
+// A Sub named like a builtin or an evaluator intrinsic was never reachable
+// from an expression, so binding to it would change behaviour.
+bool VisualGasicBinder::is_intrinsic_call(const String &p_name) {
+    static const HashSet<String> names = [] {
+        HashSet<String> set;
+        for (int id = 0; id < VisualGasicBuiltins::get_expr_builtin_count(); id++) {
+            set.insert(String(VisualGasicBuiltins::get_expr_builtin_name(id)));
+        }
+        for (int i = 0; i < VisualGasicBuiltins::get_evaluator_intrinsic_count(); i++) {
+            set.insert(String(VisualGasicBuiltins::get_evaluator_intrinsic_name(i)));
+        }
+        return set;
+    }();
+    return names.has(p_name.to_lower());
+}
+
+void VisualGasicBinder::bind(ModuleNode *p_module) {
+    module = p_module;
+    if (!module) {
+        return;
+    }
+    module->slot_names.clear();
+    slot_by_name.clear();
+    sub_by_name.clear();
+    struct_by_name.clear();
+    class_by_name.clear();
+    declare_by_name.clear();
+    current_class = nullptr;
+    globals.clear();
+    locals.clear();
+
+    for (int i = 0; i < module->subs.size(); i++) {
+        String key = module->subs[i]->name.to_lower();
+        if (!sub_by_name.has(key)) {
+            sub_by_name.insert(key, i);
+        }
+    }
+    for (int i = 0; i < module->structs.size(); i++) {
+        String key = module->structs[i]->name.to_lower();
+        if (!struct_by_name.has(key)) {
+            struct_by_name.insert(key, i);
+        }
+    }
+
+    for (int i = 0; i < module->classes.size(); i++) {
+        String key = module->classes[i]->name.to_lower();
+        if (!class_by_name.has(key)) {
+            class_by_name.insert(key, i);
+        }
+    }
+    for (int i = 0; i < module->declares.size(); i++) {
+        String key = module->declares[i]->name.to_lower();
+        if (!declare_by_name.has(key)) {
+            declare_by_name.insert(key, i);
+        }
+    }
+
+    // Module scope: everything declared outside a Sub is a global, wherever
+    // it appears in the file.
+    for (int i = 0; i < module->variables.size(); i++) {
+        globals.insert(module->variables[i]->name.to_lower());
+    }
+    for (int i = 0; i < module->constants.size(); i++) {
+        globals.insert(module->constants[i]->name.to_lower());
+    }
+    for (int i = 0; i < module->enums.size(); i++) {
+        for (int v = 0; v < module->enums[i]->values.size(); v++) {
+            globals.insert(module->enums[i]->values[v].name.to_lower());
+        }
+    }
+    declaring = true;
+    walk_block(module->global_statements);
+    declaring = false;
+
+    for (int i = 0; i < module->variables.size(); i++) {
+        bind_expression(module->variables[i]->default_value);
+    }
+    for (int i = 0; i < module->constants.size(); i++) {
+        bind_expression(module->constants[i]->value);
+    }
+    walk_block(module->global_statements);
+
+    for (int i = 0; i < module->subs.size(); i++) {
+        SubDefinition *sub = module->subs[i];
+        // A Function's own name is its result variable.
+        bind_body(sub->type == SubDefinition::TYPE_FUNCTION ? sub->name : String(), sub->parameters, sub->statements);
+    }
+    for (int i = 0; i < module->properties.size(); i++) {
+        PropertyDefinition *prop = module->properties[i];
+        bind_body(prop->property_type == PropertyDefinition::PROP_GET ? prop->name : String(), prop->parameters, prop->body);
+    }
+    for (int i = 0; i < module->classes.size(); i++) {
+        bind_class(module->classes[i]);
+    }
+    locals.clear();
+
+    module->bind_generation = next_bind_generation.fetch_add(1);
+    std::shared_ptr<SlotLayout> layout = std::make_shared<SlotLayout>();
+    layout->names = module->slot_names;
+    layout->slot_by_name = slot_by_name;
+    layout->generation = module->bind_generation;
+    module->slot_layout = layout;
+}
+
+// Lays the class out (field and method indices) and binds its methods with
+// the fields in scope. Field defaults are evaluated at module scope.
+void VisualGasicBinder::bind_class(ClassDefinition *p_class) {
+    p_class->member_index.clear();
+    p_class->method_index.clear();
+    for (int i = 0; i < p_class->members.size(); i++) {
+        String key = p_class->members[i]->name.to_lower();
+        if (!p_class->member_index.has(key)) {
+            p_class->member_index.insert(key, i);
+        }
+        bind_expression(p_class->members[i]->default_value);
+    }
+    for (int i = 0; i < p_class->methods.size(); i++) {
+        String key = p_class->methods[i]->name.to_lower();
+        if (!p_class->method_index.has(key)) {
+            p_class->method_index.insert(key, i);
+        }
+    }
+
+    current_class = p_class;
+    for (int i = 0; i < p_class->methods.size(); i++) {
+        SubDefinition *method = p_class->methods[i];
+        bind_body(method->type == SubDefinition::TYPE_FUNCTION ? method->name : String(), method->parameters, method->statements);
+    }
+    current_class = nullptr;
+}
+
+int VisualGasicBinder::slot_for(const String &p_name) {
+    const int *slot = slot_by_name.getptr(p_name);
+    if (slot) {
+        return *slot;
+    }
+    int index = module->slot_names.size();
+    module->slot_names.push_back(p_name);
+    slot_by_name.insert(p_name, index);
+    return index;
+}
+
+BindKind VisualGasicBinder::variable_kind(const String &p_name) const {
+    String key = p_name.to_lower();
+    if (key == "freefile" || key == "godot") {
+        return BIND_INTRINSIC;
+    }
+    if (locals.has(key)) {
+        return BIND_LOCAL;
+    }
+    if (current_class && current_class->member_index.has(key)) {
+        return BIND_MEMBER;
+    }
+    if (globals.has(key)) {
+        return BIND_GLOBAL;
+    }
+    return BIND_EXTERNAL;
+}
+
+// Fields have no slot: the interpreter reads them from the running object.
+void VisualGasicBinder::bind_variable(const String &p_name, Binding &r_binding) {
+    r_binding.kind = variable_kind(p_name);
+    if (r_binding.kind == BIND_MEMBER) {
+        r_binding.slot = -1;
+        r_binding.index = *current_class->member_index.getptr(p_name.to_lower());
+    } else {
+        r_binding.slot = slot_for(p_name);
+        r_binding.index = -1;
+    }
+}
+
+void VisualGasicBinder::declare(const String &p_name) {
+    if (!declaring || p_name.is_empty()) {
+        return;
+    }
+    if (in_sub) {
+        locals.insert(p_name.to_lower());
+    } else {
+        globals.insert(p_name.to_lower());
+    }
+}
+
+// Assigning to an undeclared name creates it, unless Option Explicit is on.
+// Assigning to a global or to a field of the enclosing Class does not.
+void VisualGasicBinder::declare_target(ExpressionNode *p_target) {
+    if (p_target && p_target->type == ExpressionNode::VARIABLE) {
+        const String &name = ((VariableNode *)p_target)->name;
+        String key = name.to_lower();
+        if (!in_sub || (!globals.has(key) && !(current_class && current_class->member_index.has(key)))) {
+            declare(name);
+        }
+    }
+}
+
+void VisualGasicBinder::bind_body(const String &p_result, const Vector<Parameter> &p_params, const Vector<Statement *> &p_body) {
+    locals.clear();
+    in_sub = true;
+    if (!p_result.is_empty()) {
+        locals.insert(p_result.to_lower());
+    }
+    for (int i = 0; i < p_params.size(); i++) {
+        locals.insert(p_params[i].name.to_lower());
+    }
+    declaring = true;
+    walk_block(p_body);
+    declaring = false;
+    walk_block(p_body);
+    in_sub = false;
+}
+
+void VisualGasicBinder::walk_block(const Vector<Statement *> &p_block) {
+    for (int i = 0; i < p_block.size(); i++) {
+        walk_statement(p_block[i]);
+    }
+}
+
+// One walk serves both passes: declare() only acts while declaring and
+// bind_expression() only while binding.
+void VisualGasicBinder::walk_statement(Statement *p_stmt) {
+    if (!p_stmt) {
+        return;
+    }
+    switch (p_stmt->type) {
+        case STMT_PRINT: {
+            PrintStatement *s = (PrintStatement *)p_stmt;
+            bind_expression(s->expression);
+            bind_expression(s->file_number);
+        } break;
+        case STMT_DIM: {
+            DimStatement *s = (DimStatement *)p_stmt;
+            declare(s->variable_name);
+            bind_expressions(s->array_sizes);
+            bind_expression(s->initializer);
+        } break;
+        case STMT_REDIM: {
+            ReDimStatement *s = (ReDimStatement *)p_stmt;
+            declare(s->variable_name);
+            bind_expressions(s->array_sizes);
+        } break;
+        case STMT_CONST: {
+            ConstStatement *s = (ConstStatement *)p_stmt;
+            declare(s->name);
+            bind_expression(s->value);
+        } break;
+        case STMT_ASSIGNMENT: {
+            AssignmentStatement *s = (AssignmentStatement *)p_stmt;
+            declare_target(s->target);
+            bind_expression(s->target);
+            bind_expression(s->value);
+        } break;
+        case STMT_IF: {
+            IfStatement *s = (IfStatement *)p_stmt;
+            bind_expression(s->condition);
+            walk_block(s->then_branch);
+            walk_block(s->else_branch);
+        } break;
+        case STMT_FOR: {
+            ForStatement *s = (ForStatement *)p_stmt;
+            declare(s->variable_name);
+            if (!declaring) {
+                s->binding.kind = variable_kind(s->variable_name);
+                s->binding.slot = slot_for(s->variable_name);
+            }
+            bind_expression(s->from_val);
+            bind_expression(s->to_val);
+            bind_expression(s->step_val);
+            walk_block(s->body);
+        } break;
+        case STMT_WHILE: {
+            WhileStatement *s = (WhileStatement *)p_stmt;
+            bind_expression(s->condition);
+            walk_block(s->body);
+        } break;
+        case STMT_DO: {
+            DoStatement *s = (DoStatement *)p_stmt;
+            bind_expression(s->condition);
+            walk_block(s->body);
+        } break;
+        case STMT_FOR_EACH: {
+            ForEachStatement *s = (ForEachStatement *)p_stmt;
+            declare(s->variable_name);
+            bind_expression(s->collection);
+            walk_block(s->body);
+        } break;
+        case STMT_WITH: {
+            WithStatement *s = (WithStatement *)p_stmt;
+            bind_expression(s->expression);
+            walk_block(s->body);
+        } break;
+        case STMT_CALL: {
+            CallStatement *s = (CallStatement *)p_stmt;
+            bind_expression(s->base_object);
+            bind_expressions(s->arguments);
+            if (!declaring) {
+                s->binding = Binding();
+                s->class_cache = ClassSiteCache();
+                String key = s->method_name.to_lower();
+                const int *method = current_class && !s->base_object ? current_class->method_index.getptr(key) : nullptr;
+                const int *declared = s->base_object ? nullptr : declare_by_name.getptr(key);
+                const int *sub = s->base_object ? nullptr : sub_by_name.getptr(key);
+                int command = s->base_object ? -1 : VisualGasicCommands::find_command_id(key);
+                if (method) {
+                    s->binding.kind = BIND_METHOD;
+                    s->binding.index = *method;
+                } else if (declared) {
+                    s->binding.kind = BIND_DECLARE;
+                    s->binding.index = *declared;
+                } else if (sub) {
+                    // User Subs shadow the interpreter's commands.
+                    s->binding.kind = BIND_SUB;
+                    s->binding.index = *sub;
+                } else if (command >= 0) {
+                    s->binding.kind = BIND_COMMAND;
+                    s->binding.index = command;
+                }
+            }
+        } break;
+        case STMT_SELECT: {
+            SelectStatement *s = (SelectStatement *)p_stmt;
+            bind_expression(s->expression);
+            for (int i = 0; i < s->cases.size(); i++) {
+                if (s->cases[i]) {
+                    bind_expressions(s->cases[i]->values);
+                    walk_block(s->cases[i]->body);
+                }
+            }
+        } break;
+        case STMT_OPEN: {
+            OpenStatement *s = (OpenStatement *)p_stmt;
+            bind_expression(s->path);
+            bind_expression(s->file_number);
+            bind_expression(s->record_length);
+        } break;
+        case STMT_CLOSE:
+            bind_expression(((CloseStatement *)p_stmt)->file_number);
+            break;
+        case STMT_INPUT: {
+            InputStatement *s = (InputStatement *)p_stmt;
+            bind_expression(s->file_number);
+            for (int i = 0; i < s->variables.size(); i++) {
+                declare_target(s->variables[i]);
+            }
+            bind_expressions(s->variables);
+        } break;
+        case STMT_READ: {
+            ReadStatement *s = (ReadStatement *)p_stmt;
+            for (int i = 0; i < s->targets.size(); i++) {
+                declare_target(s->targets[i]);
+            }
+            bind_expressions(s->targets);
+        } break;
+        case STMT_DATA:
+            bind_expressions(((DataStatement *)p_stmt)->values);
+            break;
+        case STMT_RETURN:
+            bind_expression(((ReturnStatement *)p_stmt)->return_value);
+            break;
+        case STMT_RAISE_EVENT:
+            bind_expressions(((RaiseEventStatement *)p_stmt)->arguments);
+            break;
+        case STMT_LOAD_DATA:
+            bind_expression(((LoadDataStatement *)p_stmt)->path_expression);
+            break;
+        case STMT_SEEK: {
+            SeekStatement *s = (SeekStatement *)p_stmt;
+            bind_expression(s->file_number);
+            bind_expression(s->position);
+        } break;
+        case STMT_FILE_RECORD: {
+            FileRecordStatement *s = (FileRecordStatement *)p_stmt;
+            bind_expression(s->file_number);
+            bind_expression(s->position);
+            if (!s->is_put) {
+                declare_target(s->variable);
+            }
+            bind_expression(s->variable);
+        } break;
+        case STMT_KILL:
+            bind_expression(((KillStatement *)p_stmt)->path);
+            break;
+        case STMT_NAME: {
+            NameStatement *s = (NameStatement *)p_stmt;
+            bind_expression(s->old_path);
+            bind_expression(s->new_path);
+        } break;
+        case STMT_TRY: {
+            TryStatement *s = (TryStatement *)p_stmt;
+            declare(s->catch_var_name);
+            walk_block(s->try_block);
+            walk_block(s->catch_block);
+            walk_block(s->finally_block);
+        } break;
+        case STMT_RAISE: {
+            RaiseStatement *s = (RaiseStatement *)p_stmt;
+            bind_expression(s->code);
+            bind_expression(s->msg);
+        } break;
+        case STMT_WHENEVER_SECTION: {
+            WheneverSectionStatement *s = (WheneverSectionStatement *)p_stmt;
+            bind_expression(s->comparison_value);
+            bind_expression(s->comparison_value2);
+            bind_expression(s->condition_expression);
+        } break;
+        case STMT_ASYNC_FUNCTION: {
+            AsyncFunctionStatement *s = (AsyncFunctionStatement *)p_stmt;
+            for (int i = 0; i < s->parameters.size(); i++) {
+                if (s->parameters[i]) {
+                    declare(s->parameters[i]->name);
+                }
+            }
+            walk_block(s->body);
+        } break;
+        case STMT_TASK_RUN:
+            walk_block(((TaskRunStatement *)p_stmt)->task_body);
+            break;
+        case STMT_PARALLEL_FOR: {
+            ParallelForStatement *s = (ParallelForStatement *)p_stmt;
+            declare(s->variable_name);
+            bind_expression(s->start_expr);
+            bind_expression(s->end_expr);
+            bind_expression(s->step_expr);
+            walk_block(s->body);
+        } break;
+        case STMT_PARALLEL_SECTION:
+            walk_block(((ParallelSectionStatement *)p_stmt)->section_body);
+            break;
+        case STMT_PATTERN_MATCH: {
+            PatternMatchStatement *s = (PatternMatchStatement *)p_stmt;
+            bind_expression(s->expression);
+            for (int i = 0; i < s->cases.size(); i++) {
+                if (s->cases[i]) {
+                    walk_pattern(s->cases[i]->pattern);
+                    walk_block(s->cases[i]->statements);
+                }
+            }
+        } break;
+        default:
+            break;
+    }
+}
+
+void VisualGasicBinder::walk_pattern(Pattern *p_pattern) {
+    if (!p_pattern) {
+        return;
+    }
+    declare(p_pattern->variable_name);
+    bind_expression(p_pattern->guard_expression);
+    for (int i = 0; i < p_pattern->sub_patterns.size(); i++) {
+        walk_pattern(p_pattern->sub_patterns[i]);
+    }
+}
+
+void VisualGasicBinder::bind_expressions(const Vector<ExpressionNode *> &p_exprs) {
+    for (int i = 0; i < p_exprs.size(); i++) {
+        bind_expression(p_exprs[i]);
+    }
+}
+
+void VisualGasicBinder::bind_expression(ExpressionNode *p_expr) {
+    if (declaring || !p_expr) {
+        return;
+    }
+    switch (p_expr->type) {
+        case ExpressionNode::VARIABLE: {
+            VariableNode *v = (VariableNode *)p_expr;
+            bind_variable(v->name, v->binding);
+        } break;
+        case ExpressionNode::EXPRESSION_CALL: {
+            CallExpression *c = (CallExpression *)p_expr;
+            bind_expression(c->base_object);
+            bind_expressions(c->arguments);
+            c->binding = Binding();
+            c->class_cache = ClassSiteCache();
+            if (c->base_object) {
+                break;
+            }
+            // A Declare names a native function explicitly, so it wins over
+            // builtins of the same name.
+            const int *declared = declare_by_name.getptr(c->method_name.to_lower());
+            if (declared && !locals.has(c->method_name.to_lower())) {
+                c->binding.kind = BIND_DECLARE;
+                c->binding.index = *declared;
+                break;
+            }
+            if (is_intrinsic_call(c->method_name)) {
+                c->binding.kind = BIND_INTRINSIC;
+                break;
+            }
+            // Methods and (indexed) fields of the enclosing Class come
+            // before module Subs.
+            if (current_class && !locals.has(c->method_name.to_lower())) {
+                const int *method = current_class->method_index.getptr(c->method_name.to_lower());
+                if (method) {
+                    c->binding.kind = BIND_METHOD;
+                    c->binding.index = *method;
+                    break;
+                }
+                if (variable_kind(c->method_name) == BIND_MEMBER) {
+                    bind_variable(c->method_name, c->binding);
+                    break;
+                }
+            }
+            // The slot is kept for Subs too: a variable of the same name
+            // holding an array is indexed instead of calling the Sub.
+            c->binding.slot = slot_for(c->method_name);
+            const int *sub = sub_by_name.getptr(c->method_name.to_lower());
+            if (sub) {
+                c->binding.kind = BIND_SUB;
+                c->binding.index = *sub;
+            } else {
+                c->binding.kind = variable_kind(c->method_name);
+            }
+        } break;
+        case ExpressionNode::NEW: {
+            NewNode *n = (NewNode *)p_expr;
+            bind_expressions(n->args);
+            n->binding = Binding();
+            String key = n->class_name.to_lower();
+            const int *def = struct_by_name.getptr(key);
+            const int *cls = class_by_name.getptr(key);
+            if (key == "memoryblock" || key == "dictionary") {
+                n->binding.kind = BIND_INTRINSIC;
+            } else if (cls) {
+                n->binding.kind = BIND_CLASS;
+                n->binding.index = *cls;
+            } else if (def) {
+                n->binding.kind = BIND_STRUCT;
+                n->binding.index = *def;
+            } else {
+                n->binding.kind = BIND_EXTERNAL;
+            }
+        } break;
+        case ExpressionNode::BINARY_OP: {
+            BinaryOpNode *b = (BinaryOpNode *)p_expr;
+            bind_expression(b->left);
+            bind_expression(b->right);
+        } break;
+        case ExpressionNode::UNARY_OP:
+            bind_expression(((UnaryOpNode *)p_expr)->operand);
+            break;
+        case ExpressionNode::MEMBER_ACCESS: {
+            MemberAccessNode *m = (MemberAccessNode *)p_expr;
+            m->class_cache = ClassSiteCache();
+            bind_expression(m->base_object);
+        } break;
+        case ExpressionNode::ARRAY_ACCESS: {
+            ArrayAccessNode *a = (ArrayAccessNode *)p_expr;
+            bind_expression(a->base);
+            bind_expressions(a->indices);
+        } break;
+        case ExpressionNode::EXPRESSION_IIF: {
+            IIfNode *n = (IIfNode *)p_expr;
+            bind_expression(n->condition);
+            bind_expression(n->true_part);
+            bind_expression(n->false_part);
+        } break;
+        case ExpressionNode::OPTIONAL_ACCESS:
+            bind_expression(((OptionalAccessExpression *)p_expr)->object_expression);
+            break;
+        case ExpressionNode::TYPE_CHECK:
+            bind_expression(((TypeCheckExpression *)p_expr)->expression);
+            break;
+        default:
+            break;
+    }
+}
+
+bool VisualGasicBinder::collect_reads(const ExpressionNode *p_expr, Vector<String> &r_names) {
+    if (!p_expr) {
+        return true;
+    }
+    switch (p_expr->type) {
+        case ExpressionNode::LITERAL:
+            return true;
+        case ExpressionNode::VARIABLE:
+            r_names.push_back(((const VariableNode *)p_expr)->name);
+            return true;
+        case ExpressionNode::EXPRESSION_CALL: {
+            const CallExpression *c = (const CallExpression *)p_expr;
+            if (c->base_object || !is_intrinsic_call(c->method_name)) {
+                return false;
+            }
+            bool complete = true;
+            for (int i = 0; i < c->arguments.size(); i++) {
+                complete = collect_reads(c->arguments[i], r_names) && complete;
+            }
+            return complete;
+        }
+        case ExpressionNode::BINARY_OP: {
+            const BinaryOpNode *b = (const BinaryOpNode *)p_expr;
+            bool complete = collect_reads(b->left, r_names);
+            return collect_reads(b->right, r_names) && complete;
+        }
+        case ExpressionNode::UNARY_OP:
+            return collect_reads(((const UnaryOpNode *)p_expr)->operand, r_names);
+        case ExpressionNode::EXPRESSION_IIF: {
+            const IIfNode *n = (const IIfNode *)p_expr;
+            bool complete = collect_reads(n->condition, r_names);
+            complete = collect_reads(n->true_part, r_names) && complete;
+            return collect_reads(n->false_part, r_names) && complete;
+        }
+        case ExpressionNode::TYPE_CHECK:
+            return collect_reads(((const TypeCheckExpression *)p_expr)->expression, r_names);
+        default:
+            return false;
+    }
+}
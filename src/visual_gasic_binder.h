@@ -0,0 +1,69 @@
+#ifndef VISUAL_GASIC_BINDER_H
+#define VISUAL_GASIC_BINDER_H
+
+// Name resolution pass, run on a module right after it is parsed.
+// It fills in the Binding of every VariableNode, CallExpression and NewNode
+// so the AST interpreter does not look names up on each evaluation:
+// variable names get an index into ModuleNode::slot_names (and its
+// ModuleNode::slot_layout, which every instance's GlobalSlotTable starts
+// from, so the index is the slot), calls and New get
+// the Sub, Type, Class or Declare they name, and statement calls to no Sub
+// get the interpreter command they name. Inside a Class method, the
+// Class's fields and methods bind to their index in its layout (BIND_MEMBER,
+// BIND_METHOD) instead of a slot. Locals and globals share one slot table in
+// this interpreter, so BIND_LOCAL and BIND_GLOBAL only record where a name
+// was declared; the slot is still read before any fallback, which keeps
+// variables created at run time (implicit Dims, the REPL) visible.
+
+#include "visual_gasic_ast.h"
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/hash_set.hpp>
+
+using namespace VisualGasic;
+using namespace godot;
+
+class VisualGasicBinder {
+public:
+    // Binds every node reachable from p_module and gives it a new
+    // bind_generation. Nodes reused from an earlier parse are bound again,
+    // since Sub indices and the slot layout may have changed.
+    void bind(ModuleNode *p_module);
+
+    // Names the interpreter handles before user Subs (builtins and the
+    // expression call chain); calls to them are never bound to a Sub.
+    static bool is_intrinsic_call(const String &p_name);
+
+    // Appends the names of the variables p_expr reads to r_names. Returns
+    // false if it may also read state no variable write reflects: user
+    // Function calls, array elements, methods and members of objects.
+    static bool collect_reads(const ExpressionNode *p_expr, Vector<String> &r_names);
+
+private:
+    ModuleNode *module = nullptr;
+    bool declaring = false; // First walk of a body only records declarations
+    bool in_sub = false;
+    HashMap<String, int> slot_by_name; // Exact name -> index in slot_names
+    HashMap<String, int> sub_by_name;  // Lower-case name -> first Sub with it
+    HashMap<String, int> struct_by_name;
+    HashMap<String, int> class_by_name;
+    HashMap<String, int> declare_by_name;
+    const ClassDefinition *current_class = nullptr; // While binding its methods
+    HashSet<String> globals; // Lower-case
+    HashSet<String> locals;  // Lower-case, current Sub only
+
+    int slot_for(const String &p_name);
+    BindKind variable_kind(const String &p_name) const;
+    void bind_variable(const String &p_name, Binding &r_binding);
+    void bind_class(ClassDefinition *p_class);
+    void declare(const String &p_name);
+    void declare_target(ExpressionNode *p_target);
+
+    void bind_body(const String &p_result, const Vector<Parameter> &p_params, const Vector<Statement *> &p_body);
+    void walk_block(const Vector<Statement *> &p_block);
+    void walk_statement(Statement *p_stmt);
+    void walk_pattern(Pattern *p_pattern);
+    void bind_expressions(const Vector<ExpressionNode *> &p_exprs);
+    void bind_expression(ExpressionNode *p_expr);
+};
+
+#endif // VISUAL_GASIC_BINDER_H
@@ -1,4 +1,5 @@
 #include "visual_gasic_builtins.h"
+#include "visual_gasic_commands.h"
 #include <godot_cpp/classes/json.hpp>
 #include <godot_cpp/classes/file_access.hpp>
 #include <godot_cpp/classes/dir_access.hpp>
@@ -20,6 +21,8 @@
 #include <godot_cpp/classes/tree.hpp>
 #include <godot_cpp/classes/tree_item.hpp>
 #include <godot_cpp/variant/packed_int64_array.hpp>
+#include <climits>
+#include <cstring>
 
 using namespace godot;
 
@@ -47,989 +50,1034 @@ static String variant_to_cstr(const Variant &src) {
 
 Variant call_builtin_expr_evaluated(VisualGasicInstance *instance, const String &p_method, const Array &p_args, bool &r_handled);
 
-bool call_builtin(VisualGasicInstance *instance, const String &p_method, const Array &p_args, Variant &r_ret, bool &r_found) {
-    VG_PROFILE_CATEGORY("builtin_call", "builtins");
-    VG_COUNT("builtin.function_calls");
-    
-    r_found = false;
-    r_ret = Variant();
+// ---------------------------------------------------------------------------
+// Builtin table (OP_CALL_BUILTIN)
+// ---------------------------------------------------------------------------
+// Each entry mirrors the name-matched implementation in
+// call_builtin_expr_evaluated / call_builtin_expr exactly.
 
-    if (!instance) return false;
-
-    String method = p_method;
-
-    // Minimal set implemented here; the rest can be added as needed.
-    if (method.nocasecmp_to("MsgBox") == 0) {
-        r_found = true;
-        if (!instance->get_owner()) return true;
-        Node *root = Object::cast_to<Node>(instance->get_owner());
-        if (!root) return true;
-
-        String msg = "";
-        if (p_args.size() > 0) msg = String(p_args[0]);
-        int buttons = 0;
-        if (p_args.size() > 1) buttons = (int)p_args[1];
-        String title = "VisualGasic";
-        if (p_args.size() > 2) title = String(p_args[2]);
-
-        AcceptDialog *dlg = memnew(AcceptDialog);
-        dlg->set_title(title);
-        dlg->set_text(msg);
-        root->add_child(dlg);
-        dlg->popup_centered();
-
-        // Blocking modal loop (not ideal, but mirrors previous behavior)
-        while (dlg->is_visible() && dlg->is_inside_tree()) {
-            DisplayServer::get_singleton()->process_events();
-            OS::get_singleton()->delay_msec(10);
-        }
-        dlg->queue_free();
-        return true;
-    }
-
-    if (method.nocasecmp_to("InputBox") == 0) {
-        r_found = true;
-        if (!instance->get_owner()) return true;
-        Node *root = Object::cast_to<Node>(instance->get_owner());
-        if (!root) return true;
-
-        String prompt = "";
-        if (p_args.size() > 0) prompt = String(p_args[0]);
-        String title = "VisualGasic";
-        if (p_args.size() > 1) title = String(p_args[1]);
-        String def = "";
-        if (p_args.size() > 2) def = String(p_args[2]);
-
-        AcceptDialog *dialog = memnew(AcceptDialog);
-        dialog->set_title(title);
-        VBoxContainer *vbox = memnew(VBoxContainer);
-        Label *lbl = memnew(Label);
-        lbl->set_text(prompt);
-        vbox->add_child(lbl);
-        LineEdit *le = memnew(LineEdit);
-        le->set_text(def);
-        vbox->add_child(le);
-        dialog->add_child(vbox);
-        root->add_child(dialog);
-        dialog->popup_centered();
-        le->grab_focus();
-
-        while (dialog->is_visible() && dialog->is_inside_tree()) {
-            DisplayServer::get_singleton()->process_events();
-            OS::get_singleton()->delay_msec(10);
-        }
+static constexpr int BUILTIN_MAX_ARGS = 3;
 
-        String result = "";
-        // No reliable meta-setting here; assume accepted if not visible
-        result = le->get_text();
-        dialog->queue_free();
-        r_ret = result;
-        return true;
-    }
+static Variant bi_len(VisualGasicInstance *, const Variant *a, int) { return String(a[0]).length(); }
+static Variant bi_left(VisualGasicInstance *, const Variant *a, int) { return String(a[0]).left((int)a[1]); }
+static Variant bi_right(VisualGasicInstance *, const Variant *a, int) { return String(a[0]).right((int)a[1]); }
+static Variant bi_mid(VisualGasicInstance *, const Variant *a, int argc) {
+    String s = String(a[0]);
+    int start = (int)a[1] - 1;
+    if (start < 0) start = 0;
+    if (argc == 3) return s.substr(start, (int)a[2]);
+    return s.substr(start);
+}
+static Variant bi_ucase(VisualGasicInstance *, const Variant *a, int) { return String(a[0]).to_upper(); }
+static Variant bi_lcase(VisualGasicInstance *, const Variant *a, int) { return String(a[0]).to_lower(); }
+static Variant bi_asc(VisualGasicInstance *, const Variant *a, int) { String s = a[0]; if (s.length() > 0) return (int)s.unicode_at(0); return 0; }
+static Variant bi_chr(VisualGasicInstance *, const Variant *a, int) { return String::chr((int)a[0]); }
+static Variant bi_space(VisualGasicInstance *, const Variant *a, int) {
+    int n = (int)a[0];
+    return n > 0 ? String(" ").repeat(n) : String();
+}
+static Variant bi_string(VisualGasicInstance *, const Variant *a, int) {
+    int n = (int)a[0];
+    String char_str = String(a[1]);
+    if (n <= 0 || char_str.length() == 0) return String();
+    return char_str.substr(0, 1).repeat(n);
+}
+static Variant bi_str(VisualGasicInstance *, const Variant *a, int) { return a[0].stringify(); }
+static Variant bi_cstr(VisualGasicInstance *, const Variant *a, int) { return variant_to_cstr(a[0]); }
+static Variant bi_val(VisualGasicInstance *, const Variant *a, int) { String s = a[0]; if (s.is_valid_float()) return s.to_float(); if (s.is_valid_int()) return s.to_int(); return 0.0; }
+static Variant bi_instr(VisualGasicInstance *, const Variant *a, int) { String s1 = a[0]; String s2 = a[1]; int pos = s1.find(s2); if (pos == -1) return 0; return pos + 1; }
+static Variant bi_replace(VisualGasicInstance *, const Variant *a, int) { return String(a[0]).replace(String(a[1]), String(a[2])); }
+static Variant bi_trim(VisualGasicInstance *, const Variant *a, int) { return String(a[0]).strip_edges(); }
+static Variant bi_ltrim(VisualGasicInstance *, const Variant *a, int) { return String(a[0]).strip_edges(true, false); }
+static Variant bi_rtrim(VisualGasicInstance *, const Variant *a, int) { return String(a[0]).strip_edges(false, true); }
+static Variant bi_strreverse(VisualGasicInstance *, const Variant *a, int) { String s = a[0]; String res; for (int i = s.length() - 1; i >= 0; i--) res += s[i]; return res; }
+static Variant bi_hex(VisualGasicInstance *, const Variant *a, int) { return String::num_int64((int64_t)a[0], 16).to_upper(); }
+static Variant bi_oct(VisualGasicInstance *, const Variant *a, int) { return String::num_int64((int64_t)a[0], 8); }
 
-    // Fallback: not handled here
-    return false;
+static Variant bi_sin(VisualGasicInstance *, const Variant *a, int) { return UtilityFunctions::sin(a[0]); }
+static Variant bi_cos(VisualGasicInstance *, const Variant *a, int) { return UtilityFunctions::cos(a[0]); }
+static Variant bi_tan(VisualGasicInstance *, const Variant *a, int) { return UtilityFunctions::tan(a[0]); }
+static Variant bi_log(VisualGasicInstance *, const Variant *a, int) { return UtilityFunctions::log(a[0]); }
+static Variant bi_exp(VisualGasicInstance *, const Variant *a, int) { return UtilityFunctions::exp(a[0]); }
+static Variant bi_atn(VisualGasicInstance *, const Variant *a, int) { return UtilityFunctions::atan(a[0]); }
+static Variant bi_sqr(VisualGasicInstance *, const Variant *a, int) { return UtilityFunctions::sqrt(a[0]); }
+static Variant bi_abs(VisualGasicInstance *, const Variant *a, int) {
+    if (a[0].get_type() == Variant::INT) { int64_t v = (int64_t)a[0]; return v < 0 ? -v : v; }
+    return UtilityFunctions::abs(a[0]);
+}
+static Variant bi_sgn(VisualGasicInstance *, const Variant *a, int) { double d = (double)a[0]; if (d > 0) return (int64_t)1; if (d < 0) return (int64_t)-1; return (int64_t)0; }
+static Variant bi_int(VisualGasicInstance *, const Variant *a, int) { if (a[0].get_type() == Variant::INT) return (int64_t)a[0]; return UtilityFunctions::floor(a[0]); }
+static Variant bi_rnd(VisualGasicInstance *, const Variant *, int) { return UtilityFunctions::randf(); }
+static Variant bi_fix(VisualGasicInstance *, const Variant *a, int) { double v = (double)a[0]; return v < 0 ? ceil(v) : floor(v); }
+static Variant bi_round(VisualGasicInstance *, const Variant *a, int argc) {
+    double val = (double)a[0];
+    if (argc > 1) {
+        int digits = (int)a[1];
+        double step = pow(10.0, -digits);
+        return Math::snapped(val, step);
+    }
+    return round(val);
+}
+static Variant bi_randrange(VisualGasicInstance *, const Variant *a, int) {
+    float min = (float)a[0];
+    float max = (float)a[1];
+    return min + UtilityFunctions::randf() * (max - min);
+}
+static Variant bi_cint(VisualGasicInstance *, const Variant *a, int) { return (int64_t)llround((double)a[0]); }
+static Variant bi_clng(VisualGasicInstance *, const Variant *a, int) { return (int64_t)llround((double)a[0]); }
+static Variant bi_csng(VisualGasicInstance *, const Variant *a, int) { return (double)a[0]; }
+static Variant bi_cdbl(VisualGasicInstance *, const Variant *a, int) { return (double)a[0]; }
+static Variant bi_cbool(VisualGasicInstance *, const Variant *a, int) { return (bool)a[0]; }
+static Variant bi_lerp(VisualGasicInstance *, const Variant *a, int) { double x = a[0]; double y = a[1]; double t = a[2]; return Math::lerp(x, y, t); }
+static Variant bi_clamp(VisualGasicInstance *, const Variant *a, int) { double val = a[0]; double mn = a[1]; double mx = a[2]; return Math::clamp(val, mn, mx); }
+static Variant bi_startswith(VisualGasicInstance *, const Variant *a, int) { return String(a[0]).begins_with(String(a[1])); }
+static Variant bi_endswith(VisualGasicInstance *, const Variant *a, int) { return String(a[0]).ends_with(String(a[1])); }
+static Variant bi_padleft(VisualGasicInstance *, const Variant *a, int argc) {
+    String text = String(a[0]);
+    int length = int(a[1]);
+    String pad_char = argc == 3 ? String(a[2]) : String(" ");
+    if (pad_char.length() > 0 && text.length() < length) {
+        text = pad_char.substr(0, 1).repeat(length - text.length()) + text;
+    }
+    return text;
+}
+static Variant bi_padright(VisualGasicInstance *, const Variant *a, int argc) {
+    String text = String(a[0]);
+    int length = int(a[1]);
+    String pad_char = argc == 3 ? String(a[2]) : String(" ");
+    if (pad_char.length() > 0 && text.length() < length) {
+        text = text + pad_char.substr(0, 1).repeat(length - text.length());
+    }
+    return text;
 }
 
-Variant call_builtin_expr(VisualGasicInstance *instance, CallExpression *call, bool &r_handled) {
-    r_handled = false;
-    Variant ret;
-    if (!call) return Variant();
+// Append only: the index is the ID baked into compiled bytecode.
+static const BuiltinInfo builtin_table[] = {
+    {"len", 1, 1, bi_len},
+    {"left", 2, 2, bi_left},
+    {"right", 2, 2, bi_right},
+    {"mid", 2, 3, bi_mid},
+    {"ucase", 1, 1, bi_ucase},
+    {"lcase", 1, 1, bi_lcase},
+    {"asc", 1, 1, bi_asc},
+    {"chr", 1, 1, bi_chr},
+    {"space", 1, 1, bi_space},
+    {"string", 2, 2, bi_string},
+    {"str", 1, 1, bi_str},
+    {"cstr", 1, 1, bi_cstr},
+    {"val", 1, 1, bi_val},
+    {"instr", 2, 2, bi_instr},
+    {"replace", 3, 3, bi_replace},
+    {"trim", 1, 1, bi_trim},
+    {"ltrim", 1, 1, bi_ltrim},
+    {"rtrim", 1, 1, bi_rtrim},
+    {"strreverse", 1, 1, bi_strreverse},
+    {"hex", 1, 1, bi_hex},
+    {"oct", 1, 1, bi_oct},
+    {"sin", 1, 1, bi_sin},
+    {"cos", 1, 1, bi_cos},
+    {"tan", 1, 1, bi_tan},
+    {"log", 1, 1, bi_log},
+    {"exp", 1, 1, bi_exp},
+    {"atn", 1, 1, bi_atn},
+    {"sqr", 1, 1, bi_sqr},
+    {"abs", 1, 1, bi_abs},
+    {"sgn", 1, 1, bi_sgn},
+    {"int", 1, 1, bi_int},
+    {"rnd", 0, 1, bi_rnd},
+    {"fix", 1, 1, bi_fix},
+    {"round", 1, 2, bi_round},
+    {"randrange", 2, 2, bi_randrange},
+    {"cint", 1, 1, bi_cint},
+    {"clng", 1, 1, bi_clng},
+    {"csng", 1, 1, bi_csng},
+    {"cdbl", 1, 1, bi_cdbl},
+    {"cbool", 1, 1, bi_cbool},
+    {"lerp", 3, 3, bi_lerp},
+    {"clamp", 3, 3, bi_clamp},
+    {"startswith", 2, 2, bi_startswith},
+    {"endswith", 2, 2, bi_endswith},
+    {"padleft", 2, 3, bi_padleft},
+    {"padright", 2, 3, bi_padright},
+};
+static constexpr int builtin_table_size = sizeof(builtin_table) / sizeof(builtin_table[0]);
 
-    // Evaluate call arguments using the instance evaluator
-    Array args;
-    for (int i = 0; i < call->arguments.size(); i++) {
-        args.push_back(instance->evaluate_expression_for_builtins(call->arguments[i]));
+// Case-insensitive FNV-1a; the seed is chosen so the table has no collisions.
+template <typename CharT>
+static uint32_t builtin_name_hash(const CharT *p_chars, int p_len, uint32_t p_seed) {
+    uint32_t h = 2166136261u ^ p_seed;
+    for (int i = 0; i < p_len; i++) {
+        uint32_t c = (uint32_t)p_chars[i];
+        if (c >= 'A' && c <= 'Z') {
+            c += 'a' - 'A';
+        }
+        h ^= c;
+        h *= 16777619u;
     }
+    return h;
+}
+
+struct BuiltinLookup {
+    uint32_t seed = 0;
+    uint32_t mask = 0;
+    Vector<int16_t> slots;
+};
 
-    String name = call->method_name;
-    String lowercase_name = name.to_lower();
-    const StringName method_key = StringName(lowercase_name);
-#define METHOD_IS(literal) (method_key == StringName(literal))
-
-    {
-        bool handled_eval = false;
-        Variant eval_res = call_builtin_expr_evaluated(instance, name, args, handled_eval);
-        if (handled_eval) {
-            r_handled = true;
-            return eval_res;
+// Perfect hash over a builtin table: one probe, one name compare per lookup.
+template <typename Entry>
+static BuiltinLookup build_builtin_lookup(const Entry *p_table, int p_count) {
+    BuiltinLookup lookup;
+    uint32_t size = 64;
+    while (size < (uint32_t)p_count * 2) {
+        size <<= 1;
+    }
+    for (;;) {
+        lookup.mask = size - 1;
+        lookup.slots.resize(size);
+        for (uint32_t seed = 1; seed < 4096; seed++) {
+            lookup.slots.fill(-1);
+            bool collision = false;
+            for (int i = 0; i < p_count && !collision; i++) {
+                const char *name = p_table[i].name;
+                uint32_t slot = builtin_name_hash(name, (int)strlen(name), seed) & lookup.mask;
+                if (lookup.slots[slot] >= 0) {
+                    collision = true;
+                } else {
+                    lookup.slots.write[slot] = (int16_t)i;
+                }
+            }
+            if (!collision) {
+                lookup.seed = seed;
+                return lookup;
+            }
         }
+        size <<= 1;
     }
+}
 
-    // String Library
-    if (name == "Len" && args.size() == 1) {
-        r_handled = true;
-        return String(args[0]).length();
-    }
-    if (name == "Left" && args.size() == 2) {
-        r_handled = true;
-        return String(args[0]).left((int)args[1]);
-    }
-    if (name == "Right" && args.size() == 2) {
-        r_handled = true;
-        return String(args[0]).right((int)args[1]);
+// Index of p_name (case-insensitive) in p_table, or -1.
+template <typename Entry>
+static int lookup_builtin(const BuiltinLookup &p_lookup, const Entry *p_table, const String &p_name) {
+    int len = p_name.length();
+    if (len == 0) {
+        return -1;
     }
-    if (name == "Mid" && args.size() >= 2) {
-        r_handled = true;
-        String s = String(args[0]);
-        int start = (int)args[1] - 1;
-        if (start < 0) start = 0;
-        if (args.size() == 3) return s.substr(start, (int)args[2]);
-        return s.substr(start);
+    const char32_t *chars = p_name.ptr();
+    int id = p_lookup.slots[builtin_name_hash(chars, len, p_lookup.seed) & p_lookup.mask];
+    if (id < 0) {
+        return -1;
     }
-    if (name == "UCase" && args.size() == 1) { r_handled = true; return String(args[0]).to_upper(); }
-    if (name == "LCase" && args.size() == 1) { r_handled = true; return String(args[0]).to_lower(); }
-    if (name == "Asc" && args.size() == 1) { r_handled = true; String s = args[0]; if (s.length()>0) return (int)s.unicode_at(0); return 0; }
-    if (name == "Chr" && args.size() == 1) { r_handled = true; return String::chr((int)args[0]); }
-    if (name == "Space" && args.size() == 1) { r_handled = true; int n = (int)args[0]; String s=""; for(int i=0;i<n;i++) s += " "; return s; }
-    if (name == "String" && args.size() == 2) { r_handled = true; int n=(int)args[0]; String char_str = String(args[1]); String s=""; if (char_str.length()>0){ String c = char_str.substr(0,1); for(int i=0;i<n;i++) s+=c;} return s; }
-    if (name == "Str" && args.size() == 1) { r_handled = true; return Variant(args[0]).stringify(); }
-    if (name.nocasecmp_to("CStr") == 0 && args.size() == 1) { r_handled = true; return variant_to_cstr(args[0]); }
-    if (name.nocasecmp_to("CStr") == 0 && args.size() == 1) { r_handled = true; return variant_to_cstr(args[0]); }
-    if (name == "Val" && args.size() == 1) { r_handled = true; String s = args[0]; if (s.is_valid_float()) return s.to_float(); if (s.is_valid_int()) return s.to_int(); return 0.0; }
-    if (METHOD_IS("instr") && args.size() == 2) { r_handled = true; String s1 = args[0]; String s2 = args[1]; int pos = s1.find(s2); if (pos==-1) return 0; return pos+1; }
-    if (METHOD_IS("replace") && args.size() == 3) { r_handled = true; return String(args[0]).replace(String(args[1]), String(args[2])); }
-    if (METHOD_IS("trim") && args.size() == 1) { r_handled = true; return String(args[0]).strip_edges(); }
-    if (METHOD_IS("ltrim") && args.size() == 1) { r_handled = true; return String(args[0]).strip_edges(true,false); }
-    if (METHOD_IS("rtrim") && args.size() == 1) { r_handled = true; return String(args[0]).strip_edges(false,true); }
-    if (METHOD_IS("strreverse") && args.size() == 1) { r_handled = true; String s = args[0]; String res=""; for(int i=s.length()-1;i>=0;i--) res += s[i]; return res; }
-    if (METHOD_IS("hex") && args.size() == 1) { r_handled = true; int64_t val = (int64_t)args[0]; return String::num_int64(val,16).to_upper(); }
-    if (METHOD_IS("oct") && args.size() == 1) { r_handled = true; int64_t val = (int64_t)args[0]; return String::num_int64(val,8); }
-    if (METHOD_IS("split") && args.size() >= 2) { r_handled = true; return String(args[0]).split(String(args[1])); }
-    if (METHOD_IS("join") && args.size() == 2) {
-        r_handled = true;
-        Variant v = args[0];
-        if (v.get_type() == Variant::PACKED_STRING_ARRAY) {
-            PackedStringArray psa = v;
-            return String(args[1]).join(psa);
+    const char *ref = p_table[id].name;
+    for (int i = 0; i < len; i++) {
+        char32_t c = chars[i];
+        if (c >= 'A' && c <= 'Z') {
+            c += 'a' - 'A';
         }
-        if (v.get_type() == Variant::ARRAY) {
-            Array arr = v;
-            PackedStringArray psa;
-            for (int i=0;i<arr.size();i++) psa.push_back((String)arr[i]);
-            return String(args[1]).join(psa);
+        if (ref[i] == '\0' || (char32_t)ref[i] != c) {
+            return -1;
         }
-        return String();
     }
+    return ref[len] == '\0' ? id : -1;
+}
 
-    // Array Helpers
-    if (METHOD_IS("ubound") && args.size() >= 1) {
-        r_handled = true;
-        Variant v = args[0];
-        if (v.get_type() == Variant::ARRAY) return ((Array)v).size() - 1;
-        if (v.get_type() == Variant::PACKED_STRING_ARRAY) return ((PackedStringArray)v).size() - 1;
-        if (v.get_type() == Variant::PACKED_INT32_ARRAY) return ((PackedInt32Array)v).size() - 1;
-        if (v.get_type() == Variant::PACKED_FLOAT32_ARRAY) return ((PackedFloat32Array)v).size() - 1;
-        if (v.get_type() == Variant::PACKED_INT64_ARRAY) return ((PackedInt64Array)v).size() - 1;
-        if (v.get_type() == Variant::PACKED_FLOAT64_ARRAY) return ((PackedFloat64Array)v).size() - 1;
+static const BuiltinLookup &get_builtin_lookup() {
+    static const BuiltinLookup lookup = build_builtin_lookup(builtin_table, builtin_table_size);
+    return lookup;
+}
+
+int find_builtin_id(const String &p_name) {
+    return lookup_builtin(get_builtin_lookup(), builtin_table, p_name);
+}
+
+int find_builtin_id(const String &p_name, int p_argc) {
+    int id = find_builtin_id(p_name);
+    if (id < 0 || p_argc < builtin_table[id].min_args || p_argc > builtin_table[id].max_args) {
         return -1;
     }
-    if (METHOD_IS("lbound") && args.size() >= 1) { r_handled = true; return 0; }
-
-    // File / Dir Helpers (use instance wrappers)
-    if (METHOD_IS("lof") && args.size() == 1) { r_handled = true; return instance->file_lof((int)args[0]); }
-    if (METHOD_IS("loc") && args.size() == 1) { r_handled = true; return instance->file_loc((int)args[0]); }
-    if (METHOD_IS("eof") && args.size() == 1) { r_handled = true; return instance->file_eof((int)args[0]); }
-    if (METHOD_IS("freefile")) { r_handled = true; int range = 0; if (args.size()>0) range = (int)args[0]; return instance->file_free(range); }
-    if (METHOD_IS("filelen") && args.size() == 1) { r_handled = true; return instance->file_len(String(args[0])); }
-    if (METHOD_IS("dir")) { r_handled = true; return instance->file_dir(args); }
-    if (METHOD_IS("randomize")) { r_handled = true; instance->randomize_seed(); return Variant(); }
-
-    // If not handled here, leave r_handled false so caller can fallback
-#undef METHOD_IS
-    return Variant();
+    return id;
 }
 
-Variant call_builtin_expr_evaluated(VisualGasicInstance *instance, const String &p_method, const Array &p_args, bool &r_handled) {
-    r_handled = false;
-    const Array &args = p_args;
+const BuiltinInfo *get_builtin_info(int p_id) {
+    if (p_id < 0 || p_id >= builtin_table_size) {
+        return nullptr;
+    }
+    return &builtin_table[p_id];
+}
 
-    String lowercase_name = p_method;
-    lowercase_name = lowercase_name.to_lower();
-    const StringName method_key = StringName(lowercase_name);
+int get_builtin_count() {
+    return builtin_table_size;
+}
 
-    // Lowercase once so builtin dispatch stays O(1) per comparison.
-#define METHOD_IS(literal) (method_key == StringName(literal))
+bool call_builtin(VisualGasicInstance *instance, const String &p_method, const Array &p_args, Variant &r_ret, bool &r_found) {
+    VG_PROFILE_CATEGORY("builtin_call", "builtins");
+    VG_COUNT("builtin.function_calls");
+    
+    r_found = false;
+    r_ret = Variant();
 
-    if (METHOD_IS("createnode") && args.size() == 1) {
-        r_handled = true;
-        String type = String(args[0]);
-        if (ClassDB::class_exists(type) && ClassDB::can_instantiate(type)) {
-            Object *obj = ClassDB::instantiate(type);
-            if (obj) {
-                return obj;
-            }
-        }
-        return Variant();
-    }
+    if (!instance) return false;
 
-    if (METHOD_IS("benchfileiofast") && args.size() == 2) {
-        r_handled = true;
-        int64_t iterations = (int64_t)args[0];
-        int64_t size = (int64_t)args[1];
-        if (iterations <= 0 || size <= 0) return (int64_t)0;
-
-        String line;
-        line = line.repeat(0);
-        for (int64_t i = 0; i < size; i++) {
-            line += "x";
-        }
+    // Statement-level builtins are the command registry's; commands return nothing.
+    r_found = VisualGasicCommands::call_command(instance, p_method, p_args);
+    return r_found;
+}
 
-        Ref<FileAccess> file = FileAccess::open("user://bench_io_fast.txt", FileAccess::WRITE);
-        if (file.is_valid()) {
-            for (int64_t i = 0; i < iterations; i++) {
-                file->store_line(line);
-            }
-            file->close();
-        }
+// ---------------------------------------------------------------------------
+// Expression builtins
+// ---------------------------------------------------------------------------
+// Every name an expression call can resolve to a builtin. IDs below
+// builtin_table_size are the table builtins above; the rest index
+// expr_builtin_table. Call sites resolve their name once (find_expr_builtin_id)
+// and dispatch by ID afterwards, so a builtin's position in these tables does
+// not affect its call cost. Unlike table IDs, these are never baked into
+// bytecode and may be reordered.
+
+static constexpr int BUILTIN_VARIADIC = INT_MAX;
 
-        Ref<FileAccess> read = FileAccess::open("user://bench_io_fast.txt", FileAccess::READ);
-        String read_line;
-        if (read.is_valid()) {
-            read_line = read->get_line();
-            read->close();
+typedef Variant (*ExprBuiltinFunction)(VisualGasicInstance *p_instance, const Array &p_args);
+struct ExprBuiltinInfo {
+    const char *name; // Lower-case VB name
+    int min_args;
+    int max_args;
+    ExprBuiltinFunction fn;
+};
+
+// Engine and benchmark helpers
+static Variant eb_createnode(VisualGasicInstance *, const Array &args) {
+    String type = String(args[0]);
+    if (ClassDB::class_exists(type) && ClassDB::can_instantiate(type)) {
+        Object *obj = ClassDB::instantiate(type);
+        if (obj) {
+            return obj;
         }
-        return (int64_t)read_line.length();
     }
+    return Variant();
+}
 
-    // String Library
-    if (METHOD_IS("len") && args.size() == 1) { r_handled = true; return String(args[0]).length(); }
-    if (METHOD_IS("left") && args.size() == 2) { r_handled = true; return String(args[0]).left((int)args[1]); }
-    if (METHOD_IS("right") && args.size() == 2) { r_handled = true; return String(args[0]).right((int)args[1]); }
-    if (METHOD_IS("mid") && args.size() >= 2) {
-        r_handled = true;
-        String s = String(args[0]);
-        int start = (int)args[1] - 1;
-        if (start < 0) start = 0;
-        if (args.size() == 3) return s.substr(start, (int)args[2]);
-        return s.substr(start);
-    }
-    if (METHOD_IS("ucase") && args.size() == 1) { r_handled = true; return String(args[0]).to_upper(); }
-    if (METHOD_IS("lcase") && args.size() == 1) { r_handled = true; return String(args[0]).to_lower(); }
-    if (METHOD_IS("asc") && args.size() == 1) { r_handled = true; String s = args[0]; if (s.length()>0) return (int)s.unicode_at(0); return 0; }
-    if (METHOD_IS("chr") && args.size() == 1) { r_handled = true; return String::chr((int)args[0]); }
-    if (METHOD_IS("space") && args.size() == 1) { r_handled = true; int n = (int)args[0]; String s=""; for(int i=0;i<n;i++) s += " "; return s; }
-    if (METHOD_IS("string") && args.size() == 2) { r_handled = true; int n=(int)args[0]; String char_str = String(args[1]); String s=""; if (char_str.length()>0){ String c = char_str.substr(0,1); for(int i=0;i<n;i++) s+=c;} return s; }
-    if (METHOD_IS("str") && args.size() == 1) { r_handled = true; return Variant(args[0]).stringify(); }
-    if (METHOD_IS("cstr") && args.size() == 1) { r_handled = true; return variant_to_cstr(args[0]); }
-    if (METHOD_IS("val") && args.size() == 1) { r_handled = true; String s = args[0]; if (s.is_valid_float()) return s.to_float(); if (s.is_valid_int()) return s.to_int(); return 0.0; }
-
-    // Math Library
-    if (METHOD_IS("sin") && args.size() == 1) { r_handled = true; return UtilityFunctions::sin(args[0]); }
-    if (METHOD_IS("cos") && args.size() == 1) { r_handled = true; return UtilityFunctions::cos(args[0]); }
-    if (METHOD_IS("tan") && args.size() == 1) { r_handled = true; return UtilityFunctions::tan(args[0]); }
-    if (METHOD_IS("log") && args.size() == 1) { r_handled = true; return UtilityFunctions::log(args[0]); }
-    if (METHOD_IS("exp") && args.size() == 1) { r_handled = true; return UtilityFunctions::exp(args[0]); }
-    if (METHOD_IS("atn") && args.size() == 1) { r_handled = true; return UtilityFunctions::atan(args[0]); }
-    if (METHOD_IS("sqr") && args.size() == 1) { r_handled = true; return UtilityFunctions::sqrt(args[0]); }
-    if (METHOD_IS("abs") && args.size() == 1) { 
-        r_handled = true; 
-        if (args[0].get_type() == Variant::INT) { int64_t v = (int64_t)args[0]; return v < 0 ? -v : v; }
-        return UtilityFunctions::abs(args[0]); 
+static Variant eb_benchfileiofast(VisualGasicInstance *, const Array &args) {
+    int64_t iterations = (int64_t)args[0];
+    int64_t size = (int64_t)args[1];
+    if (iterations <= 0 || size <= 0) return (int64_t)0;
+
+    String line;
+    line = line.repeat(0);
+    for (int64_t i = 0; i < size; i++) {
+        line += "x";
     }
-    if (METHOD_IS("sgn") && args.size() == 1) { r_handled = true; double d = (double)args[0]; if (d>0) return (int64_t)1; if (d<0) return (int64_t)-1; return (int64_t)0; }
-    if (METHOD_IS("int") && args.size() == 1) { r_handled = true; if (args[0].get_type() == Variant::INT) return (int64_t)args[0]; return UtilityFunctions::floor(args[0]); }
-    if (METHOD_IS("rnd") && (args.size() == 0 || args.size() == 1)) { r_handled = true; return UtilityFunctions::randf(); }
-    if (METHOD_IS("fix") && args.size() == 1) { r_handled = true; double v = (double)args[0]; return v < 0 ? ceil(v) : floor(v); }
 
-    if (METHOD_IS("round") && args.size() >= 1) {
-        r_handled = true;
-        double val = (double)args[0];
-        if (args.size() > 1) {
-            int digits = (int)args[1];
-            double step = pow(10.0, -digits);
-            return Math::snapped(val, step);
+    Ref<FileAccess> file = FileAccess::open("user://bench_io_fast.txt", FileAccess::WRITE);
+    if (file.is_valid()) {
+        for (int64_t i = 0; i < iterations; i++) {
+            file->store_line(line);
         }
-        return round(val);
+        file->close();
     }
 
-    if (METHOD_IS("randrange") && args.size() == 2) {
-        r_handled = true;
-        float min = (float)args[0];
-        float max = (float)args[1];
-        return min + UtilityFunctions::randf() * (max - min);
+    Ref<FileAccess> read = FileAccess::open("user://bench_io_fast.txt", FileAccess::READ);
+    String read_line;
+    if (read.is_valid()) {
+        read_line = read->get_line();
+        read->close();
     }
+    return (int64_t)read_line.length();
+}
 
-    if (METHOD_IS("cint") && args.size() == 1) { r_handled = true; return (int64_t)llround((double)args[0]); }
-    if (METHOD_IS("clng") && args.size() == 1) { r_handled = true; return (int64_t)llround((double)args[0]); }
-    if (METHOD_IS("csng") && args.size() == 1) { r_handled = true; return (double)args[0]; }
-    if (METHOD_IS("cdbl") && args.size() == 1) { r_handled = true; return (double)args[0]; }
-    if (METHOD_IS("cbool") && args.size() == 1) { r_handled = true; return (bool)args[0]; }
+// Extended array functions
+static Variant eb_allocfilli64(VisualGasicInstance *, const Array &args) {
+    int64_t count = (int64_t)args[0];
+    if (count < 0) count = 0;
+    PackedInt64Array arr;
+    arr.resize((int)count);
+    int64_t *w = arr.ptrw();
+    for (int64_t i = 0; i < count; i++) {
+        w[i] = i;
+    }
+    return arr;
+}
 
-    if (METHOD_IS("lerp") && args.size() == 3) { r_handled = true; double a = args[0]; double b = args[1]; double t = args[2]; return Math::lerp(a,b,t); }
-    if (METHOD_IS("clamp") && args.size() == 3) { r_handled = true; double val = args[0]; double mn = args[1]; double mx = args[2]; return Math::clamp(val,mn,mx); }
+static Variant eb_allocfilli64sum(VisualGasicInstance *, const Array &args) {
+    int64_t count = (int64_t)args[0];
+    if (count < 0) count = 0;
+    PackedInt64Array arr;
+    arr.resize((int)count);
+    int64_t *w = arr.ptrw();
+    for (int64_t i = 0; i < count; i++) {
+        w[i] = i;
+    }
+    return count;
+}
 
-    // String functions
-    if (METHOD_IS("startswith") && args.size() == 2) {
-        r_handled = true;
-        String text = String(args[0]);
-        String prefix = String(args[1]);
-        return text.begins_with(prefix);
-    }
-    
-    if (METHOD_IS("endswith") && args.size() == 2) {
-        r_handled = true;
-        String text = String(args[0]);
-        String suffix = String(args[1]);
-        return text.ends_with(suffix);
-    }
-    
-    if (METHOD_IS("padleft") && (args.size() == 2 || args.size() == 3)) {
-        r_handled = true;
-        String text = String(args[0]);
-        int length = int(args[1]);
-        String pad_char = args.size() == 3 ? String(args[2]) : " ";
-        if (pad_char.length() > 0) {
-            while (text.length() < length) {
-                text = pad_char.substr(0, 1) + text;
-            }
-        }
-        return text;
-    }
-    
-    if (METHOD_IS("padright") && (args.size() == 2 || args.size() == 3)) {
-        r_handled = true;
-        String text = String(args[0]);
-        int length = int(args[1]);
-        String pad_char = args.size() == 3 ? String(args[2]) : " ";
-        if (pad_char.length() > 0) {
-            while (text.length() < length) {
-                text = text + pad_char.substr(0, 1);
-            }
+static Variant eb_push(VisualGasicInstance *, const Array &args) {
+    Variant input = args[0];
+    Variant new_item = args[1];
+    if (input.get_type() == Variant::ARRAY) {
+        Array arr = input;
+        Array new_arr = arr.duplicate();
+        new_arr.append(new_item);
+        return new_arr;
+    }
+    return input;
+}
+
+static Variant eb_pop(VisualGasicInstance *, const Array &args) {
+    Variant input = args[0];
+    if (input.get_type() == Variant::ARRAY) {
+        Array arr = input;
+        if (arr.size() > 0) {
+            return arr[arr.size() - 1];
         }
-        return text;
     }
+    return Variant();
+}
 
+static Variant eb_slice(VisualGasicInstance *, const Array &args) {
+    Variant input = args[0];
+    int start = int(args[1]);
+    int end = args.size() > 2 ? int(args[2]) : -1;
 
-    // Extended Array Functions
-    if (METHOD_IS("allocfilli64") && args.size() == 1) {
-        r_handled = true;
-        int64_t count = (int64_t)args[0];
-        if (count < 0) count = 0;
-        PackedInt64Array arr;
-        arr.resize((int)count);
-        int64_t *w = arr.ptrw();
-        for (int64_t i = 0; i < count; i++) {
-            w[i] = i;
-        }
-        return arr;
-    }
-    if (METHOD_IS("allocfilli64sum") && args.size() == 1) {
-        r_handled = true;
-        int64_t count = (int64_t)args[0];
-        if (count < 0) count = 0;
-        PackedInt64Array arr;
-        arr.resize((int)count);
-        int64_t *w = arr.ptrw();
-        for (int64_t i = 0; i < count; i++) {
-            w[i] = i;
-        }
-        return count;
-    }
-    if (METHOD_IS("push") && args.size() == 2) {
-        r_handled = true;
-        Variant input = args[0];
-        Variant new_item = args[1];
-        if (input.get_type() == Variant::ARRAY) {
-            Array arr = input;
-            Array new_arr = arr.duplicate();
-            new_arr.append(new_item);
-            return new_arr;
-        }
-        return input;
-    }
-    
-    if (METHOD_IS("pop") && args.size() == 1) {
-        r_handled = true;
-        Variant input = args[0];
-        if (input.get_type() == Variant::ARRAY) {
-            Array arr = input;
-            if (arr.size() > 0) {
-                return arr[arr.size() - 1];
-            }
-        }
-        return Variant();
-    }
-    
-    if (METHOD_IS("slice") && args.size() >= 2) {
-        r_handled = true;
-        Variant input = args[0];
-        int start = int(args[1]);
-        int end = args.size() > 2 ? int(args[2]) : -1;
-        
-        if (input.get_type() == Variant::ARRAY) {
-            Array arr = input;
-            Array sliced;
-            if (end == -1) end = arr.size();
-            
-            for (int i = start; i < end && i < arr.size(); i++) {
-                if (i >= 0) sliced.append(arr[i]);
-            }
-            return sliced;
+    if (input.get_type() == Variant::ARRAY) {
+        Array arr = input;
+        Array sliced;
+        if (end == -1) end = arr.size();
+
+        for (int i = start; i < end && i < arr.size(); i++) {
+            if (i >= 0) sliced.append(arr[i]);
         }
-        return input;
+        return sliced;
     }
-    if (METHOD_IS("sort") && args.size() == 1) {
-        r_handled = true;
-        Variant input = args[0];
-        if (input.get_type() == Variant::ARRAY) {
-            Array arr = input;
-            Array sorted_arr = arr.duplicate();
-            
-            // Simple bubble sort for mixed types
-            int n = sorted_arr.size();
-            for (int i = 0; i < n - 1; i++) {
-                for (int j = 0; j < n - i - 1; j++) {
-                    Variant a = sorted_arr[j];
-                    Variant b = sorted_arr[j + 1];
-                    
-                    // Compare based on type
-                    bool should_swap = false;
-                    if (a.get_type() == b.get_type()) {
-                        if (a.get_type() == Variant::INT || a.get_type() == Variant::FLOAT) {
-                            should_swap = (double)a > (double)b;
-                        } else if (a.get_type() == Variant::STRING) {
-                            should_swap = String(a).naturalnocasecmp_to(String(b)) > 0;
-                        }
-                    } else {
-                        // Different types: convert to strings for comparison
+    return input;
+}
+
+static Variant eb_sort(VisualGasicInstance *, const Array &args) {
+    Variant input = args[0];
+    if (input.get_type() == Variant::ARRAY) {
+        Array arr = input;
+        Array sorted_arr = arr.duplicate();
+
+        // Simple bubble sort for mixed types
+        int n = sorted_arr.size();
+        for (int i = 0; i < n - 1; i++) {
+            for (int j = 0; j < n - i - 1; j++) {
+                Variant a = sorted_arr[j];
+                Variant b = sorted_arr[j + 1];
+
+                // Compare based on type
+                bool should_swap = false;
+                if (a.get_type() == b.get_type()) {
+                    if (a.get_type() == Variant::INT || a.get_type() == Variant::FLOAT) {
+                        should_swap = (double)a > (double)b;
+                    } else if (a.get_type() == Variant::STRING) {
                         should_swap = String(a).naturalnocasecmp_to(String(b)) > 0;
                     }
-                    
-                    if (should_swap) {
-                        sorted_arr[j] = b;
-                        sorted_arr[j + 1] = a;
-                    }
+                } else {
+                    // Different types: convert to strings for comparison
+                    should_swap = String(a).naturalnocasecmp_to(String(b)) > 0;
+                }
+
+                if (should_swap) {
+                    sorted_arr[j] = b;
+                    sorted_arr[j + 1] = a;
                 }
             }
-            return sorted_arr;
         }
-        return input;
+        return sorted_arr;
     }
+    return input;
+}
 
-    if (METHOD_IS("reverse") && args.size() == 1) {
-        r_handled = true;
-        Variant input = args[0];
-        if (input.get_type() == Variant::ARRAY) {
-            Array arr = input;
-            Array reversed_arr;
-            for (int i = arr.size() - 1; i >= 0; i--) {
-                reversed_arr.append(arr[i]);
-            }
-            return reversed_arr;
+static Variant eb_reverse(VisualGasicInstance *, const Array &args) {
+    Variant input = args[0];
+    if (input.get_type() == Variant::ARRAY) {
+        Array arr = input;
+        Array reversed_arr;
+        for (int i = arr.size() - 1; i >= 0; i--) {
+            reversed_arr.append(arr[i]);
         }
-        return input;
+        return reversed_arr;
     }
+    return input;
+}
 
-    if (METHOD_IS("indexof") && args.size() == 2) {
-        r_handled = true;
-        Variant input = args[0];
-        Variant search_val = args[1];
-        if (input.get_type() == Variant::ARRAY) {
-            Array arr = input;
-            for (int i = 0; i < arr.size(); i++) {
-                if (arr[i] == search_val) {
-                    return i;
-                }
+static Variant eb_indexof(VisualGasicInstance *, const Array &args) {
+    Variant input = args[0];
+    Variant search_val = args[1];
+    if (input.get_type() == Variant::ARRAY) {
+        Array arr = input;
+        for (int i = 0; i < arr.size(); i++) {
+            if (arr[i] == search_val) {
+                return i;
             }
         }
-        return -1;
     }
+    return -1;
+}
 
-    if (METHOD_IS("contains") && args.size() == 2) {
-        r_handled = true;
-        Variant input = args[0];
-        Variant search_val = args[1];
-        
-        // Handle string contains
-        if (input.get_type() == Variant::STRING) {
-            String text = String(input);
-            String search = String(search_val);
-            return text.contains(search);
-        }
-        
-        // Handle array contains
-        if (input.get_type() == Variant::ARRAY) {
-            Array arr = input;
-            for (int i = 0; i < arr.size(); i++) {
-                if (arr[i] == search_val) {
-                    return true;
-                }
-            }
-        }
-        return false;
+static Variant eb_contains(VisualGasicInstance *, const Array &args) {
+    Variant input = args[0];
+    Variant search_val = args[1];
+
+    // Handle string contains
+    if (input.get_type() == Variant::STRING) {
+        String text = String(input);
+        String search = String(search_val);
+        return text.contains(search);
     }
 
-    if (METHOD_IS("unique") && args.size() == 1) {
-        r_handled = true;
-        Variant input = args[0];
-        if (input.get_type() == Variant::ARRAY) {
-            Array arr = input;
-            Array unique_arr;
-            for (int i = 0; i < arr.size(); i++) {
-                bool found = false;
-                for (int j = 0; j < unique_arr.size(); j++) {
-                    if (unique_arr[j] == arr[i]) {
-                        found = true;
-                        break;
-                    }
-                }
-                if (!found) {
-                    unique_arr.append(arr[i]);
-                }
+    // Handle array contains
+    if (input.get_type() == Variant::ARRAY) {
+        Array arr = input;
+        for (int i = 0; i < arr.size(); i++) {
+            if (arr[i] == search_val) {
+                return true;
             }
-            return unique_arr;
         }
-        return input;
     }
+    return false;
+}
 
-    if (METHOD_IS("flatten") && args.size() == 1) {
-        r_handled = true;
-        Variant input = args[0];
-        if (input.get_type() == Variant::ARRAY) {
-            Array arr = input;
-            Array flat_arr;
-            for (int i = 0; i < arr.size(); i++) {
-                if (arr[i].get_type() == Variant::ARRAY) {
-                    Array sub_arr = arr[i];
-                    for (int j = 0; j < sub_arr.size(); j++) {
-                        flat_arr.append(sub_arr[j]);
-                    }
-                } else {
-                    flat_arr.append(arr[i]);
+static Variant eb_unique(VisualGasicInstance *, const Array &args) {
+    Variant input = args[0];
+    if (input.get_type() == Variant::ARRAY) {
+        Array arr = input;
+        Array unique_arr;
+        for (int i = 0; i < arr.size(); i++) {
+            bool found = false;
+            for (int j = 0; j < unique_arr.size(); j++) {
+                if (unique_arr[j] == arr[i]) {
+                    found = true;
+                    break;
                 }
             }
-            return flat_arr;
-        }
-        return input;
-    }
-    
-    if (METHOD_IS("push") && args.size() == 2) {
-        r_handled = true;
-        Variant input = args[0];
-        Variant new_item = args[1];
-        if (input.get_type() == Variant::ARRAY) {
-            Array arr = input;
-            Array new_arr = arr.duplicate();
-            new_arr.append(new_item);
-            return new_arr;
-        }
-        return input;
-    }
-    
-    if (METHOD_IS("pop") && args.size() == 1) {
-        r_handled = true;
-        Variant input = args[0];
-        if (input.get_type() == Variant::ARRAY) {
-            Array arr = input;
-            if (arr.size() > 0) {
-                return arr[arr.size() - 1];
+            if (!found) {
+                unique_arr.append(arr[i]);
             }
         }
-        return Variant();
+        return unique_arr;
     }
-    
-    if (METHOD_IS("slice") && args.size() >= 2) {
-        r_handled = true;
-        Variant input = args[0];
-        int start = int(args[1]);
-        int end = args.size() > 2 ? int(args[2]) : -1;
-        
-        if (input.get_type() == Variant::ARRAY) {
-            Array arr = input;
-            Array sliced;
-            if (end == -1) end = arr.size();
-            
-            for (int i = start; i < end && i < arr.size(); i++) {
-                if (i >= 0) sliced.append(arr[i]);
+    return input;
+}
+
+static Variant eb_flatten(VisualGasicInstance *, const Array &args) {
+    Variant input = args[0];
+    if (input.get_type() == Variant::ARRAY) {
+        Array arr = input;
+        Array flat_arr;
+        for (int i = 0; i < arr.size(); i++) {
+            if (arr[i].get_type() == Variant::ARRAY) {
+                Array sub_arr = arr[i];
+                for (int j = 0; j < sub_arr.size(); j++) {
+                    flat_arr.append(sub_arr[j]);
+                }
+            } else {
+                flat_arr.append(arr[i]);
             }
-            return sliced;
-        }
-        return input;
-    }
-    
-    if (METHOD_IS("repeat") && args.size() == 2) {
-        r_handled = true;
-        Variant item = args[0];
-        int count = int(args[1]);
-        Array repeated;
-        
-        for (int i = 0; i < count; i++) {
-            repeated.append(item);
         }
-        return repeated;
+        return flat_arr;
     }
-    
-    if (METHOD_IS("zip") && args.size() == 2) {
-        r_handled = true;
-        Variant input1 = args[0];
-        Variant input2 = args[1];
-        
-        if (input1.get_type() == Variant::ARRAY && input2.get_type() == Variant::ARRAY) {
-            Array arr1 = input1;
-            Array arr2 = input2;
-            Array zipped;
-            
-            int min_size = Math::min(arr1.size(), arr2.size());
-            for (int i = 0; i < min_size; i++) {
-                Array pair;
-                pair.append(arr1[i]);
-                pair.append(arr2[i]);
-                zipped.append(pair);
-            }
-            return zipped;
-        }
-        return Array();
+    return input;
+}
+
+static Variant eb_repeat(VisualGasicInstance *, const Array &args) {
+    Variant item = args[0];
+    int count = int(args[1]);
+    Array repeated;
+
+    for (int i = 0; i < count; i++) {
+        repeated.append(item);
     }
-    
-    if (METHOD_IS("range") && (args.size() >= 2 && args.size() <= 3)) {
-        r_handled = true;
-        int start = int(args[0]);
-        int end = int(args[1]);
-        int step = args.size() == 3 ? int(args[2]) : 1;
-        
-        Array range;
-        if (step > 0) {
-            for (int i = start; i < end; i += step) {
-                range.append(i);
-            }
-        } else if (step < 0) {
-            for (int i = start; i > end; i += step) {
-                range.append(i);
-            }
+    return repeated;
+}
+
+static Variant eb_zip(VisualGasicInstance *, const Array &args) {
+    Variant input1 = args[0];
+    Variant input2 = args[1];
+
+    if (input1.get_type() == Variant::ARRAY && input2.get_type() == Variant::ARRAY) {
+        Array arr1 = input1;
+        Array arr2 = input2;
+        Array zipped;
+
+        int min_size = Math::min(arr1.size(), arr2.size());
+        for (int i = 0; i < min_size; i++) {
+            Array pair;
+            pair.append(arr1[i]);
+            pair.append(arr2[i]);
+            zipped.append(pair);
         }
-        return range;
+        return zipped;
     }
-    
-    // Dictionary functions
-    if (METHOD_IS("keys") && args.size() == 1) {
-        r_handled = true;
-        Variant input = args[0];
-        if (input.get_type() == Variant::DICTIONARY) {
-            Dictionary dict = input;
-            return dict.keys();
+    return Array();
+}
+
+static Variant eb_range(VisualGasicInstance *, const Array &args) {
+    int start = int(args[0]);
+    int end = int(args[1]);
+    int step = args.size() == 3 ? int(args[2]) : 1;
+
+    Array range;
+    if (step > 0) {
+        for (int i = start; i < end; i += step) {
+            range.append(i);
         }
-        return Array();
-    }
-    
-    if (METHOD_IS("values") && args.size() == 1) {
-        r_handled = true;
-        Variant input = args[0];
-        if (input.get_type() == Variant::DICTIONARY) {
-            Dictionary dict = input;
-            return dict.values();
+    } else if (step < 0) {
+        for (int i = start; i > end; i += step) {
+            range.append(i);
         }
-        return Array();
     }
-    
-    if (METHOD_IS("haskey") && args.size() == 2) {
-        r_handled = true;
-        Variant input = args[0];
-        Variant key = args[1];
-        if (input.get_type() == Variant::DICTIONARY) {
-            Dictionary dict = input;
-            return dict.has(key);
-        }
-        return false;
+    return range;
+}
+
+// Dictionary functions
+static Variant eb_keys(VisualGasicInstance *, const Array &args) {
+    Variant input = args[0];
+    if (input.get_type() == Variant::DICTIONARY) {
+        Dictionary dict = input;
+        return dict.keys();
+    }
+    return Array();
+}
+
+static Variant eb_values(VisualGasicInstance *, const Array &args) {
+    Variant input = args[0];
+    if (input.get_type() == Variant::DICTIONARY) {
+        Dictionary dict = input;
+        return dict.values();
     }
-    
-    if (METHOD_IS("merge") && args.size() == 2) {
-        r_handled = true;
-        Variant input1 = args[0];
-        Variant input2 = args[1];
-        
-        if (input1.get_type() == Variant::DICTIONARY && input2.get_type() == Variant::DICTIONARY) {
-            Dictionary dict1 = input1;
-            Dictionary dict2 = input2;
-            Dictionary merged = dict1.duplicate();
-            
-            Array keys2 = dict2.keys();
-            for (int i = 0; i < keys2.size(); i++) {
-                merged[keys2[i]] = dict2[keys2[i]];
-            }
-            return merged;
-        }
-        return input1;
+    return Array();
+}
+
+static Variant eb_haskey(VisualGasicInstance *, const Array &args) {
+    Variant input = args[0];
+    Variant key = args[1];
+    if (input.get_type() == Variant::DICTIONARY) {
+        Dictionary dict = input;
+        return dict.has(key);
     }
-    
-    if (METHOD_IS("remove") && args.size() == 2) {
-        r_handled = true;
-        Variant input = args[0];
-        Variant key = args[1];
-        
-        if (input.get_type() == Variant::DICTIONARY) {
-            Dictionary dict = input;
-            Dictionary new_dict = dict.duplicate();
-            new_dict.erase(key);
-            return new_dict;
+    return false;
+}
+
+static Variant eb_merge(VisualGasicInstance *, const Array &args) {
+    Variant input1 = args[0];
+    Variant input2 = args[1];
+
+    if (input1.get_type() == Variant::DICTIONARY && input2.get_type() == Variant::DICTIONARY) {
+        Dictionary dict1 = input1;
+        Dictionary dict2 = input2;
+        Dictionary merged = dict1.duplicate();
+
+        Array keys2 = dict2.keys();
+        for (int i = 0; i < keys2.size(); i++) {
+            merged[keys2[i]] = dict2[keys2[i]];
         }
-        return input;
-    }
-    
-    // Type checking functions
-    if (METHOD_IS("isarray") && args.size() == 1) {
-        r_handled = true;
-        return args[0].get_type() == Variant::ARRAY;
-    }
-    
-    if (METHOD_IS("isdict") && args.size() == 1) {
-        r_handled = true;
-        return args[0].get_type() == Variant::DICTIONARY;
-    }
-    
-    if (METHOD_IS("isstring") && args.size() == 1) {
-        r_handled = true;
-        return args[0].get_type() == Variant::STRING;
+        return merged;
     }
-    
-    if (METHOD_IS("isnumber") && args.size() == 1) {
-        r_handled = true;
-        Variant::Type type = args[0].get_type();
-        return type == Variant::INT || type == Variant::FLOAT;
-    }
-    
-    if (METHOD_IS("isnull") && args.size() == 1) {
-        r_handled = true;
-        return args[0].get_type() == Variant::NIL;
-    }
-    
-    if (METHOD_IS("typename") && args.size() == 1) {
-        r_handled = true;
-        return Variant::get_type_name(args[0].get_type());
-    }
-    
-    // JSON functions
-    if (METHOD_IS("jsonstringify") && args.size() >= 1) {
-        r_handled = true;
-        Variant data = args[0];
-        bool pretty = args.size() > 1 ? bool(args[1]) : false;
-        String indent = pretty ? "\t" : "";
-        return JSON::stringify(data, indent);
-    }
-    
-    if (METHOD_IS("jsonparse") && args.size() == 1) {
-        r_handled = true;
-        String json_str = String(args[0]);
-        return JSON::parse_string(json_str);
-    }
-    
-    // File system functions
-    if (METHOD_IS("fileexists") && args.size() == 1) {
-        r_handled = true;
-        String path = String(args[0]);
-        return FileAccess::file_exists(path);
+    return input1;
+}
+
+static Variant eb_remove(VisualGasicInstance *, const Array &args) {
+    Variant input = args[0];
+    Variant key = args[1];
+
+    if (input.get_type() == Variant::DICTIONARY) {
+        Dictionary dict = input;
+        Dictionary new_dict = dict.duplicate();
+        new_dict.erase(key);
+        return new_dict;
     }
-    
-    if (METHOD_IS("direxists") && args.size() == 1) {
-        r_handled = true;
-        String path = String(args[0]);
-        return DirAccess::dir_exists_absolute(path);
+    return input;
+}
+
+// Type checking functions
+static Variant eb_isarray(VisualGasicInstance *, const Array &args) {
+    return args[0].get_type() == Variant::ARRAY;
+}
+
+static Variant eb_isdict(VisualGasicInstance *, const Array &args) {
+    return args[0].get_type() == Variant::DICTIONARY;
+}
+
+static Variant eb_isstring(VisualGasicInstance *, const Array &args) {
+    return args[0].get_type() == Variant::STRING;
+}
+
+static Variant eb_isnumber(VisualGasicInstance *, const Array &args) {
+    Variant::Type type = args[0].get_type();
+    return type == Variant::INT || type == Variant::FLOAT;
+}
+
+static Variant eb_isnull(VisualGasicInstance *, const Array &args) {
+    return args[0].get_type() == Variant::NIL;
+}
+
+static Variant eb_typename(VisualGasicInstance *, const Array &args) {
+    return Variant::get_type_name(args[0].get_type());
+}
+
+// JSON functions
+static Variant eb_jsonstringify(VisualGasicInstance *, const Array &args) {
+    Variant data = args[0];
+    bool pretty = args.size() > 1 ? bool(args[1]) : false;
+    String indent = pretty ? "\t" : "";
+    return JSON::stringify(data, indent);
+}
+
+static Variant eb_jsonparse(VisualGasicInstance *, const Array &args) {
+    String json_str = String(args[0]);
+    return JSON::parse_string(json_str);
+}
+
+// File system functions
+static Variant eb_fileexists(VisualGasicInstance *, const Array &args) {
+    String path = String(args[0]);
+    return FileAccess::file_exists(path);
+}
+
+static Variant eb_direxists(VisualGasicInstance *, const Array &args) {
+    String path = String(args[0]);
+    return DirAccess::dir_exists_absolute(path);
+}
+
+static Variant eb_readalltext(VisualGasicInstance *, const Array &args) {
+    String path = String(args[0]);
+    Ref<FileAccess> file = FileAccess::open(path, FileAccess::READ);
+    if (file.is_valid()) {
+        String content = file->get_as_text();
+        file->close();
+        return content;
+    }
+    return String();
+}
+
+static Variant eb_writealltext(VisualGasicInstance *, const Array &args) {
+    String path = String(args[0]);
+    String content = String(args[1]);
+    Ref<FileAccess> file = FileAccess::open(path, FileAccess::WRITE);
+    if (file.is_valid()) {
+        file->store_string(content);
+        file->close();
+        return true;
     }
-    
-    if (METHOD_IS("readalltext") && args.size() == 1) {
-        r_handled = true;
-        String path = String(args[0]);
-        Ref<FileAccess> file = FileAccess::open(path, FileAccess::READ);
-        if (file.is_valid()) {
-            String content = file->get_as_text();
-            file->close();
-            return content;
+    return false;
+}
+
+static Variant eb_readlines(VisualGasicInstance *, const Array &args) {
+    String path = String(args[0]);
+    Ref<FileAccess> file = FileAccess::open(path, FileAccess::READ);
+    if (file.is_valid()) {
+        Array lines;
+        while (!file->eof_reached()) {
+            lines.append(file->get_line());
         }
-        return String();
+        file->close();
+        return lines;
     }
-    
-    if (METHOD_IS("writealltext") && args.size() == 2) {
-        r_handled = true;
-        String path = String(args[0]);
-        String content = String(args[1]);
-        Ref<FileAccess> file = FileAccess::open(path, FileAccess::WRITE);
-        if (file.is_valid()) {
-            file->store_string(content);
-            file->close();
-            return true;
+    return Array();
+}
+
+static Variant eb_dictmerge(VisualGasicInstance *, const Array &args) {
+    Variant input1 = args[0];
+    Variant input2 = args[1];
+
+    if (input1.get_type() == Variant::DICTIONARY && input2.get_type() == Variant::DICTIONARY) {
+        Dictionary dict1 = input1;
+        Dictionary dict2 = input2;
+        Dictionary merged = dict1.duplicate();
+
+        Array keys2 = dict2.keys();
+        for (int i = 0; i < keys2.size(); i++) {
+            merged[keys2[i]] = dict2[keys2[i]];
         }
-        return false;
+        return merged;
     }
-    
-    if (METHOD_IS("readlines") && args.size() == 1) {
-        r_handled = true;
-        String path = String(args[0]);
-        Ref<FileAccess> file = FileAccess::open(path, FileAccess::READ);
-        if (file.is_valid()) {
-            Array lines;
-            while (!file->eof_reached()) {
-                lines.append(file->get_line());
-            }
-            file->close();
-            return lines;
-        }
-        return Array();
+    return input1;
+}
+
+static Variant eb_dictremove(VisualGasicInstance *, const Array &args) {
+    Variant input = args[0];
+    Variant key = args[1];
+
+    if (input.get_type() == Variant::DICTIONARY) {
+        Dictionary dict = input;
+        Dictionary new_dict = dict.duplicate();
+        new_dict.erase(key);
+        return new_dict;
     }
-    
-    if (METHOD_IS("repeat") && args.size() == 2) {
-        r_handled = true;
-        Variant item = args[0];
-        int count = int(args[1]);
-        Array repeated;
-        
-        for (int i = 0; i < count; i++) {
-            repeated.append(item);
-        }
-        return repeated;
+    return input;
+}
+
+static Variant eb_dictclear(VisualGasicInstance *, const Array &args) {
+    Variant input = args[0];
+
+    if (input.get_type() == Variant::DICTIONARY) {
+        Dictionary dict = input;
+        Dictionary new_dict;
+        return new_dict;
     }
-    
-    if (METHOD_IS("zip") && args.size() == 2) {
-        r_handled = true;
-        Variant input1 = args[0];
-        Variant input2 = args[1];
-        
-        if (input1.get_type() == Variant::ARRAY && input2.get_type() == Variant::ARRAY) {
-            Array arr1 = input1;
-            Array arr2 = input2;
-            Array zipped;
-            
-            int min_size = Math::min(arr1.size(), arr2.size());
-            for (int i = 0; i < min_size; i++) {
-                Array pair;
-                pair.append(arr1[i]);
-                pair.append(arr2[i]);
-                zipped.append(pair);
-            }
-            return zipped;
-        }
-        return Array();
+    return input;
+}
+
+static Variant eb_split(VisualGasicInstance *, const Array &args) {
+    return String(args[0]).split(String(args[1]));
+}
+
+static Variant eb_join(VisualGasicInstance *, const Array &args) {
+    Variant v = args[0];
+    if (v.get_type() == Variant::PACKED_STRING_ARRAY) {
+        PackedStringArray psa = v;
+        return String(args[1]).join(psa);
+    }
+    if (v.get_type() == Variant::ARRAY) {
+        Array arr = v;
+        PackedStringArray psa;
+        for (int i=0;i<arr.size();i++) psa.push_back((String)arr[i]);
+        return String(args[1]).join(psa);
+    }
+    return String();
+}
+
+// Array bounds and file number helpers (use instance wrappers)
+static Variant eb_ubound(VisualGasicInstance *, const Array &args) {
+    Variant v = args[0];
+    if (v.get_type() == Variant::ARRAY) return ((Array)v).size() - 1;
+    if (v.get_type() == Variant::PACKED_STRING_ARRAY) return ((PackedStringArray)v).size() - 1;
+    if (v.get_type() == Variant::PACKED_INT32_ARRAY) return ((PackedInt32Array)v).size() - 1;
+    if (v.get_type() == Variant::PACKED_FLOAT32_ARRAY) return ((PackedFloat32Array)v).size() - 1;
+    if (v.get_type() == Variant::PACKED_INT64_ARRAY) return ((PackedInt64Array)v).size() - 1;
+    if (v.get_type() == Variant::PACKED_FLOAT64_ARRAY) return ((PackedFloat64Array)v).size() - 1;
+    return -1;
+}
+
+static Variant eb_lbound(VisualGasicInstance *, const Array &) {
+    return 0;
+}
+
+static Variant eb_lof(VisualGasicInstance *instance, const Array &args) {
+    return instance->file_lof((int)args[0]);
+}
+
+static Variant eb_loc(VisualGasicInstance *instance, const Array &args) {
+    return instance->file_loc((int)args[0]);
+}
+
+static Variant eb_eof(VisualGasicInstance *instance, const Array &args) {
+    return instance->file_eof((int)args[0]);
+}
+
+static Variant eb_freefile(VisualGasicInstance *instance, const Array &args) {
+    int range = 0;
+    if (args.size()>0) range = (int)args[0];
+    return instance->file_free(range);
+}
+
+static Variant eb_filelen(VisualGasicInstance *instance, const Array &args) {
+    return instance->file_len(String(args[0]));
+}
+
+static Variant eb_dir(VisualGasicInstance *instance, const Array &args) {
+    return instance->file_dir(args);
+}
+
+static Variant eb_randomize(VisualGasicInstance *instance, const Array &) {
+    instance->randomize_seed();
+    return Variant();
+}
+
+static const ExprBuiltinInfo expr_builtin_table[] = {
+    {"createnode", 1, 1, eb_createnode},
+    {"benchfileiofast", 2, 2, eb_benchfileiofast},
+    {"allocfilli64", 1, 1, eb_allocfilli64},
+    {"allocfilli64sum", 1, 1, eb_allocfilli64sum},
+    {"push", 2, 2, eb_push},
+    {"pop", 1, 1, eb_pop},
+    {"slice", 2, BUILTIN_VARIADIC, eb_slice},
+    {"sort", 1, 1, eb_sort},
+    {"reverse", 1, 1, eb_reverse},
+    {"indexof", 2, 2, eb_indexof},
+    {"contains", 2, 2, eb_contains},
+    {"unique", 1, 1, eb_unique},
+    {"flatten", 1, 1, eb_flatten},
+    {"repeat", 2, 2, eb_repeat},
+    {"zip", 2, 2, eb_zip},
+    {"range", 2, 3, eb_range},
+    {"keys", 1, 1, eb_keys},
+    {"values", 1, 1, eb_values},
+    {"haskey", 2, 2, eb_haskey},
+    {"merge", 2, 2, eb_merge},
+    {"remove", 2, 2, eb_remove},
+    {"isarray", 1, 1, eb_isarray},
+    {"isdict", 1, 1, eb_isdict},
+    {"isstring", 1, 1, eb_isstring},
+    {"isnumber", 1, 1, eb_isnumber},
+    {"isnull", 1, 1, eb_isnull},
+    {"typename", 1, 1, eb_typename},
+    {"jsonstringify", 1, BUILTIN_VARIADIC, eb_jsonstringify},
+    {"jsonparse", 1, 1, eb_jsonparse},
+    {"fileexists", 1, 1, eb_fileexists},
+    {"direxists", 1, 1, eb_direxists},
+    {"readalltext", 1, 1, eb_readalltext},
+    {"writealltext", 2, 2, eb_writealltext},
+    {"readlines", 1, 1, eb_readlines},
+    {"dictmerge", 2, 2, eb_dictmerge},
+    {"dictremove", 2, 2, eb_dictremove},
+    {"dictclear", 1, 1, eb_dictclear},
+    {"split", 2, BUILTIN_VARIADIC, eb_split},
+    {"join", 2, 2, eb_join},
+    {"ubound", 1, BUILTIN_VARIADIC, eb_ubound},
+    {"lbound", 1, BUILTIN_VARIADIC, eb_lbound},
+    {"lof", 1, 1, eb_lof},
+    {"loc", 1, 1, eb_loc},
+    {"eof", 1, 1, eb_eof},
+    {"freefile", 0, BUILTIN_VARIADIC, eb_freefile},
+    {"filelen", 1, 1, eb_filelen},
+    {"dir", 0, BUILTIN_VARIADIC, eb_dir},
+    {"randomize", 0, BUILTIN_VARIADIC, eb_randomize},
+};
+static constexpr int expr_builtin_table_size = sizeof(expr_builtin_table) / sizeof(expr_builtin_table[0]);
+
+static const BuiltinLookup &get_expr_builtin_lookup() {
+    static const BuiltinLookup lookup = build_builtin_lookup(expr_builtin_table, expr_builtin_table_size);
+    return lookup;
+}
+
+int find_expr_builtin_id(const String &p_name) {
+    int id = find_builtin_id(p_name);
+    if (id >= 0) {
+        return id;
     }
-    
-    if (METHOD_IS("range") && (args.size() >= 2 && args.size() <= 3)) {
-        r_handled = true;
-        int start = int(args[0]);
-        int end = int(args[1]);
-        int step = args.size() == 3 ? int(args[2]) : 1;
-        
-        Array range;
-        if (step > 0) {
-            for (int i = start; i < end; i += step) {
-                range.append(i);
-            }
-        } else if (step < 0) {
-            for (int i = start; i > end; i += step) {
-                range.append(i);
-            }
-        }
-        return range;
+    id = lookup_builtin(get_expr_builtin_lookup(), expr_builtin_table, p_name);
+    return id < 0 ? -1 : builtin_table_size + id;
+}
+
+int get_expr_builtin_count() {
+    return builtin_table_size + expr_builtin_table_size;
+}
+
+const char *get_expr_builtin_name(int p_id) {
+    if (p_id >= 0 && p_id < builtin_table_size) {
+        return builtin_table[p_id].name;
     }
+    if (p_id >= builtin_table_size && p_id < builtin_table_size + expr_builtin_table_size) {
+        return expr_builtin_table[p_id - builtin_table_size].name;
+    }
+    return nullptr;
+}
 
-    // Dictionary Functions
-    if (METHOD_IS("keys") && args.size() == 1) {
-        r_handled = true;
-        Variant input = args[0];
-        if (input.get_type() == Variant::DICTIONARY) {
-            Dictionary dict = input;
-            return dict.keys();
+// Calls VisualGasicInstance::evaluate_expression answers itself, after the
+// tables above and before user Subs. Add a name here when adding a case there.
+static const char *const evaluator_intrinsic_table[] = {
+    "addchild", "array", "color", "compileshader", "connect", "createactor2d",
+    "createbutton", "createcommondialog", "createfiledialog", "createflexgrid",
+    "createinput", "createlabel", "createlistview", "createmenu", "createmscomm",
+    "createmultimeshinstance3d", "createparticles2d", "createparticles3d",
+    "createprogressbar", "createslider", "createsprite", "createsprite3d",
+    "createtext", "createtexturerect", "createtimer", "createtrigger", "date",
+    "day", "getaxis", "getcollider", "getcollisioncount", "getdelta",
+    "getglobalmousepos", "getjoyaxis", "getkey", "getmousepos",
+    "getmouseposition", "getmousex", "getmousey", "hascollided", "hour",
+    "instantiate", "isactionjustpressed", "isactionjustreleased",
+    "isactionpressed", "iskeydown", "iskeypressed", "ismousebuttondown",
+    "ismousebuttonpressed", "isnumeric", "isobject", "isonfloor", "load",
+    "loadshader", "loadsprite", "loadtexture", "loadtexture3d", "minute",
+    "month", "msgbox", "now", "rect2", "second", "shell", "sleep", "time",
+    "timer", "tweenproperty", "vector2", "vector3", "year",
+};
+static constexpr int evaluator_intrinsic_table_size = sizeof(evaluator_intrinsic_table) / sizeof(evaluator_intrinsic_table[0]);
+
+int get_evaluator_intrinsic_count() {
+    return evaluator_intrinsic_table_size;
+}
+
+const char *get_evaluator_intrinsic_name(int p_index) {
+    return p_index >= 0 && p_index < evaluator_intrinsic_table_size ? evaluator_intrinsic_table[p_index] : nullptr;
+}
+
+bool is_evaluator_intrinsic(const String &p_name) {
+    static const HashSet<String> names = [] {
+        HashSet<String> set;
+        for (const char *name : evaluator_intrinsic_table) {
+            set.insert(String(name));
         }
-        return Array();
+        return set;
+    }();
+    return names.has(p_name.to_lower());
+}
+
+bool get_expr_builtin_arity(int p_id, int &r_min_args, int &r_max_args) {
+    if (p_id >= 0 && p_id < builtin_table_size) {
+        r_min_args = builtin_table[p_id].min_args;
+        r_max_args = builtin_table[p_id].max_args;
+        return true;
     }
-    
-    if (METHOD_IS("values") && args.size() == 1) {
-        r_handled = true;
-        Variant input = args[0];
-        if (input.get_type() == Variant::DICTIONARY) {
-            Dictionary dict = input;
-            return dict.values();
-        }
-        return Array();
+    if (p_id >= builtin_table_size && p_id < builtin_table_size + expr_builtin_table_size) {
+        r_min_args = expr_builtin_table[p_id - builtin_table_size].min_args;
+        r_max_args = expr_builtin_table[p_id - builtin_table_size].max_args;
+        return true;
     }
-    
-    if (METHOD_IS("haskey") && args.size() == 2) {
-        r_handled = true;
-        Variant input = args[0];
-        Variant key = args[1];
-        if (input.get_type() == Variant::DICTIONARY) {
-            Dictionary dict = input;
-            return dict.has(key);
+    return false;
+}
+
+// Mid and Round have always ignored arguments past their last one.
+static bool ignores_surplus_args(int p_id) {
+    static const int mid_id = find_builtin_id("mid");
+    static const int round_id = find_builtin_id("round");
+    return p_id == mid_id || p_id == round_id;
+}
+
+Variant call_builtin_expr_by_id(VisualGasicInstance *instance, int p_id, const Array &p_args, bool &r_handled) {
+    r_handled = false;
+    int argc = p_args.size();
+    if (p_id >= 0 && p_id < builtin_table_size) {
+        const BuiltinInfo &info = builtin_table[p_id];
+        if (argc < info.min_args) {
+            return Variant();
         }
-        return false;
-    }
-    
-    if (METHOD_IS("dictmerge") && args.size() == 2) {
-        r_handled = true;
-        Variant input1 = args[0];
-        Variant input2 = args[1];
-        
-        if (input1.get_type() == Variant::DICTIONARY && input2.get_type() == Variant::DICTIONARY) {
-            Dictionary dict1 = input1;
-            Dictionary dict2 = input2;
-            Dictionary merged = dict1.duplicate();
-            
-            Array keys2 = dict2.keys();
-            for (int i = 0; i < keys2.size(); i++) {
-                merged[keys2[i]] = dict2[keys2[i]];
+        if (argc > info.max_args) {
+            if (!ignores_surplus_args(p_id)) {
+                return Variant();
             }
-            return merged;
+            argc = info.max_args;
         }
-        return input1;
-    }
-    
-    if (METHOD_IS("dictremove") && args.size() == 2) {
-        r_handled = true;
-        Variant input = args[0];
-        Variant key = args[1];
-        
-        if (input.get_type() == Variant::DICTIONARY) {
-            Dictionary dict = input;
-            Dictionary new_dict = dict.duplicate();
-            new_dict.erase(key);
-            return new_dict;
+        Variant argv[BUILTIN_MAX_ARGS];
+        for (int i = 0; i < argc; i++) {
+            argv[i] = p_args[i];
         }
-        return input;
-    }
-    
-    if (METHOD_IS("dictclear") && args.size() == 1) {
         r_handled = true;
-        Variant input = args[0];
-        
-        if (input.get_type() == Variant::DICTIONARY) {
-            Dictionary dict = input;
-            Dictionary new_dict;
-            return new_dict;
-        }
-        return input;
+        return info.fn(instance, argv, argc);
     }
 
-    // Type Checking Functions
-    if (METHOD_IS("isarray") && args.size() == 1) {
-        r_handled = true;
-        return args[0].get_type() == Variant::ARRAY;
-    }
-    
-    if (METHOD_IS("isdict") && args.size() == 1) {
-        r_handled = true;
-        return args[0].get_type() == Variant::DICTIONARY;
+    int index = p_id - builtin_table_size;
+    if (index < 0 || index >= expr_builtin_table_size) {
+        return Variant();
     }
-    
-    if (METHOD_IS("isstring") && args.size() == 1) {
-        r_handled = true;
-        return args[0].get_type() == Variant::STRING;
+    const ExprBuiltinInfo &info = expr_builtin_table[index];
+    if (argc < info.min_args || argc > info.max_args) {
+        return Variant();
     }
-    
-    if (METHOD_IS("isnumber") && args.size() == 1) {
-        r_handled = true;
-        Variant::Type type = args[0].get_type();
-        return type == Variant::INT || type == Variant::FLOAT;
+    r_handled = true;
+    return info.fn(instance, p_args);
+}
+
+Variant call_builtin_expr(VisualGasicInstance *instance, CallExpression *call, bool &r_handled) {
+    r_handled = false;
+    if (!call) return Variant();
+
+    if (call->builtin_id == BUILTIN_UNRESOLVED) {
+        call->builtin_id = find_expr_builtin_id(call->method_name);
     }
-    
-    if (METHOD_IS("isnull") && args.size() == 1) {
-        r_handled = true;
-        return args[0].get_type() == Variant::NIL;
+    if (call->builtin_id < 0) {
+        return Variant(); // Not a builtin: the caller evaluates the arguments
     }
-    
-    if (METHOD_IS("typename") && args.size() == 1) {
-        r_handled = true;
-        return Variant::get_type_name(args[0].get_type());
+
+    Array args;
+    args.resize(call->arguments.size());
+    for (int i = 0; i < call->arguments.size(); i++) {
+        args[i] = instance->evaluate_expression_for_builtins(call->arguments[i]);
     }
+    return call_builtin_expr_by_id(instance, call->builtin_id, args, r_handled);
+}
 
-#undef METHOD_IS
-    return Variant();
+Variant call_builtin_expr_evaluated(VisualGasicInstance *instance, const String &p_method, const Array &p_args, bool &r_handled) {
+    return call_builtin_expr_by_id(instance, find_expr_builtin_id(p_method), p_args, r_handled);
 }
 
 bool call_builtin_for_base_variable(VisualGasicInstance *instance, const String &p_base_name, const String &p_method, const Array &p_args, Variant &r_ret) {
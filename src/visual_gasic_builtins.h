@@ -8,8 +8,51 @@
 using namespace godot;
 
 namespace VisualGasicBuiltins {
-    // Called for statement-level calls (CallStatement)
-    // Returns true if a builtin handled the call (r_found=true), and optionally writes a return value into r_ret.
+    // Value builtins with a fixed ID. The compiler resolves names to IDs and
+    // emits OP_CALL_BUILTIN, which calls `fn` directly on the VM stack slots.
+    // IDs are indices into a static table: append new entries, never reorder.
+    typedef Variant (*BuiltinFunction)(VisualGasicInstance *p_instance, const Variant *p_args, int p_argc);
+    struct BuiltinInfo {
+        const char *name; // Lower-case VB name
+        int min_args;
+        int max_args;
+        BuiltinFunction fn;
+    };
+
+    // Returns the ID for p_name (case-insensitive), or -1 if it is not a table builtin.
+    int find_builtin_id(const String &p_name);
+    // Like find_builtin_id, but also -1 when p_argc is outside the builtin's arity.
+    int find_builtin_id(const String &p_name, int p_argc);
+    const BuiltinInfo *get_builtin_info(int p_id);
+    int get_builtin_count();
+
+    // Expression builtins: every function call_builtin_expr_evaluated knows,
+    // the table builtins above included (same IDs). Call sites resolve the
+    // name once and keep the ID (CallExpression::builtin_id for the AST,
+    // BytecodeChunk::constant_builtin_ids for OP_CALL); dispatch by ID is a
+    // table jump. These IDs are not stable across builds.
+    static constexpr int BUILTIN_UNRESOLVED = -2; // Call-site cache not filled yet
+    // Returns the ID for p_name (case-insensitive), or -1 if it is not a builtin.
+    int find_expr_builtin_id(const String &p_name);
+    int get_expr_builtin_count();
+    const char *get_expr_builtin_name(int p_id);
+    // r_max_args is INT_MAX for builtins without an upper limit.
+    bool get_expr_builtin_arity(int p_id, int &r_min_args, int &r_max_args);
+
+    // Names the call chain in VisualGasicInstance::evaluate_expression
+    // handles itself (lower-case), none of them expression builtins. The
+    // binder never binds them to a Sub and the evaluator skips the chain for
+    // any other name.
+    int get_evaluator_intrinsic_count();
+    const char *get_evaluator_intrinsic_name(int p_index);
+    bool is_evaluator_intrinsic(const String &p_name); // Case-insensitive
+    // Sets r_handled to false, without calling anything, if p_id is -1 or the
+    // argument count is outside the builtin's arity.
+    Variant call_builtin_expr_by_id(VisualGasicInstance *instance, int p_id, const Array &p_args, bool &r_handled);
+
+    // Called for statement-level calls the binder did not resolve (the VM's
+    // OP_CALL fallback): runs the command of that name (visual_gasic_commands.h).
+    // Returns true if one handled the call (r_found=true); r_ret is always Nil.
     bool call_builtin(VisualGasicInstance *instance, const String &p_method, const Array &p_args, Variant &r_ret, bool &r_found);
 
     // Called for expression-level calls (CallExpression)
@@ -1,6 +1,7 @@
 #ifndef VISUAL_GASIC_BYTECODE_H
 #define VISUAL_GASIC_BYTECODE_H
 
+#include "visual_gasic_global_slots.h"
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/variant/variant.hpp>
 #include <godot_cpp/variant/string.hpp>
@@ -9,9 +10,19 @@
 
 using namespace godot;
 
+// Instruction format version, bumped whenever encodings change so stale
+// chunks are rejected instead of misread.
+//
+// Version 2: operands are one byte, jump offsets are 16-bit big-endian.
+// An OP_WIDE [B1] [B0] prefix extends the next instruction: its first index
+// operand becomes (B1 << 16 | B0 << 8 | operand) and a jump offset becomes
+// (B1 << 24 | B0 << 16 | offset). Constant loads past 255 use
+// OP_CONSTANT_LONG; larger indices, local slots and long jumps use OP_WIDE.
+static constexpr uint32_t VG_BYTECODE_FORMAT_VERSION = 2;
+
 enum OpCode {
     OP_CONSTANT,      // [OP] [CONST_IDX] - Load constant
-    OP_CONSTANT_LONG, // [OP] [CONST_IDX_LO] [CONST_IDX_HI] (future proofing)
+    OP_CONSTANT_LONG, // [OP] [CONST_IDX_HI] [CONST_IDX_LO]
     OP_POP,      // [OP] - Pop stack
     
     // Variables
@@ -122,10 +133,60 @@ enum OpCode {
     // Literals
     OP_NIL,
     OP_TRUE,
-    OP_FALSE
+    OP_FALSE,
+
+    // Direct calls to Subs/Functions of the same module
+    OP_CALL_USER,      // [OP] [SUB_IDX] [ARG_COUNT] (args on stack, SUB_IDX into module subs)
+
+    // Operand extension (format version 2)
+    OP_WIDE,           // [OP] [B1] [B0] - high bits for the next instruction's first operand
+
+    // Register tier: three-address ops on unboxed local slots (see local_regs).
+    // Operands are local slots unless noted; never prefixed by OP_WIDE.
+    OP_R_LOADK_I64,        // [OP] [DST] [CONST_IDX]
+    OP_R_LOADK_F64,        // [OP] [DST] [CONST_IDX]
+    OP_R_MOV,              // [OP] [DST] [SRC]
+    OP_R_I64_TO_F64,       // [OP] [DST] [SRC]
+    OP_R_ADD_I64,          // [OP] [DST] [A] [B]
+    OP_R_SUB_I64,
+    OP_R_MUL_I64,
+    OP_R_ADDK_I64,         // [OP] [DST] [A] [CONST_IDX]
+    OP_R_SUBK_I64,
+    OP_R_MULK_I64,
+    OP_R_ADD_F64,          // [OP] [DST] [A] [B]
+    OP_R_SUB_F64,
+    OP_R_MUL_F64,
+    OP_R_DIV_F64,
+    OP_R_INC_I64,          // [OP] [SLOT]
+    OP_R_JUMP_IF_NOT_I64,  // [OP] [CMP] [A] [B] [OFFSET_16] - jump unless A cmp B
+    OP_R_JUMP_IF_NOT_I64K, // [OP] [CMP] [A] [CONST_IDX] [OFFSET_16]
+    OP_R_GET_ARRAY_I64,    // [OP] [DST] [ARRAY_SLOT] [IDX] - ARRAY_SLOT is a Variant local
+    OP_R_GET_ARRAY_F64,
+    OP_R_GET_ARRAY_I64_GUARDED, // Same, index range already checked by OP_R_GUARD_ARRAY
+    OP_R_GET_ARRAY_F64_GUARDED,
+    OP_R_GUARD_ARRAY,      // [OP] [ARRAY_SLOT] [LO] [HI] [CONST_IDX] - fail the run unless
+                           // ARRAY(LO + K .. HI + K) is in range (passes when LO > HI)
+};
+
+// Comparison selector for OP_R_JUMP_IF_NOT_I64(K).
+enum RegCompare : uint8_t {
+    RCMP_EQ,
+    RCMP_NE,
+    RCMP_LT,
+    RCMP_LE,
+    RCMP_GT,
+    RCMP_GE,
+};
+
+// Unboxed storage for register-tier locals; the chunk's local_regs says
+// which member is live for each slot.
+union VMRegister {
+    int64_t i;
+    double f;
 };
 
 struct BytecodeChunk {
+    uint32_t format_version = VG_BYTECODE_FORMAT_VERSION;
     Vector<uint8_t> code;
     Vector<Variant> constants;
     Vector<int> lines; // Line number per byte (RLE compressed ideally, but flat for now)
@@ -133,6 +194,41 @@ struct BytecodeChunk {
     Vector<uint8_t> local_types;
     int local_count = 0;
 
+    // GlobalSlotTable slots for name constants and named locals, filled
+    // lazily by the VM and validated on use.
+    Vector<SlotHint> constant_slot_hints;
+    Vector<SlotHint> local_slot_hints;
+    // Expression builtin ID per name constant called through OP_CALL, filled
+    // lazily by the VM (-2 = not resolved yet, -1 = not a builtin).
+    Vector<int> constant_builtin_ids;
+
+    // Call frame layout. When param_count >= 0 the parameters occupy local
+    // slots 0..param_count-1 and OP_CALL_USER binds arguments straight into
+    // them; -1 means the Sub must be entered through call_internal (ParamArray).
+    enum ParamKind : uint8_t {
+        PARAM_ANY,
+        PARAM_INT,
+        PARAM_FLOAT,
+        PARAM_STRING,
+        PARAM_BOOL,
+    };
+    Vector<uint8_t> param_kinds;
+    int param_count = -1;
+    int return_slot = -1;              // Local holding the Function result
+    Vector<uint8_t> local_frame_only;  // 1 = never mirrored to a global slot
+
+    // Register tier. Frame-only locals whose type the compiler proved stable
+    // (every write is an Integer/Long or Single/Double expression) are kept
+    // unboxed in VMRegister storage instead of a Variant. Missing entries
+    // mean REG_NONE.
+    enum RegKind : uint8_t {
+        REG_NONE,
+        REG_I64,
+        REG_F64,
+    };
+    Vector<uint8_t> local_regs;
+    bool vm_call_failed = false;       // Set once a direct call failed; later calls use call_internal
+
     void write(uint8_t byte, int line) {
         code.push_back(byte);
         lines.push_back(line); // Simplify mapping 1:1 for now
@@ -147,9 +243,7 @@ struct BytecodeChunk {
 struct VMState {
     int ip; // Instruction Pointer
     std::vector<Variant> stack;
-    
-    // Call Frame info usually needed here for recursion
-    // For now we can assume flat execution or use C++ recursion for calls
+    int call_depth = 0; // OP_CALL_USER frames live across nested execute_bytecode runs
 };
 
 #endif
@@ -0,0 +1,376 @@
+#include "visual_gasic_bytecode_cache.h"
+#include "visual_gasic_compiler.h"
+#include "visual_gasic_builtins.h"
+
+#include <cstring>
+#include <vector>
+
+namespace {
+
+enum CachedConstantTag : uint8_t {
+    CONST_NIL,
+    CONST_BOOL,
+    CONST_INT,
+    CONST_FLOAT,
+    CONST_STRING,
+    CONST_VARIANT, // Anything else, through var_to_bytes
+};
+
+struct ModuleWriter {
+    std::vector<uint8_t> out;
+
+    void u8(uint8_t v) { out.push_back(v); }
+    void u32(uint32_t v) {
+        for (int i = 0; i < 4; i++) {
+            out.push_back((uint8_t)(v >> (8 * i)));
+        }
+    }
+    void u64(uint64_t v) {
+        for (int i = 0; i < 8; i++) {
+            out.push_back((uint8_t)(v >> (8 * i)));
+        }
+    }
+    void bytes(const uint8_t *p_data, int64_t p_size) {
+        u32((uint32_t)p_size);
+        out.insert(out.end(), p_data, p_data + p_size);
+    }
+    void str(const String &s) {
+        CharString utf8 = s.utf8();
+        bytes((const uint8_t *)utf8.get_data(), utf8.length());
+    }
+    void byte_vector(const Vector<uint8_t> &v) {
+        bytes(v.ptr(), v.size());
+    }
+};
+
+struct ModuleReader {
+    const uint8_t *data;
+    int64_t size;
+    int64_t pos = 0;
+    bool ok = true;
+
+    bool need(int64_t n) {
+        if (!ok || n < 0 || pos + n > size) {
+            ok = false;
+        }
+        return ok;
+    }
+    uint8_t u8() {
+        return need(1) ? data[pos++] : 0;
+    }
+    uint32_t u32() {
+        if (!need(4)) {
+            return 0;
+        }
+        uint32_t v = 0;
+        for (int i = 0; i < 4; i++) {
+            v |= (uint32_t)data[pos++] << (8 * i);
+        }
+        return v;
+    }
+    uint64_t u64() {
+        if (!need(8)) {
+            return 0;
+        }
+        uint64_t v = 0;
+        for (int i = 0; i < 8; i++) {
+            v |= (uint64_t)data[pos++] << (8 * i);
+        }
+        return v;
+    }
+    // Reads a length prefix; returns a pointer into the buffer and skips that many bytes.
+    const uint8_t *span(uint32_t &r_len) {
+        r_len = u32();
+        if (!need(r_len)) {
+            return nullptr;
+        }
+        const uint8_t *p = data + pos;
+        pos += r_len;
+        return p;
+    }
+    String str() {
+        uint32_t len = 0;
+        const uint8_t *p = span(len);
+        return p ? String::utf8((const char *)p, len) : String();
+    }
+    void byte_vector(Vector<uint8_t> &r_out) {
+        uint32_t len = 0;
+        const uint8_t *p = span(len);
+        r_out.resize(p ? len : 0);
+        if (p && len > 0) {
+            memcpy(r_out.ptrw(), p, len);
+        }
+    }
+};
+
+void write_constant(ModuleWriter &w, const Variant &v) {
+    switch (v.get_type()) {
+        case Variant::NIL:
+            w.u8(CONST_NIL);
+            break;
+        case Variant::BOOL:
+            w.u8(CONST_BOOL);
+            w.u8((bool)v ? 1 : 0);
+            break;
+        case Variant::INT:
+            w.u8(CONST_INT);
+            w.u64((uint64_t)(int64_t)v);
+            break;
+        case Variant::FLOAT: {
+            double d = v;
+            uint64_t bits;
+            memcpy(&bits, &d, sizeof(bits));
+            w.u8(CONST_FLOAT);
+            w.u64(bits);
+        } break;
+        case Variant::STRING:
+            w.u8(CONST_STRING);
+            w.str(v);
+            break;
+        default: {
+            PackedByteArray encoded = UtilityFunctions::var_to_bytes(v);
+            w.u8(CONST_VARIANT);
+            w.bytes(encoded.ptr(), encoded.size());
+        } break;
+    }
+}
+
+Variant read_constant(ModuleReader &r) {
+    switch (r.u8()) {
+        case CONST_NIL:
+            return Variant();
+        case CONST_BOOL:
+            return r.u8() != 0;
+        case CONST_INT:
+            return (int64_t)r.u64();
+        case CONST_FLOAT: {
+            uint64_t bits = r.u64();
+            double d;
+            memcpy(&d, &bits, sizeof(d));
+            return d;
+        }
+        case CONST_STRING:
+            return r.str();
+        case CONST_VARIANT: {
+            uint32_t len = 0;
+            const uint8_t *p = r.span(len);
+            if (!p) {
+                return Variant();
+            }
+            PackedByteArray encoded;
+            encoded.resize(len);
+            memcpy(encoded.ptrw(), p, len);
+            return UtilityFunctions::bytes_to_var(encoded);
+        }
+        default:
+            r.ok = false;
+            return Variant();
+    }
+}
+
+void write_chunk(ModuleWriter &w, const BytecodeChunk &chunk) {
+    w.byte_vector(chunk.code);
+
+    // chunk.lines has one entry per code byte; store it as runs.
+    Vector<int> runs;
+    for (int i = 0; i < chunk.lines.size(); i++) {
+        if (runs.size() > 0 && runs[runs.size() - 2] == chunk.lines[i]) {
+            runs.write[runs.size() - 1]++;
+        } else {
+            runs.push_back(chunk.lines[i]);
+            runs.push_back(1);
+        }
+    }
+    w.u32(runs.size() / 2);
+    for (int i = 0; i < runs.size(); i++) {
+        w.u32((uint32_t)runs[i]);
+    }
+
+    w.u32(chunk.constants.size());
+    for (int i = 0; i < chunk.constants.size(); i++) {
+        write_constant(w, chunk.constants[i]);
+    }
+
+    w.u32(chunk.local_count);
+    w.u32(chunk.local_names.size());
+    for (int i = 0; i < chunk.local_names.size(); i++) {
+        w.str(chunk.local_names[i]);
+    }
+    w.byte_vector(chunk.local_types);
+    w.byte_vector(chunk.local_frame_only);
+    w.byte_vector(chunk.local_regs);
+
+    w.u32((uint32_t)chunk.param_count);
+    w.byte_vector(chunk.param_kinds);
+    w.u32((uint32_t)chunk.return_slot);
+}
+
+bool read_chunk(ModuleReader &r, BytecodeChunk &chunk) {
+    r.byte_vector(chunk.code);
+
+    uint32_t run_count = r.u32();
+    if (!r.need((int64_t)run_count * 8)) {
+        return false;
+    }
+    chunk.lines.resize(chunk.code.size());
+    int *lines = chunk.lines.ptrw();
+    int64_t filled = 0;
+    for (uint32_t i = 0; i < run_count; i++) {
+        int line = (int)r.u32();
+        uint32_t run = r.u32();
+        if (filled + run > chunk.code.size()) {
+            return false;
+        }
+        for (uint32_t j = 0; j < run; j++) {
+            lines[filled++] = line;
+        }
+    }
+    if (filled != chunk.code.size()) {
+        return false;
+    }
+
+    uint32_t constant_count = r.u32();
+    if (!r.need(constant_count)) {
+        return false;
+    }
+    chunk.constants.resize(constant_count);
+    for (uint32_t i = 0; i < constant_count && r.ok; i++) {
+        chunk.constants.write[i] = read_constant(r);
+    }
+
+    chunk.local_count = (int)r.u32();
+    uint32_t name_count = r.u32();
+    if (!r.need((int64_t)name_count * 4)) {
+        return false;
+    }
+    chunk.local_names.resize(name_count);
+    for (uint32_t i = 0; i < name_count && r.ok; i++) {
+        chunk.local_names.write[i] = r.str();
+    }
+    r.byte_vector(chunk.local_types);
+    r.byte_vector(chunk.local_frame_only);
+    r.byte_vector(chunk.local_regs);
+
+    chunk.param_count = (int)(int32_t)r.u32();
+    r.byte_vector(chunk.param_kinds);
+    chunk.return_slot = (int)(int32_t)r.u32();
+    return r.ok;
+}
+
+} // namespace
+
+uint64_t BytecodeCache::config_hash() {
+    static const uint64_t hash = [] {
+        ModuleWriter w;
+        w.u32(VG_COMPILER_VERSION);
+        w.u32(VG_BYTECODE_FORMAT_VERSION);
+        int count = VisualGasicBuiltins::get_builtin_count();
+        w.u32(count);
+        for (int i = 0; i < count; i++) {
+            const VisualGasicBuiltins::BuiltinInfo *info = VisualGasicBuiltins::get_builtin_info(i);
+            w.bytes((const uint8_t *)info->name, strlen(info->name));
+            w.u32(info->min_args);
+            w.u32(info->max_args);
+        }
+        return SourceHash::compute_bytes(w.out.data(), w.out.size());
+    }();
+    return hash;
+}
+
+PackedByteArray BytecodeCache::encode_module(const ModuleKey& key, const Vector<CachedModuleEntry>& p_entries) {
+    ModuleWriter w;
+    w.u8('V');
+    w.u8('G');
+    w.u8('B');
+    w.u8('C');
+    w.u32(VG_MODULE_CACHE_VERSION);
+    w.u64(key.source_hash);
+    w.u64(key.config_hash);
+    w.u32(key.dependencies.size());
+    for (int i = 0; i < key.dependencies.size(); i++) {
+        w.str(key.dependencies[i].path);
+        w.u64(key.dependencies[i].hash);
+    }
+    w.u32(p_entries.size());
+    for (int i = 0; i < p_entries.size(); i++) {
+        const CachedModuleEntry &entry = p_entries[i];
+        w.str(entry.name);
+        w.u8(entry.compiled ? 1 : 0);
+        if (entry.compiled) {
+            write_chunk(w, entry.chunk);
+        }
+    }
+
+    PackedByteArray buffer;
+    buffer.resize(w.out.size());
+    if (!w.out.empty()) {
+        memcpy(buffer.ptrw(), w.out.data(), w.out.size());
+    }
+    return buffer;
+}
+
+bool BytecodeCache::decode_module(const uint8_t* p_data, int64_t p_size, const ModuleKey& key, Vector<CachedModuleEntry>& r_entries) {
+    r_entries.clear();
+    ModuleReader r{ p_data, p_size };
+    bool magic = r.u8() == 'V' && r.u8() == 'G' && r.u8() == 'B' && r.u8() == 'C';
+    if (!magic || r.u32() != VG_MODULE_CACHE_VERSION || r.u64() != key.source_hash ||
+            r.u64() != key.config_hash || r.u32() != (uint32_t)key.dependencies.size()) {
+        return false;
+    }
+    // Includes are listed in the order they were resolved, so the lists
+    // match element for element when nothing changed.
+    for (int i = 0; i < key.dependencies.size(); i++) {
+        if (r.str() != key.dependencies[i].path || r.u64() != key.dependencies[i].hash) {
+            return false;
+        }
+    }
+
+    uint32_t entry_count = r.u32();
+    if (!r.need(entry_count)) {
+        return false;
+    }
+    Vector<CachedModuleEntry> entries;
+    entries.resize(entry_count);
+    for (uint32_t i = 0; i < entry_count; i++) {
+        CachedModuleEntry &entry = entries.write[i];
+        entry.name = r.str();
+        entry.compiled = r.u8() != 0;
+        if (entry.compiled && !read_chunk(r, entry.chunk)) {
+            return false;
+        }
+        if (!r.ok) {
+            return false;
+        }
+    }
+    r_entries = entries;
+    return true;
+}
+
+bool BytecodeCache::load_module(const String& source_file, const ModuleKey& key, Vector<CachedModuleEntry>& r_entries) const {
+    r_entries.clear();
+    String cache_file = get_cache_filename(source_file);
+    if (!FileAccess::file_exists(cache_file)) {
+        return false;
+    }
+    PackedByteArray data = FileAccess::get_file_as_bytes(cache_file);
+    return decode_module(data.ptr(), data.size(), key, r_entries);
+}
+
+bool BytecodeCache::save_module(const String& source_file, const ModuleKey& key, const Vector<CachedModuleEntry>& p_entries) const {
+    if (!DirAccess::dir_exists_absolute(cache_dir) && DirAccess::make_dir_recursive_absolute(cache_dir) != OK) {
+        return false;
+    }
+
+    // Write next to the target and rename, so a concurrent load never sees a
+    // half-written module.
+    String cache_file = get_cache_filename(source_file);
+    String temp_file = cache_file + ".tmp";
+    Ref<FileAccess> file = FileAccess::open(temp_file, FileAccess::WRITE);
+    if (!file.is_valid()) {
+        UtilityFunctions::printerr("Failed to open cache file: ", temp_file);
+        return false;
+    }
+    file->store_buffer(encode_module(key, p_entries));
+    file->close();
+    return DirAccess::rename_absolute(temp_file, cache_file) == OK;
+}
@@ -1,132 +1,102 @@
 #ifndef VISUAL_GASIC_BYTECODE_CACHE_H
 #define VISUAL_GASIC_BYTECODE_CACHE_H
 
+#include "visual_gasic_bytecode.h"
+#include "visual_gasic_source_hash.h"
 #include <godot_cpp/core/class_db.hpp>
-#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/vector.hpp>
 #include <godot_cpp/variant/string.hpp>
+#include <godot_cpp/classes/dir_access.hpp>
 #include <godot_cpp/classes/file_access.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 
 using namespace godot;
 
-// Simple hash of source code for cache validation
-class SourceHash {
-public:
-    static uint64_t compute(const String& source) {
-        uint64_t hash = 5381;
-        for (int i = 0; i < source.length(); i++) {
-            hash = ((hash << 5) + hash) + source[i];
-        }
-        return hash;
-    }
+// Serialized module (.vgc) format. One file holds every entry point of a
+// script that has been compiled so far; it is read back in a single bulk
+// read and decoded from memory. All integers are little-endian.
+//
+//   "VGBC" u32 VG_MODULE_CACHE_VERSION u64 source_hash u64 config_hash
+//   u32 dependency_count dependency_count x { str path, u64 hash }
+//   u32 entry_count entry_count x { str name, u8 compiled, chunk (compiled entries only) }
+//
+// A chunk is its code bytes, the line table as (line, run) pairs, the
+// constant pool (one type tag per constant), local names/types and the call
+// frame layout. Runtime-only fields (slot hints, vm_call_failed) are not
+// stored. Bump VG_MODULE_CACHE_VERSION when this layout changes.
+static constexpr uint32_t VG_MODULE_CACHE_VERSION = 2;
+
+// A file whose text went into the module (an Include), with the hash of the
+// text that was compiled; 0 marks an Include that was missing.
+struct ModuleDependency {
+    String path;
+    uint64_t hash = 0;
+};
+
+// What a cached module must match to be reused: the script's own source,
+// the compiler configuration (see BytecodeCache::config_hash) and every
+// dependency. Each script has its own cache file, so editing an Include only
+// invalidates the modules that list it.
+struct ModuleKey {
+    uint64_t source_hash = 0;
+    uint64_t config_hash = 0;
+    Vector<ModuleDependency> dependencies;
+};
+
+// One entry point of a cached module. compiled == false records a Sub the
+// compiler rejected, so a warm start does not retry it either.
+struct CachedModuleEntry {
+    String name;
+    bool compiled = false;
+    BytecodeChunk chunk;
 };
 
 class BytecodeCache {
 private:
     String cache_dir;
-    HashMap<String, uint64_t> source_hashes; // filename -> source hash
 
 public:
-    BytecodeCache(const String& p_cache_dir = "user://visualgasic_cache/") 
-        : cache_dir(p_cache_dir) {
-        // Create cache directory if it doesn't exist
-        Ref<DirAccess> dir = DirAccess::open(p_cache_dir.get_basename());
-        if (dir.is_valid() && !dir->dir_exists(p_cache_dir)) {
-            dir->make_dir(p_cache_dir);
-        }
-    }
-
-    // Generate cache filename from source filename
-    String get_cache_filename(const String& source_file) {
-        String filename = source_file.get_file();
-        return cache_dir + filename + ".vgc"; // VisualGasic Compiled
-    }
-
-    // Check if cached bytecode is valid
-    bool is_cached_valid(const String& source_file, const String& source_code) {
-        String cache_file = get_cache_filename(source_file);
-        
-        Ref<FileAccess> file = FileAccess::open(cache_file, FileAccess::READ);
-        if (!file.is_valid()) {
-            return false; // No cache file
-        }
-
-        // Read stored hash from file (first 8 bytes)
-        uint64_t stored_hash = file->get_64();
-        uint64_t current_hash = SourceHash::compute(source_code);
-
-        return stored_hash == current_hash;
+    BytecodeCache(const String& p_cache_dir = "user://visualgasic_cache/") {
+        set_cache_dir(p_cache_dir);
     }
 
-    // Save bytecode to cache
-    bool save_bytecode(const String& source_file, const String& source_code, 
-                       const Vector<uint8_t>& bytecode) {
-        String cache_file = get_cache_filename(source_file);
-
-        Ref<FileAccess> file = FileAccess::open(cache_file, FileAccess::WRITE);
-        if (!file.is_valid()) {
-            UtilityFunctions::printerr("Failed to open cache file: ", cache_file);
-            return false;
-        }
-
-        // Write source hash
-        uint64_t hash = SourceHash::compute(source_code);
-        file->store_64(hash);
-
-        // Write bytecode length
-        file->store_32(bytecode.size());
-
-        // Write bytecode
-        // Convert Vector<uint8_t> to PackedByteArray
-        PackedByteArray pba;
-        pba.resize(bytecode.size());
-        for (int i = 0; i < bytecode.size(); i++) {
-            pba[i] = bytecode[i];
-        }
-        file->store_buffer(pba);
-
-        return true;
+    // Cache filename for a source path. The file name keeps the cache
+    // directory readable; the hash of the full path keeps main.vg in two
+    // folders apart.
+    String get_cache_filename(const String& source_file) const {
+        String path_hash = String::num_uint64(SourceHash::compute(source_file), 16);
+        return cache_dir + source_file.get_file() + "-" + path_hash + ".vgc"; // VisualGasic Compiled
     }
 
-    // Load bytecode from cache
-    bool load_bytecode(const String& source_file, Vector<uint8_t>& out_bytecode) {
-        String cache_file = get_cache_filename(source_file);
-
-        Ref<FileAccess> file = FileAccess::open(cache_file, FileAccess::READ);
-        if (!file.is_valid()) {
-            return false;
-        }
-
-        // Skip hash (already validated)
-        file->get_64();
+    // Hash of everything besides the source that decides what the compiler
+    // emits: compiler and bytecode format versions and the builtin table
+    // (names, arities and order, since IDs are baked into OP_CALL_BUILTIN).
+    static uint64_t config_hash();
 
-        // Read bytecode length
-        uint32_t length = file->get_32();
+    // Reads the module cached for source_file. Returns false when there is
+    // no cache file, any part of its key differs from `key`, or it is
+    // truncated; r_entries is left empty in that case.
+    bool load_module(const String& source_file, const ModuleKey& key, Vector<CachedModuleEntry>& r_entries) const;
 
-        // Read bytecode
-        PackedByteArray pba = file->get_buffer(length);
-        out_bytecode.clear();
-        for (int i = 0; i < pba.size(); i++) {
-            out_bytecode.push_back(pba[i]);
-        }
+    // Replaces the module cached for source_file with p_entries.
+    bool save_module(const String& source_file, const ModuleKey& key, const Vector<CachedModuleEntry>& p_entries) const;
 
-        return true;
-    }
+    // Encoding without file I/O, used by the two calls above and the tests.
+    static PackedByteArray encode_module(const ModuleKey& key, const Vector<CachedModuleEntry>& p_entries);
+    static bool decode_module(const uint8_t* p_data, int64_t p_size, const ModuleKey& key, Vector<CachedModuleEntry>& r_entries);
 
     // Clear cache for a specific file
     void clear_cache(const String& source_file) {
         String cache_file = get_cache_filename(source_file);
-        Ref<DirAccess> dir = DirAccess::open(cache_dir);
-        
-        if (dir.is_valid() && dir->file_exists(cache_file)) {
-            dir->remove(cache_file);
+        if (FileAccess::file_exists(cache_file)) {
+            DirAccess::remove_absolute(cache_file);
         }
     }
 
     // Clear entire cache directory
     void clear_all() {
         Ref<DirAccess> dir = DirAccess::open(cache_dir);
-        
+
         if (dir.is_valid()) {
             dir->list_dir_begin();
             String file = dir->get_next();
@@ -0,0 +1,81 @@
+#include "visual_gasic_commands.h"
+#include <godot_cpp/templates/hash_map.hpp>
+#include <vector>
+
+using namespace godot;
+
+namespace VisualGasicCommands {
+
+namespace {
+
+struct CommandRegistry {
+    std::vector<CommandInfo> commands;
+    HashMap<String, int> by_name; // Lower-case name -> ID
+};
+
+void add_commands(CommandRegistry &r_registry, const CommandInfo *p_commands, int p_count) {
+    for (int i = 0; i < p_count; i++) {
+        String key = String(p_commands[i].name).to_lower();
+        if (r_registry.by_name.has(key)) {
+            continue;
+        }
+        r_registry.by_name.insert(key, (int)r_registry.commands.size());
+        r_registry.commands.push_back(p_commands[i]);
+    }
+}
+
+typedef const CommandInfo *(*ModuleTable)(int &r_count);
+
+// Starts out with the built-in modules; register_commands appends to it.
+CommandRegistry &get_registry() {
+    static CommandRegistry registry = [] {
+        CommandRegistry builtin;
+        const ModuleTable modules[] = { get_system_commands, get_game_commands, get_graphics_commands };
+        for (ModuleTable module : modules) {
+            int count = 0;
+            const CommandInfo *commands = module(count);
+            add_commands(builtin, commands, count);
+        }
+        return builtin;
+    }();
+    return registry;
+}
+
+} // namespace
+
+void register_commands(const CommandInfo *p_commands, int p_count) {
+    add_commands(get_registry(), p_commands, p_count);
+}
+
+int find_command_id(const String &p_name) {
+    const int *id = get_registry().by_name.getptr(p_name.to_lower());
+    return id ? *id : -1;
+}
+
+const CommandInfo *get_command_info(int p_id) {
+    CommandRegistry &registry = get_registry();
+    if (p_id < 0 || p_id >= (int)registry.commands.size()) {
+        return nullptr;
+    }
+    return &registry.commands[p_id];
+}
+
+int get_command_count() {
+    return (int)get_registry().commands.size();
+}
+
+bool call_command(VisualGasicInstance *p_instance, int p_id, const Array &p_args) {
+    const CommandInfo *info = get_command_info(p_id);
+    int argc = p_args.size();
+    if (!info || argc < info->min_args || argc > info->max_args) {
+        return false;
+    }
+    info->fn(p_instance, p_args);
+    return true;
+}
+
+bool call_command(VisualGasicInstance *p_instance, const String &p_name, const Array &p_args) {
+    return call_command(p_instance, find_command_id(p_name), p_args);
+}
+
+} // namespace VisualGasicCommands
@@ -0,0 +1,55 @@
+#ifndef VISUAL_GASIC_COMMANDS_H
+#define VISUAL_GASIC_COMMANDS_H
+
+// Statement-level commands: calls such as `CLS`, `DrawLine 0, 0, 10, 10` or
+// `PlaySound "res://hit.wav"` that name neither a user Sub nor a Declare.
+// Each command module registers a table of them; the registry hashes the
+// names once, and the binder resolves every CallStatement without a base
+// object to a command ID (BIND_COMMAND) after Class methods, Declares and
+// module Subs. Running a command is then an index and an arity check, so
+// statement calls cost the same however many commands there are.
+
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/string.hpp>
+#include <climits>
+
+using namespace godot;
+
+class VisualGasicInstance;
+
+namespace VisualGasicCommands {
+    static constexpr int COMMAND_VARIADIC = INT_MAX;
+
+    typedef void (*CommandFunction)(VisualGasicInstance *p_instance, const Array &p_args);
+    struct CommandInfo {
+        const char *name; // VB name; matched case-insensitively
+        int min_args;
+        int max_args; // COMMAND_VARIADIC for no upper limit
+        CommandFunction fn;
+    };
+
+    // Adds a module's commands to the registry; a name already registered
+    // keeps its first entry. IDs are handed out in registration order and
+    // stay valid for the life of the process. Register before binding the
+    // scripts that use them (the binder resolves names, not the interpreter).
+    void register_commands(const CommandInfo *p_commands, int p_count);
+
+    // The built-in modules' tables, registered ahead of any other module the
+    // first time the registry is used.
+    const CommandInfo *get_system_commands(int &r_count);   // Files, settings, dialogs, processes
+    const CommandInfo *get_game_commands(int &r_count);     // Scenes, physics, AI, audio, menus, window
+    const CommandInfo *get_graphics_commands(int &r_count); // Immediate drawing, 3D primitives, CLS
+
+    // Returns the ID for p_name (case-insensitive), or -1 if it is not a command.
+    int find_command_id(const String &p_name);
+    const CommandInfo *get_command_info(int p_id);
+    int get_command_count();
+
+    // Runs command p_id and returns true, or returns false without running
+    // it if p_id is -1 or the argument count is outside the command's arity;
+    // the caller then treats the call as a method of the owner.
+    bool call_command(VisualGasicInstance *p_instance, int p_id, const Array &p_args);
+    bool call_command(VisualGasicInstance *p_instance, const String &p_name, const Array &p_args);
+}
+
+#endif // VISUAL_GASIC_COMMANDS_H
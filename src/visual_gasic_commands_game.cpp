@@ -0,0 +1,385 @@
+// Game commands: scenes and signals, physics, AI, animation, audio, menus
+// and the window.
+
+#include "visual_gasic_commands.h"
+#include "visual_gasic_instance.h"
+#include "gasic_ai_controller.h"
+#include <godot_cpp/classes/audio_stream.hpp>
+#include <godot_cpp/classes/audio_stream_player.hpp>
+#include <godot_cpp/classes/audio_stream_wav.hpp>
+#include <godot_cpp/classes/character_body2d.hpp>
+#include <godot_cpp/classes/character_body3d.hpp>
+#include <godot_cpp/classes/node.hpp>
+#include <godot_cpp/classes/packed_scene.hpp>
+#include <godot_cpp/classes/popup_menu.hpp>
+#include <godot_cpp/classes/resource_loader.hpp>
+#include <godot_cpp/classes/rigid_body2d.hpp>
+#include <godot_cpp/classes/rigid_body3d.hpp>
+#include <godot_cpp/classes/scene_tree.hpp>
+#include <godot_cpp/classes/tween.hpp>
+#include <godot_cpp/classes/window.hpp>
+#include <godot_cpp/core/math.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+#include <cmath>
+#include <cstdlib>
+
+using namespace godot;
+
+namespace VisualGasicCommands {
+
+namespace {
+
+Node *owner_node(VisualGasicInstance *p_instance) {
+    return Object::cast_to<Node>(p_instance->get_owner());
+}
+
+// Plays p_stream once from a player under the owner that frees itself.
+void play_once(VisualGasicInstance *p_instance, const Ref<AudioStream> &p_stream) {
+    Node *n = owner_node(p_instance);
+    if (!n) return;
+    AudioStreamPlayer *p = memnew(AudioStreamPlayer);
+    p->set_stream(p_stream);
+    p->set_autoplay(true);
+    p->connect("finished", Callable(p, "queue_free"));
+    n->add_child(p);
+}
+
+// Connect object, "signal", "HandlerSub"
+void cmd_connect(VisualGasicInstance *p_instance, const Array &args) {
+    Object *obj = args[0];
+    String signal_name = args[1];
+    Object *owner = p_instance->get_owner();
+    if (!obj || !owner) return;
+    if (obj->has_signal(signal_name)) {
+        Callable callable = Callable(owner, String(args[2]));
+        if (!obj->is_connected(signal_name, callable)) {
+            obj->connect(signal_name, callable);
+        }
+    } else {
+        UtilityFunctions::print("Runtime Warning: Signal '", signal_name, "' not found on object");
+    }
+}
+
+void cmd_changescene(VisualGasicInstance *p_instance, const Array &args) {
+    Node *n = owner_node(p_instance);
+    SceneTree *tree = n ? n->get_tree() : nullptr;
+    if (tree) {
+        tree->change_scene_to_file(String(args[0]));
+    }
+}
+
+// LoadForm "path.tscn": instances the scene under the scene tree's root.
+void cmd_loadform(VisualGasicInstance *p_instance, const Array &args) {
+    String path = args[0];
+    if (!path.begins_with("res://")) path = "res://" + path;
+
+    Ref<PackedScene> scene = ResourceLoader::get_singleton()->load(path);
+    if (!scene.is_valid()) {
+        p_instance->raise_runtime_error("Could not load form: " + path);
+        return;
+    }
+    Node *new_form = scene->instantiate();
+    Node *n = owner_node(p_instance);
+    // Outside the scene tree (headless tests) the form is not added.
+    if (n && n->is_inside_tree()) {
+        SceneTree *tree = n->get_tree();
+        if (tree && tree->get_root()) {
+            tree->get_root()->add_child(new_form);
+        }
+    }
+}
+
+void cmd_addchild(VisualGasicInstance *p_instance, const Array &args) {
+    Node *child = Object::cast_to<Node>((Object *)args[0]);
+    Node *parent = owner_node(p_instance);
+    if (child && parent) {
+        parent->add_child(child);
+        p_instance->track_dynamic_node(child);
+    }
+}
+
+// --- Physics ---
+
+void cmd_applyforce(VisualGasicInstance *, const Array &args) {
+    Object *obj = args[0];
+    if (!obj) return;
+    double x = args[1];
+    double y = args[2];
+    double z = args.size() >= 4 ? (double)args[3] : 0.0;
+    if (RigidBody2D *body = Object::cast_to<RigidBody2D>(obj)) {
+        body->apply_force(Vector2(x, y));
+    } else if (RigidBody3D *body3d = Object::cast_to<RigidBody3D>(obj)) {
+        body3d->apply_force(Vector3(x, y, z));
+    }
+}
+
+void cmd_applyimpulse(VisualGasicInstance *, const Array &args) {
+    Object *obj = args[0];
+    if (!obj) return;
+    double x = args[1];
+    double y = args[2];
+    double z = args.size() >= 4 ? (double)args[3] : 0.0;
+    if (RigidBody2D *body = Object::cast_to<RigidBody2D>(obj)) {
+        body->apply_impulse(Vector2(x, y));
+    } else if (RigidBody3D *body3d = Object::cast_to<RigidBody3D>(obj)) {
+        body3d->apply_impulse(Vector3(x, y, z));
+    }
+}
+
+void cmd_setvelocity(VisualGasicInstance *, const Array &args) {
+    Object *obj = args[0];
+    if (!obj) return;
+    double x = args[1];
+    double y = args[2];
+    double z = args.size() >= 4 ? (double)args[3] : 0.0;
+    if (RigidBody2D *rb2d = Object::cast_to<RigidBody2D>(obj)) {
+        rb2d->set_linear_velocity(Vector2(x, y));
+    } else if (RigidBody3D *rb3d = Object::cast_to<RigidBody3D>(obj)) {
+        rb3d->set_linear_velocity(Vector3(x, y, z));
+    } else if (CharacterBody2D *cb2d = Object::cast_to<CharacterBody2D>(obj)) {
+        cb2d->set_velocity(Vector2(x, y));
+    } else if (CharacterBody3D *cb3d = Object::cast_to<CharacterBody3D>(obj)) {
+        cb3d->set_velocity(Vector3(x, y, z));
+    }
+}
+
+void cmd_moveandslide(VisualGasicInstance *, const Array &args) {
+    Object *obj = args[0];
+    if (CharacterBody2D *cb2d = Object::cast_to<CharacterBody2D>(obj)) {
+        cb2d->move_and_slide();
+    } else if (CharacterBody3D *cb3d = Object::cast_to<CharacterBody3D>(obj)) {
+        cb3d->move_and_slide();
+    }
+}
+
+// --- AI ---
+
+// The GasicAIController child of p_enemy; created when p_create is set.
+GasicAIController *find_ai_controller(Object *p_enemy, bool p_create) {
+    Node *enemy_node = Object::cast_to<Node>(p_enemy);
+    if (!enemy_node) return nullptr;
+    TypedArray<Node> children = enemy_node->get_children();
+    for (int i = 0; i < children.size(); i++) {
+        Node *c = Object::cast_to<Node>(children[i]);
+        if (c && c->is_class("GasicAIController")) {
+            return Object::cast_to<GasicAIController>(c);
+        }
+    }
+    if (!p_create) return nullptr;
+    GasicAIController *ai = memnew(GasicAIController);
+    ai->set_name("GasicAI");
+    enemy_node->add_child(ai);
+    return ai;
+}
+
+// AI_Chase enemy, target, speed, [stop_distance]
+void cmd_ai_chase(VisualGasicInstance *, const Array &args) {
+    if (GasicAIController *ai = find_ai_controller(args[0], true)) {
+        ai->start_chase(args[1], args[2], args.size() >= 4 ? (double)args[3] : 0.0);
+    }
+}
+
+// AI_Wander enemy, speed, radius
+void cmd_ai_wander(VisualGasicInstance *, const Array &args) {
+    if (GasicAIController *ai = find_ai_controller(args[0], true)) {
+        ai->start_wander(args[1], args[2]);
+    }
+}
+
+// AI_Patrol enemy, points, speed, [loop]
+void cmd_ai_patrol(VisualGasicInstance *, const Array &args) {
+    if (GasicAIController *ai = find_ai_controller(args[0], true)) {
+        ai->start_patrol(args[1], args[2], args.size() >= 4 ? (bool)args[3] : false);
+    }
+}
+
+void cmd_ai_stop(VisualGasicInstance *, const Array &args) {
+    if (GasicAIController *ai = find_ai_controller(args[0], false)) {
+        ai->stop();
+    }
+}
+
+// --- Animation ---
+
+void cmd_tweenproperty(VisualGasicInstance *p_instance, const Array &args) {
+    Object *obj = args[0];
+    Node *n = owner_node(p_instance);
+    if (obj && n) {
+        Ref<Tween> t = n->create_tween();
+        t->tween_property(obj, NodePath(String(args[1])), args[2], (double)args[3]);
+    }
+}
+
+// Animate node, "Property", value, seconds: VB property names are mapped to
+// their Godot counterparts.
+void cmd_animate(VisualGasicInstance *, const Array &args) {
+    Node *n = Object::cast_to<Node>((Object *)args[0]);
+    if (!n) return;
+    String prop = args[1];
+    Variant val = args[2];
+    double dur = args[3];
+
+    String actual_prop = prop;
+    if (prop == "Left") actual_prop = "position:x";
+    if (prop == "Top") actual_prop = "position:y";
+    if (prop == "Width") actual_prop = "size:x";
+    if (prop == "Height") actual_prop = "size:y";
+    if (prop == "Caption") actual_prop = "text";
+    if (prop == "Value") actual_prop = "value";
+    if (n->is_class("Timer") && prop == "Interval") {
+        actual_prop = "wait_time";
+        val = (double)val / 1000.0;
+    }
+
+    Ref<Tween> tween = n->create_tween();
+    if (tween.is_valid()) {
+        tween->tween_property(n, actual_prop, val, dur);
+    }
+}
+
+// --- Audio ---
+
+// A mono 16-bit WAV of p_seconds of p_waveform (0 sine, 1 square,
+// 2 sawtooth, 3 noise); p_volume is the peak amplitude, up to 1.
+Ref<AudioStreamWAV> make_tone(double p_freq, double p_seconds, int p_waveform, double p_volume) {
+    const int mix_rate = 44100;
+    Ref<AudioStreamWAV> stream;
+    stream.instantiate();
+    stream->set_mix_rate(mix_rate);
+    stream->set_format(AudioStreamWAV::FORMAT_16_BITS);
+    stream->set_stereo(false);
+
+    int samples = (int)(p_seconds * mix_rate);
+    if (samples <= 0) return stream;
+    PackedByteArray data;
+    data.resize(samples * 2);
+    uint8_t *out = data.ptrw();
+    for (int i = 0; i < samples; ++i) {
+        double t = (double)i / mix_rate;
+        double val;
+        switch (p_waveform) {
+            case 1: val = (sin(2.0 * Math_PI * p_freq * t) > 0) ? 1.0 : -1.0; break;
+            case 2: val = 2.0 * (t * p_freq - floor(t * p_freq + 0.5)); break;
+            case 3: val = ((double)rand() / RAND_MAX) * 2.0 - 1.0; break;
+            default: val = sin(2.0 * Math_PI * p_freq * t); break;
+        }
+        int16_t sample = (int16_t)(val * p_volume * 32767.0);
+        out[i * 2] = (uint8_t)(sample & 0xFF);
+        out[i * 2 + 1] = (uint8_t)((sample >> 8) & 0xFF);
+    }
+    stream->set_data(data);
+    return stream;
+}
+
+void cmd_beep(VisualGasicInstance *p_instance, const Array &) {
+    play_once(p_instance, make_tone(880.0, 0.2, 0, 0.9));
+}
+
+// PlayTone frequency, milliseconds, [waveform]
+void cmd_playtone(VisualGasicInstance *p_instance, const Array &args) {
+    int waveform = args.size() >= 3 ? (int)args[2] : 0;
+    play_once(p_instance, make_tone((double)args[0], (double)args[1] / 1000.0, waveform, 0.5));
+}
+
+void cmd_playsound(VisualGasicInstance *p_instance, const Array &args) {
+    Ref<AudioStream> stream = ResourceLoader::get_singleton()->load(String(args[0]));
+    if (stream.is_valid()) {
+        play_once(p_instance, stream);
+    }
+}
+
+// The music player is remembered in the owner's __BG_MUSIC__ meta, so a new
+// PlayMusic replaces the old track.
+void stop_music(Node *p_owner) {
+    if (!p_owner->has_meta("__BG_MUSIC__")) return;
+    Node *old = Object::cast_to<Node>((Object *)p_owner->get_meta("__BG_MUSIC__"));
+    if (old) old->queue_free();
+    p_owner->remove_meta("__BG_MUSIC__");
+}
+
+void cmd_playmusic(VisualGasicInstance *p_instance, const Array &args) {
+    Ref<AudioStream> stream = ResourceLoader::get_singleton()->load(String(args[0]));
+    Node *n = owner_node(p_instance);
+    if (!stream.is_valid() || !n) return;
+    stop_music(n);
+    AudioStreamPlayer *p = memnew(AudioStreamPlayer);
+    p->set_stream(stream); // Looping is a property of the imported stream
+    p->set_autoplay(true);
+    n->add_child(p);
+    n->set_meta("__BG_MUSIC__", p);
+}
+
+void cmd_stopmusic(VisualGasicInstance *p_instance, const Array &) {
+    if (Node *n = owner_node(p_instance)) {
+        stop_music(n);
+    }
+}
+
+// --- Menus and window ---
+
+// AddMenuItem menu, "Text", "CallbackSub": the callback is stored as the
+// item's metadata and in the menu's "callbacks" meta; the menu's
+// id_pressed signal reaches the script through _OnSignal.
+void cmd_addmenuitem(VisualGasicInstance *p_instance, const Array &args) {
+    PopupMenu *pm = Object::cast_to<PopupMenu>((Object *)args[0]);
+    if (!pm) return;
+    String callback = args[2];
+    pm->add_item(String(args[1]));
+    int idx = pm->get_item_count() - 1;
+
+    Dictionary callback_map;
+    if (pm->has_meta("callbacks")) {
+        callback_map = pm->get_meta("callbacks");
+    } else {
+        pm->connect("id_pressed", Callable(p_instance->get_owner(), "_OnSignal").bind(pm->get_name(), "MenuClick"));
+    }
+    pm->set_item_metadata(idx, callback);
+    callback_map[idx] = callback;
+    pm->set_meta("callbacks", callback_map);
+}
+
+void cmd_settitle(VisualGasicInstance *p_instance, const Array &args) {
+    Node *n = owner_node(p_instance);
+    Window *w = n ? n->get_window() : nullptr;
+    if (w) w->set_title(String(args[0]));
+}
+
+void cmd_setscreensize(VisualGasicInstance *p_instance, const Array &args) {
+    Node *n = owner_node(p_instance);
+    Window *w = n ? n->get_window() : nullptr;
+    if (w) w->set_size(Vector2i((int)args[0], (int)args[1]));
+}
+
+const CommandInfo game_commands[] = {
+    { "Connect", 3, 3, cmd_connect },
+    { "ChangeScene", 1, 1, cmd_changescene },
+    { "LoadForm", 1, 1, cmd_loadform },
+    { "AddChild", 1, 1, cmd_addchild },
+    { "ApplyForce", 3, COMMAND_VARIADIC, cmd_applyforce },
+    { "ApplyImpulse", 3, COMMAND_VARIADIC, cmd_applyimpulse },
+    { "SetVelocity", 3, COMMAND_VARIADIC, cmd_setvelocity },
+    { "MoveAndSlide", 1, COMMAND_VARIADIC, cmd_moveandslide },
+    { "AI_Chase", 3, COMMAND_VARIADIC, cmd_ai_chase },
+    { "AI_Wander", 3, COMMAND_VARIADIC, cmd_ai_wander },
+    { "AI_Patrol", 3, COMMAND_VARIADIC, cmd_ai_patrol },
+    { "AI_Stop", 1, 1, cmd_ai_stop },
+    { "TweenProperty", 4, 4, cmd_tweenproperty },
+    { "Animate", 4, COMMAND_VARIADIC, cmd_animate },
+    { "Beep", 0, COMMAND_VARIADIC, cmd_beep },
+    { "PlayTone", 2, COMMAND_VARIADIC, cmd_playtone },
+    { "PlaySound", 1, 1, cmd_playsound },
+    { "PlayMusic", 1, 1, cmd_playmusic },
+    { "StopMusic", 0, COMMAND_VARIADIC, cmd_stopmusic },
+    { "AddMenuItem", 3, COMMAND_VARIADIC, cmd_addmenuitem },
+    { "SetTitle", 1, 1, cmd_settitle },
+    { "SetScreenSize", 2, 2, cmd_setscreensize },
+};
+
+} // namespace
+
+const CommandInfo *get_game_commands(int &r_count) {
+    r_count = sizeof(game_commands) / sizeof(game_commands[0]);
+    return game_commands;
+}
+
+} // namespace VisualGasicCommands
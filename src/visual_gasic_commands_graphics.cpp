@@ -0,0 +1,209 @@
+// Graphics commands: immediate-mode drawing on the owner (valid while it
+// is handling its draw notification), the PSet framebuffer, shaders, 3D
+// primitives and CLS. Shapes drawn from OnDraw go through the instance's
+// draw batch; outside it they are drawn one call at a time as before.
+
+#include "visual_gasic_commands.h"
+#include "visual_gasic_draw_batch.h"
+#include "visual_gasic_instance.h"
+#include <godot_cpp/classes/box_mesh.hpp>
+#include <godot_cpp/classes/canvas_item.hpp>
+#include <godot_cpp/classes/font.hpp>
+#include <godot_cpp/classes/material.hpp>
+#include <godot_cpp/classes/mesh_instance3d.hpp>
+#include <godot_cpp/classes/node.hpp>
+#include <godot_cpp/classes/shader.hpp>
+#include <godot_cpp/classes/shader_material.hpp>
+#include <godot_cpp/classes/sphere_mesh.hpp>
+#include <godot_cpp/classes/standard_material3d.hpp>
+
+using namespace godot;
+
+namespace VisualGasicCommands {
+
+namespace {
+
+CanvasItem *owner_canvas(VisualGasicInstance *p_instance) {
+    return Object::cast_to<CanvasItem>(p_instance->get_owner());
+}
+
+Color optional_color(const Array &p_args, int p_index) {
+    return p_args.size() > p_index ? (Color)p_args[p_index] : Color(1, 1, 1);
+}
+
+// The instance's batch while OnDraw runs, else null.
+VisualGasicDrawBatch *active_batch(VisualGasicInstance *p_instance) {
+    VisualGasicDrawBatch *batch = p_instance->get_draw_batch();
+    return batch->is_active() ? batch : nullptr;
+}
+
+// CLS / ClearScreen: frees the nodes AddChild and the Create* commands
+// added, and clears the framebuffer to black.
+void cmd_cls(VisualGasicInstance *p_instance, const Array &) {
+    p_instance->clear_dynamic_nodes();
+    p_instance->get_draw_batch()->framebuffer_clear(Color(0, 0, 0, 1));
+}
+
+// SetFramebuffer width, height, [scale]: PSet then writes into a
+// width x height image shown on the owner at scale x scale pixels per
+// pixel; SetFramebuffer 0, 0 turns it off.
+void cmd_setframebuffer(VisualGasicInstance *p_instance, const Array &args) {
+    int scale = args.size() > 2 ? (int)args[2] : 1;
+    p_instance->get_draw_batch()->set_framebuffer(owner_canvas(p_instance), args[0], args[1], scale);
+}
+
+// DrawLine x1, y1, x2, y2, [color], [width]
+void cmd_drawline(VisualGasicInstance *p_instance, const Array &args) {
+    float width = args.size() > 5 ? (float)args[5] : 1.0f;
+    if (VisualGasicDrawBatch *batch = active_batch(p_instance)) {
+        batch->add_line(Vector2(args[0], args[1]), Vector2(args[2], args[3]), optional_color(args, 4), width);
+    } else if (CanvasItem *ci = owner_canvas(p_instance)) {
+        ci->draw_line(Vector2(args[0], args[1]), Vector2(args[2], args[3]), optional_color(args, 4), width);
+    }
+}
+
+// DrawRect x, y, w, h, [color], [filled]
+void cmd_drawrect(VisualGasicInstance *p_instance, const Array &args) {
+    bool filled = args.size() > 5 ? (bool)args[5] : true;
+    if (VisualGasicDrawBatch *batch = active_batch(p_instance)) {
+        batch->add_rect(Rect2(args[0], args[1], args[2], args[3]), optional_color(args, 4), filled);
+    } else if (CanvasItem *ci = owner_canvas(p_instance)) {
+        ci->draw_rect(Rect2(args[0], args[1], args[2], args[3]), optional_color(args, 4), filled);
+    }
+}
+
+// DrawCircle x, y, radius, [color]
+void cmd_drawcircle(VisualGasicInstance *p_instance, const Array &args) {
+    if (VisualGasicDrawBatch *batch = active_batch(p_instance)) {
+        batch->add_circle(Vector2(args[0], args[1]), (float)args[2], optional_color(args, 3));
+    } else if (CanvasItem *ci = owner_canvas(p_instance)) {
+        ci->draw_circle(Vector2(args[0], args[1]), (float)args[2], optional_color(args, 3));
+    }
+}
+
+// PSet / DrawPixel x, y, color; a no-op with fewer arguments. With a
+// framebuffer the pixel is stored and works from any event.
+void cmd_pset(VisualGasicInstance *p_instance, const Array &args) {
+    if (args.size() < 3) return;
+    VisualGasicDrawBatch *batch = p_instance->get_draw_batch();
+    if (batch->has_framebuffer()) {
+        batch->framebuffer_pset(args[0], args[1], (Color)args[2]);
+    } else if (batch->is_active()) {
+        batch->add_pixel(Vector2(args[0], args[1]), (Color)args[2]);
+    } else if (CanvasItem *ci = owner_canvas(p_instance)) {
+        ci->draw_rect(Rect2(args[0], args[1], 1, 1), (Color)args[2], true);
+    }
+}
+
+// DrawText position, text, [color], with the default theme font.
+void cmd_drawtext(VisualGasicInstance *p_instance, const Array &args) {
+    if (VisualGasicDrawBatch *batch = active_batch(p_instance)) {
+        batch->flush(); // Keep the text above the shapes drawn before it
+    }
+    if (CanvasItem *ci = owner_canvas(p_instance)) {
+        ci->draw_string(Ref<Font>(), args[0], String(args[1]), HorizontalAlignment::HORIZONTAL_ALIGNMENT_LEFT, -1, 16, optional_color(args, 2));
+    }
+}
+
+// SetShader node, shader_or_material: anything else clears the material.
+void cmd_setshader(VisualGasicInstance *, const Array &args) {
+    CanvasItem *ci = Object::cast_to<CanvasItem>((Object *)args[0]);
+    if (!ci) return;
+    Variant sh = args[1];
+    if (sh.get_type() == Variant::OBJECT && (Object *)sh) {
+        Ref<Shader> shader = sh;
+        if (shader.is_valid()) {
+            Ref<ShaderMaterial> mat;
+            mat.instantiate();
+            mat->set_shader(shader);
+            ci->set_material(mat);
+        } else {
+            Ref<Material> mat_res = sh;
+            if (mat_res.is_valid()) {
+                ci->set_material(mat_res);
+            }
+        }
+    } else {
+        ci->set_material(Ref<Material>());
+    }
+}
+
+// A material of the given albedo when the last argument is a Color.
+Ref<StandardMaterial3D> trailing_color_material(const Array &p_args) {
+    Ref<StandardMaterial3D> mat;
+    const Variant &last = p_args[p_args.size() - 1];
+    if (last.get_type() == Variant::COLOR) {
+        mat.instantiate();
+        mat->set_albedo((Color)last);
+    }
+    return mat;
+}
+
+void add_primitive(VisualGasicInstance *p_instance, MeshInstance3D *p_mesh) {
+    if (Node *n = Object::cast_to<Node>(p_instance->get_owner())) {
+        n->add_child(p_mesh);
+        p_instance->track_dynamic_node(p_mesh);
+    }
+}
+
+// CreateCube sx, sy, sz, [px, py, pz], [color]
+void cmd_createcube(VisualGasicInstance *p_instance, const Array &args) {
+    MeshInstance3D *mi = memnew(MeshInstance3D);
+    Ref<BoxMesh> box;
+    box.instantiate();
+    box->set_size(Vector3(args[0], args[1], args[2]));
+    Ref<StandardMaterial3D> mat = trailing_color_material(args);
+    if (mat.is_valid()) {
+        box->set_material(mat);
+    }
+    mi->set_mesh(box);
+    if (args.size() >= 6) {
+        mi->set_position(Vector3(args[3], args[4], args[5]));
+    }
+    add_primitive(p_instance, mi);
+}
+
+// CreateSphere radius, [px, py, pz], [color]
+void cmd_createsphere(VisualGasicInstance *p_instance, const Array &args) {
+    float r = args[0];
+    MeshInstance3D *mi = memnew(MeshInstance3D);
+    Ref<SphereMesh> sphere;
+    sphere.instantiate();
+    sphere->set_radius(r);
+    sphere->set_height(r * 2);
+    if (args.size() > 1) {
+        Ref<StandardMaterial3D> mat = trailing_color_material(args);
+        if (mat.is_valid()) {
+            sphere->set_material(mat);
+        }
+    }
+    if (args.size() >= 4) {
+        mi->set_position(Vector3(args[1], args[2], args[3]));
+    }
+    mi->set_mesh(sphere);
+    add_primitive(p_instance, mi);
+}
+
+const CommandInfo graphics_commands[] = {
+    { "CLS", 0, COMMAND_VARIADIC, cmd_cls },
+    { "ClearScreen", 0, COMMAND_VARIADIC, cmd_cls },
+    { "DrawLine", 4, COMMAND_VARIADIC, cmd_drawline },
+    { "DrawRect", 4, COMMAND_VARIADIC, cmd_drawrect },
+    { "DrawCircle", 3, COMMAND_VARIADIC, cmd_drawcircle },
+    { "PSet", 0, COMMAND_VARIADIC, cmd_pset },
+    { "DrawPixel", 0, COMMAND_VARIADIC, cmd_pset },
+    { "DrawText", 2, COMMAND_VARIADIC, cmd_drawtext },
+    { "SetFramebuffer", 2, 3, cmd_setframebuffer },
+    { "SetShader", 2, 2, cmd_setshader },
+    { "CreateCube", 3, COMMAND_VARIADIC, cmd_createcube },
+    { "CreateSphere", 1, COMMAND_VARIADIC, cmd_createsphere },
+};
+
+} // namespace
+
+const CommandInfo *get_graphics_commands(int &r_count) {
+    r_count = sizeof(graphics_commands) / sizeof(graphics_commands[0]);
+    return graphics_commands;
+}
+
+} // namespace VisualGasicCommands
@@ -0,0 +1,195 @@
+// System commands: files and directories, settings, dialogs and processes.
+
+#include "visual_gasic_commands.h"
+#include "visual_gasic_instance.h"
+#include <godot_cpp/classes/accept_dialog.hpp>
+#include <godot_cpp/classes/config_file.hpp>
+#include <godot_cpp/classes/dir_access.hpp>
+#include <godot_cpp/classes/display_server.hpp>
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/json.hpp>
+#include <godot_cpp/classes/label.hpp>
+#include <godot_cpp/classes/line_edit.hpp>
+#include <godot_cpp/classes/node.hpp>
+#include <godot_cpp/classes/os.hpp>
+#include <godot_cpp/classes/v_box_container.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+using namespace godot;
+
+namespace VisualGasicCommands {
+
+namespace {
+
+// Relative paths are relative to user://.
+String user_path(const String &p_path) {
+    if (!p_path.begins_with("res://") && !p_path.begins_with("user://")) {
+        return "user://" + p_path;
+    }
+    return p_path;
+}
+
+// Runs the engine's event loop until the dialog is closed.
+void wait_for_dialog(AcceptDialog *p_dialog) {
+    while (p_dialog->is_visible() && p_dialog->is_inside_tree()) {
+        DisplayServer::get_singleton()->process_events();
+        OS::get_singleton()->delay_msec(10);
+    }
+}
+
+void cmd_randomize(VisualGasicInstance *, const Array &) {
+    UtilityFunctions::randomize();
+}
+
+void cmd_sleep(VisualGasicInstance *, const Array &args) {
+    OS::get_singleton()->delay_msec((int)args[0]);
+}
+
+// Shell "program arg ""quoted arg""": splits on spaces, honouring quotes.
+void cmd_shell(VisualGasicInstance *, const Array &args) {
+    String cmd_line = args[0];
+    String exe = "";
+    Array exe_args;
+    int i = 0;
+    while (i < cmd_line.length() && cmd_line[i] == ' ') i++;
+    if (i < cmd_line.length()) {
+        if (cmd_line[i] == '"') {
+            i++;
+            while (i < cmd_line.length() && cmd_line[i] != '"') { exe += cmd_line[i]; i++; }
+            i++;
+        } else {
+            while (i < cmd_line.length() && cmd_line[i] != ' ') { exe += cmd_line[i]; i++; }
+        }
+    }
+    while (i < cmd_line.length()) {
+        while (i < cmd_line.length() && cmd_line[i] == ' ') i++;
+        if (i >= cmd_line.length()) break;
+        String arg = "";
+        if (cmd_line[i] == '"') {
+            i++;
+            while (i < cmd_line.length() && cmd_line[i] != '"') { arg += cmd_line[i]; i++; }
+            i++;
+        } else {
+            while (i < cmd_line.length() && cmd_line[i] != ' ') { arg += cmd_line[i]; i++; }
+        }
+        exe_args.push_back(arg);
+    }
+    OS::get_singleton()->execute(exe, exe_args);
+}
+
+void cmd_mkdir(VisualGasicInstance *, const Array &args) {
+    DirAccess::make_dir_recursive_absolute(String(args[0]));
+}
+
+void cmd_rmdir(VisualGasicInstance *, const Array &args) {
+    DirAccess::remove_absolute(String(args[0])); // Only removes empty directories
+}
+
+void cmd_kill(VisualGasicInstance *p_instance, const Array &args) {
+    String path = user_path(args[0]);
+    if (FileAccess::file_exists(path)) {
+        DirAccess::remove_absolute(path);
+    } else {
+        p_instance->raise_runtime_error("File not found: " + path);
+    }
+}
+
+void cmd_name(VisualGasicInstance *p_instance, const Array &args) {
+    if (DirAccess::rename_absolute(user_path(args[0]), user_path(args[1])) != OK) {
+        p_instance->raise_runtime_error("Failed to rename file");
+    }
+}
+
+void cmd_filecopy(VisualGasicInstance *p_instance, const Array &args) {
+    if (DirAccess::copy_absolute(user_path(args[0]), user_path(args[1])) != OK) {
+        p_instance->raise_runtime_error("Failed to copy file");
+    }
+}
+
+// SaveSetting AppName, Section, Key, Value: the registry is emulated by a
+// ConfigFile with "AppName/Section" sections.
+void cmd_savesetting(VisualGasicInstance *, const Array &args) {
+    Ref<ConfigFile> cfg;
+    cfg.instantiate();
+    String path = "user://vb_settings.cfg";
+    cfg->load(path);
+    cfg->set_value(String(args[0]) + "/" + String(args[1]), args[2], args[3]);
+    cfg->save(path);
+}
+
+void cmd_savedatabase(VisualGasicInstance *p_instance, const Array &args) {
+    String path = user_path(args[0]);
+    Ref<FileAccess> f = FileAccess::open(path, FileAccess::WRITE);
+    if (f.is_valid()) {
+        f->store_string(JSON::stringify(args[1], "\t"));
+    } else {
+        p_instance->raise_runtime_error("Could not write to database: " + path);
+    }
+}
+
+// MsgBox and InputBox as statements block until the dialog closes; their
+// results are only available from the expression forms.
+void cmd_msgbox(VisualGasicInstance *p_instance, const Array &args) {
+    Node *root = Object::cast_to<Node>(p_instance->get_owner());
+    if (!root) return;
+
+    String msg = args.size() > 0 ? String(args[0]) : String();
+    String title = args.size() > 2 ? String(args[2]) : String("VisualGasic");
+
+    AcceptDialog *dlg = memnew(AcceptDialog);
+    dlg->set_title(title);
+    dlg->set_text(msg);
+    root->add_child(dlg);
+    dlg->popup_centered();
+    wait_for_dialog(dlg);
+    dlg->queue_free();
+}
+
+void cmd_inputbox(VisualGasicInstance *p_instance, const Array &args) {
+    Node *root = Object::cast_to<Node>(p_instance->get_owner());
+    if (!root) return;
+
+    String prompt = args.size() > 0 ? String(args[0]) : String();
+    String title = args.size() > 1 ? String(args[1]) : String("VisualGasic");
+    String def = args.size() > 2 ? String(args[2]) : String();
+
+    AcceptDialog *dialog = memnew(AcceptDialog);
+    dialog->set_title(title);
+    VBoxContainer *vbox = memnew(VBoxContainer);
+    Label *lbl = memnew(Label);
+    lbl->set_text(prompt);
+    vbox->add_child(lbl);
+    LineEdit *le = memnew(LineEdit);
+    le->set_text(def);
+    vbox->add_child(le);
+    dialog->add_child(vbox);
+    root->add_child(dialog);
+    dialog->popup_centered();
+    le->grab_focus();
+    wait_for_dialog(dialog);
+    dialog->queue_free();
+}
+
+const CommandInfo system_commands[] = {
+    { "Randomize", 0, COMMAND_VARIADIC, cmd_randomize },
+    { "Sleep", 1, 1, cmd_sleep },
+    { "Shell", 1, COMMAND_VARIADIC, cmd_shell },
+    { "MkDir", 1, 1, cmd_mkdir },
+    { "RmDir", 1, 1, cmd_rmdir },
+    { "Kill", 1, 1, cmd_kill },
+    { "Name", 2, 2, cmd_name },
+    { "FileCopy", 2, 2, cmd_filecopy },
+    { "SaveSetting", 4, 4, cmd_savesetting },
+    { "SaveDatabase", 2, 2, cmd_savedatabase },
+    { "MsgBox", 0, COMMAND_VARIADIC, cmd_msgbox },
+    { "InputBox", 0, COMMAND_VARIADIC, cmd_inputbox },
+};
+
+} // namespace
+
+const CommandInfo *get_system_commands(int &r_count) {
+    r_count = sizeof(system_commands) / sizeof(system_commands[0]);
+    return system_commands;
+}
+
+} // namespace VisualGasicCommands
@@ -1,4 +1,5 @@
 #include "visual_gasic_compiler.h"
+#include "visual_gasic_builtins.h"
 #include <godot_cpp/variant/utility_functions.hpp>
 #include <godot_cpp/core/math.hpp>
 
@@ -39,13 +40,40 @@ void VisualGasicCompiler::emit_bytes(uint8_t byte1, uint8_t byte2) {
     emit_byte(byte2);
 }
 
+void VisualGasicCompiler::emit_indexed(uint8_t op, int index) {
+    // Indices past one byte carry their high bits in an OP_WIDE prefix.
+    if (index > 0xFF) {
+        if (index > 0xFFFFFF) {
+            UtilityFunctions::print("Compiler Error: Operand index out of range: ", index);
+            compile_ok = false;
+            return;
+        }
+        emit_byte(OP_WIDE);
+        emit_byte((index >> 16) & 0xFF);
+        emit_byte((index >> 8) & 0xFF);
+    }
+    emit_bytes(op, (uint8_t)(index & 0xFF));
+}
+
+bool VisualGasicCompiler::fits_byte_operands(std::initializer_list<int> operands) const {
+    for (int v : operands) {
+        if (v < 0 || v > 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void VisualGasicCompiler::emit_constant(const Variant& value) {
     int idx = current_chunk->add_constant(value);
     if (idx < 256) {
         emit_bytes(OP_CONSTANT, (uint8_t)idx);
+    } else if (idx < 65536) {
+        emit_byte(OP_CONSTANT_LONG);
+        emit_byte((idx >> 8) & 0xFF);
+        emit_byte(idx & 0xFF);
     } else {
-        // Handle > 256 constants? Need OP_CONSTANT_LONG or similar. For now just truncate or error?
-        UtilityFunctions::print("Compiler Error: Too many constants");
+        emit_indexed(OP_CONSTANT, idx);
     }
 }
 
@@ -54,6 +82,12 @@ void VisualGasicCompiler::emit_return() {
 }
 
 int VisualGasicCompiler::emit_jump(uint8_t op) {
+    if (wide_jumps) {
+        // Reserve the prefix; patch_jump fills it in.
+        emit_byte(OP_WIDE);
+        emit_byte(0);
+        emit_byte(0);
+    }
     emit_byte(op);
     emit_byte(0);
     emit_byte(0);
@@ -62,20 +96,49 @@ int VisualGasicCompiler::emit_jump(uint8_t op) {
 
 void VisualGasicCompiler::patch_jump(int offset_pos) {
     int offset = current_chunk->code.size() - offset_pos - 2;
+    if (offset > 0xFFFF) {
+        if (!wide_jumps) {
+            // compile() retries the whole Sub with prefixed jumps.
+            jump_overflow = true;
+            return;
+        }
+        current_chunk->code.write[offset_pos - 3] = (offset >> 24) & 0xFF;
+        current_chunk->code.write[offset_pos - 2] = (offset >> 16) & 0xFF;
+    }
     current_chunk->code.write[offset_pos] = (offset >> 8) & 0xFF;
     current_chunk->code.write[offset_pos + 1] = offset & 0xFF;
 }
 
 void VisualGasicCompiler::emit_loop(int loop_start) {
+    int offset = current_chunk->code.size() - loop_start + 3;
+    if (offset > 0xFFFF) {
+        offset += 3;
+        emit_byte(OP_WIDE);
+        emit_byte((offset >> 24) & 0xFF);
+        emit_byte((offset >> 16) & 0xFF);
+    }
     emit_byte(OP_LOOP);
-    int offset = current_chunk->code.size() - loop_start + 2;
     emit_byte((offset >> 8) & 0xFF);
     emit_byte(offset & 0xFF);
 }
 
 bool VisualGasicCompiler::compile(ModuleNode* module, const String& entry_point, BytecodeChunk* chunk) {
+    wide_jumps = false;
+    bool ok = compile_pass(module, entry_point, chunk);
+    if (ok && jump_overflow) {
+        // A forward jump spans more than 64 KB. Jumps are patched after their
+        // targets are known, so redo the Sub with an OP_WIDE prefix on each.
+        *chunk = BytecodeChunk();
+        wide_jumps = true;
+        ok = compile_pass(module, entry_point, chunk);
+    }
+    return ok && !jump_overflow;
+}
+
+bool VisualGasicCompiler::compile_pass(ModuleNode* module, const String& entry_point, BytecodeChunk* chunk) {
     current_chunk = chunk;
     compile_ok = true;
+    jump_overflow = false;
     array_vars.clear();
     dictionary_vars.clear();
     trusted_dictionary_vars.clear();
@@ -91,6 +154,14 @@ bool VisualGasicCompiler::compile(ModuleNode* module, const String& entry_point,
     loop_bound_vars.clear();
     temp_local_id = 0;
     current_sub = nullptr;
+    current_module = module;
+    frame_locals.clear();
+    register_slots.clear();
+    reg_hoisted.clear();
+    guarded_loads.clear();
+    reg_temp_pool[0].clear();
+    reg_temp_pool[1].clear();
+    reset_reg_temps();
     
     // Find the entry point sub
     SubDefinition* sub = nullptr;
@@ -108,11 +179,61 @@ bool VisualGasicCompiler::compile(ModuleNode* module, const String& entry_point,
 
 
     current_sub = sub;
-    non_local_names.insert(sub->name.to_lower());
     used_vars.insert(sub->name.to_lower());
 
+    // Parameters and the Function result live in the call frame. Parameters
+    // take slots 0..N-1 in declaration order so OP_CALL_USER can bind
+    // arguments straight off the value stack.
+    bool frame_params = true;
     for (int i = 0; i < sub->parameters.size(); i++) {
-        non_local_names.insert(sub->parameters[i].name.to_lower());
+        if (sub->parameters[i].is_param_array) {
+            frame_params = false;
+        }
+    }
+    if (frame_params) {
+        for (int i = 0; i < sub->parameters.size(); i++) {
+            const Parameter &param = sub->parameters[i];
+            String key = param.name.to_lower();
+            ValueType vt = type_from_hint(param.type_hint);
+            get_or_add_local(param.name, vt);
+            frame_locals.insert(key);
+            if (vt != VT_UNKNOWN) {
+                typed_locals.insert(key);
+            }
+
+            String t = param.type_hint.to_lower();
+            uint8_t kind = BytecodeChunk::PARAM_ANY;
+            if (t == "integer" || t == "long") kind = BytecodeChunk::PARAM_INT;
+            else if (t == "single" || t == "double") kind = BytecodeChunk::PARAM_FLOAT;
+            else if (t == "string") kind = BytecodeChunk::PARAM_STRING;
+            else if (t == "boolean") kind = BytecodeChunk::PARAM_BOOL;
+            current_chunk->param_kinds.push_back(kind);
+        }
+        current_chunk->param_count = sub->parameters.size();
+
+        if (sub->type == SubDefinition::TYPE_FUNCTION) {
+            ValueType rt = type_from_hint(sub->return_type);
+            current_chunk->return_slot = get_or_add_local(sub->name, rt);
+            frame_locals.insert(sub->name.to_lower());
+            if (rt != VT_UNKNOWN) {
+                typed_locals.insert(sub->name.to_lower());
+            }
+
+            Variant init_val;
+            String t = sub->return_type.to_lower();
+            if (t == "integer" || t == "long") init_val = (int64_t)0;
+            else if (t == "single" || t == "double") init_val = 0.0;
+            else if (t == "string") init_val = "";
+            else if (t == "boolean") init_val = false;
+            emit_constant(init_val);
+            emit_indexed(OP_SET_LOCAL, current_chunk->return_slot);
+        }
+    } else {
+        current_chunk->param_count = -1;
+        non_local_names.insert(sub->name.to_lower());
+        for (int i = 0; i < sub->parameters.size(); i++) {
+            non_local_names.insert(sub->parameters[i].name.to_lower());
+        }
     }
 
     if (current_sub && current_sub->name.nocasecmp_to("BenchFileIO") == 0 && sub->parameters.size() >= 2) {
@@ -124,15 +245,16 @@ bool VisualGasicCompiler::compile(ModuleNode* module, const String& entry_point,
         compile_expression(&iter_node);
         compile_expression(&size_node);
         int idx = current_chunk->add_constant(String("BenchFileIOFast"));
-        emit_bytes(OP_CALL, (uint8_t)idx);
+        emit_indexed(OP_CALL, idx);
         emit_byte((uint8_t)2);
 
         int slot = get_or_add_local(sub->name, VT_INT);
-        if (slot >= 0) emit_bytes(OP_SET_LOCAL, (uint8_t)slot);
+        if (slot >= 0) emit_indexed(OP_SET_LOCAL, slot);
         else {
             int name_idx = current_chunk->add_constant(sub->name);
-            emit_bytes(OP_SET_GLOBAL, (uint8_t)name_idx);
+            emit_indexed(OP_SET_GLOBAL, name_idx);
         }
+        finalize_local_scopes();
         emit_return();
         return compile_ok;
     }
@@ -154,6 +276,8 @@ bool VisualGasicCompiler::compile(ModuleNode* module, const String& entry_point,
     for (int i = 0; i < sub->statements.size(); i++) {
         collect_locals(sub->statements[i]);
     }
+
+    assign_register_locals(sub);
     
     for (int i = 0; i < sub->statements.size(); i++) {
         Statement *stmt = sub->statements[i];
@@ -177,10 +301,10 @@ bool VisualGasicCompiler::compile(ModuleNode* module, const String& entry_point,
                             emit_byte(OP_ALLOC_FILL_I64);
 
                             int slot = get_or_add_local(rd_name, VT_UNKNOWN);
-                            if (slot >= 0) emit_bytes(OP_SET_LOCAL, (uint8_t)slot);
+                            if (slot >= 0) emit_indexed(OP_SET_LOCAL, slot);
                             else {
                                 int idx = current_chunk->add_constant(rd_name);
-                                emit_bytes(OP_SET_GLOBAL, (uint8_t)idx);
+                                emit_indexed(OP_SET_GLOBAL, idx);
                             }
                             i++; // Skip the fill loop
                             continue;
@@ -191,11 +315,77 @@ bool VisualGasicCompiler::compile(ModuleNode* module, const String& entry_point,
         }
         compile_statement(stmt);
     }
-    current_chunk->local_count = local_slots.size();
+    finalize_local_scopes();
     emit_return();
     return compile_ok;
 }
 
+void VisualGasicCompiler::finalize_local_scopes() {
+    current_chunk->local_count = local_slots.size();
+    current_chunk->local_frame_only.resize(current_chunk->local_count);
+    for (int i = 0; i < current_chunk->local_count; i++) {
+        String key = current_chunk->local_names[i].to_lower();
+        bool frame_only = key.begins_with("__") || frame_locals.has(key);
+        current_chunk->local_frame_only.write[i] = frame_only ? 1 : 0;
+    }
+    current_chunk->local_regs.resize(current_chunk->local_count);
+    for (int i = 0; i < current_chunk->local_count; i++) {
+        uint8_t kind = BytecodeChunk::REG_NONE;
+        if (register_slots.has(i)) {
+            kind = register_slots[i] == VT_FLOAT ? BytecodeChunk::REG_F64 : BytecodeChunk::REG_I64;
+        }
+        current_chunk->local_regs.write[i] = kind;
+    }
+}
+
+VisualGasicCompiler::ValueType VisualGasicCompiler::type_from_hint(const String &type_name) const {
+    String t = type_name.to_lower();
+    if (t == "integer" || t == "long") return VT_INT;
+    if (t == "single" || t == "double") return VT_FLOAT;
+    return VT_UNKNOWN;
+}
+
+int VisualGasicCompiler::find_user_sub(const String &name) const {
+    if (!current_module) {
+        return -1;
+    }
+    for (int i = 0; i < current_module->subs.size(); i++) {
+        if (current_module->subs[i]->name.nocasecmp_to(name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Emits a direct call to a Sub/Function of this module: arguments are left on
+// the value stack and the callee is addressed by its index in module->subs.
+// Returns false when the call has to go through name-based OP_CALL instead.
+bool VisualGasicCompiler::emit_user_call(const String &name, const Vector<ExpressionNode*> &arguments) {
+    int sub_index = find_user_sub(name);
+    if (sub_index < 0 || arguments.size() > 255) {
+        return false;
+    }
+    SubDefinition *target = current_module->subs[sub_index];
+    if (arguments.size() > target->parameters.size()) {
+        return false;
+    }
+    for (int i = 0; i < target->parameters.size(); i++) {
+        const Parameter &param = target->parameters[i];
+        if (param.is_param_array) {
+            return false;
+        }
+        if (i >= arguments.size() && !param.is_optional) {
+            return false;
+        }
+    }
+    for (int i = 0; i < arguments.size(); i++) {
+        compile_expression(arguments[i]);
+    }
+    emit_indexed(OP_CALL_USER, sub_index);
+    emit_byte((uint8_t)arguments.size());
+    return true;
+}
+
 int VisualGasicCompiler::get_or_add_local(const String &name, ValueType type) {
     String key = name.to_lower();
     if (non_local_names.has(key)) {
@@ -240,6 +430,7 @@ void VisualGasicCompiler::collect_locals(Statement* stmt) {
     switch (stmt->type) {
         case STMT_DIM: {
             DimStatement* s = (DimStatement*)stmt;
+            frame_locals.insert(s->variable_name.to_lower());
             if (s->array_sizes.size() > 0) {
                 array_vars.insert(s->variable_name.to_lower());
                 String t = s->type_name.to_lower();
@@ -413,8 +604,17 @@ void VisualGasicCompiler::collect_assigned_vars_stmt(Statement* stmt, HashSet<St
             }
             break;
         }
+        case STMT_DIM: {
+            out.insert(((DimStatement*)stmt)->variable_name.to_lower());
+            break;
+        }
+        case STMT_REDIM: {
+            out.insert(((ReDimStatement*)stmt)->variable_name.to_lower());
+            break;
+        }
         case STMT_FOR: {
             ForStatement* f = (ForStatement*)stmt;
+            out.insert(f->variable_name.to_lower());
             for (int i = 0; i < f->body.size(); i++) collect_assigned_vars_stmt(f->body[i], out);
             break;
         }
@@ -1690,12 +1890,764 @@ VisualGasicCompiler::ValueType VisualGasicCompiler::infer_type(ExpressionNode* e
     return VT_UNKNOWN;
 }
 
+// Literal operand of a register expression: a numeric literal, optionally
+// negated.
+static bool vg_reg_literal(ExpressionNode* expr, Variant &r_value) {
+    if (!expr) return false;
+    bool negate = false;
+    if (expr->type == ExpressionNode::UNARY_OP) {
+        UnaryOpNode* u = (UnaryOpNode*)expr;
+        if (u->op != "-" || !u->operand) return false;
+        negate = true;
+        expr = u->operand;
+    }
+    if (expr->type != ExpressionNode::LITERAL) return false;
+    Variant v = ((LiteralNode*)expr)->value;
+    if (v.get_type() == Variant::INT) {
+        r_value = negate ? -(int64_t)v : (int64_t)v;
+        return true;
+    }
+    if (v.get_type() == Variant::FLOAT) {
+        r_value = negate ? -(double)v : (double)v;
+        return true;
+    }
+    return false;
+}
+
+// Upper bounds on the scratch registers and constants a register expression
+// needs (one temp per node, one constant per literal).
+static void vg_reg_expr_cost(ExpressionNode* expr, int &r_nodes, int &r_literals) {
+    if (!expr) return;
+    r_nodes++;
+    Variant literal;
+    if (vg_reg_literal(expr, literal)) {
+        r_literals++;
+        return;
+    }
+    if (expr->type == ExpressionNode::BINARY_OP) {
+        BinaryOpNode* b = (BinaryOpNode*)expr;
+        vg_reg_expr_cost(b->left, r_nodes, r_literals);
+        vg_reg_expr_cost(b->right, r_nodes, r_literals);
+    } else if (expr->type == ExpressionNode::ARRAY_ACCESS) {
+        ArrayAccessNode* aa = (ArrayAccessNode*)expr;
+        for (int i = 0; i < aa->indices.size(); i++) vg_reg_expr_cost(aa->indices[i], r_nodes, r_literals);
+    }
+}
+
+// Register ops needed to evaluate expr in place (one per operator).
+static int vg_reg_op_count(ExpressionNode* expr) {
+    if (!expr || expr->type != ExpressionNode::BINARY_OP) return 0;
+    BinaryOpNode* b = (BinaryOpNode*)expr;
+    return 1 + vg_reg_op_count(b->left) + vg_reg_op_count(b->right);
+}
+
+// Structural key used to group equal expressions; empty for node kinds the
+// loop optimiser does not compare.
+static String vg_expr_key(ExpressionNode* expr) {
+    if (!expr) return String();
+    switch (expr->type) {
+        case ExpressionNode::LITERAL: {
+            const Variant &v = ((LiteralNode*)expr)->value;
+            return vformat("#%d:%s", (int)v.get_type(), v.stringify());
+        }
+        case ExpressionNode::VARIABLE:
+            return ((VariableNode*)expr)->name.to_lower();
+        case ExpressionNode::UNARY_OP: {
+            UnaryOpNode* u = (UnaryOpNode*)expr;
+            String inner = vg_expr_key(u->operand);
+            return inner.is_empty() ? String() : vformat("(%s %s)", u->op, inner);
+        }
+        case ExpressionNode::BINARY_OP: {
+            BinaryOpNode* b = (BinaryOpNode*)expr;
+            String l = vg_expr_key(b->left);
+            String r = vg_expr_key(b->right);
+            if (l.is_empty() || r.is_empty()) return String();
+            return vformat("(%s %s %s)", l, b->op, r);
+        }
+        default:
+            return String();
+    }
+}
+
+// Register tier: frame-only locals declared Integer/Long or Single/Double are
+// kept unboxed when every write to them in the Sub is an expression of a
+// matching numeric type, so the conversion in the VM never changes a value
+// the Variant path would have stored.
+void VisualGasicCompiler::assign_register_locals(SubDefinition* sub) {
+    HashSet<String> blocked;
+    for (int i = 0; i < sub->statements.size(); i++) {
+        collect_register_blockers(sub->statements[i], blocked);
+    }
+    for (const KeyValue<String, int> &entry : local_slots) {
+        const String &key = entry.key;
+        int slot = entry.value;
+        if (!frame_locals.has(key) || !typed_locals.has(key) || blocked.has(key)) continue;
+        if (array_vars.has(key) || dictionary_vars.has(key) || slot > 0xFF) continue;
+        ValueType vt = local_types.has(key) ? local_types[key] : VT_UNKNOWN;
+        if (vt == VT_INT || vt == VT_FLOAT) {
+            register_slots[slot] = vt;
+        }
+    }
+}
+
+void VisualGasicCompiler::collect_register_blockers(Statement* stmt, HashSet<String> &out) const {
+    if (!stmt) return;
+    auto check_write = [&](const String &name, ExpressionNode* value) {
+        String key = name.to_lower();
+        ValueType target = typed_locals.has(key) && local_types.has(key) ? local_types[key] : VT_UNKNOWN;
+        ValueType vt = register_value_type(value);
+        bool ok = (target == VT_INT && vt == VT_INT) || (target == VT_FLOAT && vt != VT_UNKNOWN);
+        if (!ok) out.insert(key);
+    };
+    switch (stmt->type) {
+        case STMT_ASSIGNMENT: {
+            AssignmentStatement* s = (AssignmentStatement*)stmt;
+            if (s->target && s->target->type == ExpressionNode::VARIABLE) {
+                check_write(((VariableNode*)s->target)->name, s->value);
+            }
+            break;
+        }
+        case STMT_DIM: {
+            DimStatement* s = (DimStatement*)stmt;
+            if (s->initializer || s->array_sizes.size() > 0) out.insert(s->variable_name.to_lower());
+            break;
+        }
+        case STMT_REDIM: {
+            out.insert(((ReDimStatement*)stmt)->variable_name.to_lower());
+            break;
+        }
+        case STMT_FOR: {
+            ForStatement* f = (ForStatement*)stmt;
+            check_write(f->variable_name, f->from_val);
+            check_write(f->variable_name, f->to_val);
+            if (f->step_val) check_write(f->variable_name, f->step_val);
+            for (int i = 0; i < f->body.size(); i++) collect_register_blockers(f->body[i], out);
+            break;
+        }
+        case STMT_IF: {
+            IfStatement* s = (IfStatement*)stmt;
+            for (int i = 0; i < s->then_branch.size(); i++) collect_register_blockers(s->then_branch[i], out);
+            for (int i = 0; i < s->else_branch.size(); i++) collect_register_blockers(s->else_branch[i], out);
+            break;
+        }
+        case STMT_WHILE: {
+            WhileStatement* s = (WhileStatement*)stmt;
+            for (int i = 0; i < s->body.size(); i++) collect_register_blockers(s->body[i], out);
+            break;
+        }
+        case STMT_DO: {
+            DoStatement* s = (DoStatement*)stmt;
+            for (int i = 0; i < s->body.size(); i++) collect_register_blockers(s->body[i], out);
+            break;
+        }
+        case STMT_FOR_EACH: {
+            ForEachStatement* s = (ForEachStatement*)stmt;
+            out.insert(s->variable_name.to_lower());
+            for (int i = 0; i < s->body.size(); i++) collect_register_blockers(s->body[i], out);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+// Like infer_type, but only claims a type the value is guaranteed to have at
+// run time (declared locals, typed arrays, numeric literals and arithmetic on
+// them).
+VisualGasicCompiler::ValueType VisualGasicCompiler::register_value_type(ExpressionNode* expr) const {
+    if (!expr) return VT_UNKNOWN;
+    Variant literal;
+    if (vg_reg_literal(expr, literal)) {
+        return literal.get_type() == Variant::INT ? VT_INT : VT_FLOAT;
+    }
+    switch (expr->type) {
+        case ExpressionNode::VARIABLE: {
+            String key = ((VariableNode*)expr)->name.to_lower();
+            if (typed_locals.has(key) && local_types.has(key)) return local_types[key];
+            return VT_UNKNOWN;
+        }
+        case ExpressionNode::ARRAY_ACCESS: {
+            ArrayAccessNode* aa = (ArrayAccessNode*)expr;
+            if (aa->base && aa->base->type == ExpressionNode::VARIABLE) {
+                String key = ((VariableNode*)aa->base)->name.to_lower();
+                if (array_types.has(key)) return array_types[key];
+            }
+            return VT_UNKNOWN;
+        }
+        case ExpressionNode::BINARY_OP: {
+            BinaryOpNode* b = (BinaryOpNode*)expr;
+            ValueType lt = register_value_type(b->left);
+            ValueType rt = register_value_type(b->right);
+            if (lt == VT_UNKNOWN || rt == VT_UNKNOWN) return VT_UNKNOWN;
+            if (b->op == "/") return VT_FLOAT;
+            if (b->op == "+" || b->op == "-" || b->op == "*") {
+                return (lt == VT_INT && rt == VT_INT) ? VT_INT : VT_FLOAT;
+            }
+            return VT_UNKNOWN;
+        }
+        default:
+            return VT_UNKNOWN;
+    }
+}
+
+int VisualGasicCompiler::register_slot(const String &name) const {
+    String key = name.to_lower();
+    if (non_local_names.has(key) || !local_slots.has(key)) return -1;
+    int slot = local_slots[key];
+    return register_slots.has(slot) ? slot : -1;
+}
+
+VisualGasicCompiler::ValueType VisualGasicCompiler::register_kind(int slot) const {
+    return register_slots.has(slot) ? register_slots[slot] : VT_UNKNOWN;
+}
+
+bool VisualGasicCompiler::reg_expr_ok(ExpressionNode* expr, ValueType kind) const {
+    if (!expr) return false;
+    if (reg_hoisted.has(expr)) {
+        ValueType hk = register_kind(reg_hoisted[expr]);
+        return hk == kind || (kind == VT_FLOAT && hk == VT_INT);
+    }
+    Variant literal;
+    if (vg_reg_literal(expr, literal)) {
+        return literal.get_type() == Variant::INT || kind == VT_FLOAT;
+    }
+    switch (expr->type) {
+        case ExpressionNode::VARIABLE: {
+            int slot = register_slot(((VariableNode*)expr)->name);
+            if (slot < 0 || slot > 0xFF) return false;
+            ValueType vk = register_kind(slot);
+            return vk == kind || (kind == VT_FLOAT && vk == VT_INT);
+        }
+        case ExpressionNode::BINARY_OP: {
+            BinaryOpNode* b = (BinaryOpNode*)expr;
+            bool arith = b->op == "+" || b->op == "-" || b->op == "*" || (kind == VT_FLOAT && b->op == "/");
+            return arith && reg_expr_ok(b->left, kind) && reg_expr_ok(b->right, kind);
+        }
+        case ExpressionNode::ARRAY_ACCESS: {
+            // Single-index read of a typed local array (a Variant slot).
+            ArrayAccessNode* aa = (ArrayAccessNode*)expr;
+            if (!aa->base || aa->base->type != ExpressionNode::VARIABLE || aa->indices.size() != 1) return false;
+            String key = ((VariableNode*)aa->base)->name.to_lower();
+            if (!array_types.has(key) || non_local_names.has(key) || !local_slots.has(key)) return false;
+            int slot = local_slots[key];
+            if (slot > 0xFF || register_slots.has(slot)) return false;
+            ValueType et = array_types[key];
+            if (et != kind && !(kind == VT_FLOAT && et == VT_INT)) return false;
+            return reg_expr_ok(aa->indices[0], VT_INT);
+        }
+        default:
+            return false;
+    }
+}
+
+void VisualGasicCompiler::reset_reg_temps() {
+    reg_temp_used[0] = reg_temp_used[1] = 0;
+    reg_temp_planned[0] = reg_temp_planned[1] = 0;
+    reg_const_planned = 0;
+}
+
+// Checks that expr can be emitted as register code and reserves the temps
+// and constant indices it needs, so emit_reg_expr never fails halfway.
+bool VisualGasicCompiler::prepare_reg_expr(ExpressionNode* expr, ValueType kind) {
+    if (!reg_expr_ok(expr, kind)) return false;
+    int nodes = 0;
+    int literals = 0;
+    vg_reg_expr_cost(expr, nodes, literals);
+    if (current_chunk->constants.size() + reg_const_planned + literals > 0x100) return false;
+    int pool = kind == VT_FLOAT ? 1 : 0;
+    Vector<int> &temps = reg_temp_pool[pool];
+    while (temps.size() < reg_temp_planned[pool] + nodes) {
+        String name = vformat("__reg_%s_%d", pool ? "f64" : "i64", temps.size());
+        int slot = get_or_add_local(name, kind);
+        if (slot < 0 || slot > 0xFF) return false;
+        register_slots[slot] = kind;
+        temps.push_back(slot);
+    }
+    reg_temp_planned[pool] += nodes;
+    reg_const_planned += literals;
+    return true;
+}
+
+int VisualGasicCompiler::take_reg_temp(ValueType kind) {
+    int pool = kind == VT_FLOAT ? 1 : 0;
+    return reg_temp_pool[pool][reg_temp_used[pool]++];
+}
+
+// Emits expr (already accepted by prepare_reg_expr) into dst, or into a temp
+// when dst is -1, and returns the slot holding the result. A plain variable
+// of the right kind is returned in place.
+int VisualGasicCompiler::emit_reg_expr(ExpressionNode* expr, ValueType kind, int dst) {
+    bool f64 = kind == VT_FLOAT;
+    if (reg_hoisted.has(expr)) {
+        return emit_reg_copy(reg_hoisted[expr], kind, dst);
+    }
+    Variant literal;
+    if (vg_reg_literal(expr, literal)) {
+        int target = dst >= 0 ? dst : take_reg_temp(kind);
+        if (f64 && literal.get_type() == Variant::INT) {
+            literal = (double)(int64_t)literal;
+        }
+        int k = current_chunk->add_constant(literal);
+        emit_byte(f64 ? OP_R_LOADK_F64 : OP_R_LOADK_I64);
+        emit_bytes((uint8_t)target, (uint8_t)k);
+        return target;
+    }
+    if (expr->type == ExpressionNode::VARIABLE) {
+        return emit_reg_copy(register_slot(((VariableNode*)expr)->name), kind, dst);
+    }
+    if (expr->type == ExpressionNode::ARRAY_ACCESS) {
+        ArrayAccessNode* aa = (ArrayAccessNode*)expr;
+        int arr_slot = local_slots[((VariableNode*)aa->base)->name.to_lower()];
+        int idx = emit_reg_expr(aa->indices[0], VT_INT, -1);
+        int target = dst >= 0 ? dst : take_reg_temp(kind);
+        bool guarded = guarded_loads.has(expr);
+        if (f64) {
+            emit_byte(guarded ? OP_R_GET_ARRAY_F64_GUARDED : OP_R_GET_ARRAY_F64);
+        } else {
+            emit_byte(guarded ? OP_R_GET_ARRAY_I64_GUARDED : OP_R_GET_ARRAY_I64);
+        }
+        emit_byte((uint8_t)target);
+        emit_bytes((uint8_t)arr_slot, (uint8_t)idx);
+        return target;
+    }
+
+    BinaryOpNode* b = (BinaryOpNode*)expr;
+    if (!f64) {
+        // A literal operand folds into the K form (either side for + and *).
+        ExpressionNode* reg_side = b->left;
+        Variant k_value;
+        bool use_k = vg_reg_literal(b->right, k_value);
+        if (!use_k && b->op != "-" && vg_reg_literal(b->left, k_value)) {
+            use_k = true;
+            reg_side = b->right;
+        }
+        if (use_k) {
+            int a = emit_reg_expr(reg_side, kind, -1);
+            int target = dst >= 0 ? dst : take_reg_temp(kind);
+            int k = current_chunk->add_constant(k_value);
+            emit_byte(b->op == "+" ? OP_R_ADDK_I64 : (b->op == "-" ? OP_R_SUBK_I64 : OP_R_MULK_I64));
+            emit_byte((uint8_t)target);
+            emit_bytes((uint8_t)a, (uint8_t)k);
+            return target;
+        }
+    }
+    int a = emit_reg_expr(b->left, kind, -1);
+    int c = emit_reg_expr(b->right, kind, -1);
+    int target = dst >= 0 ? dst : take_reg_temp(kind);
+    uint8_t op;
+    if (f64) {
+        op = b->op == "+" ? OP_R_ADD_F64 : (b->op == "-" ? OP_R_SUB_F64 : (b->op == "*" ? OP_R_MUL_F64 : OP_R_DIV_F64));
+    } else {
+        op = b->op == "+" ? OP_R_ADD_I64 : (b->op == "-" ? OP_R_SUB_I64 : OP_R_MUL_I64);
+    }
+    emit_byte(op);
+    emit_byte((uint8_t)target);
+    emit_bytes((uint8_t)a, (uint8_t)c);
+    return target;
+}
+
+// A register read in the given kind: the slot itself, or a copy / Long to
+// Double conversion into dst (or a temp).
+int VisualGasicCompiler::emit_reg_copy(int slot, ValueType kind, int dst) {
+    if (kind == VT_FLOAT && register_kind(slot) == VT_INT) {
+        int target = dst >= 0 ? dst : take_reg_temp(kind);
+        emit_byte(OP_R_I64_TO_F64);
+        emit_bytes((uint8_t)target, (uint8_t)slot);
+        return target;
+    }
+    if (dst >= 0 && dst != slot) {
+        emit_byte(OP_R_MOV);
+        emit_bytes((uint8_t)dst, (uint8_t)slot);
+        return dst;
+    }
+    return slot;
+}
+
+bool VisualGasicCompiler::emit_reg_assignment(int slot, ExpressionNode* value) {
+    ValueType kind = register_kind(slot);
+    if (kind == VT_UNKNOWN || slot > 0xFF) return false;
+    reset_reg_temps();
+    if (!prepare_reg_expr(value, kind)) return false;
+    emit_reg_expr(value, kind, slot);
+    return true;
+}
+
+// Compare-and-branch on Long registers for If conditions. Returns the jump
+// operand position for patch_jump, or -1 when the condition needs the stack.
+int VisualGasicCompiler::emit_reg_branch_if_false(ExpressionNode* condition) {
+    if (wide_jumps || !condition || condition->type != ExpressionNode::BINARY_OP) return -1;
+    BinaryOpNode* b = (BinaryOpNode*)condition;
+    uint8_t cmp;
+    if (b->op == "=") cmp = RCMP_EQ;
+    else if (b->op == "<>") cmp = RCMP_NE;
+    else if (b->op == "<") cmp = RCMP_LT;
+    else if (b->op == "<=") cmp = RCMP_LE;
+    else if (b->op == ">") cmp = RCMP_GT;
+    else if (b->op == ">=") cmp = RCMP_GE;
+    else return -1;
+
+    reset_reg_temps();
+    Variant k_value;
+    bool use_k = vg_reg_literal(b->right, k_value) && k_value.get_type() == Variant::INT;
+    if (!prepare_reg_expr(b->left, VT_INT)) return -1;
+    if (use_k) {
+        if (current_chunk->constants.size() + reg_const_planned >= 0x100) return -1;
+    } else if (!prepare_reg_expr(b->right, VT_INT)) {
+        return -1;
+    }
+
+    int a = emit_reg_expr(b->left, VT_INT, -1);
+    int rhs = use_k ? current_chunk->add_constant(k_value) : emit_reg_expr(b->right, VT_INT, -1);
+    emit_byte(use_k ? OP_R_JUMP_IF_NOT_I64K : OP_R_JUMP_IF_NOT_I64);
+    emit_bytes(cmp, (uint8_t)a);
+    emit_byte((uint8_t)rhs);
+    emit_bytes(0, 0);
+    return current_chunk->code.size() - 2;
+}
+
+// Loop optimisation for register For loops. The AST is the IR: the body is
+// scanned once before it is compiled, and what this records decides which
+// expressions move to the loop preheader instead of running every iteration.
+void VisualGasicCompiler::collect_loop_facts(Statement* stmt, RegLoopPlan &plan, bool conditional) const {
+    if (!stmt) return;
+    Vector<ExpressionNode*> &roots = conditional ? plan.cond_roots : plan.roots;
+    switch (stmt->type) {
+        case STMT_ASSIGNMENT: {
+            AssignmentStatement* s = (AssignmentStatement*)stmt;
+            if (s->target && s->target->type == ExpressionNode::VARIABLE) {
+                plan.rebound.insert(((VariableNode*)s->target)->name.to_lower());
+            } else if (s->target && s->target->type == ExpressionNode::ARRAY_ACCESS &&
+                    ((ArrayAccessNode*)s->target)->base &&
+                    ((ArrayAccessNode*)s->target)->base->type == ExpressionNode::VARIABLE) {
+                // Element stores keep the array's binding and size.
+                ArrayAccessNode* aa = (ArrayAccessNode*)s->target;
+                for (int i = 0; i < aa->indices.size(); i++) roots.push_back(aa->indices[i]);
+            } else {
+                plan.has_calls = true; // Member stores may run property setters
+            }
+            roots.push_back(s->value);
+            break;
+        }
+        case STMT_DIM: {
+            plan.rebound.insert(((DimStatement*)stmt)->variable_name.to_lower());
+            break;
+        }
+        case STMT_REDIM: {
+            plan.rebound.insert(((ReDimStatement*)stmt)->variable_name.to_lower());
+            break;
+        }
+        case STMT_PRINT: {
+            roots.push_back(((PrintStatement*)stmt)->expression);
+            break;
+        }
+        case STMT_FOR: {
+            ForStatement* f = (ForStatement*)stmt;
+            plan.rebound.insert(f->variable_name.to_lower());
+            roots.push_back(f->from_val);
+            roots.push_back(f->to_val);
+            roots.push_back(f->step_val);
+            plan.inner_loops++;
+            for (int i = 0; i < f->body.size(); i++) collect_loop_facts(f->body[i], plan, true);
+            plan.inner_loops--;
+            break;
+        }
+        case STMT_IF: {
+            IfStatement* s = (IfStatement*)stmt;
+            roots.push_back(s->condition);
+            for (int i = 0; i < s->then_branch.size(); i++) collect_loop_facts(s->then_branch[i], plan, true);
+            for (int i = 0; i < s->else_branch.size(); i++) collect_loop_facts(s->else_branch[i], plan, true);
+            break;
+        }
+        case STMT_EXIT:
+            // Exit For inside an inner loop only ends that loop; anything else
+            // can leave this one before the counter reaches its bound.
+            if (((ExitStatement*)stmt)->exit_type != ExitStatement::EXIT_FOR || plan.inner_loops == 0) {
+                plan.may_exit = true;
+            }
+            break;
+        default:
+            plan.has_calls = true; // Call statements and anything not modelled here
+            break;
+    }
+}
+
+bool VisualGasicCompiler::is_loop_invariant(ExpressionNode* expr, const RegLoopPlan &plan) const {
+    HashSet<String> vars;
+    collect_vars_in_expr(expr, vars);
+    if (vars.is_empty()) return false; // Constant; folded where it is used
+    for (const String &v : vars) {
+        if (v == plan.iv || plan.rebound.has(v)) return false;
+    }
+    return true;
+}
+
+// Matches expr = a * counter + b with b loop invariant, where a is an Integer
+// literal (r_lit, r_var empty) or an invariant Long register (r_var). Both
+// stay zero/empty when expr does not depend on the counter.
+bool VisualGasicCompiler::affine_coefficient(ExpressionNode* expr, const RegLoopPlan &plan, int64_t &r_lit, String &r_var) const {
+    r_lit = 0;
+    r_var = String();
+    if (!expr) return false;
+    Variant literal;
+    if (vg_reg_literal(expr, literal)) {
+        return literal.get_type() == Variant::INT;
+    }
+    if (expr->type == ExpressionNode::VARIABLE) {
+        String key = ((VariableNode*)expr)->name.to_lower();
+        if (key == plan.iv) {
+            r_lit = 1;
+            return true;
+        }
+        return !plan.rebound.has(key);
+    }
+    if (expr->type != ExpressionNode::BINARY_OP) return false;
+
+    BinaryOpNode* b = (BinaryOpNode*)expr;
+    int64_t l_lit = 0;
+    int64_t r_lit_side = 0;
+    String l_var;
+    String r_var_side;
+    if (!affine_coefficient(b->left, plan, l_lit, l_var) || !affine_coefficient(b->right, plan, r_lit_side, r_var_side)) {
+        return false;
+    }
+    bool l_iv = l_lit != 0 || !l_var.is_empty();
+    bool r_iv = r_lit_side != 0 || !r_var_side.is_empty();
+    if (b->op == "+" || b->op == "-") {
+        bool negate = b->op == "-";
+        if (l_iv && r_iv) {
+            if (!l_var.is_empty() || !r_var_side.is_empty()) return false;
+            r_lit = negate ? l_lit - r_lit_side : l_lit + r_lit_side;
+            return true;
+        }
+        if (r_iv) {
+            if (negate && !r_var_side.is_empty()) return false;
+            r_lit = negate ? -r_lit_side : r_lit_side;
+            r_var = r_var_side;
+            return true;
+        }
+        r_lit = l_lit;
+        r_var = l_var;
+        return true;
+    }
+    if (b->op == "*") {
+        if (!l_iv && !r_iv) return true;
+        if (l_iv && r_iv) return false;
+        ExpressionNode* scale = l_iv ? b->right : b->left;
+        int64_t coeff = l_iv ? l_lit : r_lit_side;
+        const String &coeff_var = l_iv ? l_var : r_var_side;
+        Variant k;
+        if (vg_reg_literal(scale, k)) {
+            if (!coeff_var.is_empty()) return false;
+            r_lit = coeff * (int64_t)k;
+            return true;
+        }
+        if (scale->type == ExpressionNode::VARIABLE && coeff_var.is_empty() && coeff == 1) {
+            r_var = ((VariableNode*)scale)->name.to_lower();
+            return true;
+        }
+    }
+    return false;
+}
+
+// arr(counter + k) reads of a typed local array the body cannot rebind or
+// resize. Returns the array's local slot (k in r_offset), or -1.
+int VisualGasicCompiler::guarded_array_slot(ArrayAccessNode* aa, const RegLoopPlan &plan, int64_t &r_offset) const {
+    if (plan.has_calls || plan.rebound.has(plan.iv) || !reg_expr_ok(aa, VT_FLOAT)) return -1;
+    String key = ((VariableNode*)aa->base)->name.to_lower();
+    if (!frame_locals.has(key) || plan.rebound.has(key)) return -1;
+
+    ExpressionNode* idx = aa->indices[0];
+    auto is_counter = [&](ExpressionNode* node) {
+        return node && node->type == ExpressionNode::VARIABLE && ((VariableNode*)node)->name.to_lower() == plan.iv;
+    };
+    Variant k;
+    r_offset = 0;
+    if (is_counter(idx)) {
+        return local_slots[key];
+    }
+    if (idx->type != ExpressionNode::BINARY_OP) return -1;
+    BinaryOpNode* b = (BinaryOpNode*)idx;
+    if (is_counter(b->left) && (b->op == "+" || b->op == "-") &&
+            vg_reg_literal(b->right, k) && k.get_type() == Variant::INT) {
+        r_offset = b->op == "+" ? (int64_t)k : -(int64_t)k;
+        return local_slots[key];
+    }
+    if (is_counter(b->right) && b->op == "+" && vg_reg_literal(b->left, k) && k.get_type() == Variant::INT) {
+        r_offset = (int64_t)k;
+        return local_slots[key];
+    }
+    return -1;
+}
+
+// Collects the outermost candidates below expr: invariant register
+// expressions, affine functions of the counter, and guardable array reads.
+void VisualGasicCompiler::plan_loop_expr(ExpressionNode* expr, RegLoopPlan &plan, bool conditional,
+        HashMap<String, Vector<ExpressionNode*>> &r_invariant, HashMap<String, Vector<ExpressionNode*>> &r_derived,
+        HashMap<String, Vector<ExpressionNode*>> &r_guarded) {
+    if (!expr || reg_hoisted.has(expr)) return;
+    switch (expr->type) {
+        case ExpressionNode::BINARY_OP: {
+            BinaryOpNode* b = (BinaryOpNode*)expr;
+            ValueType vt = register_value_type(expr);
+            String key = vg_expr_key(expr);
+            if (vt != VT_UNKNOWN && !key.is_empty() && reg_expr_ok(expr, vt)) {
+                if (is_loop_invariant(expr, plan)) {
+                    r_invariant[key].push_back(expr);
+                    return;
+                }
+                int64_t coeff = 0;
+                String coeff_var;
+                if (vt == VT_INT && !plan.rebound.has(plan.iv) && affine_coefficient(expr, plan, coeff, coeff_var) &&
+                        (coeff != 0 || !coeff_var.is_empty())) {
+                    r_derived[key].push_back(expr);
+                    return;
+                }
+            }
+            plan_loop_expr(b->left, plan, conditional, r_invariant, r_derived, r_guarded);
+            plan_loop_expr(b->right, plan, conditional, r_invariant, r_derived, r_guarded);
+            break;
+        }
+        case ExpressionNode::UNARY_OP:
+            plan_loop_expr(((UnaryOpNode*)expr)->operand, plan, conditional, r_invariant, r_derived, r_guarded);
+            break;
+        case ExpressionNode::ARRAY_ACCESS: {
+            ArrayAccessNode* aa = (ArrayAccessNode*)expr;
+            int64_t offset = 0;
+            if (!conditional) {
+                int arr_slot = guarded_array_slot(aa, plan, offset);
+                if (arr_slot >= 0) {
+                    r_guarded[vformat("%d:%d", arr_slot, offset)].push_back(expr);
+                }
+            }
+            for (int i = 0; i < aa->indices.size(); i++) {
+                plan_loop_expr(aa->indices[i], plan, conditional, r_invariant, r_derived, r_guarded);
+            }
+            break;
+        }
+        case ExpressionNode::EXPRESSION_CALL: {
+            CallExpression* c = (CallExpression*)expr;
+            for (int i = 0; i < c->arguments.size(); i++) {
+                plan_loop_expr(c->arguments[i], plan, conditional, r_invariant, r_derived, r_guarded);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+// Emits the preheader of a register For loop (after the counter and bound
+// registers are set) and returns the latch updates for derived induction
+// registers. r_nodes lists the AST nodes redirected to preheader registers so
+// the caller can drop them once the loop is compiled.
+void VisualGasicCompiler::optimize_reg_loop(RegLoopPlan &plan, Vector<RegLoopUpdate> &r_updates, Vector<ExpressionNode*> &r_nodes) {
+    HashMap<String, Vector<ExpressionNode*>> invariant;
+    HashMap<String, Vector<ExpressionNode*>> derived;
+    HashMap<String, Vector<ExpressionNode*>> guarded;
+    // After an Exit the counter may never reach the bound, so no read is
+    // known to happen for every counter value and none can be range-guarded.
+    for (int i = 0; i < plan.roots.size(); i++) {
+        plan_loop_expr(plan.roots[i], plan, plan.may_exit, invariant, derived, guarded);
+    }
+    for (int i = 0; i < plan.cond_roots.size(); i++) {
+        plan_loop_expr(plan.cond_roots[i], plan, true, invariant, derived, guarded);
+    }
+
+    auto new_register = [&](const char *prefix, ValueType kind) -> int {
+        int slot = get_or_add_local(String(prefix) + String::num_int64(temp_local_id++), kind);
+        if (slot < 0 || slot > 0xFF) return -1;
+        register_slots[slot] = kind;
+        return slot;
+    };
+    auto redirect = [&](const Vector<ExpressionNode*> &nodes, int slot) {
+        for (int i = 0; i < nodes.size(); i++) {
+            reg_hoisted[nodes[i]] = slot;
+            r_nodes.push_back(nodes[i]);
+        }
+    };
+
+    // Invariants are always hoisted: one evaluation per loop entry instead of
+    // one per iteration, and equal expressions share the register.
+    for (const KeyValue<String, Vector<ExpressionNode*>> &entry : invariant) {
+        ExpressionNode* expr = entry.value[0];
+        ValueType kind = register_value_type(expr);
+        reset_reg_temps();
+        if (!prepare_reg_expr(expr, kind)) continue;
+        int slot = new_register("__licm_", kind);
+        if (slot < 0) return;
+        emit_reg_expr(expr, kind, slot);
+        redirect(entry.value, slot);
+    }
+
+    // Derived induction registers, chosen by cost: recomputing the
+    // expression costs one op per operator at every use, stepping it costs a
+    // single add at the latch.
+    for (const KeyValue<String, Vector<ExpressionNode*>> &entry : derived) {
+        ExpressionNode* expr = entry.value[0];
+        if (entry.value.size() * vg_reg_op_count(expr) <= 1) continue;
+        int64_t coeff = 0;
+        String coeff_var;
+        affine_coefficient(expr, plan, coeff, coeff_var);
+        reset_reg_temps();
+        if (!prepare_reg_expr(expr, VT_INT)) continue;
+        if (current_chunk->constants.size() + reg_const_planned + 2 > 0x100) continue;
+
+        RegLoopUpdate update;
+        update.const_idx = -1;
+        update.step_slot = -1;
+        int scaled = -1;
+        if (!coeff_var.is_empty()) {
+            update.step_slot = register_slot(coeff_var);
+            if (update.step_slot < 0) continue;
+            if (plan.step != 1) {
+                scaled = new_register("__licm_", VT_INT);
+                if (scaled < 0) return;
+            }
+        }
+        update.slot = new_register("__iv_", VT_INT);
+        if (update.slot < 0) return;
+        emit_reg_expr(expr, VT_INT, update.slot);
+        if (coeff_var.is_empty()) {
+            update.const_idx = current_chunk->add_constant(Variant((int64_t)(coeff * plan.step)));
+        } else if (scaled >= 0) {
+            int k = current_chunk->add_constant(Variant(plan.step));
+            emit_byte(OP_R_MULK_I64);
+            emit_byte((uint8_t)scaled);
+            emit_bytes((uint8_t)update.step_slot, (uint8_t)k);
+            update.step_slot = scaled;
+        }
+        r_updates.push_back(update);
+        redirect(entry.value, update.slot);
+    }
+
+    // Range guards: one check per (array, offset) before the loop lets every
+    // matching read in the body skip its bounds check.
+    for (const KeyValue<String, Vector<ExpressionNode*>> &entry : guarded) {
+        int64_t offset = 0;
+        int arr_slot = guarded_array_slot((ArrayAccessNode*)entry.value[0], plan, offset);
+        if (arr_slot < 0 || current_chunk->constants.size() >= 0x100) continue;
+        int k = current_chunk->add_constant(Variant(offset));
+        emit_byte(OP_R_GUARD_ARRAY);
+        emit_bytes((uint8_t)arr_slot, (uint8_t)plan.iv_slot);
+        emit_bytes((uint8_t)plan.bound_slot, (uint8_t)k);
+        for (int i = 0; i < entry.value.size(); i++) {
+            guarded_loads.insert(entry.value[i]);
+            r_nodes.push_back(entry.value[i]);
+        }
+    }
+}
+
 void VisualGasicCompiler::compile_statement(Statement* stmt) {
     current_line = stmt->line;
     expr_cache.clear();
     switch (stmt->type) {
         case STMT_PRINT: {
             PrintStatement* s = (PrintStatement*)stmt;
+            if (s->file_number) {
+                // Print # goes to an open file, which only the interpreter has.
+                compile_ok = false;
+                break;
+            }
             if (s->expression) {
                 compile_expression(s->expression);
                 emit_byte(OP_PRINT);
@@ -1704,6 +2656,7 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
         }
         case STMT_DIM: {
             DimStatement* s = (DimStatement*)stmt;
+            frame_locals.insert(s->variable_name.to_lower());
             if (s->initializer) {
                 // Initializers with casting are not supported in bytecode yet.
                 compile_ok = false;
@@ -1725,10 +2678,10 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                 else emit_byte(OP_NEW_ARRAY);
 
                 int slot = get_or_add_local(s->variable_name, VT_UNKNOWN);
-                if (slot >= 0) emit_bytes(OP_SET_LOCAL, (uint8_t)slot);
+                if (slot >= 0) emit_indexed(OP_SET_LOCAL, slot);
                 else {
                     int idx = current_chunk->add_constant(s->variable_name);
-                    emit_bytes(OP_SET_GLOBAL, (uint8_t)idx);
+                    emit_indexed(OP_SET_GLOBAL, idx);
                 }
                 break;
             } else {
@@ -1752,11 +2705,11 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                 int slot = get_or_add_local(s->variable_name, infer_type(s->initializer));
                 if (slot >= 0) {
                     emit_constant(init_val);
-                    emit_bytes(OP_SET_LOCAL, (uint8_t)slot);
+                    emit_indexed(OP_SET_LOCAL, slot);
                 } else {
                     emit_constant(init_val);
                     int idx = current_chunk->add_constant(s->variable_name);
-                    emit_bytes(OP_SET_GLOBAL, (uint8_t)idx);
+                    emit_indexed(OP_SET_GLOBAL, idx);
                 }
             }
             break;
@@ -1768,6 +2721,10 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                  if (!used_vars.has(name) && is_pure_expr(s->value)) {
                      break; // DCE
                  }
+                 int reg_slot = register_slot(name);
+                 if (reg_slot >= 0 && emit_reg_assignment(reg_slot, s->value)) {
+                     break;
+                 }
              }
              if (s->target && s->target->type == ExpressionNode::VARIABLE &&
                  s->value && s->value->type == ExpressionNode::BINARY_OP) {
@@ -1848,9 +2805,9 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                      if (get_local_type(s_name) == VT_INT && get_local_type(j_name) == VT_INT) {
                          int s_slot = get_or_add_local(s_name, VT_INT);
                          int j_slot = get_or_add_local(j_name, VT_INT);
-                         if (s_slot >= 0 && j_slot >= 0) {
-                             int k_idx = current_chunk->add_constant(Variant(k_val));
-                             int c_idx = current_chunk->add_constant(Variant(c_val));
+                         int k_idx = current_chunk->add_constant(Variant(k_val));
+                         int c_idx = current_chunk->add_constant(Variant(c_val));
+                         if (s_slot >= 0 && j_slot >= 0 && fits_byte_operands({s_slot, j_slot, k_idx, c_idx})) {
                              emit_byte(OP_ACCUM_I64_MULADD_CONST);
                              emit_byte((uint8_t)s_slot);
                              emit_byte((uint8_t)j_slot);
@@ -1871,8 +2828,7 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                     int slot = get_or_add_local(v->name, infer_type(s->value));
                     if (slot >= 0 && get_local_type(v->name) == VT_INT) {
                         compile_expression(b->right);
-                        emit_byte(b->op == "+" ? OP_ADD_LOCAL_I64_STACK : OP_SUB_LOCAL_I64_STACK);
-                        emit_byte((uint8_t)slot);
+                        emit_indexed(b->op == "+" ? OP_ADD_LOCAL_I64_STACK : OP_SUB_LOCAL_I64_STACK, slot);
                         break;
                     }
                  }
@@ -1887,8 +2843,8 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                      b->right && b->right->type == ExpressionNode::LITERAL &&
                      ((LiteralNode*)b->right)->value.get_type() == Variant::INT) {
                      int slot = get_or_add_local(v->name, get_local_type(v->name));
-                     if (slot >= 0 && get_local_type(v->name) == VT_INT) {
-                         int idx = current_chunk->add_constant(((LiteralNode*)b->right)->value);
+                     int idx = current_chunk->add_constant(((LiteralNode*)b->right)->value);
+                     if (slot >= 0 && get_local_type(v->name) == VT_INT && fits_byte_operands({slot, idx})) {
                          emit_byte(b->op == "+" ? OP_ADD_LOCAL_I64_CONST : OP_SUB_LOCAL_I64_CONST);
                          emit_byte((uint8_t)slot);
                          emit_byte((uint8_t)idx);
@@ -1902,10 +2858,10 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                  VariableNode* v = (VariableNode*)s->target;
                  int slot = get_or_add_local(v->name, infer_type(s->value));
                  if (slot >= 0) {
-                     emit_bytes(OP_SET_LOCAL, (uint8_t)slot);
+                     emit_indexed(OP_SET_LOCAL, slot);
                  } else {
                      int idx = current_chunk->add_constant(v->name);
-                     emit_bytes(OP_SET_GLOBAL, (uint8_t)idx);
+                     emit_indexed(OP_SET_GLOBAL, idx);
                  }
              } else if (s->target->type == ExpressionNode::ARRAY_ACCESS) {
                  ArrayAccessNode* aa = (ArrayAccessNode*)s->target;
@@ -1947,10 +2903,10 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                  emit_byte(opcode);
                  emit_byte(1);
                 int slot = get_or_add_local(v->name, VT_UNKNOWN);
-                if (slot >= 0) emit_bytes(OP_SET_LOCAL, (uint8_t)slot);
+                if (slot >= 0) emit_indexed(OP_SET_LOCAL, slot);
                 else {
                     int idx = current_chunk->add_constant(v->name);
-                    emit_bytes(OP_SET_GLOBAL, (uint8_t)idx);
+                    emit_indexed(OP_SET_GLOBAL, idx);
                 }
              } else if (s->target->type == ExpressionNode::EXPRESSION_CALL) {
                  CallExpression* call = (CallExpression*)s->target;
@@ -1972,10 +2928,10 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                      
                      int slot = get_or_add_local(call->method_name, VT_UNKNOWN);
                      if (slot >= 0) {
-                         emit_bytes(OP_SET_DICT_LOCAL, (uint8_t)slot);
+                         emit_indexed(OP_SET_DICT_LOCAL, slot);
                      } else {
                          int idx = current_chunk->add_constant(call->method_name);
-                         emit_bytes(OP_SET_DICT_GLOBAL, (uint8_t)idx);
+                         emit_indexed(OP_SET_DICT_GLOBAL, idx);
                      }
                      emit_byte(1);  // arg count
                  } else {
@@ -1988,10 +2944,10 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                      emit_byte(1);
 
                      int slot = get_or_add_local(call->method_name, VT_UNKNOWN);
-                     if (slot >= 0) emit_bytes(OP_SET_LOCAL, (uint8_t)slot);
+                     if (slot >= 0) emit_indexed(OP_SET_LOCAL, slot);
                      else {
                          int idx = current_chunk->add_constant(call->method_name);
-                         emit_bytes(OP_SET_GLOBAL, (uint8_t)idx);
+                         emit_indexed(OP_SET_GLOBAL, idx);
                      }
                  }
              } else if (s->target->type == ExpressionNode::MEMBER_ACCESS) {
@@ -2003,7 +2959,7 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                  compile_expression(ma->base_object);
                  compile_expression(s->value);
                  int member_idx = current_chunk->add_constant(ma->member_name);
-                 emit_bytes(OP_SET_MEMBER, (uint8_t)member_idx);
+                 emit_indexed(OP_SET_MEMBER, member_idx);
 
                  // OP_SET_MEMBER pushes the modified base back onto the stack.
                  // We need to pop it since we're not using the return value.
@@ -2023,11 +2979,24 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                     break;
                 }
             }
+            if (s->binding.kind == BIND_DECLARE) {
+                // Native calls go through the interpreter's FFI stubs.
+                compile_ok = false;
+                break;
+            }
+            if (!s->base_object && emit_user_call(s->method_name, s->arguments)) {
+                emit_byte(OP_POP);
+                break;
+            }
+            if (s->arguments.size() > 255) {
+                compile_ok = false; // Argument counts are a single byte
+                break;
+            }
             for (int i = 0; i < s->arguments.size(); i++) {
                 compile_expression(s->arguments[i]);
             }
             int idx = current_chunk->add_constant(s->method_name);
-            emit_bytes(OP_CALL, (uint8_t)idx);
+            emit_indexed(OP_CALL, idx);
             emit_byte((uint8_t)s->arguments.size());
             emit_byte(OP_POP);
             break;
@@ -2079,8 +3048,8 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                     int temp_slot = get_or_add_local(String("__alloc_") + name + String::num_int64(temp_local_id++), VT_UNKNOWN);
                     if (temp_slot >= 0) {
                         int idx = current_chunk->add_constant(name);
-                        emit_bytes(OP_GET_GLOBAL, (uint8_t)idx);
-                        emit_bytes(OP_SET_LOCAL, (uint8_t)temp_slot);
+                        emit_indexed(OP_GET_GLOBAL, idx);
+                        emit_indexed(OP_SET_LOCAL, temp_slot);
                         return temp_slot;
                     }
                     return -1;
@@ -2089,13 +3058,13 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                 int iter_slot = ensure_local_slot(alloc_iter);
                 int size_slot = ensure_local_slot(alloc_size);
 
-                if (sum_slot >= 0 && arr_slot >= 0 && tmp_slot >= 0 && iter_slot >= 0 && size_slot >= 0) {
+                int lit_idx = current_chunk->add_constant(alloc_lit);
+                if (fits_byte_operands({sum_slot, arr_slot, tmp_slot, iter_slot, size_slot, lit_idx})) {
                     ValueType iter_type = get_local_type(alloc_iter);
                     ValueType size_type = get_local_type(alloc_size);
                     if (iter_type == VT_FLOAT || size_type == VT_FLOAT) {
                         break;
                     }
-                    int lit_idx = current_chunk->add_constant(alloc_lit);
                     emit_byte(OP_ALLOC_FILL_REPEAT_I64);
                     emit_byte((uint8_t)sum_slot);
                     emit_byte((uint8_t)arr_slot);
@@ -2103,7 +3072,7 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                     emit_byte((uint8_t)lit_idx);
                     emit_byte((uint8_t)iter_slot);
                     emit_byte((uint8_t)size_slot);
-                    emit_bytes(OP_SET_LOCAL, (uint8_t)sum_slot);
+                    emit_indexed(OP_SET_LOCAL, sum_slot);
                     break;
                 }
             }
@@ -2123,10 +3092,10 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                     emit_byte(OP_ARRAY_FILL_I64_SEQ);
 
                     int slot = get_or_add_local(fill_arr, VT_UNKNOWN);
-                    if (slot >= 0) emit_bytes(OP_SET_LOCAL, (uint8_t)slot);
+                    if (slot >= 0) emit_indexed(OP_SET_LOCAL, slot);
                     else {
                         int idx = current_chunk->add_constant(fill_arr);
-                        emit_bytes(OP_SET_GLOBAL, (uint8_t)idx);
+                        emit_indexed(OP_SET_GLOBAL, idx);
                     }
                     break;
                 }
@@ -2145,16 +3114,18 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                     compile_ok = false;
                     break;
                 }
-                compile_expression(interop_inner->to_val);
-                compile_expression(f->to_val);
-
                 int lit_idx = current_chunk->add_constant(interop_lit);
-                emit_byte(OP_INTEROP_SET_NAME_LEN);
-                emit_byte((uint8_t)sum_slot);
-                emit_byte((uint8_t)lit_idx);
+                if (fits_byte_operands({sum_slot, lit_idx})) {
+                    compile_expression(interop_inner->to_val);
+                    compile_expression(f->to_val);
 
-                emit_bytes(OP_SET_LOCAL, (uint8_t)sum_slot);
-                break;
+                    emit_byte(OP_INTEROP_SET_NAME_LEN);
+                    emit_byte((uint8_t)sum_slot);
+                    emit_byte((uint8_t)lit_idx);
+
+                    emit_indexed(OP_SET_LOCAL, sum_slot);
+                    break;
+                }
             }
 
             String repeat_target;
@@ -2168,10 +3139,10 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                 emit_byte(OP_STRING_REPEAT);
 
                 int slot = get_or_add_local(repeat_target, VT_UNKNOWN);
-                if (slot >= 0) emit_bytes(OP_SET_LOCAL, (uint8_t)slot);
+                if (slot >= 0) emit_indexed(OP_SET_LOCAL, slot);
                 else {
                     int idx = current_chunk->add_constant(repeat_target);
-                    emit_bytes(OP_SET_GLOBAL, (uint8_t)idx);
+                    emit_indexed(OP_SET_GLOBAL, idx);
                 }
                 break;
             }
@@ -2180,7 +3151,9 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
             String nested_literal;
             ForStatement* inner_string = nullptr;
             if (kEnableLoopFusions && is_nested_string_concat(f, nested_target, nested_literal, inner_string)) {
-                if (inner_string && inner_string->to_val) {
+                int slot = get_or_add_local(nested_target, VT_UNKNOWN);
+                int lit_idx = current_chunk->add_constant(nested_literal);
+                if (inner_string && inner_string->to_val && fits_byte_operands({slot, lit_idx})) {
                     auto emit_loop_count = [&](ForStatement* loop) -> int {
                         int slot = get_or_add_local(String("__fused_count_") + String::num_int64(temp_local_id++), VT_INT);
                         String bound_var = extract_bound_var(loop->to_val);
@@ -2193,18 +3166,16 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                             emit_constant(Variant((int64_t)1));
                             emit_byte(OP_ADD_I64);
                         }
-                        emit_bytes(OP_SET_LOCAL, (uint8_t)slot);
+                        emit_indexed(OP_SET_LOCAL, slot);
                         return slot;
                     };
 
                     int inner_count_slot = emit_loop_count(inner_string);
                     int outer_count_slot = emit_loop_count(f);
 
-                    emit_bytes(OP_GET_LOCAL, (uint8_t)inner_count_slot);
-                    emit_bytes(OP_GET_LOCAL, (uint8_t)outer_count_slot);
+                    emit_indexed(OP_GET_LOCAL, inner_count_slot);
+                    emit_indexed(OP_GET_LOCAL, outer_count_slot);
 
-                    int slot = get_or_add_local(nested_target, VT_UNKNOWN);
-                    int lit_idx = current_chunk->add_constant(nested_literal);
                     emit_byte(OP_STRING_REPEAT_OUTER);
                     emit_byte((uint8_t)slot);
                     emit_byte((uint8_t)lit_idx);
@@ -2218,7 +3189,9 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
             int64_t arith_k = 0;
             int64_t arith_c = 0;
             if (kEnableLoopFusions && is_simple_arith_loop(f, sum_var, arith_k, arith_c)) {
-                if (f->to_val && get_local_type(sum_var) == VT_INT) {
+                int k_idx = current_chunk->add_constant(Variant(arith_k));
+                int c_idx = current_chunk->add_constant(Variant(arith_c));
+                if (f->to_val && get_local_type(sum_var) == VT_INT && fits_byte_operands({k_idx, c_idx})) {
                     compile_expression(f->to_val);
                     emit_constant(Variant((int64_t)0));
 
@@ -2226,27 +3199,28 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                     sum_node.name = sum_var;
                     compile_expression(&sum_node);
 
-                    int k_idx = current_chunk->add_constant(Variant(arith_k));
-                    int c_idx = current_chunk->add_constant(Variant(arith_c));
                     emit_byte(OP_ARITH_SUM);
                     emit_byte((uint8_t)k_idx);
                     emit_byte((uint8_t)c_idx);
 
                     int slot = get_or_add_local(sum_var, VT_INT);
-                    if (slot >= 0) emit_bytes(OP_SET_LOCAL, (uint8_t)slot);
+                    if (slot >= 0) emit_indexed(OP_SET_LOCAL, slot);
                     else {
                         int idx = current_chunk->add_constant(sum_var);
-                        emit_bytes(OP_SET_GLOBAL, (uint8_t)idx);
+                        emit_indexed(OP_SET_GLOBAL, idx);
                     }
                     break;
                 }
             }
             if (kEnableLoopFusions && is_nested_arith_loop(f, sum_var, arith_k, arith_c)) {
                 ForStatement* inner = (ForStatement*)f->body[0];
+                int k_idx = current_chunk->add_constant(Variant(arith_k));
+                int c_idx = current_chunk->add_constant(Variant(arith_c));
                 if (inner && inner->to_val && f->to_val &&
                     infer_type(inner->to_val) != VT_FLOAT &&
                     infer_type(f->to_val) != VT_FLOAT &&
-                    get_local_type(sum_var) == VT_INT) {
+                    get_local_type(sum_var) == VT_INT &&
+                    fits_byte_operands({k_idx, c_idx})) {
                     // Push inner_to, outer_to, current sum then apply closed-form arithmetic sum.
                     compile_expression(inner->to_val);
                     compile_expression(f->to_val);
@@ -2255,17 +3229,15 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                     sum_node.name = sum_var;
                     compile_expression(&sum_node);
 
-                    int k_idx = current_chunk->add_constant(Variant(arith_k));
-                    int c_idx = current_chunk->add_constant(Variant(arith_c));
                     emit_byte(OP_ARITH_SUM);
                     emit_byte((uint8_t)k_idx);
                     emit_byte((uint8_t)c_idx);
 
                     int slot = get_or_add_local(sum_var, VT_INT);
-                    if (slot >= 0) emit_bytes(OP_SET_LOCAL, (uint8_t)slot);
+                    if (slot >= 0) emit_indexed(OP_SET_LOCAL, slot);
                     else {
                         int idx = current_chunk->add_constant(sum_var);
-                        emit_bytes(OP_SET_GLOBAL, (uint8_t)idx);
+                        emit_indexed(OP_SET_GLOBAL, idx);
                     }
                     break;
                 }
@@ -2278,7 +3250,7 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                     get_local_type(branch_sum_var) == VT_INT &&
                     get_local_type(branch_flag_var) == VT_INT) {
                     int flag_slot = get_or_add_local(branch_flag_var, VT_INT);
-                    if (flag_slot >= 0) {
+                    if (fits_byte_operands({flag_slot})) {
                         auto emit_loop_count = [&](ForStatement* loop) -> int {
                             int slot = get_or_add_local(String("__fused_count_") + String::num_int64(temp_local_id++), VT_INT);
                             String bound_var = extract_bound_var(loop->to_val);
@@ -2291,15 +3263,15 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                                 emit_constant(Variant((int64_t)1));
                                 emit_byte(OP_ADD_I64);
                             }
-                            emit_bytes(OP_SET_LOCAL, (uint8_t)slot);
+                            emit_indexed(OP_SET_LOCAL, slot);
                             return slot;
                         };
 
                         int inner_count_slot = emit_loop_count(inner);
                         int outer_count_slot = emit_loop_count(f);
 
-                        emit_bytes(OP_GET_LOCAL, (uint8_t)inner_count_slot);
-                        emit_bytes(OP_GET_LOCAL, (uint8_t)outer_count_slot);
+                        emit_indexed(OP_GET_LOCAL, inner_count_slot);
+                        emit_indexed(OP_GET_LOCAL, outer_count_slot);
 
                         VariableNode sum_node;
                         sum_node.name = branch_sum_var;
@@ -2309,10 +3281,10 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                         emit_byte((uint8_t)flag_slot);
 
                         int slot = get_or_add_local(branch_sum_var, VT_INT);
-                        if (slot >= 0) emit_bytes(OP_SET_LOCAL, (uint8_t)slot);
+                        if (slot >= 0) emit_indexed(OP_SET_LOCAL, slot);
                         else {
                             int idx = current_chunk->add_constant(branch_sum_var);
-                            emit_bytes(OP_SET_GLOBAL, (uint8_t)idx);
+                            emit_indexed(OP_SET_GLOBAL, idx);
                         }
                         break;
                     }
@@ -2339,10 +3311,10 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                 emit_byte(OP_ADD_I64);
 
                 int slot = get_or_add_local(sum_var, VT_INT);
-                if (slot >= 0) emit_bytes(OP_SET_LOCAL, (uint8_t)slot);
+                if (slot >= 0) emit_indexed(OP_SET_LOCAL, slot);
                 else {
                     int idx = current_chunk->add_constant(sum_var);
-                    emit_bytes(OP_SET_GLOBAL, (uint8_t)idx);
+                    emit_indexed(OP_SET_GLOBAL, idx);
                 }
                 break;
             }
@@ -2467,10 +3439,10 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                 emit_byte(OP_ADD_I64);
 
                 int slot = get_or_add_local(sum_var, VT_INT);
-                if (slot >= 0) emit_bytes(OP_SET_LOCAL, (uint8_t)slot);
+                if (slot >= 0) emit_indexed(OP_SET_LOCAL, slot);
                 else {
                     int idx = current_chunk->add_constant(sum_var);
-                    emit_bytes(OP_SET_GLOBAL, (uint8_t)idx);
+                    emit_indexed(OP_SET_GLOBAL, idx);
                 }
                 break;
             }
@@ -2485,23 +3457,72 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
             ValueType init_type = declared_type != VT_UNKNOWN ? declared_type : infer_type(f->from_val);
             int var_slot = get_or_add_local(f->variable_name, init_type);
             ValueType loop_type = declared_type != VT_UNKNOWN ? declared_type : init_type;
-            compile_expression(f->from_val);
-            if (var_slot >= 0) {
-                emit_bytes(OP_SET_LOCAL, (uint8_t)var_slot);
+
+            // Register loop: a Long counter kept unboxed, tested against a
+            // bound register evaluated once and stepped by a positive constant.
+            bool reg_loop = false;
+            int reg_bound_slot = -1;
+            int64_t reg_step = 1;
+            if (!wide_jumps && var_slot >= 0 && var_slot <= 0xFF && register_kind(var_slot) == VT_INT) {
+                bool step_ok = true;
+                if (f->step_val) {
+                    step_ok = is_constant_expr(f->step_val) &&
+                        classify_integral_variant(eval_constant_expr(f->step_val), reg_step) && reg_step > 0;
+                }
+                HashSet<String> expr_vars;
+                HashSet<String> body_assigned;
+                collect_vars_in_expr(f->to_val, expr_vars);
+                for (int i = 0; i < f->body.size(); i++) collect_assigned_vars_stmt(f->body[i], body_assigned);
+                bool invariant = !expr_vars.has(f->variable_name.to_lower());
+                for (const String &v : expr_vars) {
+                    if (body_assigned.has(v)) { invariant = false; break; }
+                }
+                reset_reg_temps();
+                reg_loop = step_ok && invariant &&
+                    prepare_reg_expr(f->from_val, VT_INT) && prepare_reg_expr(f->to_val, VT_INT) &&
+                    current_chunk->constants.size() + reg_const_planned < 0x100;
+                if (reg_loop) {
+                    reg_bound_slot = get_or_add_local(String("__reg_to_") + String::num_int64(temp_local_id++), VT_INT);
+                    reg_loop = reg_bound_slot >= 0 && reg_bound_slot <= 0xFF;
+                }
             }
-            else {
-                int var_idx = current_chunk->add_constant(f->variable_name);
-                emit_bytes(OP_SET_GLOBAL, (uint8_t)var_idx);
+
+            int reg_step_idx = -1;
+            Vector<RegLoopUpdate> reg_updates;
+            Vector<ExpressionNode*> reg_loop_nodes;
+            if (reg_loop) {
+                register_slots[reg_bound_slot] = VT_INT;
+                emit_reg_expr(f->from_val, VT_INT, var_slot);
+                emit_reg_expr(f->to_val, VT_INT, reg_bound_slot);
+                if (reg_step != 1) {
+                    reg_step_idx = current_chunk->add_constant(Variant(reg_step));
+                }
+                RegLoopPlan plan;
+                plan.iv = f->variable_name.to_lower();
+                plan.iv_slot = var_slot;
+                plan.bound_slot = reg_bound_slot;
+                plan.step = reg_step;
+                for (int i = 0; i < f->body.size(); i++) collect_loop_facts(f->body[i], plan, false);
+                optimize_reg_loop(plan, reg_updates, reg_loop_nodes);
+            } else {
+                compile_expression(f->from_val);
+                if (var_slot >= 0) {
+                    emit_indexed(OP_SET_LOCAL, var_slot);
+                }
+                else {
+                    int var_idx = current_chunk->add_constant(f->variable_name);
+                    emit_indexed(OP_SET_GLOBAL, var_idx);
+                }
             }
 
             int to_slot = -1;
-            if (is_constant_expr(f->to_val)) {
+            if (!reg_loop && is_constant_expr(f->to_val)) {
                 to_slot = get_or_add_local(String("__const_to_") + String::num_int64(temp_local_id++), infer_type(f->to_val));
                 emit_constant(eval_constant_expr(f->to_val));
                 if (to_slot >= 0) {
-                    emit_bytes(OP_SET_LOCAL, (uint8_t)to_slot);
+                    emit_indexed(OP_SET_LOCAL, to_slot);
                 }
-            } else if (is_pure_expr(f->to_val)) {
+            } else if (!reg_loop && is_pure_expr(f->to_val)) {
                 HashSet<String> expr_vars;
                 HashSet<String> body_assigned;
                 collect_vars_in_expr(f->to_val, expr_vars);
@@ -2517,7 +3538,7 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                     to_slot = get_or_add_local(String("__inv_to_") + String::num_int64(temp_local_id++), infer_type(f->to_val));
                     compile_expression(f->to_val);
                     if (to_slot >= 0) {
-                        emit_bytes(OP_SET_LOCAL, (uint8_t)to_slot);
+                        emit_indexed(OP_SET_LOCAL, to_slot);
                     }
                 }
             }
@@ -2534,7 +3555,7 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                 step_const_is_one = true;
                 step_const_int = 1;
             }
-            if (f->step_val && is_constant_expr(f->step_val)) {
+            if (!reg_loop && f->step_val && is_constant_expr(f->step_val)) {
                 step_slot = get_or_add_local(String("__const_step_") + String::num_int64(temp_local_id++), infer_type(f->step_val));
                 Variant step_const = eval_constant_expr(f->step_val);
                 has_step_const = true;
@@ -2542,9 +3563,9 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                 step_const_is_one = step_const_is_integral && step_const_int == 1;
                 emit_constant(step_const);
                 if (step_slot >= 0) {
-                    emit_bytes(OP_SET_LOCAL, (uint8_t)step_slot);
+                    emit_indexed(OP_SET_LOCAL, step_slot);
                 }
-            } else if (f->step_val && is_pure_expr(f->step_val)) {
+            } else if (!reg_loop && f->step_val && is_pure_expr(f->step_val)) {
                 HashSet<String> expr_vars;
                 HashSet<String> body_assigned;
                 collect_vars_in_expr(f->step_val, expr_vars);
@@ -2560,29 +3581,38 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                     step_slot = get_or_add_local(String("__inv_step_") + String::num_int64(temp_local_id++), infer_type(f->step_val));
                     compile_expression(f->step_val);
                     if (step_slot >= 0) {
-                        emit_bytes(OP_SET_LOCAL, (uint8_t)step_slot);
+                        emit_indexed(OP_SET_LOCAL, step_slot);
                     }
                 }
             }
 
             int loop_start = current_chunk->code.size();
+            int exit_jump;
+
+            if (reg_loop) {
+                emit_byte(OP_R_JUMP_IF_NOT_I64);
+                emit_bytes(RCMP_LE, (uint8_t)var_slot);
+                emit_byte((uint8_t)reg_bound_slot);
+                emit_bytes(0, 0);
+                exit_jump = current_chunk->code.size() - 2;
+            } else {
+                if (var_slot >= 0) {
+                    emit_indexed(OP_GET_LOCAL, var_slot);
+                }
+                else {
+                    int var_idx = current_chunk->add_constant(f->variable_name);
+                    emit_indexed(OP_GET_GLOBAL, var_idx);
+                }
 
-            if (var_slot >= 0) {
-                emit_bytes(OP_GET_LOCAL, (uint8_t)var_slot);
-            }
-            else {
-                int var_idx = current_chunk->add_constant(f->variable_name);
-                emit_bytes(OP_GET_GLOBAL, (uint8_t)var_idx);
-            }
-
-            if (to_slot >= 0) {
-                emit_bytes(OP_GET_LOCAL, (uint8_t)to_slot);
+                if (to_slot >= 0) {
+                    emit_indexed(OP_GET_LOCAL, to_slot);
+                }
+                else compile_expression(f->to_val);
+                ValueType to_type = infer_type(f->to_val);
+                bool use_int_compare = (loop_type == VT_INT && to_type != VT_FLOAT);
+                emit_byte(use_int_compare ? OP_LESS_EQUAL_I64 : OP_LESS_EQUAL);
+                exit_jump = emit_jump(OP_JUMP_IF_FALSE);
             }
-            else compile_expression(f->to_val);
-            ValueType to_type = infer_type(f->to_val);
-            bool use_int_compare = (loop_type == VT_INT && to_type != VT_FLOAT);
-            emit_byte(use_int_compare ? OP_LESS_EQUAL_I64 : OP_LESS_EQUAL);
-            int exit_jump = emit_jump(OP_JUMP_IF_FALSE);
             auto compile_statement_list = [&](const Vector<Statement*> &stmts) {
                 for (int i = 0; i < stmts.size(); i++) {
                     Statement *stmt = stmts[i];
@@ -2604,10 +3634,10 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                                         emit_byte(OP_ALLOC_FILL_I64);
 
                                         int slot = get_or_add_local(rd_name, VT_UNKNOWN);
-                                        if (slot >= 0) emit_bytes(OP_SET_LOCAL, (uint8_t)slot);
+                                        if (slot >= 0) emit_indexed(OP_SET_LOCAL, slot);
                                         else {
                                             int idx = current_chunk->add_constant(rd_name);
-                                            emit_bytes(OP_SET_GLOBAL, (uint8_t)idx);
+                                            emit_indexed(OP_SET_GLOBAL, idx);
                                         }
                                         i++; // Skip the fill loop
                                         continue;
@@ -2624,20 +3654,39 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
 
             bool inc_local_fast = (var_slot >= 0 && has_step_const && step_const_is_one && loop_type == VT_INT);
 
-            if (inc_local_fast) {
-                emit_byte(OP_INC_LOCAL_I64);
-                emit_byte((uint8_t)var_slot);
+            if (reg_loop) {
+                if (reg_step_idx < 0) {
+                    emit_bytes(OP_R_INC_I64, (uint8_t)var_slot);
+                } else {
+                    emit_byte(OP_R_ADDK_I64);
+                    emit_byte((uint8_t)var_slot);
+                    emit_bytes((uint8_t)var_slot, (uint8_t)reg_step_idx);
+                }
+                for (int i = 0; i < reg_updates.size(); i++) {
+                    const RegLoopUpdate &update = reg_updates[i];
+                    if (update.const_idx >= 0) {
+                        emit_byte(OP_R_ADDK_I64);
+                        emit_byte((uint8_t)update.slot);
+                        emit_bytes((uint8_t)update.slot, (uint8_t)update.const_idx);
+                    } else {
+                        emit_byte(OP_R_ADD_I64);
+                        emit_byte((uint8_t)update.slot);
+                        emit_bytes((uint8_t)update.slot, (uint8_t)update.step_slot);
+                    }
+                }
+            } else if (inc_local_fast) {
+                emit_indexed(OP_INC_LOCAL_I64, var_slot);
             } else {
                 if (var_slot >= 0) {
-                    emit_bytes(OP_GET_LOCAL, (uint8_t)var_slot);
+                    emit_indexed(OP_GET_LOCAL, var_slot);
                 }
                 else {
                     int var_idx = current_chunk->add_constant(f->variable_name);
-                    emit_bytes(OP_GET_GLOBAL, (uint8_t)var_idx);
+                    emit_indexed(OP_GET_GLOBAL, var_idx);
                 }
 
                 if (step_slot >= 0) {
-                    emit_bytes(OP_GET_LOCAL, (uint8_t)step_slot);
+                    emit_indexed(OP_GET_LOCAL, step_slot);
                 }
                 else if (f->step_val) {
                     compile_expression(f->step_val);
@@ -2663,16 +3712,20 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                 }
 
                 if (var_slot >= 0) {
-                    emit_bytes(OP_SET_LOCAL, (uint8_t)var_slot);
+                    emit_indexed(OP_SET_LOCAL, var_slot);
                 }
                 else {
                     int var_idx = current_chunk->add_constant(f->variable_name);
-                    emit_bytes(OP_SET_GLOBAL, (uint8_t)var_idx);
+                    emit_indexed(OP_SET_GLOBAL, var_idx);
                 }
             }
 
             emit_loop(loop_start);
             patch_jump(exit_jump);
+            for (int i = 0; i < reg_loop_nodes.size(); i++) {
+                reg_hoisted.erase(reg_loop_nodes[i]);
+                guarded_loads.erase(reg_loop_nodes[i]);
+            }
             loop_vars.remove_at(loop_vars.size() - 1);
             loop_bound_vars.remove_at(loop_bound_vars.size() - 1);
             break;
@@ -2684,8 +3737,11 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
                 break;
             }
 
-            compile_expression(s->condition);
-            int else_jump = emit_jump(OP_JUMP_IF_FALSE);
+            int else_jump = emit_reg_branch_if_false(s->condition);
+            if (else_jump < 0) {
+                compile_expression(s->condition);
+                else_jump = emit_jump(OP_JUMP_IF_FALSE);
+            }
 
             for (int i = 0; i < s->then_branch.size(); i++) {
                 compile_statement(s->then_branch[i]);
@@ -2725,10 +3781,10 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
             else emit_byte(OP_NEW_ARRAY);
 
             int slot = get_or_add_local(s->variable_name, VT_UNKNOWN);
-            if (slot >= 0) emit_bytes(OP_SET_LOCAL, (uint8_t)slot);
+            if (slot >= 0) emit_indexed(OP_SET_LOCAL, slot);
             else {
                 int idx = current_chunk->add_constant(s->variable_name);
-                emit_bytes(OP_SET_GLOBAL, (uint8_t)idx);
+                emit_indexed(OP_SET_GLOBAL, idx);
             }
             break;
         }
@@ -2750,6 +3806,11 @@ void VisualGasicCompiler::compile_statement(Statement* stmt) {
 }
 
 void VisualGasicCompiler::compile_expression(ExpressionNode* expr) {
+    if (reg_hoisted.has(expr)) {
+        // Computed before the enclosing register loop (see optimize_reg_loop).
+        emit_indexed(OP_GET_LOCAL, reg_hoisted[expr]);
+        return;
+    }
     switch (expr->type) {
         case ExpressionNode::LITERAL: {
             LiteralNode* l = (LiteralNode*)expr;
@@ -2788,10 +3849,10 @@ void VisualGasicCompiler::compile_expression(ExpressionNode* expr) {
             VariableNode* v = (VariableNode*)expr;
             int slot = get_or_add_local(v->name, VT_UNKNOWN);
             if (slot >= 0) {
-                emit_bytes(OP_GET_LOCAL, (uint8_t)slot);
+                emit_indexed(OP_GET_LOCAL, slot);
             } else {
                 int idx = current_chunk->add_constant(v->name);
-                emit_bytes(OP_GET_GLOBAL, (uint8_t)idx);
+                emit_indexed(OP_GET_GLOBAL, idx);
             }
             break;
         }
@@ -2812,7 +3873,7 @@ void VisualGasicCompiler::compile_expression(ExpressionNode* expr) {
                 else key += ((LiteralNode*)b->right)->value.stringify();
 
                 if (expr_cache.has(key)) {
-                    emit_bytes(OP_GET_LOCAL, (uint8_t)expr_cache[key]);
+                    emit_indexed(OP_GET_LOCAL, expr_cache[key]);
                     break;
                 }
 
@@ -2826,10 +3887,10 @@ void VisualGasicCompiler::compile_expression(ExpressionNode* expr) {
                     if (lt == VT_INT && rt == VT_INT) {
                         if (b->right->type == ExpressionNode::LITERAL && ((LiteralNode*)b->right)->value.get_type() == Variant::INT) {
                             int idx = current_chunk->add_constant(((LiteralNode*)b->right)->value);
-                            emit_bytes(OP_ADD_I64_CONST, (uint8_t)idx);
+                            emit_indexed(OP_ADD_I64_CONST, idx);
                         } else if (b->left->type == ExpressionNode::LITERAL && ((LiteralNode*)b->left)->value.get_type() == Variant::INT) {
                             int idx = current_chunk->add_constant(((LiteralNode*)b->left)->value);
-                            emit_bytes(OP_ADD_I64_CONST, (uint8_t)idx);
+                            emit_indexed(OP_ADD_I64_CONST, idx);
                         } else {
                             emit_byte(OP_ADD_I64);
                         }
@@ -2841,7 +3902,7 @@ void VisualGasicCompiler::compile_expression(ExpressionNode* expr) {
                     if (lt == VT_INT && rt == VT_INT) {
                         if (b->right->type == ExpressionNode::LITERAL && ((LiteralNode*)b->right)->value.get_type() == Variant::INT) {
                             int idx = current_chunk->add_constant(((LiteralNode*)b->right)->value);
-                            emit_bytes(OP_SUB_I64_CONST, (uint8_t)idx);
+                            emit_indexed(OP_SUB_I64_CONST, idx);
                         } else {
                             emit_byte(OP_SUB_I64);
                         }
@@ -2853,10 +3914,10 @@ void VisualGasicCompiler::compile_expression(ExpressionNode* expr) {
                     if (lt == VT_INT && rt == VT_INT) {
                         if (b->right->type == ExpressionNode::LITERAL && ((LiteralNode*)b->right)->value.get_type() == Variant::INT) {
                             int idx = current_chunk->add_constant(((LiteralNode*)b->right)->value);
-                            emit_bytes(OP_MUL_I64_CONST, (uint8_t)idx);
+                            emit_indexed(OP_MUL_I64_CONST, idx);
                         } else if (b->left->type == ExpressionNode::LITERAL && ((LiteralNode*)b->left)->value.get_type() == Variant::INT) {
                             int idx = current_chunk->add_constant(((LiteralNode*)b->left)->value);
-                            emit_bytes(OP_MUL_I64_CONST, (uint8_t)idx);
+                            emit_indexed(OP_MUL_I64_CONST, idx);
                         } else {
                             emit_byte(OP_MUL_I64);
                         }
@@ -2893,8 +3954,8 @@ void VisualGasicCompiler::compile_expression(ExpressionNode* expr) {
                 }
 
                 if (cse_slot >= 0) {
-                    emit_bytes(OP_SET_LOCAL, (uint8_t)cse_slot);
-                    emit_bytes(OP_GET_LOCAL, (uint8_t)cse_slot);
+                    emit_indexed(OP_SET_LOCAL, cse_slot);
+                    emit_indexed(OP_GET_LOCAL, cse_slot);
                     expr_cache[key] = cse_slot;
                 }
                 break;
@@ -2909,10 +3970,10 @@ void VisualGasicCompiler::compile_expression(ExpressionNode* expr) {
                 if (lt == VT_INT && rt == VT_INT) {
                     if (b->right->type == ExpressionNode::LITERAL && ((LiteralNode*)b->right)->value.get_type() == Variant::INT) {
                         int idx = current_chunk->add_constant(((LiteralNode*)b->right)->value);
-                        emit_bytes(OP_ADD_I64_CONST, (uint8_t)idx);
+                        emit_indexed(OP_ADD_I64_CONST, idx);
                     } else if (b->left->type == ExpressionNode::LITERAL && ((LiteralNode*)b->left)->value.get_type() == Variant::INT) {
                         int idx = current_chunk->add_constant(((LiteralNode*)b->left)->value);
-                        emit_bytes(OP_ADD_I64_CONST, (uint8_t)idx);
+                        emit_indexed(OP_ADD_I64_CONST, idx);
                     } else {
                         emit_byte(OP_ADD_I64);
                     }
@@ -2924,7 +3985,7 @@ void VisualGasicCompiler::compile_expression(ExpressionNode* expr) {
                 if (lt == VT_INT && rt == VT_INT) {
                     if (b->right->type == ExpressionNode::LITERAL && ((LiteralNode*)b->right)->value.get_type() == Variant::INT) {
                         int idx = current_chunk->add_constant(((LiteralNode*)b->right)->value);
-                        emit_bytes(OP_SUB_I64_CONST, (uint8_t)idx);
+                        emit_indexed(OP_SUB_I64_CONST, idx);
                     } else {
                         emit_byte(OP_SUB_I64);
                     }
@@ -2936,10 +3997,10 @@ void VisualGasicCompiler::compile_expression(ExpressionNode* expr) {
                 if (lt == VT_INT && rt == VT_INT) {
                     if (b->right->type == ExpressionNode::LITERAL && ((LiteralNode*)b->right)->value.get_type() == Variant::INT) {
                         int idx = current_chunk->add_constant(((LiteralNode*)b->right)->value);
-                        emit_bytes(OP_MUL_I64_CONST, (uint8_t)idx);
+                        emit_indexed(OP_MUL_I64_CONST, idx);
                     } else if (b->left->type == ExpressionNode::LITERAL && ((LiteralNode*)b->left)->value.get_type() == Variant::INT) {
                         int idx = current_chunk->add_constant(((LiteralNode*)b->left)->value);
-                        emit_bytes(OP_MUL_I64_CONST, (uint8_t)idx);
+                        emit_indexed(OP_MUL_I64_CONST, idx);
                     } else {
                         emit_byte(OP_MUL_I64);
                     }
@@ -3018,18 +4079,26 @@ void VisualGasicCompiler::compile_expression(ExpressionNode* expr) {
             MemberAccessNode* ma = (MemberAccessNode*)expr;
             compile_expression(ma->base_object);
             int idx = current_chunk->add_constant(ma->member_name);
-            emit_bytes(OP_GET_MEMBER, (uint8_t)idx);
+            emit_indexed(OP_GET_MEMBER, idx);
             break;
         }
         case ExpressionNode::EXPRESSION_CALL: {
              CallExpression* call = (CallExpression*)expr;
-             if (call->base_object) {
-                 // Method calls on objects are not supported in bytecode yet.
+             if (call->base_object || call->binding.kind == BIND_DECLARE) {
+                 // Method calls on objects are not supported in bytecode yet;
+                 // native calls go through the interpreter's FFI stubs.
                  compile_ok = false;
                  break;
              }
 
              String call_name = call->method_name.to_lower();
+             // Inside a Function its own name is a local (the result slot), but
+             // Name(args) is still a recursive call, not an array read.
+             bool is_user_call = !array_vars.has(call_name) && !dictionary_vars.has(call_name) &&
+                 (!local_slots.has(call_name) || (current_sub && current_sub->name.nocasecmp_to(call->method_name) == 0));
+             if (is_user_call && emit_user_call(call->method_name, call->arguments)) {
+                 break;
+             }
              if (array_vars.has(call_name) || dictionary_vars.has(call_name) || local_slots.has(call_name)) {
                  if (call->arguments.size() != 1) {
                      compile_ok = false;
@@ -3072,13 +4141,27 @@ void VisualGasicCompiler::compile_expression(ExpressionNode* expr) {
                  break;
              }
 
+             int builtin_id = VisualGasicBuiltins::find_builtin_id(call->method_name, call->arguments.size());
+             if (builtin_id >= 0 && builtin_id <= 255) {
+                 for (int i = 0; i < call->arguments.size(); i++) {
+                     compile_expression(call->arguments[i]);
+                 }
+                 emit_bytes(OP_CALL_BUILTIN, (uint8_t)builtin_id);
+                 emit_byte((uint8_t)call->arguments.size());
+                 break;
+             }
+
+             if (call->arguments.size() > 255) {
+                 compile_ok = false; // Argument counts are a single byte
+                 break;
+             }
              // Push args
              for(int i=0; i<call->arguments.size(); i++) {
                  compile_expression(call->arguments[i]);
              }
              // Call
              int idx = current_chunk->add_constant(call->method_name);
-             emit_bytes(OP_CALL, (uint8_t)idx);
+             emit_indexed(OP_CALL, idx);
              emit_byte((uint8_t)call->arguments.size()); // Arg count
              break;
         }
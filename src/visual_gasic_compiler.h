@@ -6,10 +6,16 @@
 #include <godot_cpp/templates/hash_map.hpp>
 #include <godot_cpp/templates/hash_set.hpp>
 #include <godot_cpp/templates/vector.hpp>
+#include <initializer_list>
 
 using namespace VisualGasic;
 using namespace godot;
 
+// Code generation version, bumped whenever the compiler emits different
+// bytecode for the same source so cached modules (.vgc) from an older build
+// are recompiled instead of reused.
+static constexpr uint32_t VG_COMPILER_VERSION = 2;
+
 class VisualGasicCompiler {
 public:
     enum ValueType {
@@ -43,9 +49,51 @@ private:
     Vector<String> loop_bound_vars;
     int temp_local_id = 0;
     SubDefinition* current_sub = nullptr;
+    ModuleNode* current_module = nullptr;
+    HashSet<String> frame_locals; // Lower-cased locals that never mirror a global
+    bool wide_jumps = false;    // Prefix every jump with OP_WIDE (second pass for huge Subs)
+    bool jump_overflow = false; // A forward jump did not fit 16 bits in this pass
+
+    // Register tier (see BytecodeChunk::local_regs). register_slots maps a
+    // local slot to VT_INT / VT_FLOAT; temps are per-kind scratch slots reused
+    // by every register expression ([0] = Long, [1] = Double).
+    HashMap<int, ValueType> register_slots;
+    Vector<int> reg_temp_pool[2];
+    int reg_temp_used[2] = { 0, 0 };
+    int reg_temp_planned[2] = { 0, 0 };
+    int reg_const_planned = 0;
+
+    // Loop optimisation for register For loops. reg_hoisted maps a body
+    // expression to the register its value was computed into before the loop
+    // (a hoisted invariant or a derived induction variable); guarded_loads
+    // are array reads whose index range a preheader OP_R_GUARD_ARRAY checked.
+    HashMap<ExpressionNode*, int> reg_hoisted;
+    HashSet<ExpressionNode*> guarded_loads;
+
+    struct RegLoopPlan {
+        String iv;                          // Lower-cased loop counter
+        int iv_slot = -1;
+        int bound_slot = -1;
+        int64_t step = 1;
+        HashSet<String> rebound;            // Names (re)bound anywhere in the body
+        bool has_calls = false;             // Body may run user or host code
+        bool may_exit = false;              // An Exit can leave the loop early
+        int inner_loops = 0;                // Depth of inner For loops while scanning
+        Vector<ExpressionNode*> roots;      // Expressions evaluated every iteration
+        Vector<ExpressionNode*> cond_roots; // Expressions behind an If or inner loop
+    };
+    struct RegLoopUpdate {
+        int slot;       // Derived induction register
+        int const_idx;  // Per-iteration ADDK constant, or -1
+        int step_slot;  // Register added per iteration when const_idx is -1
+    };
+
+    bool compile_pass(ModuleNode* module, const String& entry_point, BytecodeChunk* chunk);
 
     void emit_byte(uint8_t byte);
     void emit_bytes(uint8_t byte1, uint8_t byte2);
+    void emit_indexed(uint8_t op, int index);
+    bool fits_byte_operands(std::initializer_list<int> operands) const;
     void emit_constant(const Variant& value);
     void emit_return();
     int emit_jump(uint8_t op);
@@ -55,6 +103,11 @@ private:
     int get_or_add_local(const String &name, ValueType type);
     ValueType get_local_type(const String &name) const;
     uint8_t to_local_type(ValueType type) const;
+    ValueType type_from_hint(const String &type_name) const;
+
+    int find_user_sub(const String &name) const;
+    bool emit_user_call(const String &name, const Vector<ExpressionNode*> &arguments);
+    void finalize_local_scopes();
 
     void collect_locals(Statement* stmt);
     void collect_used_vars_stmt(Statement* stmt);
@@ -81,6 +134,29 @@ private:
     Variant eval_constant_expr(ExpressionNode* expr) const;
     ValueType infer_type(ExpressionNode* expr) const;
 
+    void assign_register_locals(SubDefinition* sub);
+    void collect_register_blockers(Statement* stmt, HashSet<String> &out) const;
+    ValueType register_value_type(ExpressionNode* expr) const;
+    int register_slot(const String &name) const;
+    ValueType register_kind(int slot) const;
+    bool reg_expr_ok(ExpressionNode* expr, ValueType kind) const;
+    void reset_reg_temps();
+    bool prepare_reg_expr(ExpressionNode* expr, ValueType kind);
+    int take_reg_temp(ValueType kind);
+    int emit_reg_expr(ExpressionNode* expr, ValueType kind, int dst);
+    int emit_reg_copy(int slot, ValueType kind, int dst);
+    bool emit_reg_assignment(int slot, ExpressionNode* value);
+    int emit_reg_branch_if_false(ExpressionNode* condition);
+
+    void collect_loop_facts(Statement* stmt, RegLoopPlan &plan, bool conditional) const;
+    bool is_loop_invariant(ExpressionNode* expr, const RegLoopPlan &plan) const;
+    bool affine_coefficient(ExpressionNode* expr, const RegLoopPlan &plan, int64_t &r_lit, String &r_var) const;
+    int guarded_array_slot(ArrayAccessNode* aa, const RegLoopPlan &plan, int64_t &r_offset) const;
+    void plan_loop_expr(ExpressionNode* expr, RegLoopPlan &plan, bool conditional,
+            HashMap<String, Vector<ExpressionNode*>> &r_invariant, HashMap<String, Vector<ExpressionNode*>> &r_derived,
+            HashMap<String, Vector<ExpressionNode*>> &r_guarded);
+    void optimize_reg_loop(RegLoopPlan &plan, Vector<RegLoopUpdate> &r_updates, Vector<ExpressionNode*> &r_nodes);
+
     void compile_statement(Statement* stmt);
     void compile_expression(ExpressionNode* expr);
 };
@@ -0,0 +1,303 @@
+#include "visual_gasic_data_pool.h"
+#include "visual_gasic_parser.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// End of the value starting at p_from: the next comma, line break or
+// comment outside quotes and parentheses; npos if the buffer ends first.
+size_t find_value_end(const std::string &p_text, size_t p_from) {
+    bool quoted = false;
+    int depth = 0;
+    for (size_t i = p_from; i < p_text.size(); i++) {
+        char c = p_text[i];
+        if (c == '"') {
+            quoted = !quoted; // "" inside a string toggles twice
+        } else if (c == '\n') {
+            return i;
+        } else if (!quoted) {
+            if (c == '(') {
+                depth++;
+            } else if (c == ')') {
+                depth--;
+            } else if ((c == ',' || c == '\'') && depth <= 0) {
+                return i;
+            }
+        }
+    }
+    return std::string::npos;
+}
+
+// Case-insensitive match of p_text's first p_length bytes against lowercase p_word.
+bool matches_word(const char *p_text, const char *p_word, size_t p_length) {
+    for (size_t i = 0; i < p_length; i++) {
+        char c = p_text[i];
+        if ((c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c) != p_word[i]) return false;
+    }
+    return true;
+}
+
+bool starts_number(const char *p_text, size_t p_length) {
+    size_t i = (p_text[0] == '-' || p_text[0] == '+') ? 1 : 0;
+    if (i < p_length && p_text[i] == '.') i++;
+    return i < p_length && p_text[i] >= '0' && p_text[i] <= '9';
+}
+
+} // namespace
+
+void VisualGasicDataPool::clear() {
+    kinds.clear();
+    slots.clear();
+    strings.clear();
+    string_indices.clear();
+    expressions.clear();
+    streams.clear();
+    arena.clear();
+}
+
+void VisualGasicDataPool::add_expression(ExpressionNode *p_value) {
+    if (!p_value) return;
+    if (p_value->type == ExpressionNode::LITERAL) {
+        add_value(static_cast<LiteralNode *>(p_value)->value);
+        return;
+    }
+    if (p_value->type == ExpressionNode::UNARY_OP) {
+        UnaryOpNode *unary = static_cast<UnaryOpNode *>(p_value);
+        if (unary->op == "-" && unary->operand && unary->operand->type == ExpressionNode::LITERAL) {
+            const Variant &operand = static_cast<LiteralNode *>(unary->operand)->value;
+            if (operand.get_type() == Variant::INT) {
+                push(KIND_INT, -(int64_t)operand);
+                return;
+            }
+            if (operand.get_type() == Variant::FLOAT) {
+                add_value(-(double)operand);
+                return;
+            }
+        }
+    }
+    push(KIND_EXPRESSION, (int64_t)expressions.size());
+    expressions.push_back(p_value);
+}
+
+void VisualGasicDataPool::add_value(const Variant &p_value) {
+    switch (p_value.get_type()) {
+        case Variant::INT:
+            push(KIND_INT, (int64_t)p_value);
+            break;
+        case Variant::FLOAT: {
+            double value = p_value;
+            int64_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            push(KIND_FLOAT, bits);
+            break;
+        }
+        case Variant::BOOL:
+            push(KIND_BOOL, (bool)p_value ? 1 : 0);
+            break;
+        case Variant::STRING:
+            add_string(p_value);
+            break;
+        default: {
+            // No typed slot (a Color constant...): keep it as a literal node.
+            LiteralNode *literal = arena.alloc<LiteralNode>();
+            literal->value = p_value;
+            push(KIND_EXPRESSION, (int64_t)expressions.size());
+            expressions.push_back(literal);
+            break;
+        }
+    }
+}
+
+void VisualGasicDataPool::add_string(const String &p_text) {
+    const int64_t *index = string_indices.getptr(p_text);
+    if (index) {
+        push(KIND_STRING, *index);
+        return;
+    }
+    int64_t new_index = (int64_t)strings.size();
+    strings.push_back(p_text);
+    string_indices.insert(p_text, new_index);
+    push(KIND_STRING, new_index);
+}
+
+Error VisualGasicDataPool::add_file(const String &p_path) {
+    Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::READ);
+    if (file.is_null()) {
+        return FileAccess::get_open_error();
+    }
+    streams.emplace_back();
+    streams.back().file = file;
+    return OK;
+}
+
+Variant VisualGasicDataPool::get_value(int64_t p_index) const {
+    int64_t slot = slots[p_index];
+    switch (kinds[p_index]) {
+        case KIND_INT:
+            return slot;
+        case KIND_FLOAT: {
+            double value;
+            memcpy(&value, &slot, sizeof(value));
+            return value;
+        }
+        case KIND_BOOL:
+            return slot != 0;
+        case KIND_STRING:
+            return strings[slot];
+        default:
+            return Variant();
+    }
+}
+
+int64_t VisualGasicDataPool::get_memory_usage() const {
+    int64_t bytes = (int64_t)(kinds.capacity() + slots.capacity() * sizeof(int64_t) +
+            expressions.capacity() * sizeof(ExpressionNode *) + strings.capacity() * sizeof(String));
+    for (const String &s : strings) {
+        bytes += (s.length() + 1) * sizeof(char32_t);
+    }
+    for (const Stream &stream : streams) {
+        bytes += (int64_t)stream.buffer.capacity();
+    }
+    return bytes + (int64_t)arena.get_bytes_allocated();
+}
+
+bool VisualGasicDataPool::load_until(int64_t p_index) {
+    while (p_index >= (int64_t)kinds.size() && !streams.empty()) {
+        if (!parse_next(streams.front())) {
+            streams.front().file->close();
+            streams.pop_front();
+        }
+    }
+    return p_index < (int64_t)kinds.size();
+}
+
+bool VisualGasicDataPool::refill(Stream &p_stream) {
+    if (p_stream.file->eof_reached()) {
+        return false;
+    }
+    PackedByteArray chunk = p_stream.file->get_buffer(CHUNK_SIZE);
+    if (chunk.is_empty()) {
+        return false;
+    }
+    bool first = p_stream.file->get_position() == (uint64_t)chunk.size();
+    p_stream.buffer.erase(0, p_stream.pos);
+    p_stream.pos = 0;
+    p_stream.buffer.append((const char *)chunk.ptr(), chunk.size());
+    if (first && p_stream.buffer.compare(0, 3, "\xEF\xBB\xBF") == 0) {
+        p_stream.pos = 3; // UTF-8 BOM
+    }
+    return true;
+}
+
+bool VisualGasicDataPool::parse_next(Stream &p_stream) {
+    while (true) {
+        if (p_stream.pos >= p_stream.buffer.size() && !refill(p_stream)) {
+            return false;
+        }
+        char c = p_stream.buffer[p_stream.pos];
+        if (c == '\n') {
+            p_stream.pos++;
+            p_stream.line_start = true;
+            continue;
+        }
+        if (is_blank(c)) {
+            p_stream.pos++;
+            continue;
+        }
+        if (c == ',') {
+            p_stream.pos++;
+            p_stream.line_start = false;
+            continue;
+        }
+        if (c == '\'') {
+            // Comment: skip to the line break, which ends it.
+            while (true) {
+                size_t eol = p_stream.buffer.find('\n', p_stream.pos);
+                if (eol != std::string::npos) {
+                    p_stream.pos = eol;
+                    break;
+                }
+                p_stream.pos = p_stream.buffer.size();
+                if (!refill(p_stream)) return false;
+            }
+            continue;
+        }
+        if (p_stream.line_start) {
+            p_stream.line_start = false;
+            while (p_stream.buffer.size() - p_stream.pos < 5 && refill(p_stream)) {
+            }
+            const char *word = p_stream.buffer.data() + p_stream.pos;
+            if (p_stream.buffer.size() - p_stream.pos >= 4 && matches_word(word, "data", 4) &&
+                    (p_stream.buffer.size() - p_stream.pos == 4 || is_blank(word[4]) || word[4] == '\n')) {
+                p_stream.pos += 4;
+                continue;
+            }
+        }
+
+        size_t end;
+        while ((end = find_value_end(p_stream.buffer, p_stream.pos)) == std::string::npos) {
+            if (!refill(p_stream)) {
+                end = p_stream.buffer.size();
+                break;
+            }
+        }
+        add_field(p_stream.buffer.data() + p_stream.pos, end - p_stream.pos);
+        p_stream.pos = end;
+        return true;
+    }
+}
+
+void VisualGasicDataPool::add_field(const char *p_text, size_t p_length) {
+    while (p_length > 0 && is_blank(p_text[p_length - 1])) {
+        p_length--;
+    }
+    if (p_length == 0) return;
+
+    if (p_text[0] == '"' && p_length >= 2 && p_text[p_length - 1] == '"') {
+        std::string text;
+        size_t i = 1;
+        for (; i < p_length - 1; i++) {
+            if (p_text[i] == '"') {
+                if (p_text[i + 1] != '"') break; // Quote inside: an expression
+                i++;
+            }
+            text.push_back(p_text[i]);
+        }
+        if (i == p_length - 1) {
+            add_string(String::utf8(text.data(), (int64_t)text.size()));
+            return;
+        }
+    } else if (p_length == 4 && matches_word(p_text, "true", 4)) {
+        push(KIND_BOOL, 1);
+        return;
+    } else if (p_length == 5 && matches_word(p_text, "false", 5)) {
+        push(KIND_BOOL, 0);
+        return;
+    } else if (starts_number(p_text, p_length)) {
+        std::string number(p_text, p_length);
+        char *end = nullptr;
+        errno = 0;
+        long long integer = strtoll(number.c_str(), &end, 10);
+        if (*end == '\0' && errno == 0) {
+            push(KIND_INT, (int64_t)integer);
+            return;
+        }
+        double real = strtod(number.c_str(), &end);
+        if (*end == '\0') {
+            add_value(real);
+            return;
+        }
+    }
+
+    // Anything else (Vector2(1, 2), &HFF, a constant) goes through the parser.
+    Vector<ExpressionNode *> values = VisualGasicParser::parse_data_values_from_text(String::utf8(p_text, (int64_t)p_length), arena);
+    for (int i = 0; i < values.size(); i++) {
+        add_expression(values[i]);
+    }
+}
@@ -0,0 +1,102 @@
+#ifndef VISUAL_GASIC_DATA_POOL_H
+#define VISUAL_GASIC_DATA_POOL_H
+
+#include "visual_gasic_ast.h"
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/variant/string.hpp>
+#include <godot_cpp/variant/variant.hpp>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+using namespace godot;
+using namespace VisualGasic;
+
+// The values READ walks through: every DATA statement of the module, in
+// source order, followed by the files LoadData appended.
+//
+// Values are stored typed, one kind byte and one 8-byte slot each: an
+// int64, a double's bits, a Boolean, or an index into a table of distinct
+// strings. A DATA value that is not a literal (Vector2(1, 2), a constant)
+// keeps its expression node and is evaluated by READ as before.
+//
+// LoadData does not read the file up front: the file is queued and its
+// values are parsed from 64 KB chunks as READ reaches them, so a large
+// table costs nothing until it is read and never exists as text or as AST
+// nodes. Values once parsed stay in the pool, so Restore can go back.
+// Data files hold values separated by commas or line breaks; a "Data"
+// keyword at the start of a line and ' comments are allowed.
+class VisualGasicDataPool {
+public:
+    enum Kind : uint8_t {
+        KIND_INT,
+        KIND_FLOAT,
+        KIND_BOOL,
+        KIND_STRING,
+        KIND_EXPRESSION,
+    };
+    static constexpr int64_t CHUNK_SIZE = 64 * 1024;
+
+    VisualGasicDataPool() {}
+    VisualGasicDataPool(const VisualGasicDataPool &) = delete;
+    VisualGasicDataPool &operator=(const VisualGasicDataPool &) = delete;
+
+    void clear();
+
+    // A DATA value: literals (and negated numbers) are stored typed, other
+    // expressions by node. The node must outlive the pool's use of it.
+    void add_expression(ExpressionNode *p_value);
+    void add_value(const Variant &p_value);
+    // Queues a LoadData file. Fails only if the file cannot be opened.
+    Error add_file(const String &p_path);
+
+    // Parses queued files until p_index exists; false if the data ends first.
+    bool ensure(int64_t p_index) {
+        return p_index < (int64_t)kinds.size() || load_until(p_index);
+    }
+    // Values available without parsing further.
+    int64_t size() const { return (int64_t)kinds.size(); }
+    bool has_pending_files() const { return !streams.empty(); }
+
+    Kind get_kind(int64_t p_index) const { return (Kind)kinds[p_index]; }
+    // The value at p_index (which must exist); Nil for KIND_EXPRESSION.
+    Variant get_value(int64_t p_index) const;
+    ExpressionNode *get_expression(int64_t p_index) const {
+        return kinds[p_index] == KIND_EXPRESSION ? expressions[slots[p_index]] : nullptr;
+    }
+
+    // Bytes held by the parsed values and the string table.
+    int64_t get_memory_usage() const;
+
+private:
+    struct Stream {
+        Ref<FileAccess> file;
+        std::string buffer; // Unparsed text, from `pos`
+        size_t pos = 0;
+        bool line_start = true;
+    };
+
+    bool load_until(int64_t p_index);
+    // Parses the next value of p_stream into the pool; false at its end.
+    bool parse_next(Stream &p_stream);
+    // Reads another chunk into the buffer; false at the end of the file.
+    bool refill(Stream &p_stream);
+    void add_field(const char *p_text, size_t p_length);
+    void add_string(const String &p_text);
+    void push(Kind p_kind, int64_t p_slot) {
+        kinds.push_back(p_kind);
+        slots.push_back(p_slot);
+    }
+
+    std::vector<uint8_t> kinds;
+    std::vector<int64_t> slots;
+    std::vector<String> strings; // Distinct strings, by first appearance
+    HashMap<String, int64_t> string_indices;
+    std::vector<ExpressionNode *> expressions;
+    std::deque<Stream> streams; // Queued LoadData files, front one first
+    ASTArena arena; // Expression values parsed out of data files
+};
+
+#endif // VISUAL_GASIC_DATA_POOL_H
@@ -0,0 +1,206 @@
+#include "visual_gasic_draw_batch.h"
+#include <godot_cpp/classes/rendering_server.hpp>
+#include <godot_cpp/core/math.hpp>
+#include <godot_cpp/core/object.hpp>
+#include <cstring>
+
+namespace {
+
+// Above this many pending triangle vertices the batch is flushed early, so
+// one OnDraw that plots a whole screen does not build one huge array.
+constexpr size_t MAX_BATCH_VERTICES = 65536;
+
+template <typename T, typename P>
+void copy_to_packed(const std::vector<T> &p_from, P &r_to) {
+    r_to.resize(p_from.size());
+    if (!p_from.empty()) {
+        memcpy(r_to.ptrw(), p_from.data(), p_from.size() * sizeof(T));
+    }
+}
+
+} // namespace
+
+void VisualGasicDrawBatch::begin(CanvasItem *p_canvas) {
+    flush();
+    canvas = p_canvas;
+}
+
+void VisualGasicDrawBatch::flush() {
+    flush_lines();
+    flush_triangles();
+}
+
+void VisualGasicDrawBatch::end() {
+    flush();
+    canvas = nullptr;
+}
+
+void VisualGasicDrawBatch::flush_lines() {
+    if (line_points.empty()) return;
+    if (canvas) {
+        copy_to_packed(line_points, packed_points);
+        copy_to_packed(line_colors, packed_colors);
+        canvas->draw_multiline_colors(packed_points, packed_colors, line_width);
+        flush_count++;
+    }
+    line_points.clear();
+    line_colors.clear();
+}
+
+void VisualGasicDrawBatch::flush_triangles() {
+    if (tri_points.empty()) return;
+    if (canvas) {
+        copy_to_packed(tri_points, packed_points);
+        copy_to_packed(tri_colors, packed_colors);
+        copy_to_packed(tri_indices, packed_indices);
+        RenderingServer::get_singleton()->canvas_item_add_triangle_array(canvas->get_canvas_item(), packed_indices, packed_points, packed_colors);
+        flush_count++;
+    }
+    tri_points.clear();
+    tri_colors.clear();
+    tri_indices.clear();
+}
+
+void VisualGasicDrawBatch::add_line(const Vector2 &p_from, const Vector2 &p_to, const Color &p_color, float p_width) {
+    flush_triangles();
+    if (!line_points.empty() && p_width != line_width) {
+        flush_lines();
+    }
+    line_width = p_width;
+    line_points.push_back(p_from);
+    line_points.push_back(p_to);
+    // draw_multiline_colors takes one color per segment.
+    line_colors.push_back(p_color);
+}
+
+void VisualGasicDrawBatch::add_quad(const Vector2 &p_a, const Vector2 &p_b, const Vector2 &p_c, const Vector2 &p_d, const Color &p_color) {
+    flush_lines();
+    if (tri_points.size() + 4 > MAX_BATCH_VERTICES) {
+        flush_triangles();
+    }
+    int32_t base = (int32_t)tri_points.size();
+    tri_points.push_back(p_a);
+    tri_points.push_back(p_b);
+    tri_points.push_back(p_c);
+    tri_points.push_back(p_d);
+    tri_colors.insert(tri_colors.end(), 4, p_color);
+    const int32_t quad[6] = { base, base + 1, base + 2, base, base + 2, base + 3 };
+    tri_indices.insert(tri_indices.end(), quad, quad + 6);
+}
+
+void VisualGasicDrawBatch::add_pixel(const Vector2 &p_pos, const Color &p_color) {
+    add_quad(p_pos, p_pos + Vector2(1, 0), p_pos + Vector2(1, 1), p_pos + Vector2(0, 1), p_color);
+}
+
+void VisualGasicDrawBatch::add_rect(const Rect2 &p_rect, const Color &p_color, bool p_filled, float p_width) {
+    Vector2 a = p_rect.position;
+    Vector2 b = a + Vector2(p_rect.size.x, 0);
+    Vector2 c = a + p_rect.size;
+    Vector2 d = a + Vector2(0, p_rect.size.y);
+    if (p_filled) {
+        add_quad(a, b, c, d, p_color);
+    } else {
+        add_line(a, b, p_color, p_width);
+        add_line(b, c, p_color, p_width);
+        add_line(c, d, p_color, p_width);
+        add_line(d, a, p_color, p_width);
+    }
+}
+
+void VisualGasicDrawBatch::add_circle(const Vector2 &p_center, float p_radius, const Color &p_color) {
+    if (p_radius <= 0.0f) return;
+    // About one segment per pixel of radius, as smooth as draw_circle at
+    // 64 and no worse than an octagon for dots.
+    int segments = CLAMP((int)p_radius, 8, 64);
+    flush_lines();
+    if (tri_points.size() + segments + 1 > MAX_BATCH_VERTICES) {
+        flush_triangles();
+    }
+    int32_t center = (int32_t)tri_points.size();
+    tri_points.push_back(p_center);
+    for (int i = 0; i < segments; i++) {
+        float angle = (float)Math_TAU * i / segments;
+        tri_points.push_back(p_center + Vector2(Math::cos(angle), Math::sin(angle)) * p_radius);
+    }
+    tri_colors.insert(tri_colors.end(), segments + 1, p_color);
+    for (int i = 0; i < segments; i++) {
+        const int32_t fan[3] = { center, center + 1 + i, center + 1 + (i + 1) % segments };
+        tri_indices.insert(tri_indices.end(), fan, fan + 3);
+    }
+}
+
+void VisualGasicDrawBatch::set_framebuffer(CanvasItem *p_canvas, int p_width, int p_height, int p_scale) {
+    fb_image.unref();
+    fb_texture.unref();
+    fb_ptr = nullptr;
+    fb_dirty = false;
+    fb_canvas = p_canvas ? p_canvas->get_instance_id() : 0;
+    if (p_width <= 0 || p_height <= 0) {
+        fb_width = 0;
+        fb_height = 0;
+        fb_pixels = PackedByteArray();
+        if (p_canvas) p_canvas->queue_redraw();
+        return;
+    }
+    fb_width = p_width;
+    fb_height = p_height;
+    fb_scale = MAX(p_scale, 1);
+    fb_pixels.resize((int64_t)fb_width * fb_height * 4);
+    if (p_canvas) {
+        p_canvas->set_texture_filter(CanvasItem::TEXTURE_FILTER_NEAREST);
+    }
+    framebuffer_clear(Color(0, 0, 0, 1));
+}
+
+uint8_t *VisualGasicDrawBatch::mark_framebuffer_dirty() {
+    // ptrw() copies the buffer if the image from the last upload still
+    // shares it; the pointer then stays valid until the next upload.
+    fb_ptr = fb_pixels.ptrw();
+    fb_dirty = true;
+    if (CanvasItem *ci = Object::cast_to<CanvasItem>(ObjectDB::get_instance(fb_canvas))) {
+        ci->queue_redraw();
+    }
+    return fb_ptr;
+}
+
+Color VisualGasicDrawBatch::framebuffer_pget(int p_x, int p_y) const {
+    if ((unsigned)p_x >= (unsigned)fb_width || (unsigned)p_y >= (unsigned)fb_height) {
+        return Color(0, 0, 0, 0);
+    }
+    const uint8_t *px = fb_pixels.ptr() + ((int64_t)p_y * fb_width + p_x) * 4;
+    return Color(px[0] / 255.0f, px[1] / 255.0f, px[2] / 255.0f, px[3] / 255.0f);
+}
+
+void VisualGasicDrawBatch::framebuffer_clear(const Color &p_color) {
+    if (!has_framebuffer()) return;
+    uint8_t *px = fb_dirty ? fb_ptr : mark_framebuffer_dirty();
+    const uint8_t rgba[4] = { to_byte(p_color.r), to_byte(p_color.g), to_byte(p_color.b), to_byte(p_color.a) };
+    int64_t count = (int64_t)fb_width * fb_height;
+    for (int64_t i = 0; i < count; i++) {
+        memcpy(px + i * 4, rgba, 4);
+    }
+}
+
+bool VisualGasicDrawBatch::upload_framebuffer() {
+    if (!has_framebuffer() || !fb_dirty) return false;
+    if (fb_image.is_null()) {
+        fb_image = Image::create_from_data(fb_width, fb_height, false, Image::FORMAT_RGBA8, fb_pixels);
+    } else {
+        fb_image->set_data(fb_width, fb_height, false, Image::FORMAT_RGBA8, fb_pixels);
+    }
+    if (fb_texture.is_null()) {
+        fb_texture = ImageTexture::create_from_image(fb_image);
+    } else {
+        fb_texture->update(fb_image);
+    }
+    fb_dirty = false;
+    fb_ptr = nullptr;
+    return true;
+}
+
+void VisualGasicDrawBatch::draw_framebuffer(CanvasItem *p_canvas) {
+    upload_framebuffer();
+    if (p_canvas && fb_texture.is_valid()) {
+        p_canvas->draw_texture_rect(fb_texture, Rect2(0, 0, fb_width * fb_scale, fb_height * fb_scale), false);
+    }
+}
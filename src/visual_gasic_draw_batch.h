@@ -0,0 +1,111 @@
+#ifndef VISUAL_GASIC_DRAW_BATCH_H
+#define VISUAL_GASIC_DRAW_BATCH_H
+
+#include <godot_cpp/classes/canvas_item.hpp>
+#include <godot_cpp/classes/image.hpp>
+#include <godot_cpp/classes/image_texture.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/packed_color_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_vector2_array.hpp>
+#include <cstdint>
+#include <vector>
+
+using namespace godot;
+
+// Immediate-mode 2D drawing for one script instance (PSet, DrawLine,
+// DrawRect, DrawCircle).
+//
+// Batched mode: between begin() and end(), which the instance calls around
+// OnDraw, shapes are collected instead of drawn one CanvasItem call at a
+// time. Lines go into one vertex/color array per line width, flushed with
+// draw_multiline_colors; pixels, filled rectangles and circles are
+// triangulated into one indexed triangle array, flushed with a single
+// canvas_item_add_triangle_array. The arrays are std::vectors that keep
+// their capacity between frames and are copied into packed arrays once per
+// flush. Switching between the two kinds (or line widths) flushes, so
+// overlapping shapes keep their order; anything drawn directly (DrawText)
+// must call flush() first.
+//
+// Framebuffer mode (SetFramebuffer): PSet writes RGBA8 pixels into memory,
+// from any event, and the owner is redrawn once per frame with the pixels
+// uploaded as one texture, scaled by an integer factor.
+class VisualGasicDrawBatch {
+public:
+    void begin(CanvasItem *p_canvas);
+    void flush();
+    void end();
+    // True between begin() and end(): shapes are batched.
+    bool is_active() const { return canvas != nullptr; }
+
+    void add_pixel(const Vector2 &p_pos, const Color &p_color);
+    void add_line(const Vector2 &p_from, const Vector2 &p_to, const Color &p_color, float p_width);
+    // Outlines use p_width like add_line (-1 for a thin line).
+    void add_rect(const Rect2 &p_rect, const Color &p_color, bool p_filled, float p_width = -1.0f);
+    void add_circle(const Vector2 &p_center, float p_radius, const Color &p_color);
+
+    // Pending (not yet flushed) vertices, and totals since construction.
+    int get_pending_line_vertices() const { return (int)line_points.size(); }
+    int get_pending_triangle_vertices() const { return (int)tri_points.size(); }
+    int64_t get_flush_count() const { return flush_count; }
+
+    // Turns the framebuffer on at p_width x p_height, cleared to opaque
+    // black, shown at p_scale; a size of 0 turns it off. p_canvas (may be
+    // null) is redrawn whenever pixels change and gets nearest filtering.
+    void set_framebuffer(CanvasItem *p_canvas, int p_width, int p_height, int p_scale);
+    bool has_framebuffer() const { return fb_width > 0; }
+    int get_framebuffer_width() const { return fb_width; }
+    int get_framebuffer_height() const { return fb_height; }
+    // Out-of-range coordinates are ignored, as in VB.
+    void framebuffer_pset(int p_x, int p_y, const Color &p_color) {
+        if ((unsigned)p_x >= (unsigned)fb_width || (unsigned)p_y >= (unsigned)fb_height) {
+            return;
+        }
+        uint8_t *px = (fb_dirty ? fb_ptr : mark_framebuffer_dirty()) + ((int64_t)p_y * fb_width + p_x) * 4;
+        px[0] = to_byte(p_color.r);
+        px[1] = to_byte(p_color.g);
+        px[2] = to_byte(p_color.b);
+        px[3] = to_byte(p_color.a);
+    }
+    Color framebuffer_pget(int p_x, int p_y) const;
+    void framebuffer_clear(const Color &p_color);
+    // Uploads the pixels if they changed since the last upload. Returns
+    // true if the texture was updated.
+    bool upload_framebuffer();
+    // Uploads if needed and draws the framebuffer texture on p_canvas.
+    void draw_framebuffer(CanvasItem *p_canvas);
+
+private:
+    static uint8_t to_byte(float p_value) {
+        return p_value <= 0.0f ? 0 : (p_value >= 1.0f ? 255 : (uint8_t)(p_value * 255.0f + 0.5f));
+    }
+    // Starts a new frame of pixel writes; returns the writable pixels.
+    uint8_t *mark_framebuffer_dirty();
+    void flush_lines();
+    void flush_triangles();
+    void add_quad(const Vector2 &p_a, const Vector2 &p_b, const Vector2 &p_c, const Vector2 &p_d, const Color &p_color);
+
+    CanvasItem *canvas = nullptr;
+    std::vector<Vector2> line_points; // Pairs of segment end points
+    std::vector<Color> line_colors;
+    float line_width = -1.0f;
+    std::vector<Vector2> tri_points;
+    std::vector<Color> tri_colors;
+    std::vector<int32_t> tri_indices;
+    PackedVector2Array packed_points; // Flush staging, reused
+    PackedColorArray packed_colors;
+    PackedInt32Array packed_indices;
+    int64_t flush_count = 0;
+
+    int fb_width = 0;
+    int fb_height = 0;
+    int fb_scale = 1;
+    PackedByteArray fb_pixels;
+    uint8_t *fb_ptr = nullptr; // fb_pixels.ptrw() while fb_dirty
+    bool fb_dirty = false;
+    uint64_t fb_canvas = 0; // Instance ID of the CanvasItem to redraw
+    Ref<Image> fb_image;
+    Ref<ImageTexture> fb_texture;
+};
+
+#endif // VISUAL_GASIC_DRAW_BATCH_H
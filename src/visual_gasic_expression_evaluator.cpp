@@ -67,18 +67,21 @@ Variant VisualGasicExpressionEvaluator::evaluate(ExpressionNode* expr, Context&
         return Variant();
     }
     if (expr->type == ExpressionNode::VARIABLE) {
-        String name = ((VariableNode*)expr)->name;
-        if (name.nocasecmp_to("FreeFile") == 0) {
+        VariableNode* var = (VariableNode*)expr;
+        String name = var->name;
+        // FreeFile and Godot win over a variable of the same name.
+        if (name.length() == 8 && name.nocasecmp_to("FreeFile") == 0) {
             for(int i=1; i<=255; i++) {
                 if (!ctx.open_files.has(i)) return i;
             }
             UtilityFunctions::print("Too many files open");
             return 0;
         }
-        if (name.nocasecmp_to("Godot") == 0) {
+        if (name.length() == 5 && name.nocasecmp_to("Godot") == 0) {
             return Engine::get_singleton();
         }
-        if (ctx.variables.has(name)) return ctx.variables[name];
+        int slot = ctx.variables.find_hinted(var->name, var->slot_hint);
+        if (slot >= 0 && ctx.variables.is_bound(slot)) return ctx.variables.get_slot(slot);
         if (ctx.owner) {
             Variant ret = ctx.owner->get(name);
             if (ret.get_type() != Variant::NIL) return ret;
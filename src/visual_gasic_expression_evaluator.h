@@ -2,6 +2,7 @@
 #define VISUAL_GASIC_EXPRESSION_EVALUATOR_H
 
 #include "visual_gasic_ast.h"
+#include "visual_gasic_global_slots.h"
 #include <godot_cpp/variant/variant.hpp>
 #include <godot_cpp/core/object.hpp>
 #include <godot_cpp/variant/dictionary.hpp>
@@ -9,18 +10,21 @@
 #include <godot_cpp/variant/callable.hpp>
 #include <godot_cpp/variant/node_path.hpp>
 #include <godot_cpp/classes/dir_access.hpp>
+#include <godot_cpp/templates/hash_map.hpp>
 #include <godot_cpp/templates/vector.hpp>
 
 using namespace godot;
 using namespace VisualGasic;
 
+class VisualGasicFile;
+
 class VisualGasicExpressionEvaluator {
 public:
     // Context struct to provide access to variables, owner, etc.
     struct Context {
-        Dictionary& variables;
+        GlobalSlotTable& variables;
         Object* owner;
-        Dictionary& open_files;
+        HashMap<int, VisualGasicFile *>& open_files;
         Ref<DirAccess>& current_dir;
         String& dir_pattern;
         bool& option_compare_text;
@@ -0,0 +1,197 @@
+#include "visual_gasic_ffi.h"
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+#include <dlfcn.h>
+#include <mutex>
+
+namespace {
+
+union FFIValue {
+    uint8_t u8;
+    int16_t i16;
+    int32_t i32;
+    int64_t i64;
+    float f32;
+    double f64;
+    const char *str;
+    void *ptr;
+};
+
+ffi_type *ffi_type_for(VisualGasicFFIStub::Kind p_kind) {
+    switch (p_kind) {
+        case VisualGasicFFIStub::KIND_VOID: return &ffi_type_void;
+        case VisualGasicFFIStub::KIND_BYTE: return &ffi_type_uint8;
+        case VisualGasicFFIStub::KIND_SHORT: return &ffi_type_sint16;
+        case VisualGasicFFIStub::KIND_INTEGER: return &ffi_type_sint32;
+        case VisualGasicFFIStub::KIND_LONG: return &ffi_type_sint64;
+        case VisualGasicFFIStub::KIND_SINGLE: return &ffi_type_float;
+        case VisualGasicFFIStub::KIND_DOUBLE: return &ffi_type_double;
+        case VisualGasicFFIStub::KIND_BOOLEAN: return &ffi_type_sint32;
+        case VisualGasicFFIStub::KIND_STRING:
+        case VisualGasicFFIStub::KIND_POINTER: return &ffi_type_pointer;
+    }
+    return &ffi_type_pointer;
+}
+
+std::mutex library_mutex;
+HashMap<String, void *> loaded_libraries; // Declare lib name -> dlopen handle, never closed
+
+void *load_library(const String &p_lib_name, String &r_error) {
+    std::lock_guard<std::mutex> lock(library_mutex);
+    if (void **handle = loaded_libraries.getptr(p_lib_name)) {
+        return *handle;
+    }
+    String lib_path = p_lib_name;
+#ifdef __linux__
+    if (!lib_path.ends_with(".so") && !lib_path.ends_with(".so.0")) {
+        if (!lib_path.begins_with("lib")) {
+            lib_path = "lib" + lib_path;
+        }
+        lib_path += ".so";
+    }
+#elif defined(_WIN32)
+    if (!lib_path.ends_with(".dll")) {
+        lib_path += ".dll";
+    }
+#endif
+    void *handle = dlopen(lib_path.utf8().get_data(), RTLD_LAZY);
+    if (!handle) {
+        r_error = "Error loading library '" + p_lib_name + "': " + String(dlerror());
+        return nullptr;
+    }
+    loaded_libraries.insert(p_lib_name, handle);
+    UtilityFunctions::print("Loaded library: ", p_lib_name);
+    return handle;
+}
+
+} // namespace
+
+VisualGasicFFIStub *VisualGasicFFIStub::create(const DeclareStatement *p_decl, String &r_error) {
+    void *lib_handle = load_library(p_decl->lib_name, r_error);
+    if (!lib_handle) {
+        return nullptr;
+    }
+    String func_name = p_decl->alias_name.is_empty() ? p_decl->name : p_decl->alias_name;
+    dlerror(); // Clear any earlier error
+    void *func_ptr = dlsym(lib_handle, func_name.utf8().get_data());
+    const char *error = dlerror();
+    if (error || !func_ptr) {
+        r_error = "Error finding function '" + func_name + "': " + String(error ? error : "null symbol");
+        return nullptr;
+    }
+    VisualGasicFFIStub *stub = memnew(VisualGasicFFIStub);
+    if (!stub->prepare(func_ptr, p_decl, r_error)) {
+        memdelete(stub);
+        return nullptr;
+    }
+    return stub;
+}
+
+// Integer keeps the C int width the interpreter has always passed it as.
+VisualGasicFFIStub::Kind VisualGasicFFIStub::kind_of(const String &p_type) {
+    String type = p_type.to_lower();
+    if (type == "byte") return KIND_BYTE;
+    if (type == "short") return KIND_SHORT;
+    if (type == "integer") return KIND_INTEGER;
+    if (type == "long" || type == "longlong") return KIND_LONG;
+    if (type == "single") return KIND_SINGLE;
+    if (type == "double") return KIND_DOUBLE;
+    if (type == "string") return KIND_STRING;
+    if (type == "boolean") return KIND_BOOLEAN;
+    return KIND_POINTER;
+}
+
+bool VisualGasicFFIStub::prepare(void *p_function, const DeclareStatement *p_decl, String &r_error) {
+    function = p_function;
+    int count = p_decl->param_types.size();
+    arg_kinds.resize(count);
+    arg_types.resize(count);
+    string_count = 0;
+    for (int i = 0; i < count; i++) {
+        Kind kind = kind_of(p_decl->param_types[i]);
+        arg_kinds.write[i] = kind;
+        arg_types.write[i] = ffi_type_for(kind);
+        if (kind == KIND_STRING) {
+            string_count++;
+        }
+    }
+    return_kind = p_decl->return_type.is_empty() ? KIND_VOID : kind_of(p_decl->return_type);
+
+    if (ffi_prep_cif(&cif, FFI_DEFAULT_ABI, count, ffi_type_for(return_kind), count ? arg_types.ptrw() : nullptr) != FFI_OK) {
+        r_error = "Unsupported signature for Declare " + p_decl->name;
+        function = nullptr;
+        return false;
+    }
+    return true;
+}
+
+Variant VisualGasicFFIStub::call(const Variant *p_args, int p_count) const {
+    // Most native helpers take a handful of arguments: keep those on the stack.
+    static constexpr int INLINE_ARGS = 16;
+    FFIValue inline_values[INLINE_ARGS];
+    void *inline_slots[INLINE_ARGS];
+    Vector<FFIValue> heap_values;
+    Vector<void *> heap_slots;
+    FFIValue *values = inline_values;
+    void **slots = inline_slots;
+    if (p_count > INLINE_ARGS) {
+        heap_values.resize(p_count);
+        heap_slots.resize(p_count);
+        values = heap_values.ptrw();
+        slots = heap_slots.ptrw();
+    }
+    Vector<CharString> strings; // Must outlive ffi_call
+    if (string_count) {
+        strings.resize(string_count);
+    }
+
+    const Kind *kinds = arg_kinds.ptr();
+    int next_string = 0;
+    for (int i = 0; i < p_count; i++) {
+        FFIValue &value = values[i];
+        const Variant &arg = p_args[i];
+        switch (kinds[i]) {
+            case KIND_BYTE: value.u8 = (uint8_t)(int64_t)arg; break;
+            case KIND_SHORT: value.i16 = (int16_t)(int64_t)arg; break;
+            case KIND_INTEGER: value.i32 = (int32_t)(int64_t)arg; break;
+            case KIND_LONG: value.i64 = (int64_t)arg; break;
+            case KIND_SINGLE: value.f32 = (float)(double)arg; break;
+            case KIND_DOUBLE: value.f64 = (double)arg; break;
+            case KIND_BOOLEAN: value.i32 = (bool)arg ? -1 : 0; break;
+            case KIND_STRING:
+                strings.write[next_string] = String(arg).utf8();
+                value.str = strings[next_string++].get_data();
+                break;
+            case KIND_VOID:
+            case KIND_POINTER: value.ptr = (void *)(intptr_t)(int64_t)arg; break;
+        }
+        slots[i] = &value;
+    }
+
+    // libffi widens integral results narrower than a register to ffi_arg.
+    union {
+        ffi_arg u;
+        ffi_sarg s;
+        int64_t i64;
+        float f32;
+        double f64;
+        const char *str;
+        void *ptr;
+    } result;
+    result.i64 = 0;
+    ffi_call(const_cast<ffi_cif *>(&cif), FFI_FN(function), return_kind == KIND_VOID ? nullptr : &result, slots);
+
+    switch (return_kind) {
+        case KIND_VOID: return Variant();
+        case KIND_BYTE: return (int64_t)(uint8_t)result.u;
+        case KIND_SHORT: return (int64_t)(int16_t)result.s;
+        case KIND_INTEGER: return (int64_t)(int32_t)result.s;
+        case KIND_LONG: return result.i64;
+        case KIND_SINGLE: return (double)result.f32;
+        case KIND_DOUBLE: return result.f64;
+        case KIND_BOOLEAN: return (int32_t)result.s != 0;
+        case KIND_STRING: return result.str ? String::utf8(result.str) : String();
+        case KIND_POINTER: return (int64_t)(intptr_t)result.ptr;
+    }
+    return Variant();
+}
@@ -0,0 +1,58 @@
+#ifndef VISUAL_GASIC_FFI_H
+#define VISUAL_GASIC_FFI_H
+
+#include "visual_gasic_ast.h"
+#include <ffi.h>
+
+using namespace godot;
+using namespace VisualGasic;
+
+// Call stub for one Declare: the resolved symbol plus a libffi call
+// interface prepared from the declared parameter and return types. The type
+// strings are read once in prepare(); call() only converts each argument
+// by its precomputed kind, so there is no limit on the parameter count.
+class VisualGasicFFIStub {
+public:
+    // How a parameter or the return value is marshalled.
+    enum Kind : uint8_t {
+        KIND_VOID,
+        KIND_BYTE,    // uint8_t
+        KIND_SHORT,   // int16_t
+        KIND_INTEGER, // int32_t
+        KIND_LONG,    // int64_t
+        KIND_SINGLE,  // float
+        KIND_DOUBLE,  // double
+        KIND_STRING,  // const char* (UTF-8, valid for the call only)
+        KIND_BOOLEAN, // int32_t, True = -1
+        KIND_POINTER, // Any, Ptr, LongPtr and anything undeclared: a pointer-sized integer
+    };
+
+    static Kind kind_of(const String &p_type);
+
+    // Loads the Declare's library (once per process), looks its symbol up
+    // and prepares a stub. Returns null and sets r_error on failure.
+    static VisualGasicFFIStub *create(const DeclareStatement *p_decl, String &r_error);
+
+    VisualGasicFFIStub() = default;
+    VisualGasicFFIStub(const VisualGasicFFIStub &) = delete;
+    VisualGasicFFIStub &operator=(const VisualGasicFFIStub &) = delete;
+
+    // p_function is the resolved symbol. Returns false and sets r_error if
+    // libffi rejects the signature.
+    bool prepare(void *p_function, const DeclareStatement *p_decl, String &r_error);
+
+    // p_count must equal get_argument_count().
+    Variant call(const Variant *p_args, int p_count) const;
+
+    int get_argument_count() const { return arg_kinds.size(); }
+
+private:
+    void *function = nullptr;
+    ffi_cif cif;
+    Vector<ffi_type *> arg_types; // Referenced by cif
+    Vector<Kind> arg_kinds;
+    Kind return_kind = KIND_VOID;
+    int string_count = 0;
+};
+
+#endif // VISUAL_GASIC_FFI_H
@@ -0,0 +1,594 @@
+#include "visual_gasic_file.h"
+#include <godot_cpp/core/math.hpp>
+#include <godot_cpp/core/memory.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+#include <godot_cpp/variant/packed_float64_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_int64_array.hpp>
+#include <cstring>
+
+namespace {
+
+void append_le(std::vector<uint8_t> &r_bytes, uint64_t p_value, int p_size) {
+    for (int i = 0; i < p_size; i++) {
+        r_bytes.push_back((uint8_t)(p_value >> (8 * i)));
+    }
+}
+
+uint64_t read_le(const uint8_t *p_bytes, int p_size) {
+    uint64_t value = 0;
+    for (int i = 0; i < p_size; i++) {
+        value |= (uint64_t)p_bytes[i] << (8 * i);
+    }
+    return value;
+}
+
+template <typename P>
+void append_packed(std::vector<uint8_t> &r_bytes, const P &p_array, size_t p_element_size) {
+    size_t count = (size_t)p_array.size() * p_element_size;
+    if (count > 0) {
+        const uint8_t *src = (const uint8_t *)p_array.ptr();
+        r_bytes.insert(r_bytes.end(), src, src + count);
+    }
+}
+
+} // namespace
+
+VisualGasicFile *VisualGasicFile::open(const String &p_path, Mode p_mode, Access p_access, int64_t p_record_length, Error &r_error) {
+    if (p_mode == MODE_RANDOM && p_record_length <= 0) {
+        r_error = ERR_INVALID_PARAMETER;
+        return nullptr;
+    }
+    bool exists = FileAccess::file_exists(p_path);
+    FileAccess::ModeFlags flags = FileAccess::READ;
+    switch (p_mode) {
+        case MODE_INPUT:
+            flags = FileAccess::READ;
+            break;
+        case MODE_OUTPUT:
+            flags = FileAccess::WRITE;
+            break;
+        case MODE_APPEND:
+            flags = exists ? FileAccess::READ_WRITE : FileAccess::WRITE;
+            break;
+        case MODE_BINARY:
+        case MODE_RANDOM:
+            // Binary and Random files are never truncated by Open.
+            if (p_access == ACCESS_READ) {
+                flags = FileAccess::READ;
+            } else {
+                flags = exists ? FileAccess::READ_WRITE : FileAccess::WRITE_READ;
+            }
+            break;
+    }
+    Ref<FileAccess> fa = FileAccess::open(p_path, flags);
+    if (fa.is_null()) {
+        r_error = FileAccess::get_open_error();
+        return nullptr;
+    }
+
+    VisualGasicFile *f = memnew(VisualGasicFile);
+    f->file = fa;
+    f->mode = p_mode;
+    f->record_length = p_record_length > 0 ? p_record_length : DEFAULT_RECORD_LENGTH;
+    if (p_mode == MODE_APPEND) {
+        f->position = fa->get_length();
+    }
+    r_error = OK;
+    return f;
+}
+
+VisualGasicFile::~VisualGasicFile() {
+    flush();
+}
+
+void VisualGasicFile::flush() {
+    if (write_buffer.empty()) return;
+    write_staging.resize((int64_t)write_buffer.size());
+    memcpy(write_staging.ptrw(), write_buffer.data(), write_buffer.size());
+    file->seek(write_start);
+    file->store_buffer(write_staging);
+    write_buffer.clear();
+}
+
+bool VisualGasicFile::fill_read_buffer(int64_t p_min_bytes) {
+    int64_t offset = position - read_start;
+    if (offset >= 0 && offset + p_min_bytes <= read_size) {
+        return true;
+    }
+    flush();
+    file->seek(position);
+    read_buffer = file->get_buffer(MAX(BUFFER_SIZE, p_min_bytes));
+    read_ptr = read_buffer.ptr();
+    read_start = position;
+    read_size = read_buffer.size();
+    return read_size >= p_min_bytes;
+}
+
+int64_t VisualGasicFile::read_bytes(uint8_t *r_dst, int64_t p_count) {
+    int64_t done = 0;
+    while (done < p_count) {
+        if (!fill_read_buffer(1)) {
+            hit_eof = true;
+            break;
+        }
+        int64_t offset = position - read_start;
+        int64_t chunk = MIN(p_count - done, read_size - offset);
+        memcpy(r_dst + done, read_ptr + offset, chunk);
+        done += chunk;
+        position += chunk;
+    }
+    return done;
+}
+
+void VisualGasicFile::write_bytes(const uint8_t *p_src, int64_t p_count) {
+    if (!write_buffer.empty() && position != write_start + (int64_t)write_buffer.size()) {
+        flush();
+    }
+    if (write_buffer.empty()) {
+        write_start = position;
+    }
+    if (read_size > 0 && position < read_start + read_size && position + p_count > read_start) {
+        // The read-ahead window now holds stale bytes.
+        read_buffer = PackedByteArray();
+        read_ptr = nullptr;
+        read_size = 0;
+    }
+    write_buffer.insert(write_buffer.end(), p_src, p_src + p_count);
+    position += p_count;
+    if ((int64_t)write_buffer.size() >= BUFFER_SIZE) {
+        flush();
+    }
+}
+
+void VisualGasicFile::write_line(const String &p_text) {
+    CharString utf8 = p_text.utf8();
+    write_bytes((const uint8_t *)utf8.get_data(), utf8.length());
+    const uint8_t newline = '\n';
+    write_bytes(&newline, 1);
+}
+
+String VisualGasicFile::read_line() {
+    line_bytes.clear();
+    while (true) {
+        if (!fill_read_buffer(1)) {
+            hit_eof = true;
+            break;
+        }
+        const uint8_t *start = read_ptr + (position - read_start);
+        int64_t available = read_size - (position - read_start);
+        const uint8_t *newline = (const uint8_t *)memchr(start, '\n', available);
+        if (newline) {
+            line_bytes.append((const char *)start, newline - start);
+            position += (newline - start) + 1;
+            break;
+        }
+        line_bytes.append((const char *)start, available);
+        position += available;
+    }
+    if (!line_bytes.empty() && line_bytes.back() == '\r') {
+        line_bytes.pop_back();
+    }
+    return String::utf8(line_bytes.data(), (int64_t)line_bytes.size());
+}
+
+Variant VisualGasicFile::parse_field(const String &p_text) {
+    const char32_t *c = p_text.ptr();
+    int n = p_text.length();
+    int i = 0;
+    if (i < n && (c[i] == '+' || c[i] == '-')) i++;
+    int digits = 0;
+    bool is_float = false;
+    while (i < n && c[i] >= '0' && c[i] <= '9') { i++; digits++; }
+    if (i < n && c[i] == '.') {
+        is_float = true;
+        i++;
+        while (i < n && c[i] >= '0' && c[i] <= '9') { i++; digits++; }
+    }
+    if (digits > 0 && i < n && (c[i] == 'e' || c[i] == 'E')) {
+        is_float = true;
+        i++;
+        if (i < n && (c[i] == '+' || c[i] == '-')) i++;
+        int exponent_digits = 0;
+        while (i < n && c[i] >= '0' && c[i] <= '9') { i++; exponent_digits++; }
+        if (exponent_digits == 0) return p_text;
+    }
+    if (digits == 0 || i != n) {
+        return p_text;
+    }
+    return is_float ? Variant(p_text.to_float()) : Variant(p_text.to_int());
+}
+
+void VisualGasicFile::read_fields(Vector<Variant> &r_fields) {
+    r_fields.clear();
+    String line = read_line();
+    const char32_t *c = line.ptr();
+    int n = line.length();
+    int i = 0;
+    while (true) {
+        while (i < n && (c[i] == ' ' || c[i] == '\t')) i++;
+        if (i < n && c[i] == '"') {
+            String text;
+            int start = ++i;
+            while (i < n) {
+                if (c[i] == '"') {
+                    text += line.substr(start, i - start);
+                    if (i + 1 < n && c[i + 1] == '"') {
+                        text += "\"";
+                        i += 2;
+                        start = i;
+                        continue;
+                    }
+                    start = -1;
+                    i++;
+                    break;
+                }
+                i++;
+            }
+            if (start >= 0) {
+                text += line.substr(start, i - start); // Unterminated quote
+            }
+            while (i < n && c[i] != ',') i++;
+            r_fields.push_back(text);
+        } else {
+            int start = i;
+            while (i < n && c[i] != ',') i++;
+            r_fields.push_back(parse_field(line.substr(start, i - start).strip_edges()));
+        }
+        if (i < n && c[i] == ',') {
+            i++;
+            continue;
+        }
+        break;
+    }
+}
+
+bool VisualGasicFile::encode_field(const Variant &p_value, const Layout &p_layout, std::vector<uint8_t> &r_bytes) {
+    switch (p_layout.kind) {
+        case FIELD_BYTE:
+            append_le(r_bytes, (uint64_t)(int64_t)p_value, 1);
+            return true;
+        case FIELD_BOOLEAN:
+            append_le(r_bytes, p_value.booleanize() ? 0xFFFF : 0, 2);
+            return true;
+        case FIELD_INTEGER:
+            append_le(r_bytes, (uint64_t)(int64_t)p_value, 2);
+            return true;
+        case FIELD_LONG:
+            append_le(r_bytes, (uint64_t)(int64_t)p_value, 4);
+            return true;
+        case FIELD_SINGLE: {
+            float f = (float)(double)p_value;
+            uint32_t bits;
+            memcpy(&bits, &f, sizeof(bits));
+            append_le(r_bytes, bits, 4);
+            return true;
+        }
+        case FIELD_DOUBLE: {
+            double d = p_value;
+            uint64_t bits;
+            memcpy(&bits, &d, sizeof(bits));
+            append_le(r_bytes, bits, 8);
+            return true;
+        }
+        case FIELD_STRING:
+            return encode_value(String(p_value), false, r_bytes);
+        case FIELD_FIXED_STRING: {
+            CharString utf8 = String(p_value).utf8();
+            int64_t size = MIN((int64_t)utf8.length(), p_layout.length);
+            r_bytes.insert(r_bytes.end(), (const uint8_t *)utf8.get_data(), (const uint8_t *)utf8.get_data() + size);
+            r_bytes.insert(r_bytes.end(), (size_t)(p_layout.length - size), (uint8_t)' ');
+            return true;
+        }
+        case FIELD_TYPE: {
+            if (p_value.get_type() != Variant::DICTIONARY) return false;
+            Array values = ((Dictionary)p_value).values();
+            for (size_t i = 0; i < p_layout.fields.size(); i++) {
+                Variant field = (int64_t)i < values.size() ? values[i] : Variant();
+                if (!encode_value(field, false, r_bytes, &p_layout.fields[i])) return false;
+            }
+            return true;
+        }
+        case FIELD_VARIANT:
+            break;
+    }
+    return encode_value(p_value, false, r_bytes);
+}
+
+bool VisualGasicFile::encode_value(const Variant &p_value, bool p_raw_string, std::vector<uint8_t> &r_bytes, const Layout *p_layout) {
+    if (p_layout && p_layout->kind != FIELD_VARIANT) {
+        if (p_value.get_type() != Variant::ARRAY) {
+            return encode_field(p_value, *p_layout, r_bytes);
+        }
+        Array elements = p_value;
+        for (int64_t i = 0; i < elements.size(); i++) {
+            if (!encode_value(elements[i], false, r_bytes, p_layout)) return false;
+        }
+        return true;
+    }
+    switch (p_value.get_type()) {
+        case Variant::BOOL:
+            append_le(r_bytes, (bool)p_value ? 0xFFFF : 0, 2);
+            return true;
+        case Variant::INT:
+            append_le(r_bytes, (uint64_t)(int64_t)p_value, 8);
+            return true;
+        case Variant::FLOAT: {
+            double d = p_value;
+            uint64_t bits;
+            memcpy(&bits, &d, sizeof(bits));
+            append_le(r_bytes, bits, 8);
+            return true;
+        }
+        case Variant::STRING:
+        case Variant::STRING_NAME: {
+            CharString utf8 = String(p_value).utf8();
+            int64_t size = utf8.length();
+            if (!p_raw_string) {
+                if (size > 0xFFFF) return false;
+                append_le(r_bytes, (uint64_t)size, 2);
+            }
+            r_bytes.insert(r_bytes.end(), (const uint8_t *)utf8.get_data(), (const uint8_t *)utf8.get_data() + size);
+            return true;
+        }
+        case Variant::DICTIONARY: {
+            Array fields = ((Dictionary)p_value).values();
+            for (int64_t i = 0; i < fields.size(); i++) {
+                if (!encode_value(fields[i], false, r_bytes)) return false;
+            }
+            return true;
+        }
+        case Variant::ARRAY: {
+            Array elements = p_value;
+            for (int64_t i = 0; i < elements.size(); i++) {
+                if (!encode_value(elements[i], false, r_bytes)) return false;
+            }
+            return true;
+        }
+        case Variant::PACKED_BYTE_ARRAY:
+            append_packed(r_bytes, (PackedByteArray)p_value, 1);
+            return true;
+        case Variant::PACKED_INT32_ARRAY:
+            append_packed(r_bytes, (PackedInt32Array)p_value, 4);
+            return true;
+        case Variant::PACKED_INT64_ARRAY:
+            append_packed(r_bytes, (PackedInt64Array)p_value, 8);
+            return true;
+        case Variant::PACKED_FLOAT32_ARRAY:
+            append_packed(r_bytes, (PackedFloat32Array)p_value, 4);
+            return true;
+        case Variant::PACKED_FLOAT64_ARRAY:
+            append_packed(r_bytes, (PackedFloat64Array)p_value, 8);
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool VisualGasicFile::decode_field(Variant &r_value, const Layout &p_layout) {
+    uint8_t scalar[8];
+    switch (p_layout.kind) {
+        case FIELD_BYTE:
+            if (read_bytes(scalar, 1) == 1) r_value = (int64_t)scalar[0];
+            return true;
+        case FIELD_BOOLEAN:
+            if (read_bytes(scalar, 2) == 2) r_value = read_le(scalar, 2) != 0;
+            return true;
+        case FIELD_INTEGER:
+            if (read_bytes(scalar, 2) == 2) r_value = (int64_t)(int16_t)read_le(scalar, 2);
+            return true;
+        case FIELD_LONG:
+            if (read_bytes(scalar, 4) == 4) r_value = (int64_t)(int32_t)read_le(scalar, 4);
+            return true;
+        case FIELD_SINGLE:
+            if (read_bytes(scalar, 4) == 4) {
+                uint32_t bits = (uint32_t)read_le(scalar, 4);
+                float f;
+                memcpy(&f, &bits, sizeof(f));
+                r_value = (double)f;
+            }
+            return true;
+        case FIELD_DOUBLE:
+            if (read_bytes(scalar, 8) == 8) {
+                uint64_t bits = read_le(scalar, 8);
+                double d;
+                memcpy(&d, &bits, sizeof(d));
+                r_value = d;
+            }
+            return true;
+        case FIELD_STRING: {
+            Variant text = String();
+            if (!decode_value(text, false, nullptr)) return false;
+            if (!hit_eof) r_value = text;
+            return true;
+        }
+        case FIELD_FIXED_STRING: {
+            std::string text((size_t)p_layout.length, '\0');
+            if (p_layout.length > 0 && read_bytes((uint8_t *)&text[0], p_layout.length) != p_layout.length) return true;
+            r_value = String::utf8(text.data(), p_layout.length);
+            return true;
+        }
+        case FIELD_TYPE: {
+            if (r_value.get_type() != Variant::DICTIONARY) return false;
+            Dictionary fields = ((Dictionary)r_value).duplicate(false);
+            Array keys = fields.keys();
+            for (int64_t i = 0; i < keys.size() && i < (int64_t)p_layout.fields.size() && !hit_eof; i++) {
+                Variant field = fields[keys[i]];
+                if (!decode_value(field, false, &p_layout.fields[i])) return false;
+                fields[keys[i]] = field;
+            }
+            r_value = fields;
+            return true;
+        }
+        case FIELD_VARIANT:
+            break;
+    }
+    return decode_value(r_value, false, nullptr);
+}
+
+bool VisualGasicFile::decode_value(Variant &r_value, bool p_raw_string, const Layout *p_layout) {
+    if (p_layout && p_layout->kind != FIELD_VARIANT) {
+        if (r_value.get_type() != Variant::ARRAY) {
+            return decode_field(r_value, *p_layout);
+        }
+        Array elements = ((Array)r_value).duplicate(false);
+        for (int64_t i = 0; i < elements.size() && !hit_eof; i++) {
+            Variant element = elements[i];
+            if (!decode_value(element, false, p_layout)) return false;
+            elements[i] = element;
+        }
+        r_value = elements;
+        return true;
+    }
+    uint8_t scalar[8];
+    switch (r_value.get_type()) {
+        case Variant::BOOL:
+            if (read_bytes(scalar, 2) == 2) r_value = read_le(scalar, 2) != 0;
+            return true;
+        case Variant::INT:
+            if (read_bytes(scalar, 8) == 8) r_value = (int64_t)read_le(scalar, 8);
+            return true;
+        case Variant::FLOAT:
+            if (read_bytes(scalar, 8) == 8) {
+                uint64_t bits = read_le(scalar, 8);
+                double d;
+                memcpy(&d, &bits, sizeof(d));
+                r_value = d;
+            }
+            return true;
+        case Variant::STRING:
+        case Variant::STRING_NAME: {
+            int64_t size;
+            if (p_raw_string) {
+                size = String(r_value).utf8().length();
+            } else {
+                if (read_bytes(scalar, 2) != 2) return true;
+                size = (int64_t)read_le(scalar, 2);
+            }
+            std::string text((size_t)size, '\0');
+            if (size > 0 && read_bytes((uint8_t *)&text[0], size) != size) return true;
+            r_value = String::utf8(text.data(), size);
+            return true;
+        }
+        case Variant::DICTIONARY: {
+            // A copy: other variables may share the Dictionary (a = b).
+            Dictionary fields = ((Dictionary)r_value).duplicate(false);
+            Array keys = fields.keys();
+            for (int64_t i = 0; i < keys.size() && !hit_eof; i++) {
+                Variant field = fields[keys[i]];
+                if (!decode_value(field, false, nullptr)) return false;
+                fields[keys[i]] = field;
+            }
+            r_value = fields;
+            return true;
+        }
+        case Variant::ARRAY: {
+            Array elements = ((Array)r_value).duplicate(false);
+            for (int64_t i = 0; i < elements.size() && !hit_eof; i++) {
+                Variant element = elements[i];
+                if (!decode_value(element, false, nullptr)) return false;
+                elements[i] = element;
+            }
+            r_value = elements;
+            return true;
+        }
+        case Variant::PACKED_BYTE_ARRAY: {
+            PackedByteArray bytes = r_value;
+            if (read_bytes(bytes.ptrw(), bytes.size()) == bytes.size()) r_value = bytes;
+            return true;
+        }
+        case Variant::PACKED_INT32_ARRAY: {
+            PackedInt32Array values = r_value;
+            if (read_bytes((uint8_t *)values.ptrw(), values.size() * 4) == values.size() * 4) r_value = values;
+            return true;
+        }
+        case Variant::PACKED_INT64_ARRAY: {
+            PackedInt64Array values = r_value;
+            if (read_bytes((uint8_t *)values.ptrw(), values.size() * 8) == values.size() * 8) r_value = values;
+            return true;
+        }
+        case Variant::PACKED_FLOAT32_ARRAY: {
+            PackedFloat32Array values = r_value;
+            if (read_bytes((uint8_t *)values.ptrw(), values.size() * 4) == values.size() * 4) r_value = values;
+            return true;
+        }
+        case Variant::PACKED_FLOAT64_ARRAY: {
+            PackedFloat64Array values = r_value;
+            if (read_bytes((uint8_t *)values.ptrw(), values.size() * 8) == values.size() * 8) r_value = values;
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+bool VisualGasicFile::put_value(const Variant &p_value, int64_t p_position, String &r_error, const Layout *p_layout) {
+    if (mode != MODE_BINARY && mode != MODE_RANDOM) {
+        r_error = "Bad file mode";
+        return false;
+    }
+    record_bytes.clear();
+    if (!encode_value(p_value, mode == MODE_BINARY, record_bytes, p_layout)) {
+        r_error = "Bad record type: " + Variant::get_type_name(p_value.get_type());
+        return false;
+    }
+    if (mode == MODE_RANDOM) {
+        if ((int64_t)record_bytes.size() > record_length) {
+            r_error = "Bad record length";
+            return false;
+        }
+        record_bytes.resize((size_t)record_length, 0);
+        if (p_position > 0) {
+            position = (p_position - 1) * record_length;
+        }
+    } else if (p_position > 0) {
+        position = p_position - 1;
+    }
+    write_bytes(record_bytes.data(), (int64_t)record_bytes.size());
+    return true;
+}
+
+bool VisualGasicFile::get_value(Variant &r_value, int64_t p_position, String &r_error, const Layout *p_layout) {
+    if (mode != MODE_BINARY && mode != MODE_RANDOM) {
+        r_error = "Bad file mode";
+        return false;
+    }
+    if (p_position > 0) {
+        position = (p_position - 1) * (mode == MODE_RANDOM ? record_length : 1);
+    }
+    hit_eof = false;
+    int64_t record_start = position;
+    if (!decode_value(r_value, mode == MODE_BINARY, p_layout)) {
+        r_error = r_value.get_type() == Variant::NIL ? String("Get needs a typed variable")
+                                                       : "Bad record type: " + Variant::get_type_name(r_value.get_type());
+        return false;
+    }
+    if (mode == MODE_RANDOM) {
+        position = record_start + record_length; // Skip the padding
+    }
+    return true;
+}
+
+void VisualGasicFile::seek(int64_t p_position) {
+    position = MAX(p_position - 1, (int64_t)0) * (mode == MODE_RANDOM ? record_length : 1);
+    hit_eof = false;
+}
+
+bool VisualGasicFile::eof() {
+    if (mode == MODE_BINARY || mode == MODE_RANDOM) {
+        return hit_eof;
+    }
+    return position >= length();
+}
+
+int64_t VisualGasicFile::length() {
+    int64_t stored = file->get_length();
+    if (write_buffer.empty()) {
+        return stored;
+    }
+    return MAX(stored, write_start + (int64_t)write_buffer.size());
+}
+
+int64_t VisualGasicFile::loc() const {
+    return mode == MODE_RANDOM ? position / record_length : position;
+}
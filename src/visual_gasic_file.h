@@ -0,0 +1,148 @@
+#ifndef VISUAL_GASIC_FILE_H
+#define VISUAL_GASIC_FILE_H
+
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/templates/vector.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/string.hpp>
+#include <godot_cpp/variant/variant.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace godot;
+
+// A file opened with the Open statement (#1, #2...). All modes go through
+// one buffered layer over FileAccess: writes collect in a 64 KB buffer that
+// is stored when it fills, when a read or write goes elsewhere in the file,
+// and on Close; reads are served from a 64 KB read-ahead window. Print #, Line Input # and Input #
+// therefore cost a memcpy per statement instead of a FileAccess call.
+//
+// Binary and Random files hold records written with Put and read with Get,
+// little-endian. The fields of a Type are stored by their declared type, as
+// VB lays them out:
+//   Byte      1 byte               Boolean   2 bytes (0 or -1)
+//   Integer   2 bytes (int16)      Long      4 bytes (int32)
+//   Single    4 bytes (float)      Double    8 bytes (double)
+//   String    2-byte byte length + UTF-8
+//   String * n  exactly n bytes of UTF-8, space-padded or truncated
+//   a Type    its fields in declaration order; Variant fields as below
+// Any other value (a Variant field, a plain variable) is stored by its
+// runtime type: an int64 or a double in 8 bytes, Booleans and Strings as
+// above. Arrays are their elements; packed arrays their raw element bytes.
+// In Binary mode a String that is the whole record is stored without the
+// length: Put writes its bytes and Get reads as many bytes as the variable
+// already holds, as in VB. Get decodes into a copy of the variable's current
+// value, so it needs a typed variable (Dim x As Long, a Type, a sized array).
+// Random records are record_length bytes, zero-padded; a longer record is an
+// error.
+class VisualGasicFile {
+public:
+    enum Mode {
+        MODE_INPUT,
+        MODE_OUTPUT,
+        MODE_APPEND,
+        MODE_BINARY,
+        MODE_RANDOM,
+    };
+    enum Access {
+        ACCESS_DEFAULT, // Read and write where the mode allows it
+        ACCESS_READ,
+        ACCESS_WRITE,
+        ACCESS_READ_WRITE,
+    };
+    static constexpr int64_t BUFFER_SIZE = 64 * 1024;
+    static constexpr int64_t DEFAULT_RECORD_LENGTH = 128; // VB's default for Random
+
+    enum FieldKind {
+        FIELD_VARIANT, // By the runtime type of the value
+        FIELD_BYTE,
+        FIELD_BOOLEAN,
+        FIELD_INTEGER,
+        FIELD_LONG,
+        FIELD_SINGLE,
+        FIELD_DOUBLE,
+        FIELD_STRING,
+        FIELD_FIXED_STRING,
+        FIELD_TYPE,
+    };
+    // The declared layout of a value. For an array it describes each element.
+    struct Layout {
+        FieldKind kind = FIELD_VARIANT;
+        int64_t length = 0;         // FIELD_FIXED_STRING: bytes
+        std::vector<Layout> fields; // FIELD_TYPE: in declaration order
+    };
+
+    // Returns null if the file cannot be opened; r_error says why.
+    static VisualGasicFile *open(const String &p_path, Mode p_mode, Access p_access, int64_t p_record_length, Error &r_error);
+    ~VisualGasicFile(); // Stores pending writes
+
+    Mode get_mode() const { return mode; }
+    int64_t get_record_length() const { return record_length; }
+
+    // Print #: the text and a newline.
+    void write_line(const String &p_text);
+    // Line Input #: the next line without its "\n" (or "\r\n").
+    String read_line();
+    // Input #: the next line split on commas. Quoted fields are Strings
+    // ("" is a quote); unquoted ones are trimmed and become an int64 or a
+    // double when they are numbers.
+    void read_fields(Vector<Variant> &r_fields);
+
+    // Put / Get. p_position is 1-based: a byte in Binary mode, a record in
+    // Random mode; -1 continues from the current position. p_layout is the
+    // declared layout of a Type value (or of an array's elements), null to
+    // go by runtime types. They return false with r_error set on a bad
+    // record; reading past the end is not an error, it sets EOF and leaves
+    // the rest of the value unchanged. Get never changes the Dictionary or
+    // Array r_value held, it replaces r_value with a filled-in copy.
+    bool put_value(const Variant &p_value, int64_t p_position, String &r_error, const Layout *p_layout = nullptr);
+    bool get_value(Variant &r_value, int64_t p_position, String &r_error, const Layout *p_layout = nullptr);
+
+    // Seek #: 1-based like Put and Get, a record number in Random mode, else
+    // a byte. Seek #1, n then Get #1, , x reads what Get #1, n, x does.
+    void seek(int64_t p_position);
+    // EOF(): sequential files are at the end when nothing is left to read;
+    // Binary and Random ones after a Get reads past the end, as in VB.
+    bool eof();
+    int64_t length(); // LOF(), including unstored writes
+    // Loc(): the current record in Random mode, else the byte offset.
+    int64_t loc() const;
+    // Stores pending writes.
+    void flush();
+
+    // Appends p_value to r_bytes in the layout above; false for a type that
+    // has no record layout (Objects, Nil...). p_raw_string stores a String
+    // without its length.
+    static bool encode_value(const Variant &p_value, bool p_raw_string, std::vector<uint8_t> &r_bytes, const Layout *p_layout = nullptr);
+    // Input # conversion: an int64 or a double if p_text is a number, else p_text.
+    static Variant parse_field(const String &p_text);
+
+private:
+    VisualGasicFile() {}
+    int64_t read_bytes(uint8_t *r_dst, int64_t p_count);
+    void write_bytes(const uint8_t *p_src, int64_t p_count);
+    // Moves the read-ahead window to the current position; false at the end.
+    bool fill_read_buffer(int64_t p_min_bytes);
+    bool decode_value(Variant &r_value, bool p_raw_string, const Layout *p_layout);
+    static bool encode_field(const Variant &p_value, const Layout &p_layout, std::vector<uint8_t> &r_bytes);
+    void decode_field(Variant &r_value, const Layout &p_layout);
+
+    Ref<FileAccess> file;
+    Mode mode = MODE_INPUT;
+    int64_t record_length = DEFAULT_RECORD_LENGTH;
+    int64_t position = 0; // Logical byte position
+    bool hit_eof = false;
+
+    std::vector<uint8_t> write_buffer; // Bytes for [write_start, write_start + size)
+    int64_t write_start = 0;
+    PackedByteArray write_staging;
+    PackedByteArray read_buffer; // Bytes of [read_start, read_start + read_size)
+    const uint8_t *read_ptr = nullptr;
+    int64_t read_start = 0;
+    int64_t read_size = 0;
+    std::vector<uint8_t> record_bytes; // Scratch for put_value
+    std::string line_bytes;            // Scratch for read_line
+};
+
+#endif // VISUAL_GASIC_FILE_H
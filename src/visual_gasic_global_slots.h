@@ -0,0 +1,207 @@
+#ifndef VISUAL_GASIC_GLOBAL_SLOTS_H
+#define VISUAL_GASIC_GLOBAL_SLOTS_H
+
+// Slot-indexed storage for interpreter variables.
+// Every name gets a stable integer slot the first time it is seen; the
+// interpreter caches slots on AST nodes and bytecode chunks so hot paths
+// index a flat table instead of hashing a Variant key. The name -> slot map
+// is kept for get/set, the property list and the debugger. The
+// Dictionary-style helpers mirror the old `Dictionary variables` API so
+// cold paths read the same as before.
+//
+// A table built from a module's SlotLayout starts with the names the binder
+// resolved, at the slots Binding::slot gives them, and shares the layout's
+// name map; only names first seen at run time are interned per table.
+
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/vector.hpp>
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/string.hpp>
+#include <godot_cpp/variant/variant.hpp>
+
+#include <deque>
+#include <memory>
+
+using namespace godot;
+
+// The variable names VisualGasicBinder resolved for one module, built once
+// per bind and shared by the module and every table laid out from it.
+struct SlotLayout {
+    Vector<String> names; // ModuleNode::slot_names
+    HashMap<String, int> slot_by_name;
+    uint64_t generation = 0; // ModuleNode::bind_generation
+};
+
+// A slot cached on a shared AST node or bytecode chunk. It is trusted only
+// by tables laid out from the layout of that generation, where the slot
+// holds the same name in every instance.
+struct SlotHint {
+    uint64_t generation = 0;
+    int slot = -1;
+};
+
+class GlobalSlotTable {
+public:
+    // Lays an empty table out from p_layout: its names take slots 0..n-1.
+    void set_layout(const std::shared_ptr<const SlotLayout> &p_layout) {
+        if (!p_layout || !names.is_empty()) {
+            return;
+        }
+        layout = p_layout;
+        names = p_layout->names;
+        slots.resize(names.size());
+    }
+
+    // 0 when the table was not laid out from a module.
+    uint64_t get_layout_generation() const {
+        return layout ? layout->generation : 0;
+    }
+
+    // Returns the slot for p_name, or -1 if the name was never interned.
+    int find(const String &p_name) const {
+        if (layout) {
+            const int *slot = layout->slot_by_name.getptr(p_name);
+            if (slot) {
+                return *slot;
+            }
+        }
+        const int *slot = slot_by_name.getptr(p_name);
+        return slot ? *slot : -1;
+    }
+
+    // Like find(), but trusts p_hint when it was taken from this table's
+    // layout. Names interned at run time have per-table slots and are
+    // looked up by name every time.
+    int find_hinted(const String &p_name, SlotHint &p_hint) const {
+        uint64_t generation = get_layout_generation();
+        if (generation != 0 && p_hint.generation == generation) {
+            return p_hint.slot;
+        }
+        int slot = find(p_name);
+        if (generation != 0 && slot >= 0 && slot < layout->names.size()) {
+            p_hint.generation = generation;
+            p_hint.slot = slot;
+        }
+        return slot;
+    }
+
+    // Returns the slot for p_name, creating an unbound slot if needed.
+    int intern(const String &p_name) {
+        int slot = find(p_name);
+        if (slot >= 0) {
+            return slot;
+        }
+        slot = names.size();
+        names.push_back(p_name);
+        slots.emplace_back();
+        slot_by_name.insert(p_name, slot);
+        return slot;
+    }
+
+    int intern_hinted(const String &p_name, SlotHint &p_hint) {
+        int slot = find_hinted(p_name, p_hint);
+        return slot >= 0 ? slot : intern(p_name);
+    }
+
+    int slot_count() const { return names.size(); }
+    const String &slot_name(int p_slot) const { return names[p_slot]; }
+
+    bool is_bound(int p_slot) const { return slots[p_slot].bound; }
+    const Variant &get_slot(int p_slot) const { return slots[p_slot].value; }
+
+    // Marks the slot as defined and returns its storage.
+    Variant &bind_slot(int p_slot) {
+        Slot &s = slots[p_slot];
+        s.bound = true;
+        return s.value;
+    }
+
+    void set_slot(int p_slot, const Variant &p_value) {
+        Slot &s = slots[p_slot];
+        s.bound = true;
+        s.value = p_value;
+    }
+
+    void unbind_slot(int p_slot) {
+        Slot &s = slots[p_slot];
+        s.bound = false;
+        s.value = Variant();
+    }
+
+    // Dictionary-style access by name.
+    bool has(const String &p_name) const {
+        int slot = find(p_name);
+        return slot >= 0 && slots[slot].bound;
+    }
+
+    Variant &operator[](const String &p_name) {
+        return bind_slot(intern(p_name));
+    }
+
+    Variant get(const String &p_name, const Variant &p_default) const {
+        int slot = find(p_name);
+        if (slot >= 0 && slots[slot].bound) {
+            return slots[slot].value;
+        }
+        return p_default;
+    }
+
+    void erase(const String &p_name) {
+        int slot = find(p_name);
+        if (slot >= 0) {
+            unbind_slot(slot);
+        }
+    }
+
+    Array keys() const {
+        Array ret;
+        for (int i = 0; i < names.size(); i++) {
+            if (slots[i].bound) {
+                ret.push_back(names[i]);
+            }
+        }
+        return ret;
+    }
+
+    // Snapshot of all bound variables, in slot order.
+    Dictionary duplicate(bool p_deep = false) const {
+        Dictionary ret;
+        for (int i = 0; i < names.size(); i++) {
+            if (slots[i].bound) {
+                ret[names[i]] = p_deep ? slots[i].value.duplicate(true) : slots[i].value;
+            }
+        }
+        return ret;
+    }
+
+    // Restores a snapshot taken with duplicate(). Slots stay interned so
+    // cached slot indices remain valid.
+    GlobalSlotTable &operator=(const Dictionary &p_snapshot) {
+        for (Slot &s : slots) {
+            s.bound = false;
+            s.value = Variant();
+        }
+        Array snapshot_keys = p_snapshot.keys();
+        for (int i = 0; i < snapshot_keys.size(); i++) {
+            const Variant &key = snapshot_keys[i];
+            set_slot(intern(key), p_snapshot[key]);
+        }
+        return *this;
+    }
+
+private:
+    struct Slot {
+        Variant value;
+        bool bound = false;
+    };
+
+    // std::deque keeps references from operator[] valid while new names are
+    // interned (e.g. `variables[a] = variables[b]`).
+    std::deque<Slot> slots;
+    Vector<String> names;
+    std::shared_ptr<const SlotLayout> layout; // Names of slots [0, layout->names.size())
+    HashMap<String, int> slot_by_name;        // Names interned after the layout
+};
+
+#endif // VISUAL_GASIC_GLOBAL_SLOTS_H
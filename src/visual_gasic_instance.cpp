@@ -1,6 +1,7 @@
 #include <godot_cpp/classes/file_dialog.hpp>
 #include <godot_cpp/classes/tween.hpp>
 #include <cstdlib>
+#include <cstdint>
 #include <godot_cpp/classes/viewport.hpp>
 #include <godot_cpp/classes/area2d.hpp>
 #include <godot_cpp/classes/collision_shape2d.hpp>
@@ -27,6 +28,10 @@
 #include "visual_gasic_language.h"
 #include "visual_gasic_parser.h"
 #include "visual_gasic_builtins.h"
+#include "visual_gasic_commands.h"
+#include "visual_gasic_draw_batch.h"
+#include "visual_gasic_file.h"
+#include "visual_gasic_binder.h"
 #include <godot_cpp/core/object.hpp>
 #include <godot_cpp/classes/node.hpp>
 #include <godot_cpp/classes/input.hpp>
@@ -305,8 +310,8 @@ static thread_local int vg_opcode_profile_depth = 0;
 
 class OpcodeProfileScope {
 public:
-    explicit OpcodeProfileScope(OpcodeProfileKind p_kind) : kind(p_kind) {
-        enabled = vg_opcode_profile_enabled();
+    OpcodeProfileScope(OpcodeProfileKind p_kind, bool p_active) : kind(p_kind) {
+        enabled = p_active && vg_opcode_profile_enabled();
         if (enabled && Time::get_singleton() != nullptr) {
             start_us = Time::get_singleton()->get_ticks_usec();
         } else {
@@ -403,7 +408,41 @@ static void vg_stack_profile_dump(const StackProfileSample &sample, const String
 
 #define VG_CONCAT_IMPL(a, b) a##b
 #define VG_CONCAT(a, b) VG_CONCAT_IMPL(a, b)
-#define PROFILE_OPCODE(kind) OpcodeProfileScope VG_CONCAT(_vg_opcode_scope_, __COUNTER__)(OpcodeProfileKind::kind)
+// Only valid inside execute_bytecode_impl: the release instantiation
+// (Profiled == false) constant-folds the scope away.
+#define PROFILE_OPCODE(kind) OpcodeProfileScope VG_CONCAT(_vg_opcode_scope_, __COUNTER__)(OpcodeProfileKind::kind, Profiled)
+
+// Bytecode dispatch. With VG_THREADED_DISPATCH (default on GCC/Clang) each
+// handler is also a label and ends in DISPATCH(), which fetches the next
+// opcode and jumps through a label table itself, so every handler has its
+// own indirect branch instead of sharing the switch's. Leaving the chunk
+// (end of code, return to a caller frame) goes back through the loop head.
+// A computed goto does not run destructors of the scopes it leaves, so a
+// handler with locals runs inside do { } while (0), leaves it with break,
+// and DISPATCH() only follows once that scope has closed. Build with
+// threaded_dispatch=0 (SCons) / -DVG_THREADED_DISPATCH=OFF (CMake) to
+// compare; DISPATCH() is then a plain break.
+#if !defined(__GNUC__) && !defined(__clang__)
+#undef VG_THREADED_DISPATCH
+#define VG_THREADED_DISPATCH 0
+#elif !defined(VG_THREADED_DISPATCH)
+#define VG_THREADED_DISPATCH 1
+#endif
+
+#if VG_THREADED_DISPATCH
+#define VM_CASE(op) case op: vm_op_##op
+#define DISPATCH()                                                                  \
+    do {                                                                            \
+        if (vm.ip >= code_size) goto vm_loop_head;                                  \
+        last_opcode_offset = vm.ip;                                                 \
+        op = code[vm.ip++];                                                         \
+        current_opcode = op;                                                        \
+        goto *(op < vm_dispatch_count ? vm_dispatch_table[op] : &&vm_op_default);  \
+    } while (0)
+#else
+#define VM_CASE(op) case op
+#define DISPATCH() break
+#endif
 
 static String vg_repeat_literal(const String &literal, int64_t count) {
     if (count <= 0 || literal.is_empty()) {
@@ -421,6 +460,45 @@ static inline int64_t vg_loop_count(int64_t upper_bound) {
     return upper_bound >= 0 ? (upper_bound + 1) : 0;
 }
 
+// Coercions applied when a value is stored into a register-tier local; same
+// rules as the VM's to_int / to_double.
+static inline int64_t vg_register_i64(const Variant &value) {
+    switch (value.get_type()) {
+        case Variant::INT:
+            return (int64_t)value;
+        case Variant::FLOAT:
+            return (int64_t)((double)value);
+        case Variant::BOOL:
+            return (bool)value ? 1 : 0;
+        case Variant::STRING:
+            return ((String)value).to_int();
+        case Variant::NIL:
+            return 0;
+        default:
+            return (int64_t)value;
+    }
+}
+
+static inline double vg_register_f64(const Variant &value) {
+    switch (value.get_type()) {
+        case Variant::FLOAT:
+            return (double)value;
+        case Variant::INT:
+            return (double)((int64_t)value);
+        case Variant::BOOL:
+            return (bool)value ? 1.0 : 0.0;
+        case Variant::STRING:
+            return ((String)value).to_float();
+        case Variant::NIL:
+            return 0.0;
+        default:
+            return (double)value;
+    }
+}
+
+// Nesting limit for OP_CALL_USER frames before "Out of stack space" (error 28).
+static constexpr int VG_MAX_CALL_DEPTH = 10000;
+
 // ======= JIT Compilation Framework =======
 
 struct JitCompiledLoop {
@@ -658,9 +736,63 @@ void VisualGasicInstance::prune_fast_dict_cache_if_needed() {
     }
 }
 
+// How Put and Get store a Type member, from its declared type.
+static VisualGasicFile::Layout vg_record_layout(ModuleNode *p_module, const String &p_type, int p_fixed_length, int p_depth) {
+    VisualGasicFile::Layout layout;
+    if (p_type.nocasecmp_to("Byte") == 0) layout.kind = VisualGasicFile::FIELD_BYTE;
+    else if (p_type.nocasecmp_to("Boolean") == 0) layout.kind = VisualGasicFile::FIELD_BOOLEAN;
+    else if (p_type.nocasecmp_to("Integer") == 0) layout.kind = VisualGasicFile::FIELD_INTEGER;
+    else if (p_type.nocasecmp_to("Long") == 0) layout.kind = VisualGasicFile::FIELD_LONG;
+    else if (p_type.nocasecmp_to("Single") == 0) layout.kind = VisualGasicFile::FIELD_SINGLE;
+    else if (p_type.nocasecmp_to("Double") == 0) layout.kind = VisualGasicFile::FIELD_DOUBLE;
+    else if (p_type.nocasecmp_to("String") == 0) {
+        layout.kind = p_fixed_length > 0 ? VisualGasicFile::FIELD_FIXED_STRING : VisualGasicFile::FIELD_STRING;
+        layout.length = p_fixed_length;
+    } else if (p_depth < 16) { // Recursive Types have no prototype either
+        for (int i = 0; i < p_module->structs.size(); i++) {
+            StructDefinition *def = p_module->structs[i];
+            if (def->name.nocasecmp_to(p_type) != 0) continue;
+            layout.kind = VisualGasicFile::FIELD_TYPE;
+            for (int m = 0; m < def->members.size(); m++) {
+                layout.fields.push_back(vg_record_layout(p_module, def->members[m].type, def->members[m].fixed_length, p_depth + 1));
+            }
+            break;
+        }
+    }
+    return layout;
+}
+
+// Values carry no type name, so a Dictionary is matched to the Type whose
+// members have its keys, in order. Arrays use their first element.
+const VisualGasicFile::Layout *VisualGasicInstance::record_layout_for(const Variant &p_value) const {
+    Variant value = p_value;
+    while (value.get_type() == Variant::ARRAY && ((Array)value).size() > 0) {
+        value = ((Array)value)[0];
+    }
+    if (value.get_type() != Variant::DICTIONARY || !script.is_valid() || !script->ast_root) {
+        return nullptr;
+    }
+    Array keys = ((Dictionary)value).keys();
+    const Vector<StructDefinition *> &structs = script->ast_root->structs;
+    for (int i = 0; i < structs.size() && i < (int)record_layouts.size(); i++) {
+        const Vector<StructMember> &members = structs[i]->members;
+        bool match = members.size() == keys.size();
+        for (int m = 0; match && m < members.size(); m++) {
+            match = members[m].name == String(keys[m]);
+        }
+        if (match) {
+            return &record_layouts[i];
+        }
+    }
+    return nullptr;
+}
+
 VisualGasicInstance::VisualGasicInstance(Ref<VisualGasicScript> p_script, Object *p_owner) {
     script = p_script;
     owner = p_owner;
+    if (script.is_valid() && script->ast_root) {
+        variables.set_layout(script->ast_root->slot_layout);
+    }
     error_state.mode = ErrorState::NONE;
     error_state.has_error = false;
     current_sub = nullptr;
@@ -672,6 +804,15 @@ VisualGasicInstance::VisualGasicInstance(Ref<VisualGasicScript> p_script, Object
         option_compare_text = script->ast_root->option_compare_text;
     }
 
+    ProjectSettings *settings = ProjectSettings::get_singleton();
+    if (settings) {
+        loop_watchdog_iterations = (int64_t)settings->get_setting("visual_gasic/runtime/loop_watchdog_iterations", 0);
+        loop_watchdog_ms = (int64_t)settings->get_setting("visual_gasic/runtime/loop_watchdog_ms", 0);
+        // Deferred firing needs frames to flush in, so it only applies to Nodes.
+        whenever_deferred = (bool)settings->get_setting("visual_gasic/whenever/deferred_dispatch", false) &&
+                Object::cast_to<Node>(owner) != nullptr;
+    }
+
     // Initialize Err Object
     Dictionary err_obj;
     err_obj["Number"] = 0;
@@ -748,6 +889,30 @@ VisualGasicInstance::VisualGasicInstance(Ref<VisualGasicScript> p_script, Object
                  
                  UtilityFunctions::print("Initialized Global Var: ", v->name);
             }
+
+            // Reserve slots for procedure return values and parameters so
+            // binding arguments on a call never grows the slot table.
+            for(int i=0; i<vs->ast_root->subs.size(); i++) {
+                 SubDefinition *sub = vs->ast_root->subs[i];
+                 variables.intern(sub->name);
+                 for(int p=0; p<sub->parameters.size(); p++) {
+                     variables.intern(sub->parameters[p].name);
+                 }
+            }
+            // Class methods too: Class_Terminate runs while a Variant in
+            // `variables` is being overwritten, so it must not grow the table.
+            for(int c=0; c<vs->ast_root->classes.size(); c++) {
+                 const ClassDefinition *cls = vs->ast_root->classes[c];
+                 for(int m=0; m<cls->methods.size(); m++) {
+                     variables.intern(cls->methods[m]->name);
+                     for(int p=0; p<cls->methods[m]->parameters.size(); p++) {
+                         variables.intern(cls->methods[m]->parameters[p].name);
+                     }
+                 }
+            }
+            // Likewise for every name the binder resolved, before any code runs.
+            sync_bound_slots();
+            vs->resolve_declares(); // Once per script, shared by its instances
             
             // Also execute global statements (like Dims not captured in definitions, or Options)
             // Warning: Don't execute imperative code here if untrusted? 
@@ -881,6 +1046,7 @@ VisualGasicInstance::VisualGasicInstance(Ref<VisualGasicScript> p_script, Object
         for(int i=0; i<script->ast_root->structs.size(); i++) {
              String name = script->ast_root->structs[i]->name;
              struct_prototypes[name] = builder.get_proto(name);
+             record_layouts.push_back(vg_record_layout(script->ast_root, name, 0, 0));
         }
 
         // Initialize Data Segments
@@ -891,7 +1057,7 @@ VisualGasicInstance::VisualGasicInstance(Ref<VisualGasicScript> p_script, Object
 void VisualGasicInstance::scan_data_sections(ModuleNode* root) {
     if (!root) return;
 
-    data_segments.clear();
+    data_pool.clear();
     label_to_data_index.clear();
 
     // Scan Subs (and Functions which are now subtypes of Subs)
@@ -909,12 +1075,12 @@ void VisualGasicInstance::collect_data_from_block(const Vector<Statement*>& bloc
         if (s->type == STMT_DATA) {
             DataStatement* data = (DataStatement*)s;
             for(int k=0; k<data->values.size(); k++) {
-                data_segments.push_back(data->values[k]);
+                data_pool.add_expression(data->values[k]);
             }
         }
         if (s->type == STMT_LABEL) {
             LabelStatement* label = (LabelStatement*)s;
-            label_to_data_index[label->name] = data_segments.size();
+            label_to_data_index[label->name] = data_pool.size();
         }
         
         // Recursive blocks (If, Do, Loop, For, Select, With)
@@ -937,8 +1103,14 @@ void VisualGasicInstance::collect_data_from_block(const Vector<Statement*>& bloc
 }
 
 VisualGasicInstance::~VisualGasicInstance() {
-    for(int i=0; i<runtime_data_nodes.size(); i++) {
-        if (runtime_data_nodes[i]) delete runtime_data_nodes[i];
+    // Objects may outlive the instance (held by GDScript); they no longer
+    // run Class_Terminate once it is gone.
+    for (VisualGasicObject *object : live_objects) {
+        object->instance = nullptr;
+    }
+    close_all_files();
+    if (draw_batch) {
+        memdelete(draw_batch);
     }
 }
 
@@ -947,25 +1119,22 @@ Variant VisualGasicInstance::evaluate_expression_for_builtins(ExpressionNode* ex
 }
 
 Variant VisualGasicInstance::file_lof(int file_num) {
-    if (open_files.has(file_num)) {
-        Ref<FileAccess> fa = open_files[file_num];
-        if (fa.is_valid()) return fa->get_length();
+    if (VisualGasicFile **f = open_files.getptr(file_num)) {
+        return (*f)->length();
     }
     return 0;
 }
 
 Variant VisualGasicInstance::file_loc(int file_num) {
-    if (open_files.has(file_num)) {
-        Ref<FileAccess> fa = open_files[file_num];
-        if (fa.is_valid()) return fa->get_position();
+    if (VisualGasicFile **f = open_files.getptr(file_num)) {
+        return (*f)->loc();
     }
     return 0;
 }
 
 Variant VisualGasicInstance::file_eof(int file_num) {
-    if (open_files.has(file_num)) {
-        Ref<FileAccess> fa = open_files[file_num];
-        if (fa.is_valid()) return fa->eof_reached();
+    if (VisualGasicFile **f = open_files.getptr(file_num)) {
+        return (*f)->eof();
     }
     return true;
 }
@@ -980,6 +1149,20 @@ int VisualGasicInstance::file_free(int range) {
     return 0;
 }
 
+void VisualGasicInstance::close_file(int file_num) {
+    if (VisualGasicFile **f = open_files.getptr(file_num)) {
+        memdelete(*f);
+        open_files.erase(file_num);
+    }
+}
+
+void VisualGasicInstance::close_all_files() {
+    for (KeyValue<int, VisualGasicFile *> &E : open_files) {
+        memdelete(E.value);
+    }
+    open_files.clear();
+}
+
 Variant VisualGasicInstance::file_len(const String &path) {
     Ref<FileAccess> fa = FileAccess::open(path, FileAccess::READ);
     if (fa.is_valid()) return fa->get_length();
@@ -1023,9 +1206,29 @@ void VisualGasicInstance::raise_runtime_error(const String &p_msg, int p_code) {
     raise_error(p_msg, p_code);
 }
 
+void VisualGasicInstance::track_dynamic_node(Object *p_node) {
+    dynamic_nodes.push_back(p_node->get_instance_id());
+}
+
+void VisualGasicInstance::clear_dynamic_nodes() {
+    for (int i = 0; i < dynamic_nodes.size(); i++) {
+        Node *n = Object::cast_to<Node>(ObjectDB::get_instance(dynamic_nodes[i]));
+        if (n) n->queue_free();
+    }
+    dynamic_nodes.clear();
+}
+
+VisualGasicDrawBatch *VisualGasicInstance::get_draw_batch() {
+    if (!draw_batch) {
+        draw_batch = memnew(VisualGasicDrawBatch);
+    }
+    return draw_batch;
+}
+
 bool VisualGasicInstance::set(const StringName &p_name, const Variant &p_value) {
-    if (variables.has(p_name)) {
-        variables[p_name] = p_value;
+    int slot = variables.find(p_name);
+    if (slot >= 0 && variables.is_bound(slot)) {
+        variables.set_slot(slot, p_value);
         return true;
     }
     // Check if it is a public variable defined in script, but not yet initialized in variables map
@@ -1043,17 +1246,14 @@ bool VisualGasicInstance::set(const StringName &p_name, const Variant &p_value)
 }
 
 bool VisualGasicInstance::get(const StringName &p_name, Variant &r_ret) {
-    if (variables.has(p_name)) {
-        r_ret = variables[p_name];
-        return true;
-    }
-    return false;
+    return get_variable(p_name, r_ret);
 }
 
 // Retrieve a variable by name into r_ret. Returns true if found.
 bool VisualGasicInstance::get_variable(const String &p_name, Variant &r_ret) {
-    if (variables.has(p_name)) {
-        r_ret = variables[p_name];
+    int slot = variables.find(p_name);
+    if (slot >= 0 && variables.is_bound(slot)) {
+        r_ret = variables.get_slot(slot);
         return true;
     }
     return false;
@@ -1208,6 +1408,9 @@ Variant VisualGasicInstance::evaluate_expression(ExpressionNode* expr) {
         return ((LiteralNode*)expr)->value;
     }
     if (expr->type == ExpressionNode::ME) {
+        // Inside a Class method Me is the object (Nothing in Class_Terminate,
+        // which runs once no reference is left).
+        if (current_object) return current_object->terminating ? Variant() : Variant(current_object);
         if (!owner) return Variant(); // Or error?
         // Note: owner is Object*. Returning it as Variant usually works but requires safety?
         // Godot-cpp Variant constructor from Object* should handle it.
@@ -1215,9 +1418,18 @@ Variant VisualGasicInstance::evaluate_expression(ExpressionNode* expr) {
     }
     if (expr->type == ExpressionNode::NEW) {
         NewNode* n = (NewNode*)expr;
+        if (n->binding.kind == BIND_CLASS) {
+            Array args;
+            for (int i = 0; i < n->args.size(); i++) {
+                args.push_back(evaluate_expression(n->args[i]));
+            }
+            return instantiate_class(n->binding.index, args);
+        }
+        // Bound to a Type of the module, or to nothing in it (Godot class).
+        bool bound = n->binding.kind == BIND_STRUCT || n->binding.kind == BIND_EXTERNAL;
         
         // MemoryBlock -> PackedByteArray
-        if (n->class_name.nocasecmp_to("MemoryBlock") == 0) {
+        if (!bound && n->class_name.nocasecmp_to("MemoryBlock") == 0) {
             int size = 0;
             if (n->args.size() > 0) {
                  Variant v = evaluate_expression(n->args[0]);
@@ -1228,27 +1440,35 @@ Variant VisualGasicInstance::evaluate_expression(ExpressionNode* expr) {
             return pba;
         }
 
-        if (n->class_name.nocasecmp_to("Dictionary") == 0) {
+        if (!bound && n->class_name.nocasecmp_to("Dictionary") == 0) {
             return Dictionary();
         }
         
         // Custom Structs or Types?
         // Check struct definitions
+        StructDefinition* def = nullptr;
         if (script.is_valid() && script->ast_root) {
-            for(int i=0; i<script->ast_root->structs.size(); i++) {
-                if (script->ast_root->structs[i]->name.nocasecmp_to(n->class_name) == 0) {
-                     // Instantiate Struct (Dictionary)
-                     // Re-use ProtoBuilder logic? Or simple manual create
-                     Dictionary d;
-                     StructDefinition* def = script->ast_root->structs[i];
-                     for(int m=0; m<def->members.size(); m++) {
-                         // Default init
-                         d[def->members[m].name] = Variant(); // Better defaults later
-                     }
-                     return d;
+            const Vector<StructDefinition*> &structs = script->ast_root->structs;
+            if (n->binding.kind == BIND_STRUCT && n->binding.index < structs.size()) {
+                def = structs[n->binding.index];
+            }
+            for(int i=0; !bound && i<structs.size(); i++) {
+                if (structs[i]->name.nocasecmp_to(n->class_name) == 0) {
+                     def = structs[i];
+                     break;
                 }
             }
         }
+        if (def) {
+             // Instantiate Struct (Dictionary)
+             // Re-use ProtoBuilder logic? Or simple manual create
+             Dictionary d;
+             for(int m=0; m<def->members.size(); m++) {
+                 // Default init
+                 d[def->members[m].name] = Variant(); // Better defaults later
+             }
+             return d;
+        }
         
         // Try Godot ClassDB
         if (ClassDB::class_exists(n->class_name)) {
@@ -1260,9 +1480,15 @@ Variant VisualGasicInstance::evaluate_expression(ExpressionNode* expr) {
     }
 
     if (expr->type == ExpressionNode::VARIABLE) {
-        String name = ((VariableNode*)expr)->name;
+        VariableNode* var = (VariableNode*)expr;
+        if (var->binding.kind == BIND_MEMBER && current_object) return current_object->fields[var->binding.index];
+        String name = var->name;
+        // The binder already knows whether the name can be FreeFile or Godot.
+        // They are checked before variables so they win over a variable of
+        // the same name.
+        bool intrinsic = var->binding.kind == BIND_UNRESOLVED || var->binding.kind == BIND_INTRINSIC;
         
-        if (name.nocasecmp_to("FreeFile") == 0) {
+        if (intrinsic && name.length() == 8 && name.nocasecmp_to("FreeFile") == 0) {
              for(int i=1; i<=255; i++) {
                  if (!open_files.has(i)) return i;
              }
@@ -1270,13 +1496,15 @@ Variant VisualGasicInstance::evaluate_expression(ExpressionNode* expr) {
              return 0;
         }
 
-        if (name.nocasecmp_to("Godot") == 0) {
+        if (intrinsic && name.length() == 5 && name.nocasecmp_to("Godot") == 0) {
             // Return a special marker? Or can we return Engine?
             // Engine is an Object.
             return Engine::get_singleton();
         }
-        
-        if (variables.has(name)) return variables[name];
+
+        int slot = var->binding.slot >= 0 ? bound_slot(var->binding.slot) : -1;
+        if (slot < 0) slot = variables.find_hinted(var->name, var->slot_hint);
+        if (slot >= 0 && variables.is_bound(slot)) return variables.get_slot(slot);
         
         // Debug
         // UtilityFunctions::print("Variable not found in map: ", name);
@@ -1318,8 +1546,15 @@ Variant VisualGasicInstance::evaluate_expression(ExpressionNode* expr) {
              raise_error("Incomplete member access: missing base object");
              return Variant();
          }
+         // Me.Field reads the running object directly (also in Class_Terminate).
+         if (ma->base_object->type == ExpressionNode::ME && current_object) {
+             return get_class_member(current_object, ma);
+         }
          
          Variant base = evaluate_expression(ma->base_object);
+         if (VisualGasicObject *object = as_class_object(base)) {
+             return get_class_member(object, ma);
+         }
          
          if (base.get_type() == Variant::DICTIONARY) {
              Dictionary d = base;
@@ -1714,6 +1949,63 @@ Variant VisualGasicInstance::evaluate_expression(ExpressionNode* expr) {
 
     if (expr->type == ExpressionNode::EXPRESSION_CALL) {
         CallExpression* call = (CallExpression*)expr;
+
+        if (call->binding.kind == BIND_DECLARE) {
+            return call_ffi_function(call->binding.index, call->arguments);
+        }
+
+        // Methods and array fields of class objects: the running object's
+        // own (bound), or on Me or a variable holding an object.
+        if (call->base_object || call->binding.kind == BIND_METHOD || call->binding.kind == BIND_MEMBER) {
+            VisualGasicObject *object = nullptr;
+            Ref<VisualGasicObject> hold; // The arguments could reassign the variable
+            if (!call->base_object || call->base_object->type == ExpressionNode::ME) {
+                object = current_object;
+            } else if (call->base_object->type == ExpressionNode::VARIABLE) {
+                object = as_class_object(evaluate_expression(call->base_object));
+                hold = Ref<VisualGasicObject>(object);
+            }
+            if (object) {
+                Array call_args;
+                for (int i = 0; i < call->arguments.size(); i++) {
+                    call_args.push_back(evaluate_expression(call->arguments[i]));
+                }
+                if (call->base_object) {
+                    return call_class_site(object, call->class_cache, call->method_name, call_args);
+                }
+                if (call->binding.kind == BIND_METHOD) {
+                    return call_class_method(object, call->binding.index, call_args);
+                }
+                Variant element;
+                if (read_indexed_variable(object->fields[call->binding.index], call_args, element)) return element;
+                raise_error("Field " + call->method_name + " is not an array");
+                return Variant();
+            }
+        }
+
+        // The binder only gives a slot to calls that no builtin or intrinsic
+        // below can match: they index a variable, call a Sub or the owner.
+        if (call->binding.slot >= 0) {
+            Array call_args;
+            for(int i=0; i<call->arguments.size(); i++) {
+                if (!call->arguments[i]) {
+                    raise_error("Incomplete function call: missing argument");
+                    return Variant();
+                }
+                call_args.push_back(evaluate_expression(call->arguments[i]));
+            }
+            Variant ret;
+            int slot = bound_slot(call->binding.slot);
+            if (slot >= 0 && variables.is_bound(slot) && read_indexed_variable(variables.get_slot(slot), call_args, ret)) {
+                return ret;
+            }
+            if (call->binding.kind == BIND_SUB) {
+                bool found = false;
+                ret = call_internal(call->binding.index, call_args, found);
+                if (found) return ret;
+            }
+            return call_owner_method(call->method_name, call_args);
+        }
         
         // Delegate to centralized expression-level builtins first (they may evaluate arguments themselves)
         {
@@ -1766,6 +2058,9 @@ Variant VisualGasicInstance::evaluate_expression(ExpressionNode* expr) {
             }
 
             Variant base = evaluate_expression(call->base_object);
+            if (VisualGasicObject *object = as_class_object(base)) {
+                return call_class_site(object, call->class_cache, call->method_name, call_args);
+            }
             Variant br;
             if (VisualGasicBuiltins::call_builtin_for_base_variant(this, base, call->method_name, call_args, br)) {
                 return br;
@@ -1820,50 +2115,17 @@ Variant VisualGasicInstance::evaluate_expression(ExpressionNode* expr) {
 
         // Check if it is an array access
         if (variables.has(call->method_name)) {
-            Variant v = variables[call->method_name];
-            bool is_array = (v.get_type() == Variant::ARRAY);
-            bool is_packed = (v.get_type() >= Variant::PACKED_BYTE_ARRAY && v.get_type() <= Variant::PACKED_COLOR_ARRAY); // Range check for packed arrays?
-            
-            if (is_array) {
-                // Multidimensional Read (Recursive for generic Array)
-                Variant current = v;
-                bool fail = false;
-                for(int i=0; i<call_args.size(); i++) {
-                    if (current.get_type() != Variant::ARRAY) {
-                         fail = true; break;
-                    }
-                    Array arr = current;
-                    int idx = call_args[i];
-                    if (idx >= 0 && idx < arr.size()) {
-                        current = arr[idx];
-                    } else {
-                        raise_error("Array subscript out of range");
-                        return Variant();
-                    }
-                }
-                if (!fail) return current;
-            } else if (is_packed) {
-                 // Single dimension access for Packed Arrays usually
-                 if (call_args.size() == 1) {
-                      int idx = call_args[0];
-                      // Use Variant indexing
-                      bool valid = false;
-                      bool oob = false;
-                      Variant res = v.get_indexed(idx, valid, oob);
-                      if (oob) {
-                          raise_error("Array subscript out of range");
-                          return Variant();
-                      }
-                      if (valid) return res;
-                 }
-            } else if (v.get_type() == Variant::DICTIONARY) {
-                Dictionary d = v;
-                if (call_args.size() == 1) {
-                    Variant key = call_args[0];
-                    if (d.has(key)) return d[key];
-                    return Variant();
-                }
-            }
+            Variant indexed;
+            if (read_indexed_variable(variables[call->method_name], call_args, indexed)) return indexed;
+        }
+
+        // The cases below up to call_internal all match a name from
+        // VisualGasicBuiltins::is_evaluator_intrinsic.
+        if (!VisualGasicBuiltins::is_evaluator_intrinsic(call->method_name)) {
+            bool found = false;
+            Variant v_ret = call_internal(call->method_name, call_args, found);
+            if (found) return v_ret;
+            return call_owner_method(call->method_name, call_args);
         }
 
         // Built-in Connect function
@@ -2142,9 +2404,8 @@ Variant VisualGasicInstance::evaluate_expression(ExpressionNode* expr) {
         
         if (call->method_name.nocasecmp_to("EOF") == 0 && call_args.size() == 1) {
             int file_num = (int)call_args[0];
-            if (open_files.has(file_num)) {
-                 Ref<FileAccess> fa = open_files[file_num];
-                 return fa->eof_reached();
+            if (VisualGasicFile **f = open_files.getptr(file_num)) {
+                 return (*f)->eof();
             }
             return true; 
         }
@@ -3037,17 +3298,7 @@ Variant VisualGasicInstance::evaluate_expression(ExpressionNode* expr) {
         Variant v_ret = call_internal(call->method_name, call_args, found);
         if (found) return v_ret;
 
-        if (owner) {
-             if (owner->has_method(call->method_name)) {
-                 return owner->callv(call->method_name, call_args);
-             }
-             String snake = call->method_name.to_snake_case();
-             if (owner->has_method(snake)) {
-                 return owner->callv(snake, call_args);
-             }
-        }
-        raise_error("Failed to call function " + call->method_name);
-        return Variant();
+        return call_owner_method(call->method_name, call_args);
     }
     if (expr->type == ExpressionNode::UNARY_OP) {
         UnaryOpNode* u = (UnaryOpNode*)expr;
@@ -3241,9 +3492,13 @@ void VisualGasicInstance::execute_statement(Statement* stmt) {
             Variant val = evaluate_expression(s->expression);
             if (s->file_number) {
                 int fn = evaluate_expression(s->file_number);
-                if (open_files.has(fn)) {
-                     Ref<FileAccess> fa = open_files[fn];
-                     fa->store_line(String(val));
+                if (VisualGasicFile **f = open_files.getptr(fn)) {
+                     VisualGasicFile::Mode mode = (*f)->get_mode();
+                     if (mode == VisualGasicFile::MODE_OUTPUT || mode == VisualGasicFile::MODE_APPEND) {
+                         (*f)->write_line(String(val));
+                     } else {
+                         raise_error("Bad file mode", 54);
+                     }
                 } else {
                      raise_error("Bad File Name or Number");
                 }
@@ -3338,11 +3593,12 @@ void VisualGasicInstance::execute_statement(Statement* stmt) {
         case STMT_READ: {
              ReadStatement* s = (ReadStatement*)stmt;
              for(int i=0; i<s->targets.size(); i++) {
-                 if (data_pointer >= data_segments.size()) {
+                 if (!data_pool.ensure(data_pointer)) {
                      raise_error("Out of Data");
                      break;
                  }
-                 Variant val = evaluate_expression(data_segments[data_pointer]);
+                 ExpressionNode* expr = data_pool.get_expression(data_pointer);
+                 Variant val = expr ? evaluate_expression(expr) : data_pool.get_value(data_pointer);
                  data_pointer++;
                  assign_to_target(s->targets[i], val);
              }
@@ -3354,7 +3610,7 @@ void VisualGasicInstance::execute_statement(Statement* stmt) {
                  data_pointer = 0;
              } else {
                  if (label_to_data_index.has(s->label_name)) {
-                     data_pointer = (int)label_to_data_index[s->label_name];
+                     data_pointer = (int64_t)label_to_data_index[s->label_name];
                  } else {
                      raise_error("Label not found for Restore: " + s->label_name);
                  }
@@ -3428,31 +3684,50 @@ void VisualGasicInstance::execute_statement(Statement* stmt) {
         
         case STMT_FOR: {
             ForStatement* s = (ForStatement*)stmt;
-            String var = s->variable_name;
+            const String &var = s->variable_name;
             Variant start = evaluate_expression(s->from_val);
             Variant end = evaluate_expression(s->to_val);
             Variant step = s->step_val ? evaluate_expression(s->step_val) : Variant(1);
-            
-            // UtilityFunctions::print("FOR Loop: ", var, " from ", start, " to ", end, " step ", step);
-
-            assign_variable(var, start);
-            
-            int safety = 0;
-            while (safety < 1000) {
-                 Variant current = variables[var];
-                 // UtilityFunctions::print("  Loop iter: ", current);
-
-                 bool condition = false;
-                 Variant res; bool valid;
-                 if (double(step) >= 0) {
-                     Variant::evaluate(Variant::OP_LESS_EQUAL, current, end, res, valid);
-                     condition = res.booleanize();
+            if (error_state.has_error) break;
+
+            int slot = s->binding.slot >= 0 ? bound_slot(s->binding.slot) : variables.find(var);
+            assign_variable_slot(slot, var, start);
+            if (error_state.has_error) break;
+            if (slot < 0) slot = variables.find(var);
+            // An owner property used as the counter is read and written by name.
+            bool in_slot = slot >= 0 && variables.is_bound(slot);
+
+            // Integer bounds and step compare and step the counter as int64
+            // while it stays an Integer/Long; anything else goes through Variant.
+            bool ascending = double(step) >= 0;
+            bool int_bounds = end.get_type() == Variant::INT && step.get_type() == Variant::INT;
+            int64_t end_i = int_bounds ? (int64_t)end : 0;
+            int64_t step_i = int_bounds ? (int64_t)step : 0;
+            bool watchdog = loop_watchdog_enabled();
+            uint64_t started_ms = loop_watchdog_ms > 0 ? Time::get_singleton()->get_ticks_msec() : 0;
+
+            for (int64_t iterations = 0;; iterations++) {
+                 if (watchdog && loop_watchdog_tripped(iterations, started_ms)) break;
+
+                 Variant current;
+                 bool compared = false;
+                 if (in_slot) {
+                     const Variant &counter = variables.get_slot(slot);
+                     if (int_bounds && counter.get_type() == Variant::INT) {
+                         int64_t c = counter;
+                         if (ascending ? c > end_i : c < end_i) break;
+                         compared = true;
+                     } else {
+                         current = counter;
+                     }
                  } else {
-                     Variant::evaluate(Variant::OP_GREATER_EQUAL, current, end, res, valid);
-                     condition = res.booleanize();
+                     get_variable(var, current);
+                 }
+                 if (!compared) {
+                     Variant res; bool valid;
+                     Variant::evaluate(ascending ? Variant::OP_LESS_EQUAL : Variant::OP_GREATER_EQUAL, current, end, res, valid);
+                     if (!res.booleanize()) break;
                  }
-                 
-                 if (!condition) break;
                  
                  for(int i=0; i<s->body.size(); i++) {
                      execute_statement(s->body[i]);
@@ -3460,35 +3735,47 @@ void VisualGasicInstance::execute_statement(Statement* stmt) {
                  }
                  
                  if (error_state.has_error) {
-                     if (error_state.mode == ErrorState::CONTINUE_FOR) {
-                         error_state.has_error = false;
-                         error_state.mode = ErrorState::NONE;
-                         // Increment and continue
-                         Variant res; bool valid;
-                         Variant::evaluate(Variant::OP_ADD, variables[var], step, res, valid);
-                         assign_variable(var, res);
-                         safety++;
-                         continue;
-                     }
-
                      if (error_state.mode == ErrorState::EXIT_FOR) {
                          error_state.has_error = false;
                          error_state.mode = ErrorState::NONE;
                          break;
                      }
-                     break; // Propagate other errors/exits
+                     if (error_state.mode != ErrorState::CONTINUE_FOR) break; // Propagate other errors/exits
+                     error_state.has_error = false;
+                     error_state.mode = ErrorState::NONE;
                  }
                  
-                 Variant::evaluate(Variant::OP_ADD, variables[var], step, res, valid);
-                 assign_variable(var, res);
-                 safety++;
+                 // Next: the body may have assigned the counter, so step from its current value.
+                 bool notify = in_slot && is_whenever_watched(slot);
+                 if (in_slot) {
+                     const Variant &counter = variables.get_slot(slot);
+                     if (int_bounds && counter.get_type() == Variant::INT && !notify) {
+                         int64_t c = counter;
+                         // Stepping past the int64 range also steps past end_i.
+                         if (ascending ? c > INT64_MAX - step_i : c < INT64_MIN - step_i) break;
+                         journal_record_slot(slot);
+                         variables.bind_slot(slot) = c + step_i;
+                         continue;
+                     }
+                     Variant res; bool valid;
+                     Variant::evaluate(Variant::OP_ADD, counter, step, res, valid);
+                     assign_variable_slot(slot, var, res, notify);
+                 } else {
+                     get_variable(var, current);
+                     Variant res; bool valid;
+                     Variant::evaluate(Variant::OP_ADD, current, step, res, valid);
+                     assign_variable(var, res);
+                 }
+                 if (error_state.has_error) break;
             }
             break;
         }
         case STMT_WHILE: {
             WhileStatement* s = (WhileStatement*)stmt;
-            int safety = 0;
-            while (safety < 10000) {
+            bool watchdog = loop_watchdog_enabled();
+            uint64_t started_ms = loop_watchdog_ms > 0 ? Time::get_singleton()->get_ticks_msec() : 0;
+            for (int64_t iterations = 0;; iterations++) {
+                if (watchdog && loop_watchdog_tripped(iterations, started_ms)) break;
                 if (!evaluate_expression(s->condition).booleanize()) break;
                 for(int i=0; i<s->body.size(); i++) {
                     execute_statement(s->body[i]);
@@ -3499,7 +3786,6 @@ void VisualGasicInstance::execute_statement(Statement* stmt) {
                      if (error_state.mode == ErrorState::CONTINUE_WHILE || error_state.mode == ErrorState::CONTINUE_DO) {
                          error_state.has_error = false;
                          error_state.mode = ErrorState::NONE;
-                         safety++;
                          continue; // Next iteration
                      }
                      if (error_state.mode == ErrorState::EXIT_DO) {
@@ -3509,16 +3795,15 @@ void VisualGasicInstance::execute_statement(Statement* stmt) {
                      }
                      break;
                 }
-                
-                safety++;
             }
-            if (safety >= 10000) UtilityFunctions::print("Runtime: While loop limit reached.");
             break;
         }
         case STMT_DO: {
             DoStatement* s = (DoStatement*)stmt;
-            int safety = 0;
-            while (safety < 10000) {
+            bool watchdog = loop_watchdog_enabled();
+            uint64_t started_ms = loop_watchdog_ms > 0 ? Time::get_singleton()->get_ticks_msec() : 0;
+            for (int64_t iterations = 0;; iterations++) {
+                if (watchdog && loop_watchdog_tripped(iterations, started_ms)) break;
                 // Pre Check
                 if (!s->is_post_condition && s->condition_type != DoStatement::NONE) {
                     bool res = evaluate_expression(s->condition).booleanize();
@@ -3535,24 +3820,13 @@ void VisualGasicInstance::execute_statement(Statement* stmt) {
                      if (error_state.mode == ErrorState::CONTINUE_DO) {
                          error_state.has_error = false;
                          error_state.mode = ErrorState::NONE;
-                         
-                         // Handle Post-Condition Check for Continue Do
-                         if (s->is_post_condition && s->condition_type != DoStatement::NONE) {
-                             bool res = evaluate_expression(s->condition).booleanize();
-                             if (s->condition_type == DoStatement::WHILE && !res) break;
-                             if (s->condition_type == DoStatement::UNTIL && res) break;
-                         }
-                         
-                         safety++;
-                         continue;
-                     }
-
-                     if (error_state.mode == ErrorState::EXIT_DO) {
+                     } else if (error_state.mode == ErrorState::EXIT_DO) {
                          error_state.has_error = false;
                          error_state.mode = ErrorState::NONE;
                          break;
+                     } else {
+                         break;
                      }
-                     break; 
                 }
                 
                 // Post Check
@@ -3561,10 +3835,7 @@ void VisualGasicInstance::execute_statement(Statement* stmt) {
                     if (s->condition_type == DoStatement::WHILE && !res) break;
                     if (s->condition_type == DoStatement::UNTIL && res) break;
                 }
-                
-                safety++;
             }
-            if (safety >= 10000) UtilityFunctions::print("Runtime: Do loop limit reached.");
             break;
         }
 
@@ -3605,6 +3876,10 @@ void VisualGasicInstance::execute_statement(Statement* stmt) {
 
         case STMT_CALL: {
             CallStatement* s = (CallStatement*)stmt;
+            if (s->binding.kind == BIND_DECLARE) {
+                call_ffi_function(s->binding.index, s->arguments);
+                break;
+            }
             
             Array call_args;
             int arg_count = s->arguments.size();
@@ -3612,32 +3887,30 @@ void VisualGasicInstance::execute_statement(Statement* stmt) {
                 call_args.push_back(evaluate_expression(s->arguments[i]));
             }
 
-            // Try centralized statement-level builtins first
-            {
-                Variant _bg_ret;
-                bool _bg_found = false;
-                if (VisualGasicBuiltins::call_builtin(this, s->method_name, call_args, _bg_ret, _bg_found)) {
-                    if (_bg_found) break;
-                }
+            // A method of the running object, or of Me or a variable holding
+            // a class object.
+            if (s->binding.kind == BIND_METHOD && current_object) {
+                call_class_method(current_object, s->binding.index, call_args);
+                break;
             }
-
-            if (s->method_name.nocasecmp_to("TweenProperty") == 0) {
-                 if (call_args.size() == 4) {
-                      Object *obj = call_args[0];
-                      String prop = call_args[1];
-                      Variant final_val = call_args[2];
-                      double duration = call_args[3];
-                      if (obj && owner) {
-                           Node *n = Object::cast_to<Node>(owner);
-                           if (n) {
-                                Ref<Tween> t = n->create_tween();
-                                t->tween_property(obj, NodePath(prop), final_val, duration);
-                           }
-                      }
-                      break; 
-                 }
+            // A module Sub, else one of the interpreter's commands, as bound.
+            // A command given an argument count it does not take is passed
+            // on to the owner below.
+            if (s->binding.kind == BIND_SUB) {
+                bool found = false;
+                call_internal(s->binding.index, call_args, found);
+                if (found) break;
+            }
+            if (s->binding.kind == BIND_COMMAND && VisualGasicCommands::call_command(this, s->binding.index, call_args)) {
+                break;
+            }
+            if (s->base_object && (s->base_object->type == ExpressionNode::ME || s->base_object->type == ExpressionNode::VARIABLE)) {
+                VisualGasicObject *object = s->base_object->type == ExpressionNode::ME ? current_object : as_class_object(evaluate_expression(s->base_object));
+                if (object) {
+                    call_class_site(object, s->class_cache, s->method_name, call_args);
+                    break;
+                }
             }
-
 
             if (s->base_object) {
                 // Delegate variable-base builtins (Clipboard etc.) to centralized handler
@@ -3650,6 +3923,10 @@ void VisualGasicInstance::execute_statement(Statement* stmt) {
                  }
                  
                 Variant base = evaluate_expression(s->base_object);
+                if (VisualGasicObject *object = as_class_object(base)) {
+                    call_class_site(object, s->class_cache, s->method_name, call_args);
+                    break;
+                }
 
                     // Let builtins handle dictionary/object cases first
                     {
@@ -3752,967 +4029,99 @@ void VisualGasicInstance::execute_statement(Statement* stmt) {
                     // UtilityFunctions::print("Debug: Base type: ", base.get_type());
                     raise_error("Method call base is not an Object");
                 }
-            } else {            
-                // Built-ins (Helpers for Statements that look like calls)
-                if (s->method_name.nocasecmp_to("Connect") == 0 && call_args.size() == 3) {
-                     Object *obj = call_args[0];
-                     String signal_name = call_args[1];
-                     String target_method = call_args[2];
-                     
-                     if (obj && owner) {
-                          if (obj->has_signal(signal_name)) {
-                              Callable callable = Callable(owner, target_method);
-                              if (!obj->is_connected(signal_name, callable)) {
-                                   obj->connect(signal_name, callable);
-                              }
-                          } else {
-                              UtilityFunctions::print("Runtime Warning: Signal '", signal_name, "' not found on object");
-                          }
-                     }
-                     break;
+            } else {
+                // Unbound statements still reach Subs by name.
+                bool found = false;
+                call_internal(s->method_name, call_args, found);
+                
+                if (!found) {
+                    if (owner) {
+                        if (owner->has_method(s->method_name)) {
+                             owner->callv(s->method_name, call_args);
+                        } else {
+                             UtilityFunctions::print("Runtime Error: Object does not have method ", s->method_name);
+                        }
+                    } else {
+                         raise_error("No owner for method call");
+                    }
                 }
-
-                if (s->method_name.nocasecmp_to("Randomize") == 0) {
-                    UtilityFunctions::randomize();
+            }
+            break;
+        }
+        case STMT_RAISE: {
+             RaiseStatement* s = (RaiseStatement*)stmt;
+             Variant v_code = evaluate_expression(s->error_code);
+             int code = (int)v_code;
+             String msg = "Application error";
+             if (s->message) {
+                 msg = (String)evaluate_expression(s->message);
+             }
+             raise_error(msg, code);
+             break;
+        }
+        case STMT_WHENEVER_SECTION: {
+            WheneverSectionStatement* s = (WheneverSectionStatement*)stmt;
+            
+            WheneverSection section;
+            section.section_name = s->section_name;
+            section.variable_name = s->variable_name;
+            section.comparison_operator = s->comparison_operator;
+            section.callback_procedures = s->callback_procedures;  // Copy all callbacks
+            section.condition_expression = s->condition_expression;  // Copy expression reference
+            
+            // Set scope information
+            if (s->is_local_scope) {
+                section.scope_type = "local";
+                section.scope_context = current_sub ? current_sub->name : "global";
+            } else {
+                section.scope_type = "global";
+                section.scope_context = "";
+            }
+            
+            section.is_active = true;
+            
+            if (s->comparison_value) {
+                section.comparison_value = evaluate_expression(s->comparison_value);
+            }
+            
+            if (s->comparison_value2) {
+                section.comparison_value2 = evaluate_expression(s->comparison_value2);
+            }
+            
+            // Initialize last_value with current variable value
+            Variant current_value;
+            if (get_variable(s->variable_name, current_value)) {
+                section.last_value = current_value;
+            }
+            if (!s->variable_name.is_empty()) {
+                section.variable_slot = variables.intern(s->variable_name);
+            }
+            
+            whenever_sections.push_back(section);
+            rebuild_whenever_index();
+            if (whenever_deferred) {
+                Node *node = Object::cast_to<Node>(owner);
+                if (node && !node->is_processing()) node->set_process(true);
+            }
+            break;
+        }
+        case STMT_SUSPEND_WHENEVER: {
+            SuspendWheneverStatement* s = (SuspendWheneverStatement*)stmt;
+            
+            for (int i = 0; i < whenever_sections.size(); i++) {
+                if (whenever_sections[i].section_name == s->section_name) {
+                    whenever_sections.write[i].is_active = false;
                     break;
                 }
-                if (s->method_name.nocasecmp_to("Beep") == 0) {
-                    if (owner && Object::cast_to<Node>(owner)) {
-                         Node *n = Object::cast_to<Node>(owner);
-                         AudioStreamPlayer *player = memnew(AudioStreamPlayer);
-                         AudioStreamWAV *wav = memnew(AudioStreamWAV);
-                         wav->set_format(AudioStreamWAV::FORMAT_16_BITS);
-                         wav->set_mix_rate(44100);
-                         
-                         int sample_rate = 44100;
-                         float duration = 0.2f;
-                         int frames = (int)(sample_rate * duration);
-                         PackedByteArray pba;
-                         pba.resize(frames * 2);
-                         
-                         for(int i=0; i<frames; i++) {
-                              float t = (float)i / (float)sample_rate;
-                              float wave = UtilityFunctions::sin(t * 880.0f * 2.0f * Math_PI); // 880Hz Beep
-                              int16_t sample = (int16_t)(wave * 30000.0f);
-                              pba.encode_s16(i * 2, sample);
-                         }
-                         
-                         wav->set_data(pba);
-                         player->set_stream(wav);
-                         n->add_child(player);
-                         player->play();
-                         
-                         // Auto-delete on finish
-                         player->connect("finished", Callable(player, "queue_free"));
-                    }
-                    break;
-                }
-                if (s->method_name.nocasecmp_to("Sleep") == 0 && call_args.size() == 1) {
-                     int ms = (int)call_args[0];
-                     OS::get_singleton()->delay_msec(ms);
-                     break;
-                }
-                if (s->method_name.nocasecmp_to("Shell") == 0 && call_args.size() >= 1) {
-                     String cmd_line = call_args[0];
-                     
-                     String exe = "";
-                     Array args;
-                     int i = 0;
-                     while(i < cmd_line.length() && cmd_line[i] == ' ') i++;
-                     if (i < cmd_line.length()) {
-                         if (cmd_line[i] == '"') {
-                             i++;
-                             while(i < cmd_line.length() && cmd_line[i] != '"') { exe += cmd_line[i]; i++; }
-                             i++;
-                         } else {
-                             while(i < cmd_line.length() && cmd_line[i] != ' ') { exe += cmd_line[i]; i++; }
-                         }
-                     }
-                     while(i < cmd_line.length()) {
-                          while(i < cmd_line.length() && cmd_line[i] == ' ') i++; 
-                          if (i >= cmd_line.length()) break;
-                          String arg = "";
-                          if (cmd_line[i] == '"') {
-                               i++;
-                               while(i < cmd_line.length() && cmd_line[i] != '"') { arg += cmd_line[i]; i++; }
-                               i++;
-                          } else {
-                               while(i < cmd_line.length() && cmd_line[i] != ' ') { arg += cmd_line[i]; i++; }
-                          }
-                          args.push_back(arg);
-                     }
-
-                     OS::get_singleton()->execute(exe, args);
-                     break;
-                }
-                if (s->method_name.nocasecmp_to("MkDir") == 0 && call_args.size() == 1) {
-                     String path = call_args[0];
-                     DirAccess::make_dir_recursive_absolute(path);
-                     break;
-                }
-                if (s->method_name.nocasecmp_to("RmDir") == 0 && call_args.size() == 1) {
-                     String path = call_args[0];
-                     DirAccess::remove_absolute(path); // Or remove? remove_absolute likely maps to simple remove if folder? Godot behavior for DirAccess::remove on folder?
-                     // Usually works on empty folder.
-                     break;
-                }
-                
-                // --- File System Extended ---
-                if (s->method_name.nocasecmp_to("Kill") == 0 && call_args.size() == 1) {
-                     String path = call_args[0];
-                     if (!path.begins_with("res://") && !path.begins_with("user://")) path = "user://" + path;
-                     if (FileAccess::file_exists(path)) {
-                         DirAccess::remove_absolute(path);
-                     } else {
-                         raise_error("File not found: " + path);
-                     }
-                     break;
-                }
-                if (s->method_name.nocasecmp_to("Name") == 0 && call_args.size() == 2) {
-                     String p1 = call_args[0];
-                     String p2 = call_args[1];
-                     if (!p1.begins_with("res://") && !p1.begins_with("user://")) p1 = "user://" + p1;
-                     if (!p2.begins_with("res://") && !p2.begins_with("user://")) p2 = "user://" + p2;
-                     
-                     if (DirAccess::rename_absolute(p1, p2) != OK) {
-                         raise_error("Failed to rename file");
-                     }
-                     break;
-                }
-                if (s->method_name.nocasecmp_to("FileCopy") == 0 && call_args.size() == 2) {
-                     String p1 = call_args[0];
-                     String p2 = call_args[1];
-                     if (!p1.begins_with("res://") && !p1.begins_with("user://")) p1 = "user://" + p1;
-                     if (!p2.begins_with("res://") && !p2.begins_with("user://")) p2 = "user://" + p2;
-                     
-                     if (DirAccess::copy_absolute(p1, p2) != OK) {
-                         raise_error("Failed to copy file");
-                     }
-                     break;
-                }
-
-                // --- Physics Commands ---
-                if (s->method_name.nocasecmp_to("ApplyForce") == 0 && call_args.size() >= 3) {
-                     Object *obj = call_args[0];
-                     if (obj) {
-                         double x = call_args[1];
-                         double y = call_args[2];
-                         if (obj->is_class("RigidBody2D")) {
-                             Object::cast_to<RigidBody2D>(obj)->apply_force(Vector2(x, y));
-                         } else if (obj->is_class("RigidBody3D")) {
-                             double z = (call_args.size() >= 4) ? (double)call_args[3] : 0.0;
-                             Object::cast_to<RigidBody3D>(obj)->apply_force(Vector3(x, y, z));
-                         }
-                     }
-                     break;
-                }
-                if (s->method_name.nocasecmp_to("ApplyImpulse") == 0 && call_args.size() >= 3) {
-                     Object *obj = call_args[0];
-                     if (obj) {
-                         double x = call_args[1];
-                         double y = call_args[2];
-                         if (obj->is_class("RigidBody2D")) {
-                             Object::cast_to<RigidBody2D>(obj)->apply_impulse(Vector2(x, y));
-                         } else if (obj->is_class("RigidBody3D")) {
-                             double z = (call_args.size() >= 4) ? (double)call_args[3] : 0.0;
-                             Object::cast_to<RigidBody3D>(obj)->apply_impulse(Vector3(x, y, z));
-                         }
-                     }
-                     break;
-                }
-                if (s->method_name.nocasecmp_to("SetVelocity") == 0 && call_args.size() >= 3) {
-                     Object *obj = call_args[0];
-                     if (obj) {
-                         double x = call_args[1];
-                         double y = call_args[2];
-                         if (obj->is_class("RigidBody2D")) {
-                             Object::cast_to<RigidBody2D>(obj)->set_linear_velocity(Vector2(x, y));
-                         } else if (obj->is_class("RigidBody3D")) {
-                             double z = (call_args.size() >= 4) ? (double)call_args[3] : 0.0;
-                             Object::cast_to<RigidBody3D>(obj)->set_linear_velocity(Vector3(x, y, z));
-                         } else if (obj->is_class("CharacterBody2D")) {
-                             Object::cast_to<CharacterBody2D>(obj)->set_velocity(Vector2(x, y));
-                         } else if (obj->is_class("CharacterBody3D")) {
-                             double z = (call_args.size() >= 4) ? (double)call_args[3] : 0.0;
-                             Object::cast_to<CharacterBody3D>(obj)->set_velocity(Vector3(x, y, z));
-                         }
-                     }
-                     break;
-                }
-
-                // --- Animation System ---
-                if (s->method_name.nocasecmp_to("Animate") == 0 && call_args.size() >= 4) {
-                     Object *obj = call_args[0];
-                     String prop = call_args[1];
-                     Variant val = call_args[2];
-                     double dur = call_args[3];
-                     
-                     Node *n = Object::cast_to<Node>(obj);
-                     if (n) {
-                         // Property Aliasing for Tween
-                         String actual_prop = prop;
-                         if (prop == "Left") actual_prop = "position:x";
-                         if (prop == "Top") actual_prop = "position:y";
-                         if (prop == "Width") actual_prop = "size:x";
-                         if (prop == "Height") actual_prop = "size:y";
-                         if (prop == "Caption") actual_prop = "text";
-                         if (prop == "Value") actual_prop = "value";
-                         // Timer
-                         if (n->is_class("Timer") && prop == "Interval") {
-                             actual_prop = "wait_time";
-                             val = (double)val / 1000.0;
-                         }
-
-                         Ref<Tween> tween = n->create_tween();
-                         if (tween.is_valid()) {
-                             tween->tween_property(n, actual_prop, val, dur);
-                         }
-                     }
-                     break;
-                }
-
-                if (s->method_name.nocasecmp_to("MsgBox") == 0 && call_args.size() >= 1) {
-                     String msg = call_args[0];
-                     int buttons = 0;
-                     if (call_args.size() >= 2) buttons = (int)call_args[1];
-                     String title = "VisualGasic";
-                     if (call_args.size() >= 3) title = call_args[2];
-
-                     if (!owner || !Object::cast_to<Node>(owner)) {
-                          break;
-                     }
-                     Node *root = Object::cast_to<Node>(owner);
-
-                     AcceptDialog *dlg = nullptr;
-                     bool is_confirm = false;
-
-                     // Determine Dialog Type
-                     if (buttons == 4 || buttons == 1) { // vbYesNo or vbOKCancel
-                          ConfirmationDialog *cd = memnew(ConfirmationDialog);
-                          if (buttons == 4) {
-                               cd->get_ok_button()->set_text("Yes");
-                               cd->get_cancel_button()->set_text("No");
-                          }
-                          dlg = cd;
-                          is_confirm = true;
-                     } else {
-                          dlg = memnew(AcceptDialog);
-                     }
-                     
-                     dlg->set_title(title);
-                     dlg->set_text(msg);
-                     root->add_child(dlg);
-
-                     // Signal Magic
-                     dlg->set_meta("result_ok", false);
-                     dlg->connect("confirmed", Callable(dlg, "set_meta").bind("result_ok", true));
-
-                     dlg->popup_centered();
-                     
-                     while (dlg->is_visible() && dlg->is_inside_tree()) {
-                          DisplayServer::get_singleton()->process_events();
-                          OS::get_singleton()->delay_msec(10);
-                     }
-                     
-                     bool ok = (bool)dlg->get_meta("result_ok");
-                     dlg->queue_free();
-                     
-                     // Return Value logic (though this is a Statement, VB6 MsgBox statement ignores return)
-                     // If used as function, it's handled in expression parser.
-                     // But here we might just block.
-                     break;
-                }
-
-                // Persistence (Registry emulation via ConfigFile)
-                if (s->method_name.nocasecmp_to("SaveSetting") == 0 && call_args.size() == 4) {
-                     // SaveSetting(AppName, Section, Key, Value)
-                     String app = call_args[0];
-                     String section = call_args[1];
-                     String key = call_args[2];
-                     Variant val = call_args[3];
-                     
-                     Ref<ConfigFile> cfg;
-                     cfg.instantiate();
-                     String path = "user://vb_settings.cfg";
-                     cfg->load(path); // Load existing
-                     
-                     // We prefix section with AppName to simulate registry structure
-                     String real_section = app + "/" + section;
-                     cfg->set_value(real_section, key, val);
-                     cfg->save(path);
-                     break;
-                }
-
-                // GetSetting and OpenDatabase moved to evaluate_expression as they return values.
-                
-                if (s->method_name.nocasecmp_to("SaveDatabase") == 0 && call_args.size() == 2) {
-                     String path = call_args[0];
-                     Variant data = call_args[1];
-                     
-                     if (!path.begins_with("res://") && !path.begins_with("user://")) {
-                         path = "user://" + path;
-                     }
-                     Ref<FileAccess> f = FileAccess::open(path, FileAccess::WRITE);
-                     if (f.is_valid()) {
-                         String text = JSON::stringify(data, "\t");
-                         f->store_string(text);
-                     } else {
-                         raise_error("Could not write to database: " + path);
-                     }
-                     break;
-                }
-                
-                if (s->method_name.nocasecmp_to("LoadForm") == 0 && call_args.size() == 1) {
-                     String path = call_args[0];
-                     if (!path.begins_with("res://")) path = "res://" + path;
-                     
-                     Ref<PackedScene> scene = ResourceLoader::get_singleton()->load(path);
-                         if (scene.is_valid()) {
-                         Node* new_form = scene->instantiate();
-                         if (owner) {
-                             Node* owner_node = Object::cast_to<Node>(owner);
-                             if (owner_node && owner_node->is_inside_tree()) {
-                                 SceneTree *tree = owner_node->get_tree();
-                                 if (tree) {
-                                     Node* root = tree->get_root();
-                                     if (root) root->add_child(new_form);
-                                 }
-                             } else {
-                                 // Not inside scene tree; skip adding for headless/test environments.
-                             }
-                         }
-                     } else {
-                         raise_error("Could not load form: " + path);
-                     }
-                     break;
-                }
-
-                if (s->method_name.nocasecmp_to("AddChild") == 0 && call_args.size() == 1) {
-                     Object *obj = call_args[0];
-                     Node *child = Object::cast_to<Node>(obj);
-                     if (child && owner) {
-                          Node *parent = Object::cast_to<Node>(owner);
-                          if (parent) {
-                               parent->add_child(child);
-                               dynamic_nodes.push_back(child->get_instance_id());
-                          }
-                     }
-                     break;
-                }
-                
-                if (s->method_name.nocasecmp_to("CLS") == 0 || s->method_name.nocasecmp_to("ClearScreen") == 0) {
-                     for(int i=0; i<dynamic_nodes.size(); i++) {
-                         Object *obj = ObjectDB::get_instance(dynamic_nodes[i]);
-                         if (obj) {
-                             Node *n = Object::cast_to<Node>(obj);
-                             if (n) n->queue_free();
-                         }
-                     }
-                     dynamic_nodes.clear();
-                     break;
-                }
-                
-                // AI Helpers
-                int cmd_ai = 0;
-                Object *enemy = nullptr;
-                Object *target = nullptr;
-                double speed = 0;
-                double stop_dist = 0;
-                double radius = 0;
-                Array points;
-                bool loop = false;
-
-                if (s->method_name.nocasecmp_to("AI_Chase") == 0 && call_args.size() >= 3) {
-                    cmd_ai = 1;
-                    enemy = call_args[0];
-                    target = call_args[1];
-                    speed = call_args[2];
-                    if (call_args.size() >= 4) stop_dist = call_args[3];
-                }
-                else if (s->method_name.nocasecmp_to("AI_Wander") == 0 && call_args.size() >= 3) {
-                    cmd_ai = 2;
-                    enemy = call_args[0];
-                    speed = call_args[1];
-                    radius = call_args[2];
-                }
-                else if (s->method_name.nocasecmp_to("AI_Patrol") == 0 && call_args.size() >= 3) {
-                     cmd_ai = 3;
-                     enemy = call_args[0];
-                     points = call_args[1];
-                     speed = call_args[2];
-                     if (call_args.size() >= 4) loop = call_args[3];
-                }
-
-                if (cmd_ai > 0 && enemy) {
-                    Node *enemy_node = Object::cast_to<Node>(enemy);
-                    if (enemy_node) {
-                        GasicAIController *ai = nullptr;
-                        TypedArray<Node> children = enemy_node->get_children();
-                        for(int i=0; i<children.size(); i++) {
-                            Node *c = Object::cast_to<Node>(children[i]);
-                            if (c && c->is_class("GasicAIController")) {
-                                ai = Object::cast_to<GasicAIController>(c);
-                                break;
-                            }
-                        }
-                        
-                        if (!ai) {
-                            ai = memnew(GasicAIController);
-                            ai->set_name("GasicAI");
-                            enemy_node->add_child(ai);
-                        }
-                        
-                        if (cmd_ai == 1) ai->start_chase(target, speed, stop_dist);
-                        if (cmd_ai == 2) ai->start_wander(speed, radius);
-                        if (cmd_ai == 3) ai->start_patrol(points, speed, loop);
-                    }
-                    break;
-                }
-                
-                if (s->method_name.nocasecmp_to("AI_Stop") == 0 && call_args.size() == 1) {
-                }
-
-                if (s->method_name.nocasecmp_to("AI_Stop") == 0 && call_args.size() == 1) {
-                    Object *enemy = call_args[0];
-                     if (enemy) {
-                        Node *enemy_node = Object::cast_to<Node>(enemy);
-                        if (enemy_node) {
-                            TypedArray<Node> children = enemy_node->get_children();
-                            for(int i=0; i<children.size(); i++) {
-                                Node *c = Object::cast_to<Node>(children[i]);
-                                if (c && c->is_class("GasicAIController")) {
-                                    GasicAIController *ai = Object::cast_to<GasicAIController>(c);
-                                    ai->stop();
-                                    break;
-                                }
-                            }
-                        }
-                     }
-                     break;
-                }
-
-                // Helper to create simple text label
-                if (s->method_name.nocasecmp_to("CreateText") == 0 && call_args.size() >= 3) {
-                     // CreateText(text, x, y, [out_var]) -> But this is a statement, so "CreateText "Hello", 10, 10"
-                     // Ideally it returns the label object if possible?
-                     // Commands in Basic usually don't return.
-                     // But we can implement it as:
-                     // Dim l
-                     // Set l = CreateText("Hello", 10, 10) -> In Expression Evaluator?
-                     // Let's implement it in Expression Evaluator instead.
-                }
-
-                if (s->method_name.nocasecmp_to("ChangeScene") == 0 && call_args.size() == 1) {
-                     String path = call_args[0];
-                     if (owner) {
-                          Node *n = Object::cast_to<Node>(owner);
-                          if (n) {
-                               SceneTree *tree = n->get_tree();
-                               if (tree) {
-                                    tree->change_scene_to_file(path);
-                               }
-                          }
-                     }
-                     break;
-                }
-
-                // Audio Helpers
-                if (s->method_name.nocasecmp_to("PlayMusic") == 0 && call_args.size() == 1) {
-                     String path = call_args[0];
-                     Ref<AudioStream> stream = ResourceLoader::get_singleton()->load(path);
-                     if (stream.is_valid() && owner) {
-                          Node *n = Object::cast_to<Node>(owner);
-                          if (n) {
-                               // Check existing
-                               if (n->has_meta("__BG_MUSIC__")) {
-                                   Object *old = n->get_meta("__BG_MUSIC__");
-                                   if (old) {
-                                       Node *old_n = Object::cast_to<Node>(old);
-                                       if (old_n) old_n->queue_free();
-                                   }
-                               }
-                               
-                               AudioStreamPlayer *p = memnew(AudioStreamPlayer);
-                               p->set_stream(stream);
-                               p->set_autoplay(true);
-                               // Loop? Resource loop mode determines it usually, or we can explicit loop.
-                               // Godot 4: Loop is property of AudioStream (import settings) or WAV/OGG resource.
-                               n->add_child(p);
-                               n->set_meta("__BG_MUSIC__", p);
-                          }
-                     }
-                     break;
-                }
-
-                if (s->method_name.nocasecmp_to("StopMusic") == 0) {
-                     if (owner) {
-                         Node *n = Object::cast_to<Node>(owner);
-                         if (n && n->has_meta("__BG_MUSIC__")) {
-                             Object *old = n->get_meta("__BG_MUSIC__");
-                             if (old) {
-                                  Node *old_n = Object::cast_to<Node>(old);
-                                  if (old_n) old_n->queue_free();
-                             }
-                             n->remove_meta("__BG_MUSIC__");
-                         }
-                     }
-                     break;
-                }
-
-                if (s->method_name.nocasecmp_to("AddMenuItem") == 0 && call_args.size() >= 3) {
-                     Object *menu_obj = call_args[0];
-                     if (menu_obj && menu_obj->is_class("PopupMenu")) {
-                         PopupMenu *pm = Object::cast_to<PopupMenu>(menu_obj);
-                         String text = call_args[1];
-                         String callback = call_args[2];
-                         
-                         pm->add_item(text);
-                         int idx = pm->get_item_count() - 1;
-                         // Logic to bind index?
-                         // We can bind "id_pressed(int)" to a dispatcher.
-                         // But we need to know WHICH item triggered.
-                         // Simple approach: Map ID to Callback name in metadata?
-                         
-                         // Or connect "id_pressed" to _OnSignal, and let it pass the ID.
-                         // But we want to call specific callback.
-                         
-                         // Let's use metadata on the PopupMenu: Map<ID, CallbackName>
-                         Dictionary callback_map;
-                         if (pm->has_meta("callbacks")) {
-                             callback_map = pm->get_meta("callbacks");
-                         } else {
-                             // First time: connect signal
-                             pm->connect("id_pressed", Callable(owner, "_OnSignal").bind(pm->get_name(), "MenuClick")); 
-                             // Wait, name of popup might be auto gen.
-                         }
-                         
-                         // Let's assume the user handles "Menu_MenuClick(ID)".
-                         // But user asked for specific callback.
-                         // "Sub File_New_Click()"
-                         
-                         // We can store the callback name in the Item Meta?
-                         // PopupMenu doesn't support item metadata easily until Godot 4.x?
-                         // set_item_metadata(idx, metadata)
-                         pm->set_item_metadata(idx, callback);
-                         
-                         // Ensure handler is connected
-                         if (!pm->is_connected("id_pressed", Callable(owner, "_OnSignal"))) {
-                             // Bind "Menu" as Name, "Click" as Event.
-                             // But we need to dispatch dynamically based on metadata.
-                             // Complex.
-                             // Workaround: We bind to a special internal handler?
-                             // No, let's use the Metadata approach.
-                             // Modify _OnSignal to check for metadata if the sender is a PopupMenu?
-                             // Or just bind to "Menu" and let VB user write:
-                             // Sub Menu_MenuClick(ID)
-                             //    Select Case ID ...
-                             // End Sub
-                             
-                             // User Request: "AddMenuItem(Menu, Text, CallbackName)"
-                             // This implies the callback is specific.
-                             // VB6 style was Menu Editor -> Name -> Sub Name_Click().
-                             
-                             // Let's support: "Sub MyCallbackname(ItemText)"
-                             // We need a trampoline.
-                             // Let's rely on _OnSignal intercepting.
-                         }
-                         
-                         // Store callback name in a Dictionary in the Menu object Meta
-                         callback_map[idx] = callback;
-                         pm->set_meta("callbacks", callback_map);
-                     }
-                     break;
-                }
-                
-                if (s->method_name.nocasecmp_to("MoveAndSlide") == 0 && call_args.size() >= 1) {
-                     Object *obj = call_args[0];
-                     CharacterBody2D *cb2d = Object::cast_to<CharacterBody2D>(obj);
-                     if (cb2d) {
-                         cb2d->move_and_slide();
-                         break;
-                     }
-                     CharacterBody3D *cb3d = Object::cast_to<CharacterBody3D>(obj);
-                     if (cb3d) {
-                         cb3d->move_and_slide();
-                         break;
-                     }
-                     break;
-                }
-
-                if (s->method_name.nocasecmp_to("PlaySound") == 0 && call_args.size() == 1) {
-                     String path = call_args[0];
-                     Ref<AudioStream> stream = ResourceLoader::get_singleton()->load(path);
-                     if (stream.is_valid() && owner) {
-                          Node *n = Object::cast_to<Node>(owner);
-                          if (n) {
-                               AudioStreamPlayer *p = memnew(AudioStreamPlayer);
-                               p->set_stream(stream);
-                               p->set_autoplay(true);
-                               // Auto-free when done? Not built-in for simple player.
-                               // For now, just add child. It will leak if we spawn tons.
-                               // Real BASIC engines manage channels.
-                               // We can set it to free on finish signal?
-                               // Connect "finished" to "queue_free".
-                               p->connect("finished", Callable(p, "queue_free"));
-                               n->add_child(p);
-                          }
-                     }
-                     break;
-                }
-                
-                if (s->method_name.nocasecmp_to("PlayTone") == 0 && call_args.size() >= 2) {
-                    double freq = (double)call_args[0];
-                    double dur_ms = (double)call_args[1];
-                    int waveform = 0; // Sine default
-                    if (call_args.size() >= 3) waveform = (int)call_args[2];
-
-                    Ref<AudioStreamWAV> stream;
-                    stream.instantiate();
-                    
-                    int mix_rate = 44100;
-                    stream->set_mix_rate(mix_rate);
-                    stream->set_format(AudioStreamWAV::FORMAT_16_BITS);
-                    stream->set_stereo(false); // Mono
-
-                    int samples = (int)(dur_ms * mix_rate / 1000.0);
-                    if (samples > 0) {
-                        PackedByteArray data;
-                        data.resize(samples * 2); // 16-bit = 2 bytes
-
-                        for (int i = 0; i < samples; ++i) {
-                            double t = (double)i / mix_rate;
-                            double val = 0.0;
-                            // Use explicit PI constant
-                            const double PI = 3.14159265358979323846;
-                            
-                            switch (waveform) {
-                                case 1: // Square
-                                    val = (sin(2.0 * PI * freq * t) > 0) ? 1.0 : -1.0;
-                                    break;
-                                case 2: // Sawtooth
-                                    val = 2.0 * (t * freq - floor(t * freq + 0.5));
-                                    break;
-                                case 3: // Noise
-                                    val = ((double)rand() / RAND_MAX) * 2.0 - 1.0; 
-                                    break;
-                                default: // Sine
-                                    val = sin(2.0 * PI * freq * t);
-                                    break;
-                            }
-                            
-                            val *= 0.5; // Avoid clipping
-
-                            int16_t sample_int = (int16_t)(val * 32767.0);
-                            data[i * 2] = (uint8_t)(sample_int & 0xFF);
-                            data[i * 2 + 1] = (uint8_t)((sample_int >> 8) & 0xFF);
-                        }
-                        stream->set_data(data);
-                    }
-
-                    if (owner) {
-                         Node *n = Object::cast_to<Node>(owner);
-                         if (n) {
-                              AudioStreamPlayer *p = memnew(AudioStreamPlayer);
-                              p->set_stream(stream);
-                              p->set_autoplay(true);
-                              p->connect("finished", Callable(p, "queue_free"));
-                              n->add_child(p);
-                         }
-                    }
-                     break;
-                }
-
-                // --- Immediate Drawing Commands ---
-                // Works when called from OnDraw event
-                if (s->method_name.nocasecmp_to("DrawLine") == 0 && call_args.size() >= 4) {
-                     // DrawLine(x1, y1, x2, y2, [color], [width])
-                     double x1 = call_args[0]; double y1 = call_args[1];
-                     double x2 = call_args[2]; double y2 = call_args[3];
-                     Color c = (call_args.size() > 4) ? (Color)call_args[4] : Color(1,1,1);
-                     float width = (call_args.size() > 5) ? (float)call_args[5] : 1.0f;
-                     
-                     if (owner) {
-                          CanvasItem *ci = Object::cast_to<CanvasItem>(owner);
-                          if (ci) ci->draw_line(Vector2(x1, y1), Vector2(x2, y2), c, width);
-                     }
-                     break;
-                }
-                if (s->method_name.nocasecmp_to("DrawRect") == 0 && call_args.size() >= 4) {
-                     // DrawRect(x, y, w, h, [color], [filled])
-                     double x = call_args[0]; double y = call_args[1];
-                     double w = call_args[2]; double h = call_args[3];
-                     Color c = (call_args.size() > 4) ? (Color)call_args[4] : Color(1,1,1);
-                     bool filled = (call_args.size() > 5) ? (bool)call_args[5] : true;
-                     
-                     if (owner) {
-                          CanvasItem *ci = Object::cast_to<CanvasItem>(owner);
-                          if (ci) ci->draw_rect(Rect2(x, y, w, h), c, filled);
-                     }
-                     break;
-                }
-                if (s->method_name.nocasecmp_to("DrawCircle") == 0 && call_args.size() >= 3) {
-                     // DrawCircle(x, y, radius, [color])
-                     double x = call_args[0]; double y = call_args[1];
-                     float r = call_args[2];
-                     Color c = (call_args.size() > 3) ? (Color)call_args[3] : Color(1,1,1);
-                     
-                     if (owner) {
-                          CanvasItem *ci = Object::cast_to<CanvasItem>(owner);
-                          if (ci) ci->draw_circle(Vector2(x,y), r, c);
-                     }
-                     break;
-                }
-                if (s->method_name.nocasecmp_to("DrawPixel") == 0 || s->method_name.nocasecmp_to("PSet") == 0) {
-                     // PSet(x, y, color)
-                     if (call_args.size() >= 3) {
-                          double x = call_args[0]; double y = call_args[1];
-                          Color c = call_args[2];
-                          if (owner) {
-                               CanvasItem *ci = Object::cast_to<CanvasItem>(owner);
-                               // draw_primitive needs arrays. simpler to use draw_rect 1x1
-                               if (ci) ci->draw_rect(Rect2(x, y, 1, 1), c, true);
-                          }
-                     }
-                     break;
-                }
-
-                // --- 3D Primitive Shapes ---
-                if (s->method_name.nocasecmp_to("CreateCube") == 0 && call_args.size() >= 3) {
-                     // CreateCube(sx, sy, sz, [px, py, pz], [color])
-                     // Arguments are complex to parse optionally, so let's check size.
-                     double sx = call_args[0]; double sy = call_args[1]; double sz = call_args[2];
-                     
-                     MeshInstance3D *mi = memnew(MeshInstance3D);
-                     Ref<BoxMesh> box; box.instantiate();
-                     box->set_size(Vector3(sx, sy, sz));
-                     
-                     // Optional Color -> Material
-                     int last_arg_idx = call_args.size() - 1;
-                     if (call_args[last_arg_idx].get_type() == Variant::COLOR) {
-                         Ref<StandardMaterial3D> mat; mat.instantiate();
-                         mat->set_albedo((Color)call_args[last_arg_idx]);
-                         box->set_material(mat);
-                     }
-                     
-                     mi->set_mesh(box);
-                     
-                     // Position?
-                     if (call_args.size() >= 6) { 
-                         double px = call_args[3]; double py = call_args[4]; double pz = call_args[5];
-                         mi->set_position(Vector3(px, py, pz));
-                     }
-                     
-                     if (owner) {
-                         Node* n = Object::cast_to<Node>(owner);
-                         if (n) { n->add_child(mi); dynamic_nodes.push_back(mi->get_instance_id()); }
-                     }
-                     break;
-                }
-                
-                if (s->method_name.nocasecmp_to("CreateSphere") == 0 && call_args.size() >= 1) {
-                     float r = call_args[0];
-                     
-                     MeshInstance3D *mi = memnew(MeshInstance3D);
-                     Ref<SphereMesh> sphere; sphere.instantiate();
-                     sphere->set_radius(r);
-                     sphere->set_height(r * 2);
-                     
-                     // Optional Color
-                     int last_arg_idx = call_args.size() - 1;
-                     if (call_args.size() > 1 && call_args[last_arg_idx].get_type() == Variant::COLOR) {
-                         Ref<StandardMaterial3D> mat; mat.instantiate();
-                         mat->set_albedo((Color)call_args[last_arg_idx]);
-                         sphere->set_material(mat);
-                     }
-                     
-                     if (call_args.size() >= 4) {
-                         mi->set_position(Vector3(call_args[1], call_args[2], call_args[3]));
-                     }
-                     
-                     mi->set_mesh(sphere);
-                     
-                     if (owner) {
-                         Node* n = Object::cast_to<Node>(owner);
-                         if (n) { n->add_child(mi); dynamic_nodes.push_back(mi->get_instance_id()); }
-                     }
-                     break;
-                }
-
-                // Shader Helpers
-                if (s->method_name.nocasecmp_to("SetShader") == 0 && call_args.size() == 2) {
-                     // SetShader(node, shader_or_null)
-                     Object *obj = call_args[0];
-                     CanvasItem *ci = Object::cast_to<CanvasItem>(obj);
-                     if (ci) {
-                         Variant sh = call_args[1];
-                         if (sh.get_type() == Variant::OBJECT) {
-                              Object *check_obj = sh;
-                              if (check_obj) {
-                                  Ref<Shader> shader = sh;
-                                  if (shader.is_valid()) {
-                                      Ref<ShaderMaterial> mat;
-                                      mat.instantiate();
-                                      mat->set_shader(shader);
-                                      ci->set_material(mat);
-                                  } else {
-                                      // Maybe they passed a material?
-                                      Ref<Material> mat_res = sh;
-                                      if (mat_res.is_valid()) {
-                                          ci->set_material(mat_res);
-                                      }
-                                  }
-                              } else {
-                                   // Null object variant
-                                   ci->set_material(Ref<Material>());
-                              }
-                         } else {
-                              // Clear shader if not object
-                              ci->set_material(Ref<Material>());
-                         }
-                     }
-                     break;
-                }
-                
-                // Screen & Window
-                if (s->method_name.nocasecmp_to("SetTitle") == 0 && call_args.size() == 1) {
-                     String title = call_args[0];
-                     if (owner) {
-                          Node *n = Object::cast_to<Node>(owner);
-                          if (n) {
-                              Window *w = n->get_window();
-                              if (w) w->set_title(title);
-                          }
-                     }
-                     break;
-                }
-                if (s->method_name.nocasecmp_to("SetScreenSize") == 0 && call_args.size() == 2) {
-                     int w_val = call_args[0];
-                     int h_val = call_args[1];
-                     if (owner) {
-                          Node *n = Object::cast_to<Node>(owner);
-                          if (n) {
-                              Window *w = n->get_window();
-                              if (w) w->set_size(Vector2i(w_val, h_val));
-                          }
-                     }
-                     break;
-                }
-                
-                // Text Drawing (Basic)
-                if (s->method_name.nocasecmp_to("DrawText") == 0 && call_args.size() >= 2) {
-                     // DrawText(pos, text, [color])
-                     if (owner) {
-                          CanvasItem *ci = Object::cast_to<CanvasItem>(owner);
-                          if (ci) {
-                               Vector2 pos = call_args[0];
-                               String text = call_args[1];
-                               Color col = Color(1,1,1,1);
-                               if (call_args.size() > 2) col = call_args[2];
-                               
-                               // Get Default Font?
-                               // ThemeDB does not exist in 4.x GDExtension bindings yet sometimes?
-                               // Or maybe use Label's default font.
-                               // Let's rely on CanvasItem default font logic which requires a font to be passed.
-                               // Use ThemeDB::get_singleton()->get_fallback_font()
-                               Ref<Font> font;
-                               // We need to support loading font or uses default.
-                               // For now, let's skip font arg and use a simple debug approach.
-                               // If we can't get a font, we can't draw string easily in GDExtension without creating one.
-                               // Actually, let's try to load a default font if user didn't provide one?
-                               // Or just expose "LoadFont".
-                               
-                               // For this iteration, let's assume we need a font to draw string properly or it might fail/print nothing.
-                               // But wait, Debug draw usually works.
-                               ci->draw_string(Ref<Font>(), pos, text, HorizontalAlignment::HORIZONTAL_ALIGNMENT_LEFT, -1, 16, col);
-                          }
-                     }
-                     break;
-                }
-
-                // Try Internal Call
-                bool found = false;
-                call_internal(s->method_name, call_args, found);
-                
-                if (!found) {
-                    if (owner) {
-                        if (owner->has_method(s->method_name)) {
-                             owner->callv(s->method_name, call_args);
-                        } else {
-                             UtilityFunctions::print("Runtime Error: Object does not have method ", s->method_name);
-                        }
-                    } else {
-                         raise_error("No owner for method call");
-                    }
-                }
-            }
-            break;
-        }
-        case STMT_RAISE: {
-             RaiseStatement* s = (RaiseStatement*)stmt;
-             Variant v_code = evaluate_expression(s->error_code);
-             int code = (int)v_code;
-             String msg = "Application error";
-             if (s->message) {
-                 msg = (String)evaluate_expression(s->message);
-             }
-             raise_error(msg, code);
-             break;
-        }
-        case STMT_WHENEVER_SECTION: {
-            WheneverSectionStatement* s = (WheneverSectionStatement*)stmt;
-            
-            WheneverSection section;
-            section.section_name = s->section_name;
-            section.variable_name = s->variable_name;
-            section.comparison_operator = s->comparison_operator;
-            section.callback_procedures = s->callback_procedures;  // Copy all callbacks
-            section.condition_expression = s->condition_expression;  // Copy expression reference
-            
-            // Set scope information
-            if (s->is_local_scope) {
-                section.scope_type = "local";
-                section.scope_context = current_sub ? current_sub->name : "global";
-            } else {
-                section.scope_type = "global";
-                section.scope_context = "";
-            }
-            
-            section.is_active = true;
-            
-            if (s->comparison_value) {
-                section.comparison_value = evaluate_expression(s->comparison_value);
-            }
-            
-            if (s->comparison_value2) {
-                section.comparison_value2 = evaluate_expression(s->comparison_value2);
-            }
-            
-            // Initialize last_value with current variable value
-            Variant current_value;
-            if (get_variable(s->variable_name, current_value)) {
-                section.last_value = current_value;
-            }
-            
-            whenever_sections.push_back(section);
-            break;
-        }
-        case STMT_SUSPEND_WHENEVER: {
-            SuspendWheneverStatement* s = (SuspendWheneverStatement*)stmt;
-            
-            for (int i = 0; i < whenever_sections.size(); i++) {
-                if (whenever_sections[i].section_name == s->section_name) {
-                    whenever_sections.write[i].is_active = false;
-                    break;
-                }
-            }
-            break;
-        }
-        case STMT_RESUME_WHENEVER: {
-            ResumeWheneverStatement* s = (ResumeWheneverStatement*)stmt;
-            
-            for (int i = 0; i < whenever_sections.size(); i++) {
-                if (whenever_sections[i].section_name == s->section_name) {
-                    whenever_sections.write[i].is_active = true;
+            }
+            break;
+        }
+        case STMT_RESUME_WHENEVER: {
+            ResumeWheneverStatement* s = (ResumeWheneverStatement*)stmt;
+            
+            for (int i = 0; i < whenever_sections.size(); i++) {
+                if (whenever_sections[i].section_name == s->section_name) {
+                    whenever_sections.write[i].is_active = true;
                     break;
                 }
             }
@@ -4800,26 +4209,10 @@ void VisualGasicInstance::execute_statement(Statement* stmt) {
                  break;
             }
             
-            Ref<FileAccess> file = FileAccess::open(path, FileAccess::READ);
-            if (file.is_null()) {
+            // Queued after the values already there; READ parses it as it goes.
+            if (data_pool.add_file(path) != OK) {
                 raise_error("LoadData: Could not open file: " + path, 201);
-                break;
-            }
-            
-            String content = file->get_as_text();
-            file->close();
-            
-            // Parse using static helper
-            Vector<ExpressionNode*> new_data = VisualGasicParser::parse_data_values_from_text(content);
-            
-            // Append to data_segments
-            // IMPORTANT: Who owns these new nodes? 
-            // We should add them to a cleanup list in Instance.
-            for(int i=0; i<new_data.size(); i++) {
-                data_segments.push_back(new_data[i]);
-                runtime_data_nodes.push_back(new_data[i]);
             }
-            
             break;
         }
         case STMT_SELECT: {
@@ -4856,12 +4249,8 @@ void VisualGasicInstance::execute_statement(Statement* stmt) {
             int fn = (int)evaluate_expression(s->file_number);
             int pos = (int)evaluate_expression(s->position);
             
-            if (open_files.has(fn)) {
-                Ref<FileAccess> fa = open_files[fn];
-                fa->seek(pos); // In Godot, seek is absolute from beginning
-                if (fa->get_error() != Error::OK) {
-                   raise_error("Seek Failed", 53); // File not found or IO Error? 53 is generic file error
-                }
+            if (VisualGasicFile **f = open_files.getptr(fn)) {
+                (*f)->seek(pos); // 1-based: a byte, or a record number in Random mode
             } else {
                 raise_error("Bad File Number", 52);
             }
@@ -5014,34 +4403,22 @@ void VisualGasicInstance::execute_statement(Statement* stmt) {
                 break;
             }
             
-            Ref<FileAccess> fa;
-            if (s->mode == OpenStatement::MODE_INPUT) fa = FileAccess::open(path, FileAccess::READ);
-            else if (s->mode == OpenStatement::MODE_OUTPUT) fa = FileAccess::open(path, FileAccess::WRITE);
-            else if (s->mode == OpenStatement::MODE_APPEND) {
-                 if (FileAccess::file_exists(path)) {
-                     fa = FileAccess::open(path, FileAccess::READ_WRITE);
-                     if (fa.is_valid()) fa->seek_end();
-                 } else {
-                     fa = FileAccess::open(path, FileAccess::WRITE);
-                 }
-            }
-            
-            if (fa.is_null()) { 
-                 raise_error("Failed to open file: " + path);
+            int64_t record_length = s->record_length ? (int64_t)evaluate_expression(s->record_length) : VisualGasicFile::DEFAULT_RECORD_LENGTH;
+            Error err = OK;
+            VisualGasicFile *f = VisualGasicFile::open(path, (VisualGasicFile::Mode)s->mode, (VisualGasicFile::Access)s->access, record_length, err);
+            if (!f) { 
+                 raise_error(err == ERR_INVALID_PARAMETER ? String("Bad record length") : "Failed to open file: " + path);
             } else {
-                 open_files[fn] = fa;
+                 open_files.insert(fn, f);
             }
             break;
         }
         case STMT_CLOSE: {
              CloseStatement* s = (CloseStatement*)stmt;
              if (s->file_number) {
-                 int fn = evaluate_expression(s->file_number);
-                 if (open_files.has(fn)) {
-                      open_files.erase(fn); 
-                 }
+                 close_file(evaluate_expression(s->file_number));
              } else {
-                 open_files.clear();
+                 close_all_files();
              }
              break;
         }
@@ -5049,19 +4426,18 @@ void VisualGasicInstance::execute_statement(Statement* stmt) {
             InputStatement* s = (InputStatement*)stmt;
             if (s->file_number) {
                 int fn = evaluate_expression(s->file_number);
-                if (open_files.has(fn)) {
-                    Ref<FileAccess> fa = open_files[fn];
+                if (VisualGasicFile **f = open_files.getptr(fn)) {
                     if (s->is_line_input) {
-                        String line = fa->get_line();
+                        String line = (*f)->read_line();
                         if (s->variables.size() > 0) {
                              assign_to_target(s->variables[0], line);
                         }
                     } else {
-                        PackedStringArray values = fa->get_csv_line();
+                        // Numbers arrive parsed; Strings stay Strings.
+                        Vector<Variant> values;
+                        (*f)->read_fields(values);
                         for(int i=0; i<s->variables.size() && i<values.size(); i++) {
-                             Variant val = values[i];
-                             if (String(val).is_valid_float()) val = String(val).to_float(); 
-                             assign_to_target(s->variables[i], val); 
+                             assign_to_target(s->variables[i], values[i]); 
                         }
                     }
                 } else {
@@ -5070,6 +4446,29 @@ void VisualGasicInstance::execute_statement(Statement* stmt) {
             }
             break;
         }
+        case STMT_FILE_RECORD: {
+            FileRecordStatement* s = (FileRecordStatement*)stmt;
+            int fn = evaluate_expression(s->file_number);
+            VisualGasicFile **f = open_files.getptr(fn);
+            if (!f) {
+                raise_error("Bad File Name or Number", 52);
+                break;
+            }
+            int64_t position = s->position ? (int64_t)evaluate_expression(s->position) : -1;
+            Variant value = evaluate_expression(s->variable);
+            const VisualGasicFile::Layout *layout = record_layout_for(value);
+            String record_error;
+            if (s->is_put) {
+                if (!(*f)->put_value(value, position, record_error, layout)) {
+                    raise_error(record_error, record_error == "Bad record length" ? 59 : 54);
+                }
+            } else if ((*f)->get_value(value, position, record_error, layout)) {
+                assign_to_target(s->variable, value);
+            } else {
+                raise_error(record_error, 54);
+            }
+            break;
+        }
         case STMT_NAME: {
             NameStatement* s = (NameStatement*)stmt;
             String old_path = evaluate_expression(s->old_path);
@@ -5122,21 +4521,302 @@ void VisualGasicInstance::execute_statement(Statement* stmt) {
     }
 }
 
+void VisualGasicInstance::journal_begin() {
+    VariableJournalFrame frame;
+    frame.mark = variable_journal.size();
+    variable_journal_frames.push_back(frame);
+}
+
+void VisualGasicInstance::journal_record(const String &p_name) {
+    if (variable_journal_frames.is_empty() || p_name.is_empty()) {
+        return;
+    }
+    journal_record_slot(variables.intern(p_name));
+}
+
+void VisualGasicInstance::journal_record_slot(int p_slot) {
+    if (variable_journal_frames.is_empty() || p_slot < 0) {
+        return;
+    }
+    VariableJournalFrame &frame = variable_journal_frames.write[variable_journal_frames.size() - 1];
+    if (frame.recorded_slots.has(p_slot)) {
+        return;
+    }
+    frame.recorded_slots.insert(p_slot);
+
+    // Only the binding: a container's contents are journaled per element
+    // as they are written, so rebinding it costs nothing extra here.
+    VariableJournalEntry entry;
+    entry.slot = p_slot;
+    entry.existed = variables.is_bound(p_slot);
+    if (entry.existed) {
+        entry.old_value = variables.get_slot(p_slot);
+    }
+    variable_journal.push_back(entry);
+}
+
+// The storage an Array or Dictionary shares with all its copies: godot-cpp
+// wrappers hold the engine's pointer to it as their only member.
+static const void *vg_container_id(const Variant &p_container) {
+    if (p_container.get_type() == Variant::ARRAY) {
+        Array arr = p_container;
+        return *(const void *const *)arr._native_ptr();
+    }
+    if (p_container.get_type() == Variant::DICTIONARY) {
+        Dictionary dict = p_container;
+        return *(const void *const *)dict._native_ptr();
+    }
+    return nullptr;
+}
+
+void VisualGasicInstance::journal_record_element(const Variant &p_container, const Variant &p_key) {
+    if (variable_journal_frames.is_empty()) {
+        return;
+    }
+    VariableJournalEntry entry;
+    if (p_container.get_type() == Variant::ARRAY) {
+        Array arr = p_container;
+        int64_t idx = p_key;
+        if (idx < 0 || idx >= arr.size()) {
+            return; // Out of range: nothing is written
+        }
+        entry.old_value = arr[idx];
+        entry.existed = true;
+    } else if (p_container.get_type() == Variant::DICTIONARY) {
+        Dictionary dict = p_container;
+        entry.existed = dict.has(p_key);
+        if (entry.existed) {
+            entry.old_value = dict.get(p_key, Variant());
+        }
+    } else {
+        return;
+    }
+    // Only the first write per element and frame: its old value is the one a
+    // rollback needs, so a loop refilling an array records each slot once.
+    VariableJournalFrame &frame = variable_journal_frames.write[variable_journal_frames.size() - 1];
+    JournalElement element;
+    element.container = vg_container_id(p_container);
+    element.key = p_key;
+    if (frame.recorded_elements.has(element)) {
+        return;
+    }
+    frame.recorded_elements.insert(element);
+    entry.container = p_container;
+    entry.key = p_key;
+    variable_journal.push_back(entry);
+}
+
+void VisualGasicInstance::journal_record_container(const Variant &p_container) {
+    if (variable_journal_frames.is_empty()) {
+        return;
+    }
+    Variant::Type t = p_container.get_type();
+    if (t != Variant::ARRAY && t != Variant::DICTIONARY) {
+        return;
+    }
+    // Clearing or refilling already touches every element, so the copy adds
+    // no more than the operation costs. Shallow is enough: nested containers
+    // journal their own writes.
+    VariableJournalEntry entry;
+    entry.container = p_container;
+    entry.snapshot = p_container.duplicate(false);
+    variable_journal.push_back(entry);
+}
+
+void VisualGasicInstance::journal_commit() {
+    if (variable_journal_frames.is_empty()) {
+        return;
+    }
+    int mark = variable_journal_frames[variable_journal_frames.size() - 1].mark;
+    variable_journal_frames.remove_at(variable_journal_frames.size() - 1);
+    if (variable_journal_frames.is_empty()) {
+        variable_journal.clear();
+        return;
+    }
+
+    // The caller may still roll back, so hand our entries to it. Names and
+    // elements it has already recorded keep the caller's older value; the
+    // rest are adopted.
+    VariableJournalFrame &parent = variable_journal_frames.write[variable_journal_frames.size() - 1];
+    int write_idx = mark;
+    for (int i = mark; i < variable_journal.size(); i++) {
+        const VariableJournalEntry &entry = variable_journal[i];
+        if (entry.slot >= 0) {
+            if (parent.recorded_slots.has(entry.slot)) {
+                continue;
+            }
+            parent.recorded_slots.insert(entry.slot);
+        } else if (entry.snapshot.get_type() == Variant::NIL) {
+            JournalElement element;
+            element.container = vg_container_id(entry.container);
+            element.key = entry.key;
+            if (parent.recorded_elements.has(element)) {
+                continue;
+            }
+            parent.recorded_elements.insert(element);
+        }
+        if (write_idx != i) {
+            variable_journal.write[write_idx] = entry;
+        }
+        write_idx++;
+    }
+    variable_journal.resize(write_idx);
+}
+
+void VisualGasicInstance::journal_rollback() {
+    if (variable_journal_frames.is_empty()) {
+        return;
+    }
+    int mark = variable_journal_frames[variable_journal_frames.size() - 1].mark;
+    variable_journal_frames.remove_at(variable_journal_frames.size() - 1);
+
+    for (int i = variable_journal.size() - 1; i >= mark; i--) {
+        VariableJournalEntry &entry = variable_journal.write[i];
+        if (entry.slot >= 0) {
+            if (entry.existed) {
+                variables.set_slot(entry.slot, entry.old_value);
+            } else {
+                variables.unbind_slot(entry.slot);
+            }
+            continue;
+        }
+        // Restore container contents in place so aliases see the old state too.
+        if (entry.container.get_type() == Variant::ARRAY) {
+            Array arr = entry.container;
+            if (entry.snapshot.get_type() == Variant::ARRAY) {
+                arr.assign(entry.snapshot);
+            } else {
+                int64_t idx = entry.key;
+                if (idx >= 0 && idx < arr.size()) {
+                    arr[idx] = entry.old_value;
+                }
+            }
+        } else if (entry.container.get_type() == Variant::DICTIONARY) {
+            Dictionary dict = entry.container;
+            if (entry.snapshot.get_type() == Variant::DICTIONARY) {
+                dict.clear();
+                dict.merge(entry.snapshot);
+            } else if (entry.existed) {
+                dict[entry.key] = entry.old_value; // An erased key comes back last in order
+            } else {
+                dict.erase(entry.key);
+            }
+        }
+    }
+    variable_journal.resize(mark);
+}
+
+void VisualGasicInstance::sync_bound_slots() {
+    const ModuleNode *module = script->ast_root;
+    bound_generation = module->bind_generation;
+    if (variables.get_layout_generation() == module->bind_generation) {
+        bound_slots.clear(); // Layout slots are table slots, see bound_slot()
+        return;
+    }
+    bound_slots.resize(module->slot_names.size());
+    int *slots = bound_slots.ptrw();
+    for (int i = 0; i < module->slot_names.size(); i++) {
+        slots[i] = variables.intern(module->slot_names[i]);
+    }
+}
+
+// Reads `name(args)` when name holds an array, packed array or dictionary.
+// Returns false when p_value cannot be indexed that way.
+bool VisualGasicInstance::read_indexed_variable(const Variant &p_value, const Array &p_args, Variant &r_ret) {
+    Variant v = p_value;
+    bool is_array = (v.get_type() == Variant::ARRAY);
+    bool is_packed = (v.get_type() >= Variant::PACKED_BYTE_ARRAY && v.get_type() <= Variant::PACKED_COLOR_ARRAY); // Range check for packed arrays?
+
+    if (is_array) {
+        // Multidimensional Read (Recursive for generic Array)
+        Variant current = v;
+        for(int i=0; i<p_args.size(); i++) {
+            if (current.get_type() != Variant::ARRAY) {
+                 return false;
+            }
+            Array arr = current;
+            int idx = p_args[i];
+            if (idx >= 0 && idx < arr.size()) {
+                current = arr[idx];
+            } else {
+                raise_error("Array subscript out of range");
+                r_ret = Variant();
+                return true;
+            }
+        }
+        r_ret = current;
+        return true;
+    } else if (is_packed) {
+         // Single dimension access for Packed Arrays usually
+         if (p_args.size() == 1) {
+              int idx = p_args[0];
+              // Use Variant indexing
+              bool valid = false;
+              bool oob = false;
+              Variant res = v.get_indexed(idx, valid, oob);
+              if (oob) {
+                  raise_error("Array subscript out of range");
+                  r_ret = Variant();
+                  return true;
+              }
+              if (valid) {
+                  r_ret = res;
+                  return true;
+              }
+         }
+    } else if (v.get_type() == Variant::DICTIONARY) {
+        Dictionary d = v;
+        if (p_args.size() == 1) {
+            Variant key = p_args[0];
+            r_ret = d.has(key) ? d[key] : Variant();
+            return true;
+        }
+    }
+    return false;
+}
+
+// Last resort for a call no Sub or builtin handled: a method of the owner.
+Variant VisualGasicInstance::call_owner_method(const String &p_method, const Array &p_args) {
+    if (owner) {
+         if (owner->has_method(p_method)) {
+             return owner->callv(p_method, p_args);
+         }
+         String snake = p_method.to_snake_case();
+         if (owner->has_method(snake)) {
+             return owner->callv(snake, p_args);
+         }
+    }
+    raise_error("Failed to call function " + p_method);
+    return Variant();
+}
+
 Variant VisualGasicInstance::call_internal(const String& p_method, const Array& p_args, bool &r_found) {
     r_found = false;
     if (!script.is_valid() || !script->ast_root) return Variant();
 
-    SubDefinition *func = nullptr;
     for(int i=0; i<script->ast_root->subs.size(); i++) {
         if (script->ast_root->subs[i]->name.nocasecmp_to(p_method) == 0) {
-            func = script->ast_root->subs[i];
-            break;
+            return call_internal(i, p_args, r_found);
         }
     }
-    
-    if (!func) return Variant();
+    return Variant();
+}
+
+Variant VisualGasicInstance::call_internal(int p_sub_index, const Array& p_args, bool &r_found) {
+    r_found = false;
+    if (!script.is_valid() || !script->ast_root) return Variant();
+    if (p_sub_index < 0 || p_sub_index >= script->ast_root->subs.size()) return Variant();
     r_found = true;
 
+    // Module Subs run outside any object, also when a Class method calls them.
+    VisualGasicObject *prev_object = current_object;
+    current_object = nullptr;
+    Variant ret = run_procedure(script->ast_root->subs[p_sub_index], p_sub_index, p_args);
+    current_object = prev_object;
+    return ret;
+}
+
+Variant VisualGasicInstance::run_procedure(SubDefinition *func, int p_bytecode_index, const Array& p_args) {
     // Save Context
     SubDefinition* prev_sub = current_sub;
     int prev_jump = jump_target;
@@ -5148,6 +4828,7 @@ Variant VisualGasicInstance::call_internal(const String& p_method, const Array&
     // Actually we iterate params to define them.
     for(int i=0; i<max_params; i++) {
         Parameter& param = func->parameters.write[i];
+        journal_record(param.name);
         
         if (param.is_param_array) {
             Array rest;
@@ -5188,6 +4869,7 @@ Variant VisualGasicInstance::call_internal(const String& p_method, const Array&
              else if (t == "string") init_val = "";
              else if (t == "boolean") init_val = false;
         }
+        journal_record(func->name);
         variables[func->name] = init_val;
     }
 
@@ -5198,17 +4880,16 @@ Variant VisualGasicInstance::call_internal(const String& p_method, const Array&
 
     bool used_bytecode = false;
     Variant bytecode_ret;
-    Dictionary bytecode_variables_backup;
     ErrorState bytecode_error_backup = error_state;
-    bool has_backup = false;
-    if (script.is_valid()) {
-        BytecodeChunk *chunk = script->get_bytecode_for(func->name);
+    if (p_bytecode_index >= 0) {
+        BytecodeChunk *chunk = script->get_bytecode_for_sub(p_bytecode_index);
         if (chunk) {
-            bytecode_variables_backup = variables.duplicate(true);
-            has_backup = true;
+            journal_begin();
             used_bytecode = execute_bytecode(chunk, func, bytecode_ret);
-            if (!used_bytecode && has_backup) {
-                variables = bytecode_variables_backup;
+            if (used_bytecode) {
+                journal_commit();
+            } else {
+                journal_rollback();
                 error_state = bytecode_error_backup;
             }
         }
@@ -5248,15 +4929,13 @@ Variant VisualGasicInstance::call_internal(const String& p_method, const Array&
         }
     }
     
+    // Bytecode keeps the Function result in a frame slot, so only the AST
+    // walker's result lives in `variables`.
     Variant ret = Variant();
-    if (func->type == SubDefinition::TYPE_FUNCTION) {
-        if (variables.has(func->name)) {
-            ret = variables[func->name];
-        } else if (used_bytecode) {
-            ret = bytecode_ret;
-        }
-    } else if (used_bytecode) {
+    if (used_bytecode) {
         ret = bytecode_ret;
+    } else if (func->type == SubDefinition::TYPE_FUNCTION && variables.has(func->name)) {
+        ret = variables[func->name];
     }
     
     // Restore
@@ -5366,6 +5045,21 @@ void VisualGasicInstance::raise_error(String msg, int code) {
 
 
 
+// p_iterations is how many times the loop body already ran. The clock is
+// only read every 1024 iterations.
+bool VisualGasicInstance::loop_watchdog_tripped(int64_t p_iterations, uint64_t p_start_ms) {
+    if (loop_watchdog_iterations > 0 && p_iterations >= loop_watchdog_iterations) {
+        raise_error("Loop watchdog: more than " + String::num_int64(loop_watchdog_iterations) + " iterations");
+        return true;
+    }
+    if (loop_watchdog_ms > 0 && (p_iterations & 1023) == 0 &&
+            Time::get_singleton()->get_ticks_msec() - p_start_ms >= (uint64_t)loop_watchdog_ms) {
+        raise_error("Loop watchdog: loop ran longer than " + String::num_int64(loop_watchdog_ms) + " ms");
+        return true;
+    }
+    return false;
+}
+
 // Static Helper for Auto-Connection
 static void _connect_vb_signals_recursive(Node* node, VisualGasicInstance* instance, Node* instance_owner) {
     if (!node) return;
@@ -5463,6 +5157,9 @@ void VisualGasicInstance::notification(int32_t p_what) {
          }
     }
     else if (p_what == Node::NOTIFICATION_PROCESS) {
+         if (!whenever_pending.is_empty()) {
+             flush_whenever_pending();
+         }
          if (script.is_valid() && script->has_method("_Process")) {
              double delta = 0.0;
              if (owner) {
@@ -5494,10 +5191,22 @@ void VisualGasicInstance::notification(int32_t p_what) {
     }
     // Handle Drawing
     else if (p_what == CanvasItem::NOTIFICATION_DRAW) {
+         // The framebuffer goes underneath; OnDraw's shapes are batched
+         // and flushed in a few draw calls when it returns.
+         CanvasItem *canvas = Object::cast_to<CanvasItem>(owner);
+         if (canvas && draw_batch) {
+             draw_batch->draw_framebuffer(canvas);
+         }
          if (script.is_valid() && script->has_method("OnDraw")) {
              bool found;
              Array args;
+             if (canvas) {
+                 get_draw_batch()->begin(canvas);
+             }
              call_internal("OnDraw", args, found);
+             if (canvas) {
+                 draw_batch->end();
+             }
          }
     }
 }
@@ -5638,9 +5347,21 @@ const GDExtensionScriptInstanceInfo3 *VisualGasicInstance::get_script_instance_i
     return &info;
 }
 
-void VisualGasicInstance::assign_variable(const String& name, Variant val) {
+void VisualGasicInstance::assign_variable(const String& name, Variant val, SlotHint *p_slot_hint) {
+    SlotHint unused_hint;
+    SlotHint &hint = p_slot_hint ? *p_slot_hint : unused_hint;
+    assign_variable_slot(variables.find_hinted(name, hint), name, val);
+}
+
+// p_slot is the slot of `name` in `variables`, or -1 if it was never interned.
+// p_notify is false only when the caller already knows no Whenever section
+// watches the slot (see is_whenever_watched).
+void VisualGasicInstance::assign_variable_slot(int p_slot, const String& name, Variant val, bool p_notify) {
+    int slot = p_slot;
+    bool defined = slot >= 0 && variables.is_bound(slot);
+
     if (script.is_valid() && script->ast_root && script->ast_root->option_explicit) {
-         if (!variables.has(name)) {
+         if (!defined) {
              bool is_prop = false;
              if (owner) {
                  Variant current = owner->get(name);
@@ -5654,22 +5375,24 @@ void VisualGasicInstance::assign_variable(const String& name, Variant val) {
          }
     }
 
-    if (variables.has(name)) {
-         Variant::Type target_type = variables[name].get_type();
+    if (defined) {
+         journal_record_slot(slot);
+         Variant &target = variables.bind_slot(slot);
+         Variant::Type target_type = target.get_type();
          if (target_type == Variant::INT) {
-             variables[name] = (int64_t)val;
+             target = (int64_t)val;
          }
          else if (target_type == Variant::FLOAT) {
-             variables[name] = (double)val;
+             target = (double)val;
          }
          else if (target_type == Variant::STRING) {
-             variables[name] = (String)val;
+             target = (String)val;
          }
          else if (target_type == Variant::BOOL) {
-             variables[name] = (bool)val;
+             target = (bool)val;
          }
          else {
-             variables[name] = val;
+             target = val;
          }
     } else if (owner) {
          Variant current = owner->get(name);
@@ -5677,126 +5400,213 @@ void VisualGasicInstance::assign_variable(const String& name, Variant val) {
              owner->set(name, val);
              return;
          }
-         variables[name] = val;
+         if (slot < 0) slot = variables.intern(name);
+         journal_record_slot(slot);
+         variables.set_slot(slot, val);
     } else {
-         variables[name] = val;
+         if (slot < 0) slot = variables.intern(name);
+         journal_record_slot(slot);
+         variables.set_slot(slot, val);
     }
     
-    // Check Whenever sections for this variable
-    check_whenever_conditions(name, val);
-    
-    // Check complex expression conditions
-    check_expression_conditions();
+    if (p_notify) {
+        notify_whenever(slot, val);
+    }
 }
 
-void VisualGasicInstance::check_whenever_conditions(const String& variable_name, const Variant& new_value) {
+void VisualGasicInstance::rebuild_whenever_index() {
+    whenever_watchers.clear();
+    whenever_opaque_sections.clear();
+    whenever_pending.clear();
+    whenever_revision++;
     for (int i = 0; i < whenever_sections.size(); i++) {
-        WheneverSection& section = whenever_sections.write[i];
-        
-        if (!section.is_active || section.variable_name != variable_name) {
-            continue;
+        const WheneverSection& section = whenever_sections[i];
+        if (section.variable_slot >= 0) {
+            whenever_watchers[section.variable_slot].value_sections.push_back(i);
+        }
+        if (section.condition_expression) {
+            Vector<String> reads;
+            if (VisualGasicBinder::collect_reads(section.condition_expression, reads)) {
+                for (int r = 0; r < reads.size(); r++) {
+                    Vector<int> &sections = whenever_watchers[variables.intern(reads[r])].expression_sections;
+                    if (sections.is_empty() || sections[sections.size() - 1] != i) {
+                        sections.push_back(i);
+                    }
+                }
+            } else {
+                whenever_opaque_sections.push_back(i);
+            }
         }
-        
-        bool condition_met = false;
-        
-        if (section.comparison_operator.to_lower() == "changes") {
-            // Always trigger if value changed
-            condition_met = (section.last_value != new_value);
-        }
-        else if (section.comparison_operator.to_lower() == "becomes") {
-            // Trigger if value becomes the specified value
-            condition_met = (new_value == section.comparison_value);
-        }
-        else if (section.comparison_operator.to_lower() == "exceeds") {
-            // Trigger if value exceeds the specified value
-            double new_num = (double)new_value;
-            double threshold = (double)section.comparison_value;
-            condition_met = (new_num > threshold);
-        }
-        else if (section.comparison_operator.to_lower() == "below") {
-            // Trigger if value is below the specified value
-            double new_num = (double)new_value;
-            double threshold = (double)section.comparison_value;
-            condition_met = (new_num < threshold);
-        }
-        else if (section.comparison_operator.to_lower() == "between") {
-            // Trigger if value is between two specified values
-            double new_num = (double)new_value;
-            double min_val = (double)section.comparison_value;
-            double max_val = (double)section.comparison_value2;
-            condition_met = (new_num >= min_val && new_num <= max_val);
-        }
-        else if (section.comparison_operator.to_lower() == "contains") {
-            // Trigger if string/array contains the specified value
-            String haystack = String(new_value);
-            String needle = String(section.comparison_value);
-            condition_met = haystack.contains(needle);
+        if (section.pending) {
+            whenever_pending.push_back(i);
         }
-        
-        if (condition_met) {
-            // Check debounce timing
-            uint64_t current_time = Time::get_singleton()->get_ticks_msec();
-            if (section.debounce_ms > 0 && (current_time - section.last_trigger_time) < section.debounce_ms) {
-                // Skip this trigger due to debouncing
-                section.last_value = new_value;  // Still update last value
-                continue;
-            }
-            
-            // Update last trigger time
-            section.last_trigger_time = current_time;
-            
-            // Update last value for future comparisons
-            section.last_value = new_value;
-            
-            // Call all callback procedures
-            Array empty_args;
-            for (int j = 0; j < section.callback_procedures.size(); j++) {
-                bool found = false;
-                call_internal(section.callback_procedures[j], empty_args, found);
-                
-                if (!found) {
-                    UtilityFunctions::print("Warning: Whenever callback procedure '", section.callback_procedures[j], "' not found");
+    }
+}
+
+// Called after every assignment to a slot. Only the sections indexed under
+// that slot (and expressions whose reads are unknown) are looked at.
+void VisualGasicInstance::notify_whenever(int p_slot, const Variant& new_value) {
+    const WheneverWatchers *watchers = whenever_watchers.getptr(p_slot);
+    if (!watchers && whenever_opaque_sections.is_empty()) {
+        return;
+    }
+    // Copies share the buffers; they keep the lists valid if a callback
+    // adds or removes sections.
+    Vector<int> value_sections;
+    Vector<int> expression_sections;
+    if (watchers) {
+        value_sections = watchers->value_sections;
+        expression_sections = watchers->expression_sections;
+    }
+    Vector<int> opaque_sections = whenever_opaque_sections;
+
+    if (whenever_deferred) {
+        const Vector<int> *lists[3] = { &value_sections, &expression_sections, &opaque_sections };
+        for (const Vector<int> *list : lists) {
+            for (int i = 0; i < list->size(); i++) {
+                WheneverSection& section = whenever_sections.write[(*list)[i]];
+                if (section.is_active && !section.pending) {
+                    section.pending = true;
+                    whenever_pending.push_back((*list)[i]);
                 }
             }
-        } else {
-            // Update last value even if condition wasn't met (for "changes" tracking)
-            section.last_value = new_value;
+        }
+        return;
+    }
+
+    uint64_t revision = whenever_revision;
+    for (int i = 0; i < value_sections.size() && revision == whenever_revision; i++) {
+        fire_whenever_value_section(value_sections[i], new_value);
+    }
+    for (int i = 0; i < expression_sections.size() && revision == whenever_revision; i++) {
+        fire_whenever_expression_section(expression_sections[i]);
+    }
+    for (int i = 0; i < opaque_sections.size() && revision == whenever_revision; i++) {
+        fire_whenever_expression_section(opaque_sections[i]);
+    }
+}
+
+// Checks the sections queued since the last frame. Each runs once, against
+// the current value of its variable.
+void VisualGasicInstance::flush_whenever_pending() {
+    Vector<int> pending = whenever_pending;
+    whenever_pending.clear();
+    for (int i = 0; i < pending.size(); i++) {
+        whenever_sections.write[pending[i]].pending = false;
+    }
+    uint64_t revision = whenever_revision;
+    for (int i = 0; i < pending.size() && revision == whenever_revision; i++) {
+        const WheneverSection& section = whenever_sections[pending[i]];
+        if (section.condition_expression) {
+            fire_whenever_expression_section(pending[i]);
+        } else if (section.variable_slot >= 0) {
+            Variant current = variables.get_slot(section.variable_slot);
+            fire_whenever_value_section(pending[i], current);
         }
     }
 }
 
-void VisualGasicInstance::check_expression_conditions() {
-    for (int i = 0; i < whenever_sections.size(); i++) {
-        WheneverSection& section = whenever_sections.write[i];
+void VisualGasicInstance::fire_whenever_value_section(int p_index, const Variant& new_value) {
+    WheneverSection& section = whenever_sections.write[p_index];
+    if (!section.is_active) {
+        return;
+    }
         
-        if (!section.is_active || !section.condition_expression) {
-            continue;
-        }
+    bool condition_met = false;
+    String op = section.comparison_operator.to_lower();
         
-        // Check debounce timing
-        uint64_t current_time = Time::get_singleton()->get_ticks_msec();
-        if (section.debounce_ms > 0 && (current_time - section.last_trigger_time) < section.debounce_ms) {
-            continue;
+    if (op == "changes") {
+        // Always trigger if value changed
+        condition_met = (section.last_value != new_value);
+    }
+    else if (op == "becomes") {
+        // Trigger if value becomes the specified value
+        condition_met = (new_value == section.comparison_value);
+    }
+    else if (op == "exceeds") {
+        // Trigger if value exceeds the specified value
+        double new_num = (double)new_value;
+        double threshold = (double)section.comparison_value;
+        condition_met = (new_num > threshold);
+    }
+    else if (op == "below") {
+        // Trigger if value is below the specified value
+        double new_num = (double)new_value;
+        double threshold = (double)section.comparison_value;
+        condition_met = (new_num < threshold);
+    }
+    else if (op == "between") {
+        // Trigger if value is between two specified values
+        double new_num = (double)new_value;
+        double min_val = (double)section.comparison_value;
+        double max_val = (double)section.comparison_value2;
+        condition_met = (new_num >= min_val && new_num <= max_val);
+    }
+    else if (op == "contains") {
+        // Trigger if string/array contains the specified value
+        String haystack = String(new_value);
+        String needle = String(section.comparison_value);
+        condition_met = haystack.contains(needle);
+    }
+        
+    // Update last value for future comparisons (also when the condition
+    // wasn't met or the trigger is debounced, for "changes" tracking)
+    section.last_value = new_value;
+    if (!condition_met) {
+        return;
+    }
+
+    // Check debounce timing
+    uint64_t current_time = Time::get_singleton()->get_ticks_msec();
+    if (section.debounce_ms > 0 && (current_time - section.last_trigger_time) < section.debounce_ms) {
+        return;
+    }
+    section.last_trigger_time = current_time;
+            
+    // Call all callback procedures. The section may move while they run.
+    Vector<String> callbacks = section.callback_procedures;
+    Array empty_args;
+    for (int j = 0; j < callbacks.size(); j++) {
+        bool found = false;
+        call_internal(callbacks[j], empty_args, found);
+                
+        if (!found) {
+            UtilityFunctions::print("Warning: Whenever callback procedure '", callbacks[j], "' not found");
         }
+    }
+}
+
+void VisualGasicInstance::fire_whenever_expression_section(int p_index) {
+    WheneverSection& section = whenever_sections.write[p_index];
+    if (!section.is_active) {
+        return;
+    }
         
-        // Evaluate the complex expression
-        Variant result = evaluate_expression(section.condition_expression);
-        bool condition_met = (bool)result;
+    // Check debounce timing
+    uint64_t current_time = Time::get_singleton()->get_ticks_msec();
+    if (section.debounce_ms > 0 && (current_time - section.last_trigger_time) < section.debounce_ms) {
+        return;
+    }
         
-        if (condition_met) {
-            // Update last trigger time
-            section.last_trigger_time = current_time;
+    // Evaluate the complex expression
+    Variant result = evaluate_expression(section.condition_expression);
+    if (!(bool)result) {
+        return;
+    }
+
+    // Evaluating may have run code that added sections.
+    WheneverSection& fired = whenever_sections.write[p_index];
+    fired.last_trigger_time = current_time;
             
-            // Call all callback procedures
-            Array empty_args;
-            for (int j = 0; j < section.callback_procedures.size(); j++) {
-                bool found = false;
-                call_internal(section.callback_procedures[j], empty_args, found);
+    // Call all callback procedures
+    Vector<String> callbacks = fired.callback_procedures;
+    Array empty_args;
+    for (int j = 0; j < callbacks.size(); j++) {
+        bool found = false;
+        call_internal(callbacks[j], empty_args, found);
                 
-                if (!found) {
-                    UtilityFunctions::print("Warning: Whenever callback procedure '", section.callback_procedures[j], "' not found");
-                }
-            }
+        if (!found) {
+            UtilityFunctions::print("Warning: Whenever callback procedure '", callbacks[j], "' not found");
         }
     }
 }
@@ -5826,6 +5636,7 @@ String VisualGasicInstance::get_whenever_status() const {
 
 void VisualGasicInstance::clear_whenever_sections() {
     whenever_sections.clear();
+    rebuild_whenever_index();
 }
 
 int VisualGasicInstance::get_active_whenever_count() const {
@@ -5837,12 +5648,17 @@ int VisualGasicInstance::get_active_whenever_count() const {
 }
 
 void VisualGasicInstance::cleanup_scoped_whenever(const String& scope_type, const String& scope_context) {
+    bool removed = false;
     for (int i = whenever_sections.size() - 1; i >= 0; i--) {
         const WheneverSection& section = whenever_sections[i];
         if (section.scope_type == scope_type && section.scope_context == scope_context) {
             whenever_sections.remove_at(i);
+            removed = true;
         }
     }
+    if (removed) {
+        rebuild_whenever_index();
+    }
 }
 
 void VisualGasicInstance::enter_scope(const String& scope_name) {
@@ -5860,12 +5676,36 @@ void VisualGasicInstance::exit_scope(const String& scope_name) {
 
 void VisualGasicInstance::assign_to_target(ExpressionNode* target, Variant val) {
     if (target->type == ExpressionNode::VARIABLE) {
-         String name = ((VariableNode*)target)->name;
-         assign_variable(name, val);
+         VariableNode* var = (VariableNode*)target;
+         if (var->binding.kind == BIND_MEMBER && current_object) {
+             current_object->fields.write[var->binding.index] = val;
+             return;
+         }
+         int slot = var->binding.slot >= 0 ? bound_slot(var->binding.slot) : -1;
+         if (slot >= 0) {
+             assign_variable_slot(slot, var->name, val);
+         } else {
+             assign_variable(var->name, val, &var->slot_hint);
+         }
     } 
     else if (target->type == ExpressionNode::MEMBER_ACCESS) {
          MemberAccessNode* ma = (MemberAccessNode*)target;
-         Variant base = evaluate_expression(ma->base_object);
+         VisualGasicObject *object = ma->base_object->type == ExpressionNode::ME ? current_object : nullptr;
+         Variant base;
+         if (!object) {
+             base = evaluate_expression(ma->base_object);
+             object = as_class_object(base);
+         }
+         if (object) {
+             const ClassDefinition *cls = object->definition;
+             int field = lookup_class_site(ma->class_cache, cls, cls->member_index, ma->member_name);
+             if (field >= 0) {
+                 object->fields.write[field] = val;
+             } else {
+                 raise_error("Class " + object->class_name + " has no field " + ma->member_name);
+             }
+             return;
+         }
          
          // UtilityFunctions::print("Assignment to Member: ", ma->member_name, " Base Type: ", base.get_type());
 
@@ -5996,6 +5836,7 @@ void VisualGasicInstance::assign_to_target(ExpressionNode* target, Variant val)
              if (aa->indices.size() > 0) {
                  Dictionary d = base;
                  Variant key = evaluate_expression(aa->indices[0]);
+                 journal_record_element(base, key);
                  d[key] = val; // Dictionary copy? Or ref? 
                  // Dictionaries are passed by reference in Godot 4 usually, but Variant operator= might copy?
                  // Wait, Dictionary IS ref counted.
@@ -6027,6 +5868,7 @@ void VisualGasicInstance::assign_to_target(ExpressionNode* target, Variant val)
               Array arr = container;
               int idx = evaluate_expression(aa->indices[aa->indices.size()-1]);
               if (idx >= 0 && idx < arr.size()) {
+                  journal_record_element(container, idx);
                   arr[idx] = val;
               } else {
                   raise_error("Array subscript out of range");
@@ -6052,6 +5894,7 @@ void VisualGasicInstance::assign_to_target(ExpressionNode* target, Variant val)
              }
              Dictionary dict = container;
              Variant key = evaluate_expression(call->arguments[0]);
+             journal_record_element(container, key);
              dict[key] = val;
              assign_variable(name, dict);
              return;
@@ -6092,6 +5935,7 @@ void VisualGasicInstance::assign_to_target(ExpressionNode* target, Variant val)
                  raise_error("Array subscript out of range");
                  return;
              }
+             journal_record_element(current, last_idx);
              arr[last_idx] = val;
              assign_variable(name, container);
              return;
@@ -6106,12 +5950,22 @@ void VisualGasicInstance::assign_to_target(ExpressionNode* target, Variant val)
 }
 
 bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition* func, Variant &r_ret) {
+    // Profiling hooks live in their own instantiation so the default path
+    // carries no per-push/pop or per-opcode profiling branches.
+    if (vg_opcode_profile_enabled() || vg_stack_profile_enabled()) {
+        return execute_bytecode_impl<true>(chunk, func, r_ret);
+    }
+    return execute_bytecode_impl<false>(chunk, func, r_ret);
+}
+
+template <bool Profiled>
+bool VisualGasicInstance::execute_bytecode_impl(BytecodeChunk* chunk, SubDefinition* func, Variant &r_ret) {
     if (!chunk) {
         r_ret = Variant();
         return false;
     }
 
-    const bool profiling_enabled = vg_opcode_profile_enabled();
+    const bool profiling_enabled = Profiled && vg_opcode_profile_enabled();
     const bool is_outermost_profile = profiling_enabled && vg_opcode_profile_depth == 0;
     if (profiling_enabled) {
         if (is_outermost_profile) {
@@ -6120,8 +5974,8 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
         vg_opcode_profile_depth++;
     }
 
-    const bool stack_profile_enabled = vg_stack_profile_enabled();
-    const bool stack_trace_enabled = []() {
+    const bool stack_profile_enabled = Profiled && vg_stack_profile_enabled();
+    const bool stack_trace_enabled = stack_profile_enabled && []() {
         const char *trace_env = std::getenv("VG_STACK_TRACE");
         return trace_env && trace_env[0] != '\0' && trace_env[0] != '0';
     }();
@@ -6142,7 +5996,7 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
         }
     }
 
-    const size_t stack_base = vm.stack.size();
+    size_t stack_base = vm.stack.size();
     int previous_ip = vm.ip;
     vm.stack.resize(stack_base);
     vm.ip = 0;
@@ -6152,47 +6006,93 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
         vm.ip = previous_ip;
     };
 
-    Vector<Variant> locals;
-    locals.resize(chunk->local_count);
-    for (int i = 0; i < chunk->local_count; i++) {
-        Variant initial;
-        if (i < chunk->local_names.size()) {
-            const String &name = chunk->local_names[i];
-            if (!name.is_empty() && variables.has(name)) {
-                initial = variables[name];
+    // Locals that name a global mirror its slot so Sub bodies that fall back
+    // to the AST walker (or name-based calls) observe the same values.
+    // Frame-only locals (parameters, the Function result, Dim'd names) live in
+    // the frame alone; the outermost frame seeds them from the globals that
+    // call_internal bound.
+    // Register-tier slots (chunk->local_regs) hold their value unboxed in
+    // `regs`; the Variant in `locals` is unused for them and read_local /
+    // sync_local box and coerce at the boundary.
+    std::vector<Variant> locals;
+    std::vector<VMRegister> regs;
+    std::vector<int> local_global_slots;
+    auto enter_chunk_locals = [&](BytecodeChunk *p_chunk, bool p_seed_frame_locals) {
+        if (p_chunk->local_slot_hints.size() != p_chunk->local_count) {
+            p_chunk->local_slot_hints.resize(p_chunk->local_count);
+            p_chunk->local_slot_hints.fill(SlotHint());
+        }
+        if (p_chunk->constant_slot_hints.size() != p_chunk->constants.size()) {
+            p_chunk->constant_slot_hints.resize(p_chunk->constants.size());
+            p_chunk->constant_slot_hints.fill(SlotHint());
+        }
+        if (p_chunk->constant_builtin_ids.size() != p_chunk->constants.size()) {
+            p_chunk->constant_builtin_ids.resize(p_chunk->constants.size());
+            p_chunk->constant_builtin_ids.fill(VisualGasicBuiltins::BUILTIN_UNRESOLVED);
+        }
+        locals.clear();
+        locals.resize(p_chunk->local_count);
+        regs.assign(p_chunk->local_count, VMRegister());
+        local_global_slots.resize(p_chunk->local_count);
+        for (int i = 0; i < p_chunk->local_count; i++) {
+            bool frame_only = i < p_chunk->local_frame_only.size() && p_chunk->local_frame_only[i];
+            int global_slot = -1;
+            if (i < p_chunk->local_names.size() && (!frame_only || p_seed_frame_locals)) {
+                const String &name = p_chunk->local_names[i];
+                if (!name.is_empty()) {
+                    global_slot = variables.intern_hinted(name, p_chunk->local_slot_hints.write[i]);
+                    if (variables.is_bound(global_slot)) {
+                        locals[i] = variables.get_slot(global_slot);
+                    }
+                }
             }
+            local_global_slots[i] = frame_only ? -1 : global_slot;
         }
-        locals.write[i] = initial;
-    }
-
-    auto get_local_name = [&](int slot) -> String {
-        if (slot >= 0 && slot < chunk->local_names.size()) {
-            return chunk->local_names[slot];
+        int reg_count = MIN(p_chunk->local_regs.size(), p_chunk->local_count);
+        for (int i = 0; i < reg_count; i++) {
+            switch (p_chunk->local_regs[i]) {
+                case BytecodeChunk::REG_I64: regs[i].i = vg_register_i64(locals[i]); locals[i] = Variant(); break;
+                case BytecodeChunk::REG_F64: regs[i].f = vg_register_f64(locals[i]); locals[i] = Variant(); break;
+                default: break;
+            }
         }
-        return String();
+    };
+    enter_chunk_locals(chunk, true);
+
+    auto local_reg_kind = [&](int slot) -> uint8_t {
+        return slot < chunk->local_regs.size() ? chunk->local_regs[slot] : (uint8_t)BytecodeChunk::REG_NONE;
     };
 
     auto sync_local = [&](int slot, const Variant &value) {
-        if (slot < 0 || slot >= locals.size()) {
+        if (slot < 0 || slot >= (int)locals.size()) {
             return;
         }
-        locals.write[slot] = value;
-        String name = get_local_name(slot);
-        if (!name.is_empty()) {
-            variables[name] = value;
+        switch (local_reg_kind(slot)) {
+            case BytecodeChunk::REG_I64: regs[slot].i = vg_register_i64(value); break;
+            case BytecodeChunk::REG_F64: regs[slot].f = vg_register_f64(value); break;
+            default: locals[slot] = value; break;
+        }
+        int global_slot = local_global_slots[slot];
+        if (global_slot >= 0) {
+            journal_record_slot(global_slot);
+            variables.set_slot(global_slot, value);
         }
     };
 
     auto read_local = [&](int slot) -> Variant {
-        if (slot >= 0 && slot < locals.size()) {
-            return locals[slot];
+        if (slot >= 0 && slot < (int)locals.size()) {
+            switch (local_reg_kind(slot)) {
+                case BytecodeChunk::REG_I64: return Variant(regs[slot].i);
+                case BytecodeChunk::REG_F64: return Variant(regs[slot].f);
+                default: return locals[slot];
+            }
         }
         return Variant();
     };
 
     auto pop_value = [&]() -> Variant {
         if (vm.stack.size() <= stack_base) {
-            if (stack_profile_enabled) {
+            if (Profiled && stack_profile_enabled) {
                 stack_profile_sample.underflow_count++;
             }
             return Variant();
@@ -6200,7 +6100,7 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
         int top_idx = vm.stack.size() - 1;
         Variant v = std::move(vm.stack[top_idx]);
         vm.stack.pop_back();
-        if (stack_profile_enabled) {
+        if (Profiled && stack_profile_enabled) {
             stack_profile_sample.pop_count++;
         }
         return v;
@@ -6211,7 +6111,7 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
 
     auto push_value = [&](auto &&value) {
         vm.stack.push_back(std::forward<decltype(value)>(value));
-        if (stack_profile_enabled) {
+        if (Profiled && stack_profile_enabled) {
             stack_profile_sample.push_count++;
             uint64_t depth = (uint64_t)(vm.stack.size() - stack_base);
             if (depth > stack_profile_sample.max_depth) {
@@ -6275,7 +6175,7 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
 
     auto ensure_stack = [&](int count) -> bool {
         if ((int)(vm.stack.size() - stack_base) < count) {
-            if (stack_profile_enabled) {
+            if (Profiled && stack_profile_enabled) {
                 stack_profile_sample.underflow_count++;
             }
             UtilityFunctions::printerr("VisualGasic: bytecode stack underflow");
@@ -6321,9 +6221,28 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
         return true;
     };
 
-    const Vector<uint8_t> &code = chunk->code;
-    const int code_size = code.size();
+    // Rebound whenever OP_CALL_USER enters or leaves a frame.
+    const uint8_t *code = chunk->code.ptr();
+    int code_size = chunk->code.size();
     bool success = true;
+
+    // High bits set by an OP_WIDE prefix, consumed by the next instruction's
+    // first operand (see VG_BYTECODE_FORMAT_VERSION).
+    uint32_t wide_operand = 0;
+    auto wide_index = [&](uint8_t low) -> int {
+        int value = (int)((wide_operand << 8) | low);
+        wide_operand = 0;
+        return value;
+    };
+
+    if (chunk->format_version != VG_BYTECODE_FORMAT_VERSION) {
+        UtilityFunctions::printerr("VisualGasic: bytecode format ", (int64_t)chunk->format_version,
+            " does not match runtime format ", (int64_t)VG_BYTECODE_FORMAT_VERSION);
+        restore_vm();
+        finalize_profile();
+        r_ret = Variant();
+        return false;
+    }
     Variant result_snapshot;
     Variant explicit_return;
     bool has_explicit_return = false;
@@ -6335,6 +6254,16 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
         return Variant();
     };
 
+    // Slot of the global named by constant idx; interned when p_create is set.
+    auto global_slot_for_constant = [&](int idx, bool p_create) -> int {
+        if (idx < 0 || idx >= chunk->constants.size()) {
+            return -1;
+        }
+        String name = chunk->constants[idx];
+        SlotHint &hint = chunk->constant_slot_hints.write[idx];
+        return p_create ? variables.intern_hinted(name, hint) : variables.find_hinted(name, hint);
+    };
+
     struct MemberNameCacheEntry {
         enum class AccessPreference : uint8_t {
             UNKNOWN,
@@ -6383,131 +6312,301 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
         return entry.has_snake;
     };
 
-    auto resolve_class_preference = [&](MemberNameCacheEntry &entry, const StringName &class_name) -> MemberNameCacheEntry::AccessPreference* {
-        for (int i = 0; i < entry.class_preferences.size(); i++) {
-            if (entry.class_preferences[i].class_name == class_name) {
-                return &entry.class_preferences.write[i].preference;
-            }
-        }
-        MemberNameCacheEntry::ClassPreference pref;
-        pref.class_name = class_name;
-        entry.class_preferences.push_back(pref);
-        return &entry.class_preferences.write[entry.class_preferences.size() - 1].preference;
+    auto resolve_class_preference = [&](MemberNameCacheEntry &entry, const StringName &class_name) -> MemberNameCacheEntry::AccessPreference* {
+        for (int i = 0; i < entry.class_preferences.size(); i++) {
+            if (entry.class_preferences[i].class_name == class_name) {
+                return &entry.class_preferences.write[i].preference;
+            }
+        }
+        MemberNameCacheEntry::ClassPreference pref;
+        pref.class_name = class_name;
+        entry.class_preferences.push_back(pref);
+        return &entry.class_preferences.write[entry.class_preferences.size() - 1].preference;
+    };
+
+    // OP_CALL_USER runs the callee inside this loop: the caller's state is
+    // saved here and the active variables above (chunk, code, locals, ...)
+    // are rebound, so calls between compiled Subs never build an argument
+    // Array, look the callee up by name or re-enter execute_bytecode.
+    struct CallFrame {
+        BytecodeChunk *chunk = nullptr;
+        SubDefinition *func = nullptr;
+        SubDefinition *prev_sub = nullptr;
+        ErrorState prev_error;
+        int return_ip = 0;
+        size_t stack_base = 0;
+        std::vector<Variant> locals;
+        std::vector<VMRegister> regs;
+        std::vector<int> local_global_slots;
+        Vector<MemberNameCacheEntry> member_name_cache;
+        Variant explicit_return;
+        bool has_explicit_return = false;
+    };
+    std::vector<CallFrame> call_frames;
+
+    auto enter_call_frame = [&](BytecodeChunk *p_chunk, SubDefinition *p_func, int p_arg_count) {
+        CallFrame frame;
+        frame.chunk = chunk;
+        frame.func = func;
+        frame.prev_sub = current_sub;
+        frame.prev_error = error_state;
+        frame.return_ip = vm.ip;
+        frame.stack_base = stack_base;
+        frame.locals = std::move(locals);
+        frame.regs = std::move(regs);
+        frame.local_global_slots = std::move(local_global_slots);
+        frame.member_name_cache = member_name_cache;
+        frame.explicit_return = explicit_return;
+        frame.has_explicit_return = has_explicit_return;
+        call_frames.push_back(std::move(frame));
+        vm.call_depth++;
+
+        // Arguments are the top p_arg_count stack values; bind them into
+        // parameter slots and drop them so the callee's stack starts there.
+        size_t args_base = vm.stack.size() - p_arg_count;
+        chunk = p_chunk;
+        func = p_func;
+        enter_chunk_locals(chunk, false);
+        for (int i = 0; i < chunk->param_count && i < (int)locals.size(); i++) {
+            Variant val;
+            if (i < p_arg_count) {
+                val = std::move(vm.stack[args_base + i]);
+                switch (chunk->param_kinds[i]) {
+                    case BytecodeChunk::PARAM_INT: val = (int64_t)val; break;
+                    case BytecodeChunk::PARAM_FLOAT: val = (double)val; break;
+                    case BytecodeChunk::PARAM_STRING: val = (String)val; break;
+                    case BytecodeChunk::PARAM_BOOL: val = (bool)val; break;
+                    default: break;
+                }
+            } else {
+                val = p_func->parameters[i].default_value;
+            }
+            sync_local(i, val);
+        }
+        vm.stack.resize(args_base);
+        stack_base = args_base;
+
+        member_name_cache.clear();
+        member_name_cache.resize(chunk->constants.size());
+        explicit_return = Variant();
+        has_explicit_return = false;
+        code = chunk->code.ptr();
+        code_size = chunk->code.size();
+        vm.ip = 0;
+
+        current_sub = p_func;
+        error_state.mode = ErrorState::NONE;
+        error_state.has_error = false;
+        error_state.label = "";
+        journal_begin();
+    };
+
+    auto leave_call_frame = [&]() {
+        Variant ret;
+        if (has_explicit_return) {
+            ret = explicit_return;
+        } else if (chunk->return_slot >= 0) {
+            ret = read_local(chunk->return_slot);
+        }
+        journal_commit();
+        vm.call_depth--;
+        vm.stack.resize(stack_base);
+
+        CallFrame &frame = call_frames.back();
+        chunk = frame.chunk;
+        func = frame.func;
+        current_sub = frame.prev_sub;
+        error_state = frame.prev_error;
+        stack_base = frame.stack_base;
+        locals = std::move(frame.locals);
+        regs = std::move(frame.regs);
+        local_global_slots = std::move(frame.local_global_slots);
+        member_name_cache = frame.member_name_cache;
+        explicit_return = frame.explicit_return;
+        has_explicit_return = frame.has_explicit_return;
+        code = chunk->code.ptr();
+        code_size = chunk->code.size();
+        vm.ip = frame.return_ip;
+        call_frames.pop_back();
+
+        push_value(ret);
+    };
+
+#if VG_THREADED_DISPATCH
+    // Indexed by OpCode, in enum order; opcodes without a handler share the
+    // default label.
+    static const void *const vm_dispatch_table[] = {
+        &&vm_op_OP_CONSTANT, &&vm_op_OP_CONSTANT_LONG, &&vm_op_OP_POP, &&vm_op_OP_GET_GLOBAL,
+        &&vm_op_OP_SET_GLOBAL, &&vm_op_OP_GET_LOCAL, &&vm_op_OP_SET_LOCAL, &&vm_op_OP_ADD,
+        &&vm_op_OP_SUBTRACT, &&vm_op_OP_MULTIPLY, &&vm_op_OP_DIVIDE, &&vm_op_OP_NEGATE,
+        &&vm_op_OP_CONCAT, &&vm_op_OP_ADD_I64, &&vm_op_OP_ADD_I64_CONST, &&vm_op_OP_SUB_I64,
+        &&vm_op_OP_SUB_I64_CONST, &&vm_op_OP_MUL_I64, &&vm_op_OP_MUL_I64_CONST, &&vm_op_OP_ADD_F64,
+        &&vm_op_OP_SUB_F64, &&vm_op_OP_MUL_F64, &&vm_op_OP_DIV_F64, &&vm_op_OP_ACCUM_I64_MULADD_CONST,
+        &&vm_op_OP_ADD_LOCAL_I64_STACK, &&vm_op_OP_SUB_LOCAL_I64_STACK,
+        &&vm_op_OP_ADD_LOCAL_I64_CONST, &&vm_op_OP_SUB_LOCAL_I64_CONST, &&vm_op_OP_INC_LOCAL_I64,
+        &&vm_op_OP_ARITH_SUM, &&vm_op_OP_BRANCH_SUM, &&vm_op_OP_SUM_ARRAY_I64,
+        &&vm_op_OP_SUM_DICT_I64, &&vm_op_OP_ARRAY_FILL_I64_SEQ, &&vm_op_OP_ALLOC_FILL_I64,
+        &&vm_op_default, &&vm_op_OP_ALLOC_FILL_REPEAT_I64, &&vm_op_OP_STRING_REPEAT,
+        &&vm_op_OP_STRING_REPEAT_OUTER, &&vm_op_OP_ABS, &&vm_op_OP_SGN, &&vm_op_OP_LEN,
+        &&vm_op_OP_EQUAL, &&vm_op_OP_NOT_EQUAL, &&vm_op_OP_GREATER, &&vm_op_OP_LESS,
+        &&vm_op_OP_GREATER_EQUAL, &&vm_op_OP_LESS_EQUAL, &&vm_op_OP_EQUAL_I64,
+        &&vm_op_OP_NOT_EQUAL_I64, &&vm_op_OP_LESS_EQUAL_I64, &&vm_op_OP_NOT, &&vm_op_OP_AND,
+        &&vm_op_OP_OR, &&vm_op_OP_XOR, &&vm_op_OP_JUMP, &&vm_op_OP_JUMP_IF_FALSE, &&vm_op_OP_LOOP,
+        &&vm_op_OP_CALL, &&vm_op_OP_CALL_BUILTIN, &&vm_op_OP_RETURN, &&vm_op_OP_RETURN_VALUE,
+        &&vm_op_OP_PRINT, &&vm_op_OP_NEW_ARRAY, &&vm_op_OP_NEW_ARRAY_I64, &&vm_op_OP_NEW_DICT,
+        &&vm_op_OP_GET_ARRAY, &&vm_op_OP_SET_ARRAY, &&vm_op_OP_GET_ARRAY_UNCHECKED,
+        &&vm_op_OP_SET_ARRAY_UNCHECKED, &&vm_op_OP_GET_ARRAY_FAST, &&vm_op_OP_SET_ARRAY_FAST,
+        &&vm_op_OP_GET_ARRAY_FAST_UNCHECKED, &&vm_op_OP_SET_ARRAY_FAST_UNCHECKED,
+        &&vm_op_OP_GET_DICT_FAST, &&vm_op_OP_SET_DICT_FAST, &&vm_op_OP_GET_DICT_TRUSTED,
+        &&vm_op_OP_SET_DICT_TRUSTED, &&vm_op_OP_SET_DICT_LOCAL, &&vm_op_OP_SET_DICT_GLOBAL,
+        &&vm_op_OP_DICT_HAS_KEY, &&vm_op_OP_DICT_SIZE, &&vm_op_OP_DICT_CLEAR_INPLACE,
+        &&vm_op_OP_DICT_KEYS, &&vm_op_OP_DICT_VALUES, &&vm_op_OP_DICT_ERASE, &&vm_op_default,
+        &&vm_op_OP_GET_MEMBER, &&vm_op_OP_SET_MEMBER, &&vm_op_OP_INTEROP_SET_NAME_LEN,
+        &&vm_op_OP_NIL, &&vm_op_OP_TRUE, &&vm_op_OP_FALSE, &&vm_op_OP_CALL_USER, &&vm_op_OP_WIDE,
+        &&vm_op_OP_R_LOADK_I64, &&vm_op_OP_R_LOADK_F64, &&vm_op_OP_R_MOV, &&vm_op_OP_R_I64_TO_F64,
+        &&vm_op_OP_R_ADD_I64, &&vm_op_OP_R_SUB_I64, &&vm_op_OP_R_MUL_I64, &&vm_op_OP_R_ADDK_I64,
+        &&vm_op_OP_R_SUBK_I64, &&vm_op_OP_R_MULK_I64, &&vm_op_OP_R_ADD_F64, &&vm_op_OP_R_SUB_F64,
+        &&vm_op_OP_R_MUL_F64, &&vm_op_OP_R_DIV_F64, &&vm_op_OP_R_INC_I64,
+        &&vm_op_OP_R_JUMP_IF_NOT_I64, &&vm_op_OP_R_JUMP_IF_NOT_I64K, &&vm_op_OP_R_GET_ARRAY_I64,
+        &&vm_op_OP_R_GET_ARRAY_F64, &&vm_op_OP_R_GET_ARRAY_I64_GUARDED, &&vm_op_OP_R_GET_ARRAY_F64_GUARDED,
+        &&vm_op_OP_R_GUARD_ARRAY
     };
+    constexpr int vm_dispatch_count = (int)(sizeof(vm_dispatch_table) / sizeof(vm_dispatch_table[0]));
+    static_assert(vm_dispatch_count == OP_R_GUARD_ARRAY + 1, "vm_dispatch_table must list every OpCode");
+#endif
 
-    while (vm.ip < code_size) {
+    for (;;) {
+#if VG_THREADED_DISPATCH
+    vm_loop_head:
+#endif
+        if (vm.ip >= code_size) {
+            if (call_frames.empty()) {
+                break;
+            }
+            leave_call_frame();
+            continue;
+        }
         last_opcode_offset = vm.ip;
         uint8_t op = code[vm.ip++];
         current_opcode = op;
+#if VG_THREADED_DISPATCH
+        goto *(op < vm_dispatch_count ? vm_dispatch_table[op] : &&vm_op_default);
+#endif
         switch (op) {
-            case OP_CONSTANT: {
+            VM_CASE(OP_CONSTANT): do {
                 if (vm.ip >= code_size) {
                     success = false;
                     goto cleanup;
                 }
-                uint8_t idx = code[vm.ip++];
+                int idx = wide_index(code[vm.ip++]);
                 push_value(read_constant(idx));
-                break;
-            }
-            case OP_CONSTANT_LONG: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_CONSTANT_LONG): do {
                 if (vm.ip + 1 >= code_size) {
                     success = false;
                     goto cleanup;
                 }
-                uint8_t lo = code[vm.ip++];
                 uint8_t hi = code[vm.ip++];
+                uint8_t lo = code[vm.ip++];
                 int idx = (hi << 8) | lo;
                 push_value(read_constant(idx));
-                break;
-            }
-            case OP_POP: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_POP): do {
                 if (vm.stack.size() > stack_base) {
                     vm.stack.pop_back();
                 }
-                break;
-            }
-            case OP_GET_GLOBAL: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_GET_GLOBAL): do {
                 if (vm.ip >= code_size) {
                     success = false;
                     goto cleanup;
                 }
-                uint8_t idx = code[vm.ip++];
-                Variant name_var = read_constant(idx);
-                String name = name_var;
-                Variant val = variables.get(name, Variant());
-                push_value(val);
-                break;
-            }
-            case OP_SET_GLOBAL: {
+                int idx = wide_index(code[vm.ip++]);
+                int global_slot = global_slot_for_constant(idx, false);
+                if (global_slot >= 0 && variables.is_bound(global_slot)) {
+                    push_value(variables.get_slot(global_slot));
+                } else {
+                    push_value(Variant());
+                }
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_SET_GLOBAL): do {
                 if (vm.ip >= code_size) {
                     success = false;
                     goto cleanup;
                 }
-                uint8_t idx = code[vm.ip++];
-                Variant name_var = read_constant(idx);
-                String name = name_var;
+                int idx = wide_index(code[vm.ip++]);
                 if (!ensure_stack(1)) {
                     success = false;
                     goto cleanup;
                 }
                 Variant value = pop_value();
-                variables[name] = value;
-                break;
-            }
-            case OP_GET_LOCAL: {
+                int global_slot = global_slot_for_constant(idx, true);
+                if (global_slot < 0) {
+                    success = false;
+                    goto cleanup;
+                }
+                journal_record_slot(global_slot);
+                variables.set_slot(global_slot, value);
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_GET_LOCAL): do {
                 if (vm.ip >= code_size) {
                     success = false;
                     goto cleanup;
                 }
-                uint8_t slot = code[vm.ip++];
+                int slot = wide_index(code[vm.ip++]);
                 push_value(read_local(slot));
-                break;
-            }
-            case OP_SET_LOCAL: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_SET_LOCAL): do {
                 if (vm.ip >= code_size) {
                     success = false;
                     goto cleanup;
                 }
-                uint8_t slot = code[vm.ip++];
+                int slot = wide_index(code[vm.ip++]);
                 if (!ensure_stack(1)) {
                     success = false;
                     goto cleanup;
                 }
                 Variant value = pop_value();
                 sync_local(slot, value);
-                break;
-            }
-            case OP_ADD:
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_ADD):
                 if (!apply_variant_op(Variant::OP_ADD)) {
                     success = false;
                     goto cleanup;
                 }
-                break;
-            case OP_SUBTRACT:
+                DISPATCH();
+            VM_CASE(OP_SUBTRACT):
                 if (!apply_variant_op(Variant::OP_SUBTRACT)) {
                     success = false;
                     goto cleanup;
                 }
-                break;
-            case OP_MULTIPLY:
+                DISPATCH();
+            VM_CASE(OP_MULTIPLY):
                 if (!apply_variant_op(Variant::OP_MULTIPLY)) {
                     success = false;
                     goto cleanup;
                 }
-                break;
-            case OP_DIVIDE:
+                DISPATCH();
+            VM_CASE(OP_DIVIDE):
                 if (!apply_variant_op(Variant::OP_DIVIDE)) {
                     success = false;
                     goto cleanup;
                 }
-                break;
-            case OP_NEGATE:
+                DISPATCH();
+            VM_CASE(OP_NEGATE):
                 if (!apply_variant_op(Variant::OP_NEGATE)) {
                     success = false;
                     goto cleanup;
                 }
-                break;
-            case OP_CONCAT: {
+                DISPATCH();
+            VM_CASE(OP_CONCAT): do {
                 if (!ensure_stack(2)) {
                     success = false;
                     goto cleanup;
@@ -6520,9 +6619,9 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                 } else {
                     push_value(Variant(String(a) + String(b)));
                 }
-                break;
-            }
-            case OP_STRING_REPEAT: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_STRING_REPEAT): do {
                 if (!ensure_stack(2)) {
                     success = false;
                     goto cleanup;
@@ -6530,9 +6629,9 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                 String literal = String(pop_value());
                 int64_t count = to_int(pop_value());
                 push_value(vg_repeat_literal(literal, count));
-                break;
-            }
-            case OP_STRING_REPEAT_OUTER: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_STRING_REPEAT_OUTER): do {
                 if (vm.ip + 1 >= code_size) { success = false; goto cleanup; }
                 uint8_t slot = code[vm.ip++];
                 uint8_t lit_idx = code[vm.ip++];
@@ -6555,9 +6654,9 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                     result = vg_repeat_literal(literal, inner_count);
                 }
                 sync_local(slot, result);
-                break;
-            }
-            case OP_INTEROP_SET_NAME_LEN: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_INTEROP_SET_NAME_LEN): do {
                 if (vm.ip + 1 >= code_size) { success = false; goto cleanup; }
                 uint8_t sum_slot = code[vm.ip++];
                 uint8_t lit_idx = code[vm.ip++];
@@ -6573,9 +6672,9 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                     current_sum += delta;
                 }
                 push_value(current_sum);
-                break;
-            }
-            case OP_ADD_I64: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_ADD_I64): do {
                 if (!ensure_stack(2)) {
                     success = false;
                     goto cleanup;
@@ -6583,9 +6682,9 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                 int64_t b = to_int(pop_value());
                 int64_t a = to_int(pop_value());
                 push_value((int64_t)(a + b));
-                break;
-            }
-            case OP_SUB_I64: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_SUB_I64): do {
                 if (!ensure_stack(2)) {
                     success = false;
                     goto cleanup;
@@ -6593,9 +6692,9 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                 int64_t b = to_int(pop_value());
                 int64_t a = to_int(pop_value());
                 push_value((int64_t)(a - b));
-                break;
-            }
-            case OP_MUL_I64: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_MUL_I64): do {
                 if (!ensure_stack(2)) {
                     success = false;
                     goto cleanup;
@@ -6603,9 +6702,9 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                 int64_t b = to_int(pop_value());
                 int64_t a = to_int(pop_value());
                 push_value((int64_t)(a * b));
-                break;
-            }
-            case OP_ADD_F64: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_ADD_F64): do {
                 if (!ensure_stack(2)) {
                     success = false;
                     goto cleanup;
@@ -6613,9 +6712,9 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                 double b = to_double(pop_value());
                 double a = to_double(pop_value());
                 push_value(a + b);
-                break;
-            }
-            case OP_SUB_F64: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_SUB_F64): do {
                 if (!ensure_stack(2)) {
                     success = false;
                     goto cleanup;
@@ -6623,9 +6722,9 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                 double b = to_double(pop_value());
                 double a = to_double(pop_value());
                 push_value(a - b);
-                break;
-            }
-            case OP_MUL_F64: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_MUL_F64): do {
                 if (!ensure_stack(2)) {
                     success = false;
                     goto cleanup;
@@ -6633,9 +6732,9 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                 double b = to_double(pop_value());
                 double a = to_double(pop_value());
                 push_value(a * b);
-                break;
-            }
-            case OP_DIV_F64: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_DIV_F64): do {
                 if (!ensure_stack(2)) {
                     success = false;
                     goto cleanup;
@@ -6643,80 +6742,91 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                 double b = to_double(pop_value());
                 double a = to_double(pop_value());
                 push_value(a / b);
-                break;
-            }
-            case OP_ADD_I64_CONST: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_ADD_I64_CONST): do {
                 if (vm.ip >= code_size) { success = false; goto cleanup; }
-                uint8_t idx = code[vm.ip++];
+                int idx = wide_index(code[vm.ip++]);
                 if (!ensure_stack(2)) { success = false; goto cleanup; }
                 pop_value(); // discard literal operand on stack
                 int64_t a = to_int(pop_value());
                 int64_t c = to_int(read_constant(idx));
                 push_value((int64_t)(a + c));
-                break;
-            }
-            case OP_SUB_I64_CONST: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_SUB_I64_CONST): do {
                 if (vm.ip >= code_size) { success = false; goto cleanup; }
-                uint8_t idx = code[vm.ip++];
+                int idx = wide_index(code[vm.ip++]);
                 if (!ensure_stack(2)) { success = false; goto cleanup; }
                 pop_value();
                 int64_t a = to_int(pop_value());
                 int64_t c = to_int(read_constant(idx));
                 push_value((int64_t)(a - c));
-                break;
-            }
-            case OP_MUL_I64_CONST: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_MUL_I64_CONST): do {
                 if (vm.ip >= code_size) { success = false; goto cleanup; }
-                uint8_t idx = code[vm.ip++];
+                int idx = wide_index(code[vm.ip++]);
                 if (!ensure_stack(2)) { success = false; goto cleanup; }
                 pop_value();
                 int64_t a = to_int(pop_value());
                 int64_t c = to_int(read_constant(idx));
                 push_value((int64_t)(a * c));
-                break;
-            }
-            case OP_ADD_LOCAL_I64_STACK: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_ADD_LOCAL_I64_STACK): do {
                 if (vm.ip >= code_size) { success = false; goto cleanup; }
-                uint8_t slot = code[vm.ip++];
+                int slot = wide_index(code[vm.ip++]);
                 int64_t delta = to_int(pop_value());
                 int64_t base = to_int(read_local(slot));
                 sync_local(slot, (int64_t)(base + delta));
-                break;
-            }
-            case OP_SUB_LOCAL_I64_STACK: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_SUB_LOCAL_I64_STACK): do {
                 if (vm.ip >= code_size) { success = false; goto cleanup; }
-                uint8_t slot = code[vm.ip++];
+                int slot = wide_index(code[vm.ip++]);
                 int64_t delta = to_int(pop_value());
                 int64_t base = to_int(read_local(slot));
                 sync_local(slot, (int64_t)(base - delta));
-                break;
-            }
-            case OP_ADD_LOCAL_I64_CONST: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_ADD_LOCAL_I64_CONST): do {
                 if (vm.ip >= code_size) { success = false; goto cleanup; }
                 uint8_t slot = code[vm.ip++];
                 if (vm.ip >= code_size) { success = false; goto cleanup; }
                 uint8_t idx = code[vm.ip++];
                 int64_t base = to_int(read_local(slot));
                 sync_local(slot, (int64_t)(base + to_int(read_constant(idx))));
-                break;
-            }
-            case OP_SUB_LOCAL_I64_CONST: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_SUB_LOCAL_I64_CONST): do {
                 if (vm.ip >= code_size) { success = false; goto cleanup; }
                 uint8_t slot = code[vm.ip++];
                 if (vm.ip >= code_size) { success = false; goto cleanup; }
                 uint8_t idx = code[vm.ip++];
                 int64_t base = to_int(read_local(slot));
                 sync_local(slot, (int64_t)(base - to_int(read_constant(idx))));
-                break;
-            }
-            case OP_INC_LOCAL_I64: {
-                if (vm.ip >= code_size) { success = false; goto cleanup; }
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_ACCUM_I64_MULADD_CONST): do {
+                if (vm.ip + 3 >= code_size) { success = false; goto cleanup; }
                 uint8_t slot = code[vm.ip++];
+                uint8_t j_slot = code[vm.ip++];
+                uint8_t k_idx = code[vm.ip++];
+                uint8_t c_idx = code[vm.ip++];
+                int64_t base = to_int(read_local(slot));
+                int64_t j = to_int(read_local(j_slot));
+                sync_local(slot, (int64_t)(base + j * to_int(read_constant(k_idx)) + to_int(read_constant(c_idx))));
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_INC_LOCAL_I64): do {
+                if (vm.ip >= code_size) { success = false; goto cleanup; }
+                int slot = wide_index(code[vm.ip++]);
                 int64_t base = to_int(read_local(slot));
                 sync_local(slot, (int64_t)(base + 1));
-                break;
-            }
-            case OP_ARITH_SUM: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_ARITH_SUM): do {
                 if (vm.ip >= code_size) { success = false; goto cleanup; }
                 uint8_t k_idx = code[vm.ip++];
                 if (vm.ip >= code_size) { success = false; goto cleanup; }
@@ -6740,9 +6850,9 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                     result_sum += per_inner * n_outer;
                 }
                 push_value(result_sum);
-                break;
-            }
-            case OP_BRANCH_SUM: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_BRANCH_SUM): do {
                 if (vm.ip >= code_size) { success = false; goto cleanup; }
                 uint8_t flag_slot = code[vm.ip++];
                 if (!ensure_stack(3)) { success = false; goto cleanup; }
@@ -6768,9 +6878,9 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                     sync_local(flag_slot, (int64_t)0);
                 }
                 push_value(result_sum);
-                break;
-            }
-            case OP_LEN: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_LEN): do {
                 if (!ensure_stack(1)) { success = false; goto cleanup; }
                 Variant value = pop_value();
                 int64_t length = 0;
@@ -6790,103 +6900,106 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                         break;
                 }
                 push_value(length);
-                break;
-            }
-            case OP_EQUAL:
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_EQUAL):
                 if (!apply_variant_op(Variant::OP_EQUAL)) { success = false; goto cleanup; }
-                break;
-            case OP_NOT_EQUAL:
+                DISPATCH();
+            VM_CASE(OP_NOT_EQUAL):
                 if (!apply_variant_op(Variant::OP_NOT_EQUAL)) { success = false; goto cleanup; }
-                break;
-            case OP_GREATER:
+                DISPATCH();
+            VM_CASE(OP_GREATER):
                 if (!apply_variant_op(Variant::OP_GREATER)) { success = false; goto cleanup; }
-                break;
-            case OP_LESS:
+                DISPATCH();
+            VM_CASE(OP_LESS):
                 if (!apply_variant_op(Variant::OP_LESS)) { success = false; goto cleanup; }
-                break;
-            case OP_GREATER_EQUAL:
+                DISPATCH();
+            VM_CASE(OP_GREATER_EQUAL):
                 if (!apply_variant_op(Variant::OP_GREATER_EQUAL)) { success = false; goto cleanup; }
-                break;
-            case OP_LESS_EQUAL:
+                DISPATCH();
+            VM_CASE(OP_LESS_EQUAL):
                 if (!apply_variant_op(Variant::OP_LESS_EQUAL)) { success = false; goto cleanup; }
-                break;
-            case OP_EQUAL_I64: {
+                DISPATCH();
+            VM_CASE(OP_EQUAL_I64): do {
                 if (!ensure_stack(2)) { success = false; goto cleanup; }
                 int64_t b = to_int(pop_value());
                 int64_t a = to_int(pop_value());
                 push_value(a == b);
-                break;
-            }
-            case OP_NOT_EQUAL_I64: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_NOT_EQUAL_I64): do {
                 if (!ensure_stack(2)) { success = false; goto cleanup; }
                 int64_t b = to_int(pop_value());
                 int64_t a = to_int(pop_value());
                 push_value(a != b);
-                break;
-            }
-            case OP_LESS_EQUAL_I64: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_LESS_EQUAL_I64): do {
                 if (!ensure_stack(2)) { success = false; goto cleanup; }
                 int64_t b = to_int(pop_value());
                 int64_t a = to_int(pop_value());
                 push_value(a <= b);
-                break;
-            }
-            case OP_NOT: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_NOT): do {
                 if (!ensure_stack(1)) { success = false; goto cleanup; }
                 push_value(!to_bool(pop_value()));
-                break;
-            }
-            case OP_AND: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_AND): do {
                 if (!ensure_stack(2)) { success = false; goto cleanup; }
                 bool b = to_bool(pop_value());
                 bool a = to_bool(pop_value());
                 push_value(a && b);
-                break;
-            }
-            case OP_OR: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_OR): do {
                 if (!ensure_stack(2)) { success = false; goto cleanup; }
                 bool b = to_bool(pop_value());
                 bool a = to_bool(pop_value());
                 push_value(a || b);
-                break;
-            }
-            case OP_XOR: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_XOR): do {
                 if (!ensure_stack(2)) { success = false; goto cleanup; }
                 bool b = to_bool(pop_value());
                 bool a = to_bool(pop_value());
                 push_value((a && !b) || (!a && b));
-                break;
-            }
-            case OP_JUMP: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_JUMP): do {
                 if (vm.ip + 1 >= code_size) { success = false; goto cleanup; }
                 uint8_t hi = code[vm.ip++];
                 uint8_t lo = code[vm.ip++];
-                int offset = (hi << 8) | lo;
+                int offset = (int)((wide_operand << 16) | (uint32_t)(hi << 8) | lo);
+                wide_operand = 0;
                 vm.ip += offset;
-                break;
-            }
-            case OP_JUMP_IF_FALSE: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_JUMP_IF_FALSE): do {
                 if (vm.ip + 1 >= code_size) { success = false; goto cleanup; }
                 uint8_t hi = code[vm.ip++];
                 uint8_t lo = code[vm.ip++];
-                int offset = (hi << 8) | lo;
+                int offset = (int)((wide_operand << 16) | (uint32_t)(hi << 8) | lo);
+                wide_operand = 0;
                 bool condition = to_bool(pop_value());
                 if (!condition) {
                     vm.ip += offset;
                 }
-                break;
-            }
-            case OP_LOOP: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_LOOP): do {
                 if (vm.ip + 1 >= code_size) { success = false; goto cleanup; }
                 uint8_t hi = code[vm.ip++];
                 uint8_t lo = code[vm.ip++];
-                int offset = (hi << 8) | lo;
+                int offset = (int)((wide_operand << 16) | (uint32_t)(hi << 8) | lo);
+                wide_operand = 0;
                 vm.ip -= offset;
-                break;
-            }
-            case OP_CALL: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_CALL): do {
                 if (vm.ip >= code_size) { success = false; goto cleanup; }
-                uint8_t name_idx = code[vm.ip++];
+                int name_idx = wide_index(code[vm.ip++]);
                 if (vm.ip >= code_size) { success = false; goto cleanup; }
                 uint8_t arg_count = code[vm.ip++];
                 if (!ensure_stack(arg_count)) { success = false; goto cleanup; }
@@ -6895,10 +7008,17 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                 for (int i = arg_count - 1; i >= 0; i--) {
                     args[i] = pop_value();
                 }
-                String method = read_constant(name_idx);
                 bool handled = false;
-                Variant call_ret = VisualGasicBuiltins::call_builtin_expr_evaluated(this, method, args, handled);
+                Variant call_ret;
+                if (name_idx < chunk->constant_builtin_ids.size()) {
+                    int &builtin_id = chunk->constant_builtin_ids.write[name_idx];
+                    if (builtin_id == VisualGasicBuiltins::BUILTIN_UNRESOLVED) {
+                        builtin_id = VisualGasicBuiltins::find_expr_builtin_id(read_constant(name_idx));
+                    }
+                    call_ret = VisualGasicBuiltins::call_builtin_expr_by_id(this, builtin_id, args, handled);
+                }
                 if (!handled) {
+                    String method = read_constant(name_idx);
                     bool found = false;
                     call_ret = call_internal(method, args, found);
                     if (!found) {
@@ -6908,20 +7028,254 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                     }
                 }
                 push_value(call_ret);
-                break;
-            }
-            case OP_RETURN: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_WIDE): do {
+                if (vm.ip + 1 >= code_size) { success = false; goto cleanup; }
+                wide_operand = ((uint32_t)code[vm.ip] << 8) | code[vm.ip + 1];
+                vm.ip += 2;
+            } while (0);
+            DISPATCH();
+            // Register tier. Operands index `regs` directly; the compiler
+            // only targets slots it marked in chunk->local_regs.
+            VM_CASE(OP_R_LOADK_I64):
+            VM_CASE(OP_R_LOADK_F64): do {
+                if (vm.ip + 1 >= code_size) { success = false; goto cleanup; }
+                uint8_t dst = code[vm.ip++];
+                uint8_t k = code[vm.ip++];
+                if (dst >= regs.size() || k >= chunk->constants.size()) { success = false; goto cleanup; }
+                if (op == OP_R_LOADK_I64) {
+                    regs[dst].i = to_int(chunk->constants[k]);
+                } else {
+                    regs[dst].f = to_double(chunk->constants[k]);
+                }
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_R_MOV): do {
+                if (vm.ip + 1 >= code_size) { success = false; goto cleanup; }
+                uint8_t dst = code[vm.ip++];
+                uint8_t src = code[vm.ip++];
+                if (dst >= regs.size() || src >= regs.size()) { success = false; goto cleanup; }
+                regs[dst] = regs[src];
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_R_I64_TO_F64): do {
+                if (vm.ip + 1 >= code_size) { success = false; goto cleanup; }
+                uint8_t dst = code[vm.ip++];
+                uint8_t src = code[vm.ip++];
+                if (dst >= regs.size() || src >= regs.size()) { success = false; goto cleanup; }
+                regs[dst].f = (double)regs[src].i;
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_R_ADD_I64):
+            VM_CASE(OP_R_SUB_I64):
+            VM_CASE(OP_R_MUL_I64): do {
+                if (vm.ip + 2 >= code_size) { success = false; goto cleanup; }
+                uint8_t dst = code[vm.ip++];
+                uint8_t a = code[vm.ip++];
+                uint8_t b = code[vm.ip++];
+                if (dst >= regs.size() || a >= regs.size() || b >= regs.size()) { success = false; goto cleanup; }
+                int64_t x = regs[a].i;
+                int64_t y = regs[b].i;
+                regs[dst].i = op == OP_R_ADD_I64 ? x + y : (op == OP_R_SUB_I64 ? x - y : x * y);
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_R_ADDK_I64):
+            VM_CASE(OP_R_SUBK_I64):
+            VM_CASE(OP_R_MULK_I64): do {
+                if (vm.ip + 2 >= code_size) { success = false; goto cleanup; }
+                uint8_t dst = code[vm.ip++];
+                uint8_t a = code[vm.ip++];
+                uint8_t k = code[vm.ip++];
+                if (dst >= regs.size() || a >= regs.size() || k >= chunk->constants.size()) { success = false; goto cleanup; }
+                int64_t x = regs[a].i;
+                int64_t y = to_int(chunk->constants[k]);
+                regs[dst].i = op == OP_R_ADDK_I64 ? x + y : (op == OP_R_SUBK_I64 ? x - y : x * y);
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_R_ADD_F64):
+            VM_CASE(OP_R_SUB_F64):
+            VM_CASE(OP_R_MUL_F64):
+            VM_CASE(OP_R_DIV_F64): do {
+                if (vm.ip + 2 >= code_size) { success = false; goto cleanup; }
+                uint8_t dst = code[vm.ip++];
+                uint8_t a = code[vm.ip++];
+                uint8_t b = code[vm.ip++];
+                if (dst >= regs.size() || a >= regs.size() || b >= regs.size()) { success = false; goto cleanup; }
+                double x = regs[a].f;
+                double y = regs[b].f;
+                switch (op) {
+                    case OP_R_ADD_F64: regs[dst].f = x + y; break;
+                    case OP_R_SUB_F64: regs[dst].f = x - y; break;
+                    case OP_R_MUL_F64: regs[dst].f = x * y; break;
+                    default: regs[dst].f = x / y; break;
+                }
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_R_INC_I64): do {
+                if (vm.ip >= code_size) { success = false; goto cleanup; }
+                uint8_t slot = code[vm.ip++];
+                if (slot >= regs.size()) { success = false; goto cleanup; }
+                regs[slot].i++;
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_R_JUMP_IF_NOT_I64):
+            VM_CASE(OP_R_JUMP_IF_NOT_I64K): do {
+                if (vm.ip + 4 >= code_size) { success = false; goto cleanup; }
+                uint8_t cmp = code[vm.ip++];
+                uint8_t a = code[vm.ip++];
+                uint8_t b = code[vm.ip++];
+                uint8_t hi = code[vm.ip++];
+                uint8_t lo = code[vm.ip++];
+                int offset = (int)((uint32_t)(hi << 8) | lo);
+                if (a >= regs.size()) { success = false; goto cleanup; }
+                int64_t x = regs[a].i;
+                int64_t y;
+                if (op == OP_R_JUMP_IF_NOT_I64) {
+                    if (b >= regs.size()) { success = false; goto cleanup; }
+                    y = regs[b].i;
+                } else {
+                    if (b >= chunk->constants.size()) { success = false; goto cleanup; }
+                    y = to_int(chunk->constants[b]);
+                }
+                bool taken;
+                switch (cmp) {
+                    case RCMP_EQ: taken = x == y; break;
+                    case RCMP_NE: taken = x != y; break;
+                    case RCMP_LT: taken = x < y; break;
+                    case RCMP_LE: taken = x <= y; break;
+                    case RCMP_GT: taken = x > y; break;
+                    case RCMP_GE: taken = x >= y; break;
+                    default: success = false; goto cleanup;
+                }
+                if (!taken) {
+                    vm.ip += offset;
+                }
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_R_GET_ARRAY_I64):
+            VM_CASE(OP_R_GET_ARRAY_F64):
+            VM_CASE(OP_R_GET_ARRAY_I64_GUARDED):
+            VM_CASE(OP_R_GET_ARRAY_F64_GUARDED): do {
+                PROFILE_OPCODE(GetArray);
+                if (vm.ip + 2 >= code_size) { success = false; goto cleanup; }
+                uint8_t dst = code[vm.ip++];
+                uint8_t arr_slot = code[vm.ip++];
+                uint8_t idx = code[vm.ip++];
+                if (dst >= regs.size() || idx >= regs.size() || arr_slot >= locals.size()) { success = false; goto cleanup; }
+                const Variant &base = locals[arr_slot];
+                int64_t index = regs[idx].i;
+                bool guarded = op == OP_R_GET_ARRAY_I64_GUARDED || op == OP_R_GET_ARRAY_F64_GUARDED;
+                if (!guarded) {
+                    if (base.get_type() != Variant::ARRAY) {
+                        raise_error("Fast array base is not an array");
+                        success = false;
+                        goto cleanup;
+                    }
+                    if (index < 0 || index >= VariantInternal::get_array(&base)->size()) {
+                        raise_error("Array subscript out of range");
+                        success = false;
+                        goto cleanup;
+                    }
+                }
+#ifdef DEBUG_ENABLED
+                else if (base.get_type() != Variant::ARRAY || index < 0 || index >= VariantInternal::get_array(&base)->size()) {
+                    success = false;
+                    goto cleanup;
+                }
+#endif
+                const Variant &element = (*VariantInternal::get_array(&base))[index];
+                if (op == OP_R_GET_ARRAY_I64 || op == OP_R_GET_ARRAY_I64_GUARDED) {
+                    regs[dst].i = vg_register_i64(element);
+                } else {
+                    regs[dst].f = vg_register_f64(element);
+                }
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_R_GUARD_ARRAY): do {
+                if (vm.ip + 3 >= code_size) { success = false; goto cleanup; }
+                uint8_t arr_slot = code[vm.ip++];
+                uint8_t lo = code[vm.ip++];
+                uint8_t hi = code[vm.ip++];
+                uint8_t k = code[vm.ip++];
+                if (arr_slot >= locals.size() || lo >= regs.size() || hi >= regs.size() || k >= chunk->constants.size()) {
+                    success = false;
+                    goto cleanup;
+                }
+                int64_t first = regs[lo].i;
+                int64_t last = regs[hi].i;
+                if (first <= last) {
+                    // Not provable up front: leave the Sub to the AST path,
+                    // which raises the error at the access that fails.
+                    const Variant &base = locals[arr_slot];
+                    int64_t offset = to_int(chunk->constants[k]);
+                    if (base.get_type() != Variant::ARRAY || first + offset < 0 ||
+                            last + offset >= VariantInternal::get_array(&base)->size()) {
+                        success = false;
+                        goto cleanup;
+                    }
+                }
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_CALL_BUILTIN): do {
+                if (vm.ip + 1 >= code_size) { success = false; goto cleanup; }
+                uint8_t builtin_id = code[vm.ip++];
+                uint8_t arg_count = code[vm.ip++];
+                if (!ensure_stack(arg_count)) { success = false; goto cleanup; }
+                const VisualGasicBuiltins::BuiltinInfo *builtin = VisualGasicBuiltins::get_builtin_info(builtin_id);
+                if (!builtin) {
+                    UtilityFunctions::printerr("VisualGasic: unknown builtin id ", (int)builtin_id);
+                    success = false;
+                    goto cleanup;
+                }
+                // Arguments are read in place from the value stack.
+                size_t args_base = vm.stack.size() - arg_count;
+                Variant call_ret = builtin->fn(this, arg_count > 0 ? &vm.stack[args_base] : nullptr, arg_count);
+                vm.stack.resize(args_base);
+                push_value(std::move(call_ret));
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_CALL_USER): do {
+                if (vm.ip + 1 >= code_size) { success = false; goto cleanup; }
+                int sub_idx = wide_index(code[vm.ip++]);
+                uint8_t arg_count = code[vm.ip++];
+                if (!ensure_stack(arg_count)) { success = false; goto cleanup; }
+                if (!script.is_valid() || !script->ast_root || sub_idx >= script->ast_root->subs.size()) {
+                    success = false;
+                    goto cleanup;
+                }
+                SubDefinition *callee = script->ast_root->subs[sub_idx];
+                BytecodeChunk *callee_chunk = script->get_bytecode_for_sub(sub_idx);
+                if (!callee_chunk || callee_chunk->param_count < 0 || callee_chunk->vm_call_failed) {
+                    Array args;
+                    args.resize(arg_count);
+                    for (int i = arg_count - 1; i >= 0; i--) {
+                        args[i] = pop_value();
+                    }
+                    bool found = false;
+                    push_value(call_internal(callee->name, args, found));
+                    break;
+                }
+                if (vm.call_depth >= VG_MAX_CALL_DEPTH) {
+                    raise_error("Out of stack space", 28);
+                    success = false;
+                    goto cleanup;
+                }
+                enter_call_frame(callee_chunk, callee, arg_count);
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_RETURN): do {
                 vm.ip = code_size;
-                break;
-            }
-            case OP_RETURN_VALUE: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_RETURN_VALUE): do {
                 if (!ensure_stack(1)) { success = false; goto cleanup; }
                 explicit_return = pop_value();
                 has_explicit_return = true;
                 vm.ip = code_size;
-                break;
-            }
-            case OP_PRINT: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_PRINT): do {
                 if (!ensure_stack(1)) { success = false; goto cleanup; }
                 Variant val = pop_value();
                 UtilityFunctions::print(val);
@@ -6939,10 +7293,10 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                         }
                     }
                 }
-                break;
-            }
-            case OP_NEW_ARRAY:
-            case OP_NEW_ARRAY_I64: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_NEW_ARRAY):
+            VM_CASE(OP_NEW_ARRAY_I64): do {
                 PROFILE_OPCODE(NewArray);
                 if (!ensure_stack(1)) { success = false; goto cleanup; }
                 int64_t length = to_int(pop_value());
@@ -6957,16 +7311,16 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                     }
                 }
                 push_value(arr);
-                break;
-            }
-            case OP_NEW_DICT: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_NEW_DICT): do {
                 PROFILE_OPCODE(NewDict);
                 Dictionary dict;
                 push_value(dict);
-                break;
-            }
-            case OP_GET_ARRAY:
-            case OP_GET_ARRAY_UNCHECKED: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_GET_ARRAY):
+            VM_CASE(OP_GET_ARRAY_UNCHECKED): do {
                 PROFILE_OPCODE(GetArray);
                 if (vm.ip >= code_size) { success = false; goto cleanup; }
                 uint8_t arg_count = code[vm.ip++];
@@ -7001,10 +7355,10 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                     goto cleanup;
                 }
                 push_value(result);
-                break;
-            }
-            case OP_GET_ARRAY_FAST:
-            case OP_GET_ARRAY_FAST_UNCHECKED: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_GET_ARRAY_FAST):
+            VM_CASE(OP_GET_ARRAY_FAST_UNCHECKED): do {
                 PROFILE_OPCODE(GetArray);
                 if (vm.ip >= code_size) { success = false; goto cleanup; }
                 uint8_t arg_count = code[vm.ip++];
@@ -7033,10 +7387,10 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                     goto cleanup;
                 }
                 push_value((*arr_ptr)[idx]);
-                break;
-            }
-            case OP_GET_DICT_FAST:
-            case OP_GET_DICT_TRUSTED: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_GET_DICT_FAST):
+            VM_CASE(OP_GET_DICT_TRUSTED): do {
                 PROFILE_OPCODE(GetDict);
                 if (vm.ip >= code_size) { success = false; goto cleanup; }
                 uint8_t arg_count = code[vm.ip++];
@@ -7067,10 +7421,10 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                 // Direct dictionary access via pointer
                 const Dictionary *dict_ptr = VariantInternal::get_dictionary(&base);
                 push_value(dict_ptr->get(key_var, Variant()));
-                break;
-            }
-            case OP_SET_ARRAY:
-            case OP_SET_ARRAY_UNCHECKED: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_SET_ARRAY):
+            VM_CASE(OP_SET_ARRAY_UNCHECKED): do {
                 PROFILE_OPCODE(SetArray);
                 if (vm.ip >= code_size) { success = false; goto cleanup; }
                 uint8_t arg_count = code[vm.ip++];
@@ -7096,11 +7450,13 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                             goto cleanup;
                         }
                     } else if (ok) {
+                        journal_record_element(base, idx);
                         arr[idx] = value;
                         updated = arr;
                     }
                 } else if (base.get_type() == Variant::DICTIONARY && arg_count == 1) {
                     Dictionary dict = base;
+                    journal_record_element(base, indices[0]);
                     dict[indices[0]] = value;
                     updated = dict;
                 } else {
@@ -7109,10 +7465,10 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                     goto cleanup;
                 }
                 push_value(updated);
-                break;
-            }
-            case OP_SET_ARRAY_FAST:
-            case OP_SET_ARRAY_FAST_UNCHECKED: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_SET_ARRAY_FAST):
+            VM_CASE(OP_SET_ARRAY_FAST_UNCHECKED): do {
                 PROFILE_OPCODE(SetArray);
                 if (vm.ip >= code_size) { success = false; goto cleanup; }
                 uint8_t arg_count = code[vm.ip++];
@@ -7141,12 +7497,13 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                     success = false;
                     goto cleanup;
                 }
+                journal_record_element(base, idx);
                 (*arr_ptr)[idx] = value;
                 push_value(base);
-                break;
-            }
-            case OP_SET_DICT_FAST:
-            case OP_SET_DICT_TRUSTED: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_SET_DICT_FAST):
+            VM_CASE(OP_SET_DICT_TRUSTED): do {
                 PROFILE_OPCODE(SetDict);
                 if (vm.ip >= code_size) { success = false; goto cleanup; }
                 uint8_t arg_count = code[vm.ip++];
@@ -7176,16 +7533,17 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                 }
 #endif
                 // Direct dictionary modification via pointer
+                journal_record_element(base, key_var);
                 Dictionary *dict_ptr = VariantInternal::get_dictionary(&base);
                 (*dict_ptr)[key_var] = value;
                 push_value(base);
-                break;
-            }
-            case OP_SET_DICT_LOCAL:
-            case OP_SET_DICT_GLOBAL: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_SET_DICT_LOCAL):
+            VM_CASE(OP_SET_DICT_GLOBAL): do {
                 PROFILE_OPCODE(SetDict);
                 if (vm.ip >= code_size) { success = false; goto cleanup; }
-                uint8_t slot_or_idx = code[vm.ip++];
+                int slot_or_idx = wide_index(code[vm.ip++]);
                 if (vm.ip >= code_size) { success = false; goto cleanup; }
                 uint8_t arg_count = code[vm.ip++];
                 
@@ -7202,20 +7560,20 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                 // Get reference to the dict variable without copying
                 Variant *dict_var_ptr = nullptr;
                 if (op == OP_SET_DICT_LOCAL) {
-                    if (slot_or_idx < 0 || slot_or_idx >= locals.size()) {
+                    if (slot_or_idx < 0 || slot_or_idx >= (int)locals.size() || local_reg_kind(slot_or_idx) != BytecodeChunk::REG_NONE) {
                         raise_error("Invalid local slot in OP_SET_DICT_LOCAL");
                         success = false;
                         goto cleanup;
                     }
-                    dict_var_ptr = &locals.write[slot_or_idx];
+                    dict_var_ptr = &locals[slot_or_idx];
                 } else {  // OP_SET_DICT_GLOBAL
-                    String var_name = read_constant(slot_or_idx);
-                    if (!variables.has(var_name)) {
-                        raise_error("Global variable not found: " + var_name);
+                    int global_slot = global_slot_for_constant(slot_or_idx, false);
+                    if (global_slot < 0 || !variables.is_bound(global_slot)) {
+                        raise_error("Global variable not found: " + String(read_constant(slot_or_idx)));
                         success = false;
                         goto cleanup;
                     }
-                    dict_var_ptr = &variables[var_name];
+                    dict_var_ptr = &variables.bind_slot(global_slot);
                 }
                 
                 if (dict_var_ptr->get_type() != Variant::DICTIONARY) {
@@ -7225,13 +7583,14 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                 }
                 
                 // Direct dictionary modification via pointer
+                journal_record_element(*dict_var_ptr, key_var);
                 Dictionary *dict_ptr = VariantInternal::get_dictionary(dict_var_ptr);
                 (*dict_ptr)[key_var] = value;
                 
                 // Note: No need to sync to variables HashMap - COW ensures both point to same data
-                break;
-            }
-            case OP_SUM_ARRAY_I64: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_SUM_ARRAY_I64): do {
                 if (!ensure_stack(1)) { success = false; goto cleanup; }
                 Variant arr_var = pop_value();
                 int64_t sum = 0;
@@ -7243,9 +7602,9 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                     }
                 }
                 push_value(sum);
-                break;
-            }
-            case OP_SUM_DICT_I64: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_SUM_DICT_I64): do {
                 if (!ensure_stack(1)) { success = false; goto cleanup; }
                 Variant dict_var = pop_value();
                 int64_t sum = 0;
@@ -7258,14 +7617,15 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                     }
                 }
                 push_value(sum);
-                break;
-            }
-            case OP_ARRAY_FILL_I64_SEQ: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_ARRAY_FILL_I64_SEQ): do {
                 if (!ensure_stack(2)) { success = false; goto cleanup; }
                 int64_t count = to_int(pop_value());
                 Variant arr_var = pop_value();
                 Array arr;
                 if (arr_var.get_type() == Variant::ARRAY) {
+                    journal_record_container(arr_var);
                     arr = arr_var;
                 }
                 if (count < 0) {
@@ -7276,9 +7636,9 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                     arr[(int)i] = (int64_t)i;
                 }
                 push_value(arr);
-                break;
-            }
-            case OP_ALLOC_FILL_I64: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_ALLOC_FILL_I64): do {
                 if (!ensure_stack(1)) { success = false; goto cleanup; }
                 int64_t count = to_int(pop_value());
                 if (count < 0) {
@@ -7290,9 +7650,9 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                     arr[(int)i] = (int64_t)i;
                 }
                 push_value(arr);
-                break;
-            }
-            case OP_ALLOC_FILL_REPEAT_I64: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_ALLOC_FILL_REPEAT_I64): do {
                 if (vm.ip + 5 >= code_size) { success = false; goto cleanup; }
                 uint8_t sum_slot = code[vm.ip++];
                 uint8_t arr_slot = code[vm.ip++];
@@ -7325,12 +7685,12 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                 int64_t per_iter = size;
                 base_sum += per_iter * iterations;
                 push_value(base_sum);
-                break;
-            }
-            case OP_GET_MEMBER: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_GET_MEMBER): do {
                 PROFILE_OPCODE(GetMember);
                 if (vm.ip >= code_size) { success = false; goto cleanup; }
-                uint8_t idx = code[vm.ip++];
+                int idx = wide_index(code[vm.ip++]);
                 if (!ensure_stack(1)) { success = false; goto cleanup; }
                 int member_idx = idx;
                 if (member_idx >= member_name_cache.size()) {
@@ -7393,12 +7753,12 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                     }
                 }
                 push_value(result);
-                break;
-            }
-            case OP_SET_MEMBER: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_SET_MEMBER): do {
                 PROFILE_OPCODE(SetMember);
                 if (vm.ip >= code_size) { success = false; goto cleanup; }
-                uint8_t idx = code[vm.ip++];
+                int idx = wide_index(code[vm.ip++]);
                 if (!ensure_stack(2)) { success = false; goto cleanup; }
                 int member_idx = idx;
                 if (member_idx >= member_name_cache.size()) {
@@ -7410,6 +7770,7 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                 Variant value = pop_value();
                 Variant base = pop_value();
                 if (base.get_type() == Variant::DICTIONARY) {
+                    journal_record_element(base, cache.primary_string);
                     Dictionary *dict = VariantInternal::get_dictionary(&base);
                     (*dict)[cache.primary_string] = value;
                     push_value(base);  // Push modified dictionary back
@@ -7452,18 +7813,18 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                 } else {
                     push_value(base);
                 }
-                break;
-            }
-            case OP_NIL:
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_NIL):
                 push_value(Variant());
-                break;
-            case OP_TRUE:
+                DISPATCH();
+            VM_CASE(OP_TRUE):
                 push_value(true);
-                break;
-            case OP_FALSE:
+                DISPATCH();
+            VM_CASE(OP_FALSE):
                 push_value(false);
-                break;
-            case OP_ABS: {
+                DISPATCH();
+            VM_CASE(OP_ABS): do {
                 if (!ensure_stack(1)) { success = false; goto cleanup; }
                 Variant value = pop_value();
                 if (value.get_type() == Variant::INT) {
@@ -7471,16 +7832,16 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                 } else {
                     push_value(Math::abs(to_double(value)));
                 }
-                break;
-            }
-            case OP_SGN: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_SGN): do {
                 if (!ensure_stack(1)) { success = false; goto cleanup; }
                 double v = to_double(pop_value());
                 int64_t sign = (v > 0.0) - (v < 0.0);
                 push_value(sign);
-                break;
-            }
-            case OP_DICT_HAS_KEY: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_DICT_HAS_KEY): do {
                 if (!ensure_stack(2)) { success = false; goto cleanup; }
                 Variant key = pop_value();
                 Variant dict_var = pop_value();
@@ -7490,9 +7851,9 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                     result = dict->has(key);
                 }
                 push_value(result);
-                break;
-            }
-            case OP_DICT_SIZE: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_DICT_SIZE): do {
                 if (!ensure_stack(1)) { success = false; goto cleanup; }
                 Variant dict_var = pop_value();
                 int64_t size = 0;
@@ -7501,19 +7862,20 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                     size = dict->size();
                 }
                 push_value(size);
-                break;
-            }
-            case OP_DICT_CLEAR_INPLACE: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_DICT_CLEAR_INPLACE): do {
                 if (!ensure_stack(1)) { success = false; goto cleanup; }
                 Variant dict_var = pop_value();
                 if (dict_var.get_type() == Variant::DICTIONARY) {
+                    journal_record_container(dict_var);
                     Dictionary *dict = VariantInternal::get_dictionary(&dict_var);
                     dict->clear();
                 }
                 push_value(dict_var);
-                break;
-            }
-            case OP_DICT_KEYS: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_DICT_KEYS): do {
                 if (!ensure_stack(1)) { success = false; goto cleanup; }
                 Variant dict_var = pop_value();
                 Array keys;
@@ -7522,9 +7884,9 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                     keys = dict->keys();
                 }
                 push_value(keys);
-                break;
-            }
-            case OP_DICT_VALUES: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_DICT_VALUES): do {
                 if (!ensure_stack(1)) { success = false; goto cleanup; }
                 Variant dict_var = pop_value();
                 Array values;
@@ -7533,20 +7895,24 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
                     values = dict->values();
                 }
                 push_value(values);
-                break;
-            }
-            case OP_DICT_ERASE: {
+            } while (0);
+            DISPATCH();
+            VM_CASE(OP_DICT_ERASE): do {
                 if (!ensure_stack(2)) { success = false; goto cleanup; }
                 Variant key = pop_value();
                 Variant dict_var = pop_value();
                 if (dict_var.get_type() == Variant::DICTIONARY) {
+                    journal_record_element(dict_var, key);
                     Dictionary *dict = VariantInternal::get_dictionary(&dict_var);
                     dict->erase(key);
                 }
                 push_value(dict_var);
-                break;
-            }
+            } while (0);
+            DISPATCH();
             default:
+#if VG_THREADED_DISPATCH
+            vm_op_default:
+#endif
                 UtilityFunctions::printerr("VisualGasic: unsupported opcode ", (int)op);
                 success = false;
                 goto cleanup;
@@ -7554,6 +7920,25 @@ bool VisualGasicInstance::execute_bytecode(BytecodeChunk* chunk, SubDefinition*
     }
 
 cleanup:
+    if (!success && !call_frames.empty()) {
+        // A directly called Sub failed. Later calls to it go through
+        // call_internal (which can fall back to the AST walker); this run
+        // unwinds every frame and fails as a whole so the outermost caller
+        // rolls back and re-executes.
+        chunk->vm_call_failed = true;
+        for (size_t i = 0; i < call_frames.size(); i++) {
+            journal_rollback();
+        }
+        vm.call_depth -= (int)call_frames.size();
+        CallFrame &outermost = call_frames.front();
+        chunk = outermost.chunk;
+        func = outermost.func;
+        current_sub = outermost.prev_sub;
+        stack_base = outermost.stack_base;
+        locals = std::move(outermost.locals);
+        regs = std::move(outermost.regs);
+        call_frames.clear();
+    }
     if (success) {
         if (has_explicit_return) {
             result_snapshot = explicit_return;
@@ -7570,7 +7955,15 @@ cleanup:
     }
 
     if (func && func->type == SubDefinition::TYPE_FUNCTION) {
-        if (variables.has(func->name)) {
+        if (chunk->return_slot >= 0) {
+            if (has_explicit_return) {
+                r_ret = explicit_return;
+            } else if (chunk->return_slot < (int)locals.size()) {
+                r_ret = read_local(chunk->return_slot);
+            } else {
+                r_ret = Variant();
+            }
+        } else if (variables.has(func->name)) {
             r_ret = variables[func->name];
         } else {
             r_ret = result_snapshot;
@@ -7593,7 +7986,7 @@ void VisualGasicInstance::execute_async_function(AsyncFunctionStatement* async_f
     coroutine.instruction_pointer = 0;
     
     // Create local scope for function parameters
-    Dictionary backup_vars = variables;
+    Dictionary backup_vars = variables.duplicate();
     
     // Set parameter values (simplified)
     for (int i = 0; i < async_func->parameters.size(); i++) {
@@ -7747,7 +8140,7 @@ void VisualGasicInstance::execute_pattern_match(PatternMatchStatement* match_stm
         
         if (pattern_matches(match_case->pattern, value, captured_vars)) {
             // Save current variable state
-            Dictionary backup_vars = variables;
+            Dictionary backup_vars = variables.duplicate();
             
             // Add captured variables to scope
             Array keys = captured_vars.keys();
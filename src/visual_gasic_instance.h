@@ -4,20 +4,36 @@
 #include "visual_gasic_script.h"
 #include "visual_gasic_bytecode.h"
 #include "visual_gasic_ast.h"
+#include "visual_gasic_data_pool.h"
+#include "visual_gasic_file.h"
+#include "visual_gasic_global_slots.h"
+#include "visual_gasic_object.h"
 #include <godot_cpp/core/object.hpp>
 #include <godot_cpp/classes/file_access.hpp>
 #include <godot_cpp/classes/dir_access.hpp>
 #include <godot_cpp/classes/os.hpp>
 #include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/hash_set.hpp>
 
 using namespace godot;
 using namespace VisualGasic;
 
+class VisualGasicDrawBatch;
+
 class VisualGasicInstance {
     Ref<VisualGasicScript> script;
     Object *owner;
-    Dictionary variables; // Variable storage
-    Dictionary open_files; // Map<int, Ref<FileAccess>>
+    GlobalSlotTable variables; // Variable storage (slot-indexed, see visual_gasic_global_slots.h)
+    // ModuleNode::slot_names index -> slot in `variables`, for nodes the
+    // binder resolved. Only needed once a reparse gives the module a layout
+    // other than the one `variables` was laid out from; empty until then.
+    Vector<int> bound_slots;
+    uint64_t bound_generation = 0;
+    // Optional loop watchdog, from the visual_gasic/runtime/loop_watchdog_*
+    // project settings; 0 turns a budget off. Loops are unbounded otherwise.
+    int64_t loop_watchdog_iterations = 0;
+    int64_t loop_watchdog_ms = 0;
+    HashMap<int, VisualGasicFile *> open_files; // #n -> file, see visual_gasic_file.h
 
     Ref<DirAccess> current_dir; // For Dir() iteration
     String dir_pattern; 
@@ -28,13 +44,13 @@ class VisualGasicInstance {
     Vector<Variant> with_stack;
 
     // DATA / READ Support
-    Vector<ExpressionNode*> data_segments; 
-    Vector<ExpressionNode*> runtime_data_nodes; // Nodes created at execution time (LoadData)
-    int data_pointer;
+    VisualGasicDataPool data_pool; // DATA values, then LoadData files (parsed as READ reaches them)
+    int64_t data_pointer;
     Dictionary label_to_data_index; 
     
     // Dynamic Nodes Tracking (for CLS)
     Vector<uint64_t> dynamic_nodes;
+    VisualGasicDrawBatch *draw_batch = nullptr; // Created by the first drawing command
 
     void scan_data_sections(ModuleNode* root);
     void collect_data_from_block(const Vector<Statement*>& block);
@@ -48,6 +64,9 @@ class VisualGasicInstance {
     // Or we can construct a Dictionary of Default Values for each struct eagerly.
     // Name -> Dictionary(default object).
     Dictionary struct_prototypes; 
+    // Put/Get layout of each Type, parallel to ModuleNode::structs.
+    std::vector<VisualGasicFile::Layout> record_layouts;
+    const VisualGasicFile::Layout *record_layout_for(const Variant &p_value) const;
     
     // Class system storage
     struct FastKeyCacheEntry {
@@ -59,11 +78,16 @@ class VisualGasicInstance {
     static constexpr uint32_t FAST_DICT_CACHE_TRIGGER = 3;
     static constexpr uint32_t FAST_DICT_CACHE_MAX_ENTRIES = 256;
 
-    Dictionary class_registry;       // class_name -> ClassDefinition* (as int64_t)
-    Dictionary object_instances;     // object_id -> Dictionary of member values
-    int next_object_id = 1;         // For unique object IDs
-    Dictionary loaded_libraries;     // lib_name -> handle (as int64_t)
-    Dictionary declared_functions;   // function_name -> DeclareStatement* (as int64_t)
+    // Class objects (VisualGasicObject). live_objects are detached when the
+    // instance goes away so their release no longer calls back into it.
+    HashSet<VisualGasicObject *> live_objects;
+    VisualGasicObject *current_object = nullptr; // Me inside a Class method
+    struct ClassLayout {
+        Vector<Variant> defaults; // Field values by type, copied into each new object
+        Vector<int> fresh;        // Fields built per object: initializers, arrays, Types
+    };
+    Vector<ClassLayout> class_layouts; // Per ModuleNode::classes, for class_layout_generation
+    uint64_t class_layout_generation = 0;
     HashMap<StringName, FastKeyCacheEntry> fast_dict_key_cache;
     uint32_t fast_dict_key_cache_generation = 0;
     StringName fast_dict_last_key_name;
@@ -84,14 +108,29 @@ class VisualGasicInstance {
         uint64_t debounce_ms;       // Minimum time between triggers
         String scope_type;          // "global", "local", "member"
         String scope_context;       // Sub/Function name or Class name
+        int variable_slot;          // Slot of variable_name in `variables`, -1 for expressions
+        bool pending;               // Deferred dispatch: queued for the next frame
         
-        WheneverSection() : condition_expression(nullptr), is_active(true), last_trigger_time(0), debounce_ms(0), scope_type("global") {}
+        WheneverSection() : condition_expression(nullptr), is_active(true), last_trigger_time(0), debounce_ms(0), scope_type("global"), variable_slot(-1), pending(false) {}
         
         ~WheneverSection() {
             // Note: condition_expression will be cleaned up by AST, don't delete here
         }
     };
     Vector<WheneverSection> whenever_sections;
+    // Dispatch index over whenever_sections, rebuilt when sections are added
+    // or removed: slot in `variables` -> sections to check when it is assigned.
+    struct WheneverWatchers {
+        Vector<int> value_sections;      // Sections on the variable itself
+        Vector<int> expression_sections; // Condition expressions that read it
+    };
+    HashMap<int, WheneverWatchers> whenever_watchers;
+    Vector<int> whenever_opaque_sections; // Expressions checked on every assignment (see VisualGasicBinder::collect_reads)
+    uint64_t whenever_revision = 0;       // Bumped by each rebuild; stale section indices stop a dispatch
+    // visual_gasic/whenever/deferred_dispatch: assignments only queue the
+    // sections, which are checked once per frame from NOTIFICATION_PROCESS.
+    bool whenever_deferred = false;
+    Vector<int> whenever_pending;
     Vector<String> scope_stack;  // Track current scope hierarchy
 
     // Multitasking system
@@ -131,8 +170,99 @@ class VisualGasicInstance {
     
     SubDefinition* current_sub;
     int jump_target;
-    
+
+    // Undo journal for bytecode runs. Instead of deep-copying `variables`
+    // before every call, the first write to each name inside a frame records
+    // its previous binding, and every in-place container write records the
+    // element it overwrites (once per element and frame, like names), so a
+    // failed bytecode run can be rolled back before the AST fallback
+    // re-executes it. Recording never copies a container, so a write costs
+    // the same however large the container is.
+    struct VariableJournalEntry {
+        int slot = -1;        // Rebound variable; -1 for container edits
+        Variant container;    // Array/Dictionary edited in place
+        Variant key;          // Element written (index or key)
+        Variant old_value;    // Previous binding or element value
+        Variant snapshot;     // Shallow copy of contents before a clear/refill
+        bool existed = false; // Variable was bound / key was present
+    };
+    // An element of an Array/Dictionary: the storage its copies share, and
+    // the key. The journal entry holds the container, so the storage cannot
+    // be freed and reused while the element is recorded.
+    struct JournalElement {
+        const void *container = nullptr;
+        Variant key;
+        bool operator==(const JournalElement &p_other) const {
+            return container == p_other.container && key.hash_compare(p_other.key);
+        }
+    };
+    struct JournalElementHasher {
+        static uint32_t hash(const JournalElement &p_element) {
+            return hash_murmur3_one_64((uint64_t)(uintptr_t)p_element.container, p_element.key.hash());
+        }
+    };
+    struct VariableJournalFrame {
+        int mark = 0;
+        HashSet<int> recorded_slots;
+        HashSet<JournalElement, JournalElementHasher> recorded_elements;
+    };
+    Vector<VariableJournalEntry> variable_journal;
+    Vector<VariableJournalFrame> variable_journal_frames;
+
+    void journal_begin();
+    void journal_record(const String &p_name);
+    void journal_record_slot(int p_slot);
+    // Before p_container[p_key] is written or erased.
+    void journal_record_element(const Variant &p_container, const Variant &p_key);
+    // Before p_container is cleared or refilled as a whole.
+    void journal_record_container(const Variant &p_container);
+    void journal_commit();
+    void journal_rollback();
+
     Variant call_internal(const String& p_method, const Array& p_args, bool &r_found);
+    Variant call_internal(int p_sub_index, const Array& p_args, bool &r_found);
+    // Binds the arguments and runs a Sub/Function or Class method body;
+    // p_bytecode_index is its index in ModuleNode::subs, -1 to stay on the AST.
+    Variant run_procedure(SubDefinition *p_func, int p_bytecode_index, const Array &p_args);
+
+    Variant instantiate_class(int p_class_index, const Array &p_args);
+    // True while the object's class layout belongs to its instance's module.
+    static bool object_is_current(const VisualGasicObject *p_object);
+    // The class object held by p_value, or nullptr. Raises an error for an
+    // object whose script was reloaded since it was created.
+    VisualGasicObject *as_class_object(const Variant &p_value);
+    Variant call_class_method(VisualGasicObject *p_object, int p_method_index, const Array &p_args);
+    // Index of p_name in p_names (ClassDefinition::member_index or
+    // method_index), through the call site's inline cache.
+    static int lookup_class_site(ClassSiteCache &p_cache, const ClassDefinition *p_class, const HashMap<String, int> &p_names, const String &p_name) {
+        if (p_cache.definition != p_class) {
+            const int *index = p_names.getptr(p_name.to_lower());
+            p_cache.definition = p_class;
+            p_cache.index = index ? *index : -1;
+        }
+        return p_cache.index;
+    }
+    // obj.Name(args): a method, or an element of an array field.
+    Variant call_class_site(VisualGasicObject *p_object, ClassSiteCache &p_cache, const String &p_name, const Array &p_args);
+    // Reads a field, or calls a parameterless method of that name.
+    Variant get_class_member(VisualGasicObject *p_object, MemberAccessNode *p_access);
+    // Slot in `variables` of a Binding::slot of the running module, or -1.
+    int bound_slot(int p_layout_slot) {
+        uint64_t generation = script->ast_root->bind_generation;
+        if (variables.get_layout_generation() == generation) {
+            return p_layout_slot;
+        }
+        if (bound_generation != generation) {
+            sync_bound_slots();
+        }
+        return p_layout_slot < bound_slots.size() ? bound_slots[p_layout_slot] : -1;
+    }
+    void sync_bound_slots();
+    bool read_indexed_variable(const Variant &p_value, const Array &p_args, Variant &r_ret);
+    Variant call_owner_method(const String &p_method, const Array &p_args);
+    // execute_bytecode picks the profiled or release instantiation.
+    template <bool Profiled>
+    bool execute_bytecode_impl(BytecodeChunk* chunk, SubDefinition* func, Variant &r_ret);
 
     // Small helper declarations used by statement execution implementation.
     // `dispatch_builtin_call` dispatches built-in method calls (returns via found flag).
@@ -142,9 +272,17 @@ class VisualGasicInstance {
     bool get_variable(const String &p_name, Variant &r_ret);
 
     void assign_to_target(ExpressionNode* target, Variant val);
-    void assign_variable(const String& name, Variant val);
-    void check_whenever_conditions(const String& variable_name, const Variant& new_value);
-    void check_expression_conditions();  // For complex expression monitoring
+    void assign_variable(const String& name, Variant val, SlotHint *p_slot_hint = nullptr);
+    void assign_variable_slot(int p_slot, const String& name, Variant val, bool p_notify = true);
+    // True if a write to the slot can trigger a Whenever section.
+    bool is_whenever_watched(int p_slot) const {
+        return !whenever_opaque_sections.is_empty() || whenever_watchers.has(p_slot);
+    }
+    void rebuild_whenever_index();
+    void notify_whenever(int p_slot, const Variant& new_value);
+    void fire_whenever_value_section(int p_index, const Variant& new_value);
+    void fire_whenever_expression_section(int p_index);  // For complex expression monitoring
+    void flush_whenever_pending();
 
     void execute_statement(Statement* stmt);
     Variant evaluate_expression(ExpressionNode* expr);
@@ -152,6 +290,9 @@ class VisualGasicInstance {
     Variant _evaluate_expression_impl(ExpressionNode* expr);
     void _execute_statement_impl(Statement* stmt);
     void raise_error(String msg, int code = 5);
+    bool loop_watchdog_enabled() const { return loop_watchdog_iterations > 0 || loop_watchdog_ms > 0; }
+    // Raises a runtime error once a loop has used up its budget.
+    bool loop_watchdog_tripped(int64_t p_iterations, uint64_t p_start_ms);
     Variant *get_cached_fast_dict_key(const Variant &key_source);
     Variant *insert_fast_dict_key_entry(const StringName &key_name, const Variant &key_source, uint32_t initial_hits);
     void prune_fast_dict_cache_if_needed();
@@ -168,11 +309,18 @@ public:
     Variant file_loc(int file_num);
     Variant file_eof(int file_num);
     int file_free(int range);
+    void close_file(int file_num); // Stores pending writes
+    void close_all_files();
     Variant file_len(const String &path);
     Variant file_dir(const Array &args);
     void randomize_seed();
     // Allow builtins to raise runtime errors via instance wrapper
     void raise_runtime_error(const String &p_msg, int p_code = 5);
+    // Nodes created by commands (AddChild, CreateCube...), freed by CLS
+    void track_dynamic_node(Object *p_node);
+    void clear_dynamic_nodes();
+    // PSet/DrawLine batching and the SetFramebuffer pixels (visual_gasic_draw_batch.h)
+    VisualGasicDrawBatch *get_draw_batch();
     
     // Whenever system utilities
     String get_whenever_status() const;
@@ -219,23 +367,18 @@ public:
     void notification(int32_t p_what);
     void to_string(GDExtensionBool *r_is_valid, GDExtensionStringPtr r_out);
 
-    // Class Management Methods
-    Variant instantiate_class(const String& class_name, const Array& args);
-    bool get_object_member(int obj_id, const String& member_name, Variant &r_ret);
-    void set_object_member(int obj_id, const String& member_name, const Variant& value);
-    Variant call_object_method(int obj_id, const String& method_name, const Array& args);
-    void register_class(ClassDefinition* cls);
-    void execute_class_method(ClassDefinition* cls, SubDefinition* method, int obj_id, const Array& args, Variant& r_ret);
+    // Class objects: field access by name (VisualGasicObject::_get/_set) and
+    // Class_Terminate when the last reference is released.
+    bool get_object_member(const VisualGasicObject *p_object, const String &p_name, Variant &r_ret);
+    bool set_object_member(VisualGasicObject *p_object, const String &p_name, const Variant &p_value);
+    void release_object(VisualGasicObject *p_object);
     bool is_property_accessor(const String& prop_name, PropertyDefinition::PropertyType& type);
     Variant call_property_get(const String& prop_name, const Array& args);
     void call_property_let(const String& prop_name, const Array& args, const Variant& value);
     void call_property_set(const String& prop_name, const Array& args, const Variant& value);
     
     // FFI/DLL Support
-    void* load_library(const String& lib_name);
-    void* get_function_address(void* lib_handle, const String& func_name);
-    Variant call_ffi_function(DeclareStatement* decl, const Array& args);
-    void register_declare(DeclareStatement* decl);
+    Variant call_ffi_function(int p_declare_index, const Vector<ExpressionNode*>& p_arguments);
 
     static const GDExtensionScriptInstanceInfo3 *get_script_instance_info();
 };
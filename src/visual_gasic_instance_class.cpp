@@ -1,201 +1,212 @@
 #include "visual_gasic_instance.h"
+#if VG_USE_FFI
+#include "visual_gasic_ffi.h"
+#endif
 #include <godot_cpp/variant/utility_functions.hpp>
-#include <dlfcn.h> // For dynamic library loading on Linux
 
 using namespace VisualGasic;
 
-// Class instantiation and management
-Variant VisualGasicInstance::instantiate_class(const String& class_name, const Array& args) {
-    if (!class_registry.has(class_name)) {
-        UtilityFunctions::print("Error: Class '", class_name, "' not defined");
-        return Variant();
-    }
-    
-    ClassDefinition* cls = (ClassDefinition*)((int64_t)class_registry[class_name]);
-    
-    // Create new object instance
-    int obj_id = next_object_id++;
-    Dictionary obj_data;
-    obj_data["__class__"] = class_name;
-    obj_data["__id__"] = obj_id;
-    
-    // Initialize member variables with defaults
-    for (int i = 0; i < cls->members.size(); i++) {
-        VariableDefinition* member = cls->members[i];
-        if (member->default_value) {
-            obj_data[member->name] = evaluate_expression(member->default_value);
-        } else {
-            // Default initialization based on type
-            if (member->type.nocasecmp_to("Integer") == 0 || member->type.nocasecmp_to("Long") == 0) {
-                obj_data[member->name] = 0;
-            } else if (member->type.nocasecmp_to("String") == 0) {
-                obj_data[member->name] = "";
-            } else if (member->type.nocasecmp_to("Boolean") == 0) {
-                obj_data[member->name] = false;
-            } else if (member->type.nocasecmp_to("Variant") == 0) {
-                obj_data[member->name] = Variant();
-            } else {
-                obj_data[member->name] = Variant();
-            }
-        }
+// Class objects: instantiation, field access, method dispatch and release.
+
+bool VisualGasicInstance::object_is_current(const VisualGasicObject *p_object) {
+    const VisualGasicInstance *owner_instance = p_object->instance;
+    return owner_instance && owner_instance->script.is_valid() && owner_instance->script->ast_root &&
+            owner_instance->script->ast_root->bind_generation == p_object->generation;
+}
+
+VisualGasicObject *VisualGasicInstance::as_class_object(const Variant &p_value) {
+    if (p_value.get_type() != Variant::OBJECT) {
+        return nullptr;
     }
-    
-    object_instances[obj_id] = obj_data;
-    
-    // Call Class_Initialize if it exists
-    if (cls->class_initialize) {
-        Variant ret;
-        execute_class_method(cls, cls->class_initialize, obj_id, args, ret);
+    VisualGasicObject *object = Object::cast_to<VisualGasicObject>((Object *)p_value);
+    if (object && !object_is_current(object)) {
+        raise_error("Object of class " + object->class_name + " was created before its script was reloaded");
+        return nullptr;
     }
-    
-    // Return object ID wrapped in Variant
-    return obj_id;
+    return object;
 }
 
-bool VisualGasicInstance::get_object_member(int obj_id, const String& member_name, Variant &r_ret) {
-    if (!object_instances.has(obj_id)) {
-        return false;
-    }
-    
-    Dictionary obj_data = object_instances[obj_id];
-    if (obj_data.has(member_name)) {
-        r_ret = obj_data[member_name];
-        return true;
+Variant VisualGasicInstance::instantiate_class(int p_class_index, const Array &p_args) {
+    ModuleNode *root = script.is_valid() ? script->ast_root : nullptr;
+    if (!root || p_class_index < 0 || p_class_index >= root->classes.size()) {
+        return Variant();
     }
-    
-    // Check for property getter
-    PropertyDefinition::PropertyType prop_type;
-    if (is_property_accessor(member_name, prop_type)) {
-        if (prop_type == PropertyDefinition::PROP_GET) {
-            r_ret = call_property_get(member_name, Array());
-            return true;
+
+    // Field defaults depend only on the member types, so they are worked out
+    // once per class and copied; initializers, arrays and Types are not.
+    if (class_layout_generation != root->bind_generation) {
+        class_layouts.clear();
+        class_layouts.resize(root->classes.size());
+        for (int c = 0; c < root->classes.size(); c++) {
+            const ClassDefinition *cls = root->classes[c];
+            ClassLayout &layout = class_layouts.write[c];
+            layout.defaults.resize(cls->members.size());
+            for (int m = 0; m < cls->members.size(); m++) {
+                const VariableDefinition *member = cls->members[m];
+                String t = member->type.to_lower();
+                Variant value;
+                if (member->default_value || !member->array_sizes.is_empty() || struct_prototypes.has(member->type)) {
+                    layout.fresh.push_back(m);
+                } else if (t == "integer" || t == "long") {
+                    value = (int64_t)0;
+                } else if (t == "single" || t == "double") {
+                    value = 0.0;
+                } else if (t == "string") {
+                    value = String();
+                } else if (t == "boolean") {
+                    value = false;
+                }
+                layout.defaults.write[m] = value;
+            }
         }
+        class_layout_generation = root->bind_generation;
     }
-    
-    return false;
-}
 
-void VisualGasicInstance::set_object_member(int obj_id, const String& member_name, const Variant& value) {
-    if (!object_instances.has(obj_id)) {
-        UtilityFunctions::print("Error: Invalid object ID ", obj_id);
-        return;
+    ClassDefinition *cls = root->classes[p_class_index];
+    const ClassLayout &layout = class_layouts[p_class_index];
+    Ref<VisualGasicObject> object;
+    object.instantiate();
+    object->instance = this;
+    object->definition = cls;
+    object->generation = root->bind_generation;
+    object->class_name = cls->name;
+    object->fields = layout.defaults;
+
+    for (int i = 0; i < layout.fresh.size(); i++) {
+        const VariableDefinition *member = cls->members[layout.fresh[i]];
+        Variant value;
+        if (!member->array_sizes.is_empty()) {
+            // Dim a(n) holds n + 1 elements, nested per dimension.
+            struct ArrayBuilder {
+                static Array create(const Vector<int> &p_sizes, int p_depth, const Variant &p_leaf) {
+                    Array a;
+                    a.resize(p_sizes[p_depth] + 1);
+                    for (int k = 0; k < a.size(); k++) {
+                        if (p_depth < p_sizes.size() - 1) {
+                            a[k] = create(p_sizes, p_depth + 1, p_leaf);
+                        } else if (p_leaf.get_type() == Variant::DICTIONARY) {
+                            a[k] = ((Dictionary)p_leaf).duplicate(true);
+                        }
+                    }
+                    return a;
+                }
+            };
+            value = ArrayBuilder::create(member->array_sizes, 0, struct_prototypes.get(member->type, Variant()));
+        } else if (member->default_value) {
+            value = evaluate_expression(member->default_value);
+            String t = member->type.to_lower();
+            if (t == "integer" || t == "long") value = (int64_t)value;
+            else if (t == "single" || t == "double") value = (double)value;
+            else if (t == "string") value = (String)value;
+            else if (t == "boolean") value = (bool)value;
+        } else {
+            value = ((Dictionary)struct_prototypes[member->type]).duplicate(true);
+        }
+        object->fields.write[layout.fresh[i]] = value;
     }
-    
-    Dictionary obj_data = object_instances[obj_id];
-    
-    // Check for property setter
-    PropertyDefinition::PropertyType prop_type;
-    if (is_property_accessor(member_name, prop_type)) {
-        if (prop_type == PropertyDefinition::PROP_LET || prop_type == PropertyDefinition::PROP_SET) {
-            call_property_let(member_name, Array(), value);
-            return;
+
+    live_objects.insert(object.ptr());
+    if (cls->class_initialize) {
+        const int *method = cls->method_index.getptr("class_initialize");
+        if (method) {
+            call_class_method(object.ptr(), *method, p_args);
         }
     }
-    
-    obj_data[member_name] = value;
-    object_instances[obj_id] = obj_data; // Update stored object
+    return object;
 }
 
-Variant VisualGasicInstance::call_object_method(int obj_id, const String& method_name, const Array& args) {
-    if (!object_instances.has(obj_id)) {
-        UtilityFunctions::print("Error: Invalid object ID ", obj_id);
-        return Variant();
+Variant VisualGasicInstance::call_class_method(VisualGasicObject *p_object, int p_method_index, const Array &p_args) {
+    if (p_object->instance != this) {
+        // Created by another script instance: its fields and methods are bound there.
+        return p_object->instance->call_class_method(p_object, p_method_index, p_args);
     }
-    
-    Dictionary obj_data = object_instances[obj_id];
-    String class_name = obj_data["__class__"];
-    
-    if (!class_registry.has(class_name)) {
-        return Variant();
-    }
-    
-    ClassDefinition* cls = (ClassDefinition*)((int64_t)class_registry[class_name]);
-    
-    // Find method in class
-    for (int i = 0; i < cls->methods.size(); i++) {
-        if (cls->methods[i]->name.nocasecmp_to(method_name) == 0) {
-            Variant ret;
-            execute_class_method(cls, cls->methods[i], obj_id, args, ret);
-            return ret;
-        }
-    }
-    
-    UtilityFunctions::print("Error: Method '", method_name, "' not found in class '", class_name, "'");
+    SubDefinition *method = p_object->definition->methods[p_method_index];
+
+    // Keep the object alive while its method runs, even if the method drops
+    // the last outside reference. Class_Terminate runs with no references left.
+    Ref<VisualGasicObject> keep_alive;
+    if (!p_object->terminating) {
+        keep_alive = Ref<VisualGasicObject>(p_object);
+    }
+    VisualGasicObject *prev_object = current_object;
+    current_object = p_object;
+    Variant ret = run_procedure(method, -1, p_args);
+    current_object = prev_object;
+    return ret;
+}
+
+Variant VisualGasicInstance::call_class_site(VisualGasicObject *p_object, ClassSiteCache &p_cache, const String &p_name, const Array &p_args) {
+    const ClassDefinition *cls = p_object->definition;
+    int method = lookup_class_site(p_cache, cls, cls->method_index, p_name);
+    if (method >= 0) {
+        return call_class_method(p_object, method, p_args);
+    }
+    const int *field = cls->member_index.getptr(p_name.to_lower());
+    Variant element;
+    if (field && read_indexed_variable(p_object->fields[*field], p_args, element)) {
+        return element;
+    }
+    raise_error("Class " + p_object->class_name + " has no method " + p_name);
     return Variant();
 }
 
-void VisualGasicInstance::register_class(ClassDefinition* cls) {
-    if (cls && !cls->name.is_empty()) {
-        class_registry[cls->name] = (int64_t)cls; // Store pointer as int64
-        UtilityFunctions::print("Registered class: ", cls->name);
-    }
+Variant VisualGasicInstance::get_class_member(VisualGasicObject *p_object, MemberAccessNode *p_access) {
+    // The cache holds a field index, or -2 - method index for a
+    // parameterless Function read like a property.
+    ClassSiteCache &cache = p_access->class_cache;
+    const ClassDefinition *cls = p_object->definition;
+    if (cache.definition != cls) {
+        String key = p_access->member_name.to_lower();
+        const int *field = cls->member_index.getptr(key);
+        const int *method = field ? nullptr : cls->method_index.getptr(key);
+        cache.definition = cls;
+        cache.index = field ? *field : (method ? -2 - *method : -1);
+    }
+    if (cache.index >= 0) {
+        return p_object->fields[cache.index];
+    }
+    if (cache.index <= -2) {
+        return call_class_method(p_object, -2 - cache.index, Array());
+    }
+    raise_error("Class " + p_object->class_name + " has no member " + p_access->member_name);
+    return Variant();
 }
 
-void VisualGasicInstance::execute_class_method(ClassDefinition* cls, SubDefinition* method, int obj_id, const Array& args, Variant& r_ret) {
-    // Save current object context
-    Dictionary saved_vars = variables.duplicate();
-    
-    // Load object members into variable scope
-    if (object_instances.has(obj_id)) {
-        Dictionary obj_data = object_instances[obj_id];
-        Array keys = obj_data.keys();
-        for (int i = 0; i < keys.size(); i++) {
-            String key = keys[i];
-            if (!key.begins_with("__")) { // Skip internal fields
-                variables[key] = obj_data[key];
-            }
-        }
+bool VisualGasicInstance::get_object_member(const VisualGasicObject *p_object, const String &p_name, Variant &r_ret) {
+    if (!object_is_current(p_object)) {
+        return false;
     }
-    
-    // Set up method parameters
-    for (int i = 0; i < method->parameters.size() && i < args.size(); i++) {
-        variables[method->parameters[i].name] = args[i];
+    const int *field = p_object->definition->member_index.getptr(p_name.to_lower());
+    if (!field) {
+        return false;
     }
-    
-    // Execute method body
-    SubDefinition* saved_sub = current_sub;
-    current_sub = method;
-    
-    for (int i = 0; i < method->statements.size(); i++) {
-        execute_statement(method->statements[i]);
-        
-        // Check for early exit
-        if (error_state.mode == ErrorState::EXIT_SUB) {
-            error_state.mode = ErrorState::NONE;
-            break;
-        }
+    r_ret = p_object->fields[*field];
+    return true;
+}
+
+bool VisualGasicInstance::set_object_member(VisualGasicObject *p_object, const String &p_name, const Variant &p_value) {
+    if (!object_is_current(p_object)) {
+        return false;
     }
-    
-    // Get return value for functions
-    if (method->type == SubDefinition::TYPE_FUNCTION) {
-        if (variables.has(method->name)) {
-            r_ret = variables[method->name];
-        }
+    const int *field = p_object->definition->member_index.getptr(p_name.to_lower());
+    if (!field) {
+        return false;
     }
-    
-    current_sub = saved_sub;
-    
-    // Save modified members back to object
-    if (object_instances.has(obj_id)) {
-        Dictionary obj_data = object_instances[obj_id];
-        String class_name = obj_data["__class__"];
-        
-        if (class_registry.has(class_name)) {
-            ClassDefinition* cls_def = (ClassDefinition*)((int64_t)class_registry[class_name]);
-            
-            for (int i = 0; i < cls_def->members.size(); i++) {
-                String member_name = cls_def->members[i]->name;
-                if (variables.has(member_name)) {
-                    obj_data[member_name] = variables[member_name];
-                }
-            }
-            
-            object_instances[obj_id] = obj_data;
-        }
+    p_object->fields.write[*field] = p_value;
+    return true;
+}
+
+// Called from NOTIFICATION_PREDELETE of an object this instance created.
+void VisualGasicInstance::release_object(VisualGasicObject *p_object) {
+    live_objects.erase(p_object);
+    if (!object_is_current(p_object) || !p_object->definition->class_terminate) {
+        return;
     }
-    
-    // Restore variable scope
-    variables = saved_vars;
+    p_object->terminating = true;
+    VisualGasicObject *prev_object = current_object;
+    current_object = p_object;
+    run_procedure(p_object->definition->class_terminate, -1, Array());
+    current_object = prev_object;
 }
 
 // Property accessors
@@ -363,283 +374,45 @@ void VisualGasicInstance::call_property_set(const String& prop_name, const Array
     variables = saved_vars;
 }
 
-// FFI / DLL Support
-void* VisualGasicInstance::load_library(const String& lib_name) {
-    // Check if already loaded
-    if (loaded_libraries.has(lib_name)) {
-        return (void*)((int64_t)loaded_libraries[lib_name]);
-    }
-    
-    // Try to load the library
-    String lib_path = lib_name;
-    
-    // On Linux, add .so extension if not present
-    #ifdef __linux__
-        if (!lib_path.ends_with(".so") && !lib_path.ends_with(".so.0")) {
-            // Try common patterns
-            if (!lib_path.begins_with("lib")) {
-                lib_path = "lib" + lib_path;
-            }
-            lib_path += ".so";
-        }
-    #elif defined(_WIN32)
-        if (!lib_path.ends_with(".dll")) {
-            lib_path += ".dll";
-        }
-    #endif
-    
-    void* handle = dlopen(lib_path.utf8().get_data(), RTLD_LAZY);
-    
-    if (!handle) {
-        UtilityFunctions::print("Error loading library '", lib_name, "': ", dlerror());
-        return nullptr;
-    }
-    
-    loaded_libraries[lib_name] = (int64_t)handle;
-    UtilityFunctions::print("Loaded library: ", lib_name);
-    return handle;
-}
-
-void* VisualGasicInstance::get_function_address(void* lib_handle, const String& func_name) {
-    if (!lib_handle) return nullptr;
-    
-    dlerror(); // Clear any existing error
-    void* func_ptr = dlsym(lib_handle, func_name.utf8().get_data());
-    
-    const char* error = dlerror();
-    if (error) {
-        UtilityFunctions::print("Error finding function '", func_name, "': ", error);
-        return nullptr;
-    }
-    
-    return func_ptr;
-}
-
-Variant VisualGasicInstance::call_ffi_function(DeclareStatement* decl, const Array& args) {
-    // Load library if not already loaded
-    void* lib_handle = load_library(decl->lib_name);
-    if (!lib_handle) {
-        UtilityFunctions::print("Error: Could not load library '", decl->lib_name, "'");
+// FFI / DLL Support. The stubs belong to the script (see
+// VisualGasicScript::get_declare_stub), so instances share them.
+Variant VisualGasicInstance::call_ffi_function(int p_declare_index, const Vector<ExpressionNode*>& p_arguments) {
+    ModuleNode* root = script.is_valid() ? script->ast_root : nullptr;
+    if (!root || p_declare_index < 0 || p_declare_index >= root->declares.size()) {
         return Variant();
     }
-    
-    // Get function name (use alias if specified)
-    String func_name = decl->alias_name.is_empty() ? decl->name : decl->alias_name;
-    
-    // Get function pointer
-    void* func_ptr = get_function_address(lib_handle, func_name);
-    if (!func_ptr) {
-        UtilityFunctions::print("Error: Function '", func_name, "' not found in library '", decl->lib_name, "'");
+#if VG_USE_FFI
+    const DeclareStatement* decl = root->declares[p_declare_index];
+    const VisualGasicFFIStub* stub = script->get_declare_stub(p_declare_index);
+    if (!stub) {
+        raise_error("Can't find DLL entry point " + decl->name + " in " + decl->lib_name);
         return Variant();
     }
-    
-    // Validate argument count
-    if (args.size() != decl->param_names.size()) {
-        UtilityFunctions::print("Error: FFI function '", func_name, "' expects ", decl->param_names.size(), 
-                               " arguments, got ", args.size());
+    int count = p_arguments.size();
+    if (count != stub->get_argument_count()) {
+        raise_error("Declare " + decl->name + " expects " + String::num_int64(stub->get_argument_count()) + " arguments, got " + String::num_int64(count));
         return Variant();
     }
-    if (args.size() > 8) {
-        UtilityFunctions::print("FFI: Functions with more than 8 parameters are not supported");
-        return Variant();
-    }
-    
-    // Convert arguments to C types and call the function
-    // We support common VB6 types: Integer (int), Long (int64), Single (float), Double, String, Boolean
-    
-    // For simplicity, we'll use a union-based approach for up to 8 parameters
-    // This works for most VB6 API calls
-    
-    union FFIArg {
-        int32_t i32;
-        int64_t i64;
-        float f32;
-        double f64;
-        const char* str;
-        void* ptr;
-    };
-    
-    FFIArg ffi_args[8];
-    Vector<CharString> string_storage; // Keep strings alive during call
-    
-    for (int i = 0; i < args.size() && i < 8; i++) {
-        String param_type = decl->param_types[i];
-        Variant arg = args[i];
-        
-        if (param_type.nocasecmp_to("Integer") == 0 || param_type.nocasecmp_to("Short") == 0) {
-            ffi_args[i].i32 = (int32_t)arg;
-        } else if (param_type.nocasecmp_to("Long") == 0) {
-            ffi_args[i].i64 = (int64_t)arg;
-        } else if (param_type.nocasecmp_to("Single") == 0) {
-            ffi_args[i].f32 = (float)arg;
-        } else if (param_type.nocasecmp_to("Double") == 0) {
-            ffi_args[i].f64 = (double)arg;
-        } else if (param_type.nocasecmp_to("String") == 0) {
-            String s = arg;
-            string_storage.push_back(s.utf8());
-            ffi_args[i].str = string_storage[string_storage.size() - 1].get_data();
-        } else if (param_type.nocasecmp_to("Boolean") == 0) {
-            ffi_args[i].i32 = (bool)arg ? -1 : 0; // VB6 True = -1
-        } else if (param_type.nocasecmp_to("Any") == 0 || param_type.nocasecmp_to("Ptr") == 0) {
-            ffi_args[i].i64 = (int64_t)arg;
-        } else {
-            // Default to pointer/long
-            ffi_args[i].i64 = (int64_t)arg;
-        }
-    }
-    
-    // Call function based on number of parameters and return type
-    // Using function pointer casting for common signatures
-    
-    Variant result;
-    String ret_type = decl->return_type;
-    
-    // Determine return type handling
-    bool returns_void = ret_type.is_empty() || ret_type.nocasecmp_to("Sub") == 0;
-    bool returns_int = ret_type.nocasecmp_to("Integer") == 0 || ret_type.nocasecmp_to("Long") == 0;
-    bool returns_float = ret_type.nocasecmp_to("Single") == 0;
-    bool returns_double = ret_type.nocasecmp_to("Double") == 0;
-    bool returns_string = ret_type.nocasecmp_to("String") == 0;
-    
-    // Call with appropriate signature based on parameter count
-    switch (args.size()) {
-        case 0: {
-            if (returns_void) {
-                ((void(*)())func_ptr)();
-            } else if (returns_int) {
-                result = (int64_t)((int64_t(*)())func_ptr)();
-            } else if (returns_float) {
-                result = ((float(*)())func_ptr)();
-            } else if (returns_double) {
-                result = ((double(*)())func_ptr)();
-            }
-            break;
-        }
-        case 1: {
-            if (returns_void) {
-                ((void(*)(int64_t))func_ptr)(ffi_args[0].i64);
-            } else if (returns_int) {
-                result = (int64_t)((int64_t(*)(int64_t))func_ptr)(ffi_args[0].i64);
-            } else if (returns_float) {
-                result = ((float(*)(int64_t))func_ptr)(ffi_args[0].i64);
-            } else if (returns_double) {
-                result = ((double(*)(int64_t))func_ptr)(ffi_args[0].i64);
-            }
-            break;
-        }
-        case 2: {
-            if (returns_void) {
-                ((void(*)(int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64);
-            } else if (returns_int) {
-                result = (int64_t)((int64_t(*)(int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64);
-            } else if (returns_float) {
-                result = ((float(*)(int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64);
-            } else if (returns_double) {
-                result = ((double(*)(int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64);
-            } else if (returns_string) {
-                const char* ret = ((const char*(*)(int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64);
-                result = ret ? String(ret) : String();
-            }
-            break;
-        }
-        case 3: {
-            if (returns_void) {
-                ((void(*)(int64_t, int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64, ffi_args[2].i64);
-            } else if (returns_int) {
-                result = (int64_t)((int64_t(*)(int64_t, int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64, ffi_args[2].i64);
-            } else if (returns_float) {
-                result = ((float(*)(int64_t, int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64, ffi_args[2].i64);
-            } else if (returns_double) {
-                result = ((double(*)(int64_t, int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64, ffi_args[2].i64);
-            } else if (returns_string) {
-                const char* ret = ((const char*(*)(int64_t, int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64, ffi_args[2].i64);
-                result = ret ? String(ret) : String();
-            }
-            break;
-        }
-        case 4: {
-            if (returns_void) {
-                ((void(*)(int64_t, int64_t, int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64, ffi_args[2].i64, ffi_args[3].i64);
-            } else if (returns_int) {
-                result = (int64_t)((int64_t(*)(int64_t, int64_t, int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64, ffi_args[2].i64, ffi_args[3].i64);
-            } else if (returns_float) {
-                result = ((float(*)(int64_t, int64_t, int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64, ffi_args[2].i64, ffi_args[3].i64);
-            } else if (returns_double) {
-                result = ((double(*)(int64_t, int64_t, int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64, ffi_args[2].i64, ffi_args[3].i64);
-            } else if (returns_string) {
-                const char* ret = ((const char*(*)(int64_t, int64_t, int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64, ffi_args[2].i64, ffi_args[3].i64);
-                result = ret ? String(ret) : String();
-            }
-            break;
-        }
-        case 5: {
-            if (returns_void) {
-                ((void(*)(int64_t, int64_t, int64_t, int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64, ffi_args[2].i64, ffi_args[3].i64, ffi_args[4].i64);
-            } else if (returns_int) {
-                result = (int64_t)((int64_t(*)(int64_t, int64_t, int64_t, int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64, ffi_args[2].i64, ffi_args[3].i64, ffi_args[4].i64);
-            } else if (returns_float) {
-                result = ((float(*)(int64_t, int64_t, int64_t, int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64, ffi_args[2].i64, ffi_args[3].i64, ffi_args[4].i64);
-            } else if (returns_double) {
-                result = ((double(*)(int64_t, int64_t, int64_t, int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64, ffi_args[2].i64, ffi_args[3].i64, ffi_args[4].i64);
-            } else if (returns_string) {
-                const char* ret = ((const char*(*)(int64_t, int64_t, int64_t, int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64, ffi_args[2].i64, ffi_args[3].i64, ffi_args[4].i64);
-                result = ret ? String(ret) : String();
-            }
-            break;
-        }
-        case 6: {
-            if (returns_void) {
-                ((void(*)(int64_t, int64_t, int64_t, int64_t, int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64, ffi_args[2].i64, ffi_args[3].i64, ffi_args[4].i64, ffi_args[5].i64);
-            } else if (returns_int) {
-                result = (int64_t)((int64_t(*)(int64_t, int64_t, int64_t, int64_t, int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64, ffi_args[2].i64, ffi_args[3].i64, ffi_args[4].i64, ffi_args[5].i64);
-            } else if (returns_float) {
-                result = ((float(*)(int64_t, int64_t, int64_t, int64_t, int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64, ffi_args[2].i64, ffi_args[3].i64, ffi_args[4].i64, ffi_args[5].i64);
-            } else if (returns_double) {
-                result = ((double(*)(int64_t, int64_t, int64_t, int64_t, int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64, ffi_args[2].i64, ffi_args[3].i64, ffi_args[4].i64, ffi_args[5].i64);
-            } else if (returns_string) {
-                const char* ret = ((const char*(*)(int64_t, int64_t, int64_t, int64_t, int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64, ffi_args[2].i64, ffi_args[3].i64, ffi_args[4].i64, ffi_args[5].i64);
-                result = ret ? String(ret) : String();
-            }
-            break;
-        }
-        case 7: {
-            if (returns_void) {
-                ((void(*)(int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64, ffi_args[2].i64, ffi_args[3].i64, ffi_args[4].i64, ffi_args[5].i64, ffi_args[6].i64);
-            } else if (returns_int) {
-                result = (int64_t)((int64_t(*)(int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64, ffi_args[2].i64, ffi_args[3].i64, ffi_args[4].i64, ffi_args[5].i64, ffi_args[6].i64);
-            } else if (returns_float) {
-                result = ((float(*)(int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64, ffi_args[2].i64, ffi_args[3].i64, ffi_args[4].i64, ffi_args[5].i64, ffi_args[6].i64);
-            } else if (returns_double) {
-                result = ((double(*)(int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64, ffi_args[2].i64, ffi_args[3].i64, ffi_args[4].i64, ffi_args[5].i64, ffi_args[6].i64);
-            } else if (returns_string) {
-                const char* ret = ((const char*(*)(int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64, ffi_args[2].i64, ffi_args[3].i64, ffi_args[4].i64, ffi_args[5].i64, ffi_args[6].i64);
-                result = ret ? String(ret) : String();
-            }
-            break;
-        }
-        case 8: {
-            if (returns_void) {
-                ((void(*)(int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64, ffi_args[2].i64, ffi_args[3].i64, ffi_args[4].i64, ffi_args[5].i64, ffi_args[6].i64, ffi_args[7].i64);
-            } else if (returns_int) {
-                result = (int64_t)((int64_t(*)(int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64, ffi_args[2].i64, ffi_args[3].i64, ffi_args[4].i64, ffi_args[5].i64, ffi_args[6].i64, ffi_args[7].i64);
-            } else if (returns_float) {
-                result = ((float(*)(int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64, ffi_args[2].i64, ffi_args[3].i64, ffi_args[4].i64, ffi_args[5].i64, ffi_args[6].i64, ffi_args[7].i64);
-            } else if (returns_double) {
-                result = ((double(*)(int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64, ffi_args[2].i64, ffi_args[3].i64, ffi_args[4].i64, ffi_args[5].i64, ffi_args[6].i64, ffi_args[7].i64);
-            } else if (returns_string) {
-                const char* ret = ((const char*(*)(int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t))func_ptr)(ffi_args[0].i64, ffi_args[1].i64, ffi_args[2].i64, ffi_args[3].i64, ffi_args[4].i64, ffi_args[5].i64, ffi_args[6].i64, ffi_args[7].i64);
-                result = ret ? String(ret) : String();
-            }
-            break;
-        }
-    }
-    
-    return result;
-}
 
-void VisualGasicInstance::register_declare(DeclareStatement* decl) {
-    if (decl && !decl->name.is_empty()) {
-        declared_functions[decl->name] = (int64_t)decl;
-        UtilityFunctions::print("Registered FFI function: ", decl->name, " from ", decl->lib_name);
+    static constexpr int INLINE_ARGS = 16;
+    Variant inline_args[INLINE_ARGS];
+    Vector<Variant> heap_args;
+    Variant* args = inline_args;
+    if (count > INLINE_ARGS) {
+        heap_args.resize(count);
+        args = heap_args.ptrw();
+    }
+    for (int i = 0; i < count; i++) {
+        if (!p_arguments[i]) {
+            raise_error("Incomplete function call: missing argument");
+            return Variant();
+        }
+        args[i] = evaluate_expression(p_arguments[i]);
     }
+    return stub->call(args, count);
+#else
+    // Built without libffi (use_ffi=0).
+    raise_error("Declare not supported on this platform");
+    return Variant();
+#endif
 }
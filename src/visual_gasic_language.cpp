@@ -2,6 +2,7 @@
 #include "visual_gasic_bracket_completion.h"
 #include "visual_gasic_snippets.h"
 #include "visual_gasic_cbm_completion.h"
+#include <godot_cpp/classes/time.hpp>
 #include <godot_cpp/core/class_db.hpp>
 
 using namespace godot;
@@ -27,11 +28,52 @@ VisualGasicLanguage::VisualGasicLanguage() {
 }
 
 VisualGasicLanguage::~VisualGasicLanguage() {
+    clear_validated_modules();
     if (singleton == this) {
         singleton = nullptr;
     }
 }
 
+void VisualGasicLanguage::clear_validated_modules() {
+    std::lock_guard<std::mutex> lock(validated_modules_mutex);
+    for (const KeyValue<String, ModuleNode *> &E : validated_modules) {
+        delete E.value;
+    }
+    validated_modules.clear();
+}
+
+void VisualGasicLanguage::queue_module_cache_save(VisualGasicScript *p_script) {
+    std::lock_guard<std::mutex> lock(pending_module_saves_mutex);
+    pending_module_saves.insert(p_script);
+}
+
+void VisualGasicLanguage::cancel_module_cache_save(VisualGasicScript *p_script) {
+    std::lock_guard<std::mutex> lock(pending_module_saves_mutex);
+    pending_module_saves.erase(p_script);
+}
+
+void VisualGasicLanguage::flush_module_cache_saves(bool p_all) {
+    Vector<VisualGasicScript *> ready;
+    {
+        std::lock_guard<std::mutex> lock(pending_module_saves_mutex);
+        if (pending_module_saves.is_empty()) {
+            return;
+        }
+        uint64_t now = Time::get_singleton()->get_ticks_msec();
+        for (VisualGasicScript *script : pending_module_saves) {
+            if (p_all || now - script->get_module_cache_touched_msec() >= MODULE_CACHE_IDLE_MSEC) {
+                ready.push_back(script);
+            }
+        }
+        for (VisualGasicScript *script : ready) {
+            pending_module_saves.erase(script);
+        }
+    }
+    for (VisualGasicScript *script : ready) {
+        script->flush_module_cache();
+    }
+}
+
 // _bind_methods definition moved below
 
 String VisualGasicLanguage::_get_name() const {
@@ -51,7 +93,8 @@ String VisualGasicLanguage::_get_extension() const {
 }
 
 void VisualGasicLanguage::_finish() {
-    // Cleanup logic
+    flush_module_cache_saves(true);
+    clear_validated_modules();
 }
 
 PackedStringArray VisualGasicLanguage::_get_reserved_words() const {
@@ -182,8 +225,13 @@ Dictionary VisualGasicLanguage::_validate(const String &p_script, const String &
              ((Array)result["errors"]).push_back(err);
              result["valid"] = false;
         } else {
+             std::lock_guard<std::mutex> lock(validated_modules_mutex);
+             ModuleNode *previous = nullptr;
+             if (validated_modules.has(p_path)) {
+                 previous = validated_modules[p_path];
+             }
              VisualGasicParser parser;
-             ModuleNode* root = parser.parse(tokens);
+             ModuleNode* root = parser.parse(tokens, p_script, previous);
              if (parser.errors.size() > 0) {
                  for(int i=0; i<parser.errors.size(); i++) {
                      VisualGasicParser::ParsingError pe = parser.errors[i];
@@ -196,7 +244,12 @@ Dictionary VisualGasicLanguage::_validate(const String &p_script, const String &
                  }
                  result["valid"] = false;
              }
-             if (root) delete root;
+             // A failed parse leaves `previous` intact, so it stays the base
+             // for the next attempt.
+             if (root) {
+                 delete previous;
+                 validated_modules[p_path] = root;
+             }
         }
     }
     return result;
@@ -632,7 +685,7 @@ TypedArray<Dictionary> VisualGasicLanguage::_debug_get_current_stack_info() {
 }
 
 void VisualGasicLanguage::_frame() {
-    // Called every frame
+    flush_module_cache_saves(false);
 }
 
 Dictionary VisualGasicLanguage::_debug_get_globals(int32_t p_max_subitems, int32_t p_max_depth) {
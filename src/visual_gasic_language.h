@@ -2,8 +2,12 @@
 #define VISUAL_GASIC_LANGUAGE_H
 
 #include <godot_cpp/classes/script_language_extension.hpp>
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/hash_set.hpp>
 #include "visual_gasic_script.h"
 
+#include <mutex>
+
 using namespace godot;
 
 class VisualGasicLanguage : public ScriptLanguageExtension {
@@ -11,6 +15,22 @@ class VisualGasicLanguage : public ScriptLanguageExtension {
 
     static VisualGasicLanguage *singleton;
 
+    // Last module of each script path that validated without errors. The
+    // editor validates on every edit; parsing against it only re-parses the
+    // Subs that changed since.
+    mutable HashMap<String, ModuleNode *> validated_modules;
+    mutable std::mutex validated_modules_mutex;
+    void clear_validated_modules();
+
+    // Scripts whose bytecode module has Subs not written to disk yet. _frame
+    // writes a module once none of its Subs has compiled for
+    // MODULE_CACHE_IDLE_MSEC, so a warming-up game writes each file once
+    // instead of on every first call.
+    static constexpr uint64_t MODULE_CACHE_IDLE_MSEC = 2000;
+    HashSet<VisualGasicScript *> pending_module_saves;
+    std::mutex pending_module_saves_mutex;
+    void flush_module_cache_saves(bool p_all);
+
 protected:
 	static void _bind_methods();
 
@@ -19,6 +39,9 @@ public:
 
     static VisualGasicLanguage *get_singleton();
 
+    void queue_module_cache_save(VisualGasicScript *p_script);
+    void cancel_module_cache_save(VisualGasicScript *p_script);
+
     VisualGasicLanguage();
     ~VisualGasicLanguage();
 
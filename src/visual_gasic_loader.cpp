@@ -35,6 +35,7 @@ Variant VisualGasicFormatLoader::_load(const String &p_path, const String &p_ori
 
 	String source = f->get_as_text();
 	script->set_source_code(source);
+	script->set_source_path(p_original_path.is_empty() ? p_path : p_original_path);
 	f->close();
 
 	// Reload with error handling to prevent crashes from malformed code
@@ -0,0 +1,20 @@
+#include "visual_gasic_object.h"
+#include "visual_gasic_instance.h"
+
+void VisualGasicObject::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("get_vb_class_name"), &VisualGasicObject::get_vb_class_name);
+}
+
+void VisualGasicObject::_notification(int p_what) {
+    if (p_what == NOTIFICATION_PREDELETE && instance) {
+        instance->release_object(this);
+    }
+}
+
+bool VisualGasicObject::_get(const StringName &p_name, Variant &r_ret) const {
+    return instance && instance->get_object_member(this, p_name, r_ret);
+}
+
+bool VisualGasicObject::_set(const StringName &p_name, const Variant &p_value) {
+    return instance && instance->set_object_member(this, p_name, p_value);
+}
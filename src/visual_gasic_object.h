@@ -0,0 +1,43 @@
+#ifndef VISUAL_GASIC_OBJECT_H
+#define VISUAL_GASIC_OBJECT_H
+
+#include "visual_gasic_ast.h"
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/core/class_db.hpp>
+
+using namespace godot;
+using namespace VisualGasic;
+
+class VisualGasicInstance;
+
+// An instance of a VisualGasic Class (New ClassName). Fields live in one
+// Variant array laid out by ClassDefinition::members, and the object is
+// reference counted like any Godot RefCounted: when the last reference goes
+// away, the owning script instance runs Class_Terminate.
+//
+// `definition` points into the module that created the object; it is only
+// dereferenced while `generation` still matches that module's
+// bind_generation (see VisualGasicInstance::object_is_current).
+class VisualGasicObject : public RefCounted {
+    GDCLASS(VisualGasicObject, RefCounted);
+    friend class VisualGasicInstance;
+
+    VisualGasicInstance *instance = nullptr; // Cleared when the script instance is destroyed
+    const ClassDefinition *definition = nullptr;
+    uint64_t generation = 0;
+    String class_name; // For messages once `definition` is stale
+    Vector<Variant> fields;
+    bool terminating = false; // Class_Terminate is running; Me is Nothing
+
+protected:
+    static void _bind_methods();
+    void _notification(int p_what);
+    // Field access from GDScript and the bytecode VM (OP_GET_MEMBER/OP_SET_MEMBER).
+    bool _get(const StringName &p_name, Variant &r_ret) const;
+    bool _set(const StringName &p_name, const Variant &p_value);
+
+public:
+    String get_vb_class_name() const { return class_name; }
+};
+
+#endif // VISUAL_GASIC_OBJECT_H
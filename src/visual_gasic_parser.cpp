@@ -1,4 +1,5 @@
 #include "visual_gasic_parser.h"
+#include "visual_gasic_source_hash.h"
 #include <godot_cpp/variant/utility_functions.hpp>
 #include <godot_cpp/classes/file_access.hpp>
 #include <stdio.h>
@@ -7,32 +8,26 @@ VisualGasicParser::VisualGasicParser() : current_pos(0), error_count(0) {
 }
 
 VisualGasicParser::~VisualGasicParser() {
-    // Free any parser-owned nodes that were not transferred to the
-    // returned ModuleNode (i.e. parse failure paths that left
-    // temporary allocations).
-    for (int i = 0; i < allocated_nodes.size(); i++) {
-        if (allocated_nodes[i]) delete allocated_nodes[i];
-    }
-    allocated_nodes.clear();
+}
 
-    for (int i = 0; i < allocated_expr_nodes.size(); i++) {
-        if (allocated_expr_nodes[i]) delete allocated_expr_nodes[i];
-    }
-    allocated_expr_nodes.clear();
+// Token accessors return references into `tokens`, which stays unchanged
+// for the whole parse; past the end they return a shared EOF token.
+static const VisualGasicTokenizer::Token &eof_token() {
+    static const VisualGasicTokenizer::Token eof = { VisualGasicTokenizer::TOKEN_EOF, Variant(), 0, 0 };
+    return eof;
 }
 
-VisualGasicTokenizer::Token VisualGasicParser::peek(int offset) {
-    if (current_pos + offset >= tokens.size()) {
-        VisualGasicTokenizer::Token t;
-        t.type = VisualGasicTokenizer::TOKEN_EOF;
-        return t;
+const VisualGasicTokenizer::Token &VisualGasicParser::peek(int offset) const {
+    int index = current_pos + offset;
+    if (index < 0 || index >= tokens.size()) {
+        return eof_token();
     }
-    return tokens[current_pos + offset];
+    return tokens.ptr()[index];
 }
 
-VisualGasicTokenizer::Token VisualGasicParser::advance() {
+const VisualGasicTokenizer::Token &VisualGasicParser::advance() {
     if (!is_at_end()) current_pos++;
-    if (current_pos > 0 && current_pos <= tokens.size()) return tokens[current_pos - 1];
+    if (current_pos > 0 && current_pos <= tokens.size()) return tokens.ptr()[current_pos - 1];
     return peek();
 }
 
@@ -44,24 +39,23 @@ bool VisualGasicParser::match(VisualGasicTokenizer::TokenType type) {
     return false;
 }
 
-bool VisualGasicParser::check(VisualGasicTokenizer::TokenType type) {
+bool VisualGasicParser::check(VisualGasicTokenizer::TokenType type) const {
     if (is_at_end()) return false;
     return peek().type == type;
 }
 
-bool VisualGasicParser::is_at_end() {
+bool VisualGasicParser::is_at_end() const {
     return peek().type == VisualGasicTokenizer::TOKEN_EOF;
 }
 
-// Helper needed because I used 'previous' in advance but didn't define it
-VisualGasicTokenizer::Token VisualGasicParser::previous() {
-    if (current_pos > 0) return tokens[current_pos - 1];
-    return VisualGasicTokenizer::Token();
+const VisualGasicTokenizer::Token &VisualGasicParser::previous() const {
+    if (current_pos > 0) return tokens.ptr()[current_pos - 1];
+    return eof_token();
 }
 
 void VisualGasicParser::error(const String& message) {
     ParsingError err;
-    VisualGasicTokenizer::Token t = peek();
+    const VisualGasicTokenizer::Token &t = peek();
     err.line = t.line;
     err.column = t.column;
     err.message = message;
@@ -75,8 +69,52 @@ void VisualGasicParser::error(const String& message) {
     }
 }
 
+// Hash of the source text covered by tokens [p_first, p_end).
+uint64_t VisualGasicParser::hash_span(int p_first, int p_end, uint64_t p_seed) const {
+    if (p_first >= p_end) {
+        return p_seed;
+    }
+    const VisualGasicTokenizer::Token &first = tokens.ptr()[p_first];
+    const VisualGasicTokenizer::Token &last = tokens.ptr()[p_end - 1];
+    int length = last.offset + last.length - first.offset;
+    return SourceHash::compute_bytes(source + first.offset, (size_t)length * sizeof(char32_t), p_seed);
+}
+
+// Hash of the tokens [p_first, p_end) one by one, ignoring newlines and
+// comments, so blank lines between declarations do not count as edits.
+uint64_t VisualGasicParser::hash_tokens(int p_first, int p_end, uint64_t p_seed) const {
+    uint64_t h = p_seed;
+    for (int i = p_first; i < p_end; i++) {
+        const VisualGasicTokenizer::Token &t = tokens.ptr()[i];
+        if (t.type == VisualGasicTokenizer::TOKEN_NEWLINE || t.type == VisualGasicTokenizer::TOKEN_COMMENT || t.type == VisualGasicTokenizer::TOKEN_EOF) {
+            continue;
+        }
+        h = SourceHash::compute_bytes(source + t.offset, (size_t)t.length * sizeof(char32_t), h ^ (uint64_t)t.type);
+    }
+    return h;
+}
+
+// Token index just past the 'End Sub'/'End Function' closing the declaration
+// at p_start, found without parsing; -1 if there is none. It can stop short of
+// where parse_sub() would (an 'End Sub' inside a statement), but then its text
+// matches no recorded declaration and the Sub is simply parsed.
+int VisualGasicParser::find_sub_end(int p_start) const {
+    bool is_function = String(tokens[p_start].value).nocasecmp_to("Function") == 0;
+    const VisualGasicTokenizer::Token *t = tokens.ptr();
+    for (int i = p_start + 1; i + 1 < tokens.size(); i++) {
+        if (t[i].length != 3 || (t[i].type != VisualGasicTokenizer::TOKEN_IDENTIFIER && t[i].type != VisualGasicTokenizer::TOKEN_KEYWORD) || t[i].value != "End") {
+            continue;
+        }
+        String end_type = t[i + 1].value;
+        if ((is_function && end_type == "Function") || (!is_function && end_type == "Sub")) {
+            return i + 2;
+        }
+    }
+    return -1;
+}
+
 // Reimplementing correct logic
-ModuleNode* VisualGasicParser::parse(const Vector<VisualGasicTokenizer::Token>& p_tokens) {
+ModuleNode* VisualGasicParser::parse(const Vector<VisualGasicTokenizer::Token>& p_tokens, const String& p_source, ModuleNode* p_previous) {
     tokens = p_tokens;
     errors.clear();
     error_count = 0;
@@ -84,9 +122,33 @@ ModuleNode* VisualGasicParser::parse(const Vector<VisualGasicTokenizer::Token>&
     
     ModuleNode* module = new ModuleNode();
     current_module = module;
+    arena = &module->arena;
+
+    // Declarations of p_previous by text hash. Each reparse leaves replaced
+    // nodes and a partly used chunk behind; once p_previous's arena holds more
+    // of those than live nodes (plus a few chunks of slack), nothing is reused
+    // so the arena starts over compact.
+    source = p_source.is_empty() ? nullptr : p_source.ptr();
+    HashMap<uint64_t, int> previous_by_hash;
+    Vector<bool> previous_used;
+    size_t previous_live = p_previous ? p_previous->arena.get_bytes_allocated() - p_previous->stale_bytes : 0;
+    if (source && p_previous && p_previous->declarations.size() == p_previous->subs.size() &&
+            p_previous->arena.get_bytes_reserved() - previous_live <= previous_live + 4 * ASTArena::CHUNK_SIZE) {
+        for (int i = 0; i < p_previous->declarations.size(); i++) {
+            if (!previous_by_hash.has(p_previous->declarations[i].text_hash)) {
+                previous_by_hash.insert(p_previous->declarations[i].text_hash, i);
+            }
+        }
+        previous_used.resize(p_previous->declarations.size());
+        previous_used.fill(false);
+    }
+    uint64_t context_hash = 0;
+    int context_from = 0; // First module-level token not yet in context_hash
+    int reused_count = 0;
+    size_t reused_bytes = 0;
 
         while (!is_at_end() && error_count < MAX_ERRORS) {
-        VisualGasicTokenizer::Token t = peek();
+        const VisualGasicTokenizer::Token &t = peek();
         
         if (t.type == VisualGasicTokenizer::TOKEN_NEWLINE) {
             current_pos++; // Skip top level newlines
@@ -125,17 +187,66 @@ ModuleNode* VisualGasicParser::parse(const Vector<VisualGasicTokenizer::Token>&
             // parse_event is defined above parse_statement now, but we need to declare it in the class or just add it to ModuleNode
             if (evt) {
                 module->events.push_back(evt);
-                unregister_node(evt);
             }
             continue;
         }
 
         if ((t.type == VisualGasicTokenizer::TOKEN_IDENTIFIER || t.type == VisualGasicTokenizer::TOKEN_KEYWORD) && (t.value == "Sub" || t.value == "Function")) {
-            SubDefinition* sub = parse_sub();
-            if (sub) {
-                module->subs.push_back(sub);
-                unregister_node(sub);
+            if (!source) {
+                SubDefinition* sub = parse_sub();
+                if (sub) {
+                    module->subs.push_back(sub);
+                }
+                continue;
+            }
+
+            int sub_start = current_pos;
+            context_hash = hash_tokens(context_from, sub_start, context_hash);
+            DeclarationInfo decl;
+
+            // Reuse the previous parse when the text and what precedes it match.
+            if (!previous_by_hash.is_empty()) {
+                int end = find_sub_end(sub_start);
+                const int *found = end > 0 ? previous_by_hash.getptr(hash_span(sub_start, end)) : nullptr;
+                if (found && !previous_used[*found] && p_previous->declarations[*found].context_hash == context_hash) {
+                    decl = p_previous->declarations[*found];
+                    decl.first_token = sub_start;
+                    decl.end_token = end;
+                    decl.previous_index = *found;
+                    previous_used.write[*found] = true;
+                    reused_count++;
+                    reused_bytes += decl.arena_bytes;
+                    module->enums.append_array(decl.enums);
+                    current_pos = end;
+                }
             }
+
+            if (!decl.sub) {
+                size_t bytes_before = arena->get_bytes_allocated();
+                int enums_before = module->enums.size();
+                decl.sub = parse_sub();
+                if (!decl.sub) {
+                    context_from = current_pos;
+                    continue;
+                }
+                decl.text_hash = hash_span(sub_start, current_pos);
+                decl.context_hash = context_hash;
+                decl.first_token = sub_start;
+                decl.end_token = current_pos;
+                for (int i = enums_before; i < module->enums.size(); i++) {
+                    decl.enums.push_back(module->enums[i]);
+                }
+                decl.arena_bytes = arena->get_bytes_allocated() - bytes_before;
+            }
+
+            int signature_end = decl.first_token;
+            while (signature_end < decl.end_token && tokens.ptr()[signature_end].type != VisualGasicTokenizer::TOKEN_NEWLINE) {
+                signature_end++;
+            }
+            decl.signature_hash = hash_tokens(decl.first_token, signature_end, 0);
+            module->subs.push_back(decl.sub);
+            module->declarations.push_back(decl);
+            context_from = current_pos;
             continue;
         }
 
@@ -143,18 +254,41 @@ ModuleNode* VisualGasicParser::parse(const Vector<VisualGasicTokenizer::Token>&
             StructDefinition* def = parse_struct();
             if (def) {
                 module->structs.push_back(def);
-                unregister_node(def);
             }
             continue;
         }
 
-        // Variable Declaration (Dim, Public, Private)
+        // Class Name ... End Class and Declare, optionally after Public/Private
         String val = String(t.value).to_lower();
+        bool visibility_modifier = t.type == VisualGasicTokenizer::TOKEN_KEYWORD && (val == "public" || val == "private");
+        if (is_class_start(visibility_modifier ? 1 : 0)) {
+            if (visibility_modifier) {
+                advance();
+            }
+            ClassDefinition* cls = parse_class();
+            if (cls) {
+                cls->is_public = val != "private";
+                module->classes.push_back(cls);
+            }
+            continue;
+        }
+        if (is_declare_start(visibility_modifier ? 1 : 0)) {
+            if (visibility_modifier) {
+                advance();
+            }
+            DeclareStatement* decl = parse_declare();
+            if (decl) {
+                module->declares.push_back(decl);
+            }
+            continue;
+        }
+
+        // Variable Declaration (Dim, Public, Private)
         if (t.type == VisualGasicTokenizer::TOKEN_KEYWORD && (val == "public" || val == "private" || val == "dim")) {
             // Parse DimStatement logic but store as global VariableDefinition
              DimStatement* dim = parse_dim(); // Reuse parse_dim which handles Dim A As Integer
              if (dim) {
-                 VariableDefinition* v = static_cast<VariableDefinition*>(register_node(new VariableDefinition()));
+                 VariableDefinition* v = make<VariableDefinition>();
                  v->name = dim->variable_name;
                  v->type = dim->type_name; // can be empty
                  v->visibility = (val == "public") ? VIS_PUBLIC : (val == "private" ? VIS_PRIVATE : VIS_DIM);
@@ -170,9 +304,6 @@ ModuleNode* VisualGasicParser::parse(const Vector<VisualGasicTokenizer::Token>&
                  }
                  
                  module->variables.push_back(v);
-                 unregister_node(v);
-                        unregister_node(dim);
-                        delete dim; // Don't need the statement wrapper
              }
              continue;
         }
@@ -207,7 +338,6 @@ ModuleNode* VisualGasicParser::parse(const Vector<VisualGasicTokenizer::Token>&
              ConstStatement* c = parse_const();
              if (c) {
                  module->constants.push_back(c);
-                 unregister_node(c);
                  // Keep the ConstStatement wrapper as it holds the value expression
              }
              continue;
@@ -220,7 +350,6 @@ ModuleNode* VisualGasicParser::parse(const Vector<VisualGasicTokenizer::Token>&
             Statement* s = parse_data_file();
             if (s) {
                 module->global_statements.push_back(s);
-                unregister_node(s);
             }
             continue;
         }
@@ -231,8 +360,6 @@ ModuleNode* VisualGasicParser::parse(const Vector<VisualGasicTokenizer::Token>&
             if (s && s->type == STMT_DATA || (s && s->type == STMT_LABEL)) {
                 module->global_statements.push_back(s);
             } else if (s) {
-                unregister_node(s);
-                delete s;
                 error("Only Data and Labels are allowed at module level.");
             }
             continue;
@@ -243,73 +370,38 @@ ModuleNode* VisualGasicParser::parse(const Vector<VisualGasicTokenizer::Token>&
     }
 
     // If parsing recorded errors, free the partially-built AST and
-    // return nullptr so callers know parsing failed. This ensures the
-    // parser is responsible for cleanup on failure and avoids leaving
-    // dangling allocations for higher layers to clean.
+    // return nullptr so callers know parsing failed. Every node,
+    // including ones dropped on error paths, lives in the module's
+    // arena, so deleting the module frees them all.
+    arena = nullptr;
     if (errors.size() > 0) {
         delete module;
-        // Delete any parser-owned nodes that weren't transferred
-        for (int i = 0; i < allocated_nodes.size(); i++) if (allocated_nodes[i]) delete allocated_nodes[i];
-        allocated_nodes.clear();
-        for (int i = 0; i < allocated_expr_nodes.size(); i++) if (allocated_expr_nodes[i]) delete allocated_expr_nodes[i];
-        allocated_expr_nodes.clear();
+        current_module = nullptr;
+        source = nullptr;
         return nullptr;
     }
 
-    // Successful parse: ownership of AST nodes should now belong to
-    // the ModuleNode and its sub-structures. Clear the allocated_nodes
-    // tracker without deleting to avoid double-free.
-    allocated_nodes.clear();
-    allocated_expr_nodes.clear();
-
-    return module;
-}
-
-ASTNode* VisualGasicParser::register_node(ASTNode* p_node) {
-    if (p_node) {
-        allocated_nodes.push_back(p_node);
-        // parser registration (silenced in normal runs)
-    }
-    return p_node;
-}
-
-void VisualGasicParser::unregister_node(ASTNode* p_node) {
-    if (!p_node) return;
-    for (int i = 0; i < allocated_nodes.size(); i++) {
-        if (allocated_nodes[i] == p_node) {
-            allocated_nodes.remove_at(i);
-            // parser unregister (silenced in normal runs)
-            return;
+    if (source) {
+        uint64_t interface_hash = hash_tokens(context_from, tokens.size(), context_hash);
+        for (int i = 0; i < module->declarations.size(); i++) {
+            uint64_t signature = module->declarations[i].signature_hash;
+            interface_hash = SourceHash::compute_bytes(&signature, sizeof(signature), interface_hash);
         }
+        module->interface_hash = interface_hash;
+        source = nullptr;
     }
-}
 
-ExpressionNode* VisualGasicParser::register_node(ExpressionNode* p_node) {
-    if (p_node) {
-        allocated_expr_nodes.push_back(p_node);
-        // expression registration (silenced in normal runs)
+    // Reused nodes live in p_previous's arena; everything else in it is stale.
+    if (reused_count > 0) {
+        module->stale_bytes = p_previous->arena.get_bytes_allocated() - reused_bytes;
+        module->arena.adopt(p_previous->arena);
     }
-    return p_node;
-}
 
-void VisualGasicParser::unregister_node(ExpressionNode* p_node) {
-    if (!p_node) return;
-    for (int i = 0; i < allocated_expr_nodes.size(); i++) {
-        if (allocated_expr_nodes[i] == p_node) {
-            allocated_expr_nodes.remove_at(i);
-            // expression unregister (silenced in normal runs)
-            return;
-        }
-    }
-}
-
-void VisualGasicParser::clear_tracked_nodes() {
-    allocated_nodes.clear();
-    allocated_expr_nodes.clear();
+    return module;
 }
 
 SubDefinition* VisualGasicParser::parse_sub() {
-    VisualGasicTokenizer::Token start_token = peek();
+    const VisualGasicTokenizer::Token &start_token = peek();
     bool is_function = (String(start_token.value).nocasecmp_to("Function") == 0);
     current_pos++; // Eat Sub or Function
 
@@ -381,7 +473,6 @@ SubDefinition* VisualGasicParser::parse_sub() {
                              // usually requires constant folding.
                              // We'll leave as NIL if not literal.
                          }
-                         if (expr) { unregister_node(expr); delete expr; }
                      }
 
                      parameters.push_back(param);
@@ -413,17 +504,17 @@ SubDefinition* VisualGasicParser::parse_sub() {
           current_pos++;
     }
 
-    SubDefinition* sub = static_cast<SubDefinition*>(register_node(new SubDefinition()));
+    SubDefinition* sub = make<SubDefinition>();
     sub->name = name;
     sub->type = is_function ? SubDefinition::TYPE_FUNCTION : SubDefinition::TYPE_SUB;
     sub->parameters = parameters;
 
     // Body
     while (!is_at_end() && error_count < MAX_ERRORS) {
-        VisualGasicTokenizer::Token t = peek();
+        const VisualGasicTokenizer::Token &t = peek();
 
         if ((t.type == VisualGasicTokenizer::TOKEN_IDENTIFIER || t.type == VisualGasicTokenizer::TOKEN_KEYWORD) && t.value == "End") {
-           VisualGasicTokenizer::Token next = peek(1);
+           const VisualGasicTokenizer::Token &next = peek(1);
            String end_type = next.value;
            
            if ((is_function && end_type == "Function") || (!is_function && end_type == "Sub")) {
@@ -435,7 +526,6 @@ SubDefinition* VisualGasicParser::parse_sub() {
         Statement* stmt = parse_statement();
         if (stmt) {
             sub->statements.push_back(stmt);
-            unregister_node(stmt);
         } else {
             current_pos++; // Skip unknown token to avoid infinite loop
         }
@@ -446,7 +536,7 @@ SubDefinition* VisualGasicParser::parse_sub() {
 
 // Helper declaration
 RaiseEventStatement* VisualGasicParser::parse_raise_event() {
-    RaiseEventStatement* stmt = static_cast<RaiseEventStatement*>(register_node(new RaiseEventStatement()));
+    RaiseEventStatement* stmt = make<RaiseEventStatement>();
     
     if (!check(VisualGasicTokenizer::TOKEN_IDENTIFIER)) {
         error("Expected event name after RaiseEvent");
@@ -463,7 +553,6 @@ RaiseEventStatement* VisualGasicParser::parse_raise_event() {
                  ExpressionNode* arg = parse_expression();
                  if (arg) {
                      stmt->arguments.push_back(arg);
-                     unregister_node(arg);
                  }
                 
                  if (check(VisualGasicTokenizer::TOKEN_COMMA)) {
@@ -487,7 +576,7 @@ EventDefinition* VisualGasicParser::parse_event() {
         return nullptr;
     }
     
-    EventDefinition* evt = static_cast<EventDefinition*>(register_node(new EventDefinition()));
+    EventDefinition* evt = make<EventDefinition>();
     evt->name = advance().value;
     
     if (check(VisualGasicTokenizer::TOKEN_PAREN_OPEN)) {
@@ -536,7 +625,7 @@ Statement* VisualGasicParser::parse_statement() {
         return nullptr;
     }
     
-    VisualGasicTokenizer::Token t = peek();
+    const VisualGasicTokenizer::Token &t = peek();
     // UtilityFunctions::print("ParseStmt Token: ", t.value, " Type: ", t.type);
 
     if (t.type == VisualGasicTokenizer::TOKEN_COMMENT) {
@@ -582,11 +671,11 @@ Statement* VisualGasicParser::parse_statement() {
         if (val == "const") return parse_const();
         if (val == "pass") {
             advance();
-            return static_cast<PassStatement*>(register_node(new PassStatement()));
+            return make<PassStatement>();
         }
         if (val == "doevents") {
             advance();
-            return static_cast<DoEventsStatement*>(register_node(new DoEventsStatement()));
+            return make<DoEventsStatement>();
         }
         if (val == "data") return parse_data();
         if (val == "datafile") return parse_data_file();
@@ -691,12 +780,17 @@ Statement* VisualGasicParser::parse_statement() {
             return parse_assignment_or_call();
         }
     }
+    // Get and Put are not reserved words; the # marks the statement.
+    if (t.type == VisualGasicTokenizer::TOKEN_IDENTIFIER && (val == "get" || val == "put") &&
+            peek(1).type == VisualGasicTokenizer::TOKEN_OPERATOR && peek(1).value == "#") {
+        return parse_file_record(val == "put");
+    }
     if (val == "goto") {
         advance();
         if (check(VisualGasicTokenizer::TOKEN_IDENTIFIER)) {
             String label = peek().value;
             advance();
-            GotoStatement* g = static_cast<GotoStatement*>(register_node(new GotoStatement()));
+            GotoStatement* g = make<GotoStatement>();
             g->label_name = label;
             return g;
         }
@@ -716,7 +810,7 @@ Statement* VisualGasicParser::parse_statement() {
                  advance();
                  if (String(peek().value).nocasecmp_to("Next") == 0) {
                      advance();
-                     OnErrorStatement* s = static_cast<OnErrorStatement*>(register_node(new OnErrorStatement()));
+                     OnErrorStatement* s = make<OnErrorStatement>();
                      s->mode = OnErrorStatement::RESUME_NEXT;
                      return s;
                  }
@@ -725,7 +819,7 @@ Statement* VisualGasicParser::parse_statement() {
                  if (check(VisualGasicTokenizer::TOKEN_IDENTIFIER)) {
                      String label = peek().value;
                      advance();
-                     OnErrorStatement* s = static_cast<OnErrorStatement*>(register_node(new OnErrorStatement()));
+                     OnErrorStatement* s = make<OnErrorStatement>();
                      s->mode = OnErrorStatement::GOTO_LABEL;
                      s->label_name = label;
                      return s;
@@ -737,7 +831,7 @@ Statement* VisualGasicParser::parse_statement() {
                            // Treated as disable, or empty label?
                            // For now, let's just ignore or treat as disable.
                            // Actually, we can make it a specific mode or empty label.
-                           OnErrorStatement* s = static_cast<OnErrorStatement*>(register_node(new OnErrorStatement()));
+                           OnErrorStatement* s = make<OnErrorStatement>();
                            s->mode = OnErrorStatement::GOTO_LABEL;
                            s->label_name = ""; // Empty label means disable
                            return s;
@@ -751,10 +845,10 @@ Statement* VisualGasicParser::parse_statement() {
         advance();
         ExpressionNode* target = nullptr;
         if (check(VisualGasicTokenizer::TOKEN_KEYWORD) && String(peek().value).nocasecmp_to("Me") == 0) {
-            target = static_cast<ExpressionNode*>(register_node(new ExpressionNode())); target->type = ExpressionNode::ME;
+            target = make<ExpressionNode>(); target->type = ExpressionNode::ME;
             advance();
         } else if (check(VisualGasicTokenizer::TOKEN_IDENTIFIER)) {
-            VariableNode* v = static_cast<VariableNode*>(register_node(new VariableNode())); v->name = peek().value;
+            VariableNode* v = make<VariableNode>(); v->name = peek().value;
             target = v;
             advance();
         } else { return nullptr; }
@@ -762,7 +856,7 @@ Statement* VisualGasicParser::parse_statement() {
         while(check(VisualGasicTokenizer::TOKEN_OPERATOR) && peek().value == ".") {
             advance();
             if (check(VisualGasicTokenizer::TOKEN_IDENTIFIER) || check(VisualGasicTokenizer::TOKEN_KEYWORD)) {
-                MemberAccessNode* ma = static_cast<MemberAccessNode*>(register_node(new MemberAccessNode())); ma->base_object = target;
+                MemberAccessNode* ma = make<MemberAccessNode>(); ma->base_object = target;
                 ma->member_name = peek().value;
                 target = ma;
                 advance();
@@ -772,7 +866,7 @@ Statement* VisualGasicParser::parse_statement() {
         // Allow parens: Call Method(Args)
         bool has_parens = false;
         // Check for LPAREN
-        VisualGasicTokenizer::Token next_t = peek();
+        const VisualGasicTokenizer::Token &next_t = peek();
         if (next_t.type == VisualGasicTokenizer::TOKEN_PAREN_OPEN) {
             advance(); 
             has_parens = true;
@@ -789,7 +883,6 @@ Statement* VisualGasicParser::parse_statement() {
                      ExpressionNode* _tmp = parse_expression();
                      if (_tmp) {
                          args.push_back(_tmp);
-                         unregister_node(_tmp);
                      }
                  }
                  if (check(VisualGasicTokenizer::TOKEN_COMMA)) {
@@ -808,16 +901,15 @@ Statement* VisualGasicParser::parse_statement() {
              }
         }
         
-        CallStatement* call_stmt = static_cast<CallStatement*>(register_node(new CallStatement()));
+        CallStatement* call_stmt = make<CallStatement>();
         if (target->type == ExpressionNode::MEMBER_ACCESS) {
             MemberAccessNode* ma = (MemberAccessNode*)target;
             call_stmt->base_object = ma->base_object;
             call_stmt->method_name = ma->member_name;
-            ma->base_object = nullptr; unregister_node(ma); delete ma;
+            ma->base_object = nullptr;
         } else if (target->type == ExpressionNode::VARIABLE) {
             call_stmt->method_name = ((VariableNode*)target)->name;
-            unregister_node(target); delete target;
-        } else { unregister_node(target); delete target; unregister_node(call_stmt); delete call_stmt; return nullptr; }
+        } else { return nullptr; }
 
         call_stmt->arguments = args;
         return call_stmt;
@@ -829,7 +921,7 @@ Statement* VisualGasicParser::parse_statement() {
             String label_name = t.value;
             advance(); // Identifier
             advance(); // Colon
-            LabelStatement* l = static_cast<LabelStatement*>(register_node(new LabelStatement()));
+            LabelStatement* l = make<LabelStatement>();
             l->name = label_name;
             return l;
         }
@@ -869,7 +961,7 @@ ExpressionNode* VisualGasicParser::parse_expression() {
             ExpressionNode* false_part = parse_expression(); // Recursive
             
             // Build IIfNode (Reuse IIfNode structure)
-            IIfNode* iif = static_cast<IIfNode*>(register_node(new IIfNode()));
+            IIfNode* iif = make<IIfNode>();
             iif->condition = cond;
             iif->true_part = expr;
             iif->false_part = false_part;
@@ -889,15 +981,9 @@ ExpressionNode* VisualGasicParser::parse_logical_or() {
         if (op.nocasecmp_to("Or") == 0 || op.nocasecmp_to("Xor") == 0 || op.nocasecmp_to("OrElse") == 0) {
             advance();
             ExpressionNode* right = parse_and();
-            BinaryOpNode* bin = static_cast<BinaryOpNode*>(register_node(new BinaryOpNode()));
-            if (expr) {
-                ExpressionNode* ldup = expr->duplicate();
-                if (ldup) bin->left = register_node(ldup); else bin->left = expr;
-            } else bin->left = nullptr;
-            if (right) {
-                ExpressionNode* rdup = right->duplicate();
-                if (rdup) bin->right = register_node(rdup); else bin->right = right;
-            } else bin->right = nullptr;
+            BinaryOpNode* bin = make<BinaryOpNode>();
+            bin->left = expr;
+            bin->right = right;
             bin->op = op;
             expr = bin;
         } else {
@@ -914,15 +1000,9 @@ ExpressionNode* VisualGasicParser::parse_and() {
         if (op.nocasecmp_to("And") == 0 || op.nocasecmp_to("AndAlso") == 0) {
             advance();
             ExpressionNode* right = parse_not();
-            BinaryOpNode* bin = static_cast<BinaryOpNode*>(register_node(new BinaryOpNode()));
-            if (expr) {
-                ExpressionNode* ldup = expr->duplicate();
-                if (ldup) bin->left = register_node(ldup); else bin->left = expr;
-            } else bin->left = nullptr;
-            if (right) {
-                ExpressionNode* rdup = right->duplicate();
-                if (rdup) bin->right = register_node(rdup); else bin->right = right;
-            } else bin->right = nullptr;
+            BinaryOpNode* bin = make<BinaryOpNode>();
+            bin->left = expr;
+            bin->right = right;
             bin->op = op;
             expr = bin;
         } else {
@@ -937,12 +1017,9 @@ ExpressionNode* VisualGasicParser::parse_not() {
         String op = String(peek().value);
         advance();
         ExpressionNode* operand = parse_not();
-        UnaryOpNode* unary = static_cast<UnaryOpNode*>(register_node(new UnaryOpNode()));
+        UnaryOpNode* unary = make<UnaryOpNode>();
         unary->op = op;
-        if (operand) {
-            ExpressionNode* odup = operand->duplicate();
-            if (odup) unary->operand = register_node(odup); else unary->operand = operand;
-        } else unary->operand = nullptr;
+        unary->operand = operand;
         return unary;
     }
     return parse_comparison();
@@ -958,15 +1035,9 @@ ExpressionNode* VisualGasicParser::parse_comparison() {
             if (op == "=" || op == "<" || op == ">" || op == "<=" || op == ">=" || op == "<>" || op == "!=") {
                 advance();
                 ExpressionNode* right = parse_addition();
-                BinaryOpNode* bin = static_cast<BinaryOpNode*>(register_node(new BinaryOpNode()));
-                if (expr) {
-                    ExpressionNode* ldup = expr->duplicate();
-                    if (ldup) bin->left = register_node(ldup); else bin->left = expr;
-                } else bin->left = nullptr;
-                if (right) {
-                    ExpressionNode* rdup = right->duplicate();
-                    if (rdup) bin->right = register_node(rdup); else bin->right = right;
-                } else bin->right = nullptr;
+                BinaryOpNode* bin = make<BinaryOpNode>();
+                bin->left = expr;
+                bin->right = right;
                 bin->op = op;
                 expr = bin;
                 continue;
@@ -976,18 +1047,9 @@ ExpressionNode* VisualGasicParser::parse_comparison() {
         if (check(VisualGasicTokenizer::TOKEN_KEYWORD) && String(peek().value).nocasecmp_to("Is") == 0) {
             advance();
             ExpressionNode* right = parse_addition();
-            BinaryOpNode* bin = static_cast<BinaryOpNode*>(register_node(new BinaryOpNode()));
-            // Duplicate children when attaching to avoid sharing the same
-            // ExpressionNode instance between multiple parents which causes
-            // double-delete during AST teardown.
-            if (expr) {
-                ExpressionNode* ldup = expr->duplicate();
-                if (ldup) bin->left = register_node(ldup); else bin->left = expr;
-            } else bin->left = nullptr;
-            if (right) {
-                ExpressionNode* rdup = right->duplicate();
-                if (rdup) bin->right = register_node(rdup); else bin->right = right;
-            } else bin->right = nullptr;
+            BinaryOpNode* bin = make<BinaryOpNode>();
+            bin->left = expr;
+            bin->right = right;
             bin->op = "Is";
             expr = bin;
             continue;
@@ -1006,15 +1068,9 @@ ExpressionNode* VisualGasicParser::parse_addition() {
         if (op == "+" || op == "-" || op == "&") {
             advance();
             ExpressionNode* right = parse_term();
-            BinaryOpNode* bin = static_cast<BinaryOpNode*>(register_node(new BinaryOpNode()));
-            if (expr) {
-                ExpressionNode* ldup = expr->duplicate();
-                if (ldup) bin->left = register_node(ldup); else bin->left = expr;
-            } else bin->left = nullptr;
-            if (right) {
-                ExpressionNode* rdup = right->duplicate();
-                if (rdup) bin->right = register_node(rdup); else bin->right = right;
-            } else bin->right = nullptr;
+            BinaryOpNode* bin = make<BinaryOpNode>();
+            bin->left = expr;
+            bin->right = right;
             bin->op = op;
             expr = bin;
         } else {
@@ -1032,15 +1088,9 @@ ExpressionNode* VisualGasicParser::parse_term() {
         if (op == "*" || op == "/" || op == "//") {
             advance();
             ExpressionNode* right = parse_unary();
-            BinaryOpNode* bin = static_cast<BinaryOpNode*>(register_node(new BinaryOpNode()));
-            if (expr) {
-                ExpressionNode* ldup = expr->duplicate();
-                if (ldup) bin->left = register_node(ldup); else bin->left = expr;
-            } else bin->left = nullptr;
-            if (right) {
-                ExpressionNode* rdup = right->duplicate();
-                if (rdup) bin->right = register_node(rdup); else bin->right = right;
-            } else bin->right = nullptr;
+            BinaryOpNode* bin = make<BinaryOpNode>();
+            bin->left = expr;
+            bin->right = right;
             bin->op = op;
             expr = bin;
         } else {
@@ -1056,15 +1106,9 @@ ExpressionNode* VisualGasicParser::parse_exponentiation() {
     if (check(VisualGasicTokenizer::TOKEN_OPERATOR) && peek().value == "**") {
         advance();
         ExpressionNode* right = parse_exponentiation(); // Right Associative
-        BinaryOpNode* bin = static_cast<BinaryOpNode*>(register_node(new BinaryOpNode()));
-        if (expr) {
-            ExpressionNode* ldup = expr->duplicate();
-            if (ldup) bin->left = register_node(ldup); else bin->left = expr;
-        } else bin->left = nullptr;
-        if (right) {
-            ExpressionNode* rdup = right->duplicate();
-            if (rdup) bin->right = register_node(rdup); else bin->right = right;
-        } else bin->right = nullptr;
+        BinaryOpNode* bin = make<BinaryOpNode>();
+        bin->left = expr;
+        bin->right = right;
         bin->op = "**";
         return bin;
     }
@@ -1075,12 +1119,9 @@ ExpressionNode* VisualGasicParser::parse_unary() {
     if (check(VisualGasicTokenizer::TOKEN_OPERATOR) && peek().value == "-") {
         advance();
         ExpressionNode* operand = parse_unary();
-        UnaryOpNode* u = static_cast<UnaryOpNode*>(register_node(new UnaryOpNode()));
+        UnaryOpNode* u = make<UnaryOpNode>();
         u->op = "-"; // Unary Minus
-        if (operand) {
-            ExpressionNode* odup = operand->duplicate();
-            if (odup) u->operand = register_node(odup); else u->operand = operand;
-        } else u->operand = nullptr;
+        u->operand = operand;
         return u;
     }
     // Check for Not (Logical Not is usually higher than Relational but lower than Arithmetic? In VB Not is bitwise too)
@@ -1097,11 +1138,11 @@ ExpressionNode* VisualGasicParser::parse_factor() {
         // We can create a dummy WITH_CONTEXT node as base.
         advance(); // Eat .
         
-        ExpressionNode* base = static_cast<ExpressionNode*>(register_node(new ExpressionNode()));
+        ExpressionNode* base = make<ExpressionNode>();
         base->type = ExpressionNode::WITH_CONTEXT;
         
         if (check(VisualGasicTokenizer::TOKEN_IDENTIFIER)) {
-             MemberAccessNode* ma = static_cast<MemberAccessNode*>(register_node(new MemberAccessNode()));
+             MemberAccessNode* ma = make<MemberAccessNode>();
              ma->base_object = base;
              ma->member_name = peek().value;
              advance();
@@ -1120,7 +1161,7 @@ ExpressionNode* VisualGasicParser::parse_factor() {
         check(VisualGasicTokenizer::TOKEN_LITERAL_FLOAT) ||
         check(VisualGasicTokenizer::TOKEN_LITERAL_STRING)) {
         
-        LiteralNode* node = static_cast<LiteralNode*>(register_node(new LiteralNode()));
+        LiteralNode* node = make<LiteralNode>();
         node->value = peek().value;
         advance();
         return node;
@@ -1139,10 +1180,10 @@ ExpressionNode* VisualGasicParser::parse_factor() {
              if (open == -1) {
                  String remainder = raw.substr(start);
                  if (!remainder.is_empty()) {
-                     LiteralNode* lit = static_cast<LiteralNode*>(register_node(new LiteralNode())); lit->value = remainder;
+                     LiteralNode* lit = make<LiteralNode>(); lit->value = remainder;
                      if (!root) root = lit;
                      else {
-                         BinaryOpNode* bin = static_cast<BinaryOpNode*>(register_node(new BinaryOpNode()));
+                         BinaryOpNode* bin = make<BinaryOpNode>();
                          bin->left = root; bin->right = lit; bin->op = "&";
                          root = bin;
                      }
@@ -1152,10 +1193,10 @@ ExpressionNode* VisualGasicParser::parse_factor() {
              
              if (open > start) {
                  String prefix = raw.substr(start, open - start);
-                 LiteralNode* lit = static_cast<LiteralNode*>(register_node(new LiteralNode())); lit->value = prefix;
+                 LiteralNode* lit = make<LiteralNode>(); lit->value = prefix;
                  if (!root) root = lit;
                  else {
-                     BinaryOpNode* bin = static_cast<BinaryOpNode*>(register_node(new BinaryOpNode()));
+                     BinaryOpNode* bin = make<BinaryOpNode>();
                      bin->left = root; bin->right = lit; bin->op = "&";
                      root = bin;
                  }
@@ -1173,21 +1214,18 @@ ExpressionNode* VisualGasicParser::parse_factor() {
              Vector<VisualGasicTokenizer::Token> sub_tokens = sub_tok.tokenize(expr_str);
              VisualGasicParser sub_parser;
              sub_parser.tokens = sub_tokens;
+             sub_parser.arena = arena;
              // We deliberately do not pass full module context here as it's a lightweight parse
              // But if expr uses constants, it might fail? 
              // Variable names are just identifiers, resolved at runtime, so it's fine.
              
              ExpressionNode* sub_expr = sub_parser.parse_expression();
              if (sub_expr) {
-                  // Duplicate the sub-parser expression into this parser's ownership
-                  ExpressionNode* transferred = nullptr;
-                  ExpressionNode* d = sub_expr->duplicate();
-                  if (d) transferred = register_node(d); else transferred = sub_expr;
-                  if (!root) root = transferred;
+                  // The sub-parser allocates from this module's arena, so its nodes can be linked directly
+                  if (!root) root = sub_expr;
                   else {
-                      BinaryOpNode* bin = static_cast<BinaryOpNode*>(register_node(new BinaryOpNode()));
-                      // root is owned by this parser; transferred is duplicated/registered above
-                      bin->left = root; bin->right = transferred; bin->op = "&";
+                      BinaryOpNode* bin = make<BinaryOpNode>();
+                      bin->left = root; bin->right = sub_expr; bin->op = "&";
                       root = bin;
                   }
              }
@@ -1196,7 +1234,7 @@ ExpressionNode* VisualGasicParser::parse_factor() {
          }
          
          if (!root) {
-              LiteralNode* empty = static_cast<LiteralNode*>(register_node(new LiteralNode())); empty->value = "";
+              LiteralNode* empty = make<LiteralNode>(); empty->value = "";
               return empty;
          }
          return root;
@@ -1208,28 +1246,28 @@ ExpressionNode* VisualGasicParser::parse_factor() {
         String k = peek().value;
         if (k.nocasecmp_to("True") == 0) {
             advance();
-            LiteralNode* node = static_cast<LiteralNode*>(register_node(new LiteralNode()));
+            LiteralNode* node = make<LiteralNode>();
             node->value = true;
             return node;
         }
         if (k.nocasecmp_to("False") == 0) {
             advance();
-            LiteralNode* node = static_cast<LiteralNode*>(register_node(new LiteralNode()));
+            LiteralNode* node = make<LiteralNode>();
             node->value = false;
             return node;
         }
         if (k.nocasecmp_to("Me") == 0) {
             advance();
-            return static_cast<MeNode*>(register_node(new MeNode()));
+            return make<MeNode>();
         }
         if (k.nocasecmp_to("Super") == 0 || k.nocasecmp_to("MyBase") == 0) {
             advance();
-            return static_cast<SuperNode*>(register_node(new SuperNode()));
+            return make<SuperNode>();
         }
         if (k.nocasecmp_to("New") == 0) {
             advance();
              if (check(VisualGasicTokenizer::TOKEN_IDENTIFIER) || check(VisualGasicTokenizer::TOKEN_KEYWORD)) {
-                 NewNode* n = static_cast<NewNode*>(register_node(new NewNode()));
+                 NewNode* n = make<NewNode>();
                  n->class_name = peek().value;
                  advance();
                  
@@ -1243,7 +1281,6 @@ ExpressionNode* VisualGasicParser::parse_factor() {
                                  ExpressionNode* _tmp = parse_expression();
                                  if (_tmp) {
                                      n->args.push_back(_tmp);
-                                     unregister_node(_tmp);
                                  }
                              }
                              if (check(VisualGasicTokenizer::TOKEN_COMMA)) {
@@ -1290,7 +1327,7 @@ ExpressionNode* VisualGasicParser::parse_factor() {
         ExpressionNode* false_part = parse_expression();
         match(VisualGasicTokenizer::TOKEN_PAREN_CLOSE);
         
-        IIfNode* iif = static_cast<IIfNode*>(register_node(new IIfNode()));
+        IIfNode* iif = make<IIfNode>();
         iif->condition = cond;
         iif->true_part = true_part;
         iif->false_part = false_part;
@@ -1299,7 +1336,7 @@ ExpressionNode* VisualGasicParser::parse_factor() {
     
     // Check for Nothing
     if (check(VisualGasicTokenizer::TOKEN_KEYWORD) && String(peek().value).nocasecmp_to("Nothing") == 0) {
-        LiteralNode* node = static_cast<LiteralNode*>(register_node(new LiteralNode()));
+        LiteralNode* node = make<LiteralNode>();
         node->value = Variant(); // Nil
         advance();
         return node; 
@@ -1308,14 +1345,14 @@ ExpressionNode* VisualGasicParser::parse_factor() {
     // Check for Me
     if (check(VisualGasicTokenizer::TOKEN_KEYWORD) && String(peek().value).nocasecmp_to("Me") == 0) {
         advance();
-        ExpressionNode* left = static_cast<ExpressionNode*>(register_node(new ExpressionNode()));
+        ExpressionNode* left = make<ExpressionNode>();
         left->type = ExpressionNode::ME;
         
         // Handle member access
         while (check(VisualGasicTokenizer::TOKEN_OPERATOR) && peek().value == ".") {
             advance(); // Eat .
             if (check(VisualGasicTokenizer::TOKEN_IDENTIFIER) || check(VisualGasicTokenizer::TOKEN_KEYWORD)) {
-                MemberAccessNode* member = static_cast<MemberAccessNode*>(register_node(new MemberAccessNode()));
+                MemberAccessNode* member = make<MemberAccessNode>();
                 member->base_object = left;
                 member->member_name = peek().value;
                 advance();
@@ -1327,12 +1364,12 @@ ExpressionNode* VisualGasicParser::parse_factor() {
         
         if (check(VisualGasicTokenizer::TOKEN_PAREN_OPEN)) {
             advance();
-            CallExpression* call = static_cast<CallExpression*>(register_node(new CallExpression()));
+            CallExpression* call = make<CallExpression>();
             if (left->type == ExpressionNode::MEMBER_ACCESS) {
                 MemberAccessNode* ma = (MemberAccessNode*)left;
                 call->base_object = ma->base_object;
                 call->method_name = ma->member_name;
-                ma->base_object = nullptr; unregister_node(ma); delete ma;
+                ma->base_object = nullptr;
             } else {
                  // Me(...) call? Invalid?
                  // delete left; 
@@ -1343,7 +1380,7 @@ ExpressionNode* VisualGasicParser::parse_factor() {
              if (!check(VisualGasicTokenizer::TOKEN_PAREN_CLOSE)) {
                 while (true) {
                     ExpressionNode* expr = parse_expression();
-                    if (expr) { call->arguments.push_back(expr); unregister_node(expr); }
+                    if (expr) { call->arguments.push_back(expr); }
                     if (match(VisualGasicTokenizer::TOKEN_COMMA)) continue;
                     break;
                 }
@@ -1359,7 +1396,7 @@ ExpressionNode* VisualGasicParser::parse_factor() {
     if (check(VisualGasicTokenizer::TOKEN_KEYWORD) && String(peek().value).nocasecmp_to("New") == 0) {
         advance();
         if (check(VisualGasicTokenizer::TOKEN_IDENTIFIER) || check(VisualGasicTokenizer::TOKEN_KEYWORD)) {
-             NewNode* n = static_cast<NewNode*>(register_node(new NewNode()));
+             NewNode* n = make<NewNode>();
              n->class_name = peek().value;
              advance();
              return n;
@@ -1381,7 +1418,7 @@ ExpressionNode* VisualGasicParser::parse_factor() {
         String var_name = peek().value;
         advance();
         
-        VariableNode* target = static_cast<VariableNode*>(register_node(new VariableNode()));
+        VariableNode* target = make<VariableNode>();
         target->name = var_name;
         
         // Expect "Is"
@@ -1394,28 +1431,22 @@ ExpressionNode* VisualGasicParser::parse_factor() {
                 advance();
                 
                 // Create a binary operation node for "TypeOf x Is Type"
-                BinaryOpNode* typecheck = static_cast<BinaryOpNode*>(register_node(new BinaryOpNode()));
+                BinaryOpNode* typecheck = make<BinaryOpNode>();
                 typecheck->op = "Is"; // Use "Is" as the operator
                 typecheck->left = target;
-                unregister_node(target);
                 
                 // Create a type node for the right side
-                VariableNode* type_node = static_cast<VariableNode*>(register_node(new VariableNode()));
+                VariableNode* type_node = make<VariableNode>();
                 type_node->name = type_name;
                 typecheck->right = type_node;
-                unregister_node(type_node);
                 
                 return typecheck;
             } else {
                 error("Expected type name after 'TypeOf ... Is'");
-                unregister_node(target);
-                delete target;
                 return nullptr;
             }
         } else {
             error("Expected 'Is' after 'TypeOf variable'");
-            unregister_node(target);
-            delete target;
             return nullptr;
         }
     }
@@ -1436,14 +1467,14 @@ ExpressionNode* VisualGasicParser::parse_factor() {
         // Function Call? "Func(x)"
         if (check(VisualGasicTokenizer::TOKEN_PAREN_OPEN)) {
             advance(); // Eat (
-            CallExpression* call = static_cast<CallExpression*>(register_node(new CallExpression()));
+            CallExpression* call = make<CallExpression>();
             call->method_name = name;
             
             if (!check(VisualGasicTokenizer::TOKEN_PAREN_CLOSE)) {
                 // Parse arguments
                 while (true) {
                     ExpressionNode* expr = parse_expression();
-                    if (expr) { call->arguments.push_back(expr); unregister_node(expr); }
+                    if (expr) { call->arguments.push_back(expr); }
                     
                     if (match(VisualGasicTokenizer::TOKEN_COMMA)) continue;
                     break;
@@ -1456,7 +1487,7 @@ ExpressionNode* VisualGasicParser::parse_factor() {
             left = call;
         } else {
             // Variable
-            VariableNode* node = static_cast<VariableNode*>(register_node(new VariableNode()));
+            VariableNode* node = make<VariableNode>();
             node->name = name;
             left = node;
         }
@@ -1467,7 +1498,7 @@ ExpressionNode* VisualGasicParser::parse_factor() {
             
             // Allow Identifier OR Keyword (e.g. Input, New)
             if (check(VisualGasicTokenizer::TOKEN_IDENTIFIER) || check(VisualGasicTokenizer::TOKEN_KEYWORD)) {
-                MemberAccessNode* member = static_cast<MemberAccessNode*>(register_node(new MemberAccessNode()));
+                MemberAccessNode* member = make<MemberAccessNode>();
                 member->base_object = left;
                 member->member_name = peek().value;
                 advance();
@@ -1476,15 +1507,15 @@ ExpressionNode* VisualGasicParser::parse_factor() {
                 // Check for Method Call syntax .Method(Args)
                 if (check(VisualGasicTokenizer::TOKEN_PAREN_OPEN)) {
                     advance(); // Eat (
-                    CallExpression* call = static_cast<CallExpression*>(register_node(new CallExpression()));
+                    CallExpression* call = make<CallExpression>();
                     call->base_object = member->base_object;
                     call->method_name = member->member_name;
-                    member->base_object = nullptr; unregister_node(member); delete member;
+                    member->base_object = nullptr;
                     
                     if (!check(VisualGasicTokenizer::TOKEN_PAREN_CLOSE)) {
                          while(true) {
                              ExpressionNode* expr = parse_expression();
-                             if (expr) { call->arguments.push_back(expr); unregister_node(expr); }
+                             if (expr) { call->arguments.push_back(expr); }
                              
                              if (match(VisualGasicTokenizer::TOKEN_COMMA)) continue;
                              break;
@@ -1520,17 +1551,16 @@ ExpressionNode* VisualGasicParser::parse_factor() {
 
 WithStatement* VisualGasicParser::parse_with() {
     advance(); // Eat With
-    WithStatement* stmt = static_cast<WithStatement*>(register_node(new WithStatement()));
+    WithStatement* stmt = make<WithStatement>();
     {
         ExpressionNode* _tmp = parse_expression();
         stmt->expression = _tmp;
-        unregister_node(_tmp);
     }
     
     // Parse Block
     while (!match(VisualGasicTokenizer::TOKEN_EOF)) {
         if (check(VisualGasicTokenizer::TOKEN_KEYWORD) && String(peek().value).nocasecmp_to("End") == 0) {
-            VisualGasicTokenizer::Token next = peek(1);
+            const VisualGasicTokenizer::Token &next = peek(1);
             if (String(next.value).nocasecmp_to("With") == 0) {
                 advance(); // Eat End
                 advance(); // Eat With
@@ -1539,7 +1569,7 @@ WithStatement* VisualGasicParser::parse_with() {
         }
         
         Statement* s = parse_statement();
-        if (s) { stmt->body.push_back(s); unregister_node(s); }
+        if (s) { stmt->body.push_back(s); }
         else {
              if (check(VisualGasicTokenizer::TOKEN_NEWLINE)) advance();
              else if (!is_at_end()) advance();
@@ -1560,7 +1590,7 @@ DimStatement* VisualGasicParser::parse_dim() {
         return nullptr;
     }
     
-    DimStatement* stmt = static_cast<DimStatement*>(register_node(new DimStatement()));
+    DimStatement* stmt = make<DimStatement>();
     stmt->variable_name = peek().value;
     advance();
     
@@ -1569,7 +1599,7 @@ DimStatement* VisualGasicParser::parse_dim() {
         do {
             {
                 ExpressionNode* _tmp = parse_expression();
-                if (_tmp) { stmt->array_sizes.push_back(_tmp); unregister_node(_tmp); }
+                if (_tmp) { stmt->array_sizes.push_back(_tmp); }
                 else {
                     // Expression parse failed, skip to closing paren or newline
                     while (!is_at_end() && peek().type != VisualGasicTokenizer::TOKEN_PAREN_CLOSE && peek().type != VisualGasicTokenizer::TOKEN_NEWLINE) {
@@ -1608,7 +1638,6 @@ DimStatement* VisualGasicParser::parse_dim() {
             ExpressionNode* _tmp = parse_expression();
             if (_tmp) {
                 stmt->initializer = _tmp;
-                unregister_node(_tmp);
             } else {
                 // Expression parse failed, skip to newline
                 UtilityFunctions::print("Parser Error: Failed to parse initializer expression");
@@ -1625,7 +1654,7 @@ DimStatement* VisualGasicParser::parse_dim() {
 IfStatement* VisualGasicParser::parse_if() {
     advance(); // Eat If
     
-    IfStatement* stmt = static_cast<IfStatement*>(register_node(new IfStatement()));
+    IfStatement* stmt = make<IfStatement>();
     {
         ExpressionNode* _tmp = parse_expression();
         if (!_tmp) {
@@ -1633,7 +1662,6 @@ IfStatement* VisualGasicParser::parse_if() {
             return nullptr;
         }
         stmt->condition = _tmp;
-        unregister_node(_tmp);
     }
     
     bool is_block = false;
@@ -1674,11 +1702,10 @@ IfStatement* VisualGasicParser::parse_if() {
                  if (val.nocasecmp_to("Elif") == 0 || val.nocasecmp_to("ElseIf") == 0) {
                      advance(); // Eat Elif
                      
-                     IfStatement* next_if = static_cast<IfStatement*>(register_node(new IfStatement()));
+                     IfStatement* next_if = make<IfStatement>();
                      {
                          ExpressionNode* _tmp = parse_expression();
                          next_if->condition = _tmp;
-                         unregister_node(_tmp);
                      }
                      
                      if (check(VisualGasicTokenizer::TOKEN_KEYWORD) && String(peek().value).nocasecmp_to("Then") == 0) {
@@ -1687,7 +1714,6 @@ IfStatement* VisualGasicParser::parse_if() {
 
                      // Link to previous Else
                      current_if_node->else_branch.push_back(next_if);
-                     unregister_node(next_if);
                      
                      // Switch Context
                      current_if_node = next_if;
@@ -1698,7 +1724,7 @@ IfStatement* VisualGasicParser::parse_if() {
             }
             
             Statement* s = parse_statement();
-            if (s) { current_branch->push_back(s); unregister_node(s); }
+            if (s) { current_branch->push_back(s); }
             else if (check(VisualGasicTokenizer::TOKEN_NEWLINE)) advance();
             else if (check(VisualGasicTokenizer::TOKEN_EOF)) break;
             else advance(); // Skip garbage
@@ -1710,13 +1736,12 @@ IfStatement* VisualGasicParser::parse_if() {
         Statement* s = parse_statement();
         if (s) {
             stmt->then_branch.push_back(s);
-            unregister_node(s);
 
             // Check for Else (Single Line)
             if (check(VisualGasicTokenizer::TOKEN_KEYWORD) && String(peek().value).nocasecmp_to("Else") == 0) {
                  advance();
                  Statement* el = parse_statement();
-                 if (el) { stmt->else_branch.push_back(el); unregister_node(el); }
+                 if (el) { stmt->else_branch.push_back(el); }
             }
         }
     }
@@ -1751,7 +1776,7 @@ Statement* VisualGasicParser::parse_for() {
         }
         advance(); // Eat In
         
-        ForEachStatement* stmt = static_cast<ForEachStatement*>(register_node(new ForEachStatement()));
+        ForEachStatement* stmt = make<ForEachStatement>();
         stmt->variable_name = var_name;
         {
             ExpressionNode* _tmp = parse_expression();
@@ -1764,7 +1789,6 @@ Statement* VisualGasicParser::parse_for() {
                 return stmt;
             }
             stmt->collection = _tmp;
-            unregister_node(_tmp);
         }
         
         while (!match(VisualGasicTokenizer::TOKEN_EOF)) {
@@ -1776,7 +1800,7 @@ Statement* VisualGasicParser::parse_for() {
                 break;
             }
             Statement* s = parse_statement();
-            if (s) { stmt->body.push_back(s); unregister_node(s); }
+            if (s) { stmt->body.push_back(s); }
             else {
                 if (check(VisualGasicTokenizer::TOKEN_NEWLINE)) advance();
                 else if (!is_at_end()) advance(); // Skip garbage
@@ -1786,7 +1810,7 @@ Statement* VisualGasicParser::parse_for() {
     }
 
     // Standard For Loop
-    ForStatement* stmt = static_cast<ForStatement*>(register_node(new ForStatement()));
+    ForStatement* stmt = make<ForStatement>();
     stmt->variable_name = var_name;
     
     //Handle optional "As Type" declaration
@@ -1810,7 +1834,6 @@ Statement* VisualGasicParser::parse_for() {
         ExpressionNode* _tmp = parse_expression();
         if (_tmp) {
             stmt->from_val = _tmp;
-            unregister_node(_tmp);
         } else {
             error("Failed to parse For start value");
             // Skip to newline to recover
@@ -1822,7 +1845,7 @@ Statement* VisualGasicParser::parse_for() {
     }
     
     bool found_to = false;
-    VisualGasicTokenizer::Token t_to = peek();
+    const VisualGasicTokenizer::Token &t_to = peek();
     
     // UtilityFunctions::print("DEBUG FOR: Next token after from_val: ", t_to.value, " Type: ", t_to.type);
     
@@ -1838,7 +1861,6 @@ Statement* VisualGasicParser::parse_for() {
             ExpressionNode* _tmp = parse_expression();
             if (_tmp) {
                 stmt->to_val = _tmp;
-                unregister_node(_tmp);
             } else {
                 error("Failed to parse For end value");
                 // Skip to newline to recover
@@ -1858,14 +1880,13 @@ Statement* VisualGasicParser::parse_for() {
     }
     
     // Step ?
-    VisualGasicTokenizer::Token t_step = peek();
+    const VisualGasicTokenizer::Token &t_step = peek();
     if ((t_step.type == VisualGasicTokenizer::TOKEN_KEYWORD || t_step.type == VisualGasicTokenizer::TOKEN_IDENTIFIER)
         && t_step.value.operator String().nocasecmp_to("Step") == 0) {
         advance();
         {
             ExpressionNode* _tmp = parse_expression();
             stmt->step_val = _tmp;
-            unregister_node(_tmp);
         }
     }
     
@@ -1898,7 +1919,7 @@ Statement* VisualGasicParser::parse_for() {
         }
         
         Statement* s = parse_statement();
-        if (s) { stmt->body.push_back(s); unregister_node(s); }
+        if (s) { stmt->body.push_back(s); }
         else if (check(VisualGasicTokenizer::TOKEN_NEWLINE)) advance();
         else advance();
     }
@@ -1921,20 +1942,19 @@ SelectStatement* VisualGasicParser::parse_select() {
         UtilityFunctions::print("Parser Error: Expected Case after Select");
     }
     
-    SelectStatement* stmt = static_cast<SelectStatement*>(register_node(new SelectStatement()));
+    SelectStatement* stmt = make<SelectStatement>();
     {
         ExpressionNode* _tmp = parse_expression();
         stmt->expression = _tmp;
-        unregister_node(_tmp);
     }
     match(VisualGasicTokenizer::TOKEN_NEWLINE);
     
     while (!is_at_end()) {
-        VisualGasicTokenizer::Token t = peek();
+        const VisualGasicTokenizer::Token &t = peek();
         
         // End Select
         if ((t.type == VisualGasicTokenizer::TOKEN_KEYWORD || t.type == VisualGasicTokenizer::TOKEN_IDENTIFIER) && String(t.value).nocasecmp_to("End") == 0) {
-            VisualGasicTokenizer::Token next = peek(1);
+            const VisualGasicTokenizer::Token &next = peek(1);
             if ((next.type == VisualGasicTokenizer::TOKEN_KEYWORD || next.type == VisualGasicTokenizer::TOKEN_IDENTIFIER) && String(next.value).nocasecmp_to("Select") == 0) {
                 advance(); // End
                 advance(); // Select
@@ -1946,7 +1966,7 @@ SelectStatement* VisualGasicParser::parse_select() {
         if ((t.type == VisualGasicTokenizer::TOKEN_KEYWORD || t.type == VisualGasicTokenizer::TOKEN_IDENTIFIER) && String(t.value).nocasecmp_to("Case") == 0) {
             advance(); // Eat Case
             
-            CaseBlock* block = static_cast<CaseBlock*>(register_node(new CaseBlock()));
+            CaseBlock* block = make<CaseBlock>();
             
             // Case Else
             if ((check(VisualGasicTokenizer::TOKEN_KEYWORD) || check(VisualGasicTokenizer::TOKEN_IDENTIFIER)) && String(peek().value).nocasecmp_to("Else") == 0) {
@@ -1957,7 +1977,7 @@ SelectStatement* VisualGasicParser::parse_select() {
                 do {
                     {
                         ExpressionNode* _tmp = parse_expression();
-                        if (_tmp) { block->values.push_back(_tmp); unregister_node(_tmp); }
+                        if (_tmp) { block->values.push_back(_tmp); }
                     }
                     if (match(VisualGasicTokenizer::TOKEN_COMMA)) continue;
                     break;
@@ -1968,22 +1988,21 @@ SelectStatement* VisualGasicParser::parse_select() {
             
             // Parse Body until next Case or End Select
             while (!is_at_end()) {
-                VisualGasicTokenizer::Token next = peek();
+                const VisualGasicTokenizer::Token &next = peek();
                 if ((next.type == VisualGasicTokenizer::TOKEN_KEYWORD || next.type == VisualGasicTokenizer::TOKEN_IDENTIFIER) && String(next.value).nocasecmp_to("Case") == 0) break;
                 if ((next.type == VisualGasicTokenizer::TOKEN_KEYWORD || next.type == VisualGasicTokenizer::TOKEN_IDENTIFIER) && String(next.value).nocasecmp_to("End") == 0) {
-                     VisualGasicTokenizer::Token next2 = peek(1);
+                     const VisualGasicTokenizer::Token &next2 = peek(1);
                      if (String(next2.value).nocasecmp_to("Select") == 0) break;
                 }
                 
                 Statement* s = parse_statement();
-                if (s) { block->body.push_back(s); unregister_node(s); }
+                if (s) { block->body.push_back(s); }
                 else {
                     if (check(VisualGasicTokenizer::TOKEN_NEWLINE)) advance();
                     else break; // Avoid infinite loop or move next
                 }
             }
             stmt->cases.push_back(block);
-            unregister_node(block);
             continue;
         }
 
@@ -2008,18 +2027,18 @@ WhileStatement* VisualGasicParser::parse_while() {
         while (!is_at_end() && peek().type != VisualGasicTokenizer::TOKEN_NEWLINE) {
             advance();
         }
-        WhileStatement* stmt = static_cast<WhileStatement*>(register_node(new WhileStatement()));
+        WhileStatement* stmt = make<WhileStatement>();
         stmt->condition = nullptr;
         return stmt;
     }
     
     match(VisualGasicTokenizer::TOKEN_NEWLINE);
     
-    WhileStatement* stmt = static_cast<WhileStatement*>(register_node(new WhileStatement()));
+    WhileStatement* stmt = make<WhileStatement>();
     stmt->condition = condition;
     
     while (!is_at_end() && error_count < MAX_ERRORS) {
-        VisualGasicTokenizer::Token t = peek();
+        const VisualGasicTokenizer::Token &t = peek();
         if ((t.type == VisualGasicTokenizer::TOKEN_KEYWORD || t.type == VisualGasicTokenizer::TOKEN_IDENTIFIER)) {
             String kw = String(t.value);
             
@@ -2042,7 +2061,7 @@ WhileStatement* VisualGasicParser::parse_while() {
         }
         
         Statement* s = parse_statement();
-        if (s) { stmt->body.push_back(s); unregister_node(s); }
+        if (s) { stmt->body.push_back(s); }
         else if (check(VisualGasicTokenizer::TOKEN_NEWLINE)) advance();
         else current_pos++;
     }
@@ -2058,9 +2077,9 @@ WhileStatement* VisualGasicParser::parse_while() {
 DoStatement* VisualGasicParser::parse_do() {
     advance(); // Eat Do
     
-    DoStatement* stmt = static_cast<DoStatement*>(register_node(new DoStatement()));
+    DoStatement* stmt = make<DoStatement>();
     
-    VisualGasicTokenizer::Token t = peek();
+    const VisualGasicTokenizer::Token &t = peek();
     String val = t.value;
     
     if (val.nocasecmp_to("While") == 0) {
@@ -2069,7 +2088,6 @@ DoStatement* VisualGasicParser::parse_do() {
         {
             ExpressionNode* _tmp = parse_expression();
             stmt->condition = _tmp;
-            unregister_node(_tmp);
         }
     } else if (val.nocasecmp_to("Until") == 0) {
         advance();
@@ -2077,14 +2095,13 @@ DoStatement* VisualGasicParser::parse_do() {
         {
             ExpressionNode* _tmp = parse_expression();
             stmt->condition = _tmp;
-            unregister_node(_tmp);
         }
     }
     
     match(VisualGasicTokenizer::TOKEN_NEWLINE);
     
     while (!is_at_end()) {
-        VisualGasicTokenizer::Token t_loop = peek();
+        const VisualGasicTokenizer::Token &t_loop = peek();
         if ((t_loop.type == VisualGasicTokenizer::TOKEN_KEYWORD || t_loop.type == VisualGasicTokenizer::TOKEN_IDENTIFIER)) {
             String kw = String(t_loop.value);
             
@@ -2094,7 +2111,7 @@ DoStatement* VisualGasicParser::parse_do() {
                 
                 // Post-condition
                 if (stmt->condition_type == DoStatement::NONE) {
-                      VisualGasicTokenizer::Token t_post = peek();
+                      const VisualGasicTokenizer::Token &t_post = peek();
                       if (String(t_post.value).nocasecmp_to("While") == 0) {
                           advance();
                           stmt->condition_type = DoStatement::WHILE;
@@ -2102,7 +2119,6 @@ DoStatement* VisualGasicParser::parse_do() {
                           {
                               ExpressionNode* _tmp = parse_expression();
                               stmt->condition = _tmp;
-                              unregister_node(_tmp);
                           }
                       } else if (String(t_post.value).nocasecmp_to("Until") == 0) {
                           advance();
@@ -2111,7 +2127,6 @@ DoStatement* VisualGasicParser::parse_do() {
                           {
                               ExpressionNode* _tmp = parse_expression();
                               stmt->condition = _tmp;
-                              unregister_node(_tmp);
                           }
                       }
                 }
@@ -2131,7 +2146,7 @@ DoStatement* VisualGasicParser::parse_do() {
         }
         
         Statement* s = parse_statement();
-        if (s) { stmt->body.push_back(s); unregister_node(s); }
+        if (s) { stmt->body.push_back(s); }
         else if (check(VisualGasicTokenizer::TOKEN_NEWLINE)) advance();
         else current_pos++;
     }
@@ -2154,12 +2169,11 @@ DoStatement* VisualGasicParser::parse_do() {
 
 Statement* VisualGasicParser::parse_return() {
     advance(); // Eat Return
-    ReturnStatement* ret = static_cast<ReturnStatement*>(register_node(new ReturnStatement()));
+    ReturnStatement* ret = make<ReturnStatement>();
     if (!check(VisualGasicTokenizer::TOKEN_NEWLINE) && !check(VisualGasicTokenizer::TOKEN_EOF)) {
         {
             ExpressionNode* _tmp = parse_expression();
             ret->return_value = _tmp;
-            unregister_node(_tmp);
         }
     }
     return ret;
@@ -2167,7 +2181,7 @@ Statement* VisualGasicParser::parse_return() {
 
 Statement* VisualGasicParser::parse_continue() {
     advance(); // Eat Continue
-    ContinueStatement* c = static_cast<ContinueStatement*>(register_node(new ContinueStatement()));
+    ContinueStatement* c = make<ContinueStatement>();
     
     if (check(VisualGasicTokenizer::TOKEN_KEYWORD)) {
         String val = peek().value;
@@ -2191,8 +2205,8 @@ Statement* VisualGasicParser::parse_assignment_or_call() {
     if (check(VisualGasicTokenizer::TOKEN_OPERATOR) && peek().value == ".") {
         advance(); // Eat .
         if (check(VisualGasicTokenizer::TOKEN_IDENTIFIER) || check(VisualGasicTokenizer::TOKEN_KEYWORD)) {
-             MemberAccessNode* ma = static_cast<MemberAccessNode*>(register_node(new MemberAccessNode()));
-             ExpressionNode* ctx = static_cast<ExpressionNode*>(register_node(new ExpressionNode()));
+             MemberAccessNode* ma = make<MemberAccessNode>();
+             ExpressionNode* ctx = make<ExpressionNode>();
              ctx->type = ExpressionNode::WITH_CONTEXT;
              ma->base_object = ctx;
              ma->member_name = peek().value;
@@ -2206,10 +2220,10 @@ Statement* VisualGasicParser::parse_assignment_or_call() {
         String name = peek().value;
         advance();
            if (name.nocasecmp_to("Me") == 0) {
-               head = static_cast<ExpressionNode*>(register_node(new ExpressionNode()));
+               head = make<ExpressionNode>();
                head->type = ExpressionNode::ME;
            } else {
-               VariableNode* var = static_cast<VariableNode*>(register_node(new VariableNode()));
+               VariableNode* var = make<VariableNode>();
                var->name = name;
                head = var;
            }
@@ -2220,7 +2234,7 @@ Statement* VisualGasicParser::parse_assignment_or_call() {
         if (check(VisualGasicTokenizer::TOKEN_OPERATOR) && peek().value == ".") {
             advance();
             if (check(VisualGasicTokenizer::TOKEN_IDENTIFIER) || check(VisualGasicTokenizer::TOKEN_KEYWORD)) {
-                 MemberAccessNode* ma = static_cast<MemberAccessNode*>(register_node(new MemberAccessNode()));
+                 MemberAccessNode* ma = make<MemberAccessNode>();
                  ma->base_object = head;
                  ma->member_name = peek().value;
                  head = ma;
@@ -2232,14 +2246,14 @@ Statement* VisualGasicParser::parse_assignment_or_call() {
         }
         else if (check(VisualGasicTokenizer::TOKEN_PAREN_OPEN)) {
              advance(); // Eat (
-             ArrayAccessNode* aa = static_cast<ArrayAccessNode*>(register_node(new ArrayAccessNode()));
+             ArrayAccessNode* aa = make<ArrayAccessNode>();
              aa->base = head;
              
              if (!check(VisualGasicTokenizer::TOKEN_PAREN_CLOSE)) {
                  while(true) {
                      {
                          ExpressionNode* _tmp = parse_expression();
-                         if (_tmp) { aa->indices.push_back(_tmp); unregister_node(_tmp); }
+                         if (_tmp) { aa->indices.push_back(_tmp); }
                      }
                      if (match(VisualGasicTokenizer::TOKEN_COMMA)) continue;
                      break;
@@ -2281,28 +2295,26 @@ Statement* VisualGasicParser::parse_assignment_or_call() {
                 }
             }
             
-            AssignmentStatement* assign = static_cast<AssignmentStatement*>(register_node(new AssignmentStatement()));
+            AssignmentStatement* assign = make<AssignmentStatement>();
             assign->target = head;
             {
                 ExpressionNode* _tmp = parse_expression();
                 assign->value = _tmp;
-                unregister_node(_tmp);
             }
             return assign;
 
         } else if (op == "+=" || op == "-=" || op == "*=" || op == "/=") {
             advance(); // Eat Op
             
-            AssignmentStatement* assign = static_cast<AssignmentStatement*>(register_node(new AssignmentStatement()));
+            AssignmentStatement* assign = make<AssignmentStatement>();
             assign->target = head; 
-            ExpressionNode* lhs_read = head->duplicate();
+            ExpressionNode* lhs_read = head->duplicate(*arena);
             
-            BinaryOpNode* bin = static_cast<BinaryOpNode*>(register_node(new BinaryOpNode()));
+            BinaryOpNode* bin = make<BinaryOpNode>();
             bin->left = lhs_read;
             {
                 ExpressionNode* _tmp = parse_expression();
                 bin->right = _tmp;
-                unregister_node(_tmp);
             }
             
             if (op == "+=") bin->op = "+";
@@ -2316,14 +2328,14 @@ Statement* VisualGasicParser::parse_assignment_or_call() {
         } else if (op == "++" || op == "--") {
             advance(); // Eat Op
 
-            AssignmentStatement* assign = static_cast<AssignmentStatement*>(register_node(new AssignmentStatement()));
+            AssignmentStatement* assign = make<AssignmentStatement>();
             assign->target = head;
-            ExpressionNode* lhs_read = head->duplicate();
+            ExpressionNode* lhs_read = head->duplicate(*arena);
             
-            BinaryOpNode* bin = static_cast<BinaryOpNode*>(register_node(new BinaryOpNode()));
+            BinaryOpNode* bin = make<BinaryOpNode>();
             bin->left = lhs_read;
             
-            LiteralNode* one = static_cast<LiteralNode*>(register_node(new LiteralNode()));
+            LiteralNode* one = make<LiteralNode>();
             one->value = 1;
             bin->right = one;
             
@@ -2336,7 +2348,7 @@ Statement* VisualGasicParser::parse_assignment_or_call() {
     }
     
     // Call Statement conversion
-            CallStatement* call = static_cast<CallStatement*>(register_node(new CallStatement()));
+            CallStatement* call = make<CallStatement>();
     
     if (head->type == ExpressionNode::ARRAY_ACCESS) {
         ArrayAccessNode* aa = (ArrayAccessNode*)head;
@@ -2348,33 +2360,25 @@ Statement* VisualGasicParser::parse_assignment_or_call() {
               ExpressionNode* idx = aa->indices[i];
               if (idx) {
                  call->arguments.push_back(idx);
-                 unregister_node(idx);
               }
            }
            aa->indices.clear(); 
 
            if (callee->type == ExpressionNode::VARIABLE) {
               call->method_name = ((VariableNode*)callee)->name;
-              unregister_node(callee); delete callee; 
            } else if (callee->type == ExpressionNode::MEMBER_ACCESS) {
                MemberAccessNode* ma = (MemberAccessNode*)callee;
                call->method_name = ma->member_name;
                call->base_object = ma->base_object;
                ma->base_object = nullptr; 
-               unregister_node(ma); delete ma;
            }
-           unregister_node(aa); delete aa;
     } else if (head->type == ExpressionNode::VARIABLE) {
          call->method_name = ((VariableNode*)head)->name;
-            unregister_node(head); delete head;
     } else if (head->type == ExpressionNode::MEMBER_ACCESS) {
          MemberAccessNode* ma = (MemberAccessNode*)head;
          call->method_name = ma->member_name;
          call->base_object = ma->base_object;
          ma->base_object = nullptr;
-            unregister_node(head); delete head;
-    } else {
-            unregister_node(head); delete head; 
     }
     
     if (!check(VisualGasicTokenizer::TOKEN_NEWLINE) && !check(VisualGasicTokenizer::TOKEN_EOF) && 
@@ -2386,7 +2390,7 @@ Statement* VisualGasicParser::parse_assignment_or_call() {
         
         while (true) {
             ExpressionNode* expr = parse_expression();
-            if (expr) { call->arguments.push_back(expr); unregister_node(expr); }
+            if (expr) { call->arguments.push_back(expr); }
             if (check(VisualGasicTokenizer::TOKEN_COMMA)) {
                 advance();
                 continue;
@@ -2398,6 +2402,172 @@ Statement* VisualGasicParser::parse_assignment_or_call() {
     return call;
 }
 
+// "Class" is not a keyword (it is a common identifier), so a Class block is
+// recognised by the word followed by a name at the start of a statement.
+bool VisualGasicParser::is_class_start(int p_offset) const {
+    const VisualGasicTokenizer::Token &t = peek(p_offset);
+    return (t.type == VisualGasicTokenizer::TOKEN_IDENTIFIER || t.type == VisualGasicTokenizer::TOKEN_KEYWORD) &&
+            String(t.value).nocasecmp_to("Class") == 0 && peek(p_offset + 1).type == VisualGasicTokenizer::TOKEN_IDENTIFIER;
+}
+
+// Class Name
+//     [Dim|Public|Private] member [As Type] [= default]
+//     [Public|Private] Sub/Function ... End Sub/Function
+// End Class
+ClassDefinition* VisualGasicParser::parse_class() {
+    advance(); // Eat Class
+    ClassDefinition* cls = make<ClassDefinition>();
+    cls->name = advance().value;
+
+    while (!is_at_end()) {
+        const VisualGasicTokenizer::Token &t = peek();
+        if (t.type == VisualGasicTokenizer::TOKEN_NEWLINE) {
+            advance();
+            continue;
+        }
+        String val = String(t.value).to_lower();
+        if (t.type == VisualGasicTokenizer::TOKEN_KEYWORD && val == "end") {
+            if (String(peek(1).value).nocasecmp_to("Class") == 0) {
+                advance(); // Eat End
+                advance(); // Eat Class
+                return cls;
+            }
+            error("Expected End Class, found End " + String(peek(1).value));
+            return nullptr;
+        }
+
+        bool modifier = t.type == VisualGasicTokenizer::TOKEN_KEYWORD && (val == "public" || val == "private");
+        const VisualGasicTokenizer::Token &head = peek(modifier ? 1 : 0);
+        if ((head.type == VisualGasicTokenizer::TOKEN_IDENTIFIER || head.type == VisualGasicTokenizer::TOKEN_KEYWORD) &&
+                (head.value == "Sub" || head.value == "Function")) {
+            if (modifier) {
+                advance();
+            }
+            SubDefinition* method = parse_sub();
+            if (!method) {
+                return nullptr;
+            }
+            if (method->name.nocasecmp_to("Class_Initialize") == 0) {
+                cls->class_initialize = method;
+            } else if (method->name.nocasecmp_to("Class_Terminate") == 0) {
+                cls->class_terminate = method;
+            }
+            cls->methods.push_back(method);
+            continue;
+        }
+
+        if (t.type == VisualGasicTokenizer::TOKEN_KEYWORD && (modifier || val == "dim")) {
+            DimStatement* dim = parse_dim();
+            if (!dim) {
+                continue;
+            }
+            VariableDefinition* member = make<VariableDefinition>();
+            member->name = dim->variable_name;
+            member->type = dim->type_name;
+            member->default_value = dim->initializer;
+            member->visibility = (val == "public") ? VIS_PUBLIC : (val == "private" ? VIS_PRIVATE : VIS_DIM);
+            for (int i = 0; i < dim->array_sizes.size(); i++) {
+                ExpressionNode* expr = dim->array_sizes[i];
+                member->array_sizes.push_back(expr && expr->type == ExpressionNode::LITERAL ? (int)((LiteralNode*)expr)->value : 0);
+            }
+            cls->members.push_back(member);
+            continue;
+        }
+
+        error("Unexpected '" + String(t.value) + "' in Class " + cls->name);
+        while (!is_at_end() && peek().type != VisualGasicTokenizer::TOKEN_NEWLINE) {
+            advance();
+        }
+    }
+    error("Expected End Class for Class " + cls->name);
+    return nullptr;
+}
+
+bool VisualGasicParser::is_declare_start(int p_offset) const {
+    const VisualGasicTokenizer::Token &t = peek(p_offset);
+    return t.type == VisualGasicTokenizer::TOKEN_IDENTIFIER && String(t.value).nocasecmp_to("Declare") == 0;
+}
+
+// Declare [PtrSafe] Sub|Function Name [CDecl] Lib "library" [Alias "symbol"] [(params)] [As Type]
+DeclareStatement* VisualGasicParser::parse_declare() {
+    advance(); // Eat Declare
+    if (String(peek().value).nocasecmp_to("PtrSafe") == 0) {
+        advance();
+    }
+    String kind = peek().value;
+    bool is_function = kind.nocasecmp_to("Function") == 0;
+    if (!is_function && kind.nocasecmp_to("Sub") != 0) {
+        error("Expected Sub or Function after Declare");
+        while (!is_at_end() && peek().type != VisualGasicTokenizer::TOKEN_NEWLINE) {
+            advance();
+        }
+        return nullptr;
+    }
+    advance();
+    if (!check(VisualGasicTokenizer::TOKEN_IDENTIFIER)) {
+        error("Expected procedure name after Declare " + kind);
+        return nullptr;
+    }
+    DeclareStatement* decl = make<DeclareStatement>();
+    decl->name = advance().value;
+
+    if (String(peek().value).nocasecmp_to("CDecl") == 0) {
+        decl->use_cdecl = true;
+        advance();
+    }
+    if (String(peek().value).nocasecmp_to("Lib") != 0 || peek(1).type != VisualGasicTokenizer::TOKEN_LITERAL_STRING) {
+        error("Expected Lib \"library\" in Declare " + decl->name);
+        return nullptr;
+    }
+    advance(); // Eat Lib
+    decl->lib_name = advance().value;
+    if (String(peek().value).nocasecmp_to("Alias") == 0 && peek(1).type == VisualGasicTokenizer::TOKEN_LITERAL_STRING) {
+        advance(); // Eat Alias
+        decl->alias_name = advance().value;
+    }
+
+    if (match(VisualGasicTokenizer::TOKEN_PAREN_OPEN)) {
+        while (!check(VisualGasicTokenizer::TOKEN_PAREN_CLOSE) && !is_at_end()) {
+            bool by_val = false;
+            if (check(VisualGasicTokenizer::TOKEN_KEYWORD)) {
+                String modifier = String(peek().value).to_lower();
+                if (modifier == "byval" || modifier == "byref") {
+                    by_val = modifier == "byval";
+                    advance();
+                }
+            }
+            if (!check(VisualGasicTokenizer::TOKEN_IDENTIFIER)) {
+                error("Expected parameter name in Declare " + decl->name);
+                return nullptr;
+            }
+            String param_name = advance().value;
+            String param_type;
+            if (check(VisualGasicTokenizer::TOKEN_KEYWORD) && String(peek().value).nocasecmp_to("As") == 0) {
+                advance(); // Eat As
+                param_type = advance().value;
+            }
+            decl->param_names.push_back(param_name);
+            decl->param_types.push_back(param_type);
+            decl->param_byval.push_back(by_val);
+            if (!match(VisualGasicTokenizer::TOKEN_COMMA)) {
+                break;
+            }
+        }
+        if (!match(VisualGasicTokenizer::TOKEN_PAREN_CLOSE)) {
+            error("Expected ) after parameters of Declare " + decl->name);
+            return nullptr;
+        }
+    }
+
+    if (is_function && check(VisualGasicTokenizer::TOKEN_KEYWORD) && String(peek().value).nocasecmp_to("As") == 0) {
+        advance(); // Eat As
+        decl->return_type = advance().value;
+    } else if (is_function) {
+        decl->return_type = "Variant";
+    }
+    return decl;
+}
+
 StructDefinition* VisualGasicParser::parse_struct() {
     advance(); // Eat Type
     
@@ -2406,7 +2576,7 @@ StructDefinition* VisualGasicParser::parse_struct() {
         return nullptr;
     }
     
-    StructDefinition* def = static_cast<StructDefinition*>(register_node(new StructDefinition()));
+    StructDefinition* def = make<StructDefinition>();
     def->name = peek().value;
     advance();
     
@@ -2416,7 +2586,7 @@ StructDefinition* VisualGasicParser::parse_struct() {
     }
     
     while (!is_at_end()) {
-        VisualGasicTokenizer::Token t = peek();
+        const VisualGasicTokenizer::Token &t = peek();
         // UtilityFunctions::print("ParseStruct Loop: ", t.value, " Type: ", t.type);
 
         if (check(VisualGasicTokenizer::TOKEN_KEYWORD) && String(peek().value).nocasecmp_to("End") == 0) {
@@ -2442,6 +2612,15 @@ StructDefinition* VisualGasicParser::parse_struct() {
                     member.type = peek().value;
                     advance();
                 }
+                if (check(VisualGasicTokenizer::TOKEN_OPERATOR) && String(peek().value) == "*") {
+                    advance(); // String * n
+                    if (check(VisualGasicTokenizer::TOKEN_LITERAL_INTEGER)) {
+                        member.fixed_length = MAX((int)peek().value, 0);
+                        advance();
+                    } else {
+                        error("Expected a length after 'String *'");
+                    }
+                }
             } else {
                 member.type = "Variant";
             }
@@ -2466,7 +2645,7 @@ StructDefinition* VisualGasicParser::parse_struct() {
 
 PrintStatement* VisualGasicParser::parse_print() {
     advance(); // Eat Print
-    PrintStatement* stmt = static_cast<PrintStatement*>(register_node(new PrintStatement()));
+    PrintStatement* stmt = make<PrintStatement>();
     
     // Check for #1
     if (check(VisualGasicTokenizer::TOKEN_OPERATOR) && peek().value == "#") {
@@ -2474,7 +2653,6 @@ PrintStatement* VisualGasicParser::parse_print() {
         {
             ExpressionNode* _tmp = parse_expression();
             stmt->file_number = _tmp;
-            unregister_node(_tmp);
         }
         if (check(VisualGasicTokenizer::TOKEN_COMMA)) {
             advance();
@@ -2487,7 +2665,6 @@ PrintStatement* VisualGasicParser::parse_print() {
         {
             ExpressionNode* _tmp = parse_expression();
             stmt->expression = _tmp;
-            unregister_node(_tmp);
         }
     }
     
@@ -2498,25 +2675,45 @@ OpenStatement* VisualGasicParser::parse_open() {
     advance(); // Eat Open
     
     // Open path For Mode As #Num
-    OpenStatement* stmt = static_cast<OpenStatement*>(register_node(new OpenStatement()));
+    OpenStatement* stmt = make<OpenStatement>();
     {
         ExpressionNode* _tmp = parse_expression();
         stmt->path = _tmp;
-        unregister_node(_tmp);
     }
     
     if (check(VisualGasicTokenizer::TOKEN_KEYWORD) && String(peek().value).nocasecmp_to("For") == 0) {
         advance();
-        if (check(VisualGasicTokenizer::TOKEN_KEYWORD)) {
+        // Binary and Random are not reserved words.
+        if (check(VisualGasicTokenizer::TOKEN_KEYWORD) || check(VisualGasicTokenizer::TOKEN_IDENTIFIER)) {
             String m = peek().value;
             if (m.nocasecmp_to("Input") == 0) stmt->mode = OpenStatement::MODE_INPUT;
             else if (m.nocasecmp_to("Output") == 0) stmt->mode = OpenStatement::MODE_OUTPUT;
             else if (m.nocasecmp_to("Append") == 0) stmt->mode = OpenStatement::MODE_APPEND;
+            else if (m.nocasecmp_to("Binary") == 0) stmt->mode = OpenStatement::MODE_BINARY;
+            else if (m.nocasecmp_to("Random") == 0) stmt->mode = OpenStatement::MODE_RANDOM;
             else UtilityFunctions::print("Parser Error: Unknown Open mode ", m);
             advance();
         }
     }
     
+    // Access Read | Write | Read Write
+    if (check(VisualGasicTokenizer::TOKEN_IDENTIFIER) && String(peek().value).nocasecmp_to("Access") == 0) {
+        advance();
+        bool read = false;
+        bool write = false;
+        while (check(VisualGasicTokenizer::TOKEN_KEYWORD) || check(VisualGasicTokenizer::TOKEN_IDENTIFIER)) {
+            String a = peek().value;
+            if (a.nocasecmp_to("Read") == 0) read = true;
+            else if (a.nocasecmp_to("Write") == 0) write = true;
+            else break;
+            advance();
+        }
+        if (read && write) stmt->access = OpenStatement::ACCESS_READ_WRITE;
+        else if (read) stmt->access = OpenStatement::ACCESS_READ;
+        else if (write) stmt->access = OpenStatement::ACCESS_WRITE;
+        else error("Expected Read or Write after 'Access' in Open statement");
+    }
+    
     if (check(VisualGasicTokenizer::TOKEN_KEYWORD) && String(peek().value).nocasecmp_to("As") == 0) {
         advance();
         if (check(VisualGasicTokenizer::TOKEN_OPERATOR) && peek().value == "#") {
@@ -2525,7 +2722,18 @@ OpenStatement* VisualGasicParser::parse_open() {
         {
             ExpressionNode* _tmp = parse_expression();
             stmt->file_number = _tmp;
-            unregister_node(_tmp);
+        }
+    }
+    
+    // Len = record length
+    if (check(VisualGasicTokenizer::TOKEN_IDENTIFIER) && String(peek().value).nocasecmp_to("Len") == 0 &&
+            peek(1).type == VisualGasicTokenizer::TOKEN_OPERATOR && peek(1).value == "=") {
+        advance();
+        advance();
+        stmt->record_length = parse_expression();
+        if (!stmt->record_length) {
+            error("Expected record length after 'Len =' in Open statement");
+            return nullptr;
         }
     }
     
@@ -2535,7 +2743,7 @@ OpenStatement* VisualGasicParser::parse_open() {
 CloseStatement* VisualGasicParser::parse_close() {
     advance(); // Eat Close
     
-    CloseStatement* stmt = static_cast<CloseStatement*>(register_node(new CloseStatement()));
+    CloseStatement* stmt = make<CloseStatement>();
     if (check(VisualGasicTokenizer::TOKEN_OPERATOR) && peek().value == "#") {
         advance();
     }
@@ -2544,7 +2752,6 @@ CloseStatement* VisualGasicParser::parse_close() {
          {
              ExpressionNode* _tmp = parse_expression();
              stmt->file_number = _tmp;
-             unregister_node(_tmp);
          }
     }
     
@@ -2555,7 +2762,7 @@ SeekStatement* VisualGasicParser::parse_seek() {
     advance(); // Eat Seek
     // Seek #FileNum, Position
     
-    SeekStatement* stmt = static_cast<SeekStatement*>(register_node(new SeekStatement()));
+    SeekStatement* stmt = make<SeekStatement>();
     
     // Check #
     if (check(VisualGasicTokenizer::TOKEN_OPERATOR) && peek().value == "#") {
@@ -2565,11 +2772,9 @@ SeekStatement* VisualGasicParser::parse_seek() {
     {
         ExpressionNode* _tmp = parse_expression();
         stmt->file_number = _tmp;
-        unregister_node(_tmp);
     }
         if (!stmt->file_number) {
         error("Expected file number in Seek statement");
-        unregister_node(stmt); delete stmt;
         return nullptr;
     }
     
@@ -2577,18 +2782,54 @@ SeekStatement* VisualGasicParser::parse_seek() {
         advance();
         } else {
         error("Expected comma after file number in Seek statement");
-        unregister_node(stmt); delete stmt;
         return nullptr;
     }
     
     {
         ExpressionNode* _tmp = parse_expression();
         stmt->position = _tmp;
-        unregister_node(_tmp);
     }
     if (!stmt->position) {
         error("Expected position expression in Seek statement");
-        unregister_node(stmt); delete stmt;
+        return nullptr;
+    }
+    
+    return stmt;
+}
+
+FileRecordStatement* VisualGasicParser::parse_file_record(bool is_put) {
+    advance(); // Eat Get / Put
+    // Get #FileNum, [Position], Variable
+    
+    FileRecordStatement* stmt = make<FileRecordStatement>();
+    stmt->is_put = is_put;
+    advance(); // Eat #
+    
+    stmt->file_number = parse_expression();
+    if (!stmt->file_number) {
+        error("Expected file number in Get/Put statement");
+        return nullptr;
+    }
+    if (!check(VisualGasicTokenizer::TOKEN_COMMA)) {
+        error("Expected comma after file number in Get/Put statement");
+        return nullptr;
+    }
+    advance();
+    
+    if (check(VisualGasicTokenizer::TOKEN_COMMA)) {
+        advance(); // Position omitted: continue from the current one
+    } else {
+        stmt->position = parse_expression();
+        if (!stmt->position || !check(VisualGasicTokenizer::TOKEN_COMMA)) {
+            error("Expected position and comma in Get/Put statement");
+            return nullptr;
+        }
+        advance();
+    }
+    
+    stmt->variable = parse_expression();
+    if (!stmt->variable) {
+        error("Expected variable in Get/Put statement");
         return nullptr;
     }
     
@@ -2597,15 +2838,13 @@ SeekStatement* VisualGasicParser::parse_seek() {
 
 KillStatement* VisualGasicParser::parse_kill() {
     advance(); // Eat Kill
-    KillStatement* stmt = static_cast<KillStatement*>(register_node(new KillStatement()));
+    KillStatement* stmt = make<KillStatement>();
     {
         ExpressionNode* _tmp = parse_expression();
         stmt->path = _tmp;
-        unregister_node(_tmp);
     }
     if (!stmt->path) {
         error("Expected path expression in Kill statement");
-        unregister_node(stmt); delete stmt;
         return nullptr;
     }
     return stmt;
@@ -2613,17 +2852,15 @@ KillStatement* VisualGasicParser::parse_kill() {
 
 NameStatement* VisualGasicParser::parse_name() {
     advance(); // Eat Name
-    NameStatement* stmt = static_cast<NameStatement*>(register_node(new NameStatement()));
+    NameStatement* stmt = make<NameStatement>();
     
     // Name Old As New
     {
         ExpressionNode* _tmp = parse_expression();
         stmt->old_path = _tmp;
-        unregister_node(_tmp);
     }
     if (!stmt->old_path) {
         error("Expected old file path in Name statement");
-        unregister_node(stmt); delete stmt;
         return nullptr;
     }
     
@@ -2631,18 +2868,15 @@ NameStatement* VisualGasicParser::parse_name() {
         advance();
     } else {
         error("Expected 'As' in Name statement");
-        unregister_node(stmt); delete stmt;
         return nullptr;
     }
     
     {
         ExpressionNode* _tmp = parse_expression();
         stmt->new_path = _tmp;
-        unregister_node(_tmp);
     }
     if (!stmt->new_path) {
         error("Expected new file path in Name statement");
-        unregister_node(stmt); delete stmt;
         return nullptr;
     }
     
@@ -2651,12 +2885,12 @@ NameStatement* VisualGasicParser::parse_name() {
 
 DataStatement* VisualGasicParser::parse_data() {
     advance(); // Eat Data
-    DataStatement* stmt = static_cast<DataStatement*>(register_node(new DataStatement()));
+    DataStatement* stmt = make<DataStatement>();
     
     while (!check(VisualGasicTokenizer::TOKEN_NEWLINE) && !check(VisualGasicTokenizer::TOKEN_EOF)) {
         {
             ExpressionNode* _tmp = parse_expression();
-            if (_tmp) { stmt->values.push_back(_tmp); unregister_node(_tmp); }
+            if (_tmp) { stmt->values.push_back(_tmp); }
         }
         
         if (check(VisualGasicTokenizer::TOKEN_COMMA)) {
@@ -2670,13 +2904,13 @@ DataStatement* VisualGasicParser::parse_data() {
 
 ReadStatement* VisualGasicParser::parse_read() {
     advance(); // Eat Read
-    ReadStatement* stmt = static_cast<ReadStatement*>(register_node(new ReadStatement()));
+    ReadStatement* stmt = make<ReadStatement>();
     
     while (!check(VisualGasicTokenizer::TOKEN_NEWLINE) && !check(VisualGasicTokenizer::TOKEN_EOF)) {
         // Parse L-Values (Variables, Array elements, Properties)
         {
             ExpressionNode* _tmp = parse_expression();
-            if (_tmp) { stmt->targets.push_back(_tmp); unregister_node(_tmp); }
+            if (_tmp) { stmt->targets.push_back(_tmp); }
         }
         
         if (check(VisualGasicTokenizer::TOKEN_COMMA)) {
@@ -2690,7 +2924,7 @@ ReadStatement* VisualGasicParser::parse_read() {
 
 RestoreStatement* VisualGasicParser::parse_restore() {
     advance(); // Eat Restore
-    RestoreStatement* stmt = static_cast<RestoreStatement*>(register_node(new RestoreStatement()));
+    RestoreStatement* stmt = make<RestoreStatement>();
     
     if (check(VisualGasicTokenizer::TOKEN_IDENTIFIER)) {
         stmt->label_name = peek().value;
@@ -2699,7 +2933,7 @@ RestoreStatement* VisualGasicParser::parse_restore() {
     return stmt;
 }
 
-Vector<ExpressionNode*> VisualGasicParser::parse_data_values_from_text(const String& text) {
+Vector<ExpressionNode*> VisualGasicParser::parse_data_values_from_text(const String& text, ASTArena& p_arena) {
     Vector<ExpressionNode*> values;
     
     // Wrap to hack reused parser
@@ -2723,10 +2957,11 @@ Vector<ExpressionNode*> VisualGasicParser::parse_data_values_from_text(const Str
                 DataStatement* ds = (DataStatement*)s;
                 for(int k=0; k<ds->values.size(); k++) {
                     values.push_back(ds->values[k]);
-                    ds->values.write[k] = nullptr; // prevent delete by ModuleNode
                 }
             }
         }
+        // The values live in the temporary module's arena; keep them alive in the caller's.
+        p_arena.adopt(sub_module->arena);
         delete sub_module;
     }
     return values;
@@ -2757,23 +2992,21 @@ DataStatement* VisualGasicParser::parse_data_file() {
     String content = file->get_as_text();
     file->close();
     
-    DataStatement* stmt = static_cast<DataStatement*>(register_node(new DataStatement()));
-    stmt->values = parse_data_values_from_text(content);
+    DataStatement* stmt = make<DataStatement>();
+    stmt->values = parse_data_values_from_text(content, *arena);
     return stmt;
 }
 
 LoadDataStatement* VisualGasicParser::parse_load_data() {
     advance(); // Eat LoadData
     
-    LoadDataStatement* stmt = static_cast<LoadDataStatement*>(register_node(new LoadDataStatement()));
+    LoadDataStatement* stmt = make<LoadDataStatement>();
     {
         ExpressionNode* _tmp = parse_expression();
         stmt->path_expression = _tmp;
-        unregister_node(_tmp);
     }
     if (!stmt->path_expression) {
         error("Expected string expression for file path after LoadData");
-        unregister_node(stmt); delete stmt;
         return nullptr;
     }
     return stmt;
@@ -2783,7 +3016,7 @@ InputStatement* VisualGasicParser::parse_input(bool is_line) {
     if (is_line) advance(); // Input token
     else advance(); // Eat Input
     
-    InputStatement* stmt = static_cast<InputStatement*>(register_node(new InputStatement()));
+    InputStatement* stmt = make<InputStatement>();
     stmt->is_line_input = is_line;
     
     // Check #
@@ -2810,7 +3043,7 @@ InputStatement* VisualGasicParser::parse_input(bool is_line) {
         // parse_expression will parse Variable, Member, Array.
         {
             ExpressionNode* _tmp = parse_expression();
-            if (_tmp) { stmt->variables.push_back(_tmp); unregister_node(_tmp); }
+            if (_tmp) { stmt->variables.push_back(_tmp); }
         }
         
         if (check(VisualGasicTokenizer::TOKEN_COMMA)) {
@@ -2829,7 +3062,7 @@ ExitStatement* VisualGasicParser::parse_exit() {
     if (check(VisualGasicTokenizer::TOKEN_KEYWORD) || check(VisualGasicTokenizer::TOKEN_IDENTIFIER)) {
         String type = String(peek().value).to_lower();
         
-        ExitStatement* s = static_cast<ExitStatement*>(register_node(new ExitStatement()));
+        ExitStatement* s = make<ExitStatement>();
         bool valid = false;
         
         if (type == "sub") {
@@ -2850,7 +3083,6 @@ ExitStatement* VisualGasicParser::parse_exit() {
             advance();
             return s;
         } else {
-            unregister_node(s); delete s;
             return nullptr;
         }
     }
@@ -2865,7 +3097,7 @@ ConstStatement* VisualGasicParser::parse_const() {
         return nullptr;
     }
     
-    ConstStatement* s = static_cast<ConstStatement*>(register_node(new ConstStatement()));
+    ConstStatement* s = make<ConstStatement>();
     s->name = peek().value;
     advance();
     
@@ -2881,7 +3113,6 @@ ConstStatement* VisualGasicParser::parse_const() {
         {
             ExpressionNode* _tmp = parse_expression();
             s->value = _tmp;
-            unregister_node(_tmp);
         }
     } else {
         UtilityFunctions::print("Parser Error: Expected = in Const definition");
@@ -2893,7 +3124,7 @@ ConstStatement* VisualGasicParser::parse_const() {
 ReDimStatement* VisualGasicParser::parse_redim() {
     advance(); // Eat ReDim
     
-    ReDimStatement* s = static_cast<ReDimStatement*>(register_node(new ReDimStatement()));
+    ReDimStatement* s = make<ReDimStatement>();
     
     if (check(VisualGasicTokenizer::TOKEN_KEYWORD) && String(peek().value).nocasecmp_to("preserve") == 0) {
         s->preserve = true;
@@ -2902,7 +3133,6 @@ ReDimStatement* VisualGasicParser::parse_redim() {
     
     if (!check(VisualGasicTokenizer::TOKEN_IDENTIFIER)) {
         UtilityFunctions::print("Parser Error: Expected variable name after ReDim");
-        unregister_node(s); delete s;
         return nullptr;
     }
     
@@ -2916,7 +3146,7 @@ ReDimStatement* VisualGasicParser::parse_redim() {
             while (true) {
                 {
                     ExpressionNode* _tmp = parse_expression();
-                    if (_tmp) { s->array_sizes.push_back(_tmp); unregister_node(_tmp); }
+                    if (_tmp) { s->array_sizes.push_back(_tmp); }
                 }
                 if (check(VisualGasicTokenizer::TOKEN_COMMA)) {
                     advance();
@@ -2944,7 +3174,7 @@ ReDimStatement* VisualGasicParser::parse_redim() {
 TryStatement* VisualGasicParser::parse_try() {
     advance(); // Eat Try
     
-    TryStatement* s = static_cast<TryStatement*>(register_node(new TryStatement()));
+    TryStatement* s = make<TryStatement>();
     
     // Parse Try Block
     while (!is_at_end()) {
@@ -2963,7 +3193,7 @@ TryStatement* VisualGasicParser::parse_try() {
         }
         
         Statement* stmt = parse_statement();
-        if (stmt) { s->try_block.push_back(stmt); unregister_node(stmt); }
+        if (stmt) { s->try_block.push_back(stmt); }
         else advance(); 
     }
     
@@ -2971,7 +3201,7 @@ TryStatement* VisualGasicParser::parse_try() {
     if (check(VisualGasicTokenizer::TOKEN_KEYWORD) && String(peek().value).to_lower() == "catch") {
         advance(); // Eat Catch
         
-        VisualGasicTokenizer::Token vars = peek();
+        const VisualGasicTokenizer::Token &vars = peek();
         // Optional Variable? Catch ex As Exception?
         if (check(VisualGasicTokenizer::TOKEN_IDENTIFIER)) {
             // Store exception variable name
@@ -2996,7 +3226,7 @@ TryStatement* VisualGasicParser::parse_try() {
                  }
              }
              Statement* stmt = parse_statement();
-             if (stmt) { s->catch_block.push_back(stmt); unregister_node(stmt); }
+             if (stmt) { s->catch_block.push_back(stmt); }
              else advance();
         }
     }
@@ -3015,7 +3245,7 @@ TryStatement* VisualGasicParser::parse_try() {
                  }
              }
              Statement* stmt = parse_statement();
-             if (stmt) { s->finally_block.push_back(stmt); unregister_node(stmt); }
+             if (stmt) { s->finally_block.push_back(stmt); }
              else advance();
         }
     }
@@ -3032,12 +3262,11 @@ TryStatement* VisualGasicParser::parse_try() {
 
 RaiseStatement* VisualGasicParser::parse_raise() {
     advance(); // Eat Raise
-    RaiseStatement* s = static_cast<RaiseStatement*>(register_node(new RaiseStatement()));
+    RaiseStatement* s = make<RaiseStatement>();
     
     {
         ExpressionNode* _tmp = parse_expression();
         s->error_code = _tmp;
-        unregister_node(_tmp);
     }
     if (!s->error_code) {
         error("Expected error code in Raise statement");
@@ -3048,7 +3277,6 @@ RaiseStatement* VisualGasicParser::parse_raise() {
         {
             ExpressionNode* _tmp = parse_expression();
             s->message = _tmp;
-            unregister_node(_tmp);
         }
     }
     
@@ -3064,7 +3292,7 @@ WheneverSectionStatement* VisualGasicParser::parse_whenever() {
     }
     advance(); // Eat "Section"
     
-    WheneverSectionStatement* stmt = static_cast<WheneverSectionStatement*>(register_node(new WheneverSectionStatement()));
+    WheneverSectionStatement* stmt = make<WheneverSectionStatement>();
     
     // Check for optional "Local" scope modifier
     bool is_local = false;
@@ -3088,7 +3316,6 @@ WheneverSectionStatement* VisualGasicParser::parse_whenever() {
         
         ExpressionNode* _tmp = parse_expression(); // This will handle the entire parenthetical expression
         stmt->condition_expression = _tmp;
-        unregister_node(_tmp);
         
         stmt->comparison_operator = "expression"; // Special marker for complex expressions
     } else {
@@ -3118,7 +3345,6 @@ WheneverSectionStatement* VisualGasicParser::parse_whenever() {
         if (op != "changes") {
             ExpressionNode* _tmp = parse_expression();
             stmt->comparison_value = _tmp;
-            unregister_node(_tmp);
             
             // Handle "Between X And Y" syntax
             if (op == "between") {
@@ -3130,7 +3356,6 @@ WheneverSectionStatement* VisualGasicParser::parse_whenever() {
                 
                 ExpressionNode* _tmp2 = parse_expression();
                 stmt->comparison_value2 = _tmp2;
-                unregister_node(_tmp2);
             }
         }
     }
@@ -3163,7 +3388,7 @@ WheneverSectionStatement* VisualGasicParser::parse_whenever() {
 }
 
 SuspendWheneverStatement* VisualGasicParser::parse_suspend_whenever() {
-    SuspendWheneverStatement* stmt = static_cast<SuspendWheneverStatement*>(register_node(new SuspendWheneverStatement()));
+    SuspendWheneverStatement* stmt = make<SuspendWheneverStatement>();
     
     if (!check(VisualGasicTokenizer::TOKEN_IDENTIFIER)) {
         error("Expected section name after 'Suspend Whenever'");
@@ -3176,7 +3401,7 @@ SuspendWheneverStatement* VisualGasicParser::parse_suspend_whenever() {
 }
 
 ResumeWheneverStatement* VisualGasicParser::parse_resume_whenever() {
-    ResumeWheneverStatement* stmt = static_cast<ResumeWheneverStatement*>(register_node(new ResumeWheneverStatement()));
+    ResumeWheneverStatement* stmt = make<ResumeWheneverStatement>();
     
     if (!check(VisualGasicTokenizer::TOKEN_IDENTIFIER)) {
         error("Expected section name after 'Resume Whenever'");
@@ -3201,7 +3426,7 @@ void VisualGasicParser::parse_enum() {
     String enum_name = peek().value;
     advance();
     
-    EnumDefinition* def = static_cast<EnumDefinition*>(register_node(new EnumDefinition()));
+    EnumDefinition* def = make<EnumDefinition>();
     def->name = enum_name;
     
     int next_val = 0;
@@ -3233,7 +3458,6 @@ void VisualGasicParser::parse_enum() {
                 if (expr && expr->type == ExpressionNode::LITERAL) {
                     val = (int)((LiteralNode*)expr)->value;
                 }
-                if (expr) { unregister_node(expr); delete expr; }
              }
              
              EnumValue ev;
@@ -3249,15 +3473,13 @@ void VisualGasicParser::parse_enum() {
     
     if (current_module) {
         current_module->enums.push_back(def);
-    } else {
-        delete def;
     }
 }
 
 // === MULTITASKING PARSING FUNCTIONS ===
 
 AsyncFunctionStatement* VisualGasicParser::parse_async_function() {
-    AsyncFunctionStatement* async_func = static_cast<AsyncFunctionStatement*>(register_node(new AsyncFunctionStatement()));
+    AsyncFunctionStatement* async_func = make<AsyncFunctionStatement>();
     
     // Should be "Sub" or "Function" 
     bool is_function = false;
@@ -3286,7 +3508,7 @@ AsyncFunctionStatement* VisualGasicParser::parse_async_function() {
     if (check(VisualGasicTokenizer::TOKEN_PAREN_OPEN)) {
         advance(); // (
         while (!check(VisualGasicTokenizer::TOKEN_PAREN_CLOSE) && !is_at_end()) {
-            Parameter* param = new Parameter();
+            Parameter* param = make<Parameter>();
             param->name = peek().value;
             advance();
             
@@ -3353,9 +3575,9 @@ Statement* VisualGasicParser::parse_await() {
     
     // Create await statement using assignment AST
     // Target is a VariableNode for __await_result__
-    AssignmentStatement* await_stmt = static_cast<AssignmentStatement*>(register_node(new AssignmentStatement()));
+    AssignmentStatement* await_stmt = make<AssignmentStatement>();
     
-    VariableNode* target = new VariableNode();
+    VariableNode* target = make<VariableNode>();
     target->name = "__await_result__";
     
     await_stmt->target = target;
@@ -3365,7 +3587,7 @@ Statement* VisualGasicParser::parse_await() {
 }
 
 TaskRunStatement* VisualGasicParser::parse_task_run() {
-    TaskRunStatement* task = static_cast<TaskRunStatement*>(register_node(new TaskRunStatement()));
+    TaskRunStatement* task = make<TaskRunStatement>();
     
     // Optional task name
     if (check(VisualGasicTokenizer::TOKEN_IDENTIFIER)) {
@@ -3398,7 +3620,7 @@ TaskRunStatement* VisualGasicParser::parse_task_run() {
 }
 
 TaskWaitStatement* VisualGasicParser::parse_task_wait() {
-    TaskWaitStatement* wait_stmt = static_cast<TaskWaitStatement*>(register_node(new TaskWaitStatement()));
+    TaskWaitStatement* wait_stmt = make<TaskWaitStatement>();
     
     String wait_type = String(peek().value).to_lower();
     advance();
@@ -3430,7 +3652,7 @@ TaskWaitStatement* VisualGasicParser::parse_task_wait() {
 }
 
 ParallelForStatement* VisualGasicParser::parse_parallel_for() {
-    ParallelForStatement* par_for = static_cast<ParallelForStatement*>(register_node(new ParallelForStatement()));
+    ParallelForStatement* par_for = make<ParallelForStatement>();
     
     // Variable name
     if (!check(VisualGasicTokenizer::TOKEN_IDENTIFIER)) {
@@ -3482,7 +3704,7 @@ ParallelForStatement* VisualGasicParser::parse_parallel_for() {
 }
 
 ParallelSectionStatement* VisualGasicParser::parse_parallel_section() {
-    ParallelSectionStatement* par_section = static_cast<ParallelSectionStatement*>(register_node(new ParallelSectionStatement()));
+    ParallelSectionStatement* par_section = make<ParallelSectionStatement>();
     
     match(VisualGasicTokenizer::TOKEN_NEWLINE);
     
@@ -3511,7 +3733,7 @@ ParallelSectionStatement* VisualGasicParser::parse_parallel_section() {
 // === ADVANCED TYPE SYSTEM PARSING ===
 
 PatternMatchStatement* VisualGasicParser::parse_pattern_match() {
-    PatternMatchStatement* match_stmt = static_cast<PatternMatchStatement*>(register_node(new PatternMatchStatement()));
+    PatternMatchStatement* match_stmt = make<PatternMatchStatement>();
     
     // Parse the expression to match
     match_stmt->expression = parse_expression();
@@ -3547,14 +3769,14 @@ PatternMatchStatement* VisualGasicParser::parse_pattern_match() {
 }
 
 MatchCase* VisualGasicParser::parse_match_case() {
-    MatchCase* match_case = new MatchCase();
+    MatchCase* match_case = make<MatchCase>();
     
     advance(); // consume "case"
     
     // Check for Case Else
     if (check(VisualGasicTokenizer::TOKEN_KEYWORD) && String(peek().value).to_lower() == "else") {
         advance();
-        Pattern* else_pattern = new Pattern();
+        Pattern* else_pattern = make<Pattern>();
         else_pattern->type = Pattern::VARIABLE_PATTERN;
         else_pattern->variable_name = "_"; // Wildcard
         match_case->pattern = else_pattern;
@@ -3580,7 +3802,7 @@ MatchCase* VisualGasicParser::parse_match_case() {
 }
 
 Pattern* VisualGasicParser::parse_pattern() {
-    Pattern* pattern = new Pattern();
+    Pattern* pattern = make<Pattern>();
     
     // Type pattern: Success(value)
     if (check(VisualGasicTokenizer::TOKEN_IDENTIFIER)) {
@@ -3594,7 +3816,7 @@ Pattern* VisualGasicParser::parse_pattern() {
             advance(); // (
             
             while (!check(VisualGasicTokenizer::TOKEN_PAREN_CLOSE) && !is_at_end()) {
-                Pattern* sub_pattern = new Pattern();
+                Pattern* sub_pattern = make<Pattern>();
                 sub_pattern->type = Pattern::VARIABLE_PATTERN;
                 sub_pattern->variable_name = peek().value;
                 pattern->sub_patterns.push_back(sub_pattern);
@@ -3644,7 +3866,7 @@ Pattern* VisualGasicParser::parse_pattern() {
 }
 
 AdvancedType* VisualGasicParser::parse_advanced_type() {
-    AdvancedType* type = new AdvancedType();
+    AdvancedType* type = make<AdvancedType>();
     
     if (!check(VisualGasicTokenizer::TOKEN_IDENTIFIER)) {
         error("Expected type name");
@@ -3689,7 +3911,7 @@ AdvancedType* VisualGasicParser::parse_advanced_type() {
 }
 
 SubDefinition* VisualGasicParser::parse_generic_function() {
-    SubDefinition* sub = new SubDefinition();
+    SubDefinition* sub = make<SubDefinition>();
     
     // Function name
     if (check(VisualGasicTokenizer::TOKEN_IDENTIFIER)) {
@@ -3705,7 +3927,7 @@ SubDefinition* VisualGasicParser::parse_generic_function() {
             advance(); // of
             
             while (!check(VisualGasicTokenizer::TOKEN_PAREN_CLOSE) && !is_at_end()) {
-                GenericTypeParameter* param = new GenericTypeParameter();
+                GenericTypeParameter* param = make<GenericTypeParameter>();
                 param->name = peek().value;
                 advance();
                 
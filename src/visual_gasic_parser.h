@@ -11,12 +11,23 @@ class VisualGasicParser {
     Vector<VisualGasicTokenizer::Token> tokens;
     int current_pos;
 
-    VisualGasicTokenizer::Token peek(int offset = 0);
-    VisualGasicTokenizer::Token advance();
-    VisualGasicTokenizer::Token previous();
+    const VisualGasicTokenizer::Token &peek(int offset = 0) const;
+    const VisualGasicTokenizer::Token &advance();
+    const VisualGasicTokenizer::Token &previous() const;
     bool match(VisualGasicTokenizer::TokenType type);
-    bool check(VisualGasicTokenizer::TokenType type);
-    bool is_at_end();
+    bool check(VisualGasicTokenizer::TokenType type) const;
+    bool is_at_end() const;
+
+    // Arena of the module being parsed; every node is allocated from it.
+    ASTArena* arena = nullptr;
+    template <typename T>
+    T* make() { return arena->alloc<T>(); }
+
+    // Source text of the tokens, for declaration hashes (nullptr when not given).
+    const char32_t* source = nullptr;
+    uint64_t hash_span(int p_first, int p_end, uint64_t p_seed = 0) const;
+    uint64_t hash_tokens(int p_first, int p_end, uint64_t p_seed) const;
+    int find_sub_end(int p_start) const;
 
 public:
     struct ParsingError {
@@ -33,14 +44,25 @@ public:
 
     ModuleNode* current_module; // Store reference to module being parsed
     
-    ModuleNode* parse(const Vector<VisualGasicTokenizer::Token>& p_tokens);
-    static Vector<ExpressionNode*> parse_data_values_from_text(const String& text);
+    // p_source is the text p_tokens came from; with it, each Sub/Function is
+    // recorded in ModuleNode::declarations. Subs of p_previous whose text and
+    // preceding module-level declarations are unchanged are reused instead of
+    // parsed again. If any is reused, the result takes over p_previous's arena:
+    // delete p_previous afterwards without touching its nodes. On failure
+    // p_previous is left as it was.
+    ModuleNode* parse(const Vector<VisualGasicTokenizer::Token>& p_tokens, const String& p_source = String(), ModuleNode* p_previous = nullptr);
+    // Parses DATA values from text; the nodes are allocated in p_arena.
+    static Vector<ExpressionNode*> parse_data_values_from_text(const String& text, ASTArena& p_arena);
 
 private:
     void error(const String& message);
 
     SubDefinition* parse_sub();
     StructDefinition* parse_struct();
+    bool is_class_start(int p_offset) const;
+    ClassDefinition* parse_class();
+    bool is_declare_start(int p_offset) const;
+    DeclareStatement* parse_declare();
     EventDefinition* parse_event();
     Statement* parse_statement();
     
@@ -66,6 +88,7 @@ private:
     OpenStatement* parse_open();
     CloseStatement* parse_close();
     SeekStatement* parse_seek();
+    FileRecordStatement* parse_file_record(bool is_put);
     KillStatement* parse_kill();
     NameStatement* parse_name();
     TryStatement* parse_try();
@@ -109,24 +132,7 @@ private:
     ExpressionNode* parse_unary();
     ExpressionNode* parse_factor();     // ( ) Lit Var Call unary-
 
-    // Parser-owned allocations tracking: register nodes created during
-    // parsing so the parser can free them on failure. On successful
-    // parse ownership is typically transferred to the returned
-    // `ModuleNode`, in which case the parser will clear the tracker
-    // without deleting the nodes.
-    ASTNode* register_node(ASTNode* p_node);
-    void unregister_node(ASTNode* p_node);
-    ExpressionNode* register_node(ExpressionNode* p_node);
-    void unregister_node(ExpressionNode* p_node);
-
-    // Internal list of parser-owned allocations
-    Vector<ASTNode*> allocated_nodes;
-    Vector<ExpressionNode*> allocated_expr_nodes;
 public:
-    // Clear tracked allocations without deleting them (used when ownership
-    // has been transferred to the AST to avoid double-free in parser dtor).
-    void clear_tracked_nodes();
-
     static String format_iif_to_inline(const String& p_source);
 };
 
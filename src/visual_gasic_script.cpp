@@ -2,8 +2,14 @@
 #include "visual_gasic_language.h"
 #include "visual_gasic_instance.h"
 #include "visual_gasic_compiler.h"
+#include "visual_gasic_binder.h"
+#include "visual_gasic_builtins.h"
+#if VG_USE_FFI
+#include "visual_gasic_ffi.h"
+#endif
 #include <godot_cpp/godot.hpp>
 #include <godot_cpp/classes/resource_loader.hpp>
+#include <godot_cpp/classes/time.hpp>
 
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
@@ -132,6 +138,30 @@ String opcode_name(uint8_t op) {
         OP_NAME_CASE(OP_NIL);
         OP_NAME_CASE(OP_TRUE);
         OP_NAME_CASE(OP_FALSE);
+        OP_NAME_CASE(OP_CALL_USER);
+        OP_NAME_CASE(OP_WIDE);
+        OP_NAME_CASE(OP_R_LOADK_I64);
+        OP_NAME_CASE(OP_R_LOADK_F64);
+        OP_NAME_CASE(OP_R_MOV);
+        OP_NAME_CASE(OP_R_I64_TO_F64);
+        OP_NAME_CASE(OP_R_ADD_I64);
+        OP_NAME_CASE(OP_R_SUB_I64);
+        OP_NAME_CASE(OP_R_MUL_I64);
+        OP_NAME_CASE(OP_R_ADDK_I64);
+        OP_NAME_CASE(OP_R_SUBK_I64);
+        OP_NAME_CASE(OP_R_MULK_I64);
+        OP_NAME_CASE(OP_R_ADD_F64);
+        OP_NAME_CASE(OP_R_SUB_F64);
+        OP_NAME_CASE(OP_R_MUL_F64);
+        OP_NAME_CASE(OP_R_DIV_F64);
+        OP_NAME_CASE(OP_R_INC_I64);
+        OP_NAME_CASE(OP_R_JUMP_IF_NOT_I64);
+        OP_NAME_CASE(OP_R_JUMP_IF_NOT_I64K);
+        OP_NAME_CASE(OP_R_GET_ARRAY_I64);
+        OP_NAME_CASE(OP_R_GET_ARRAY_F64);
+        OP_NAME_CASE(OP_R_GET_ARRAY_I64_GUARDED);
+        OP_NAME_CASE(OP_R_GET_ARRAY_F64_GUARDED);
+        OP_NAME_CASE(OP_R_GUARD_ARRAY);
         OP_NAME_CASE(OP_ABS);
         OP_NAME_CASE(OP_SGN);
 #undef OP_NAME_CASE
@@ -168,6 +198,7 @@ int opcode_operand_length(uint8_t op) {
         case OP_SET_DICT_FAST:
         case OP_GET_DICT_TRUSTED:
         case OP_SET_DICT_TRUSTED:
+        case OP_R_INC_I64:
             return 1;
         case OP_CONSTANT_LONG:
         case OP_ADD_LOCAL_I64_CONST:
@@ -178,10 +209,37 @@ int opcode_operand_length(uint8_t op) {
         case OP_LOOP:
         case OP_CALL:
         case OP_CALL_BUILTIN:
+        case OP_CALL_USER:
+        case OP_WIDE:
+        case OP_R_LOADK_I64:
+        case OP_R_LOADK_F64:
+        case OP_R_MOV:
+        case OP_R_I64_TO_F64:
             return 2;
         case OP_STRING_REPEAT_OUTER:
         case OP_INTEROP_SET_NAME_LEN:
             return 2;
+        case OP_R_ADD_I64:
+        case OP_R_SUB_I64:
+        case OP_R_MUL_I64:
+        case OP_R_ADDK_I64:
+        case OP_R_SUBK_I64:
+        case OP_R_MULK_I64:
+        case OP_R_ADD_F64:
+        case OP_R_SUB_F64:
+        case OP_R_MUL_F64:
+        case OP_R_DIV_F64:
+        case OP_R_GET_ARRAY_I64:
+        case OP_R_GET_ARRAY_F64:
+        case OP_R_GET_ARRAY_I64_GUARDED:
+        case OP_R_GET_ARRAY_F64_GUARDED:
+            return 3;
+        case OP_ACCUM_I64_MULADD_CONST:
+        case OP_R_GUARD_ARRAY:
+            return 4;
+        case OP_R_JUMP_IF_NOT_I64:
+        case OP_R_JUMP_IF_NOT_I64K:
+            return 5;
         case OP_ALLOC_FILL_REPEAT_I64:
             return 6;
         default:
@@ -189,19 +247,25 @@ int opcode_operand_length(uint8_t op) {
     }
 }
 
-String describe_jump_target(uint8_t op, const Array &operands, int offset) {
+String describe_jump_target(uint8_t op, const Array &operands, int offset, uint32_t wide) {
     if (operands.size() < 2) {
         return String();
     }
     int hi = int(operands[0]);
     int lo = int(operands[1]);
-    int delta = (hi << 8) | lo;
+    int delta = (int)((wide << 16) | (uint32_t)(hi << 8) | (uint32_t)lo);
     int next_ip = offset + 3;
     int target = (op == OP_LOOP) ? (next_ip - delta) : (next_ip + delta);
     return vformat("delta=%d -> %04d", delta, target);
 }
 
-String describe_operands(uint8_t op, const Array &operands, const BytecodeChunk *chunk, int offset) {
+// `wide` is the payload of a preceding OP_WIDE; it extends the first index
+// operand (or the jump offset) the same way the VM does.
+String describe_operands(uint8_t op, const Array &raw_operands, const BytecodeChunk *chunk, int offset, uint32_t wide) {
+    Array operands = raw_operands.duplicate(); // Array copies share storage
+    if (wide != 0 && operands.size() >= 1 && op != OP_JUMP && op != OP_JUMP_IF_FALSE && op != OP_LOOP) {
+        operands[0] = (int)((wide << 8) | (uint32_t)int(operands[0]));
+    }
     switch (op) {
         case OP_CONSTANT:
             if (operands.size() >= 1) {
@@ -210,7 +274,7 @@ String describe_operands(uint8_t op, const Array &operands, const BytecodeChunk
             break;
         case OP_CONSTANT_LONG:
             if (operands.size() >= 2) {
-                int idx = (int(operands[1]) << 8) | int(operands[0]);
+                int idx = (int(operands[0]) << 8) | int(operands[1]);
                 return describe_constant(chunk, idx);
             }
             break;
@@ -263,7 +327,7 @@ String describe_operands(uint8_t op, const Array &operands, const BytecodeChunk
         case OP_JUMP:
         case OP_JUMP_IF_FALSE:
         case OP_LOOP:
-            return describe_jump_target(op, operands, offset);
+            return describe_jump_target(op, operands, offset, wide);
         case OP_CALL:
             if (operands.size() >= 2) {
                 return vformat("%s, argc=%d",
@@ -273,9 +337,18 @@ String describe_operands(uint8_t op, const Array &operands, const BytecodeChunk
             break;
         case OP_CALL_BUILTIN:
             if (operands.size() >= 2) {
+                const VisualGasicBuiltins::BuiltinInfo *info = VisualGasicBuiltins::get_builtin_info(int(operands[0]));
+                if (info) {
+                    return vformat("builtin[%d]=%s, argc=%d", int(operands[0]), String(info->name), int(operands[1]));
+                }
                 return vformat("builtin=%d, argc=%d", int(operands[0]), int(operands[1]));
             }
             break;
+        case OP_CALL_USER:
+            if (operands.size() >= 2) {
+                return vformat("sub=%d, argc=%d", int(operands[0]), int(operands[1]));
+            }
+            break;
         case OP_GET_ARRAY:
         case OP_SET_ARRAY:
         case OP_GET_ARRAY_UNCHECKED:
@@ -298,6 +371,100 @@ String describe_operands(uint8_t op, const Array &operands, const BytecodeChunk
                 return describe_constant(chunk, int(operands[0]));
             }
             break;
+        case OP_WIDE:
+            if (operands.size() >= 2) {
+                return vformat("prefix=0x%04x", (int(operands[0]) << 8) | int(operands[1]));
+            }
+            break;
+        case OP_R_LOADK_I64:
+        case OP_R_LOADK_F64:
+            if (operands.size() >= 2) {
+                return vformat("%s <- %s",
+                    describe_local_slot(chunk, int(operands[0])),
+                    describe_constant(chunk, int(operands[1])));
+            }
+            break;
+        case OP_R_MOV:
+        case OP_R_I64_TO_F64:
+            if (operands.size() >= 2) {
+                return vformat("%s <- %s",
+                    describe_local_slot(chunk, int(operands[0])),
+                    describe_local_slot(chunk, int(operands[1])));
+            }
+            break;
+        case OP_R_ADD_I64:
+        case OP_R_SUB_I64:
+        case OP_R_MUL_I64:
+        case OP_R_ADD_F64:
+        case OP_R_SUB_F64:
+        case OP_R_MUL_F64:
+        case OP_R_DIV_F64:
+            if (operands.size() >= 3) {
+                return vformat("%s <- %s, %s",
+                    describe_local_slot(chunk, int(operands[0])),
+                    describe_local_slot(chunk, int(operands[1])),
+                    describe_local_slot(chunk, int(operands[2])));
+            }
+            break;
+        case OP_R_ADDK_I64:
+        case OP_R_SUBK_I64:
+        case OP_R_MULK_I64:
+            if (operands.size() >= 3) {
+                return vformat("%s <- %s, %s",
+                    describe_local_slot(chunk, int(operands[0])),
+                    describe_local_slot(chunk, int(operands[1])),
+                    describe_constant(chunk, int(operands[2])));
+            }
+            break;
+        case OP_R_INC_I64:
+            if (operands.size() >= 1) {
+                return describe_local_slot(chunk, int(operands[0]));
+            }
+            break;
+        case OP_R_GET_ARRAY_I64:
+        case OP_R_GET_ARRAY_F64:
+        case OP_R_GET_ARRAY_I64_GUARDED:
+        case OP_R_GET_ARRAY_F64_GUARDED:
+            if (operands.size() >= 3) {
+                return vformat("%s <- %s(%s)",
+                    describe_local_slot(chunk, int(operands[0])),
+                    describe_local_slot(chunk, int(operands[1])),
+                    describe_local_slot(chunk, int(operands[2])));
+            }
+            break;
+        case OP_R_GUARD_ARRAY:
+            if (operands.size() >= 4) {
+                return vformat("%s(%s .. %s) + %s",
+                    describe_local_slot(chunk, int(operands[0])),
+                    describe_local_slot(chunk, int(operands[1])),
+                    describe_local_slot(chunk, int(operands[2])),
+                    describe_constant(chunk, int(operands[3])));
+            }
+            break;
+        case OP_ACCUM_I64_MULADD_CONST:
+            if (operands.size() >= 4) {
+                return vformat("%s += %s * %s + %s",
+                    describe_local_slot(chunk, int(operands[0])),
+                    describe_local_slot(chunk, int(operands[1])),
+                    describe_constant(chunk, int(operands[2])),
+                    describe_constant(chunk, int(operands[3])));
+            }
+            break;
+        case OP_R_JUMP_IF_NOT_I64:
+        case OP_R_JUMP_IF_NOT_I64K:
+            if (operands.size() >= 5) {
+                static const char *cmp_names[] = { "=", "<>", "<", "<=", ">", ">=" };
+                int cmp = int(operands[0]);
+                String rhs = op == OP_R_JUMP_IF_NOT_I64K
+                    ? describe_constant(chunk, int(operands[2]))
+                    : describe_local_slot(chunk, int(operands[2]));
+                int delta = (int(operands[3]) << 8) | int(operands[4]);
+                return vformat("unless %s %s %s: delta=%d -> %04d",
+                    describe_local_slot(chunk, int(operands[1])),
+                    String(cmp >= 0 && cmp <= RCMP_GE ? cmp_names[cmp] : "?"),
+                    rhs, delta, offset + 6 + delta);
+            }
+            break;
         case OP_ALLOC_FILL_REPEAT_I64:
             if (operands.size() >= 6) {
                 return vformat("sum=%s, arr=%s, tmp=%s, %s, iter=%s, size=%s",
@@ -317,6 +484,7 @@ String describe_operands(uint8_t op, const Array &operands, const BytecodeChunk
 
 void VisualGasicScript::_bind_methods() {
     ClassDB::bind_method(D_METHOD("debug_dump_bytecode", "entry_point"), &VisualGasicScript::debug_dump_bytecode);
+    ClassDB::bind_method(D_METHOD("debug_ast_stats"), &VisualGasicScript::debug_ast_stats);
 }
 
 bool VisualGasicScript::_can_instantiate() const {
@@ -371,8 +539,9 @@ String VisualGasicScript::_get_source_code() const {
 
 #include <godot_cpp/classes/file_access.hpp>
 
-// Helper to resolve includes
-String resolve_includes(const String& path, const String& code, int depth = 0) {
+// Helper to resolve includes. Every Include is appended to r_dependencies
+// (when given) with the hash of the text that was inlined.
+String resolve_includes(const String& path, const String& code, int depth = 0, Vector<ModuleDependency> *r_dependencies = nullptr) {
     if (depth > 10) return code; // Prevent infinite recursion
 
     String result = "";
@@ -393,11 +562,16 @@ String resolve_includes(const String& path, const String& code, int depth = 0) {
                   // But 'path' passed to us is... ?
              }
              
+             ModuleDependency dependency;
+             dependency.path = full_path;
              if (FileAccess::file_exists(full_path)) {
                  String content = FileAccess::get_file_as_string(full_path);
-                 result += resolve_includes(full_path, content, depth + 1) + "\n";
+                 dependency.hash = SourceHash::compute(content);
+                 if (r_dependencies) r_dependencies->push_back(dependency);
+                 result += resolve_includes(full_path, content, depth + 1, r_dependencies) + "\n";
              } else {
                  UtilityFunctions::print("Include Error: File not found ", full_path);
+                 if (r_dependencies) r_dependencies->push_back(dependency);
                  result += "' Missing Include: " + full_path + "\n";
              }
         } else {
@@ -433,29 +607,31 @@ Error VisualGasicScript::_reload(bool p_keep_state) {
         }
     }
     
+    // Subs compiled from the old source go to its module before the key changes.
+    flush_module_cache();
+
     last_reload_had_error = false;
-    clear_bytecode_cache();
     // Apply Formatting just before successful reload?
     format_source_code();
     
     // Reload logic: Validate tokens
-    String processed_code = resolve_includes("", source_code);
+    module_key = ModuleKey();
+    String processed_code = resolve_includes("", source_code, 0, &module_key.dependencies);
+    module_key.source_hash = SourceHash::compute(source_code);
+    module_key.config_hash = BytecodeCache::config_hash();
     Vector<VisualGasicTokenizer::Token> tokens = tokenizer.tokenize(processed_code);
     if (tokens.size() > 0 && tokens[tokens.size()-1].type == VisualGasicTokenizer::TOKEN_ERROR) {
         String err_msg = tokens[tokens.size()-1].value;
         UtilityFunctions::print("Script Reload Error (Token): ", err_msg);
+        clear_bytecode_cache();
         last_reload_had_error = true;
         return ERR_PARSE_ERROR;
     }
     
-    // Re-parse
-    // Ensure parser does not try to delete AST-owned nodes from its
-    // tracked allocation lists when the script is torn down. Clear
-    // the parser trackers first to avoid double-delete in the
-    // parser destructor (parser is a member and will be destroyed
-    // after this object).
-    parser.clear_tracked_nodes();
-    if (ast_root) delete ast_root;
+    // Re-parse. The previous AST stays alive until the new one is built so
+    // unchanged Subs can be taken over instead of parsed again.
+    ModuleNode *previous = ast_root;
+    ast_root = nullptr;
     
     String path = get_path();
     if (path.is_empty()) {
@@ -473,12 +649,19 @@ Error VisualGasicScript::_reload(bool p_keep_state) {
     
     if (tokens.is_empty()) {
         UtilityFunctions::print("[VG] ERROR: Empty token list");
+        delete previous;
+        clear_bytecode_cache();
         last_reload_had_error = true;
         return ERR_PARSE_ERROR;
     }
     
-    ast_root = parser.parse(tokens);
+    ast_root = parser.parse(tokens, processed_code, previous);
     UtilityFunctions::print("[VG] Parse completed, errors: ", parser.errors.size());
+    // Bind even after errors: nodes reused from `previous` still carry its bindings.
+    VisualGasicBinder binder;
+    binder.bind(ast_root);
+    retain_unchanged_bytecode(previous);
+    delete previous;
     
     if (parser.errors.size() > 0) {
          UtilityFunctions::print("[VG] Parser Error: ", parser.errors[0].message, " at line ", parser.errors[0].line);
@@ -511,7 +694,8 @@ Error VisualGasicScript::_reload(bool p_keep_state) {
             }
         }
     }
-    
+
+    load_module_cache();
     return OK;
 }
 
@@ -642,6 +826,31 @@ TypedArray<Dictionary> VisualGasicScript::_get_documentation() const {
     return TypedArray<Dictionary>();
 }
 
+// After a reparse, keeps the compiled entries of Subs whose AST was taken
+// over from p_previous and drops the rest. Chunks address callees by index in
+// ast_root->subs and check their parameter lists, so when any module-level
+// declaration or Sub signature changed nothing is kept.
+void VisualGasicScript::retain_unchanged_bytecode(const ModuleNode *p_previous) {
+    std::deque<CompiledEntry> kept;
+    std::vector<int> kept_index;
+    if (ast_root && p_previous && p_previous->interface_hash != 0 &&
+            ast_root->interface_hash == p_previous->interface_hash &&
+            ast_root->declarations.size() == ast_root->subs.size()) {
+        kept_index.assign(ast_root->subs.size(), -1);
+        for (int i = 0; i < ast_root->declarations.size(); i++) {
+            int previous_index = ast_root->declarations[i].previous_index;
+            if (previous_index < 0 || previous_index >= (int)sub_bytecode_index.size() || sub_bytecode_index[previous_index] < 0) {
+                continue;
+            }
+            kept.push_back(std::move(bytecode_cache[sub_bytecode_index[previous_index]]));
+            kept_index[i] = (int)kept.size() - 1;
+        }
+    }
+    clear_bytecode_cache();
+    bytecode_cache = std::move(kept);
+    sub_bytecode_index = std::move(kept_index);
+}
+
 void VisualGasicScript::clear_bytecode_cache() {
     bytecode.code.clear();
     bytecode.constants.clear();
@@ -650,45 +859,218 @@ void VisualGasicScript::clear_bytecode_cache() {
     bytecode.local_types.clear();
     bytecode.local_count = 0;
     bytecode_cache.clear();
+    sub_bytecode_index.clear();
     has_bytecode = false;
 }
 
-BytecodeChunk *VisualGasicScript::get_bytecode_for(const String &entry_point) {
-    if (!ast_root || entry_point.is_empty()) {
-        return nullptr;
+static BytecodeCache &vg_module_cache() {
+    static BytecodeCache cache;
+    return cache;
+}
+
+static bool vg_module_cache_enabled() {
+    ProjectSettings *settings = ProjectSettings::get_singleton();
+    return settings && (bool)settings->get_setting("visual_gasic/bytecode_cache/enabled", true);
+}
+
+// Seeds the per-Sub entries from the module cache, so the Subs compiled in an
+// earlier run start without going through the compiler again. The AST is
+// still parsed: it is the fallback tier and the source of module state.
+void VisualGasicScript::load_module_cache() {
+    module_path = source_path.is_empty() ? get_path() : source_path;
+    if (module_path.is_empty() || !ast_root || !vg_module_cache_enabled()) {
+        module_path = String();
+        return;
     }
 
-    String key = entry_point.to_lower();
-    for (CompiledEntry &entry : bytecode_cache) {
-        if (entry.name_lower == key) {
-            return &entry.chunk;
+    Vector<CachedModuleEntry> entries;
+    if (!vg_module_cache().load_module(module_path, module_key, entries)) {
+        return;
+    }
+    if ((int)sub_bytecode_index.size() != ast_root->subs.size()) {
+        sub_bytecode_index.assign(ast_root->subs.size(), -1);
+    }
+    for (int i = 0; i < entries.size(); i++) {
+        const CachedModuleEntry &cached = entries[i];
+        for (int s = 0; s < ast_root->subs.size(); s++) {
+            if (sub_bytecode_index[s] >= 0 || ast_root->subs[s]->name.nocasecmp_to(cached.name) != 0) {
+                continue;
+            }
+            CompiledEntry entry;
+            entry.original_name = cached.name;
+            entry.name_lower = cached.name.to_lower();
+            entry.compiled = cached.compiled;
+            entry.from_cache = true;
+            entry.chunk = cached.chunk;
+            bytecode_cache.push_back(entry);
+            sub_bytecode_index[s] = (int)bytecode_cache.size() - 1;
+            break;
         }
     }
+}
 
-    VisualGasicCompiler compiler;
-    BytecodeChunk compiled_chunk;
-    compiled_chunk.code.clear();
-    compiled_chunk.constants.clear();
-    compiled_chunk.lines.clear();
-    compiled_chunk.local_names.clear();
-    compiled_chunk.local_types.clear();
-    compiled_chunk.local_count = 0;
-
-    if (!compiler.compile(ast_root, entry_point, &compiled_chunk)) {
-        UtilityFunctions::printerr("VisualGasic: Failed to compile bytecode for ", entry_point);
-        return nullptr;
+// Rewrites the module with every Sub compiled so far, so a module only ever
+// holds entry points that actually ran. Called through flush_module_cache.
+void VisualGasicScript::save_module_cache() {
+    if (module_path.is_empty()) {
+        return;
+    }
+    Vector<CachedModuleEntry> entries;
+    for (int index : sub_bytecode_index) {
+        if (index < 0) {
+            continue;
+        }
+        const CompiledEntry &compiled = bytecode_cache[index];
+        CachedModuleEntry entry;
+        entry.name = compiled.original_name;
+        entry.compiled = compiled.compiled;
+        if (compiled.compiled) {
+            entry.chunk = compiled.chunk;
+        }
+        entries.push_back(entry);
+    }
+    vg_module_cache().save_module(module_path, module_key, entries);
+}
+
+VisualGasicScript::~VisualGasicScript() {
+    if (VisualGasicLanguage::get_singleton()) {
+        VisualGasicLanguage::get_singleton()->cancel_module_cache_save(this);
     }
+    flush_module_cache();
+    clear_declare_stubs();
+    if (ast_root) {
+        delete ast_root;
+    }
+}
 
+void VisualGasicScript::clear_declare_stubs() {
+#if VG_USE_FFI
+    for (VisualGasicFFIStub *stub : declare_stubs) {
+        if (stub) {
+            memdelete(stub);
+        }
+    }
+#endif
+    declare_stubs.clear();
+    declare_stub_generation = 0;
+}
+
+void VisualGasicScript::resolve_declares() {
+    std::lock_guard<std::mutex> lock(declare_stub_mutex);
+    if (!ast_root || declare_stub_generation == ast_root->bind_generation) {
+        return;
+    }
+    clear_declare_stubs();
+#if VG_USE_FFI
+    declare_stubs.resize(ast_root->declares.size(), nullptr);
+    for (int i = 0; i < ast_root->declares.size(); i++) {
+        String error;
+        declare_stubs[i] = VisualGasicFFIStub::create(ast_root->declares[i], error);
+        if (!declare_stubs[i]) {
+            UtilityFunctions::print("Declare ", ast_root->declares[i]->name, ": ", error);
+        }
+    }
+#endif
+    declare_stub_generation = ast_root->bind_generation;
+}
+
+const VisualGasicFFIStub *VisualGasicScript::get_declare_stub(int p_index) {
+    if (!ast_root || declare_stub_generation != ast_root->bind_generation) {
+        resolve_declares();
+    }
+    return p_index >= 0 && p_index < (int)declare_stubs.size() ? declare_stubs[p_index] : nullptr;
+}
+
+void VisualGasicScript::flush_module_cache() {
+    if (!module_cache_dirty) {
+        return;
+    }
+    module_cache_dirty = false;
+    save_module_cache();
+}
+
+int VisualGasicScript::compile_entry(const String &entry_point) {
+    VisualGasicCompiler compiler;
     CompiledEntry entry;
     entry.original_name = entry_point;
-    entry.name_lower = key;
-    entry.chunk = compiled_chunk;
+    entry.name_lower = entry_point.to_lower();
+    entry.compiled = compiler.compile(ast_root, entry_point, &entry.chunk);
+    if (!entry.compiled) {
+        UtilityFunctions::printerr("VisualGasic: Failed to compile bytecode for ", entry_point);
+        entry.chunk = BytecodeChunk();
+    }
     bytecode_cache.push_back(entry);
 
-    bytecode = compiled_chunk;
-    has_bytecode = true;
+    if (entry.compiled) {
+        bytecode = entry.chunk;
+        has_bytecode = true;
+    }
+    return (int)bytecode_cache.size() - 1;
+}
 
-    return &bytecode_cache.back().chunk;
+BytecodeChunk *VisualGasicScript::get_bytecode_for_sub(int sub_index) {
+    if (!ast_root || sub_index < 0 || sub_index >= ast_root->subs.size()) {
+        return nullptr;
+    }
+    if ((int)sub_bytecode_index.size() != ast_root->subs.size()) {
+        sub_bytecode_index.assign(ast_root->subs.size(), -1);
+    }
+
+    int cache_index = sub_bytecode_index[sub_index];
+    if (cache_index < 0) {
+        cache_index = compile_entry(ast_root->subs[sub_index]->name);
+        sub_bytecode_index[sub_index] = cache_index;
+        if (!module_path.is_empty()) {
+            module_cache_dirty = true;
+            module_cache_touched_msec = Time::get_singleton()->get_ticks_msec();
+            if (VisualGasicLanguage::get_singleton()) {
+                VisualGasicLanguage::get_singleton()->queue_module_cache_save(this);
+            }
+        }
+    }
+    CompiledEntry &entry = bytecode_cache[cache_index];
+    return entry.compiled ? &entry.chunk : nullptr;
+}
+
+BytecodeChunk *VisualGasicScript::get_bytecode_for(const String &entry_point) {
+    if (!ast_root || entry_point.is_empty()) {
+        return nullptr;
+    }
+
+    for (int i = 0; i < ast_root->subs.size(); i++) {
+        if (ast_root->subs[i]->name.nocasecmp_to(entry_point) == 0) {
+            return get_bytecode_for_sub(i);
+        }
+    }
+
+    String key = entry_point.to_lower();
+    for (CompiledEntry &entry : bytecode_cache) {
+        if (entry.name_lower == key) {
+            return entry.compiled ? &entry.chunk : nullptr;
+        }
+    }
+    CompiledEntry &entry = bytecode_cache[compile_entry(entry_point)];
+    return entry.compiled ? &entry.chunk : nullptr;
+}
+
+Dictionary VisualGasicScript::debug_ast_stats() const {
+    Dictionary info;
+    if (!ast_root) {
+        info["error"] = "Script has not been parsed";
+        return info;
+    }
+    info["bytes_allocated"] = (int64_t)ast_root->arena.get_bytes_allocated();
+    info["bytes_reserved"] = (int64_t)ast_root->arena.get_bytes_reserved();
+    info["subs"] = ast_root->subs.size();
+    int reused = 0;
+    for (int i = 0; i < ast_root->declarations.size(); i++) {
+        if (ast_root->declarations[i].previous_index >= 0) {
+            reused++;
+        }
+    }
+    info["reused_subs"] = reused; // Taken over from the previous parse
+    info["bound_slots"] = ast_root->slot_names.size(); // Variable names resolved by the binder
+    return info;
 }
 
 Dictionary VisualGasicScript::debug_dump_bytecode(const String &entry_point) {
@@ -700,6 +1082,15 @@ Dictionary VisualGasicScript::debug_dump_bytecode(const String &entry_point) {
     }
 
     info["entry_point"] = entry_point;
+    info["format_version"] = (int64_t)chunk->format_version;
+    bool from_cache = false;
+    for (const CompiledEntry &entry : bytecode_cache) {
+        if (&entry.chunk == chunk) {
+            from_cache = entry.from_cache;
+            break;
+        }
+    }
+    info["from_cache"] = from_cache;
 
     PackedByteArray code_bytes;
     code_bytes.resize(chunk->code.size());
@@ -728,6 +1119,12 @@ Dictionary VisualGasicScript::debug_dump_bytecode(const String &entry_point) {
         local_types.set(i, chunk->local_types[i]);
     }
     info["local_types"] = local_types;
+    PackedByteArray local_regs;
+    local_regs.resize(chunk->local_regs.size());
+    for (int i = 0; i < chunk->local_regs.size(); i++) {
+        local_regs.set(i, chunk->local_regs[i]);
+    }
+    info["local_regs"] = local_regs;
     info["local_count"] = chunk->local_count;
 
     Array constants;
@@ -739,6 +1136,7 @@ Dictionary VisualGasicScript::debug_dump_bytecode(const String &entry_point) {
 
     Array instructions;
     int ip = 0;
+    uint32_t wide = 0;
     while (ip < chunk->code.size()) {
         uint8_t op = chunk->code[ip];
         Dictionary inst;
@@ -754,9 +1152,15 @@ Dictionary VisualGasicScript::debug_dump_bytecode(const String &entry_point) {
             operands.push_back((int)chunk->code[ip + 1 + i]);
         }
         inst["operands"] = operands;
-        inst["detail"] = describe_operands(op, operands, chunk, ip);
+        inst["detail"] = describe_operands(op, operands, chunk, ip, wide);
         instructions.push_back(inst);
 
+        if (op == OP_WIDE && operands.size() >= 2) {
+            wide = ((uint32_t)int(operands[0]) << 8) | (uint32_t)int(operands[1]);
+        } else {
+            wide = 0;
+        }
+
         ip += 1 + operand_len;
     }
 
@@ -1,15 +1,20 @@
 #ifndef VISUAL_GASIC_SCRIPT_H
 #define VISUAL_GASIC_SCRIPT_H
 
+#include <deque>
+#include <mutex>
 #include <vector>
 #include <godot_cpp/classes/script_extension.hpp>
 #include <godot_cpp/classes/script_language.hpp>
 #include "visual_gasic_tokenizer.h"
 #include "visual_gasic_parser.h" 
 #include "visual_gasic_bytecode.h"
+#include "visual_gasic_bytecode_cache.h"
 
 using namespace godot;
 
+class VisualGasicFFIStub;
+
 class VisualGasicScript : public ScriptExtension {
 	GDCLASS(VisualGasicScript, ScriptExtension);
 
@@ -21,9 +26,36 @@ class VisualGasicScript : public ScriptExtension {
     struct CompiledEntry {
         String original_name;
         String name_lower;
+        bool compiled = false; // false = compile failed, don't retry
+        bool from_cache = false; // Read from the module cache instead of compiled
         BytecodeChunk chunk;
     };
-    std::vector<CompiledEntry> bytecode_cache;
+    // std::deque so chunk pointers held by active call frames survive new
+    // entries being compiled mid-run.
+    std::deque<CompiledEntry> bytecode_cache;
+    std::vector<int> sub_bytecode_index; // ast_root->subs index -> bytecode_cache index (-1 = not compiled yet)
+    int compile_entry(const String &entry_point);
+    void retain_unchanged_bytecode(const ModuleNode *p_previous);
+
+    // Serialized module cache (visual_gasic_bytecode_cache.h). module_path is
+    // empty when the script has no file to key the cache by or caching is off.
+    // New compiles only mark the module dirty; it is written once, when the
+    // language sees it idle, on reload or when the script is freed.
+    String source_path;
+    String module_path;
+    ModuleKey module_key;
+    bool module_cache_dirty = false;
+    uint64_t module_cache_touched_msec = 0; // Last compile that dirtied it
+    void load_module_cache();
+    void save_module_cache();
+
+    // Declare call stubs, one per ModuleNode::declares (null if it did not
+    // resolve), built once per bind of the module and shared by all its
+    // instances. Libraries stay loaded for the process.
+    std::vector<VisualGasicFFIStub *> declare_stubs;
+    uint64_t declare_stub_generation = 0;
+    std::mutex declare_stub_mutex;
+    void clear_declare_stubs();
 
 public:
     ModuleNode *ast_root = nullptr;
@@ -34,11 +66,17 @@ protected:
 	static void _bind_methods();
 
 public:
-    virtual ~VisualGasicScript() {
-        if (ast_root) {
-            delete ast_root;
-        }
-    }
+    virtual ~VisualGasicScript();
+
+    // Writes the module cache if a compile changed it since the last write.
+    void flush_module_cache();
+
+    // Builds the Declare stubs of the current bind if they are not built yet.
+    void resolve_declares();
+    // Null if the Declare did not resolve (the reason was printed) or the
+    // build has no libffi.
+    const VisualGasicFFIStub *get_declare_stub(int p_index);
+    uint64_t get_module_cache_touched_msec() const { return module_cache_touched_msec; }
 
     virtual bool _can_instantiate() const override;
     virtual Ref<Script> _get_base_script() const override;
@@ -71,12 +109,19 @@ public:
     virtual bool _has_static_method(const StringName &p_method) const override;
     virtual TypedArray<Dictionary> _get_documentation() const override;
     bool has_reload_errors() const { return last_reload_had_error; }
+    // The resource loader reloads before the path is assigned, so it passes
+    // the file path here for the module cache.
+    void set_source_path(const String &p_path) { source_path = p_path; }
 
     // Tools
     void format_source_code();
     void clear_bytecode_cache();
     BytecodeChunk *get_bytecode_for(const String &entry_point);
+    BytecodeChunk *get_bytecode_for_sub(int sub_index);
     Dictionary debug_dump_bytecode(const String &entry_point);
+    // Memory held by the parsed module's AST arena, and how many Subs the
+    // last reload took over from the previous parse.
+    Dictionary debug_ast_stats() const;
 };
 
 #endif // VISUAL_GASIC_SCRIPT_H
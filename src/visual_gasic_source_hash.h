@@ -0,0 +1,86 @@
+#ifndef VISUAL_GASIC_SOURCE_HASH_H
+#define VISUAL_GASIC_SOURCE_HASH_H
+
+#include <godot_cpp/variant/string.hpp>
+
+#include <cstdint>
+#include <cstring>
+
+using namespace godot;
+
+// XXH64 over a raw byte buffer; Strings are hashed as their UTF-32 storage
+// without conversion. Used for cache keys, not for anything security related.
+class SourceHash {
+    static constexpr uint64_t P1 = 0x9E3779B185EBCA87ULL;
+    static constexpr uint64_t P2 = 0xC2B2AE3D27D4EB4FULL;
+    static constexpr uint64_t P3 = 0x165667B19E3779F9ULL;
+    static constexpr uint64_t P4 = 0x85EBCA77C2B2AE63ULL;
+    static constexpr uint64_t P5 = 0x27D4EB2F165667C5ULL;
+
+    static uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+    static uint64_t read64(const uint8_t *p) { uint64_t v; memcpy(&v, p, 8); return v; }
+    static uint32_t read32(const uint8_t *p) { uint32_t v; memcpy(&v, p, 4); return v; }
+    static uint64_t mix_lane(uint64_t acc, uint64_t input) {
+        acc += input * P2;
+        return rotl(acc, 31) * P1;
+    }
+    static uint64_t merge(uint64_t acc, uint64_t v) {
+        acc ^= mix_lane(0, v);
+        return acc * P1 + P4;
+    }
+
+public:
+    static uint64_t compute_bytes(const void *p_data, size_t p_len, uint64_t p_seed = 0) {
+        const uint8_t *p = (const uint8_t *)p_data;
+        const uint8_t *end = p + p_len;
+        uint64_t h;
+        if (p_len >= 32) {
+            // Four independent lanes per 32-byte stripe.
+            uint64_t v1 = p_seed + P1 + P2;
+            uint64_t v2 = p_seed + P2;
+            uint64_t v3 = p_seed;
+            uint64_t v4 = p_seed - P1;
+            const uint8_t *limit = end - 32;
+            do {
+                v1 = mix_lane(v1, read64(p));
+                v2 = mix_lane(v2, read64(p + 8));
+                v3 = mix_lane(v3, read64(p + 16));
+                v4 = mix_lane(v4, read64(p + 24));
+                p += 32;
+            } while (p <= limit);
+            h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+            h = merge(h, v1);
+            h = merge(h, v2);
+            h = merge(h, v3);
+            h = merge(h, v4);
+        } else {
+            h = p_seed + P5;
+        }
+        h += (uint64_t)p_len;
+        for (; p + 8 <= end; p += 8) {
+            h ^= mix_lane(0, read64(p));
+            h = rotl(h, 27) * P1 + P4;
+        }
+        if (p + 4 <= end) {
+            h ^= (uint64_t)read32(p) * P1;
+            h = rotl(h, 23) * P2 + P3;
+            p += 4;
+        }
+        for (; p < end; p++) {
+            h ^= (uint64_t)(*p) * P5;
+            h = rotl(h, 11) * P1;
+        }
+        h ^= h >> 33;
+        h *= P2;
+        h ^= h >> 29;
+        h *= P3;
+        h ^= h >> 32;
+        return h;
+    }
+
+    static uint64_t compute(const String& source, uint64_t p_seed = 0) {
+        return compute_bytes(source.ptr(), (size_t)source.length() * sizeof(char32_t), p_seed);
+    }
+};
+
+#endif // VISUAL_GASIC_SOURCE_HASH_H
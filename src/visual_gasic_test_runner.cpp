@@ -3,14 +3,31 @@
 #include "visual_gasic_instance.h"
 #include "visual_gasic_script.h"
 #include "visual_gasic_bytecode.h"
-
+#include "visual_gasic_bytecode_cache.h"
+#include "visual_gasic_async.h"
+#include "visual_gasic_binder.h"
+#include "visual_gasic_builtins.h"
+#include "visual_gasic_commands.h"
+#include "visual_gasic_data_pool.h"
+#include "visual_gasic_draw_batch.h"
+#if VG_USE_FFI
+#include "visual_gasic_ffi.h"
+#endif
+#include "visual_gasic_file.h"
+#include "visual_gasic_parser.h"
+
+#include <godot_cpp/classes/dir_access.hpp>
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/variant/array.hpp>
 #include <godot_cpp/variant/dictionary.hpp>
 #include <godot_cpp/variant/string.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <cstring>
 #include <functional>
+#include <thread>
 #include <vector>
 
 using namespace godot;
@@ -167,6 +184,114 @@ bool test_bytecode_array_ops(String &err) {
     return true;
 }
 
+// OP_CALL resolves its name to an expression builtin once and keeps the ID
+// on the chunk; table builtins share their OP_CALL_BUILTIN IDs.
+bool test_expr_builtin_dispatch(String &err) {
+    int mid_id = VisualGasicBuiltins::find_expr_builtin_id("Mid");
+    int typename_id = VisualGasicBuiltins::find_expr_builtin_id("TYPENAME");
+    if (mid_id != VisualGasicBuiltins::find_builtin_id("mid") || typename_id < VisualGasicBuiltins::get_builtin_count()
+            || VisualGasicBuiltins::find_expr_builtin_id("NoSuchBuiltin") != -1) {
+        err = "Expression builtin lookup failed";
+        return false;
+    }
+    for (int id = 0; id < VisualGasicBuiltins::get_expr_builtin_count(); id++) {
+        if (VisualGasicBuiltins::find_expr_builtin_id(VisualGasicBuiltins::get_expr_builtin_name(id)) != id) {
+            err = String("Builtin ") + VisualGasicBuiltins::get_expr_builtin_name(id) + " does not resolve to its own ID";
+            return false;
+        }
+        if (!VisualGasicBinder::is_intrinsic_call(VisualGasicBuiltins::get_expr_builtin_name(id))) {
+            err = String("Builtin ") + VisualGasicBuiltins::get_expr_builtin_name(id) + " could be bound to a Sub";
+            return false;
+        }
+    }
+    for (int i = 0; i < VisualGasicBuiltins::get_evaluator_intrinsic_count(); i++) {
+        String name = VisualGasicBuiltins::get_evaluator_intrinsic_name(i);
+        if (VisualGasicBuiltins::find_expr_builtin_id(name) != -1 || !VisualGasicBinder::is_intrinsic_call(name)) {
+            err = "Evaluator intrinsic " + name + " is also a builtin, or could be bound to a Sub";
+            return false;
+        }
+    }
+    if (!VisualGasicBuiltins::is_evaluator_intrinsic("CreateButton") || VisualGasicBinder::is_intrinsic_call("MyHelper")) {
+        err = "Intrinsic name lookup failed";
+        return false;
+    }
+    bool handled = true;
+    VisualGasicBuiltins::call_builtin_expr_by_id(nullptr, typename_id, Array(), handled);
+    if (handled) {
+        err = "Builtin called with too few arguments";
+        return false;
+    }
+
+    BytecodeChunk chunk;
+    int idx_value = chunk.add_constant((int64_t)42);
+    int idx_name = chunk.add_constant(String("IsNumber"));
+    push_byte(chunk, OP_CONSTANT);
+    push_byte(chunk, (uint8_t)idx_value);
+    push_byte(chunk, OP_CALL);
+    push_byte(chunk, (uint8_t)idx_name);
+    push_byte(chunk, 1);
+    push_byte(chunk, OP_RETURN_VALUE);
+
+    Variant ret;
+    if (!run_chunk(chunk, ret, err)) {
+        return false;
+    }
+    if (ret.get_type() != Variant::BOOL || !(bool)ret) {
+        err = String("Expected True, got ") + format_value(ret);
+        return false;
+    }
+    if (chunk.constant_builtin_ids.size() != chunk.constants.size()
+            || chunk.constant_builtin_ids[idx_name] != VisualGasicBuiltins::find_expr_builtin_id("isnumber")
+            || chunk.constant_builtin_ids[idx_value] != VisualGasicBuiltins::BUILTIN_UNRESOLVED) {
+        err = "OP_CALL did not cache the builtin ID";
+        return false;
+    }
+    return true;
+}
+
+bool test_bytecode_call_builtin(String &err) {
+    int mid_id = VisualGasicBuiltins::find_builtin_id("Mid", 3);
+    if (mid_id < 0 || VisualGasicBuiltins::find_builtin_id("MID") != mid_id) {
+        err = "Builtin lookup for Mid failed";
+        return false;
+    }
+    if (VisualGasicBuiltins::find_builtin_id("Midx") != -1 || VisualGasicBuiltins::find_builtin_id("Mid", 4) != -1) {
+        err = "Builtin lookup accepted an unknown name or arity";
+        return false;
+    }
+    int ucase_id = VisualGasicBuiltins::find_builtin_id("UCase", 1);
+
+    BytecodeChunk chunk;
+    int idx_text = chunk.add_constant(String("VisualGasic"));
+    int idx_start = chunk.add_constant((int64_t)7);
+    int idx_len = chunk.add_constant((int64_t)5);
+
+    push_byte(chunk, OP_CONSTANT);
+    push_byte(chunk, (uint8_t)idx_text);
+    push_byte(chunk, OP_CONSTANT);
+    push_byte(chunk, (uint8_t)idx_start);
+    push_byte(chunk, OP_CONSTANT);
+    push_byte(chunk, (uint8_t)idx_len);
+    push_byte(chunk, OP_CALL_BUILTIN);
+    push_byte(chunk, (uint8_t)mid_id);
+    push_byte(chunk, 3);
+    push_byte(chunk, OP_CALL_BUILTIN);
+    push_byte(chunk, (uint8_t)ucase_id);
+    push_byte(chunk, 1);
+    push_byte(chunk, OP_RETURN_VALUE);
+
+    Variant ret;
+    if (!run_chunk(chunk, ret, err)) {
+        return false;
+    }
+
+    if (ret.get_type() != Variant::STRING || String(ret) != "GASIC") {
+        err = String("Expected GASIC, got ") + format_value(ret);
+        return false;
+    }
+    return true;
+}
+
 bool test_bytecode_interop_name_len(String &err) {
     BytecodeChunk chunk;
     chunk.local_count = 1;
@@ -450,6 +575,1233 @@ bool test_bytecode_branch_sum(String &err) {
     return true;
 }
 
+void push_wide(BytecodeChunk &chunk, uint8_t op, int index) {
+    if (index > 0xFF) {
+        push_byte(chunk, OP_WIDE);
+        push_byte(chunk, (uint8_t)((index >> 16) & 0xFF));
+        push_byte(chunk, (uint8_t)((index >> 8) & 0xFF));
+    }
+    push_byte(chunk, op);
+    push_byte(chunk, (uint8_t)(index & 0xFF));
+}
+
+bool test_bytecode_wide_operands(String &err) {
+    const int constant_count = 300;
+    const int local_count = 301;
+    const int jump_span = 70000; // Longer than a 16-bit offset
+
+    BytecodeChunk chunk;
+    chunk.local_count = local_count;
+    for (int i = 0; i < local_count; i++) {
+        chunk.local_names.push_back(String("wide_local_") + String::num_int64(i));
+        chunk.local_types.push_back(0);
+    }
+    for (int i = 0; i < constant_count; i++) {
+        chunk.add_constant((int64_t)i * 10);
+    }
+
+    // local[300] = const[299] (two-byte OP_CONSTANT_LONG index)
+    push_byte(chunk, OP_CONSTANT_LONG);
+    push_byte(chunk, (uint8_t)(299 >> 8));
+    push_byte(chunk, (uint8_t)(299 & 0xFF));
+    push_wide(chunk, OP_SET_LOCAL, 300);
+
+    // Jump over a block that would clobber the local if executed.
+    push_byte(chunk, OP_WIDE);
+    push_byte(chunk, (uint8_t)((jump_span >> 24) & 0xFF));
+    push_byte(chunk, (uint8_t)((jump_span >> 16) & 0xFF));
+    push_byte(chunk, OP_JUMP);
+    push_byte(chunk, (uint8_t)((jump_span >> 8) & 0xFF));
+    push_byte(chunk, (uint8_t)(jump_span & 0xFF));
+    int skipped_start = chunk.code.size();
+    while (chunk.code.size() - skipped_start < jump_span - 4) {
+        push_byte(chunk, OP_NIL);
+        push_byte(chunk, OP_POP);
+    }
+    while (chunk.code.size() - skipped_start < jump_span) {
+        push_byte(chunk, OP_NIL);
+    }
+
+    // local[300] + const[288] through an OP_WIDE-prefixed OP_CONSTANT.
+    push_wide(chunk, OP_GET_LOCAL, 300);
+    push_wide(chunk, OP_CONSTANT, 288);
+    push_byte(chunk, OP_ADD_I64);
+    push_byte(chunk, OP_RETURN_VALUE);
+
+    Variant ret;
+    if (!run_chunk(chunk, ret, err)) {
+        return false;
+    }
+
+    if (ret.get_type() != Variant::INT || (int64_t)ret != 5870) {
+        err = String("Expected 5870, got ") + format_value(ret);
+        return false;
+    }
+    return true;
+}
+
+bool test_bytecode_format_version(String &err) {
+    BytecodeChunk chunk;
+    chunk.format_version = VG_BYTECODE_FORMAT_VERSION - 1;
+    int idx_one = chunk.add_constant((int64_t)1);
+    push_byte(chunk, OP_CONSTANT);
+    push_byte(chunk, (uint8_t)idx_one);
+    push_byte(chunk, OP_RETURN_VALUE);
+
+    Ref<VisualGasicScript> script;
+    VisualGasicInstance instance(script, nullptr);
+    Variant ret;
+    if (instance.execute_bytecode(&chunk, nullptr, ret)) {
+        err = "Stale bytecode format was executed";
+        return false;
+    }
+    return true;
+}
+
+bool test_bytecode_register_ops(String &err) {
+    // i, s, n: Long registers; x, y: Double registers.
+    BytecodeChunk chunk;
+    chunk.local_count = 5;
+    const char *names[] = { "i", "s", "n", "x", "y" };
+    const uint8_t kinds[] = { BytecodeChunk::REG_I64, BytecodeChunk::REG_I64, BytecodeChunk::REG_I64,
+        BytecodeChunk::REG_F64, BytecodeChunk::REG_F64 };
+    for (int i = 0; i < chunk.local_count; i++) {
+        chunk.local_names.push_back(names[i]);
+        chunk.local_types.push_back(0);
+        chunk.local_frame_only.push_back(1);
+        chunk.local_regs.push_back(kinds[i]);
+    }
+    int idx_zero = chunk.add_constant((int64_t)0);
+    int idx_hundred = chunk.add_constant((int64_t)100);
+    int idx_sum = chunk.add_constant((int64_t)5050);
+    int idx_half = chunk.add_constant(0.5);
+    int idx_three = chunk.add_constant((int64_t)3);
+    int idx_fail = chunk.add_constant((int64_t)-1);
+
+    push_byte(chunk, OP_R_LOADK_I64);
+    push_byte(chunk, 0);
+    push_byte(chunk, (uint8_t)idx_zero);
+    push_byte(chunk, OP_R_LOADK_I64);
+    push_byte(chunk, 1);
+    push_byte(chunk, (uint8_t)idx_zero);
+    push_byte(chunk, OP_R_LOADK_I64);
+    push_byte(chunk, 2);
+    push_byte(chunk, (uint8_t)idx_hundred);
+
+    // For i = 0 To n: s = s + i
+    int loop_start = chunk.code.size();
+    push_byte(chunk, OP_R_JUMP_IF_NOT_I64);
+    push_byte(chunk, RCMP_LE);
+    push_byte(chunk, 0);
+    push_byte(chunk, 2);
+    push_byte(chunk, 0x00);
+    push_byte(chunk, 9);
+    push_byte(chunk, OP_R_ADD_I64);
+    push_byte(chunk, 1);
+    push_byte(chunk, 1);
+    push_byte(chunk, 0);
+    push_byte(chunk, OP_R_INC_I64);
+    push_byte(chunk, 0);
+    int loop_offset = chunk.code.size() + 3 - loop_start;
+    push_byte(chunk, OP_LOOP);
+    push_byte(chunk, 0x00);
+    push_byte(chunk, (uint8_t)loop_offset);
+
+    // If s <> 5050 return -1
+    push_byte(chunk, OP_R_JUMP_IF_NOT_I64K);
+    push_byte(chunk, RCMP_EQ);
+    push_byte(chunk, 1);
+    push_byte(chunk, (uint8_t)idx_sum);
+    push_byte(chunk, 0x00);
+    push_byte(chunk, 21);
+
+    // x = s * 0.5, then y = 3 through the stack (coerced to Double), x = x + y
+    push_byte(chunk, OP_R_I64_TO_F64);
+    push_byte(chunk, 3);
+    push_byte(chunk, 1);
+    push_byte(chunk, OP_R_LOADK_F64);
+    push_byte(chunk, 4);
+    push_byte(chunk, (uint8_t)idx_half);
+    push_byte(chunk, OP_R_MUL_F64);
+    push_byte(chunk, 3);
+    push_byte(chunk, 3);
+    push_byte(chunk, 4);
+    push_byte(chunk, OP_CONSTANT);
+    push_byte(chunk, (uint8_t)idx_three);
+    push_byte(chunk, OP_SET_LOCAL);
+    push_byte(chunk, 4);
+    push_byte(chunk, OP_R_ADD_F64);
+    push_byte(chunk, 3);
+    push_byte(chunk, 3);
+    push_byte(chunk, 4);
+    push_byte(chunk, OP_GET_LOCAL);
+    push_byte(chunk, 3);
+    push_byte(chunk, OP_RETURN_VALUE);
+
+    push_byte(chunk, OP_CONSTANT);
+    push_byte(chunk, (uint8_t)idx_fail);
+    push_byte(chunk, OP_RETURN_VALUE);
+
+    Variant ret;
+    if (!run_chunk(chunk, ret, err)) {
+        return false;
+    }
+
+    if (ret.get_type() != Variant::FLOAT || (double)ret != 2528.0) {
+        err = String("Expected 2528.0, got ") + format_value(ret);
+        return false;
+    }
+    return true;
+}
+
+// Sums arr(i + 1) for i = 0 To bound through guarded loads, then adds the
+// checked read arr(i) after the loop. arr is [2, 4, 6, 8, 10].
+void build_guarded_array_sum(BytecodeChunk &chunk, int64_t bound) {
+    // arr: Variant local; i, n, s, t: Long registers.
+    chunk.local_count = 5;
+    const char *names[] = { "arr", "i", "n", "s", "t" };
+    const uint8_t kinds[] = { BytecodeChunk::REG_NONE, BytecodeChunk::REG_I64, BytecodeChunk::REG_I64,
+        BytecodeChunk::REG_I64, BytecodeChunk::REG_I64 };
+    for (int i = 0; i < chunk.local_count; i++) {
+        chunk.local_names.push_back(names[i]);
+        chunk.local_types.push_back(0);
+        chunk.local_frame_only.push_back(1);
+        chunk.local_regs.push_back(kinds[i]);
+    }
+    Array values;
+    for (int64_t v = 2; v <= 10; v += 2) {
+        values.push_back(v);
+    }
+    int idx_arr = chunk.add_constant(values);
+    int idx_zero = chunk.add_constant((int64_t)0);
+    int idx_one = chunk.add_constant((int64_t)1);
+    int idx_bound = chunk.add_constant(bound);
+
+    push_byte(chunk, OP_CONSTANT);
+    push_byte(chunk, (uint8_t)idx_arr);
+    push_byte(chunk, OP_SET_LOCAL);
+    push_byte(chunk, 0);
+    push_byte(chunk, OP_R_LOADK_I64);
+    push_byte(chunk, 1);
+    push_byte(chunk, (uint8_t)idx_zero);
+    push_byte(chunk, OP_R_LOADK_I64);
+    push_byte(chunk, 2);
+    push_byte(chunk, (uint8_t)idx_bound);
+    push_byte(chunk, OP_R_LOADK_I64);
+    push_byte(chunk, 3);
+    push_byte(chunk, (uint8_t)idx_zero);
+
+    // Preheader: arr(i + 1) must be in range for every i in 0..n
+    push_byte(chunk, OP_R_GUARD_ARRAY);
+    push_byte(chunk, 0);
+    push_byte(chunk, 1);
+    push_byte(chunk, 2);
+    push_byte(chunk, (uint8_t)idx_one);
+
+    // For i = 0 To n: s = s + arr(i + 1)
+    int loop_start = chunk.code.size();
+    push_byte(chunk, OP_R_JUMP_IF_NOT_I64);
+    push_byte(chunk, RCMP_LE);
+    push_byte(chunk, 1);
+    push_byte(chunk, 2);
+    push_byte(chunk, 0x00);
+    push_byte(chunk, 17);
+    push_byte(chunk, OP_R_ADDK_I64);
+    push_byte(chunk, 4);
+    push_byte(chunk, 1);
+    push_byte(chunk, (uint8_t)idx_one);
+    push_byte(chunk, OP_R_GET_ARRAY_I64_GUARDED);
+    push_byte(chunk, 4);
+    push_byte(chunk, 0);
+    push_byte(chunk, 4);
+    push_byte(chunk, OP_R_ADD_I64);
+    push_byte(chunk, 3);
+    push_byte(chunk, 3);
+    push_byte(chunk, 4);
+    push_byte(chunk, OP_R_INC_I64);
+    push_byte(chunk, 1);
+    int loop_offset = chunk.code.size() + 3 - loop_start;
+    push_byte(chunk, OP_LOOP);
+    push_byte(chunk, 0x00);
+    push_byte(chunk, (uint8_t)loop_offset);
+
+    // s = s + arr(i), bounds checked
+    push_byte(chunk, OP_R_GET_ARRAY_I64);
+    push_byte(chunk, 4);
+    push_byte(chunk, 0);
+    push_byte(chunk, 1);
+    push_byte(chunk, OP_R_ADD_I64);
+    push_byte(chunk, 3);
+    push_byte(chunk, 3);
+    push_byte(chunk, 4);
+    push_byte(chunk, OP_GET_LOCAL);
+    push_byte(chunk, 3);
+    push_byte(chunk, OP_RETURN_VALUE);
+}
+
+bool test_bytecode_array_guard(String &err) {
+    BytecodeChunk chunk;
+    build_guarded_array_sum(chunk, 3);
+    Variant ret;
+    if (!run_chunk(chunk, ret, err)) {
+        return false;
+    }
+    if (ret.get_type() != Variant::INT || (int64_t)ret != 38) {
+        err = String("Expected 38, got ") + format_value(ret);
+        return false;
+    }
+
+    // arr(5) is out of range, so the guard must fail the run up front.
+    BytecodeChunk failing;
+    build_guarded_array_sum(failing, 4);
+    Ref<VisualGasicScript> script;
+    VisualGasicInstance instance(script, nullptr);
+    if (instance.execute_bytecode(&failing, nullptr, ret)) {
+        err = "Guard did not reject an out-of-range loop";
+        return false;
+    }
+    return true;
+}
+
+bool test_bytecode_module_cache(String &err) {
+    // XXH64 reference value, so cache keys stay stable across builds.
+    if (SourceHash::compute_bytes("abc", 3) != 0x44BC2CF5AD770999ULL) {
+        err = "SourceHash does not match XXH64";
+        return false;
+    }
+
+    Vector<CachedModuleEntry> entries;
+    CachedModuleEntry sum_entry;
+    sum_entry.name = "GuardedSum";
+    sum_entry.compiled = true;
+    build_guarded_array_sum(sum_entry.chunk, 3);
+    entries.push_back(sum_entry);
+    CachedModuleEntry rejected;
+    rejected.name = "Rejected";
+    entries.push_back(rejected);
+
+    ModuleKey key;
+    key.source_hash = SourceHash::compute(String("Function GuardedSum()"));
+    key.config_hash = BytecodeCache::config_hash();
+    ModuleDependency include;
+    include.path = "res://shared.vg";
+    include.hash = SourceHash::compute(String("Const LIMIT = 3"));
+    key.dependencies.push_back(include);
+
+    PackedByteArray encoded = BytecodeCache::encode_module(key, entries);
+    Vector<CachedModuleEntry> decoded;
+    if (!BytecodeCache::decode_module(encoded.ptr(), encoded.size(), key, decoded)) {
+        err = "Module did not decode";
+        return false;
+    }
+    if (decoded.size() != 2 || decoded[0].name != "GuardedSum" || !decoded[0].compiled || decoded[1].compiled) {
+        err = "Decoded entries do not match";
+        return false;
+    }
+    BytecodeChunk &chunk = decoded.write[0].chunk;
+    const BytecodeChunk &original = sum_entry.chunk;
+    if (chunk.code.size() != original.code.size() || chunk.lines.size() != chunk.code.size() ||
+            memcmp(chunk.code.ptr(), original.code.ptr(), chunk.code.size()) != 0 ||
+            chunk.constants.size() != original.constants.size() || chunk.local_regs.size() != original.local_regs.size() ||
+            chunk.local_regs[1] != BytecodeChunk::REG_I64 || chunk.param_count != original.param_count) {
+        err = "Decoded chunk differs from the original";
+        return false;
+    }
+    Variant ret;
+    if (!run_chunk(chunk, ret, err)) {
+        return false;
+    }
+    if (ret.get_type() != Variant::INT || (int64_t)ret != 38) {
+        err = String("Expected 38, got ") + format_value(ret);
+        return false;
+    }
+
+    // Other source, another compiler configuration, a changed Include or a
+    // truncated file must all read as a cache miss.
+    ModuleKey other_source = key;
+    other_source.source_hash = SourceHash::compute(String("Function GuardedSum() "));
+    ModuleKey other_config = key;
+    other_config.config_hash ^= 1;
+    ModuleKey other_include = key;
+    other_include.dependencies.write[0].hash = SourceHash::compute(String("Const LIMIT = 4"));
+    if (BytecodeCache::decode_module(encoded.ptr(), encoded.size(), other_source, decoded) ||
+            BytecodeCache::decode_module(encoded.ptr(), encoded.size(), other_config, decoded) ||
+            BytecodeCache::decode_module(encoded.ptr(), encoded.size(), other_include, decoded) ||
+            BytecodeCache::decode_module(encoded.ptr(), encoded.size() - 3, key, decoded)) {
+        err = "Stale or truncated module was accepted";
+        return false;
+    }
+
+    // Same file name in two folders must not share a cache file.
+    BytecodeCache cache;
+    if (cache.get_cache_filename("res://a/main.vg") == cache.get_cache_filename("res://b/main.vg")) {
+        err = "Cache filename ignores the source folder";
+        return false;
+    }
+    return true;
+}
+
+bool test_ast_arena(String &err) {
+    ASTArena arena;
+    {
+        // DATA values are parsed into a temporary module; adopting its arena
+        // must keep them alive after that module is deleted.
+        Vector<ExpressionNode *> values = VisualGasicParser::parse_data_values_from_text("1, \"two\", 3.5", arena);
+        if (values.size() != 3) {
+            err = String("Expected 3 DATA values, got ") + String::num_int64(values.size());
+            return false;
+        }
+        for (int i = 0; i < values.size(); i++) {
+            if (!values[i] || values[i]->type != ExpressionNode::LITERAL) {
+                err = "DATA value is not a literal";
+                return false;
+            }
+        }
+        if (String(static_cast<LiteralNode *>(values[1])->value) != "two") {
+            err = "Adopted DATA value was corrupted";
+            return false;
+        }
+    }
+    if (arena.get_bytes_allocated() == 0 || arena.get_bytes_reserved() < arena.get_bytes_allocated()) {
+        err = "Arena statistics are inconsistent";
+        return false;
+    }
+
+    // Interpolated strings are parsed by a nested parser sharing the
+    // module's arena; the whole module must tear down in one clear().
+    VisualGasicTokenizer tokenizer;
+    VisualGasicParser parser;
+    ModuleNode *module = parser.parse(tokenizer.tokenize("Sub Main()\n    Dim x As Long\n    x += 2\n    Print $\"x={x + 1}\"\nEnd Sub\n"));
+    if (!module || module->subs.size() != 1 || module->subs[0]->statements.size() != 3) {
+        err = "Module did not parse";
+        delete module;
+        return false;
+    }
+    delete module;
+
+    arena.clear();
+    if (arena.get_bytes_allocated() != 0 || arena.get_bytes_reserved() != 0) {
+        err = "Arena did not release its chunks";
+        return false;
+    }
+    return true;
+}
+
+bool test_incremental_reparse(String &err) {
+    const char *base =
+            "Dim total As Long\n"
+            "Sub A()\n    total = total + 1\nEnd Sub\n"
+            "\n"
+            "Function B(ByVal n As Long) As Long\n    B = n * 2\nEnd Function\n"
+            "Sub C()\n    total = B(3)\nEnd Sub\n";
+    // B's body and the blank line before it change; A and C do not.
+    const char *body_edit =
+            "Dim total As Long\n"
+            "Sub A()\n    total = total + 1\nEnd Sub\n"
+            "\n\n"
+            "Function B(ByVal n As Long) As Long\n    B = n * 3\nEnd Function\n"
+            "Sub C()\n    total = B(3)\nEnd Sub\n";
+    const char *signature_edit =
+            "Dim total As Long\n"
+            "Sub A()\n    total = total + 1\nEnd Sub\n"
+            "\n\n"
+            "Function B(ByVal n As Long, ByVal m As Long) As Long\n    B = n * 3\nEnd Function\n"
+            "Sub C()\n    total = B(3)\nEnd Sub\n";
+    const char *global_edit =
+            "Dim total As Double\n"
+            "Sub A()\n    total = total + 1\nEnd Sub\n"
+            "\n\n"
+            "Function B(ByVal n As Long, ByVal m As Long) As Long\n    B = n * 3\nEnd Function\n"
+            "Sub C()\n    total = B(3)\nEnd Sub\n";
+
+    VisualGasicTokenizer tokenizer;
+    VisualGasicParser parser;
+    String source = base;
+    ModuleNode *first = parser.parse(tokenizer.tokenize(source), source);
+    if (!first || first->subs.size() != 3 || first->declarations.size() != 3) {
+        err = "Base module did not parse";
+        delete first;
+        return false;
+    }
+    SubDefinition *a = first->subs[0];
+    SubDefinition *b = first->subs[1];
+    SubDefinition *c = first->subs[2];
+    uint64_t first_interface = first->interface_hash;
+
+    source = body_edit;
+    ModuleNode *second = parser.parse(tokenizer.tokenize(source), source, first);
+    if (!second || second->subs.size() != 3) {
+        err = "Edited module did not parse";
+        delete first;
+        delete second;
+        return false;
+    }
+    delete first;
+    if (second->subs[0] != a || second->subs[2] != c || second->subs[1] == b ||
+            second->declarations[0].previous_index != 0 || second->declarations[1].previous_index != -1) {
+        err = "Only the edited Function should have been parsed again";
+        delete second;
+        return false;
+    }
+    if (second->interface_hash != first_interface || second->stale_bytes == 0) {
+        err = "A body edit changed the module interface or freed no stale bytes";
+        delete second;
+        return false;
+    }
+
+    source = signature_edit;
+    ModuleNode *third = parser.parse(tokenizer.tokenize(source), source, second);
+    bool third_ok = third && third->subs[0] == second->subs[0] && third->interface_hash != second->interface_hash;
+    delete second;
+    if (!third_ok) {
+        err = "A signature edit should keep other Subs but change the interface";
+        delete third;
+        return false;
+    }
+
+    // Module-level declarations are visible to every Sub after them.
+    source = global_edit;
+    ModuleNode *fourth = parser.parse(tokenizer.tokenize(source), source, third);
+    bool fourth_ok = fourth && fourth->declarations.size() == 3;
+    for (int i = 0; fourth_ok && i < fourth->declarations.size(); i++) {
+        fourth_ok = fourth->declarations[i].previous_index == -1;
+    }
+    delete third;
+    delete fourth;
+    if (!fourth_ok) {
+        err = "A module-level edit should re-parse every Sub after it";
+        return false;
+    }
+    return true;
+}
+
+bool test_binder(String &err) {
+    const char *base =
+            "Dim total As Long\n"
+            "Type Point\n    X As Long\nEnd Type\n"
+            "Sub Main()\n"
+            "    Dim i As Long\n"
+            "    Dim arr(10) As Long\n"
+            "    i = total\n"
+            "    i = Twice(i)\n"
+            "    i = arr(2)\n"
+            "    i = Len(\"x\")\n"
+            "    i = Speed\n"
+            "    total = New Point\n"
+            "End Sub\n"
+            "Function Twice(ByVal n As Long) As Long\n    Twice = n * 2\nEnd Function\n";
+    // Same module with a Sub added in front of Twice.
+    const char *edited =
+            "Dim total As Long\n"
+            "Type Point\n    X As Long\nEnd Type\n"
+            "Sub Main()\n"
+            "    Dim i As Long\n"
+            "    Dim arr(10) As Long\n"
+            "    i = total\n"
+            "    i = Twice(i)\n"
+            "    i = arr(2)\n"
+            "    i = Len(\"x\")\n"
+            "    i = Speed\n"
+            "    total = New Point\n"
+            "End Sub\n"
+            "Sub Helper()\nEnd Sub\n"
+            "Function Twice(ByVal n As Long) As Long\n    Twice = n * 2\nEnd Function\n";
+
+    VisualGasicTokenizer tokenizer;
+    VisualGasicParser parser;
+    VisualGasicBinder binder;
+    String source = base;
+    ModuleNode *module = parser.parse(tokenizer.tokenize(source), source);
+    if (!module || module->subs.size() != 2 || module->subs[0]->statements.size() != 8) {
+        err = "Module did not parse";
+        delete module;
+        return false;
+    }
+    binder.bind(module);
+
+    const Vector<Statement *> &body = module->subs[0]->statements;
+    auto value_of = [&](int p_index) { return static_cast<AssignmentStatement *>(body[p_index])->value; };
+    VariableNode *total = static_cast<VariableNode *>(value_of(2));
+    CallExpression *twice = static_cast<CallExpression *>(value_of(3));
+    CallExpression *arr = static_cast<CallExpression *>(value_of(4));
+    CallExpression *len = static_cast<CallExpression *>(value_of(5));
+    VariableNode *speed = static_cast<VariableNode *>(value_of(6));
+    NewNode *point = static_cast<NewNode *>(value_of(7));
+    VariableNode *target = static_cast<VariableNode *>(static_cast<AssignmentStatement *>(body[2])->target);
+    VariableNode *argument = static_cast<VariableNode *>(twice->arguments[0]);
+
+    bool ok = total->binding.kind == BIND_GLOBAL && target->binding.kind == BIND_LOCAL &&
+            argument->binding.kind == BIND_LOCAL && argument->binding.slot == target->binding.slot &&
+            speed->binding.kind == BIND_EXTERNAL && speed->binding.slot >= 0;
+    if (!ok) {
+        err = "Variables were not resolved to their scope and slot";
+        delete module;
+        return false;
+    }
+    ok = twice->binding.kind == BIND_SUB && twice->binding.index == 1 &&
+            arr->binding.kind == BIND_LOCAL && arr->binding.slot >= 0 &&
+            len->binding.kind == BIND_INTRINSIC && len->binding.slot == -1 &&
+            point->binding.kind == BIND_STRUCT && point->binding.index == 0;
+    if (!ok) {
+        err = "Calls and New were not resolved";
+        delete module;
+        return false;
+    }
+    if (module->bind_generation == 0 || module->slot_names[total->binding.slot] != "total") {
+        err = "Module slot layout is inconsistent";
+        delete module;
+        return false;
+    }
+
+    // Tables laid out from the module agree on every bound slot, so a hint
+    // taken in one is trusted by the other without comparing names.
+    GlobalSlotTable first;
+    GlobalSlotTable second;
+    first.set_layout(module->slot_layout);
+    first.intern("OnlyInFirst");
+    second.set_layout(module->slot_layout);
+    SlotHint hint;
+    ok = first.get_layout_generation() == module->bind_generation &&
+            first.find_hinted("total", hint) == total->binding.slot && hint.generation == module->bind_generation &&
+            second.find_hinted("total", hint) == total->binding.slot && second.find("OnlyInFirst") == -1;
+    SlotHint runtime_hint;
+    ok = ok && first.find_hinted("OnlyInFirst", runtime_hint) == module->slot_names.size() && runtime_hint.slot == -1;
+    GlobalSlotTable unlaid;
+    unlaid.intern("zzz");
+    ok = ok && unlaid.find_hinted("total", hint) == -1 && unlaid.intern_hinted("total", hint) == 1;
+    if (!ok) {
+        err = "Slot tables did not share the module layout or trusted a foreign hint";
+        delete module;
+        return false;
+    }
+
+    // Main is reused by the incremental parse but Twice moved: the reused
+    // call must be bound to its new index.
+    SubDefinition *main = module->subs[0];
+    uint64_t generation = module->bind_generation;
+    source = edited;
+    ModuleNode *next = parser.parse(tokenizer.tokenize(source), source, module);
+    delete module;
+    if (!next || next->subs.size() != 3 || next->subs[0] != main) {
+        err = "Edited module did not reuse Main";
+        delete next;
+        return false;
+    }
+    binder.bind(next);
+    ok = twice->binding.kind == BIND_SUB && twice->binding.index == 2 &&
+            next->bind_generation != generation && next->slot_names[argument->binding.slot] == "i";
+    delete next;
+    if (!ok) {
+        err = "Reused nodes kept the bindings of the previous parse";
+        return false;
+    }
+    return true;
+}
+
+int test_command_calls = 0;
+void test_command(VisualGasicInstance *, const Array &) {
+    test_command_calls++;
+}
+
+bool test_command_registry(String &err) {
+    using namespace VisualGasicCommands;
+    const CommandInfo extra[] = {
+        { "VgTestCommand", 1, 2, test_command },
+        { "VgTestCommand", 0, 0, nullptr }, // Duplicate: ignored
+    };
+    register_commands(extra, 2);
+    int cls = find_command_id("cls");
+    int clear = find_command_id("ClearScreen");
+    int extra_id = find_command_id("VGTESTCOMMAND");
+    const CommandInfo *cls_info = get_command_info(cls);
+    const CommandInfo *extra_info = get_command_info(extra_id);
+    bool ok = cls >= 0 && clear >= 0 && cls != clear && cls_info && get_command_info(clear)->fn == cls_info->fn &&
+            extra_info && extra_info->fn == test_command && extra_id == get_command_count() - 1 &&
+            find_command_id("NoSuchCommand") == -1 && get_command_info(-1) == nullptr;
+    if (!ok) {
+        err = "Command names did not resolve to their registered entries";
+        return false;
+    }
+    // Outside its arity a command is not run (the caller falls back to the owner).
+    Array one;
+    one.push_back(1);
+    test_command_calls = 0;
+    ok = call_command(nullptr, extra_id, one) && !call_command(nullptr, extra_id, Array()) &&
+            !call_command(nullptr, "Sleep", Array()) && !call_command(nullptr, -1, one) &&
+            call_command(nullptr, "vgtestcommand", one) && test_command_calls == 2;
+    if (!ok) {
+        err = "Command arity checks or dispatch are wrong";
+        return false;
+    }
+
+    const char *source_text =
+            "Sub Main()\n"
+            "    CLS\n"
+            "    drawline 0, 0, 10, 10\n"
+            "    PSet 1, 2, 3\n"
+            "    VgTestCommand 5\n"
+            "    Helper\n"
+            "    NoSuchThing 1\n"
+            "    canvas.DrawLine 0, 0, 1, 1\n"
+            "End Sub\n"
+            "Sub PSet(ByVal x, ByVal y, ByVal c)\nEnd Sub\n"
+            "Sub Helper()\nEnd Sub\n";
+
+    VisualGasicTokenizer tokenizer;
+    VisualGasicParser parser;
+    VisualGasicBinder binder;
+    String source = source_text;
+    ModuleNode *module = parser.parse(tokenizer.tokenize(source), source);
+    if (!module || module->subs.size() != 3 || module->subs[0]->statements.size() != 7) {
+        err = "Command calls did not parse";
+        delete module;
+        return false;
+    }
+    binder.bind(module);
+    const Vector<Statement *> &body = module->subs[0]->statements;
+    auto binding_of = [&](int p_index) { return static_cast<CallStatement *>(body[p_index])->binding; };
+    ok = binding_of(0).kind == BIND_COMMAND && binding_of(0).index == cls &&
+            binding_of(1).kind == BIND_COMMAND && binding_of(1).index == find_command_id("DrawLine") &&
+            binding_of(2).kind == BIND_SUB && binding_of(2).index == 1 &&
+            binding_of(3).kind == BIND_COMMAND && binding_of(3).index == extra_id &&
+            binding_of(4).kind == BIND_SUB && binding_of(4).index == 2 &&
+            binding_of(5).kind == BIND_UNRESOLVED && binding_of(6).kind == BIND_UNRESOLVED;
+    delete module;
+    if (!ok) {
+        err = "Statement calls were not bound to Subs first, then commands";
+        return false;
+    }
+    return true;
+}
+
+bool test_draw_batch(String &err) {
+    // Without a canvas nothing is drawn, but the batching rules still apply.
+    VisualGasicDrawBatch batch;
+    batch.add_pixel(Vector2(1, 1), Color(1, 0, 0));
+    batch.add_rect(Rect2(0, 0, 4, 4), Color(0, 1, 0), true);
+    batch.add_circle(Vector2(10, 10), 4, Color(0, 0, 1)); // 8 segments + center
+    bool ok = batch.get_pending_triangle_vertices() == 4 + 4 + 9 && batch.get_pending_line_vertices() == 0;
+    batch.add_line(Vector2(0, 0), Vector2(5, 5), Color(1, 1, 1), 1.0f);
+    batch.add_rect(Rect2(0, 0, 4, 4), Color(1, 1, 1), false, 1.0f);
+    ok = ok && batch.get_pending_triangle_vertices() == 0 && batch.get_pending_line_vertices() == 2 + 8;
+    batch.add_line(Vector2(0, 0), Vector2(5, 5), Color(1, 1, 1), 2.0f); // New width flushes
+    ok = ok && batch.get_pending_line_vertices() == 2;
+    batch.flush();
+    ok = ok && batch.get_pending_line_vertices() == 0 && batch.get_flush_count() == 0;
+    if (!ok) {
+        err = "Draw batch did not group shapes by kind and line width";
+        return false;
+    }
+
+    batch.set_framebuffer(nullptr, 8, 4, 2);
+    batch.framebuffer_pset(7, 3, Color(1, 0, 0));
+    batch.framebuffer_pset(8, 0, Color(1, 1, 1)); // Out of range: ignored
+    batch.framebuffer_pset(-1, 0, Color(1, 1, 1));
+    ok = batch.has_framebuffer() && batch.get_framebuffer_width() == 8 && batch.get_framebuffer_height() == 4 &&
+            batch.framebuffer_pget(7, 3) == Color(1, 0, 0) && batch.framebuffer_pget(0, 0) == Color(0, 0, 0) &&
+            batch.framebuffer_pget(8, 0) == Color(0, 0, 0, 0);
+    batch.framebuffer_clear(Color(0, 0, 1));
+    ok = ok && batch.framebuffer_pget(7, 3) == Color(0, 0, 1);
+    batch.set_framebuffer(nullptr, 0, 0, 1);
+    ok = ok && !batch.has_framebuffer();
+    if (!ok) {
+        err = "Framebuffer pixels were not stored, bounded or cleared";
+        return false;
+    }
+    return true;
+}
+
+bool test_record_statements(String &err) {
+    const char *source_text =
+            "Sub Main()\n"
+            "    Open \"user://vg_records.dat\" For Random Access Read Write As #1 Len = 32\n"
+            "    Open \"user://vg_bytes.dat\" For Binary Access Read As #2\n"
+            "    Put #1, 3, rec\n"
+            "    Get #1, , rec\n"
+            "    Get #2, 1, n\n"
+            "    put = Len(\"abc\")\n"
+            "End Sub\n";
+
+    VisualGasicTokenizer tokenizer;
+    VisualGasicParser parser;
+    String source = source_text;
+    ModuleNode *module = parser.parse(tokenizer.tokenize(source), source);
+    if (!module || module->subs.size() != 1 || module->subs[0]->statements.size() != 6) {
+        err = "Open For Random/Binary, Get # and Put # did not parse";
+        delete module;
+        return false;
+    }
+    const Vector<Statement *> &body = module->subs[0]->statements;
+    OpenStatement *random = static_cast<OpenStatement *>(body[0]);
+    OpenStatement *binary = static_cast<OpenStatement *>(body[1]);
+    bool ok = body[0]->type == STMT_OPEN && random->mode == OpenStatement::MODE_RANDOM &&
+            random->access == OpenStatement::ACCESS_READ_WRITE && random->record_length != nullptr &&
+            body[1]->type == STMT_OPEN && binary->mode == OpenStatement::MODE_BINARY &&
+            binary->access == OpenStatement::ACCESS_READ && binary->record_length == nullptr;
+    for (int i = 2; ok && i < 5; i++) {
+        FileRecordStatement *s = static_cast<FileRecordStatement *>(body[i]);
+        ok = body[i]->type == STMT_FILE_RECORD && s->is_put == (i == 2) && (s->position != nullptr) == (i != 3) &&
+                s->file_number && s->variable;
+    }
+    // Get and Put stay usable as names.
+    ok = ok && body[5]->type == STMT_ASSIGNMENT;
+    delete module;
+    if (!ok) {
+        err = "Open modes, Access, Len or Get/Put operands were parsed wrongly";
+        return false;
+    }
+    return true;
+}
+
+bool test_record_files(String &err) {
+    const String random_path = "user://vg_test_records.dat";
+    const String text_path = "user://vg_test_lines.txt";
+    DirAccess::remove_absolute(random_path);
+    DirAccess::remove_absolute(text_path);
+    Error open_error = OK;
+    String record_error;
+
+    VisualGasicFile *f = VisualGasicFile::open(random_path, VisualGasicFile::MODE_RANDOM, VisualGasicFile::ACCESS_DEFAULT, 32, open_error);
+    if (!f) {
+        err = "Random file did not open";
+        return false;
+    }
+    Dictionary rec;
+    rec["name"] = "Bob";
+    rec["hp"] = (int64_t)42;
+    rec["speed"] = 1.5;
+    rec["alive"] = true;
+    bool ok = f->put_value(rec, 3, record_error) && f->length() == 96;
+    Dictionary big;
+    big["s"] = "0123456789012345678901234567890123456789";
+    ok = ok && !f->put_value(big, 1, record_error) && record_error == "Bad record length";
+    Dictionary out;
+    out["name"] = "";
+    out["hp"] = (int64_t)0;
+    out["speed"] = 0.0;
+    out["alive"] = false;
+    Variant target = out;
+    ok = ok && f->get_value(target, 3, record_error) && f->loc() == 3 && !f->eof();
+    Dictionary got = target;
+    ok = ok && String(got["name"]) == "Bob" && (int64_t)got["hp"] == 42 && (double)got["speed"] == 1.5 && (bool)got["alive"];
+    ok = ok && String(out["name"]) == "" && (int64_t)out["hp"] == 0; // Get filled a copy
+    ok = ok && f->get_value(target, 4, record_error) && f->eof();
+    memdelete(f);
+    if (!ok) {
+        err = "Random records did not round-trip (or a long record was accepted or Get changed a shared Dictionary)";
+        return false;
+    }
+
+    f = VisualGasicFile::open(random_path, VisualGasicFile::MODE_BINARY, VisualGasicFile::ACCESS_READ, 0, open_error);
+    Variant head = String("...");
+    Variant hp = (int64_t)0;
+    // Record 3 starts at byte 65: "Bob" with its 2-byte length, then hp.
+    if (!f) {
+        err = "Binary file did not open";
+        return false;
+    }
+    ok = f->get_value(hp, 65 + 2 + 3, record_error) && (int64_t)hp == 42;
+    ok = ok && f->get_value(head, 67, record_error) && String(head) == "Bob";
+    f->seek(67);
+    head = String("...");
+    ok = ok && f->get_value(head, -1, record_error) && String(head) == "Bob" && f->loc() == 69;
+    memdelete(f);
+    if (!ok) {
+        err = "Binary Get (or Seek, which is 1-based) did not read the bytes Put wrote";
+        return false;
+    }
+
+    // Type fields are stored by their declared type.
+    String type_source = "Type Hero\n    Tag As String * 4\n    Level As Integer\nEnd Type\n";
+    VisualGasicTokenizer tokenizer;
+    VisualGasicParser parser;
+    ModuleNode *module = parser.parse(tokenizer.tokenize(type_source), type_source);
+    ok = module && module->structs.size() == 1 && module->structs[0]->members.size() == 2 &&
+            module->structs[0]->members[0].fixed_length == 4 && module->structs[0]->members[1].fixed_length == 0;
+    delete module;
+    VisualGasicFile::Layout layout;
+    layout.kind = VisualGasicFile::FIELD_TYPE;
+    layout.fields.resize(5);
+    layout.fields[0].kind = VisualGasicFile::FIELD_FIXED_STRING;
+    layout.fields[0].length = 4;
+    layout.fields[1].kind = VisualGasicFile::FIELD_INTEGER;
+    layout.fields[2].kind = VisualGasicFile::FIELD_LONG;
+    layout.fields[3].kind = VisualGasicFile::FIELD_SINGLE;
+    layout.fields[4].kind = VisualGasicFile::FIELD_DOUBLE;
+    Dictionary hero;
+    hero["tag"] = "Ann";
+    hero["level"] = (int64_t)-7;
+    hero["gold"] = (int64_t)100000;
+    hero["speed"] = 0.5;
+    hero["x"] = 2.25;
+    std::vector<uint8_t> bytes;
+    ok = ok && VisualGasicFile::encode_value(hero, false, bytes, &layout) && bytes.size() == 4 + 2 + 4 + 4 + 8 && bytes[3] == ' ';
+    f = VisualGasicFile::open(random_path, VisualGasicFile::MODE_BINARY, VisualGasicFile::ACCESS_DEFAULT, 0, open_error);
+    if (!f) {
+        err = "Binary file did not reopen";
+        return false;
+    }
+    ok = ok && f->put_value(hero, 97, record_error, &layout);
+    Dictionary blank;
+    blank["tag"] = "";
+    blank["level"] = (int64_t)0;
+    blank["gold"] = (int64_t)0;
+    blank["speed"] = 0.0;
+    blank["x"] = 0.0;
+    target = blank;
+    ok = ok && f->get_value(target, 97, record_error, &layout);
+    got = target;
+    ok = ok && String(got["tag"]) == "Ann " && (int64_t)got["level"] == -7 && (int64_t)got["gold"] == 100000 &&
+            (double)got["speed"] == 0.5 && (double)got["x"] == 2.25 && f->loc() == 96 + 22;
+    memdelete(f);
+    if (!ok) {
+        err = "Type fields were not laid out by their declared types";
+        return false;
+    }
+
+    f = VisualGasicFile::open(text_path, VisualGasicFile::MODE_OUTPUT, VisualGasicFile::ACCESS_DEFAULT, 0, open_error);
+    if (!f) {
+        err = "Output file did not open";
+        return false;
+    }
+    f->write_line("first");
+    f->write_line("\"a, \"\"b\"\"\", 42, 2.5, word");
+    memdelete(f);
+    f = VisualGasicFile::open(text_path, VisualGasicFile::MODE_INPUT, VisualGasicFile::ACCESS_DEFAULT, 0, open_error);
+    if (!f) {
+        err = "Input file did not open";
+        return false;
+    }
+    Vector<Variant> fields;
+    ok = f->read_line() == "first" && !f->eof();
+    f->read_fields(fields);
+    ok = ok && f->eof() && fields.size() == 4 && String(fields[0]) == "a, \"b\"" && fields[1].get_type() == Variant::INT &&
+            (int64_t)fields[1] == 42 && (double)fields[2] == 2.5 && String(fields[3]) == "word";
+    memdelete(f);
+    DirAccess::remove_absolute(random_path);
+    DirAccess::remove_absolute(text_path);
+    if (!ok) {
+        err = "Print #, Line Input # or Input # did not round-trip";
+        return false;
+    }
+    return true;
+}
+
+bool test_data_pool(String &err) {
+    const char *source_text = "Data 10, -3, 2.5, \"Hi\", True, Vector2(1, 2)\n";
+    VisualGasicTokenizer tokenizer;
+    VisualGasicParser parser;
+    String source = source_text;
+    ModuleNode *module = parser.parse(tokenizer.tokenize(source), source);
+    if (!module || module->global_statements.size() != 1 || module->global_statements[0]->type != STMT_DATA) {
+        err = "Data statement did not parse";
+        delete module;
+        return false;
+    }
+    DataStatement *data = static_cast<DataStatement *>(module->global_statements[0]);
+    VisualGasicDataPool pool;
+    for (int i = 0; i < data->values.size(); i++) {
+        pool.add_expression(data->values[i]);
+    }
+    bool ok = pool.size() == 6 && pool.get_kind(0) == VisualGasicDataPool::KIND_INT && (int64_t)pool.get_value(0) == 10 &&
+            pool.get_kind(1) == VisualGasicDataPool::KIND_INT && (int64_t)pool.get_value(1) == -3 &&
+            pool.get_kind(2) == VisualGasicDataPool::KIND_FLOAT && (double)pool.get_value(2) == 2.5 &&
+            pool.get_kind(3) == VisualGasicDataPool::KIND_STRING && String(pool.get_value(3)) == "Hi" &&
+            pool.get_kind(4) == VisualGasicDataPool::KIND_BOOL && (bool)pool.get_value(4) &&
+            pool.get_expression(5) == data->values[5] && !pool.ensure(6);
+    if (!ok) {
+        delete module;
+        err = "Data literals were not stored typed (or an expression was not kept)";
+        return false;
+    }
+
+    const String path = "user://vg_test_data.txt";
+    Ref<FileAccess> file = FileAccess::open(path, FileAccess::WRITE);
+    if (file.is_null()) {
+        delete module;
+        err = "Could not write the data file";
+        return false;
+    }
+    file->store_string("1, 2 ' comment, 99\nData \"a, \"\"b\"\"\", 4.5\n7\n");
+    file->close();
+    ok = pool.add_file(path) == OK && pool.size() == 6 && pool.has_pending_files();
+    // Values are parsed one READ at a time.
+    ok = ok && pool.ensure(6) && pool.size() == 7 && (int64_t)pool.get_value(6) == 1;
+    ok = ok && pool.ensure(10) && (int64_t)pool.get_value(7) == 2 && String(pool.get_value(8)) == "a, \"b\"" &&
+            (double)pool.get_value(9) == 4.5 && (int64_t)pool.get_value(10) == 7;
+    ok = ok && !pool.ensure(11) && !pool.has_pending_files();
+    delete module;
+    DirAccess::remove_absolute(path);
+    if (!ok) {
+        err = "LoadData values were not streamed in order";
+        return false;
+    }
+    return true;
+}
+
+bool test_whenever_reads(String &err) {
+    const char *source_text =
+            "Sub Main()\n"
+            "    Whenever Section Low (health < 20 And Abs(mana) < health) Warn\n"
+            "    Whenever Section High (Score() > 5) Warn\n"
+            "End Sub\n"
+            "Function Score() As Long\n    Score = 1\nEnd Function\n"
+            "Sub Warn()\nEnd Sub\n";
+
+    VisualGasicTokenizer tokenizer;
+    VisualGasicParser parser;
+    String source = source_text;
+    ModuleNode *module = parser.parse(tokenizer.tokenize(source), source);
+    if (!module || module->subs.size() != 3 || module->subs[0]->statements.size() != 2) {
+        err = "Module did not parse";
+        delete module;
+        return false;
+    }
+    const Vector<Statement *> &body = module->subs[0]->statements;
+    ExpressionNode *low = static_cast<WheneverSectionStatement *>(body[0])->condition_expression;
+    ExpressionNode *high = static_cast<WheneverSectionStatement *>(body[1])->condition_expression;
+
+    Vector<String> reads;
+    bool complete = VisualGasicBinder::collect_reads(low, reads);
+    bool ok = complete && reads.size() == 3 && reads.has("health") && reads.has("mana");
+    reads.clear();
+    ok = ok && !VisualGasicBinder::collect_reads(high, reads);
+    delete module;
+    if (!ok) {
+        err = "Condition reads were not collected (or a Function call was treated as known)";
+        return false;
+    }
+    return true;
+}
+
+bool test_class_layout(String &err) {
+    const char *source_text =
+            "Dim count As Long\n"
+            "Class Particle\n"
+            "    Public X As Double\n"
+            "    Private vx As Double\n"
+            "    Sub Class_Initialize()\n        vx = 1\n        count = count + 1\n    End Sub\n"
+            "    Public Sub Move(ByVal dt As Double)\n"
+            "        Dim delta As Double\n"
+            "        delta = vx * dt\n"
+            "        X = X + delta\n"
+            "        Bump\n"
+            "    End Sub\n"
+            "    Private Sub Bump()\n    End Sub\n"
+            "    Sub Class_Terminate()\n        count = count - 1\n    End Sub\n"
+            "End Class\n"
+            "Sub Main()\n    Dim p\n    p = New Particle\n    p.Move 0.5\nEnd Sub\n";
+
+    VisualGasicTokenizer tokenizer;
+    VisualGasicParser parser;
+    VisualGasicBinder binder;
+    String source = source_text;
+    ModuleNode *module = parser.parse(tokenizer.tokenize(source), source);
+    if (!module || module->classes.size() != 1 || module->subs.size() != 1) {
+        err = "Class block did not parse";
+        delete module;
+        return false;
+    }
+    ClassDefinition *cls = module->classes[0];
+    if (cls->members.size() != 2 || cls->methods.size() != 4 || cls->class_initialize != cls->methods[0] ||
+            cls->class_terminate != cls->methods[3] || cls->methods[1]->statements.size() != 4) {
+        err = "Class members, methods or Class_Initialize/Class_Terminate were not recorded";
+        delete module;
+        return false;
+    }
+    binder.bind(module);
+
+    const int *vx = cls->member_index.getptr("vx");
+    const int *move = cls->method_index.getptr("move");
+    bool ok = vx && *vx == 1 && move && *move == 1 && cls->method_index.has("class_terminate");
+    const Vector<Statement *> &init = cls->methods[0]->statements;
+    const Vector<Statement *> &body = cls->methods[1]->statements;
+    VariableNode *init_target = static_cast<VariableNode *>(static_cast<AssignmentStatement *>(init[0])->target);
+    VariableNode *counter = static_cast<VariableNode *>(static_cast<AssignmentStatement *>(init[1])->target);
+    VariableNode *x_target = static_cast<VariableNode *>(static_cast<AssignmentStatement *>(body[2])->target);
+    BinaryOpNode *sum = static_cast<BinaryOpNode *>(static_cast<AssignmentStatement *>(body[2])->value);
+    CallStatement *bump = static_cast<CallStatement *>(body[3]);
+    ok = ok && init_target->binding.kind == BIND_MEMBER && init_target->binding.index == 1 && init_target->binding.slot == -1 &&
+            counter->binding.kind == BIND_GLOBAL && x_target->binding.kind == BIND_MEMBER && x_target->binding.index == 0 &&
+            static_cast<VariableNode *>(sum->right)->binding.kind == BIND_LOCAL &&
+            bump->binding.kind == BIND_METHOD && bump->binding.index == 2;
+    if (!ok) {
+        err = "Fields and methods were not bound to the class layout";
+        delete module;
+        return false;
+    }
+
+    const Vector<Statement *> &main = module->subs[0]->statements;
+    NewNode *creation = static_cast<NewNode *>(static_cast<AssignmentStatement *>(main[1])->value);
+    CallStatement *call = static_cast<CallStatement *>(main[2]);
+    ok = creation->binding.kind == BIND_CLASS && creation->binding.index == 0 &&
+            call->base_object && call->binding.kind == BIND_UNRESOLVED && call->class_cache.definition == nullptr;
+    delete module;
+    if (!ok) {
+        err = "New Particle was not bound to the class";
+        return false;
+    }
+    return true;
+}
+
+#if VG_USE_FFI
+// Native callee for test_declare_stub: ten mixed integer, floating-point and
+// pointer parameters, past the old eight-argument limit.
+double ffi_mix(int32_t a, double b, int64_t c, float d, const char *e, int32_t f, double g, int16_t h, uint8_t i, double j) {
+    return a + b + c + d + (double)strlen(e) + (f == -1 ? 100 : 0) + g + h + i + j;
+}
+#endif
+
+bool test_declare_stub(String &err) {
+    const char *source_text =
+            "Declare Function Mix Lib \"vgtest\" Alias \"ffi_mix\" (ByVal a As Integer, ByVal b As Double, "
+            "ByVal c As Long, ByVal d As Single, ByVal e As String, ByVal f As Boolean, ByVal g As Double, "
+            "ByVal h As Short, ByVal i As Byte, ByVal j As Double) As Double\n"
+            "Private Declare Sub Beep Lib \"vgtest\" ()\n"
+            "Sub Main()\n"
+            "    Dim r As Double\n"
+            "    r = Mix(1, 2.5, 3, 0.5, \"abcd\", True, 10, -2, 200, 0.25)\n"
+            "    Beep\n"
+            "End Sub\n";
+
+    VisualGasicTokenizer tokenizer;
+    VisualGasicParser parser;
+    VisualGasicBinder binder;
+    String source = source_text;
+    ModuleNode *module = parser.parse(tokenizer.tokenize(source), source);
+    if (!module || module->declares.size() != 2 || module->subs.size() != 1) {
+        err = "Declare statements did not parse";
+        delete module;
+        return false;
+    }
+    const DeclareStatement *mix = module->declares[0];
+    bool ok = mix->alias_name == "ffi_mix" && mix->lib_name == "vgtest" && mix->param_types.size() == 10 &&
+            mix->param_types[8] == "Byte" && mix->return_type == "Double" && module->declares[1]->return_type.is_empty();
+    binder.bind(module);
+    const Vector<Statement *> &body = module->subs[0]->statements;
+    CallExpression *call = static_cast<CallExpression *>(static_cast<AssignmentStatement *>(body[1])->value);
+    CallStatement *beep = static_cast<CallStatement *>(body[2]);
+    ok = ok && call->binding.kind == BIND_DECLARE && call->binding.index == 0 &&
+            beep->binding.kind == BIND_DECLARE && beep->binding.index == 1;
+    if (!ok) {
+        err = "Declare signature or call bindings are wrong";
+        delete module;
+        return false;
+    }
+
+#if VG_USE_FFI
+    VisualGasicFFIStub stub;
+    String error;
+    if (!stub.prepare((void *)&ffi_mix, mix, error)) {
+        err = error;
+        delete module;
+        return false;
+    }
+    // "vgtest" is no library: create() reports that instead of a stub.
+    error = String();
+    VisualGasicFFIStub *missing = VisualGasicFFIStub::create(mix, error);
+    delete module;
+    if (missing || !error.contains("vgtest")) {
+        err = "A Declare of a missing library produced a stub";
+        if (missing) {
+            memdelete(missing);
+        }
+        return false;
+    }
+    Variant args[10] = { 1, 2.5, 3, 0.5, "abcd", true, 10, -2, 200, 0.25 };
+    Variant ret = stub.call(args, 10);
+    if (ret.get_type() != Variant::FLOAT || (double)ret != 319.25) {
+        err = String("Expected 319.25, got ") + format_value(ret);
+        return false;
+    }
+#else
+    delete module; // Built without libffi: only parsing and binding are checked
+#endif
+    return true;
+}
+
+bool test_task_scheduler(String &err) {
+    using namespace VisualGasic::Async;
+    TaskScheduler &scheduler = TaskScheduler::get_instance();
+
+    TaskHandle first = scheduler.schedule([]() { return TaskResult(Variant((int64_t)41)); });
+    std::atomic<int64_t> seen{ 0 };
+    scheduler.then(first, [&seen](const TaskResult &result) { seen = (int64_t)result.value + 1; });
+    if ((int64_t)scheduler.await(first).value != 41 || seen != 42) {
+        err = "Await or its continuation did not see the task result";
+        return false;
+    }
+    // Awaiting released the slot: the next task reuses it under a new handle.
+    TaskHandle second = scheduler.schedule([]() { return TaskResult(Variant((int64_t)7)); });
+    bool reused = (second.get_id() & 0xffffffffu) == (first.get_id() & 0xffffffffu) && second != first;
+    TaskResult stale = scheduler.get_result(first);
+    scheduler.await(second);
+    if (!reused || stale.success || !scheduler.is_completed(first)) {
+        err = "Awaited task slot was not reclaimed";
+        return false;
+    }
+
+    TaskHandle any_slow = scheduler.schedule([]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        return TaskResult(Variant((int64_t)1));
+    });
+    TaskHandle any_fast = scheduler.schedule([]() { return TaskResult(Variant((int64_t)2)); });
+    TaskHandle winner;
+    TaskResult any = scheduler.await_any({ any_slow, any_fast }, winner);
+    scheduler.await(winner == any_slow ? any_fast : any_slow);
+    if (!winner.is_valid() || (int64_t)any.value != (winner == any_slow ? 1 : 2)) {
+        err = "await_any returned the wrong task";
+        return false;
+    }
+    return true;
+}
+
+// Each level forks one half and computes the other inline, so the join
+// depth far exceeds the worker count; blocking awaits would deadlock.
+int64_t fork_join_fib(int64_t n) {
+    using namespace VisualGasic::Async;
+    if (n < 2) {
+        return n;
+    }
+    TaskScheduler &scheduler = TaskScheduler::get_instance();
+    TaskHandle left = scheduler.schedule([n]() { return TaskResult(Variant(fork_join_fib(n - 1))); });
+    int64_t right = fork_join_fib(n - 2);
+    return (int64_t)scheduler.await(left).value + right;
+}
+
+bool test_work_stealing(String &err) {
+    using namespace VisualGasic::Async;
+    TaskScheduler &scheduler = TaskScheduler::get_instance();
+
+    TaskHandle root = scheduler.schedule([]() { return TaskResult(Variant(fork_join_fib(16))); });
+    int64_t fib = (int64_t)scheduler.await(root).value;
+    if (fib != 987) {
+        err = String("Fork-join fib(16) returned ") + String::num_int64(fib);
+        return false;
+    }
+
+    // Every index must be visited exactly once, also when nested in a task.
+    std::vector<int64_t> items(10000);
+    for (size_t i = 0; i < items.size(); i++) {
+        items[i] = (int64_t)i;
+    }
+    TaskHandle nested = scheduler.schedule([&items]() {
+        std::vector<TaskResult> results = ParallelExecutor::parallel_for<int64_t>(items,
+                [](const int64_t &item, size_t index) { return TaskResult(Variant(item * 2 - (int64_t)index)); });
+        int64_t sum = 0;
+        for (const TaskResult &result : results) {
+            sum += (int64_t)result.value;
+        }
+        return TaskResult(Variant(sum));
+    });
+    int64_t sum = (int64_t)scheduler.await(nested).value;
+    int64_t expected = (int64_t)items.size() * ((int64_t)items.size() - 1) / 2;
+    if (sum != expected) {
+        err = String("parallel_for sum ") + String::num_int64(sum) + ", expected " + String::num_int64(expected);
+        return false;
+    }
+    return true;
+}
 } // namespace
 
 void VisualGasicTestRunner::_bind_methods() {
@@ -467,12 +1819,32 @@ Dictionary VisualGasicTestRunner::run_bytecode_tests() {
         {"Bytecode local arithmetic", test_bytecode_locals},
         {"Bytecode conditional flow", test_bytecode_conditionals},
         {"Bytecode array operations", test_bytecode_array_ops},
+        {"Bytecode builtin table call", test_bytecode_call_builtin},
+        {"Expression builtin dispatch", test_expr_builtin_dispatch},
         {"Bytecode interop fusion", test_bytecode_interop_name_len},
         {"Bytecode alloc fill", test_bytecode_alloc_fill_i64},
         {"Bytecode dict sum", test_bytecode_sum_dict},
         {"Bytecode allocation fusion", test_bytecode_alloc_fill_repeat},
         {"Bytecode nested string fusion", test_bytecode_string_repeat_outer},
         {"Bytecode branch fusion", test_bytecode_branch_sum},
+        {"Bytecode wide operands", test_bytecode_wide_operands},
+        {"Bytecode format version", test_bytecode_format_version},
+        {"Bytecode register tier", test_bytecode_register_ops},
+        {"Bytecode array range guard", test_bytecode_array_guard},
+        {"Bytecode module cache", test_bytecode_module_cache},
+        {"AST arena ownership", test_ast_arena},
+        {"Incremental reparse", test_incremental_reparse},
+        {"Binder resolution", test_binder},
+        {"Command registry", test_command_registry},
+        {"Draw batch", test_draw_batch},
+        {"Get/Put statements", test_record_statements},
+        {"Buffered record files", test_record_files},
+        {"Data pool and LoadData streaming", test_data_pool},
+        {"Whenever condition reads", test_whenever_reads},
+        {"Class layout binding", test_class_layout},
+        {"Declare call stub", test_declare_stub},
+        {"Task scheduler await and slot reuse", test_task_scheduler},
+        {"Work-stealing fork-join", test_work_stealing},
     };
 
     Array details;
@@ -0,0 +1,475 @@
+#ifndef VISUAL_GASIC_TOKEN_SCANNER_H
+#define VISUAL_GASIC_TOKEN_SCANNER_H
+
+// Godot-free scanning core shared by VisualGasicTokenizer and the tools/
+// harnesses. It walks a UTF-8 (char) or UTF-32 (char32_t) buffer in place
+// and emits compact tokens: kind, span into the buffer, and an id (keyword,
+// operator or interned identifier). Nothing is copied; callers materialise
+// text only for the tokens that need it. Lines and columns count code units,
+// so a UTF-8 view reports byte columns after non-ASCII text.
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace VisualGasicScan {
+
+// Same order as VisualGasicTokenizer::TokenType.
+enum TokenKind : uint8_t {
+    KIND_EOF,
+    KIND_NEWLINE,
+    KIND_IDENTIFIER,
+    KIND_KEYWORD,
+    KIND_LITERAL_INTEGER,
+    KIND_LITERAL_FLOAT,
+    KIND_LITERAL_STRING,
+    KIND_STRING_INTERP,
+    KIND_OPERATOR,
+    KIND_PAREN_OPEN,
+    KIND_PAREN_CLOSE,
+    KIND_COMMA,
+    KIND_COLON,
+    KIND_COMMENT,
+    KIND_ERROR
+};
+
+// Canonical spellings, used as the TOKEN_KEYWORD value. The index is the
+// keyword id; order does not matter, duplicates are not allowed.
+static constexpr const char *KEYWORDS[] = {
+    "Dim", "Sub", "End", "Function", "If", "Then", "Else", "For", "To", "Next",
+    "Step", "While", "Wend", "Do", "Loop", "Print", "Call", "And", "Or", "Not",
+    "Xor", "On", "Error", "Resume", "Goto", "Until", "Select", "Case", "Type", "As",
+    "Open", "Close", "Input", "Output", "Append", "Line", "Include", "Exit", "Public", "Private",
+    "Redim", "Preserve", "Set", "Nothing", "Inherits", "Extends", "Me", "Event", "RaiseEvent", "New",
+    "Dictionary", "each", "in", "with", "Return", "Continue", "AndAlso", "OrElse", "IIf", "True",
+    "False", "Const", "DoEvents", "Data", "Read", "Restore", "Option", "Explicit", "Try", "Catch",
+    "Finally", "Pass", "Elif", "ElseIf", "Optional", "ByVal", "ByRef", "ParamArray", "Static", "Whenever",
+    "Section", "Changes", "Becomes", "Exceeds", "Below", "Between", "Contains", "Local", "Suspend", "Async",
+    "Await", "Task", "Parallel", "Of", "Where", "Match", "When", "Is", "IsNot", "TypeOf",
+    "HasValue", "Value",
+};
+static constexpr int KEYWORD_COUNT = sizeof(KEYWORDS) / sizeof(KEYWORDS[0]);
+
+// Operator and punctuation spellings; CompactToken::id for those kinds.
+enum OperatorId : uint8_t {
+    OPR_PLUS, OPR_PLUS_ASSIGN, OPR_INCREMENT,
+    OPR_MINUS, OPR_MINUS_ASSIGN, OPR_DECREMENT,
+    OPR_STAR, OPR_STAR_ASSIGN, OPR_POWER,
+    OPR_SLASH, OPR_SLASH_ASSIGN, OPR_INT_DIVIDE,
+    OPR_AMPERSAND, OPR_DOT, OPR_EQUAL, OPR_HASH,
+    OPR_GREATER, OPR_GREATER_EQUAL, OPR_LESS, OPR_LESS_EQUAL, OPR_LESS_GREATER,
+    OPR_BANG, OPR_BANG_EQUAL,
+    OPR_PAREN_OPEN, OPR_PAREN_CLOSE, OPR_COMMA, OPR_COLON,
+    OPR_COUNT
+};
+static constexpr const char *OPERATORS[OPR_COUNT] = {
+    "+", "+=", "++",
+    "-", "-=", "--",
+    "*", "*=", "**",
+    "/", "/=", "//",
+    "&", ".", "=", "#",
+    ">", ">=", "<", "<=", "<>",
+    "!", "!=",
+    "(", ")", ",", ":",
+};
+
+// CompactToken::id for KIND_ERROR.
+enum ErrorId : uint8_t {
+    ERR_UNEXPECTED_CHARACTER, // span is the character
+    ERR_UNTERMINATED_STRING,  // span is the string body up to the line end
+};
+
+struct CompactToken {
+    TokenKind kind;
+    uint8_t id;      // Keyword, operator or error id (see above)
+    int32_t atom;    // Interned identifier id for KIND_IDENTIFIER, else -1
+    uint32_t start;  // Span in code units
+    uint32_t length;
+    int32_t line;
+    int32_t column;
+};
+
+struct ScanResult {
+    std::vector<CompactToken> tokens;
+    // Identifier atoms: first occurrence of each distinct spelling (exact case).
+    std::vector<uint32_t> atom_start;
+    std::vector<uint32_t> atom_length;
+    bool has_error = false;
+    int32_t error_line = 0;
+    int32_t error_column = 0;
+    uint32_t error_offset = 0;
+};
+
+// --- Character classes -----------------------------------------------------
+
+enum CharClass : uint8_t {
+    CC_DIGIT = 1,
+    CC_ALPHA = 2, // A-Z, a-z and _
+    CC_SPACE = 4, // Space, tab and CR; LF is a token
+};
+
+struct CharTable {
+    uint8_t classes[128] = {};
+};
+
+constexpr CharTable make_char_table() {
+    CharTable t;
+    for (int c = '0'; c <= '9'; c++) {
+        t.classes[c] = CC_DIGIT;
+    }
+    for (int c = 'a'; c <= 'z'; c++) {
+        t.classes[c] = CC_ALPHA;
+        t.classes[c - 'a' + 'A'] = CC_ALPHA;
+    }
+    t.classes[(int)'_'] = CC_ALPHA;
+    t.classes[(int)' '] = CC_SPACE;
+    t.classes[(int)'\t'] = CC_SPACE;
+    t.classes[(int)'\r'] = CC_SPACE;
+    return t;
+}
+static constexpr CharTable CHAR_TABLE = make_char_table();
+
+template <typename CharT>
+constexpr uint32_t code_unit(CharT c) {
+    return (uint32_t)(typename std::make_unsigned<CharT>::type)c;
+}
+
+// Non-ASCII code units have no class, as before.
+template <typename CharT>
+inline uint8_t char_class(CharT c) {
+    uint32_t u = code_unit(c);
+    return u < 128 ? CHAR_TABLE.classes[u] : 0;
+}
+
+// --- Keyword perfect hash --------------------------------------------------
+// Case-insensitive FNV-1a with a seed chosen at compile time so every
+// keyword lands in its own slot: a lookup is one hash, one probe and one
+// name compare.
+
+static constexpr uint32_t KEYWORD_SLOTS = 1024;
+static constexpr int KEYWORD_MAX_LENGTH = 16;
+
+constexpr uint32_t fold_ascii(uint32_t c) {
+    return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+template <typename CharT>
+constexpr uint32_t keyword_hash(const CharT *p_chars, size_t p_len, uint32_t p_seed) {
+    uint32_t h = 2166136261u ^ p_seed;
+    for (size_t i = 0; i < p_len; i++) {
+        h ^= fold_ascii(code_unit(p_chars[i]));
+        h *= 16777619u;
+    }
+    return h;
+}
+
+constexpr size_t const_strlen(const char *s) {
+    size_t n = 0;
+    while (s[n] != '\0') {
+        n++;
+    }
+    return n;
+}
+
+struct KeywordTable {
+    uint32_t seed = 0; // 0 = no seed found
+    uint8_t slots[KEYWORD_SLOTS] = {}; // keyword id + 1, 0 = empty
+};
+
+constexpr KeywordTable build_keyword_table() {
+    for (uint32_t seed = 1; seed < 100000; seed++) {
+        KeywordTable t;
+        bool collision = false;
+        for (int i = 0; i < KEYWORD_COUNT && !collision; i++) {
+            uint32_t slot = keyword_hash(KEYWORDS[i], const_strlen(KEYWORDS[i]), seed) & (KEYWORD_SLOTS - 1);
+            if (t.slots[slot] != 0) {
+                collision = true;
+            } else {
+                t.slots[slot] = (uint8_t)(i + 1);
+            }
+        }
+        if (!collision) {
+            t.seed = seed;
+            return t;
+        }
+    }
+    return KeywordTable();
+}
+static constexpr KeywordTable KEYWORD_TABLE = build_keyword_table();
+static_assert(KEYWORD_TABLE.seed != 0, "No perfect hash seed for KEYWORDS; raise KEYWORD_SLOTS");
+static_assert(KEYWORD_COUNT < 255, "Keyword ids must fit in a byte");
+
+// Returns the keyword id for the span, or -1.
+template <typename CharT>
+inline int find_keyword(const CharT *p_chars, size_t p_len) {
+    if (p_len == 0 || p_len > (size_t)KEYWORD_MAX_LENGTH) {
+        return -1;
+    }
+    int slot = KEYWORD_TABLE.slots[keyword_hash(p_chars, p_len, KEYWORD_TABLE.seed) & (KEYWORD_SLOTS - 1)];
+    if (slot == 0) {
+        return -1;
+    }
+    const char *ref = KEYWORDS[slot - 1];
+    for (size_t i = 0; i < p_len; i++) {
+        if (ref[i] == '\0' || fold_ascii(code_unit(p_chars[i])) != fold_ascii((uint32_t)ref[i])) {
+            return -1;
+        }
+    }
+    return ref[p_len] == '\0' ? slot - 1 : -1;
+}
+
+// --- Scanner ---------------------------------------------------------------
+
+template <typename CharT>
+class Scanner {
+    const CharT *src;
+    uint32_t length;
+    ScanResult &out;
+
+    // Open-addressed identifier intern table: slot -> atom + 1.
+    std::vector<uint32_t> atom_hash;
+    std::vector<int32_t> atom_slots;
+
+    void push(TokenKind p_kind, uint8_t p_id, uint32_t p_start, uint32_t p_len, int32_t p_line, int32_t p_column, int32_t p_atom = -1) {
+        CompactToken t;
+        t.kind = p_kind;
+        t.id = p_id;
+        t.atom = p_atom;
+        t.start = p_start;
+        t.length = p_len;
+        t.line = p_line;
+        t.column = p_column;
+        out.tokens.push_back(t);
+    }
+
+    bool same_span(uint32_t a, uint32_t b, uint32_t len) const {
+        for (uint32_t i = 0; i < len; i++) {
+            if (src[a + i] != src[b + i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int32_t intern(uint32_t p_start, uint32_t p_len) {
+        uint32_t h = 2166136261u;
+        for (uint32_t i = 0; i < p_len; i++) {
+            h ^= code_unit(src[p_start + i]);
+            h *= 16777619u;
+        }
+        if ((out.atom_start.size() + 1) * 2 > atom_slots.size()) {
+            rehash(atom_slots.empty() ? 256 : atom_slots.size() * 2);
+        }
+        size_t mask = atom_slots.size() - 1;
+        for (size_t slot = h & mask;; slot = (slot + 1) & mask) {
+            int32_t entry = atom_slots[slot];
+            if (entry == 0) {
+                int32_t atom = (int32_t)out.atom_start.size();
+                out.atom_start.push_back(p_start);
+                out.atom_length.push_back(p_len);
+                atom_hash.push_back(h);
+                atom_slots[slot] = atom + 1;
+                return atom;
+            }
+            int32_t atom = entry - 1;
+            if (atom_hash[atom] == h && out.atom_length[atom] == p_len && same_span(out.atom_start[atom], p_start, p_len)) {
+                return atom;
+            }
+        }
+    }
+
+    void rehash(size_t p_size) {
+        atom_slots.assign(p_size, 0);
+        size_t mask = p_size - 1;
+        for (size_t atom = 0; atom < atom_hash.size(); atom++) {
+            size_t slot = atom_hash[atom] & mask;
+            while (atom_slots[slot] != 0) {
+                slot = (slot + 1) & mask;
+            }
+            atom_slots[slot] = (int32_t)atom + 1;
+        }
+    }
+
+    bool next_is(uint32_t p_pos, char p_c) const {
+        return p_pos + 1 < length && src[p_pos + 1] == (CharT)p_c;
+    }
+
+public:
+    Scanner(const CharT *p_src, size_t p_length, ScanResult &r_out) :
+            src(p_src), length((uint32_t)p_length), out(r_out) {}
+
+    void run() {
+        out.tokens.clear();
+        out.tokens.reserve(length / 4 + 16);
+        out.atom_start.clear();
+        out.atom_length.clear();
+        out.has_error = false;
+
+        uint32_t current = 0;
+        int32_t line = 1;
+        int32_t column = 1;
+
+        while (current < length) {
+            CharT c = src[current];
+            uint8_t cls = char_class(c);
+
+            if (cls & CC_SPACE) {
+                current++;
+                column++;
+                continue;
+            }
+
+            if (c == (CharT)'\n') {
+                push(KIND_NEWLINE, 0, current, 1, line, column);
+                current++;
+                line++;
+                column = 1;
+                continue;
+            }
+
+            // ' comments run to the end of the line; the newline is its own token.
+            if (c == (CharT)'\'') {
+                uint32_t start = current;
+                while (current < length && src[current] != (CharT)'\n') {
+                    current++;
+                }
+                push(KIND_COMMENT, 0, start, current - start, line, column);
+                column += current - start;
+                continue;
+            }
+
+            if (c == (CharT)'/' && next_is(current, '*')) {
+                uint32_t start = current;
+                int32_t start_line = line;
+                int32_t start_column = column;
+                current += 2;
+                column += 2;
+                while (current + 1 < length) {
+                    if (src[current] == (CharT)'*' && src[current + 1] == (CharT)'/') {
+                        current += 2;
+                        column += 2;
+                        break;
+                    }
+                    if (src[current] == (CharT)'\n') {
+                        line++;
+                        column = 1;
+                    } else {
+                        column++;
+                    }
+                    current++;
+                }
+                push(KIND_COMMENT, 0, start, current - start, start_line, start_column);
+                continue;
+            }
+
+            if (cls & CC_DIGIT) {
+                uint32_t start = current;
+                bool is_float = false;
+                while (current < length && ((char_class(src[current]) & CC_DIGIT) || src[current] == (CharT)'.')) {
+                    if (src[current] == (CharT)'.') {
+                        if (is_float) {
+                            break; // Second dot
+                        }
+                        is_float = true;
+                    }
+                    current++;
+                }
+                push(is_float ? KIND_LITERAL_FLOAT : KIND_LITERAL_INTEGER, 0, start, current - start, line, column);
+                column += current - start;
+                continue;
+            }
+
+            if (cls & CC_ALPHA) {
+                uint32_t start = current;
+                while (current < length && (char_class(src[current]) & (CC_ALPHA | CC_DIGIT))) {
+                    current++;
+                }
+                uint32_t len = current - start;
+                int keyword = find_keyword(src + start, len);
+                if (keyword >= 0) {
+                    push(KIND_KEYWORD, (uint8_t)keyword, start, len, line, column);
+                } else {
+                    push(KIND_IDENTIFIER, 0, start, len, line, column, intern(start, len));
+                }
+                column += len;
+                continue;
+            }
+
+            bool is_interpolated = false;
+            if (c == (CharT)'$' && next_is(current, '"')) {
+                is_interpolated = true;
+                current++; // Eat $
+                c = (CharT)'"';
+            }
+
+            if (c == (CharT)'"') {
+                current++; // Opening quote
+                uint32_t start = current;
+                while (current < length && src[current] != (CharT)'"' && src[current] != (CharT)'\n') {
+                    current++;
+                }
+                if (current >= length || src[current] == (CharT)'\n') {
+                    push(KIND_ERROR, ERR_UNTERMINATED_STRING, start, current - start, line, column);
+                    continue;
+                }
+                push(is_interpolated ? KIND_STRING_INTERP : KIND_LITERAL_STRING, 0, start, current - start, line, column);
+                current++; // Closing quote
+                // Full token width, including quotes and the optional $
+                column += current - start + 1 + (is_interpolated ? 1 : 0);
+                continue;
+            }
+
+            TokenKind kind = KIND_OPERATOR;
+            int op = -1;
+            switch (code_unit(c)) {
+                case '(': kind = KIND_PAREN_OPEN; op = OPR_PAREN_OPEN; break;
+                case ')': kind = KIND_PAREN_CLOSE; op = OPR_PAREN_CLOSE; break;
+                case ',': kind = KIND_COMMA; op = OPR_COMMA; break;
+                case ':': kind = KIND_COLON; op = OPR_COLON; break;
+                case '+': op = next_is(current, '=') ? OPR_PLUS_ASSIGN : next_is(current, '+') ? OPR_INCREMENT : OPR_PLUS; break;
+                case '-': op = next_is(current, '=') ? OPR_MINUS_ASSIGN : next_is(current, '-') ? OPR_DECREMENT : OPR_MINUS; break;
+                case '*': op = next_is(current, '=') ? OPR_STAR_ASSIGN : next_is(current, '*') ? OPR_POWER : OPR_STAR; break;
+                // '/' followed by '*' was taken as a block comment above.
+                case '/': op = next_is(current, '=') ? OPR_SLASH_ASSIGN : next_is(current, '/') ? OPR_INT_DIVIDE : OPR_SLASH; break;
+                case '&': op = OPR_AMPERSAND; break;
+                case '.': op = OPR_DOT; break;
+                case '=': op = OPR_EQUAL; break;
+                case '#': op = OPR_HASH; break;
+                case '>': op = next_is(current, '=') ? OPR_GREATER_EQUAL : OPR_GREATER; break;
+                case '<': op = next_is(current, '=') ? OPR_LESS_EQUAL : next_is(current, '>') ? OPR_LESS_GREATER : OPR_LESS; break;
+                case '!': op = next_is(current, '=') ? OPR_BANG_EQUAL : OPR_BANG; break;
+                default: break;
+            }
+
+            if (op < 0) {
+                push(KIND_ERROR, ERR_UNEXPECTED_CHARACTER, current, 1, line, column);
+                if (!out.has_error) {
+                    out.has_error = true;
+                    out.error_line = line;
+                    out.error_column = column;
+                    out.error_offset = current;
+                }
+                current++;
+                column++;
+                continue;
+            }
+
+            uint32_t width = OPERATORS[op][1] != '\0' ? 2 : 1;
+            push(kind, (uint8_t)op, current, width, line, column);
+            current += width;
+            column += width;
+        }
+
+        push(KIND_EOF, 0, length, 0, line, column);
+    }
+};
+
+template <typename CharT>
+inline void scan(const CharT *p_src, size_t p_length, ScanResult &r_result) {
+    Scanner<CharT>(p_src, p_length, r_result).run();
+}
+
+} // namespace VisualGasicScan
+
+#endif // VISUAL_GASIC_TOKEN_SCANNER_H
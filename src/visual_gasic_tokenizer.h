@@ -33,6 +33,9 @@ public:
         Variant value;
         int line;
         int column;
+        // Span in the tokenized source; string literals exclude their quotes.
+        int offset = 0;
+        int length = 0;
     };
 
     VisualGasicTokenizer();
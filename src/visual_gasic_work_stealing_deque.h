@@ -0,0 +1,123 @@
+#ifndef VISUAL_GASIC_WORK_STEALING_DEQUE_H
+#define VISUAL_GASIC_WORK_STEALING_DEQUE_H
+
+// Chase-Lev work-stealing deque (Chase & Lev 2005, with the C11 memory
+// orderings of Le et al. 2013). One owner thread pushes and pops at the
+// bottom without locking; any other thread may steal from the top. Buffers
+// grow by doubling; replaced buffers are kept until the deque is destroyed,
+// since a concurrent thief may still be reading one.
+//
+// T must be a pointer (or another trivially copyable type whose
+// value-initialised form, T(), means "empty").
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace VisualGasic {
+namespace Async {
+
+template <typename T>
+class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(int64_t p_capacity = 256) {
+        buffers_.push_back(std::make_unique<Buffer>(p_capacity));
+        buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque &) = delete;
+    WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+    // Owner only.
+    void push(T p_item) {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        int64_t top = top_.load(std::memory_order_acquire);
+        Buffer *buffer = buffer_.load(std::memory_order_relaxed);
+        if (bottom - top > buffer->capacity - 1) {
+            buffer = grow(buffer, top, bottom);
+        }
+        buffer->put(bottom, p_item);
+        // A release store rather than the paper's fence + relaxed store:
+        // the same on x86 and ARM, and visible to ThreadSanitizer.
+        bottom_.store(bottom + 1, std::memory_order_release);
+    }
+
+    // Owner only. Returns T() when empty.
+    T pop() {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        Buffer *buffer = buffer_.load(std::memory_order_relaxed);
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = top_.load(std::memory_order_relaxed);
+
+        T item = T();
+        if (top <= bottom) {
+            item = buffer->get(bottom);
+            if (top == bottom) {
+                // Last item: race the thieves for it.
+                if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                    item = T();
+                }
+                bottom_.store(bottom + 1, std::memory_order_relaxed);
+            }
+        } else {
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    // Any thread. Returns T() when empty or when another thread won the item.
+    T steal() {
+        int64_t top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t bottom = bottom_.load(std::memory_order_acquire);
+        if (top >= bottom) {
+            return T();
+        }
+        Buffer *buffer = buffer_.load(std::memory_order_acquire);
+        T item = buffer->get(top);
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return T();
+        }
+        return item;
+    }
+
+    // Approximate; only for statistics and sleep decisions.
+    bool is_empty() const {
+        return bottom_.load(std::memory_order_relaxed) <= top_.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Buffer {
+        int64_t capacity;
+        int64_t mask;
+        std::unique_ptr<std::atomic<T>[]> items;
+
+        explicit Buffer(int64_t p_capacity) :
+                capacity(p_capacity), mask(p_capacity - 1), items(new std::atomic<T>[p_capacity]) {}
+
+        T get(int64_t p_index) const { return items[p_index & mask].load(std::memory_order_relaxed); }
+        void put(int64_t p_index, T p_item) { items[p_index & mask].store(p_item, std::memory_order_relaxed); }
+    };
+
+    Buffer *grow(Buffer *p_old, int64_t p_top, int64_t p_bottom) {
+        buffers_.push_back(std::make_unique<Buffer>(p_old->capacity * 2));
+        Buffer *buffer = buffers_.back().get();
+        for (int64_t i = p_top; i < p_bottom; i++) {
+            buffer->put(i, p_old->get(i));
+        }
+        buffer_.store(buffer, std::memory_order_release);
+        return buffer;
+    }
+
+    alignas(64) std::atomic<int64_t> top_{ 0 };
+    alignas(64) std::atomic<int64_t> bottom_{ 0 };
+    std::atomic<Buffer *> buffer_{ nullptr };
+    std::vector<std::unique_ptr<Buffer>> buffers_; // Owner only; every buffer ever used
+};
+
+} // namespace Async
+} // namespace VisualGasic
+
+#endif // VISUAL_GASIC_WORK_STEALING_DEQUE_H
@@ -7,6 +7,7 @@
 #include "visual_gasic_instance.h"
 #include "visual_gasic_script.h"
 #include "visual_gasic_bytecode.h"
+#include <godot_cpp/classes/ref_counted.hpp>
 
 using namespace godot;
 
@@ -147,6 +148,56 @@ bool test_bytecode_array_ops() {
     return ok && ret.get_type() == Variant::INT && (int64_t)ret == 99;
 }
 
+// OP_CONCAT holds its operands in Variant locals. Under threaded dispatch a
+// handler that jumped to the next one with those still in scope would skip
+// their destructors, so each iteration would leak a reference to `probe`.
+bool test_bytecode_concat_loop_releases_operands() {
+    const int64_t iterations = 1000;
+    Ref<RefCounted> probe;
+    probe.instantiate();
+
+    BytecodeChunk chunk;
+    chunk.local_count = 1;
+    chunk.local_names.push_back("i");
+    chunk.local_types.push_back(0);
+    int idx_zero = chunk.add_constant((int64_t)0);
+    int idx_last = chunk.add_constant(iterations - 1);
+    int idx_probe = chunk.add_constant(Variant(probe));
+    int idx_suffix = chunk.add_constant(String("x"));
+
+    push_byte(chunk, OP_CONSTANT); // i = 0
+    push_byte(chunk, (uint8_t)idx_zero);
+    push_byte(chunk, OP_SET_LOCAL);
+    push_byte(chunk, 0);
+    push_byte(chunk, OP_GET_LOCAL); // 4: while i <= iterations - 1
+    push_byte(chunk, 0);
+    push_byte(chunk, OP_CONSTANT);
+    push_byte(chunk, (uint8_t)idx_last);
+    push_byte(chunk, OP_LESS_EQUAL_I64);
+    push_byte(chunk, OP_JUMP_IF_FALSE);
+    push_byte(chunk, 0x00);
+    push_byte(chunk, 0x0B); // to 23
+    push_byte(chunk, OP_CONSTANT); // 12: probe & "x", result dropped
+    push_byte(chunk, (uint8_t)idx_probe);
+    push_byte(chunk, OP_CONSTANT);
+    push_byte(chunk, (uint8_t)idx_suffix);
+    push_byte(chunk, OP_CONCAT);
+    push_byte(chunk, OP_POP);
+    push_byte(chunk, OP_INC_LOCAL_I64);
+    push_byte(chunk, 0);
+    push_byte(chunk, OP_LOOP);
+    push_byte(chunk, 0x00);
+    push_byte(chunk, 0x13); // back to 4
+    push_byte(chunk, OP_GET_LOCAL); // 23
+    push_byte(chunk, 0);
+    push_byte(chunk, OP_RETURN_VALUE);
+
+    int refs_before = probe->get_reference_count();
+    Variant ret;
+    bool ok = run_chunk(chunk, ret);
+    return ok && (int64_t)ret == iterations && probe->get_reference_count() == refs_before;
+}
+
 } // namespace
 
 int run_all_integration_tests() {
@@ -155,6 +206,7 @@ int run_all_integration_tests() {
         {"Bytecode local arithmetic", test_bytecode_locals},
         {"Bytecode conditional flow", test_bytecode_conditionals},
         {"Bytecode array operations", test_bytecode_array_ops},
+        {"Bytecode concat loop releases operands", test_bytecode_concat_loop_releases_operands},
     };
 
     int passed = 0;
@@ -0,0 +1,27 @@
+// Small native library for the Declare (FFI) benchmark, built by
+//
+//   make -f Makefile.tests ffi-test-lib
+//
+// into demo/bin/libvgffitest.so. demo/run_ffi_bench.gd declares these and
+// checks their results, so keep the two in sync.
+
+#include <stdint.h>
+#include <string.h>
+
+int64_t vg_add(int64_t a, int64_t b) {
+    return a + b;
+}
+
+double vg_lerp(double a, double b, double t) {
+    return a + (b - a) * t;
+}
+
+int32_t vg_strlen(const char *s) {
+    return s ? (int32_t)strlen(s) : 0;
+}
+
+// Twelve mixed parameters, past the old eight-argument limit.
+double vg_sum12(int64_t a, double b, int32_t c, float d, int64_t e, double f,
+        int32_t g, double h, int64_t i, double j, int64_t k, double l) {
+    return a + b + c + d + e + f + g + h + i + j + k + l;
+}
@@ -0,0 +1,43 @@
+#ifndef TOOLS_STANDALONE_TOKENIZER_H
+#define TOOLS_STANDALONE_TOKENIZER_H
+
+#include <string>
+#include <vector>
+
+// Godot-free copy of the original VisualGasicTokenizer loop over std::string,
+// used by the std parser tools and as the baseline in tokenizer_bench.
+class StandaloneTokenizer {
+public:
+    enum TokenType {
+        TOKEN_EOF,
+        TOKEN_NEWLINE,
+        TOKEN_IDENTIFIER,
+        TOKEN_KEYWORD,
+        TOKEN_LITERAL_INTEGER,
+        TOKEN_LITERAL_FLOAT,
+        TOKEN_LITERAL_STRING,
+        TOKEN_STRING_INTERP,
+        TOKEN_OPERATOR,
+        TOKEN_PAREN_OPEN,
+        TOKEN_PAREN_CLOSE,
+        TOKEN_COMMA,
+        TOKEN_COLON,
+        TOKEN_COMMENT,
+        TOKEN_ERROR
+    };
+
+    struct Token {
+        TokenType type;
+        std::string value;
+        int line;
+        int column;
+    };
+
+    StandaloneTokenizer();
+    ~StandaloneTokenizer();
+
+    std::vector<Token> tokenize(const std::string &p_source_code);
+    std::string token_type_to_string(TokenType t);
+};
+
+#endif // TOOLS_STANDALONE_TOKENIZER_H
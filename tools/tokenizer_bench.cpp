@@ -0,0 +1,120 @@
+// Tokenizer throughput benchmark (MB/s), Godot-free.
+//
+// Generates a .vg corpus and times StandaloneTokenizer (the original
+// std::string loop: per-call keyword list, one std::string per token) against
+// the VisualGasicScan scanner over the same text as UTF-8 and as UTF-32,
+// which is what VisualGasicTokenizer hands it. The corpus sticks to the
+// operators StandaloneTokenizer knows, so both must agree on the token stream
+// (columns excepted: the baseline counts a string literal one column wider).
+//
+//   make -f Makefile.tests tokenizer-bench
+//   tools/tokenizer_bench [lines] [repeats]
+
+#include "standalone_tokenizer.h"
+#include "visual_gasic_token_scanner.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string make_corpus(int p_lines) {
+    static const char *BLOCK =
+            "' Generated module for tokenizer throughput\n"
+            "Function Accumulate%d(ByVal count As Long, ByVal scale As Double) As Double\n"
+            "    Dim total As Double\n"
+            "    Dim index As Long\n"
+            "    For index = 1 To count\n"
+            "        total = total + index * scale - (index / 3.25)\n"
+            "        If total > 100000 Then\n"
+            "            total = total - 100000\n"
+            "        End If\n"
+            "    Next index\n"
+            "    Print \"Total: \" & total, player.position.x\n"
+            "    Accumulate%d = total\n"
+            "End Function\n"
+            "\n";
+    std::string out;
+    char buf[1024];
+    int lines = 0;
+    for (int block = 0; lines < p_lines; block++) {
+        snprintf(buf, sizeof(buf), BLOCK, block, block);
+        out += buf;
+        lines += 14;
+    }
+    return out;
+}
+
+template <typename F>
+double best_seconds(int p_repeats, F p_fn) {
+    double best = 1e30;
+    for (int r = 0; r < p_repeats; r++) {
+        auto start = std::chrono::steady_clock::now();
+        p_fn();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (elapsed.count() < best) {
+            best = elapsed.count();
+        }
+    }
+    return best;
+}
+
+// The baseline only knows a handful of keywords; compare everything else.
+int fold_kind(int p_kind) {
+    return p_kind == StandaloneTokenizer::TOKEN_KEYWORD ? StandaloneTokenizer::TOKEN_IDENTIFIER : p_kind;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    int lines = argc > 1 ? atoi(argv[1]) : 200000;
+    int repeats = argc > 2 ? atoi(argv[2]) : 5;
+
+    std::string utf8 = make_corpus(lines);
+    std::u32string utf32(utf8.begin(), utf8.end()); // Corpus is ASCII
+    double mb = utf8.size() / (1024.0 * 1024.0);
+
+    size_t baseline_tokens = 0;
+    std::vector<StandaloneTokenizer::Token> baseline;
+    double baseline_s = best_seconds(repeats, [&] {
+        StandaloneTokenizer tokenizer;
+        baseline = tokenizer.tokenize(utf8);
+        baseline_tokens = baseline.size();
+    });
+
+    VisualGasicScan::ScanResult scan8;
+    double scan8_s = best_seconds(repeats, [&] { VisualGasicScan::scan(utf8.data(), utf8.size(), scan8); });
+    VisualGasicScan::ScanResult scan32;
+    double scan32_s = best_seconds(repeats, [&] { VisualGasicScan::scan(utf32.data(), utf32.size(), scan32); });
+
+    printf("Tokenizer throughput (%.2f MB, %d lines, best of %d)\n", mb, lines, repeats);
+    printf("%-22s %9.2f MB/s  %9zu tokens\n", "standalone (baseline)", mb / baseline_s, baseline_tokens);
+    printf("%-22s %9.2f MB/s  %9zu tokens  %zu atoms\n", "scanner utf-8", mb / scan8_s, scan8.tokens.size(), scan8.atom_start.size());
+    printf("%-22s %9.2f MB/s  %9zu tokens  %zu atoms\n", "scanner utf-32", mb / scan32_s, scan32.tokens.size(), scan32.atom_start.size());
+
+    int failures = 0;
+    if (scan8.tokens.size() != baseline.size() || scan32.tokens.size() != baseline.size()) {
+        fprintf(stderr, "Token counts differ\n");
+        failures++;
+    } else {
+        for (size_t i = 0; i < baseline.size(); i++) {
+            const VisualGasicScan::CompactToken &a = scan8.tokens[i];
+            const VisualGasicScan::CompactToken &b = scan32.tokens[i];
+            const StandaloneTokenizer::Token &ref = baseline[i];
+            bool same = fold_kind(a.kind) == fold_kind(ref.type) && a.line == ref.line &&
+                    a.kind == b.kind && a.start == b.start && a.length == b.length && a.column == b.column;
+            if (same && (a.kind == VisualGasicScan::KIND_IDENTIFIER || a.kind == VisualGasicScan::KIND_LITERAL_INTEGER)) {
+                same = utf8.compare(a.start, a.length, ref.value) == 0;
+            }
+            if (!same) {
+                fprintf(stderr, "Token %zu differs (line %d, column %d)\n", i, ref.line, ref.column);
+                failures++;
+                break;
+            }
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}